@@ -13,6 +13,7 @@
 #include "scene/actor.hpp"
 #include "scene/camera.hpp"
 #include "scene/gltf_loader.hpp"
+#include "scene/import_stream.hpp"
 #include "scene/usd_loader.hpp"
 #include "scene/material_instance.hpp"
 #include "scene/scene.hpp"
@@ -588,6 +589,22 @@ uint64_t actor_identity_sig(const tracey::sops::EmittedActor &a) {
         sig_mix(h, &a.ovSubsurfaceColor, sizeof(a.ovSubsurfaceColor));
         sig_mix(h, &a.ovAnisotropy, sizeof(a.ovAnisotropy));
     }
+    // Nested-instancing levels are structural: they live in Scene
+    // instance groups that only the slow path rebuilds, so any change
+    // inside them (count, TRS or tint) has to leave the fast TRS path.
+    const uint64_t levels = a.groupLevels.size();
+    sig_mix(h, &levels, sizeof(levels));
+    for (const auto &level : a.groupLevels) {
+        const uint64_t n = level.size();
+        sig_mix(h, &n, sizeof(n));
+        for (const auto &e : level) {
+            sig_mix(h, &e.translate, sizeof(e.translate));
+            sig_mix(h, &e.rotation,  sizeof(e.rotation));
+            sig_mix(h, &e.scale,     sizeof(e.scale));
+            sig_mix(h, &e.hasTint,   sizeof(e.hasTint));
+            if (e.hasTint) sig_mix(h, &e.tint, sizeof(e.tint));
+        }
+    }
     // Instance-group count + per-instance tints are INTENTIONALLY NOT
     // folded in here. A particle sim spawning/dying entries every cook
     // would otherwise flip this hash and force the slow path —
@@ -664,6 +681,19 @@ static uint64_t emitted_signature(const std::vector<tracey::sops::EmittedActor>&
             mix(&e.hasTint,   sizeof(e.hasTint));
             if (e.hasTint) mix(&e.tint, sizeof(e.tint));
         }
+        const uint64_t nl = a.groupLevels.size();
+        mix(&nl, sizeof(nl));
+        for (const auto &level : a.groupLevels) {
+            const uint64_t n = level.size();
+            mix(&n, sizeof(n));
+            for (const auto &e : level) {
+                mix(&e.translate, sizeof(e.translate));
+                mix(&e.rotation,  sizeof(e.rotation));
+                mix(&e.scale,     sizeof(e.scale));
+                mix(&e.hasTint,   sizeof(e.hasTint));
+                if (e.hasTint) mix(&e.tint, sizeof(e.tint));
+            }
+        }
         // Object Output inline material override — fold in so dragging a
         // material slider flips the signature and apply_emitted actually
         // re-applies it (otherwise the "nothing changed" early-out swallows it).
@@ -1028,6 +1058,15 @@ void EditorServer::apply_emitted(std::vector<tracey::sops::EmittedActor>&& emitt
         }
     };
 
+    // Helper: drop the Scene instance groups a nested-instancing actor
+    // created under `key`. Group names are per actor key, never shared.
+    auto release_groups_for_key = [&](uint64_t key) {
+        auto groupIt = m_actor_instance_groups.find(key);
+        if (groupIt == m_actor_instance_groups.end()) return;
+        for (const auto &name : groupIt->second) scene.removeInstanceGroup(name);
+        m_actor_instance_groups.erase(groupIt);
+    };
+
     // Iterate the *old* m_actor_signatures (still holds the previous
     // cook's set) and prune anything that isn't in this cook's newKeys.
     // This is where actors from a deleted SOP (e.g. removing an Instance
@@ -1048,6 +1087,7 @@ void EditorServer::apply_emitted(std::vector<tracey::sops::EmittedActor>&& emitt
             m_emitted_actor_to_actor.erase(actorIt);
         }
         release_object_for_key(it->first);
+        release_groups_for_key(it->first);
         // Only forget the per-uid visibility flag when *every* actor for
         // that uid is gone (instance SOPs share one visibility flag across
         // all their instances).
@@ -1170,8 +1210,8 @@ void EditorServer::apply_emitted(std::vector<tracey::sops::EmittedActor>&& emitt
 
     // Composite keys whose Actor got newly created (or recreated after a
     // structural change) in this pass. Used by Pass 2 below to gate parent
-    // re-wiring — addChild isn't idempotent, so re-running it on unchanged
-    // actors would push duplicate child uids.
+    // re-wiring — unchanged actors already carry their links, so there is
+    // nothing to redo for them.
     std::unordered_set<uint64_t> recreatedKeys;
 
     // Selection survives actor recreation. A deforming actor (skinned mesh,
@@ -1292,6 +1332,7 @@ void EditorServer::apply_emitted(std::vector<tracey::sops::EmittedActor>&& emitt
                 m_emitted_actor_to_actor.erase(actorIt);
             }
             release_object_for_key(actorKey);
+            release_groups_for_key(actorKey);
         }
         recreatedKeys.insert(actorKey);
 
@@ -1528,6 +1569,46 @@ void EditorServer::apply_emitted(std::vector<tracey::sops::EmittedActor>&& emitt
             mat.setFloat("anisotropy", ea.ovAnisotropy);
         }
 
+        // Nested instancing (a packed copy_to_points feeding the `instance`
+        // SOP): each group level becomes a Scene instance group whose
+        // members place the level below — the stamp object for level 0,
+        // the previous group otherwise — and the actor's own instances
+        // below place the outermost group. Materials live on the level-0
+        // members (a group placement's material is ignored), so only the
+        // innermost template's Cd tints the clones.
+        std::string placedName = objectName;
+        if (!ea.groupLevels.empty() && !ea.instances.empty()) {
+            auto &groupNames = m_actor_instance_groups[actorKey];
+            for (size_t level = 0; level < ea.groupLevels.size(); ++level) {
+                std::vector<tracey::SceneInstance> members;
+                members.reserve(ea.groupLevels[level].size());
+                for (const auto &e : ea.groupLevels[level]) {
+                    tracey::MaterialInstance imat = mat;
+                    if (level == 0 && e.hasTint && tintAllowed) {
+                        const tracey::Vec3 base = imat.albedo().value_or(tracey::Vec3(1.0f));
+                        imat.setAlbedo(tracey::Vec3(base.x * e.tint.x,
+                                                    base.y * e.tint.y,
+                                                    base.z * e.tint.z));
+                    }
+                    tracey::SceneInstance si(placedName, imat);
+                    tracey::Transform xf;
+                    xf.setPosition(e.translate);
+                    xf.setRotation(tracey::Quaternion(e.rotation.x, e.rotation.y,
+                                                       e.rotation.z, e.rotation.w));
+                    xf.setScale(e.scale);
+                    si.setLocalTransform(xf);
+                    members.push_back(std::move(si));
+                }
+                // Keyed by actor key, not object name: deduped actors share
+                // the stamp object but each owns its own groups.
+                std::string groupName = "__instance_group_" + std::to_string(actorKey) +
+                                        "_" + std::to_string(level);
+                scene.addInstanceGroup(groupName, std::move(members));
+                groupNames.push_back(groupName);
+                placedName = std::move(groupName);
+            }
+        }
+
         if (!ea.instances.empty()) {
             // Instance-group emit: one Actor sitting at identity, N
             // SceneInstances each carrying its own local transform and
@@ -1545,7 +1626,7 @@ void EditorServer::apply_emitted(std::vector<tracey::sops::EmittedActor>&& emitt
                                                 base.y * e.tint.y,
                                                 base.z * e.tint.z));
                 }
-                tracey::SceneInstance si(objectName, imat);
+                tracey::SceneInstance si(placedName, imat);
                 tracey::Transform xf;
                 xf.setPosition(e.translate);
                 xf.setRotation(tracey::Quaternion(e.rotation.x, e.rotation.y,
@@ -1570,11 +1651,10 @@ void EditorServer::apply_emitted(std::vector<tracey::sops::EmittedActor>&& emitt
         restoreVisibility(actor, ea.sourceNodeUid);
     }
 
-    // Pass 2: wire parent → child edges for recreated actors only. Both
-    // directions are stored so Scene::flatten() can walk top-down without
-    // a per-actor reverse scan. Unchanged actors keep their existing
-    // parent/child links — addChild isn't idempotent, so re-running it
-    // every cook on those would duplicate child uids. Parenting is
+    // Pass 2: wire parent → child edges for recreated actors only. Actor
+    // keeps both directions in sync (addChild sets the child's parent), so
+    // Scene::flatten() walks top-down without a per-actor reverse scan.
+    // Unchanged actors keep their existing parent/child links. Parenting is
     // expressed in SOP-node terms (parentNodeUid → sourceNodeUid), so we
     // use the SOP→primary-actor map on both sides.
     for (const auto& ea : emitted) {
@@ -1591,7 +1671,6 @@ void EditorServer::apply_emitted(std::vector<tracey::sops::EmittedActor>&& emitt
         auto* parent = scene.getActor(parentIt->second);
         if (!child || !parent) continue;
         parent->addChild(child);
-        child->setParent(parent->getUid());
     }
 
     // Re-point selection at the (possibly recreated) actor for its stable key,
@@ -1858,13 +1937,19 @@ EditorServer::collect_dop_stamps(double time) {
     const int frame_idx = std::max(1,
         static_cast<int>(std::floor(time * fps + 1e-6)) + 1);
 
-    // Scrubbing backward (or graph edited) requires re-sim from the
-    // empty baseline. cookToFrame is monotonic; clear first when we're
-    // landing in the past.
+    // Frames whose SOP sources re-cooked since they were simulated are
+    // stale; drop them (and everything after) before reading the cache.
+    // Frames before the first affected one survive, so an edit to an
+    // emitter the sim only starts reading late — or to a SOP it never
+    // reads — doesn't re-sim from frame 1. The sources are read from
+    // m_main_cook_cache, so this sees an edit once a synchronous cook
+    // has picked it up.
+    //
+    // Landing before the cached extent (scrubbing backward) needs no
+    // re-sim: every cooked frame stays in the frame cache, and
+    // cookToFrame is a no-op up to cachedToFrame().
     const int prev_cached = m_dop_graph->cachedToFrame();
-    if (frame_idx < prev_cached) {
-        m_dop_graph->clearCache();
-    }
+    m_dop_graph->invalidateChangedSopInputs();
     m_dop_graph->cookToFrame(frame_idx, fps);
 
     // Broadcast cache-extent change so the dopesheet UI can draw a
@@ -1953,14 +2038,41 @@ void EditorServer::cook_worker_loop() {
             m_pending_cook_request.reset();
         }
 
-        std::unique_ptr<tracey::sops::SopGraph> graph;
-        try {
-            graph = tracey::sops::deserializeSopGraph(request.graph_json);
-        } catch (const std::exception& e) {
-            std::fprintf(stderr, "[sop worker] parse failed: %s\n", e.what());
+        // Full requests rebuild the retained graph; patch requests replay
+        // their edits on it (marking the touched cache entries dirty). A
+        // failure drops the graph, and the main thread then resyncs it with
+        // the full JSON.
+        bool parse_failed = false;
+        if (!request.graph_json.empty()) {
+            try {
+                m_worker_graph = tracey::sops::deserializeSopGraph(request.graph_json);
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "[sop worker] parse failed: %s\n", e.what());
+                m_worker_graph.reset();
+                parse_failed = true;
+            }
+        }
+        for (const auto& patch : request.patches) {
+            if (!m_worker_graph) break;
+            try {
+                tracey::sops::applySopGraphPatch(*m_worker_graph, patch, &m_worker_cook_cache);
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "[sop worker] patch failed: %s\n", e.what());
+                m_worker_graph.reset();
+            }
+        }
+        m_worker_graph_valid.store(m_worker_graph != nullptr, std::memory_order_release);
+        if (!m_worker_graph) {
+            // The patches in this request (or ones that landed on a graph
+            // dropped a moment ago) would otherwise be lost until the next
+            // edit. m_sop_graph already holds them, so have the main thread
+            // re-post it in full. Not after a bad full graph: re-sending
+            // the same JSON can't help.
+            if (!parse_failed && !request.patches.empty())
+                m_worker_needs_full_sync.store(true, std::memory_order_release);
             continue;
         }
-        if (!graph) continue;
+        tracey::sops::SopGraph* graph = m_worker_graph.get();
 
         // Apply DOP-import side-channel stamps. The serialized graph drops
         // dop_import's m_stamped Geometry; the canonical EditorServer side
@@ -1968,7 +2080,7 @@ void EditorServer::cook_worker_loop() {
         // CookRequest::dop_stamps. We poke them into the worker's private
         // graph clone here so cook() sees real data.
         for (auto& [uid, geo] : request.dop_stamps) {
-            if (auto* node = findNodeRecursive(graph.get(), uid)) {
+            if (auto* node = findNodeRecursive(graph, uid)) {
                 tracey::sops::setDopImportGeometry(node, std::move(geo));
             }
         }
@@ -2137,6 +2249,10 @@ void EditorServer::post_cook_request(std::string graph_json, double time) {
     // these into its private graph clone before cook(), so the serialized
     // JSON doesn't have to carry geometry payloads.
     auto stamps = collect_dop_stamps(time);
+    if (!graph_json.empty()) {
+        m_worker_graph_synced = true;
+        m_worker_needs_full_sync.store(false, std::memory_order_relaxed);
+    }
     {
         std::lock_guard<std::mutex> lk(m_cook_request_mutex);
         m_pending_cook_request = CookRequest{
@@ -2155,9 +2271,50 @@ void EditorServer::post_cook_request(std::string graph_json, double time) {
     }
 }
 
+// Called from the message thread under m_mutex, after apply_sop_graph_patch
+// has edited m_sop_graph in place.
+void EditorServer::post_cook_patch(std::string patch_json, double time) {
+    if (!m_worker_graph_synced || !m_worker_graph_valid.load(std::memory_order_acquire)) {
+        // Nothing on the worker side to patch (first edit after a load,
+        // m_sop_graph edited behind its back, or an earlier patch failed
+        // there): ship the whole, already-patched graph instead.
+        post_cook_request(last_pushed_graph_json(), time);
+        return;
+    }
+    auto stamps = collect_dop_stamps(time);
+    {
+        std::lock_guard<std::mutex> lk(m_cook_request_mutex);
+        if (m_pending_cook_request) {
+            m_pending_cook_request->patches.push_back(std::move(patch_json));
+            m_pending_cook_request->time = time;
+            m_pending_cook_request->dop_stamps = std::move(stamps);
+        } else {
+            m_pending_cook_request = CookRequest{{}, time, std::move(stamps), {std::move(patch_json)}};
+        }
+    }
+    m_cook_request_cv.notify_one();
+    if (m_broadcast) {
+        m_broadcast(R"({"event":"cook_status","busy":true})");
+    }
+}
+
+const std::string& EditorServer::last_pushed_graph_json() {
+    if (m_last_pushed_graph_stale && m_sop_graph) {
+        m_last_pushed_graph_json = tracey::sops::serializeSopGraph(*m_sop_graph);
+    }
+    m_last_pushed_graph_stale = false;
+    return m_last_pushed_graph_json;
+}
+
 // Called from render_tick on the main thread (already holds m_mutex).
 // Applies any cook result the worker has produced since the previous tick.
 void EditorServer::drain_cook_result() {
+    // The worker lost its graph with patches still to apply (see
+    // cook_worker_loop): resync it from the canonical, already-patched one.
+    if (m_worker_needs_full_sync.exchange(false, std::memory_order_acq_rel)) {
+        m_worker_graph_synced = false;
+        if (m_sop_graph) post_cook_request(last_pushed_graph_json(), m_timeline.current_time);
+    }
     std::optional<PendingCookResult> result;
     {
         std::lock_guard<std::mutex> lk(m_cook_result_mutex);
@@ -2181,6 +2338,10 @@ void EditorServer::drain_cook_result() {
                 {"kind",            nct.kind},
                 {"name",            nct.name},
                 {"ms",              nct.ms},
+                {"allocs",          nct.allocations},
+                {"allocs_reused",   nct.reused},
+                {"bytes_alloc",     nct.bytesAllocated},
+                {"bytes_reused",    nct.bytesReused},
             });
             total_ms += nct.ms;
         }
@@ -2208,7 +2369,7 @@ void EditorServer::drain_cook_result() {
     // animated VOP promotion + no DOP imports — i.e. the graph is
     // static) so static scenes don't busy-loop the cook worker.
     if (m_timeline.frame_locked && m_timeline.playing &&
-        !m_last_pushed_graph_json.empty() &&
+        !last_pushed_graph_json().empty() &&
         (m_has_animated_sop_params || m_has_dop_imports))
     {
         const double stride = 1.0 / std::max(m_timeline.fps, 1e-6);
@@ -2218,7 +2379,7 @@ void EditorServer::drain_cook_result() {
             // posted here directly (not via render_tick) so the worker
             // stays continuously busy.
             m_timeline_dirty = true;
-            post_cook_request(m_last_pushed_graph_json, m_timeline.current_time);
+            post_cook_request(last_pushed_graph_json(), m_timeline.current_time);
             // Broadcast the new playhead position so the dopesheet UI
             // tracks frame-locked playback the same way it tracks
             // wall-clock playback (timeline_tick in render_tick fires
@@ -2429,23 +2590,37 @@ void EditorServer::export_video_loop(VideoExportRequest req) {
             }
             apply_animation_at(frame_time);
 
-            // R4 motion blur: build shutter-close instance poses so moving
-            // objects blur. Evaluate the animation at frame_time + shutter·(1/fps),
-            // snapshot those instances as instancesEnd, then restore the start
-            // pose and stamp a fresh revision so the path-tracer backend rebuilds
-            // with the hardware/swept motion AS. Rigid per-instance (keyed TRS)
-            // motion only; camera + deformation blur are follow-ups.
-            const float shutter = m_engine->scene().camera().shutter();
+            // R4 motion blur: sample the scene at motionSamples() times evenly
+            // spread over [frame_time, frame_time + shutter·(1/fps)] and attach
+            // them as motion keys — instance poses for keyed TRS motion, and
+            // per-mesh position keys for geometry the SOP graph deforms
+            // (skinning, VOP deformers). Animated graphs are re-cooked at each
+            // sub-frame time so deformation shows up; static graphs only need
+            // the keyed transforms. Then restore the shutter-open state and
+            // stamp a fresh revision so the path-tracer backend rebuilds with
+            // the motion AS. Camera blur is a follow-up.
+            const tracey::Camera &cam = m_engine->scene().camera();
+            const float shutter = cam.shutter();
             if (shutter > 0.0f && m_engine->compiled_scene_ready()) {
                 const double dt = static_cast<double>(shutter) / std::max(req.fps, 1e-6);
-                apply_animation_at(frame_time + dt);
-                m_engine->compile_scene();
-                std::vector<tracey::Tlas::Instance> endInstances;
-                if (auto snap = m_engine->compiled_scene_snapshot())
-                    endInstances = snap->instances;
-                apply_animation_at(frame_time);   // restore the shutter-open pose
-                m_engine->compile_scene();
-                m_engine->set_motion_end_instances(std::move(endInstances));
+                const int keys = cam.motionSamples();
+                std::vector<tracey::SceneCompiler::MotionSample> samples;
+                samples.reserve(keys);
+                auto evaluate_at = [&](double t) {
+                    m_timeline.current_time = t;
+                    if (!scene_static) cook_and_apply();
+                    apply_animation_at(t);
+                    m_engine->compile_scene();
+                };
+                for (int k = 0; k < keys; ++k) {
+                    const double t = frame_time + dt * k / (keys - 1);
+                    if (k > 0) evaluate_at(t);
+                    else m_engine->compile_scene();
+                    if (auto snap = m_engine->compiled_scene_snapshot())
+                        samples.push_back(tracey::SceneCompiler::captureMotionSample(*snap));
+                }
+                evaluate_at(frame_time);   // restore the shutter-open state
+                m_engine->set_motion_samples(std::move(samples));
             }
 
             for (int s = 0; s < req.samples_per_frame; ++s) {
@@ -2505,12 +2680,15 @@ void EditorServer::export_video_loop(VideoExportRequest req) {
             const auto eRGB = take_n(emission.data(), 3);
             const auto zR = take_n(depth.data(), 1);
             const auto idR = take_n(instanceId.data(), 1);
+            // Colour-like AOVs go out as HALF; P / Z / id keep 32-bit
+            // precision.
+            constexpr auto kHalf = tracey::ExrPixelType::Half;
             const std::vector<tracey::ExrLayer> layers = {
-                {"", 3, bRGB.data()},
-                {"albedo", 3, aRGB.data()},
-                {"N", 3, nXYZ.data()},
+                {"", 3, bRGB.data(), kHalf},
+                {"albedo", 3, aRGB.data(), kHalf},
+                {"N", 3, nXYZ.data(), kHalf},
                 {"P", 3, pXYZ.data()},
-                {"emission", 3, eRGB.data()},
+                {"emission", 3, eRGB.data(), kHalf},
                 {"Z", 1, zR.data()},
                 {"id", 1, idR.data()},
             };
@@ -2740,10 +2918,11 @@ void EditorServer::render_still_loop(RenderStillRequest req) {
             const auto eRGB = take_n(emission.data(), 3);
             const auto zR = take_n(depth.data(), 1);
             const auto idR = take_n(instanceId.data(), 1);
+            constexpr auto kHalf = tracey::ExrPixelType::Half;
             const std::vector<tracey::ExrLayer> layers = {
-                {"", 3, bRGB.data()},        {"albedo", 3, aRGB.data()},
-                {"N", 3, nXYZ.data()},       {"P", 3, pXYZ.data()},
-                {"emission", 3, eRGB.data()},{"Z", 1, zR.data()},
+                {"", 3, bRGB.data(), kHalf},         {"albedo", 3, aRGB.data(), kHalf},
+                {"N", 3, nXYZ.data(), kHalf},        {"P", 3, pXYZ.data()},
+                {"emission", 3, eRGB.data(), kHalf}, {"Z", 1, zR.data()},
                 {"id", 1, idR.data()},
             };
             std::string exr_err;
@@ -2828,7 +3007,32 @@ void EditorServer::import_usd_stage_worker(UsdStageImportRequest req) {
 
     // Heavy parse — off the mutex AND off the main thread, so the UI stays live.
     progress("Reading USD…", 0, 0);
-    auto src = tracey::UsdLoader::loadFromFileCached(req.path);
+    // Meshes convert on the pool; report them as they land (about every 1%,
+    // so a 10k-prim stage doesn't flood the socket).
+    tracey::ImportStream stream;
+    stream.onProgress = [&progress](const tracey::ImportProgress &p) {
+        if (std::strcmp(p.stage, "meshes") != 0) return;
+        const size_t step = std::max<size_t>(1, p.total / 100);
+        if (p.done % step == 0 || p.done == p.total)
+            progress("Converting meshes…", static_cast<int>(p.done), static_cast<int>(p.total));
+    };
+    // Instance prototypes are the only meshes this import adds to the engine
+    // scene itself (standalone meshes come through the SOP cook), and they go
+    // in under their loader names — "<prototype>::<mesh path>". Build their
+    // BLASes as the loader streams them out, overlapping the rest of the
+    // parse, so the compile below finds them in the engine's BlasCache.
+    std::unique_ptr<tracey::BlasPrebuilder> prebuilder;
+    if (req.instances) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        prebuilder = m_engine->make_blas_prebuilder();
+    }
+    if (prebuilder) {
+        stream.onObject = [&prebuilder](const std::string& name, const tracey::SceneObject& obj) {
+            if (name.find("::") != std::string::npos) prebuilder->push(name, obj);
+        };
+    }
+    auto src = tracey::UsdLoader::loadFromFileCached(req.path, stream);
+    if (prebuilder) prebuilder->finish();
     if (!src) {
         if (m_broadcast)
             m_broadcast(json{{"event", "usd_import_error"},
@@ -3442,9 +3646,9 @@ void EditorServer::render_tick() {
         // the stamps automatically via collect_dop_stamps). The two
         // branches share the post; combine into one condition.
         const bool need_recook = (m_has_animated_sop_params || m_has_dop_imports)
-                                 && !m_last_pushed_graph_json.empty();
+                                 && !last_pushed_graph_json().empty();
         if (need_recook) {
-            post_cook_request(m_last_pushed_graph_json, m_timeline.current_time);
+            post_cook_request(last_pushed_graph_json(), m_timeline.current_time);
         }
     }
 
@@ -474,6 +474,10 @@ private:
     // re-cook path for VOP-promotion animation in render_tick explicitly
     // passes the current time to keep latest-wins coherent.
     void post_cook_request(std::string graph_json, double time);
+    // Incremental counterpart for apply_sop_graph_patch: hands the worker
+    // just the patch to replay on its retained graph. Falls back to a full
+    // post when the worker has no graph to patch.
+    void post_cook_patch(std::string patch_json, double time);
     void drain_cook_result();  // called from render_tick on the main thread
 
     // Walk the canonical SOP graph (recursing into subnet inner graphs) and
@@ -514,16 +518,41 @@ private:
     // returns; serializing the graph drops that buffer, so we pass it
     // alongside the JSON and the worker re-stamps after deserialize. Empty
     // when the graph has no dop_import nodes (the common case).
+    //
+    // `patches` are applySopGraphPatch payloads replayed in order on the
+    // worker's retained graph — after rebuilding it from `graph_json` when
+    // that is non-empty. Patch posts append to a still-pending request
+    // rather than overwrite it, so no edit is lost to latest-wins.
     struct CookRequest {
         std::string graph_json;
         double      time = 0.0;
         std::vector<std::pair<size_t, tracey::Geometry>> dop_stamps;
+        std::vector<std::string> patches;
     };
     std::optional<CookRequest> m_pending_cook_request;
+    // Worker-owned copy of the SOP graph, kept across cooks so patch
+    // requests don't re-parse the whole graph. Touched only by the worker.
+    std::unique_ptr<tracey::sops::SopGraph> m_worker_graph;
+    // Published by the worker after each request: false until a full graph
+    // has been loaded, and again after a patch fails to apply.
+    std::atomic<bool> m_worker_graph_valid{false};
+    // Set by the worker when it had patches to apply but no graph to apply
+    // them to; drain_cook_result answers with a full post. Cleared by every
+    // full post.
+    std::atomic<bool> m_worker_needs_full_sync{false};
+    // Message-thread view: true while the worker's graph (after every
+    // request posted so far) matches m_sop_graph. A full post sets it;
+    // edits of m_sop_graph that reach the worker by no post clear it.
+    bool m_worker_graph_synced = false;
     // Most recently pushed root graph JSON, kept under m_mutex. Reused by
     // the auto re-cook in render_tick (for VOP-promotion animation) — no
     // round trip to the frontend needed.
     std::string m_last_pushed_graph_json;
+    // Set by apply_sop_graph_patch, which edits m_sop_graph in place
+    // without the frontend sending the full JSON; last_pushed_graph_json()
+    // re-serializes on the next read.
+    bool m_last_pushed_graph_stale = false;
+    const std::string &last_pushed_graph_json();
     // Set true after every cook completion if the resulting graph contains
     // at least one attribute_vop with at least one animated promoted host
     // param. Gates the auto re-cook on time change.
@@ -550,6 +579,10 @@ private:
             if (!m_cache) return nullptr;
             return m_cache->findOutput(static_cast<size_t>(sopUid));
         }
+        uint64_t version(uint64_t sopUid) const override {
+            if (!m_cache) return 0;
+            return m_cache->versionOf(static_cast<size_t>(sopUid));
+        }
     private:
         const tracey::sops::CookCache *m_cache;
     };
@@ -600,6 +633,11 @@ private:
     // each instance for cleanup).
     std::unordered_map<uint64_t, std::string> m_sop_node_object_names;
 
+    // Scene instance groups an actor with nested instancing created
+    // (EmittedActor::groupLevels), innermost first. Keyed by the same
+    // composite actor key; the groups go when the actor does.
+    std::unordered_map<uint64_t, std::vector<std::string>> m_actor_instance_groups;
+
     // Per-SceneObject refcount + reverse geometry-content map. Together they
     // implement Phase-A GPU instancing: identical Geometry payloads emitted
     // by different SOP nodes (two `primitive_cube`s, a glTF mesh imported
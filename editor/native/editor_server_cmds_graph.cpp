@@ -76,6 +76,8 @@ std::optional<std::string> EditorServer::handle_graph_commands(
             // Cache so the auto re-cook in render_tick can re-post without
             // a round-trip to the frontend.
             m_last_pushed_graph_json = graph_json;
+            m_last_pushed_graph_stale = false;
+            if (!cook) m_worker_graph_synced = false;
             // Refresh the dop_import gate eagerly so the very first cook
             // after the user adds a dop_import SOP picks up its stamp.
             // The post-cook refresh in apply_emitted runs later, but
@@ -91,21 +93,44 @@ std::optional<std::string> EditorServer::handle_graph_commands(
             // 360°≡0° at the loop end). Without this the graph would be
             // animated but playback would never re-cook it.
             m_has_animated_sop_params = detect_animated_sop_params();
-            // Any SOP edit potentially changes the geometry that a
-            // pop_source(emit_mode=geometry) reads from. Blanket-
-            // invalidate the DOP sim cache so the next playhead read
-            // re-cooks from frame 0 with the fresh source geometry.
-            // Cheap when there's no geometry-source DOP (markDirty is
-            // ~free; the re-cook only fires the next time the timeline
-            // actually advances). A surgical check (only invalidate
-            // when the changed SOP is referenced by a source DOP) is a
-            // v2 follow-up.
-            if (cook && m_dop_graph) m_dop_graph->markDirty();
+            // No DOP invalidation here: the sim cache records which SOP
+            // outputs each frame read, and collect_dop_stamps drops only
+            // the frames whose sources actually re-cooked (see
+            // DopGraph::invalidateChangedSopInputs).
             if (cook) {
                 post_cook_request(graph_json, m_timeline.current_time);
             }
             return ok_response_null();
         }
+        if (cmd == "apply_sop_graph_patch") {
+            // Incremental sibling of set_sop_graph: the frontend sends only
+            // what changed (schema in sops/serialization.hpp) and we edit
+            // m_sop_graph in place instead of re-parsing the whole tree.
+            // The worker replays the same patch on its own copy. On error
+            // the graph may be half-patched; the frontend answers by
+            // re-sending the full graph through set_sop_graph.
+            const auto patch_json = req.at("patch").get<std::string>();
+            const bool cook = req.value("cook", true);
+            if (!m_sop_graph) return err_response("no sop graph to patch");
+            try {
+                tracey::sops::applySopGraphPatch(*m_sop_graph, patch_json);
+            } catch (const std::exception& e) {
+                m_worker_graph_synced = false;
+                return err_response(std::string("sop graph patch error: ") + e.what());
+            }
+            m_last_pushed_graph_stale = true;
+            // Same eager gate refreshes as set_sop_graph.
+            m_has_dop_imports = detect_dop_imports();
+            m_has_animated_sop_params = detect_animated_sop_params();
+            if (cook) {
+                post_cook_patch(patch_json, m_timeline.current_time);
+            } else {
+                // Not forwarded to the worker, so its copy now lags; the
+                // next cook goes out as a full graph.
+                m_worker_graph_synced = false;
+            }
+            return ok_response_null();
+        }
 
         // ── VOP graph (per-host attribute_vop sub-graph) ──
         // Catalog mirrors list_sop_node_catalog. get/set are scoped per host
@@ -227,6 +252,8 @@ std::optional<std::string> EditorServer::handle_graph_commands(
                     m_last_pushed_graph_json = json;
                     if (cook) {
                         post_cook_request(std::move(json), m_timeline.current_time);
+                    } else {
+                        m_worker_graph_synced = false;
                     }
                 }
                 if (cook && m_broadcast) m_broadcast(R"({"event":"sop_graph_changed"})");
@@ -250,6 +277,8 @@ std::optional<std::string> EditorServer::handle_graph_commands(
                     m_last_pushed_graph_json = json;
                     if (cook) {
                         post_cook_request(std::move(json), m_timeline.current_time);
+                    } else {
+                        m_worker_graph_synced = false;
                     }
                 }
                 if (cook && m_broadcast) m_broadcast(R"({"event":"sop_graph_changed"})");
@@ -275,8 +304,8 @@ std::optional<std::string> EditorServer::handle_graph_commands(
                     if (m_dop_graph) m_dop_graph->markDirty();
                     // Re-cook the SOP graph at the current frame so dop_import
                     // gets a fresh stamp from the now-invalidated sim cache.
-                    if (m_sop_graph && !m_last_pushed_graph_json.empty()) {
-                        post_cook_request(m_last_pushed_graph_json,
+                    if (m_sop_graph && !last_pushed_graph_json().empty()) {
+                        post_cook_request(last_pushed_graph_json(),
                                           m_timeline.current_time);
                     }
                     if (m_broadcast) {
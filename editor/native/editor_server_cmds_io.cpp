@@ -189,6 +189,7 @@ std::optional<std::string> EditorServer::handle_io_commands(
             // request before save_scene fires) still references the
             // original off-project files.
             m_last_pushed_graph_json = tracey::sops::serializeSopGraph(*m_sop_graph);
+            m_worker_graph_synced = false;
 
             // Recompile so consolidated materials take effect
             // immediately. Cook isn't required (no geometry changed),
@@ -383,6 +384,7 @@ std::optional<std::string> EditorServer::handle_io_commands(
                     // can re-cook (for VOP-promotion animation) without a
                     // round-trip.
                     m_last_pushed_graph_json = sopJson;
+                    m_worker_graph_synced = false;
 
                     // DOP graph (optional — older save files don't carry one).
                     // Same accept-string-or-object compatibility shape as
@@ -422,6 +424,9 @@ std::optional<std::string> EditorServer::handle_io_commands(
                     for (const auto &a : liveScene.actors())
                         if (a) staleUids.push_back(a->getUid());
                     for (size_t uid : staleUids) liveScene.removeActor(uid);
+                    for (const auto &[key, groups] : m_actor_instance_groups)
+                        for (const auto &name : groups) liveScene.removeInstanceGroup(name);
+                    m_actor_instance_groups.clear();
                     m_sop_node_to_actor.clear();
                     m_emitted_actor_to_actor.clear();
                     m_actor_signatures.clear();
@@ -461,6 +466,7 @@ std::optional<std::string> EditorServer::handle_io_commands(
                 // previous session's particle graph hanging around.
                 load_scene_from_file(m_engine->scene(), path);
                 m_sop_graph = std::make_unique<tracey::sops::SopGraph>(0);
+                m_worker_graph_synced = false;
                 m_dop_graph = std::make_unique<tracey::dops::DopGraph>(0);
                 wire_dop_sop_provider();
                 m_has_dop_imports = false;
@@ -205,6 +205,7 @@ std::optional<std::string> EditorServer::handle_material_commands(
                     if (actorUid != id) continue;
                     if (auto* node = findNodeRecursive(m_sop_graph.get(), sopUid)) {
                         node->setParamString("material_library_name", name);
+                        m_worker_graph_synced = false;
                     }
                     break;
                 }
@@ -239,6 +239,7 @@ std::optional<std::string> EditorServer::handle_scene_commands(
                 }
             }
             m_clear_next_frame = true;
+            if (sopMutated) m_worker_graph_synced = false;
             if (sopMutated && m_broadcast) {
                 m_broadcast(R"({"event":"sop_graph_changed"})");
             }
@@ -278,6 +279,7 @@ std::optional<std::string> EditorServer::handle_scene_commands(
                 }
             }
             m_clear_next_frame = true;
+            if (sopMutated) m_worker_graph_synced = false;
             if (sopMutated && m_broadcast) {
                 m_broadcast(R"({"event":"sop_graph_changed"})");
             }
@@ -69,10 +69,10 @@ std::optional<std::string> EditorServer::handle_timeline_commands(
             // also won't trigger the first cook. Kick one off here so the
             // drain → advance → post chain has somewhere to start.
             if (m_timeline.frame_locked &&
-                !m_last_pushed_graph_json.empty() &&
+                !last_pushed_graph_json().empty() &&
                 (m_has_animated_sop_params || m_has_dop_imports))
             {
-                post_cook_request(m_last_pushed_graph_json, m_timeline.current_time);
+                post_cook_request(last_pushed_graph_json(), m_timeline.current_time);
             }
             return ok_response_null();
         }
@@ -91,10 +91,10 @@ std::optional<std::string> EditorServer::handle_timeline_commands(
             // (which we just told to stop advancing) leaves the worker
             // idle until the user pauses + replays.
             if (!prev && m_timeline.frame_locked && m_timeline.playing &&
-                !m_last_pushed_graph_json.empty() &&
+                !last_pushed_graph_json().empty() &&
                 (m_has_animated_sop_params || m_has_dop_imports))
             {
-                post_cook_request(m_last_pushed_graph_json, m_timeline.current_time);
+                post_cook_request(last_pushed_graph_json(), m_timeline.current_time);
             }
             return ok_response_null();
         }
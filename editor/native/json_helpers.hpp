@@ -59,6 +59,7 @@ inline nlohmann::json camera_to_json(const tracey::Camera& c) {
         {"aperture", c.aperture()},
         {"focal_distance", c.focalDistance()},
         {"shutter", c.shutter()},
+        {"motion_samples", c.motionSamples()},
     };
 }
 
@@ -74,6 +75,7 @@ inline tracey::Camera camera_from_json(const nlohmann::json& j) {
     c.setAperture(j.value("aperture", 0.0f));
     c.setFocalDistance(j.value("focal_distance", 5.0f));
     c.setShutter(j.value("shutter", 0.0f));
+    c.setMotionSamples(j.value("motion_samples", 2));
     return c;
 }
 
@@ -143,6 +143,13 @@ void RenderEngine::set_material_parameter(uint32_t program_id, uint32_t param_id
     m_path_tracer->setMaterialParameter(program_id, param_idx, tracey::Vec4(x, y, z, w));
 }
 
+std::unique_ptr<tracey::BlasPrebuilder> RenderEngine::make_blas_prebuilder() {
+    if (!m_path_tracer || !m_build_acceleration_structures) return nullptr;
+    // Same BVHConfig as compile_scene(), or every entry would miss.
+    return std::make_unique<tracey::BlasPrebuilder>(
+        m_device.get(), *m_blas_cache, tracey::BVHConfig{}, &m_gpu_mutex);
+}
+
 void RenderEngine::compile_scene() {
     // Unique lock: rebuilding GPU buffers/BLAS must exclude both render workers
     // (rasterizer + PT) for its whole duration — see m_gpu_mutex.
@@ -177,9 +184,15 @@ void RenderEngine::compile_scene() {
     // that mode) so the markAll/evictUntouched bookkeeping is harmless —
     // the next PT-mode compile will repopulate everything from scratch.
     m_blas_cache->markAllUntouched();
+    // Keep instance groups nested when the path tracer walks them itself (the
+    // CPU backend): one record per unique group member instead of one per
+    // placed leaf. The rasterizer and picking expand them on the fly.
+    const bool nest_groups = m_build_acceleration_structures && m_path_tracer &&
+                             m_path_tracer->supportsInstanceGroups();
     auto compiled = tracey::SceneCompiler::compile(
         m_device.get(), *m_scene, tracey::BVHConfig{}, m_blas_cache.get(),
-        /*buildAccelerationStructures=*/m_build_acceleration_structures);
+        /*buildAccelerationStructures=*/m_build_acceleration_structures,
+        /*nestInstanceGroups=*/nest_groups);
     m_compiled_scene =
         std::make_shared<tracey::SceneCompiler::CompiledScene>(std::move(compiled));
     m_blas_cache->evictUntouched();
@@ -209,9 +222,10 @@ void RenderEngine::update_lights() {
     m_compiled_scene->lightCount = ld.lightCount;
     m_compiled_scene->lightBuffer = std::move(ld.lightBuffer);
     // Bump the generation so a snapshot captured before the swap is skipped, and
-    // the revision so the path-tracer backends re-read lights next dispatch.
+    // the revision so the path-tracer backends re-read lights next dispatch
+    // (and only lights: the change stamp leaves geometry and textures bound).
     m_scene_generation.fetch_add(1, std::memory_order_release);
-    m_compiled_scene->revision = tracey::SceneCompiler::nextSceneRevision();
+    m_compiled_scene->markChanged(tracey::SceneCompiler::CompiledScene::ChangeLights);
 }
 
 bool RenderEngine::update_material_programs() {
@@ -247,10 +261,14 @@ std::optional<RenderEngine::PickResult> RenderEngine::pick(float ndcX, float ndc
             m_pick_blas_ptrs.push_back(cpu);
         }
         if (!ok || m_pick_blas_ptrs.empty()) { m_pick_tlas.reset(); return std::nullopt; }
+        // Flat over every leaf, nested instance groups included; the hit's
+        // instanceId indexes m_pick_records.
+        tracey::SceneCompiler::expandInstanceGroups(*m_compiled_scene, m_pick_instances,
+                                                    m_pick_records);
         m_pick_tlas = std::make_unique<tracey::Tlas>(
             std::span<const tracey::Blas*>(m_pick_blas_ptrs.data(), m_pick_blas_ptrs.size()),
-            std::span<const tracey::Tlas::Instance>(m_compiled_scene->instances.data(),
-                                                    m_compiled_scene->instances.size()));
+            std::span<const tracey::Tlas::Instance>(m_pick_instances.data(),
+                                                    m_pick_instances.size()));
     }
     if (!m_pick_tlas) return std::nullopt;
 
@@ -272,21 +290,19 @@ std::optional<RenderEngine::PickResult> RenderEngine::pick(float ndcX, float ndc
     PickResult r;
     r.point = hit->position;
     r.distance = hit->t;
-    r.actorUid = (hit->instanceId < m_compiled_scene->instanceToActorUid.size())
-                     ? m_compiled_scene->instanceToActorUid[hit->instanceId]
+    const size_t record = hit->instanceId < m_pick_records.size()
+                              ? m_pick_records[hit->instanceId]
+                              : m_compiled_scene->instanceToActorUid.size();
+    r.actorUid = (record < m_compiled_scene->instanceToActorUid.size())
+                     ? m_compiled_scene->instanceToActorUid[record]
                      : 0u;
     return r;
 }
 
-void RenderEngine::set_motion_end_instances(
-    std::vector<tracey::Tlas::Instance> endInstances) {
-    if (!m_compiled_scene || endInstances.empty() ||
-        endInstances.size() != m_compiled_scene->instances.size()) {
-        return;
-    }
-    m_compiled_scene->instancesEnd = std::move(endInstances);
-    m_compiled_scene->hasMotion = true;
-    m_compiled_scene->revision = tracey::SceneCompiler::nextSceneRevision();
+void RenderEngine::set_motion_samples(
+    std::vector<tracey::SceneCompiler::MotionSample> samples) {
+    if (!m_compiled_scene) return;
+    tracey::SceneCompiler::applyMotionSamples(*m_compiled_scene, samples);
 }
 
 void RenderEngine::set_show_points(bool v) {
@@ -387,6 +403,11 @@ bool RenderEngine::denoise_path_tracer()
 
 bool RenderEngine::refresh_tlas_only() {
     if (!m_compiled_scene) return false;
+    // Instance-group placements don't map 1:1 onto compiled instances (and
+    // a nested compile has no flat TLAS to rebuild), so scenes with groups
+    // always take the full compile.
+    if (!m_scene->instanceGroups().empty() || !m_compiled_scene->instanceGroups.empty())
+        return false;
     // Note: tlas may legitimately be null when PT preview is off
     // (compile_scene skips BLAS/TLAS build via buildAccelerationStructures
     // = false). In that case we still update m_compiled_scene->instances
@@ -543,8 +564,10 @@ bool RenderEngine::refresh_tlas_only() {
     // In-place mutation: stamp a fresh revision so path tracer backends
     // that cache per-scene resources (acceleration structures, buffer
     // copies) see the change. Skipping this renders stale transforms on
-    // any backend that trusts the revision.
-    m_compiled_scene->revision = tracey::SceneCompiler::nextSceneRevision();
+    // any backend that trusts the revision. The per-record arrays grew with
+    // the instances, materials included; geometry and textures are untouched.
+    m_compiled_scene->markChanged(tracey::SceneCompiler::CompiledScene::ChangeInstances |
+                                  tracey::SceneCompiler::CompiledScene::ChangeMaterials);
     return true;
 }
 
@@ -648,6 +671,14 @@ void RenderEngine::set_pt_backend(const std::string& backend) {
             m_path_tracer->setMaterialPrograms(m_compiled_scene->materialPrograms);
         }
     }
+    // A scene compiled with nested instance groups has no device TLAS. If the
+    // new backend can't walk the groups, recompile it flat (compile_scene
+    // takes the GPU lock itself).
+    const bool recompile = m_path_tracer && m_compiled_scene &&
+                           !m_compiled_scene->instanceGroups.empty() &&
+                           !m_path_tracer->supportsInstanceGroups();
+    gpu_lk.unlock();
+    if (recompile) compile_scene();
 }
 
 void RenderEngine::set_resolution(uint32_t width, uint32_t height) {
@@ -3,6 +3,7 @@
 #include "scene/scene.hpp"
 #include "scene/scene_compiler.hpp"
 #include "scene/blas_cache.hpp"
+#include "scene/blas_prebuilder.hpp"
 #include "path_tracer/api/path_tracer.hpp"
 #include "rendering/rasterizer.hpp"
 #include "device/device.hpp"
@@ -70,6 +71,15 @@ public:
 
     void compile_scene();
 
+    // BLAS builds ahead of compile_scene() for objects an import streams in:
+    // a BlasPrebuilder over this engine's BlasCache and device, taking the
+    // GPU lock exclusively around each build, so the next compile picks the
+    // objects up as cache hits. finish() it before that compile. A compile
+    // that lands first (a SOP cook) evicts the entries it doesn't use and
+    // the import's compile rebuilds them. Null when compile_scene() wouldn't
+    // consult the cache (no path tracer, or acceleration structures off).
+    std::unique_ptr<tracey::BlasPrebuilder> make_blas_prebuilder();
+
     // Refresh ONLY the analytic lights, in place, without recompiling geometry.
     // A light edit (add / delete / tweak) changes no vertices, buffers, or BLAS/
     // TLAS, so a full compile_scene() — which re-aggregates and re-uploads every
@@ -90,11 +100,12 @@ public:
     // does nothing) if there's no compiled scene / path tracer yet.
     bool update_material_programs();
 
-    // R4 motion blur: attach shutter-close instance poses (parallel to the
-    // live compiled scene's `instances`) and bump the revision so the
-    // path-tracer backend rebuilds with the motion AS. No-op when the counts
-    // mismatch or there's no compiled scene.
-    void set_motion_end_instances(std::vector<tracey::Tlas::Instance> endInstances);
+    // R4 motion blur: attach shutter samples (SceneCompiler::MotionSample,
+    // first = shutter open) to the live compiled scene — instance pose keys
+    // plus deformation keys for meshes that move — and bump the revision so
+    // the path-tracer backend rebuilds with the motion AS. No-op when an
+    // instance count mismatches or there's no compiled scene.
+    void set_motion_samples(std::vector<tracey::SceneCompiler::MotionSample> samples);
 
     // Controls whether subsequent compile_scene() calls build BLAS / TLAS
     // and upload the material programs. Off → the rasterizer still works
@@ -367,6 +378,10 @@ private:
     // borrows; the BLAS data itself is kept alive by m_compiled_scene.
     std::unique_ptr<tracey::Tlas> m_pick_tlas;
     std::vector<const tracey::Blas*> m_pick_blas_ptrs;
+    // The pick TLAS's leaves (instance groups expanded) and, per leaf, the
+    // compiled-scene record it resolves to.
+    std::vector<tracey::Tlas::Instance> m_pick_instances;
+    std::vector<uint32_t> m_pick_records;
     uint64_t m_pick_tlas_revision = ~0ull;
 
     // Raw JSON for the active material graph. Empty until first set or first
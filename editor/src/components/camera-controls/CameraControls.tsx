@@ -52,6 +52,7 @@ export const CameraControls: Component<CameraControlsProps> = (props) => {
   const [focalDistance, setFocalDistance] = createSignal(5);
   // Motion-blur shutter (R4) — fraction of the frame interval; applied on export.
   const [shutter, setShutter] = createSignal(0);
+  const [motionSamples, setMotionSamples] = createSignal(2);
   // Lens focal length (mm), derived from / written back to the camera's FOV.
   const [focalMm, setFocalMm] = createSignal(fovToMm(45));
   const loadCamera = async () => {
@@ -60,6 +61,7 @@ export const CameraControls: Component<CameraControlsProps> = (props) => {
       setAperture(cam.aperture ?? 0);
       setFocalDistance(cam.focal_distance ?? 5);
       setShutter(cam.shutter ?? 0);
+      setMotionSamples(cam.motion_samples ?? 2);
       setFocalMm(fovToMm(cam.fov ?? 45));
     } catch { /* ignore */ }
   };
@@ -71,7 +73,7 @@ export const CameraControls: Component<CameraControlsProps> = (props) => {
     onCleanup(unlisten);
   });
   const commitDof = async (
-    next: { aperture?: number; focal_distance?: number; shutter?: number },
+    next: { aperture?: number; focal_distance?: number; shutter?: number; motion_samples?: number },
   ) => {
     try {
       const cam = await api.getCamera();
@@ -235,6 +237,21 @@ export const CameraControls: Component<CameraControlsProps> = (props) => {
             }}
           />
         </div>
+        <div class="camera-input-row">
+          <label title="Scene evaluations across the shutter. 2 blurs along straight lines; more follow rotation, arcs and deforming meshes.">Samples</label>
+          <NumberInput
+            step={1}
+            min={2}
+            max={16}
+            title="Motion samples across the shutter (2 = open + close)."
+            value={() => motionSamples()}
+            onCommit={(v) => {
+              const n = Math.max(2, Math.min(16, Math.round(v)));
+              setMotionSamples(n);
+              void commitDof({ motion_samples: n });
+            }}
+          />
+        </div>
       </div>
     </div>
   );
@@ -380,8 +380,13 @@ export const ResourcesBrowser: Component<ResourcesBrowserProps> = (props) => {
                   const pct = () =>
                     profilerTotalMs() > 0 ? (row.ms / profilerTotalMs()) * 100 : 0;
                   const label = () => row.name || `#${row.node_uid}`;
+                  const allocs = () =>
+                    row.allocs + row.allocs_reused > 0
+                      ? `\n${row.allocs} attribute allocs (${(row.bytes_alloc / 1048576).toFixed(1)} MB), ` +
+                        `${row.allocs_reused} reused (${(row.bytes_reused / 1048576).toFixed(1)} MB)`
+                      : '';
                   return (
-                    <div class="profiler-row" title={`uid ${row.node_uid}${row.parent_node_uid ? ` (inside #${row.parent_node_uid})` : ''}`}>
+                    <div class="profiler-row" title={`uid ${row.node_uid}${row.parent_node_uid ? ` (inside #${row.parent_node_uid})` : ''}${allocs()}`}>
                       <span class="profiler-cell profiler-cell-bar">
                         <span
                           class="profiler-bar-fill"
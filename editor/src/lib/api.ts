@@ -42,6 +42,9 @@ export interface Camera {
   // Motion-blur shutter as a fraction of the frame interval (0 = off). Applied
   // on sequence/EXR export — moving objects blur over [t, t+shutter/fps].
   shutter?: number;
+  // Scene evaluations across the shutter (>= 2). More samples follow curved
+  // paths and non-linear deformation.
+  motion_samples?: number;
 }
 
 export interface Actor {
@@ -255,3 +255,110 @@ export function emptyGraph(): SopGraph {
     connections: [],
   };
 }
+
+// ── Incremental patches ───────────────────────────────────────────────────
+//
+// Mirror of the C++ applySopGraphPatch op list (see
+// src/sops/serialization.hpp). The store diffs its last committed graph
+// against the current one and ships only the ops, so a slider drag doesn't
+// make the engine re-parse the whole tree on every step.
+
+export type SopPatchOp =
+  | { op: 'set_param'; node: number; name: string; param: ParamValue }
+  | { op: 'set_bypass'; node: number; bypass: boolean }
+  | { op: 'set_pos'; node: number; pos: [number, number] }
+  | { op: 'add_node'; parent: number; node: SopNode }
+  | { op: 'replace_node'; node: SopNode }
+  | { op: 'remove_node'; node: number }
+  | ({ op: 'connect' } & SopConnection)
+  | ({ op: 'disconnect' } & SopConnection);
+
+// JSON with object keys sorted, so values that only differ in key order
+// (engine-serialized vs. built by the store) compare equal.
+function canonicalJson(v: unknown): string {
+  return JSON.stringify(v, (_key, value) => {
+    if (value && typeof value === 'object' && !Array.isArray(value)) {
+      const sorted: Record<string, unknown> = {};
+      for (const k of Object.keys(value).sort()) sorted[k] = (value as Record<string, unknown>)[k];
+      return sorted;
+    }
+    return value;
+  });
+}
+
+// Everything on a node except the fields that have their own op.
+const OWN_OP_FIELDS = new Set(['uid', 'pos', 'params', 'bypass', 'subgraph']);
+function nodeIdentity(n: SopNode): string {
+  const rest: Record<string, unknown> = { hasSubgraph: !!n.subgraph };
+  for (const [k, v] of Object.entries(n)) {
+    if (!OWN_OP_FIELDS.has(k)) rest[k] = v;
+  }
+  return canonicalJson(rest);
+}
+
+const connKey = (c: SopConnection) => `${c.from_node}:${c.from_port}>${c.to_node}:${c.to_port}`;
+
+// Append the ops turning `prev` into `next` (one graph level, `parent` =
+// owning subnet uid or 0). Returns false when the edit can't be expressed
+// as a patch that leaves the engine's graph identical — today only a
+// reordering of surviving nodes.
+function diffGraphInto(prev: SopGraph, next: SopGraph, parent: number, ops: SopPatchOp[]): boolean {
+  const prevByUid = new Map(prev.nodes.map((n) => [n.uid, n]));
+  const nextByUid = new Map(next.nodes.map((n) => [n.uid, n]));
+
+  // Surviving nodes must keep their relative order and new ones must come
+  // last: add_node appends, just as the store's mutators do.
+  const survivors = prev.nodes.filter((n) => nextByUid.has(n.uid)).map((n) => n.uid);
+  const added = next.nodes.filter((n) => !prevByUid.has(n.uid));
+  const expected = [...survivors, ...added.map((n) => n.uid)];
+  if (expected.some((uid, i) => next.nodes[i].uid !== uid)) return false;
+
+  const removed = new Set<number>();
+  for (const n of prev.nodes) {
+    if (!nextByUid.has(n.uid)) {
+      ops.push({ op: 'remove_node', node: n.uid });
+      removed.add(n.uid);
+    }
+  }
+
+  const nested: [SopGraph, SopGraph, number][] = [];
+  for (const uid of survivors) {
+    const a = prevByUid.get(uid)!;
+    const b = nextByUid.get(uid)!;
+    const droppedParam = Object.keys(a.params).some((k) => !(k in b.params));
+    if (droppedParam || nodeIdentity(a) !== nodeIdentity(b)) {
+      ops.push({ op: 'replace_node', node: b });
+      continue;
+    }
+    for (const [name, param] of Object.entries(b.params)) {
+      if (canonicalJson(a.params[name]) !== canonicalJson(param)) {
+        ops.push({ op: 'set_param', node: uid, name, param });
+      }
+    }
+    if (!!a.bypass !== !!b.bypass) ops.push({ op: 'set_bypass', node: uid, bypass: !!b.bypass });
+    if (a.pos[0] !== b.pos[0] || a.pos[1] !== b.pos[1]) ops.push({ op: 'set_pos', node: uid, pos: b.pos });
+    if (a.subgraph && b.subgraph) nested.push([a.subgraph, b.subgraph, uid]);
+  }
+  for (const n of added) ops.push({ op: 'add_node', parent, node: n });
+
+  const prevConns = new Set(prev.connections.map(connKey));
+  const nextConns = new Set(next.connections.map(connKey));
+  for (const c of prev.connections) {
+    // remove_node already dropped edges touching deleted nodes.
+    if (removed.has(c.from_node) || removed.has(c.to_node)) continue;
+    if (!nextConns.has(connKey(c))) ops.push({ op: 'disconnect', ...c });
+  }
+  for (const c of next.connections) {
+    if (!prevConns.has(connKey(c))) ops.push({ op: 'connect', ...c });
+  }
+
+  return nested.every(([a, b, uid]) => diffGraphInto(a, b, uid, ops));
+}
+
+// Ops turning `prev` into `next`, or null when a full set_sop_graph push is
+// needed instead. An empty list means nothing changed.
+export function diffSopGraph(prev: SopGraph, next: SopGraph): SopPatchOp[] | null {
+  if (prev.uid !== next.uid) return null;
+  const ops: SopPatchOp[] = [];
+  return diffGraphInto(prev, next, 0, ops) ? ops : null;
+}
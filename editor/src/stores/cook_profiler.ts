@@ -14,6 +14,12 @@ export interface NodeCookTimingRow {
   kind: string;
   name: string;             // node's `name` param if any, else ""
   ms: number;
+  // Attribute storage requests during the cook: fresh heap allocations vs
+  // buffers recycled from the cook cache's pool.
+  allocs: number;
+  allocs_reused: number;
+  bytes_alloc: number;
+  bytes_reused: number;
 }
 
 export interface CookProfile {
@@ -41,6 +47,10 @@ api.listen('cook_timings', (msg) => {
       kind:            typeof rec.kind === 'string' ? rec.kind : '',
       name:            typeof rec.name === 'string' ? rec.name : '',
       ms:              typeof rec.ms === 'number' ? rec.ms : 0,
+      allocs:          typeof rec.allocs === 'number' ? rec.allocs : 0,
+      allocs_reused:   typeof rec.allocs_reused === 'number' ? rec.allocs_reused : 0,
+      bytes_alloc:     typeof rec.bytes_alloc === 'number' ? rec.bytes_alloc : 0,
+      bytes_reused:    typeof rec.bytes_reused === 'number' ? rec.bytes_reused : 0,
     };
   });
   setProfile({
@@ -8,8 +8,8 @@
 // `subgraph` field. The store keeps the entire tree as a single recursive
 // SopGraph and tracks "where the user is editing" via `currentPath` — a list
 // of subnet uids from root. Mutators take an implicit path and rebuild the
-// chain immutably back to the root, so a single debounced push always sends
-// the whole nested graph.
+// chain immutably back to the root, so one debounced push covers the whole
+// nested graph — sent as a patch of what changed when possible (pushGraph).
 
 import { createSignal } from 'solid-js';
 import * as api from '../lib/api';
@@ -23,6 +23,7 @@ import {
   Interp,
   Keyframe,
   emptyGraph,
+  diffSopGraph,
   syncNextUidRecursive,
   makeNode,
   lookupCatalog,
@@ -117,11 +118,7 @@ function doLivePush() {
   // Position-only edits (canvas node drags) leave structuralKey unchanged
   // and ride the trailing debounce with cook:false, exactly as before.
   if (structuralKey(snapshot) !== structuralKey(lastCommittedGraph)) {
-    lastCommittedGraph = structuredClone(snapshot);
-    api.send<null>('set_sop_graph', {
-      graph: JSON.stringify(snapshot),
-      cook: true,
-    }).catch((e) => {
+    pushGraph(snapshot, true).catch((e) => {
       const msg = e instanceof Error ? e.message : JSON.stringify(e);
       console.error('Failed to push SOP graph (live):', msg);
     });
@@ -134,6 +131,31 @@ function doLivePush() {
   }, PUSH_LIVE_MS);
 }
 
+// Send `snapshot` to the engine as a patch against lastCommittedGraph when
+// the edit can be expressed as one (apply_sop_graph_patch: the engine edits
+// its graph in place and re-cooks only the touched nodes), else as the
+// whole graph. lastCommittedGraph moves before the await so a push issued
+// while this one is in flight diffs against the right base. A rejected
+// patch falls back to the full graph, which resets the engine side.
+async function pushGraph(snapshot: SopGraph, cook: boolean): Promise<void> {
+  const ops = diffSopGraph(lastCommittedGraph, snapshot);
+  lastCommittedGraph = structuredClone(snapshot);
+  if (ops && ops.length === 0) return;
+  if (ops) {
+    try {
+      await api.send<null>('apply_sop_graph_patch', {
+        patch: JSON.stringify({ version: 1, ops }),
+        cook,
+      });
+      return;
+    } catch (e) {
+      const msg = e instanceof Error ? e.message : JSON.stringify(e);
+      console.warn('SOP graph patch rejected, pushing full graph:', msg);
+    }
+  }
+  await api.send<null>('set_sop_graph', { graph: JSON.stringify(snapshot), cook });
+}
+
 function scheduleLivePush() {
   if (liveCooldown) {
     livePending = true;
@@ -221,11 +243,7 @@ function schedulePush() {
     const snapshot = graph();
     const cookNeeded = structuralKey(snapshot) !== structuralKey(lastCommittedGraph);
     try {
-      await api.send<null>('set_sop_graph', {
-        graph: JSON.stringify(snapshot),
-        cook: cookNeeded,
-      });
-      lastCommittedGraph = structuredClone(snapshot);
+      await pushGraph(snapshot, cookNeeded);
     } catch (e) {
       const msg = e instanceof Error ? e.message : JSON.stringify(e);
       console.error('Failed to push SOP graph:', msg);
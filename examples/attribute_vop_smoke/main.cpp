@@ -10,6 +10,17 @@
 //   • At least one position differs from the input cube's positions
 //     (i.e. the noise was actually applied).
 //   • The VopGraph round-trips through serialize → deserialize byte-stable.
+//   • The shared noise kernels (core/noise.hpp) return bit-identical values
+//     batched (full 8-lane blocks + a ragged tail) and one point at a time,
+//     and reports their batched throughput in points/sec.
+//   • The point KD-tree's k-nearest and radius queries match brute force,
+//     the tree is cached on the point table until P changes, the
+//     pc_nearest / pc_radius VOPs agree with it inside an attribute_vop
+//     cook, and point_relax pulls the closest pair apart.
+//   • The ray SOP projects points onto a collision surface exactly, the
+//     collision BVH is shared by content hash, the intersect VOP agrees
+//     with the SOP through attribute_vop's collision input, and reports
+//     rays/sec for a large projection.
 //
 // Exit 0 on success, non-zero on first failed check.
 //
@@ -17,7 +28,11 @@
 //   cmake --build build --target attribute_vop_smoke && \
 //     ./build/examples/attribute_vop_smoke
 
+#include "core/noise.hpp"
+#include "geometry/attribute.hpp"
 #include "geometry/geometry.hpp"
+#include "geometry/geometry_blas.hpp"
+#include "geometry/point_kdtree.hpp"
 #include "scene/scene_object.hpp"
 
 #include "sops/serialization.hpp"
@@ -32,9 +47,15 @@
 #include "vops/vop_node.hpp"
 #include "vops/vop_registry.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace {
 
@@ -176,6 +197,386 @@ int main()
         check(sopRoundtrip == sopJson, "SOP graph (with VOP child) round-trips byte-stable");
     }
 
+    // ── Noise kernels: batched == single point, and throughput ──
+    {
+        // 1021 points: full 16-point iterations, one lone 8-lane block and
+        // a 5-point single-lane tail.
+        const size_t n = 1021;
+        std::vector<float> x(n), y(n), z(n), a(n), b(n), c(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i] = std::sin(static_cast<float>(i) * 0.37f) * 5.0f;
+            y[i] = std::cos(static_cast<float>(i) * 0.11f) * 7.0f - 3.0f;
+            z[i] = static_cast<float>(i) * 0.013f - 4.0f;
+        }
+        auto same = [](float u, float v) { return std::memcmp(&u, &v, sizeof(float)) == 0; };
+        noise::Fractal fr;
+        fr.octaves = 4;
+
+        bool perlinOk = true, simplexOk = true, worleyOk = true, fbmOk = true, curlOk = true;
+        bool anyNonZero = false;
+        noise::perlin(x.data(), y.data(), z.data(), a.data(), n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            perlinOk &= same(a[i], noise::perlin(Vec3(x[i], y[i], z[i])));
+            anyNonZero |= a[i] != 0.0f;
+        }
+        noise::simplex(x.data(), y.data(), z.data(), a.data(), n);
+        for (size_t i = 0; i < n; ++i) simplexOk &= same(a[i], noise::simplex(Vec3(x[i], y[i], z[i])));
+        noise::worley(x.data(), y.data(), z.data(), 7, a.data(), n);
+        for (size_t i = 0; i < n; ++i) worleyOk &= same(a[i], noise::worley(Vec3(x[i], y[i], z[i]), 7));
+        noise::fbm(x.data(), y.data(), z.data(), fr, a.data(), n);
+        for (size_t i = 0; i < n; ++i) fbmOk &= same(a[i], noise::fbm(Vec3(x[i], y[i], z[i]), fr));
+        noise::curl(x.data(), y.data(), z.data(), 3, 1e-3f, a.data(), b.data(), c.data(), n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const Vec3 r = noise::curl(Vec3(x[i], y[i], z[i]), 3, 1e-3f);
+            curlOk &= same(a[i], r.x) && same(b[i], r.y) && same(c[i], r.z);
+        }
+        check(anyNonZero, "noise: perlin field is not identically zero");
+        check(perlinOk, "noise: batched perlin == single-point perlin (bitwise)");
+        check(simplexOk, "noise: batched simplex == single-point simplex (bitwise)");
+        check(worleyOk, "noise: batched worley == single-point worley (bitwise)");
+        check(fbmOk, "noise: batched fbm == single-point fbm (bitwise)");
+        check(curlOk, "noise: batched curl == single-point curl (bitwise)");
+
+        // Throughput, single thread, 1M points per kernel.
+        const size_t m = size_t(1) << 20;
+        std::vector<float> bx(m), by(m), bz(m), o0(m), o1(m), o2(m);
+        for (size_t i = 0; i < m; ++i)
+        {
+            bx[i] = static_cast<float>(i % 1024) * 0.031f;
+            by[i] = static_cast<float>(i / 1024) * 0.027f;
+            bz[i] = 0.37f;
+        }
+        auto rate = [m](auto &&fn) {
+            const auto t0 = std::chrono::steady_clock::now();
+            fn();
+            const auto t1 = std::chrono::steady_clock::now();
+            return static_cast<double>(m) / std::chrono::duration<double>(t1 - t0).count();
+        };
+        const double perlinRate = rate([&] { noise::perlin(bx.data(), by.data(), bz.data(), o0.data(), m); });
+        const double scalarRate = rate([&] {
+            for (size_t i = 0; i < m; ++i) o1[i] = noise::perlin(Vec3(bx[i], by[i], bz[i]));
+        });
+        const double simplexRate = rate([&] { noise::simplex(bx.data(), by.data(), bz.data(), o0.data(), m); });
+        const double worleyRate = rate([&] { noise::worley(bx.data(), by.data(), bz.data(), 0, o0.data(), m); });
+        const double fbmRate = rate([&] { noise::fbm(bx.data(), by.data(), bz.data(), fr, o0.data(), m); });
+        const double curlRate = rate([&] {
+            noise::curl(bx.data(), by.data(), bz.data(), 0, 1e-3f, o0.data(), o1.data(), o2.data(), m);
+        });
+        std::printf("  noise throughput (Mpoints/s, 1 thread): perlin %.1f (single-point %.1f), "
+                    "simplex %.1f, worley %.1f, fbm×4 %.1f, curl %.1f\n",
+                    perlinRate * 1e-6, scalarRate * 1e-6, simplexRate * 1e-6, worleyRate * 1e-6,
+                    fbmRate * 1e-6, curlRate * 1e-6);
+    }
+
+    // ── Point KD-tree + point-cloud VOPs + point_relax ──
+    {
+        const size_t n = 3000;
+        Geometry cloud;
+        cloud.resizePoints(n);
+        {
+            auto &P = cloud.positions();
+            uint32_t h = 12345u;
+            auto rnd = [&h] {
+                h ^= h << 13; h ^= h >> 17; h ^= h << 5;
+                return static_cast<float>(h & 0xFFFFFFu) / static_cast<float>(0x1000000u);
+            };
+            for (size_t i = 0; i < n; ++i) P[i] = Vec3(rnd(), rnd(), rnd() * 0.25f);
+            // A few exact duplicates so ties are exercised.
+            for (size_t i = 0; i < 16; ++i) P[n - 1 - i] = P[i];
+        }
+        const std::vector<Vec3> &P = std::as_const(cloud).positions();
+        auto dist2 = [](const Vec3 &a, const Vec3 &b) {
+            const float ex = a.x - b.x, ey = a.y - b.y, ez = a.z - b.z;
+            return ex * ex + ey * ey + ez * ez;
+        };
+
+        const auto tree = acquirePointKdTree(std::as_const(cloud).points());
+        check(tree && tree->size() == n, "kdtree: built over every point");
+        check(acquirePointKdTree(std::as_const(cloud).points()) == tree,
+              "kdtree: second acquire reuses the cached tree");
+
+        const int k = 12;
+        const float radius = 0.08f;
+        bool knnOk = true, radiusOk = true;
+        for (size_t qi = 0; qi < n; qi += 7)
+        {
+            const Vec3 q = P[qi];
+            std::vector<std::pair<float, uint32_t>> brute;
+            for (size_t j = 0; j < n; ++j)
+                if (j != qi) brute.push_back({dist2(q, P[j]), static_cast<uint32_t>(j)});
+            std::sort(brute.begin(), brute.end());
+
+            uint32_t idx[PointKdTree::kMaxK];
+            float d2[PointKdTree::kMaxK];
+            const int found = tree->findNearest(q, k, 1e30f, static_cast<uint32_t>(qi), idx, d2);
+            knnOk &= found == k;
+            for (int i = 0; i < found && knnOk; ++i)
+                knnOk &= idx[i] == brute[i].second && d2[i] == brute[i].first;
+
+            size_t inRadius = 0;
+            for (const auto &b : brute) inRadius += b.first <= radius * radius ? 1 : 0;
+            size_t visited = 0;
+            tree->forEachInRadius(q, radius, [&](uint32_t j, const Vec3 &, float) {
+                visited += j != qi ? 1 : 0;
+            });
+            radiusOk &= visited == inRadius;
+        }
+        check(knnOk, "kdtree: k-nearest == brute force (order, index, distance)");
+        check(radiusOk, "kdtree: radius query visits exactly the brute-force set");
+
+        // pc_nearest(count=1).closest_dist → pscale,
+        // pc_radius(radius).count → Alpha, inside an attribute_vop cook.
+        auto host = SopRegistry::instance().create("attribute_vop", 1);
+        vops::VopGraph *g = attributeVopGraph(host.get());
+        check(g != nullptr, "pc: attribute_vop exposes VopGraph");
+        if (g)
+        {
+            auto nearest = vops::VopRegistry::instance().create("pc_nearest", g->nextUid());
+            auto inRad   = vops::VopRegistry::instance().create("pc_radius",  g->nextUid());
+            auto out     = vops::VopRegistry::instance().create("geo_output", g->nextUid());
+            check(nearest && inRad && out, "pc: create point-cloud VOP nodes");
+            nearest->setParamInt("count", 1);
+            inRad->setParamFloat("radius", radius);
+            // The cloud has no pscale / Alpha yet; have geo_output add them.
+            out->setParamBool("passthrough_pscale", false);
+            out->setParamBool("passthrough_Alpha", false);
+            const size_t nearestUid = nearest->uid(), radUid = inRad->uid(), outUid2 = out->uid();
+            g->addNode(std::move(nearest));
+            g->addNode(std::move(inRad));
+            g->addNode(std::move(out));
+            g->createConnection(nearestUid, 4, outUid2, 7); // closest_dist → pscale
+            g->createConnection(radUid, 0, outUid2, 6);     // count → Alpha
+
+            const Geometry *in[] = {&cloud};
+            const Geometry cooked = host->cook(in);
+            const auto *pscale = cooked.points().get<float>("pscale");
+            const auto *alpha = cooked.points().get<float>("Alpha");
+            bool vopOk = pscale && alpha;
+            for (size_t i = 0; vopOk && i < n; ++i)
+            {
+                float best = 1e30f;
+                size_t count = 0;
+                for (size_t j = 0; j < n; ++j)
+                {
+                    if (j == i) continue;
+                    const float d = dist2(P[i], P[j]);
+                    best = std::min(best, d);
+                    count += d <= radius * radius ? 1 : 0;
+                }
+                vopOk &= std::as_const(*pscale).data()[i] == std::sqrt(best) &&
+                         std::as_const(*alpha).data()[i] == static_cast<float>(count);
+            }
+            check(vopOk, "pc: pc_nearest / pc_radius VOPs match brute force");
+        }
+
+        // point_relax: the closest distinct pair ends up further apart.
+        auto closestPair = [&](const std::vector<Vec3> &pts) {
+            float best = 1e30f;
+            for (size_t i = 0; i < pts.size(); ++i)
+                for (size_t j = i + 1; j < pts.size(); ++j)
+                {
+                    const float d = dist2(pts[i], pts[j]);
+                    if (d > 0.0f) best = std::min(best, d);
+                }
+            return std::sqrt(best);
+        };
+        auto relax = SopRegistry::instance().create("point_relax", 2);
+        check(relax != nullptr, "create point_relax");
+        if (relax)
+        {
+            relax->setParamFloat("radius", 0.02f);
+            relax->setParamInt("iterations", 8);
+            const Geometry *in[] = {&cloud};
+            const Geometry relaxed = relax->cook(in);
+            const float before = closestPair(P);
+            const float after = closestPair(std::as_const(relaxed).positions());
+            std::printf("  point_relax closest pair: %.5f -> %.5f\n", before, after);
+            check(after > before, "point_relax: closest distinct pair moves apart");
+        }
+
+        // Throughput: 200k points, build + k=8 queries for each point.
+        const size_t m = 200000;
+        std::vector<Vec3> big(m);
+        for (size_t i = 0; i < m; ++i)
+            big[i] = Vec3(std::sin(i * 0.731f), std::cos(i * 0.377f), std::sin(i * 0.113f + 1.0f));
+        const auto t0 = std::chrono::steady_clock::now();
+        PointKdTree bigTree;
+        bigTree.build(big);
+        const auto t1 = std::chrono::steady_clock::now();
+        uint64_t sink = 0;
+        for (size_t i = 0; i < m; ++i)
+        {
+            uint32_t idx[8];
+            float d2[8];
+            sink += static_cast<uint64_t>(bigTree.findNearest(big[i], 8, 1e30f, static_cast<uint32_t>(i), idx, d2));
+        }
+        const auto t2 = std::chrono::steady_clock::now();
+        std::printf("  kdtree 200k points: build %.1f ms, k=8 queries %.2f Mq/s (1 thread, %llu hits)\n",
+                    std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                    static_cast<double>(m) / std::chrono::duration<double>(t2 - t1).count() * 1e-6,
+                    static_cast<unsigned long long>(sink));
+    }
+
+    // ── ray SOP + intersect VOP ──
+    {
+        // Collision: an (g × g)-quad grid over [-1, 1]² on the plane
+        // y = 0.3x + 0.1z + 0.5, so projected points have an exact answer.
+        auto makeGrid = [](int g, auto &&height) {
+            Geometry geo;
+            geo.resizePoints(static_cast<size_t>((g + 1) * (g + 1)));
+            auto &P = geo.positions();
+            for (int j = 0; j <= g; ++j)
+                for (int i = 0; i <= g; ++i)
+                {
+                    const float x = -1.0f + 2.0f * i / g, z = -1.0f + 2.0f * j / g;
+                    P[j * (g + 1) + i] = Vec3(x, height(x, z), z);
+                }
+            for (int j = 0; j < g; ++j)
+                for (int i = 0; i < g; ++i)
+                {
+                    const uint32_t a = j * (g + 1) + i, b = a + 1, c = a + (g + 1), d = c + 1;
+                    geo.addTriangle(a, c, b);
+                    geo.addTriangle(b, c, d);
+                }
+            return geo;
+        };
+        auto plane = [](float x, float z) { return 0.3f * x + 0.1f * z + 0.5f; };
+        const Geometry collision = makeGrid(32, plane);
+
+        // Points on a 40×40 lattice over [-1.2, 1.2]², 3 units up: the outer
+        // ring misses the collision grid.
+        Geometry cloud;
+        const int m = 40;
+        cloud.resizePoints(static_cast<size_t>(m * m));
+        {
+            auto &P = cloud.positions();
+            for (int j = 0; j < m; ++j)
+                for (int i = 0; i < m; ++i)
+                    P[j * m + i] = Vec3(-1.2f + 2.4f * (i + 0.5f) / m, 3.0f, -1.2f + 2.4f * (j + 0.5f) / m);
+        }
+
+        auto ray = SopRegistry::instance().create("ray", 1);
+        check(ray != nullptr, "create ray");
+        if (ray)
+        {
+            const Geometry *in[] = {&cloud, &collision};
+            const Geometry projected = ray->cook(in);
+            const auto &Pin = std::as_const(cloud).positions();
+            const auto &Pout = std::as_const(projected).positions();
+            const auto *dist = projected.points().get<float>("hitdist");
+            const auto *prim = projected.points().get<int>("hitprim");
+            bool projOk = dist && prim, missOk = dist && prim;
+            size_t hits = 0;
+            for (size_t i = 0; dist && prim && i < Pin.size(); ++i)
+            {
+                const Vec3 p = Pin[i];
+                const float d = std::as_const(*dist).data()[i];
+                const int pr = std::as_const(*prim).data()[i];
+                if (std::abs(p.x) <= 1.0f && std::abs(p.z) <= 1.0f)
+                {
+                    const float y = plane(p.x, p.z);
+                    projOk &= std::abs(Pout[i].y - y) < 1e-4f && Pout[i].x == p.x && Pout[i].z == p.z &&
+                              std::abs(d - (p.y - y)) < 1e-4f && pr >= 0;
+                    ++hits;
+                }
+                else
+                {
+                    missOk &= d == -1.0f && pr == -1 && Pout[i].y == p.y;
+                }
+            }
+            check(hits > 0 && projOk, "ray: points land on the collision plane with the right hitdist");
+            check(missOk, "ray: points off the surface keep P and report a miss");
+        }
+
+        const auto blasA = acquireGeometryBlas(collision);
+        check(blasA && blasA->triangleCount() == 32 * 32 * 2, "ray: collision BVH covers every triangle");
+        check(acquireGeometryBlas(collision) == blasA, "ray: unchanged collision reuses the cached BVH");
+        Geometry moved = collision;
+        moved.positions()[0].y += 0.25f;
+        check(acquireGeometryBlas(moved) != blasA, "ray: edited collision gets a fresh BVH");
+
+        // Sign flips in two words used to cancel in the word-wise FNV hash
+        // (both of these hashed to 0x3e6826a4d6c71917).
+        {
+            Geometry quad;
+            for (const Vec3 &p : {Vec3(1, 2, 3), Vec3(4, 5, 6), Vec3(7, 8, 9), Vec3(10, 11, 12)})
+                quad.addPoint(p);
+            quad.addTriangle(0, 1, 2);
+            quad.addTriangle(1, 3, 2);
+            Geometry flipped = quad;
+            flipped.positions()[1].x = -flipped.positions()[1].x;
+            flipped.positions()[3].x = -flipped.positions()[3].x;
+            check(geometryContentHash(quad) != geometryContentHash(flipped),
+                  "ray: sign flips in two points change the content hash");
+            const auto quadBlas = acquireGeometryBlas(quad);
+            const auto flippedBlas = acquireGeometryBlas(flipped);
+            check(quadBlas != flippedBlas && quadBlas->matches(quad) && flippedBlas->matches(flipped) &&
+                      !quadBlas->matches(flipped),
+                  "ray: a different mesh never gets a cached BVH built for another");
+        }
+
+        // intersect VOP through attribute_vop's collision input, straight
+        // down from P: dist → pscale must match the SOP's hitdist.
+        auto host = SopRegistry::instance().create("attribute_vop", 2);
+        vops::VopGraph *g = attributeVopGraph(host.get());
+        if (g && ray)
+        {
+            auto isect = vops::VopRegistry::instance().create("intersect", g->nextUid());
+            auto out = vops::VopRegistry::instance().create("geo_output", g->nextUid());
+            check(isect && out, "intersect: create VOP nodes");
+            out->setParamBool("passthrough_pscale", false);
+            const size_t isectUid = isect->uid(), outUid2 = out->uid();
+            g->addNode(std::move(isect));
+            g->addNode(std::move(out));
+            g->createConnection(isectUid, 2, outUid2, 7); // dist → pscale
+
+            const Geometry *in[] = {&cloud, &collision};
+            const Geometry cooked = host->cook(in);
+            const Geometry projected = ray->cook(in);
+            const auto *pscale = cooked.points().get<float>("pscale");
+            const auto *dist = projected.points().get<float>("hitdist");
+            bool same = pscale && dist;
+            for (size_t i = 0; same && i < cloud.pointCount(); ++i)
+                same &= std::as_const(*pscale).data()[i] == std::as_const(*dist).data()[i];
+            check(same, "intersect: VOP hit distances == ray SOP hitdist");
+        }
+
+        // Throughput: 256k rays down onto a 256×256-quad sine terrain.
+        const Geometry terrain = makeGrid(256, [](float x, float z) {
+            return 0.2f * std::sin(x * 9.0f) * std::cos(z * 7.0f);
+        });
+        Geometry rays;
+        const int r = 512;
+        rays.resizePoints(static_cast<size_t>(r * r));
+        {
+            auto &P = rays.positions();
+            for (int j = 0; j < r; ++j)
+                for (int i = 0; i < r; ++i)
+                    P[j * r + i] = Vec3(-1.0f + 2.0f * (i + 0.5f) / r, 1.0f, -1.0f + 2.0f * (j + 0.5f) / r);
+        }
+        if (ray)
+        {
+            const Geometry *in[] = {&rays, &terrain};
+            const auto t0 = std::chrono::steady_clock::now();
+            const Geometry first = ray->cook(in);
+            const auto t1 = std::chrono::steady_clock::now();
+            const Geometry second = ray->cook(in);
+            const auto t2 = std::chrono::steady_clock::now();
+            const double cold = std::chrono::duration<double>(t1 - t0).count();
+            const double warm = std::chrono::duration<double>(t2 - t1).count();
+            std::printf("  ray 256k rays vs 131k tris: first cook %.1f ms (incl. BVH build), "
+                        "cached %.1f ms = %.2f Mrays/s\n",
+                        cold * 1e3, warm * 1e3, static_cast<double>(r) * r / warm * 1e-6);
+            const auto *d = second.points().get<float>("hitdist");
+            bool allHit = d != nullptr;
+            for (size_t i = 0; allHit && i < rays.pointCount(); ++i) allHit &= std::as_const(*d).data()[i] > 0.0f;
+            check(allHit, "ray: every terrain ray hits");
+        }
+    }
+
     if (failures == 0)
         std::printf("[attribute_vop_smoke] all checks passed\n");
     else
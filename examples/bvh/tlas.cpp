@@ -2,6 +2,9 @@
 #include "../../src/core/blas.hpp"
 #include "../../src/core/tlas.hpp"
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/transform.hpp>
 int main()
@@ -29,6 +32,7 @@ int main()
     tracey::Ray ray;
     ray.origin = tracey::Vec3(0, 0, 0);
     ray.direction = glm::normalize(tracey::Vec3(-0.5, 0, 1));
+    ray.invDirection = 1.0f / ray.direction;
     const auto tMin = 0.0f;
     const auto tMax = 100.0f;
     tracey::RayFlags flags = tracey::RAY_FLAG_TERMINATE_ON_FIRST_HIT;
@@ -48,6 +52,7 @@ int main()
     // 6) Shoot a ray from the origin to +X direction, hitting the triangle on the right
     ray.origin = tracey::Vec3(0, 0, 0);
     ray.direction = glm::normalize(tracey::Vec3(0.5, 0, 1));
+    ray.invDirection = 1.0f / ray.direction;
     if (const auto intersection = tlas.intersect(ray, tMin, tMax, flags); intersection)
     {
         std::cout << "Hit instance " << intersection->instanceId
@@ -61,5 +66,108 @@ int main()
         std::cout << "No hit\n";
     }
 
-    return 0;
+    // 7) Nested instancing: the two instances above become a group, placed
+    //    twice (shifted up and down). The top level holds 2 entries + the
+    //    group's 2, instead of 4 flat ones. Hits report the leaf's record:
+    //    the group's records start after the top level's (2 + 0 or 2 + 1).
+    const tracey::Tlas group(std::span<const tracey::Blas *>(&blasPtr, 1), {}, instances, instances,
+                             false, tracey::Tlas::Config{}, /*recordBase=*/2);
+    std::array<tracey::Tlas::Instance, 2> placements;
+    placements[0].setGroupReference(0);
+    placements[0].setTransform(glm::translate(tracey::Vec3(0, 5, 0)));
+    placements[1].setGroupReference(0);
+    placements[1].setTransform(glm::translate(tracey::Vec3(0, -5, 0)));
+    const tracey::Tlas *groupPtr = &group;
+    const tracey::Tlas nested(std::span<const tracey::Blas *>(&blasPtr, 1),
+                              std::span<const tracey::Tlas *const>(&groupPtr, 1),
+                              placements, placements, false, tracey::Tlas::Config{});
+    std::cout << "Nested TLAS: " << nested.levels() << " instance levels\n";
+
+    // The +X ray again, 5 units down: hits the right triangle of the lower copy.
+    ray.origin = tracey::Vec3(0, -5, 0);
+    ray.direction = glm::normalize(tracey::Vec3(0.5, 0, 1));
+    ray.invDirection = 1.0f / ray.direction;
+    if (const auto intersection = nested.intersect(ray, tMin, tMax, flags); intersection)
+    {
+        std::cout << "Hit record " << intersection->instanceId
+                  << " at t = " << intersection->t
+                  << " pos = (" << intersection->position.x << ", "
+                  << intersection->position.y << ", "
+                  << intersection->position.z << ")\n";
+    }
+    else
+    {
+        std::cout << "No hit\n";
+    }
+
+    // 8) Curved motion: three pose keys move the left instance out to x = +2
+    //    mid-shutter and back. A ray aimed at x = +2 hits it only around
+    //    time 0.5; the two-pose (open/close) version never moves it at all.
+    std::array<tracey::Tlas::Instance, 1> key0, key1, key2;
+    key0[0].blasAddress = 0;
+    key0[0].setTransform(glm::translate(tracey::Vec3(-2, 0, 0)));
+    key1 = key0;
+    key1[0].setTransform(glm::translate(tracey::Vec3(2, 0, 0)));
+    key2 = key0;
+    const std::span<const tracey::Tlas::Instance> keys[3] = {key0, key1, key2};
+    const tracey::Tlas curved(std::span<const tracey::Blas *>(&blasPtr, 1), {},
+                              std::span<const std::span<const tracey::Tlas::Instance>>(keys, 3),
+                              tracey::Tlas::Config{});
+    ray.origin = tracey::Vec3(2, 0, 0);
+    ray.direction = tracey::Vec3(0, 0, 1);
+    ray.invDirection = 1.0f / ray.direction;
+    int failures = 0;
+    for (const float time : {0.0f, 0.5f, 0.99f})
+    {
+        ray.time = time;
+        const bool hit = curved.intersect(ray, tMin, tMax, flags).has_value();
+        std::cout << "Curved motion (" << curved.motionKeyCount() << " keys) at time " << time
+                  << ": " << (hit ? "hit" : "no hit") << "\n";
+        failures += hit != (time == 0.5f);
+    }
+
+    // Two keys through the new constructor trace exactly like the
+    // open/close constructor.
+    const std::span<const tracey::Tlas::Instance> pair[2] = {key0, key1};
+    const tracey::Tlas twoKeys(std::span<const tracey::Blas *>(&blasPtr, 1), {},
+                               std::span<const std::span<const tracey::Tlas::Instance>>(pair, 2),
+                               tracey::Tlas::Config{});
+    const tracey::Tlas openClose(std::span<const tracey::Blas *>(&blasPtr, 1), {}, key0, key1,
+                                 true, tracey::Tlas::Config{});
+    ray.origin = tracey::Vec3(0.3f, 0.2f, 0);
+    ray.time = 0.37f;
+    const auto a = twoKeys.intersect(ray, tMin, tMax, flags);
+    const auto b = openClose.intersect(ray, tMin, tMax, flags);
+    const bool same = a.has_value() == b.has_value() && (!a || a->t == b->t);
+    std::cout << "Two-key constructor matches open/close: " << (same ? "yes" : "no") << "\n";
+    failures += !same;
+
+    // 9) Nesting depth: wrap `nested` in one more level per step. Up to
+    //    kMaxInstanceLevels builds; one more throws instead of building a
+    //    hierarchy intersect() can't walk.
+    std::vector<std::unique_ptr<tracey::Tlas>> levels;
+    const tracey::Tlas *inner = &nested;
+    std::array<tracey::Tlas::Instance, 1> wrap;
+    wrap[0].setGroupReference(0);
+    bool threw = false;
+    for (int level = nested.levels() + 1; level <= tracey::Tlas::kMaxInstanceLevels + 1; ++level)
+    {
+        try
+        {
+            levels.push_back(std::make_unique<tracey::Tlas>(
+                std::span<const tracey::Blas *>(&blasPtr, 1), std::span<const tracey::Tlas *const>(&inner, 1),
+                wrap, wrap, false, tracey::Tlas::Config{}));
+            inner = levels.back().get();
+        }
+        catch (const std::invalid_argument &e)
+        {
+            threw = level > tracey::Tlas::kMaxInstanceLevels;
+            std::cout << "Nesting " << level << " levels: " << e.what() << "\n";
+            break;
+        }
+    }
+    std::cout << "Deepest accepted TLAS: " << inner->levels() << " instance levels\n";
+    failures += !threw || inner->levels() != tracey::Tlas::kMaxInstanceLevels;
+
+    return failures == 0 ? 0 : 1;
 }
\ No newline at end of file
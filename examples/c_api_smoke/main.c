@@ -7,6 +7,13 @@
  * links and passes, a third-party C/C++/FFI consumer can drive the renderer
  * with nothing but the flat ABI.
  *
+ * It then keeps the renderer alive and drives the persistent-scene path:
+ * moves the cube and recolours it in place, renders asynchronously with a
+ * progress callback (progressive frames + samples/sec), cancels a second
+ * async render mid-way, and checks the renderer is still usable afterwards.
+ * Finally it declares a two-cube instance group, places it twice, and renders
+ * with it (nested on the CPU backend, expanded elsewhere).
+ *
  * Usage: c_api_smoke [--backend cpu|metal|auto] [--size N] [--spp N] [--out f.ppm]
  * Exit code 0 on success, 1 on failure.
  */
@@ -33,6 +40,39 @@ static const uint32_t kCubeIndices[12 * 3] = {
     4, 5, 1,  4, 1, 0, /* bottom y- */
 };
 
+/* Async progress bookkeeping shared with the callback. */
+typedef struct progress_log
+{
+    uint32_t calls;
+    uint32_t last_samples;
+    double   last_rate;
+    size_t   last_bytes;
+    uint32_t cancel_after; /* 0 = never cancel from the callback */
+} progress_log;
+
+static int onProgress(const tracey_progress *p, void *user)
+{
+    progress_log *log = (progress_log *)user;
+    ++log->calls;
+    log->last_samples = p->samples_done;
+    log->last_rate = p->samples_per_second;
+    log->last_bytes = p->pixel_bytes;
+    return (log->cancel_after != 0 && log->calls >= log->cancel_after) ? 1 : 0;
+}
+
+/* Mean RGB over the pixels of an RGBA32F image. */
+static void meanRgb(const float *rgba, size_t pixels, double out[3])
+{
+    out[0] = out[1] = out[2] = 0.0;
+    for (size_t i = 0; i < pixels; ++i)
+    {
+        out[0] += rgba[i * 4 + 0];
+        out[1] += rgba[i * 4 + 1];
+        out[2] += rgba[i * 4 + 2];
+    }
+    out[0] /= (double)pixels; out[1] /= (double)pixels; out[2] /= (double)pixels;
+}
+
 static void identity4x4(float *m)
 {
     memset(m, 0, 16 * sizeof(float));
@@ -101,7 +141,8 @@ int main(int argc, char **argv)
 
     float xform[16];
     identity4x4(xform);
-    if (tracey_scene_add_instance(scn, "cube", &mat, xform) != 0)
+    const int cube = tracey_scene_add_instance(scn, "cube", &mat, xform);
+    if (cube < 0)
     {
         fprintf(stderr, "add_instance failed: %s\n", tracey_last_error());
         return 1;
@@ -211,6 +252,132 @@ int main(int argc, char **argv)
 
     if (out) { writePpm(out, beauty, size, size); printf("wrote %s\n", out); }
 
+    /* ── Persistent scene: incremental edits + async progressive render ── */
+    double before[3], after[3];
+    meanRgb(beauty, pixels, before);
+
+    /* Recolour the cube blue and push it off to the side: a material patch
+     * plus a TLAS-only rebuild, no recompile. */
+    mat.base_color[0] = 0.1f; mat.base_color[1] = 0.2f; mat.base_color[2] = 0.9f;
+    identity4x4(xform);
+    xform[12] = 0.75f;
+    if (tracey_scene_set_instance_material(scn, cube, &mat) != 0 ||
+        tracey_scene_set_instance_transform(scn, cube, xform) != 0)
+    {
+        fprintf(stderr, "FAIL: instance edit: %s\n", tracey_last_error());
+        ok = 0;
+    }
+    if (tracey_scene_set_instance_transform(scn, cube + 1, xform) >= 0)
+    {
+        fprintf(stderr, "FAIL: edit of an unknown instance id succeeded\n");
+        ok = 0;
+    }
+
+    progress_log log;
+    memset(&log, 0, sizeof(log));
+    if (tracey_render_async(r, scn, spp, onProgress, &log) != 0)
+    {
+        fprintf(stderr, "FAIL: render_async: %s\n", tracey_last_error());
+        ok = 0;
+    }
+    else
+    {
+        const tracey_render_status st = tracey_render_wait(r);
+        printf("async: status=%d, %u callbacks, %u samples, %.1f samples/sec\n",
+               (int)st, log.calls, log.last_samples, log.last_rate);
+        if (st != TRACEY_RENDER_COMPLETED)      { fprintf(stderr, "FAIL: async render did not complete: %s\n", tracey_last_error()); ok = 0; }
+        if (log.calls != spp)                   { fprintf(stderr, "FAIL: expected one progress callback per pass\n"); ok = 0; }
+        if (log.last_samples != spp)            { fprintf(stderr, "FAIL: final progress reports %u samples\n", log.last_samples); ok = 0; }
+        if (log.last_rate <= 0.0)               { fprintf(stderr, "FAIL: no sample rate reported\n"); ok = 0; }
+        if (log.last_bytes != pixels * 4 * sizeof(float)) { fprintf(stderr, "FAIL: progressive frame size\n"); ok = 0; }
+
+        tracey_readback_beauty(r, beauty);
+        meanRgb(beauty, pixels, after);
+        printf("mean rgb before=(%.3f %.3f %.3f) after=(%.3f %.3f %.3f)\n",
+               before[0], before[1], before[2], after[0], after[1], after[2]);
+        /* The orange cube turned blue: red falls relative to blue. */
+        if (after[2] - after[0] <= before[2] - before[0])
+        {
+            fprintf(stderr, "FAIL: material edit not visible in the incremental render\n");
+            ok = 0;
+        }
+    }
+
+    /* Cancel from the callback after two passes; the renderer survives and a
+     * plain synchronous render still works afterwards. */
+    memset(&log, 0, sizeof(log));
+    log.cancel_after = 2;
+    if (tracey_render_async(r, scn, spp + 8, onProgress, &log) == 0)
+    {
+        const tracey_render_status st = tracey_render_wait(r);
+        printf("cancelled async: status=%d after %u passes\n", (int)st, log.calls);
+        if (st != TRACEY_RENDER_CANCELLED || log.calls != 2)
+        {
+            fprintf(stderr, "FAIL: async render was not cancelled after two passes\n");
+            ok = 0;
+        }
+    }
+    if (tracey_render(r, scn, 2) != 0)
+    {
+        fprintf(stderr, "FAIL: render after cancel: %s\n", tracey_last_error());
+        ok = 0;
+    }
+
+    /* Nested instancing: a two-cube group placed twice renders, a group
+     * placement takes no material of its own, and unknown members fail. */
+    {
+        const char *members[2] = {"cube", "cube"};
+        tracey_material materials[2];
+        float locals[32];
+        materials[0] = mat;
+        materials[1] = mat;
+        materials[1].base_color[0] = 0.9f; materials[1].base_color[1] = 0.8f; materials[1].base_color[2] = 0.2f;
+        identity4x4(locals);
+        identity4x4(locals + 16);
+        locals[0] = locals[5] = locals[10] = 0.3f;
+        locals[16] = locals[21] = locals[26] = 0.3f;
+        locals[12] = -0.4f;
+        locals[28] = 0.4f;
+        if (tracey_scene_add_instance_group(scn, "pair", members, materials, locals, 2) != 0)
+        {
+            fprintf(stderr, "FAIL: add_instance_group: %s\n", tracey_last_error());
+            ok = 0;
+        }
+        const char *bogus[1] = {"no_such_mesh"};
+        if (tracey_scene_add_instance_group(scn, "broken", bogus, NULL, locals, 1) >= 0)
+        {
+            fprintf(stderr, "FAIL: group with an unknown member was accepted\n");
+            ok = 0;
+        }
+
+        identity4x4(xform);
+        xform[13] = 1.2f;
+        const int pair = tracey_scene_add_instance(scn, "pair", NULL, xform);
+        xform[13] = -1.2f;
+        if (pair < 0 || tracey_scene_add_instance(scn, "pair", NULL, xform) < 0)
+        {
+            fprintf(stderr, "FAIL: placing a group: %s\n", tracey_last_error());
+            ok = 0;
+        }
+        else if (tracey_scene_set_instance_material(scn, pair, &mat) >= 0)
+        {
+            fprintf(stderr, "FAIL: material edit of a group placement succeeded\n");
+            ok = 0;
+        }
+        if (tracey_render(r, scn, 2) != 0)
+        {
+            fprintf(stderr, "FAIL: render with instance groups: %s\n", tracey_last_error());
+            ok = 0;
+        }
+        else
+        {
+            double grouped[3];
+            tracey_readback_beauty(r, beauty);
+            meanRgb(beauty, pixels, grouped);
+            printf("instance groups: mean rgb=(%.3f %.3f %.3f)\n", grouped[0], grouped[1], grouped[2]);
+        }
+    }
+
     free(beauty);
     tracey_renderer_destroy(r);
     tracey_scene_destroy(scn);
@@ -10,6 +10,12 @@
 //      the right per-clone bands (first 36 verts = template[0].Cd, etc.).
 //   4. scatter: plane (Y=0) → scatter(count=50, seed=42) → 50 points on
 //      Y≈0, deterministic across re-runs with the same seed.
+//   4b. scatter mode=poisson: no pair closer than min_distance, near-
+//      maximal coverage, deterministic, and the cook time printed.
+//   12. Nested instancing: cube → copy_to_points(pack_instances) ←
+//      grid → copy_to_points(pack_instances) ← grid → instance. One actor
+//      carrying the cube plus one groupLevels entry per packed copy,
+//      innermost first; the packed copies bake nothing.
 //
 // Exit 0 on success. Depends only on `tracey` — no Vulkan, no rendering.
 
@@ -27,6 +33,8 @@
 
 #include "device/device.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <memory>
@@ -260,6 +268,57 @@ int main()
         check(deterministic, "scatter is deterministic given the same seed");
     }
 
+    // ───────────────────────────────────────────────────────────────────
+    // 4b) Poisson-disk scatter on the same 4×4 plane, min_distance 0.1.
+    // ───────────────────────────────────────────────────────────────────
+    {
+        Geometry plane = GeometryConverter::fromSceneObject(
+            SceneObject::createPlane(4.0f, 4.0f, 8, 8));
+        const float r = 0.1f;
+
+        auto run = [&plane, r]() {
+            auto sc = SopRegistry::instance().create("scatter", 0);
+            sc->setParamString("mode", "poisson");
+            sc->setParamFloat("min_distance", r);
+            sc->setParamInt("seed", 7);
+            const Geometry *inputs[] = {&plane};
+            return sc->cook(std::span<const Geometry *const>{inputs, 1});
+        };
+
+        const auto t0 = std::chrono::steady_clock::now();
+        Geometry a = run();
+        const auto t1 = std::chrono::steady_clock::now();
+        Geometry b = run();
+
+        const auto &P = a.positions();
+        float closest = 1e30f;
+        bool on_plane = true;
+        for (size_t i = 0; i < P.size(); ++i)
+        {
+            on_plane &= std::fabs(P[i].y) <= 1e-4f && std::fabs(P[i].x) <= 2.0f + 1e-4f &&
+                        std::fabs(P[i].z) <= 2.0f + 1e-4f;
+            for (size_t j = i + 1; j < P.size(); ++j)
+            {
+                const Vec3 d = P[i] - P[j];
+                closest = std::min(closest, std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z));
+            }
+        }
+        std::printf("  poisson scatter: %zu points, closest pair %.4f, %.2f ms\n",
+                    P.size(), closest,
+                    std::chrono::duration<double, std::milli>(t1 - t0).count());
+        check(on_plane, "poisson: points lie on the plane");
+        check(closest >= r, "poisson: no two points closer than min_distance");
+        // A maximal 2D Poisson-disk set holds ~0.7 / r² points per unit
+        // area; anything past 0.55 means the dart throwing saturated.
+        check(static_cast<float>(P.size()) > 0.55f * 16.0f / (r * r),
+              "poisson: coverage is near-maximal");
+
+        bool deterministic = a.pointCount() == b.pointCount();
+        for (size_t i = 0; deterministic && i < a.pointCount(); ++i)
+            deterministic = a.positions()[i] == b.positions()[i];
+        check(deterministic, "poisson: deterministic given the same seed");
+    }
+
     // ───────────────────────────────────────────────────────────────────
     // 5) GPU copy_to_points: same cube+grid scenario as test (2), routed
     //    through the CopyToPointsCompute dispatcher. Validates equivalence
@@ -682,6 +741,82 @@ int main()
               "keyed effector strength: 0 at t=0, full offset at t=1");
     }
 
+    // ───────────────────────────────────────────────────────────────────
+    // 12) Nested instancing through packed copy_to_points.
+    // ───────────────────────────────────────────────────────────────────
+    {
+        SopGraph g(0);
+        auto cube = SopRegistry::instance().create("primitive_cube", g.nextUid());
+        cube->setParamFloat("size", 0.2f);
+        const size_t cubeUid = cube->uid();
+        g.addNode(std::move(cube));
+
+        // Inner template 3×1×1, middle 2×2×1, outer 2×1×1.
+        auto makeGrid = [&](int x, int y) {
+            auto grid = SopRegistry::instance().create("points_grid", g.nextUid());
+            grid->setParamInt("count_x", x);
+            grid->setParamInt("count_y", y);
+            grid->setParamInt("count_z", 1);
+            const size_t uid = grid->uid();
+            g.addNode(std::move(grid));
+            return uid;
+        };
+        const size_t innerUid = makeGrid(3, 1);
+        const size_t middleUid = makeGrid(2, 2);
+        const size_t outerUid = makeGrid(2, 1);
+
+        auto makePacked = [&] {
+            auto copy = SopRegistry::instance().create("copy_to_points", g.nextUid());
+            copy->setParamBool("pack_instances", true);
+            const size_t uid = copy->uid();
+            g.addNode(std::move(copy));
+            return uid;
+        };
+        const size_t copyInner = makePacked();
+        const size_t copyMiddle = makePacked();
+
+        auto inst = SopRegistry::instance().create("instance", g.nextUid());
+        const size_t instUid = inst->uid();
+        g.addNode(std::move(inst));
+
+        g.createConnection(cubeUid, 0, copyInner, 0);
+        g.createConnection(innerUid, 0, copyInner, 1);
+        g.createConnection(copyInner, 0, copyMiddle, 0);
+        g.createConnection(middleUid, 0, copyMiddle, 1);
+        g.createConnection(copyMiddle, 0, instUid, 0);
+        g.createConnection(outerUid, 0, instUid, 1);
+
+        CookDiagnostic diag;
+        auto emitted = g.cook(&diag);
+        check(diag.ok, "nested instancing: cook ok");
+        check(emitted.size() == 1, "nested instancing: one EmittedActor");
+        if (!emitted.empty())
+        {
+            const auto &ea = emitted.front();
+            check(ea.geometry && ea.geometry->primitiveCount() == 12,
+                  "nested instancing: stamp is the bare cube");
+            check(ea.groupLevels.size() == 2, "nested instancing: two group levels");
+            if (ea.groupLevels.size() == 2)
+            {
+                check(ea.groupLevels[0].size() == 3 && ea.groupLevels[1].size() == 4,
+                      "nested instancing: levels innermost first (3 then 4 entries)");
+            }
+            check(ea.instances.size() == 2, "nested instancing: outer template places the outermost group");
+        }
+
+        // A packed copy cooked on its own hands nothing downstream.
+        Geometry stamp = GeometryConverter::fromSceneObject(SceneObject::createCube(0.5f));
+        Geometry tmpl;
+        tmpl.points().add<Vec3>("P", Vec3(0.0f));
+        tmpl.resizePoints(4);
+        auto packed = SopRegistry::instance().create("copy_to_points", 0);
+        packed->setParamBool("pack_instances", true);
+        const Geometry *inputs[] = {&stamp, &tmpl};
+        const Geometry baked = packed->cook(std::span<const Geometry *const>{inputs, 2});
+        check(baked.pointCount() == 0 && baked.primitiveCount() == 0,
+              "nested instancing: packed copy bakes no clones");
+    }
+
     if (failures == 0) std::printf("[cloners_smoke] all checks passed\n");
     else               std::printf("[cloners_smoke] %d failure(s)\n", failures);
     return failures > 0 ? 1 : 0;
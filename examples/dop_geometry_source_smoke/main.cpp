@@ -13,6 +13,11 @@
 //     frame's emit, particles 2..3 come from grid indices 2..3.
 //   • With no provider wired (legacy path), pop_source falls back to
 //     point-mode behaviour even when emit_mode=1.
+//   • SOP dependency tracking: bumping an unrelated SOP's version keeps
+//     every cached frame; bumping the source's version (or removing it)
+//     truncates to just before the first frame that read it, and the
+//     resumed sim matches a from-scratch one under the default (lossy)
+//     cache quantum: the frame it resumes from is checkpointed exactly.
 //
 // Headless / no GPU. Standalone tracey link only.
 
@@ -24,6 +29,7 @@
 #include "dops/dop_node.hpp"
 #include "dops/dop_registry.hpp"
 #include "dops/eval_context.hpp"
+#include "dops/frame_cache.hpp"
 #include "dops/register_builtins.hpp"
 #include "dops/sim_state.hpp"
 
@@ -45,6 +51,8 @@ bool near(float a, float b, float eps = 1e-4f) { return std::fabs(a - b) <= eps;
 // Trivial provider that hands back a stored Geometry for one uid. The
 // editor's impl is a thin shim over CookCache::findOutput; this test
 // builds a Geometry by hand to avoid pulling the SOP cook layer in.
+// `version` stands in for CookCache::versionOf — bump it to simulate a
+// re-cook.
 class StubProvider : public tracey::dops::SopGeometryProvider
 {
 public:
@@ -53,9 +61,16 @@ public:
     {
         return (sopUid == m_uid) ? m_g : nullptr;
     }
+    uint64_t version(uint64_t sopUid) const override
+    {
+        return (sopUid == m_uid) ? m_version : 0;
+    }
+    void setGeometry(const tracey::Geometry *g) { m_g = g; }
+    void bump() { ++m_version; }
 private:
     uint64_t m_uid;
     const tracey::Geometry *m_g;
+    uint64_t m_version = 1;
 };
 
 // Build a 4×4 grid of points on the XZ plane, with N = (0, 1, 0) and
@@ -190,6 +205,86 @@ int main()
               "no-provider fallback particle near origin (x=7, z=0)");
     }
 
+    // ── SOP dependency tracking ──
+    //    rate=12 at 24 fps emits on even frames only, so frame 1 never
+    //    looks the source up and frame 2 is the first that depends on it.
+    //    A second, point-mode source emits every frame without reading any
+    //    SOP, so frame 1 holds particles off the cache's quantisation grid.
+    {
+        auto buildSim = [&](DopGraph &g) {
+            FrameCacheConfig cfg;
+            cfg.keyframeInterval = 3;
+            cfg.spillDirectory.clear();
+            g.setFrameCacheConfig(cfg);
+            g.setSopProvider(&provider);
+            auto s = DopRegistry::instance().create("pop_source", g.nextUid());
+            s->setParamFloat("rate",           12.0f);
+            s->setParamFloat("lifetime",       60.0f);
+            s->setParamInt  ("emit_mode",       1);
+            s->setParamInt  ("source_sop_uid", static_cast<int>(SRC_UID));
+            s->setParamFloat("normal_speed",    2.0f);
+            const size_t su = s->uid();
+            g.addNode(std::move(s));
+            auto v = DopRegistry::instance().create("pop_solver", g.nextUid());
+            const size_t vu = v->uid();
+            g.addNode(std::move(v));
+            g.createConnection(su, 0, vu, 0);
+            auto p = DopRegistry::instance().create("pop_source", g.nextUid());
+            p->setParamFloat("rate",      24.0f);
+            p->setParamFloat("lifetime",  60.0f);
+            p->setParamVec3 ("initial_v", Vec3(0.3f, 1.0f, 0.7f));
+            g.addNode(std::move(p));
+        };
+        auto samePoints = [](const SimState *a, const SimState *b) {
+            if (!a || !b || a->geometry.pointCount() != b->geometry.pointCount()) return false;
+            const auto *pa = a->geometry.points().get<Vec3>("P");
+            const auto *pb = b->geometry.points().get<Vec3>("P");
+            if (!pa || !pb) return false;
+            for (size_t i = 0; i < pa->data().size(); ++i)
+                if (pa->data()[i] != pb->data()[i]) return false;
+            return true;
+        };
+
+        DopGraph tracked(0);
+        buildSim(tracked);
+        tracked.cookToFrame(8, fps);
+        const auto *f1 = tracked.sopInputs(1);
+        const auto *f2 = tracked.sopInputs(2);
+        check(f1 && f1->empty(), "frame 1 recorded no SOP inputs");
+        check(f2 && f2->size() == 1 && (*f2)[0].sopUid == SRC_UID && (*f2)[0].present,
+              "frame 2 recorded the source SOP");
+
+        check(tracked.invalidateChangedSopInputs() == 0 && tracked.cachedToFrame() == 8,
+              "unchanged sources keep every cached frame");
+
+        // Move the source and bump its version: frames 2.. are stale.
+        Geometry moved = makeGridGeometry();
+        for (auto &p : moved.points().get<Vec3>("P")->data()) p += Vec3(0.0f, 0.0f, 5.0f);
+        provider.setGeometry(&moved);
+        provider.bump();
+        const int firstStale = tracked.invalidateChangedSopInputs();
+        check(firstStale == 2, "source re-cook invalidates from the first frame that read it");
+        check(tracked.cachedToFrame() == 1, "frames before the first stale one are kept");
+        check(tracked.invalidateChangedSopInputs() == 0, "second check is a no-op");
+
+        tracked.cookToFrame(8, fps);
+        DopGraph fresh(0);
+        buildSim(fresh);
+        fresh.cookToFrame(8, fps);
+        check(samePoints(tracked.frame(8), fresh.frame(8)), "resumed sim matches a fresh one at frame 8");
+        check(samePoints(tracked.frame(5), fresh.frame(5)), "resumed sim matches a fresh one at frame 5");
+
+        // A source that disappears counts as a change too.
+        provider.setGeometry(nullptr);
+        check(tracked.invalidateChangedSopInputs() == 2, "deleted source invalidates");
+        provider.setGeometry(&src);
+
+        // DOP-side edits still drop everything.
+        tracked.cookToFrame(4, fps);
+        tracked.markDirty();
+        check(tracked.cachedToFrame() == 0 && !tracked.sopInputs(1), "markDirty clears frames and stamps");
+    }
+
     if (failures == 0) std::printf("[dop_geometry_source_smoke] all checks passed\n");
     else               std::printf("[dop_geometry_source_smoke] %d failure(s)\n", failures);
     return failures > 0 ? 1 : 0;
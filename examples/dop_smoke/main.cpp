@@ -10,6 +10,12 @@
 //   • The DopGraph round-trips through serialize → deserialize byte-stable.
 //   • clearCache() actually wipes; cookToFrame after a wipe restarts from
 //     frame 0 and reproduces the same point count.
+//   • The compressed frame cache decodes every cooked frame (reporting the
+//     compression ratio and decode time), and frames spilled to disk under
+//     a zero memory budget reload identical to resident ones. Only P / v
+//     are quantised by default: a tiny pscale or mass decodes exactly.
+//   • The neighbour grid matches brute force; pop_interact separation
+//     spreads a particle cloud and pop_collide keeps spheres apart.
 //
 // Exit 0 on success, non-zero on first failed check. Depends only on
 // `tracey`. Run with:
@@ -22,6 +28,8 @@
 #include "dops/dop_graph.hpp"
 #include "dops/dop_node.hpp"
 #include "dops/dop_registry.hpp"
+#include "dops/frame_cache.hpp"
+#include "dops/neighbor_grid.hpp"
 #include "dops/register_builtins.hpp"
 #include "dops/serialization.hpp"
 #include "dops/sim_state.hpp"
@@ -32,10 +40,16 @@
 #include "vops/vop_node.hpp"
 #include "vops/vop_registry.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <filesystem>
+#include <random>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -187,6 +201,223 @@ int main()
         check(countBefore == countAfter, "re-cook from scratch is deterministic");
     }
 
+    // Frame cache: every frame but the newest is held quantised and
+    // delta-coded. Scrub the cooked range forward (one decode per step)
+    // and then backward (each step restarts at a keyframe), and report
+    // the compression ratio + decode cost.
+    {
+        int scrubFailures = 0;
+        for (int f = 1; f <= targetFrame; ++f)
+            if (!graph->frame(f)) ++scrubFailures;
+        for (int f = targetFrame; f >= 1; --f)
+            if (!graph->frame(f)) ++scrubFailures;
+        check(scrubFailures == 0, "frame cache: every cooked frame decodes");
+
+        const FrameCacheStats &st = graph->frameCacheStats();
+        check(st.ratio() > 1.0, "frame cache: encoded frames are smaller than raw");
+        std::printf("  frame cache: %zu frames, %zu -> %zu bytes (%.2fx), "
+                    "encode %.3f ms, %zu decodes in %.3f ms (%.3f ms/frame)\n",
+                    st.frames, st.rawBytes, st.encodedBytes, st.ratio(),
+                    st.encodeSeconds * 1e3, st.decodedFrames, st.decodeSeconds * 1e3,
+                    st.decodedFrames ? st.decodeSeconds * 1e3 / st.decodedFrames : 0.0);
+    }
+
+    // Spill path: a zero memory budget pushes every frame but the newest
+    // out to disk. Reloaded frames must match the in-memory cache.
+    {
+        const std::string txt = serializeDopGraph(*graph);
+        auto spilled = deserializeDopGraph(txt);
+        if (!spilled) { std::fprintf(stderr, "deserialize failed\n"); return 2; }
+        FrameCacheConfig cfg;
+        cfg.memoryBudgetBytes = 0;
+        cfg.spillDirectory = std::filesystem::temp_directory_path() / "tracey_dop_smoke_cache";
+        spilled->setFrameCacheConfig(cfg);
+        spilled->cookToFrame(targetFrame, fps);
+        check(spilled->frameCacheStats().spilledFrames == static_cast<size_t>(targetFrame - 1),
+              "frame cache: zero budget spills all but the newest frame");
+
+        bool same = true;
+        for (int f = 1; f <= targetFrame && same; ++f)
+        {
+            const SimState *a = graph->frame(f);
+            const SimState *b = spilled->frame(f);
+            if (!a || !b || a->geometry.pointCount() != b->geometry.pointCount()) { same = false; break; }
+            const auto &pa = a->geometry.positions();
+            const auto &pb = b->geometry.positions();
+            for (size_t i = 0; i < pa.size(); ++i)
+                if (pa[i] != pb[i]) { same = false; break; }
+        }
+        check(same, "frame cache: spilled frames reload identical to resident ones");
+        std::printf("  frame cache: %zu disk loads\n", spilled->frameCacheStats().diskLoads);
+    }
+
+    // Per-attribute steps: the default config quantises P (and v) to
+    // 1e-4, but small-scale attributes like pscale or mass must come back
+    // bit-exact; attributeQuanta opts a named attribute in.
+    {
+        auto makeFrame = [](int f) {
+            SimState s;
+            s.geometry.resizePoints(64);
+            auto &pts = s.geometry.points();
+            auto &P = pts.get<Vec3>("P")->data();
+            auto &pscale = pts.add<float>("pscale", 0.0f)->data();
+            auto &mass = pts.add<float>("mass", 0.0f)->data();
+            auto &density = pts.add<float>("density", 0.0f)->data();
+            for (size_t i = 0; i < P.size(); ++i)
+            {
+                const float t = static_cast<float>(f) / 24.0f + static_cast<float>(i) * 0.013f;
+                P[i] = Vec3(std::sin(t), 0.3f * t, std::cos(t)) * 1.37f;
+                pscale[i] = 0.002f + 0.00017f * static_cast<float>(i % 7);
+                mass[i] = 3.1e-6f * static_cast<float>(1 + i % 5);
+                density[i] = 1000.0f + 0.37f * t;
+            }
+            return s;
+        };
+        FrameCacheConfig cfg;
+        cfg.spillDirectory.clear();
+        cfg.keyframeInterval = 4;
+        cfg.attributeQuanta["density"] = 0.5f;
+        FrameCache cache(cfg);
+        for (int f = 1; f <= 6; ++f) cache.push(makeFrame(f));
+
+        bool exact = true, posNear = true, densityNear = true;
+        for (int f = 1; f <= 5; ++f)
+        {
+            const SimState *got = cache.get(f);
+            const SimState want = makeFrame(f);
+            if (!got || got->geometry.pointCount() != want.geometry.pointCount()) { exact = false; break; }
+            const auto &gp = got->geometry.points();
+            const auto &wp = want.geometry.points();
+            for (const char *name : {"pscale", "mass"})
+                if (gp.get<float>(name)->data() != wp.get<float>(name)->data()) exact = false;
+            const auto &a = gp.get<Vec3>("P")->data();
+            const auto &b = wp.get<Vec3>("P")->data();
+            const auto &da = gp.get<float>("density")->data();
+            const auto &db = wp.get<float>("density")->data();
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                const Vec3 d = glm::abs(a[i] - b[i]);
+                if (std::max({d.x, d.y, d.z}) > 0.51e-4f) posNear = false;
+                if (std::abs(da[i] - db[i]) > 0.251f) densityNear = false;
+            }
+        }
+        check(exact, "frame cache: pscale / mass are stored losslessly");
+        check(posNear, "frame cache: P is quantised to the 1e-4 world-space step");
+        check(densityNear, "frame cache: attributeQuanta opts density into its own step");
+        check(cfg.quantumFor("P") == 1e-4f && cfg.quantumFor("pscale") == 0.0f &&
+                  cfg.quantumFor("density") == 0.5f,
+              "frame cache: quantumFor resolves per-attribute steps");
+    }
+
+    // ── Neighbour grid + point-point POPs ─────────────────────────────
+    // The grid must return exactly the brute-force neighbour set; then
+    // pop_interact's separation must spread a cloud out and pop_collide
+    // must keep spheres from interpenetrating.
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> u(0.0f, 10.0f);
+        std::vector<Vec3> pts(20000);
+        for (auto &p : pts) p = Vec3(u(rng), u(rng), u(rng));
+
+        NeighborGrid grid;
+        grid.build(pts, 0.5f);
+        bool match = true;
+        for (size_t q = 0; q < pts.size() && match; q += 97)
+        {
+            std::vector<uint32_t> found;
+            grid.forEachNeighbor(pts[q], 0.5f, [&](uint32_t j, const Vec3 &, float) { found.push_back(j); });
+            std::sort(found.begin(), found.end());
+            std::vector<uint32_t> expect;
+            for (size_t j = 0; j < pts.size(); ++j)
+            {
+                const Vec3 d = pts[j] - pts[q];
+                if (d.x * d.x + d.y * d.y + d.z * d.z <= 0.25f) expect.push_back(static_cast<uint32_t>(j));
+            }
+            match = found == expect;
+        }
+        check(match, "neighbor grid: queries match brute force");
+
+        std::vector<Vec3> big(400000);
+        std::uniform_real_distribution<float> ub(0.0f, 40.0f);
+        for (auto &p : big) p = Vec3(ub(rng), ub(rng), ub(rng));
+        const auto t0 = std::chrono::steady_clock::now();
+        grid.build(big, 0.5f);
+        const auto t1 = std::chrono::steady_clock::now();
+        size_t pairs = 0;
+        for (size_t i = 0; i < big.size(); ++i)
+            grid.forEachNeighbor(big[i], 0.5f, [&](uint32_t, const Vec3 &, float) { ++pairs; });
+        const auto t2 = std::chrono::steady_clock::now();
+        std::printf("  neighbor grid: 400k points, build %.2f ms, serial query sweep %.2f ms (%zu hits)\n",
+                    std::chrono::duration<double, std::milli>(t1 - t0).count(),
+                    std::chrono::duration<double, std::milli>(t2 - t1).count(), pairs);
+    }
+
+    {
+        // Mean nearest-neighbour distance over a particle cloud.
+        auto meanNearest = [](const Geometry &geo) {
+            const auto &P = geo.positions();
+            if (P.size() < 2) return 0.0;
+            double sum = 0.0;
+            for (size_t i = 0; i < P.size(); ++i)
+            {
+                float best = 1e30f;
+                for (size_t j = 0; j < P.size(); ++j)
+                {
+                    if (i == j) continue;
+                    const Vec3 d = P[j] - P[i];
+                    best = std::min(best, d.x * d.x + d.y * d.y + d.z * d.z);
+                }
+                sum += std::sqrt(best);
+            }
+            return sum / static_cast<double>(P.size());
+        };
+
+        // pop_source → [pop_interact] → pop_solver → [pop_collide], with a
+        // dense zero-velocity emission so particles start crowded.
+        auto cookCloud = [&](float separation, bool collide) -> Geometry {
+            auto g = std::make_unique<DopGraph>(0);
+            auto s  = DopRegistry::instance().create("pop_source",   g->nextUid());
+            auto ia = DopRegistry::instance().create("pop_interact", g->nextUid());
+            auto so = DopRegistry::instance().create("pop_solver",   g->nextUid());
+            auto co = DopRegistry::instance().create("pop_collide",  g->nextUid());
+            if (!s || !ia || !so || !co) return {};
+            s->setParamFloat("rate", 240.0f);
+            s->setParamFloat("lifetime", 10.0f);
+            s->setParamVec3 ("initial_v", Vec3(0.0f));
+            s->setParamFloat("pos_jitter", 0.3f);
+            ia->setParamFloat("radius", 0.5f);
+            ia->setParamFloat("separation", separation);
+            co->setParamFloat("radius", 0.05f);
+            co->setParamInt  ("iterations", 4);
+            const size_t sUid = s->uid(), iaUid = ia->uid(), soUid = so->uid(), coUid = co->uid();
+            g->addNode(std::move(s));
+            g->addNode(std::move(ia));
+            g->addNode(std::move(so));
+            g->createConnection(sUid, 0, iaUid, 0);
+            g->createConnection(iaUid, 0, soUid, 0);
+            if (collide)
+            {
+                g->addNode(std::move(co));
+                g->createConnection(soUid, 0, coUid, 0);
+            }
+            g->markDirty();
+            g->cookToFrame(targetFrame, fps);
+            const SimState *st = g->frame(targetFrame);
+            return st ? st->geometry : Geometry{};
+        };
+
+        const Geometry packed = cookCloud(0.0f, false);
+        const Geometry spread = cookCloud(5.0f, false);
+        check(packed.pointCount() > 100 && spread.pointCount() == packed.pointCount(),
+              "pop_interact: cook produced particles");
+        check(meanNearest(spread) > meanNearest(packed) * 1.5,
+              "pop_interact: separation spreads the cloud out");
+
+        const Geometry collided = cookCloud(0.0f, true);
+        check(meanNearest(collided) > 0.08,
+              "pop_collide: particles stay (nearly) separated at 2 * radius");
+    }
+
     // ── pop_force with a VOP subnet that produces a constant +X force ──
     // Verifies Phase 4 end-to-end: build a graph with pop_source →
     // pop_force → pop_solver; pop_force's subnet is a constant_vec3
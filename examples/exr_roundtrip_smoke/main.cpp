@@ -3,11 +3,15 @@
 // Writes a small EXR carrying a beauty layer + an albedo layer (3ch) + a depth
 // layer (1ch named "Z"), reads it back, and asserts the channel planes survive
 // the round-trip (deinterleave + alphabetical channel ordering are correct).
+// Then covers the chunk writer's options — HALF layers, ZIPS / uncompressed,
+// tiled + mipmapped output on a size that is not a tile multiple — and
+// reports write throughput for a 1080p beauty + six AOV frame.
 //
 // Exit 0 on success. Depends only on `tracey`.
 
 #include "io/exr_writer.hpp"
 
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <filesystem>
@@ -25,6 +29,85 @@ void check(bool ok, const char *what)
     else { ++failures; std::printf("  FAIL %s\n", what); }
 }
 bool approx(float a, float b, float tol = 1e-4f) { return std::fabs(a - b) <= tol; }
+
+using Planes = std::vector<std::pair<std::string, std::vector<float>>>;
+
+// Interleaved test pattern: smooth ramps plus a per-channel offset, so
+// misplaced tiles, rows or channels all show up.
+std::vector<float> pattern(int w, int h, int channels, float seed)
+{
+    std::vector<float> v(static_cast<size_t>(w) * h * channels);
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            for (int c = 0; c < channels; ++c)
+                v[(static_cast<size_t>(y) * w + x) * channels + c] =
+                    seed + 0.01f * x + 0.1f * y + 0.37f * c + 0.5f * std::sin(0.3f * x * (c + 1));
+    return v;
+}
+
+// Max abs error of `name` against component `c` of an interleaved source.
+float planeError(const Planes &planes, const std::string &name,
+                 const std::vector<float> &src, int channels, int c)
+{
+    for (const auto &p : planes)
+    {
+        if (p.first != name) continue;
+        float err = 0.0f;
+        for (size_t i = 0; i < p.second.size(); ++i)
+            err = std::max(err, std::fabs(p.second[i] - src[i * channels + c]));
+        return err;
+    }
+    return INFINITY;
+}
+
+// Write with `opt`, read back, and check every channel of a beauty (3ch)
+// + "alpha" (1ch) pair to `tol`.
+void roundTrip(const char *label, int W, int H, const ExrWriteOptions &opt,
+               ExrPixelType type, float tol)
+{
+    const auto rgb = pattern(W, H, 3, 1.0f);
+    const auto a = pattern(W, H, 1, -2.0f);
+    const std::vector<ExrLayer> layers = {{"", 3, rgb.data(), type}, {"alpha", 1, a.data(), type}};
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "tracey_exr_options.exr").string();
+
+    std::string err;
+    const bool wrote = writeMultiLayerExr(path, W, H, layers, opt, &err);
+    check(wrote, (std::string(label) + ": write" + (err.empty() ? "" : " (" + err + ")")).c_str());
+    if (!wrote) return;
+
+    int rw = 0, rh = 0;
+    Planes planes;
+    const bool read = readMultiLayerExr(path, &rw, &rh, planes, &err);
+    check(read && rw == W && rh == H,
+          (std::string(label) + ": read back" + (err.empty() ? "" : " (" + err + ")")).c_str());
+    if (!read) return;
+    float worst = planeError(planes, "alpha", a, 1, 0);
+    const char *rgbNames[3] = {"R", "G", "B"};
+    for (int c = 0; c < 3; ++c) worst = std::max(worst, planeError(planes, rgbNames[c], rgb, 3, c));
+    check(worst <= tol, (std::string(label) + ": pixels round-trip").c_str());
+
+    ExrFileInfo info;
+    if (readExrInfo(path, info))
+    {
+        bool typesOk = info.channels.size() == 4;
+        for (const auto &c : info.channels) typesOk = typesOk && c.second == type;
+        check(typesOk, (std::string(label) + ": channel pixel types").c_str());
+        check(info.tiled == opt.tiled, (std::string(label) + ": tiled flag").c_str());
+        if (opt.tiled)
+        {
+            int expectLevels = 1;
+            if (opt.mipmaps)
+                for (int m = std::max(W, H); m > 1; m >>= 1) ++expectLevels;
+            check(info.tileWidth == opt.tileSize && info.levels == expectLevels,
+                  (std::string(label) + ": tile size and level count").c_str());
+        }
+    }
+    else
+    {
+        check(false, (std::string(label) + ": header readable").c_str());
+    }
+}
 }
 
 int main()
@@ -112,6 +195,72 @@ int main()
         check(ok, "depth Z plane round-trips");
     }
 
+    // ── Writer options ──────────────────────────────────────────────────
+    {
+        ExrWriteOptions zip;
+        roundTrip("zip float", 67, 45, zip, ExrPixelType::Float, 0.0f);
+        // Half: 11-bit mantissa → relative error ≤ 2^-11 on values up to ~8.
+        roundTrip("zip half", 67, 45, zip, ExrPixelType::Half, 8.0f / 2048.0f);
+
+        ExrWriteOptions zips;
+        zips.compression = ExrCompression::Zips;
+        roundTrip("zips float", 67, 45, zips, ExrPixelType::Float, 0.0f);
+
+        ExrWriteOptions none;
+        none.compression = ExrCompression::None;
+        roundTrip("uncompressed half", 67, 45, none, ExrPixelType::Half, 8.0f / 2048.0f);
+
+        ExrWriteOptions tiled;
+        tiled.tiled = true;
+        tiled.tileSize = 16;
+        roundTrip("tiled float", 70, 37, tiled, ExrPixelType::Float, 0.0f);
+        tiled.mipmaps = true;
+        roundTrip("tiled mipmapped half", 70, 37, tiled, ExrPixelType::Half, 8.0f / 2048.0f);
+    }
+
+    // ── Throughput: 1080p beauty + six AOVs, as sequence export writes ──
+    {
+        const int FW = 1920, FH = 1080;
+        const auto beautyF = pattern(FW, FH, 3, 0.5f);
+        const auto albedoF = pattern(FW, FH, 3, 0.2f);
+        const auto normalF = pattern(FW, FH, 3, -0.3f);
+        const auto posF    = pattern(FW, FH, 3, 10.0f);
+        const auto emisF   = pattern(FW, FH, 3, 0.0f);
+        const auto depthF  = pattern(FW, FH, 1, 5.0f);
+        const auto idF     = pattern(FW, FH, 1, 3.0f);
+        const std::string fpath =
+            (std::filesystem::temp_directory_path() / "tracey_exr_throughput.exr").string();
+
+        auto run = [&](const char *label, const ExrWriteOptions &opt, ExrPixelType colour) {
+            const std::vector<ExrLayer> frame = {
+                {"", 3, beautyF.data(), colour},
+                {"albedo", 3, albedoF.data(), colour},
+                {"N", 3, normalF.data(), colour},
+                {"P", 3, posF.data()},
+                {"emission", 3, emisF.data(), colour},
+                {"Z", 1, depthF.data()},
+                {"id", 1, idF.data()},
+            };
+            ExrWriteStats st;
+            std::string err;
+            const bool ok = writeMultiLayerExr(fpath, FW, FH, frame, opt, &err, &st);
+            check(ok, (std::string("throughput ") + label + ": write").c_str());
+            if (!ok) return;
+            std::printf("       %-22s %4zu chunks  %6.1f MB raw → %6.1f MB  %7.1f ms  %7.1f MB/s\n",
+                        label, st.chunks, st.pixelBytes / 1e6, st.fileBytes / 1e6,
+                        st.seconds * 1e3, st.pixelBytes / 1e6 / std::max(st.seconds, 1e-9));
+        };
+        ExrWriteOptions zip;
+        run("zip, all float", zip, ExrPixelType::Float);
+        run("zip, half colour", zip, ExrPixelType::Half);
+        ExrWriteOptions mip;
+        mip.tiled = true;
+        mip.mipmaps = true;
+        run("tiled+mip, half colour", mip, ExrPixelType::Half);
+        std::error_code ec;
+        std::filesystem::remove(fpath, ec);
+    }
+
     std::printf(failures == 0 ? "[exr_roundtrip_smoke] all checks passed\n"
                               : "[exr_roundtrip_smoke] %d failure(s)\n", failures);
     return failures == 0 ? 0 : 1;
@@ -0,0 +1,219 @@
+// Smoke test for nested instancing (Scene instance groups).
+//
+// Builds one scene that places instance groups — a 3-cube "row" group, a
+// "grid" group of three rows placed twice, and a "deep" chain that wraps a
+// cube six groups deep, past Tlas::kMaxInstanceLevels — then compiles it
+// twice: nested (nestInstanceGroups = true, what the CPU backend gets) and
+// flat (the default every other consumer gets). Checks:
+//   1. The nested compile keeps the groups and has far fewer top-level
+//      instances; the flat compile has none left.
+//   2. SceneCompiler::expandInstanceGroups on the nested scene yields exactly
+//      the flat scene's instances, with the same materials.
+//   3. Both compiles render on the CPU path tracer backend to the same image:
+//      identical seeds, so the only differences are float rounding of the
+//      composed transforms at silhouette edges.
+//
+// Exit 0 on success.
+
+#include "device/device.hpp"
+#include "scene/scene.hpp"
+#include "scene/scene_object.hpp"
+#include "scene/scene_instance.hpp"
+#include "scene/material_instance.hpp"
+#include "scene/scene_compiler.hpp"
+#include "scene/actor.hpp"
+#include "scene/camera.hpp"
+#include "scene/light.hpp"
+#include "scene/transform.hpp"
+#include "path_tracer/api/path_tracer.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace tracey;
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char *what)
+{
+    if (ok) std::printf("  ok   %s\n", what);
+    else { ++failures; std::printf("  FAIL %s\n", what); }
+}
+
+SceneInstance placed(const std::string &ref, const Vec3 &position, float scale,
+                     const MaterialInstance &material = MaterialInstance("pbr"))
+{
+    SceneInstance instance(ref, material);
+    Transform xf;
+    xf.setPosition(position);
+    xf.setScale(Vec3(scale));
+    instance.setLocalTransform(xf);
+    return instance;
+}
+
+MaterialInstance tinted(const Vec3 &albedo)
+{
+    MaterialInstance m("pbr");
+    m.setAlbedo(albedo);
+    m.setRoughness(0.5f);
+    return m;
+}
+
+void buildScene(Scene &scene)
+{
+    scene.addObject("cube", SceneObject::createCube(1.0f));
+
+    // A row of three differently coloured cubes, three rows in a grid.
+    scene.addInstanceGroup("row", {placed("cube", Vec3(-1.0f, 0.0f, 0.0f), 0.6f, tinted(Vec3(0.9f, 0.2f, 0.2f))),
+                                   placed("cube", Vec3(0.0f, 0.0f, 0.0f), 0.6f, tinted(Vec3(0.2f, 0.9f, 0.2f))),
+                                   placed("cube", Vec3(1.0f, 0.0f, 0.0f), 0.6f, tinted(Vec3(0.2f, 0.2f, 0.9f)))});
+    scene.addInstanceGroup("grid", {placed("row", Vec3(0.0f, 0.0f, -1.0f), 1.0f),
+                                    placed("row", Vec3(0.0f, 0.0f, 0.0f), 1.0f),
+                                    placed("row", Vec3(0.0f, 0.0f, 1.0f), 1.0f)});
+
+    // Six wrapping levels: deeper than the TLAS can nest, so the compiler
+    // flattens the excess into the groups above.
+    scene.addInstanceGroup("deep0", {placed("cube", Vec3(0.0f), 0.5f, tinted(Vec3(0.9f, 0.8f, 0.3f)))});
+    for (int level = 1; level < 6; ++level)
+    {
+        scene.addInstanceGroup("deep" + std::to_string(level),
+                               {placed("deep" + std::to_string(level - 1), Vec3(0.1f, 0.0f, 0.0f), 1.0f)});
+    }
+
+    Actor *grids = scene.createActor();
+    grids->setName("grids");
+    grids->addInstance(placed("grid", Vec3(-1.8f, 0.0f, 0.0f), 0.8f));
+    grids->addInstance(placed("grid", Vec3(1.8f, 0.0f, 0.0f), 0.8f));
+
+    Actor *deep = scene.createActor();
+    deep->setName("deep");
+    deep->addInstance(placed("deep5", Vec3(0.0f, 1.2f, 0.0f), 1.0f));
+
+    // A plain top-level cube alongside the groups.
+    Actor *floor = scene.createActor();
+    floor->setName("floor");
+    Transform fx;
+    fx.setPosition(Vec3(0.0f, -0.8f, 0.0f));
+    fx.setScale(Vec3(8.0f, 0.1f, 6.0f));
+    floor->setTransform(fx);
+    floor->addInstance(SceneInstance("cube", tinted(Vec3(0.7f))));
+
+    Actor *dome = scene.createActor();
+    dome->setName("dome");
+    Light light;
+    light.type = LightType::Dome;
+    light.intensity = 1.0f;
+    dome->setLight(light);
+}
+
+std::vector<float> render(Device *device, const SceneCompiler::CompiledScene &compiled,
+                          uint32_t size, uint32_t spp)
+{
+    PathTracerConfig config;
+    config.width = size;
+    config.height = size;
+    config.hdrOutput = true;
+    config.linearOutput = true;
+    config.samplesPerFrame = 1;
+    config.maxBounces = 4;
+    config.backend = PathTracerBackendKind::Cpu;
+    PathTracer tracer(device, config);
+
+    Camera camera;
+    const glm::vec3 position(0.0f, 3.5f, 6.0f);
+    camera.setPosition(position);
+    camera.setRotation(glm::quatLookAt(glm::normalize(glm::vec3(0.0f, 0.2f, 0.0f) - position),
+                                       glm::vec3(0.0f, 1.0f, 0.0f)));
+    camera.setFov(45.0f);
+
+    for (uint32_t s = 0; s < spp; ++s) tracer.render(compiled, camera, s == 0, s == spp - 1);
+    std::vector<float> pixels(static_cast<size_t>(size) * size * 4);
+    tracer.readback(pixels.data());
+    return pixels;
+}
+
+}
+
+int main()
+{
+    std::unique_ptr<Device> device(createDevice(DeviceType::Cpu, DeviceBackend::Compute));
+    Scene scene;
+    buildScene(scene);
+
+    BVHConfig bvhConfig;
+    const SceneCompiler::CompiledScene nested =
+        SceneCompiler::compile(device.get(), scene, bvhConfig, nullptr, true, true);
+    const SceneCompiler::CompiledScene flat =
+        SceneCompiler::compile(device.get(), scene, bvhConfig, nullptr, true, false);
+
+    // 1) Layout.
+    std::printf("top-level instances: nested %zu (+%zu groups), flat %zu\n", nested.instances.size(),
+                nested.instanceGroups.size(), flat.instances.size());
+    check(!nested.instanceGroups.empty(), "nested compile keeps the instance groups");
+    check(flat.instanceGroups.empty(), "flat compile expands every group");
+    // 2 grids × 9 cubes + 1 deep cube + floor.
+    check(flat.instances.size() == 20, "flat compile has one instance per leaf (20)");
+    check(nested.instances.size() < flat.instances.size(), "nested compile has fewer top-level instances");
+    check(flat.tlas != nullptr, "flat compile builds a TLAS");
+
+    // 2) Expansion matches the flat compile leaf for leaf.
+    std::vector<Tlas::Instance> leaves;
+    std::vector<uint32_t> records;
+    SceneCompiler::expandInstanceGroups(nested, leaves, records);
+    bool same = leaves.size() == flat.instances.size() && records.size() == leaves.size();
+    for (size_t i = 0; same && i < leaves.size(); ++i)
+    {
+        const Mat4 a = leaves[i].getTransform();
+        const Mat4 b = flat.instances[i].getTransform();
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                if (std::fabs(a[c][r] - b[c][r]) > 1e-4f) same = false;
+        const auto &ma = nested.materials[nested.instanceToMaterialIndex[records[i]]];
+        const auto &mb = flat.materials[flat.instanceToMaterialIndex[i]];
+        if (ma.baseColorR != mb.baseColorR || ma.baseColorG != mb.baseColorG || ma.baseColorB != mb.baseColorB)
+            same = false;
+    }
+    check(same, "expandInstanceGroups matches the flat compile (transforms + materials)");
+
+    // 3) Grouped render vs flattened render on the CPU backend.
+    constexpr uint32_t kSize = 96;
+    constexpr uint32_t kSpp = 8;
+    const std::vector<float> a = render(device.get(), nested, kSize, kSpp);
+    const std::vector<float> b = render(device.get(), flat, kSize, kSpp);
+    double sumSq = 0.0, peak = 0.0, mean = 0.0;
+    size_t differing = 0;
+    for (size_t p = 0; p < a.size() / 4; ++p)
+    {
+        bool differs = false;
+        for (int c = 0; c < 3; ++c)
+        {
+            const double d = a[p * 4 + c] - b[p * 4 + c];
+            sumSq += d * d;
+            peak = std::max(peak, static_cast<double>(std::fabs(b[p * 4 + c])));
+            mean += b[p * 4 + c];
+            if (std::fabs(d) > 1e-3) differs = true;
+        }
+        if (differs) ++differing;
+    }
+    const double pixels = static_cast<double>(a.size() / 4);
+    const double mse = sumSq / (pixels * 3.0);
+    const double psnr = mse > 0.0 ? 10.0 * std::log10(std::max(peak, 1.0) * std::max(peak, 1.0) / mse) : 99.0;
+    std::printf("grouped vs flat: PSNR %.1f dB, %zu of %zu pixels differ\n", psnr, differing,
+                static_cast<size_t>(pixels));
+    check(mean / (pixels * 3.0) > 0.01, "flat render is not black");
+    check(psnr >= 40.0, "grouped render matches the flat render (PSNR >= 40 dB)");
+    check(differing <= static_cast<size_t>(pixels * 0.02), "at most 2% of pixels differ");
+
+    if (failures == 0) std::printf("[instance_groups_smoke] all checks passed\n");
+    else               std::printf("[instance_groups_smoke] %d failure(s)\n", failures);
+    return failures > 0 ? 1 : 0;
+}
@@ -10,12 +10,35 @@
 // Usage:
 //   pt_backend_compare [scene.glb] [--a metal] [--b cpu]
 //                      [--spp 64] [--size 512] [--min-psnr 30]
-//                      [--out prefix]
+//                      [--out prefix] [--compact] [--stream]
+//                      [--triangle-blocks] [--leaf-threshold N]
+//                      [--radiance-cache] [--cache-cell S] [--cache-min-samples N]
+// --compact renders backend B with compact scene data (BVHConfig::
+// compactTriangles + PathTracerConfig::compactShadingData) against the
+// full-precision A; each backend reports its scene memory with its timing.
+// --stream loads a glTF / USD scene through the streaming importer, building
+// each mesh's BLAS while the rest of the file is still being converted; the
+// "time to first render" line (load + compile) is the number to compare
+// against a run without it.
+// --triangle-blocks renders backend B from BLASes built with BVHConfig::
+// triangleBlocks (4-wide SoA leaf test) over the same tree as A, and then
+// requires the two beauty images to be byte-identical rather than merely
+// above the PSNR threshold — run it with the same CPU backend on both sides
+// (--a cpu --b cpu). --leaf-threshold sets BVHConfig::leafThreshold for both
+// (the blocks are tuned for BVHConfig::kTriangleBlockLeafThreshold).
+// --radiance-cache renders backend B with PathTracerConfig::radianceCache
+// (CPU backend) against the unbiased A; the two timings and the PSNR show what
+// the cache saves and what it costs. --cache-cell / --cache-min-samples set
+// radianceCacheCellSize / radianceCacheMinSamples. Pick --min-psnr for the
+// bias you accept: the cached image converges to a slightly different one.
 // Exit code 0 when PSNR >= threshold, 1 otherwise.
 
+#include "core/intersect.hpp"
 #include "device/device.hpp"
 #include "scene/scene_loader.hpp"
 #include "scene/scene_compiler.hpp"
+#include "scene/blas_prebuilder.hpp"
+#include "scene/import_stream.hpp"
 #include "scene/gltf_loader.hpp"
 #include "scene/usd_loader.hpp"
 #include "scene/camera.hpp"
@@ -36,6 +59,7 @@
 #include <chrono>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -128,6 +152,13 @@ int main(int argc, char *argv[])
     float motionDx = 0.0f;    // !=0 translates all instances by (dx,0,0) over the shutter (R4 motion parity test)
     float sunIntensity = 0.0f; // >0 injects a Distant (sun) light — analytic-NEE + shadow-ray parity test
     float domeIntensity = 0.0f; // >0 injects a Dome (environment) light — matches the editor's default
+    bool compact = false;       // backend B uses compact triangles + shading data
+    bool stream = false;        // streaming import with BLAS builds overlapping the parse
+    bool triangleBlocks = false; // backend B uses SoA triangle-block leaves; images must match exactly
+    int leafThreshold = tracey::BVHConfig{}.leafThreshold;
+    bool radianceCache = false; // backend B ends diffuse paths in the radiance cache
+    float cacheCell = tracey::PathTracerConfig{}.radianceCacheCellSize;
+    uint32_t cacheMinSamples = tracey::PathTracerConfig{}.radianceCacheMinSamples;
 
     for (int i = 1; i < argc; ++i)
     {
@@ -149,23 +180,54 @@ int main(int argc, char *argv[])
         else if (arg == "--motion") motionDx = std::stof(next());
         else if (arg == "--sun") sunIntensity = std::stof(next());
         else if (arg == "--dome") domeIntensity = std::stof(next());
+        else if (arg == "--compact") compact = true;
+        else if (arg == "--stream") stream = true;
+        else if (arg == "--triangle-blocks") triangleBlocks = true;
+        else if (arg == "--leaf-threshold") leafThreshold = std::stoi(next());
+        else if (arg == "--radiance-cache") radianceCache = true;
+        else if (arg == "--cache-cell") cacheCell = std::stof(next());
+        else if (arg == "--cache-min-samples") cacheMinSamples = static_cast<uint32_t>(std::stoul(next()));
         else scenePath = arg;
     }
 
     std::cout << "Scene: " << scenePath << "\nBackends: " << backendA << " vs " << backendB
               << "\nSamples: " << spp << ", size: " << size << "x" << size << std::endl;
 
+    std::unique_ptr<tracey::Device> device(
+        tracey::createDevice(tracey::DeviceType::Gpu, tracey::DeviceBackend::Compute));
+
+    // Time to first render: load + compile. With --stream the prebuilder
+    // fills `blasCache` during the load and the compile below only has to
+    // pick the entries up.
+    tracey::BVHConfig bvhConfig;
+    bvhConfig.leafThreshold = leafThreshold;
+    const auto loadStart = std::chrono::high_resolution_clock::now();
+    tracey::BlasCache blasCache;
+    std::unique_ptr<tracey::BlasPrebuilder> prebuilder;
+    tracey::ImportStream importStream;
+    if (stream)
+    {
+        prebuilder = std::make_unique<tracey::BlasPrebuilder>(device.get(), blasCache, bvhConfig);
+        importStream.onObject = [&](const std::string &name, const tracey::SceneObject &obj) {
+            prebuilder->push(name, obj);
+        };
+    }
+
     std::unique_ptr<tracey::Scene> scene;
     const std::string ext = scenePath.extension().string();
 #ifdef TRACEY_HAS_USD
     if (ext == ".usd" || ext == ".usda" || ext == ".usdc" || ext == ".usdz")
-        scene = tracey::UsdLoader::loadFromFile(scenePath.string());
+        scene = stream ? tracey::UsdLoader::loadFromFileStreaming(scenePath.string(), importStream)
+                       : tracey::UsdLoader::loadFromFile(scenePath.string());
     else
 #endif
     if (ext == ".gltf" || ext == ".glb")
-        scene = tracey::GltfLoader::loadFromFile(scenePath);
+        scene = stream ? tracey::GltfLoader::loadFromFileStreaming(scenePath, importStream)
+                       : tracey::GltfLoader::loadFromFile(scenePath);
     else
         scene = tracey::SceneLoader::loadFromFile(scenePath);
+    const auto loadEnd = std::chrono::high_resolution_clock::now();
+    if (prebuilder) prebuilder->finish();
 
     // Inject a Distant (sun) light to exercise analytic-light NEE + shadow rays.
     // Direction comes from the actor's rotation × -Z, so aim -Z down/front-right
@@ -209,11 +271,17 @@ int main(int argc, char *argv[])
         std::cout << "Injected Dome (intensity " << domeIntensity << ")\n";
     }
 
-    std::unique_ptr<tracey::Device> device(
-        tracey::createDevice(tracey::DeviceType::Gpu, tracey::DeviceBackend::Compute));
-
     tracey::SceneCompiler::CompiledScene compiled =
-        tracey::SceneCompiler::compile(device.get(), *scene);
+        tracey::SceneCompiler::compile(device.get(), *scene, bvhConfig, &blasCache);
+    {
+        const auto compileEnd = std::chrono::high_resolution_clock::now();
+        using ms = std::chrono::duration<double, std::milli>;
+        std::cout << "Time to first render: " << ms(compileEnd - loadStart).count() << " ms (load "
+                  << ms(loadEnd - loadStart).count() << " ms, compile "
+                  << ms(compileEnd - loadEnd).count() << " ms"
+                  << (prebuilder ? ", " + std::to_string(prebuilder->built()) + " BLASes prebuilt" : std::string())
+                  << ")" << std::endl;
+    }
     if (clearcoat >= 0.0f)
     {
         // Force a clear coat on every material to validate the R3 coat lobe is
@@ -266,6 +334,27 @@ int main(int argc, char *argv[])
         compiled.hasMotion = true;
         std::cout << "Motion: instances translated by dx=" << motionDx << " over shutter" << std::endl;
     }
+    // Backend B's own scene when it renders a different BLAS layout (compact
+    // triangles, triangle blocks): the same compile with that BVHConfig,
+    // carrying the overrides injected above.
+    tracey::SceneCompiler::CompiledScene compiledB;
+    if (compact || triangleBlocks)
+    {
+        tracey::BVHConfig bvh = bvhConfig;
+        bvh.compactTriangles = compact;
+        bvh.triangleBlocks = triangleBlocks;
+        compiledB = tracey::SceneCompiler::compile(device.get(), *scene, bvh);
+        compiledB.materials = compiled.materials;
+        compiledB.instancesEnd = compiled.instancesEnd;
+        compiledB.hasMotion = compiled.hasMotion;
+        if (compact)
+            std::cout << "Compact: backend B renders compact triangles + shading data" << std::endl;
+        if (triangleBlocks)
+            std::cout << "Triangle blocks: backend B renders 4-wide SoA leaves (leafThreshold "
+                      << bvh.leafThreshold << ")"
+                      << (tracey::kTriangleBlockKernel ? "" : " -- no NEON/FMA3 kernel in this build, blocks skipped")
+                      << std::endl;
+    }
     std::cout << "Compiled: " << compiled.instances.size() << " instances, "
               << compiled.blases.size() << " BLASes, "
               << compiled.textures.size() << " textures, "
@@ -302,7 +391,9 @@ int main(int argc, char *argv[])
         std::array<std::vector<float>, kAov> aovs;
     };
 
-    auto renderWith = [&](const std::string &backendName) -> RenderOut {
+    auto renderWith = [&](const std::string &backendName,
+                          const tracey::SceneCompiler::CompiledScene &sceneToRender,
+                          bool compactData, bool cached) -> RenderOut {
         tracey::PathTracerConfig config;
         config.width = size;
         config.height = size;
@@ -312,6 +403,10 @@ int main(int argc, char *argv[])
         config.maxBounces = bounces;
         config.enableAovs = true;  // exercise + compare the AOV layers too
         config.backend = tracey::pathTracerBackendKindFromString(backendName);
+        config.compactShadingData = compactData;
+        config.radianceCache = cached;
+        config.radianceCacheCellSize = cacheCell;
+        config.radianceCacheMinSamples = cacheMinSamples;
 
         tracey::PathTracer tracer(device.get(), config);
         tracer.setMaterialPrograms(programs);
@@ -321,12 +416,18 @@ int main(int argc, char *argv[])
         {
             const bool clear = (s == 0);
             const bool want = (s == spp - 1);
-            tracer.render(compiled, camera, clear, want);
+            tracer.render(sceneToRender, camera, clear, want);
         }
         const auto t1 = std::chrono::high_resolution_clock::now();
         const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
-        std::printf("  [%s] %u spp in %.1f ms (%.2f ms/spp)\n",
-                    backendName.c_str(), spp, ms, ms / std::max(spp, 1u));
+        std::printf("  [%s] %u spp in %.1f ms (%.2f ms/spp)%s\n",
+                    backendName.c_str(), spp, ms, ms / std::max(spp, 1u),
+                    cached ? " with radiance cache" : "");
+        const tracey::SceneMemoryStats memory = tracer.sceneMemory();
+        if (memory.acceleration + memory.shading > 0)
+            std::printf("  [%s] scene memory%s: %.1f MB BVH + triangles, %.1f MB shading data\n",
+                        backendName.c_str(), compactData ? " (compact)" : "",
+                        memory.acceleration / (1024.0 * 1024.0), memory.shading / (1024.0 * 1024.0));
         const size_t n4 = static_cast<size_t>(size) * size * 4;
         RenderOut out;
         out.beauty.resize(n4);
@@ -340,9 +441,10 @@ int main(int argc, char *argv[])
     };
 
     std::cout << "Rendering with '" << backendA << "'..." << std::endl;
-    const RenderOut outA = renderWith(backendA);
+    const RenderOut outA = renderWith(backendA, compiled, false, false);
     std::cout << "Rendering with '" << backendB << "'..." << std::endl;
-    const RenderOut outB = renderWith(backendB);
+    const RenderOut outB = renderWith(backendB, (compact || triangleBlocks) ? compiledB : compiled, compact,
+                                      radianceCache);
     const std::vector<float> &imgA = outA.beauty;
     const std::vector<float> &imgB = outB.beauty;
 
@@ -414,6 +516,19 @@ int main(int argc, char *argv[])
         aovFail = aovFail || bad;
     }
 
+    // The block leaf test rounds exactly like the per-triangle one, so the
+    // same backend must produce the same bytes.
+    if (triangleBlocks)
+    {
+        const bool identical = std::memcmp(imgA.data(), imgB.data(), imgA.size() * sizeof(float)) == 0;
+        std::printf("Byte-identical: %s\n", identical ? "yes" : "no");
+        if (!identical)
+        {
+            std::printf("FAIL: triangle-block render differs from the per-triangle render\n");
+            return 1;
+        }
+    }
+
     if (psnr < minPsnr)
     {
         std::printf("FAIL: PSNR %.2f below threshold %.2f\n", psnr, minPsnr);
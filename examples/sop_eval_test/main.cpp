@@ -9,6 +9,15 @@
 //   • The Transform SOP's translate parameter actually shifted positions.
 //   • The Geometry → SceneObject conversion preserves vertex count.
 //   • Catalog query exposes all v1 built-in node kinds.
+//   • Interned attribute handles resolve the same attributes as names.
+//   • Incremental patches (applySopGraphPatch) leave the live graph equal to
+//     a full deserialize of the same edits, and re-cook only what changed.
+//   • A dense Geometry → SceneObject conversion allocates only its output
+//     channels, and copying the SceneObject / handing its UVs and normals to
+//     a BlasCache entry allocates nothing (counted with a replaced global
+//     operator new; the counts are printed).
+//   • Re-cooking an edited graph through one CookCache recycles attribute
+//     storage from the cache's AttributePool without changing the output.
 //
 // Exit 0 on success, non-zero on first failed check (with a printed message).
 //
@@ -19,21 +28,53 @@
 
 #include "geometry/geometry.hpp"
 #include "geometry/geometry_converter.hpp"
+#include "scene/blas_cache.hpp"
 #include "scene/scene_object.hpp"
 
+#include "sops/cook_cache.hpp"
 #include "sops/serialization.hpp"
 #include "sops/sop_graph.hpp"
 #include "sops/sop_node.hpp"
 #include "sops/sop_registry.hpp"
 
+#include <atomic>
 #include <cstdio>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <new>
 #include <string>
+#include <vector>
+
+// Allocation counters for the conversion checks. Every operator new in the
+// process goes through here; the checks read the deltas across one call.
+namespace {
+std::atomic<size_t> g_allocCount{0};
+std::atomic<size_t> g_allocBytes{0};
+}
+
+void *operator new(std::size_t n)
+{
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(n, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
 
 namespace {
 
 int failures = 0;
 
+struct AllocDelta
+{
+    size_t count0 = g_allocCount.load();
+    size_t bytes0 = g_allocBytes.load();
+    size_t count() const { return g_allocCount.load() - count0; }
+    size_t bytes() const { return g_allocBytes.load() - bytes0; }
+};
+
 void check(bool ok, const char *what)
 {
     if (ok)
@@ -58,6 +99,29 @@ void check_eq(T got, T want, const char *what)
                 static_cast<long long>(got), static_cast<long long>(want));
 }
 
+// Cook summary compared between the patched graph and its full-reload twin:
+// per-actor point count plus a position checksum.
+std::string cookSignature(const std::vector<tracey::sops::EmittedActor> &emitted)
+{
+    std::string sig;
+    for (const auto &ea : emitted)
+    {
+        double sum = 0.0;
+        if (ea.geometry)
+            for (const auto &p : ea.geometry->positions()) sum += p.x + 2.0 * p.y + 3.0 * p.z;
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%zu:%.3f;", ea.geometry ? ea.geometry->pointCount() : 0, sum);
+        sig += buf;
+    }
+    return sig;
+}
+
+uint64_t cookIdOf(tracey::sops::CookCache &cache, size_t uid)
+{
+    auto *e = cache.find(uid);
+    return e ? e->cookId : 0;
+}
+
 } // anon
 
 int main()
@@ -140,6 +204,28 @@ int main()
         check_eq<size_t>(so.triangleCount(), 12,    "toSceneObject: triangle count");
     }
 
+    // ── Interned attribute lookup ─────────────────────────────────────────
+    std::printf("[sop_eval_test] attribute handles\n");
+    {
+        Geometry g;
+        g.addPoint(Vec3(0.0f));
+        g.points().add<float>("mass", 2.0f);
+        g.points().add(kAttrCd, Vec3(1.0f));
+        const AttributeHandle<float> mass("mass");
+        check(g.points().get(mass) == g.points().get<float>("mass") && g.points().get(mass),
+              "handles: interned lookup finds the string-added attribute");
+        check(g.points().get(kAttrP) == g.points().get<Vec3>("P"), "handles: pre-registered P");
+        check(AttributeHandle<float>("mass").id() == mass.id(), "handles: names intern once");
+        check(g.points().get(AttributeHandle<Vec3>(mass.id())) == nullptr,
+              "handles: type mismatch resolves to nullptr");
+        const auto names = g.points().names();
+        check(names.size() == 3 && names[0] == "P" && names[1] == "mass" && names[2] == "Cd",
+              "handles: table keeps insertion order");
+        Geometry copy = g;
+        check(copy.points().get(mass) && copy.points().get(mass)->data()[0] == 2.0f,
+              "handles: copied table resolves the same ids");
+    }
+
     // ── JSON round-trip ───────────────────────────────────────────────────
     std::printf("[sop_eval_test] JSON round-trip\n");
     const std::string jsonText = serializeSopGraph(graph);
@@ -163,6 +249,223 @@ int main()
         }
     }
 
+    // ── Incremental patch vs full reload ──────────────────────────────────
+    // `live` takes each edit as a patch on top of a warm CookCache; `mirror`
+    // takes the same edits through the Graph API and is then reloaded from
+    // JSON, which is what a whole-graph set_sop_graph push amounts to.
+    std::printf("[sop_eval_test] incremental patch round-trip\n");
+    {
+        auto live = deserializeSopGraph(jsonText);
+        auto mirror = deserializeSopGraph(jsonText);
+        CookCache cache;
+        CookDiagnostic pd;
+        live->cook(&pd, 0.0, &cache);
+        const uint64_t cubeCook0 = cookIdOf(cache, cubeUid);
+
+        auto compareWithReload = [&](const char *what) {
+            auto reference = deserializeSopGraph(serializeSopGraph(*mirror));
+            const bool sameJson = serializeSopGraph(*live) == serializeSopGraph(*reference);
+            CookDiagnostic ld, rd;
+            const auto liveEmit = live->cook(&ld, 0.0, &cache);
+            const auto refEmit = reference->cook(&rd);
+            std::string msg = std::string(what) + ": graph equals full reload";
+            check(sameJson, msg.c_str());
+            msg = std::string(what) + ": cached cook equals full-reload cook";
+            check(ld.ok && rd.ok && !liveEmit.empty() &&
+                      cookSignature(liveEmit) == cookSignature(refEmit),
+                  msg.c_str());
+        };
+
+        // 1. Slider edit.
+        applySopGraphPatch(*live, R"({"version": 1, "ops": [
+            {"op": "set_param", "node": 2, "name": "translate",
+             "param": {"type": "vec3", "value": [2.0, 0.0, 0.0]}}
+        ]})", &cache);
+        mirror->findNode(xformUid)->setParamVec3("translate", {2.0f, 0.0f, 0.0f});
+        const uint64_t xformCook0 = cookIdOf(cache, xformUid);
+        compareWithReload("set_param");
+        check_eq<uint64_t>(cookIdOf(cache, cubeUid), cubeCook0, "set_param: upstream cube not re-cooked");
+        check(cookIdOf(cache, xformUid) > xformCook0, "set_param: edited transform re-cooked");
+
+        // 2. Structural edit: merge + sphere spliced in ahead of the output,
+        //    plus a subnet carrying its own inner graph.
+        applySopGraphPatch(*live, R"({"version": 1, "ops": [
+            {"op": "add_node", "parent": 0, "node": {"uid": 4, "kind": "merge", "pos": [0, 0], "params": {}}},
+            {"op": "add_node", "parent": 0, "node": {"uid": 5, "kind": "primitive_sphere", "pos": [0, 0], "params": {}}},
+            {"op": "connect", "from_node": 2, "from_port": 0, "to_node": 4, "to_port": 0},
+            {"op": "connect", "from_node": 5, "from_port": 0, "to_node": 4, "to_port": 1},
+            {"op": "connect", "from_node": 4, "from_port": 0, "to_node": 3, "to_port": 0},
+            {"op": "set_pos", "node": 5, "pos": [40, 80]},
+            {"op": "add_node", "parent": 0, "node": {"uid": 6, "kind": "subnet", "pos": [0, 0], "params": {},
+                "subgraph": {"graph_kind": "sop", "version": 1, "uid": 0,
+                    "nodes": [{"uid": 7, "kind": "primitive_cube", "pos": [0, 0], "params": {}},
+                              {"uid": 8, "kind": "object_output", "pos": [0, 0], "params": {}}],
+                    "connections": [{"from_node": 7, "from_port": 0, "to_node": 8, "to_port": 0}]}}},
+            {"op": "set_param", "node": 7, "name": "size", "param": {"type": "float", "value": 3.0}}
+        ]})", &cache);
+        {
+            auto &reg = SopRegistry::instance();
+            mirror->addNode(reg.create("merge", 4));
+            auto sphere = reg.create("primitive_sphere", 5);
+            sphere->setPos(40.0f, 80.0f);
+            mirror->addNode(std::move(sphere));
+            mirror->createConnection(xformUid, 0, 4, 0);
+            mirror->createConnection(5, 0, 4, 1);
+            mirror->removeConnection({xformUid, 0, outUid, 0});
+            mirror->createConnection(4, 0, outUid, 0);
+            auto inner = std::make_unique<SopGraph>(0);
+            auto innerCube = reg.create("primitive_cube", 7);
+            innerCube->setParamFloat("size", 3.0f);
+            inner->addNode(std::move(innerCube));
+            inner->addNode(reg.create("object_output", 8));
+            inner->createConnection(7, 0, 8, 0);
+            auto subnet = reg.create("subnet", 6);
+            subnet->setInnerGraph(std::move(inner));
+            mirror->addNode(std::move(subnet));
+        }
+        compareWithReload("add/connect");
+        check_eq<uint64_t>(cookIdOf(cache, cubeUid), cubeCook0, "add/connect: upstream cube not re-cooked");
+        check(live->nextUid() > 8, "add/connect: uid allocator moved past subnet contents");
+
+        // 3. Disconnect + delete the sphere, rebuild the transform in place.
+        const uint64_t innerCook = cookIdOf(cache, 7);
+        applySopGraphPatch(*live, R"({"version": 1, "ops": [
+            {"op": "disconnect", "from_node": 5, "from_port": 0, "to_node": 4, "to_port": 1},
+            {"op": "remove_node", "node": 5},
+            {"op": "replace_node", "node": {"uid": 2, "kind": "transform", "pos": [0, 0],
+                "params": {"translate": {"type": "vec3", "value": [0.0, 3.0, 0.0]}}}}
+        ]})", &cache);
+        {
+            mirror->removeConnection({5, 0, 4, 1});
+            mirror->removeNode(5);
+            auto xform2 = SopRegistry::instance().create("transform", xformUid);
+            xform2->setParamVec3("translate", {0.0f, 3.0f, 0.0f});
+            mirror->replaceNode(std::move(xform2));
+        }
+        compareWithReload("remove/replace");
+        check(cache.find(5) == nullptr, "remove/replace: removed node's cache entry dropped");
+        check_eq<uint64_t>(cookIdOf(cache, 7), innerCook, "remove/replace: subnet contents not re-cooked");
+
+        bool threw = false;
+        try { applySopGraphPatch(*live, R"({"ops": [{"op": "remove_node", "node": 99}]})", &cache); }
+        catch (const std::exception &) { threw = true; }
+        check(threw, "unknown uid rejected");
+    }
+
+    // ── Dense Geometry → SceneObject hand-off ────────────────────────────
+    // A 512×256 sphere (point N, vertex uv): the conversion should allocate
+    // its four output channels and nothing per triangle; the SceneObject
+    // copy into a Scene and the BlasCache entry's UVs / normals share them.
+    std::printf("[sop_eval_test] dense SceneObject conversion\n");
+    {
+        SopGraph dense(0);
+        auto sphere = SopRegistry::instance().create("primitive_sphere", dense.nextUid());
+        sphere->setParamInt("segments", 512);
+        sphere->setParamInt("rings", 256);
+        auto sink = SopRegistry::instance().create("object_output", dense.nextUid());
+        const size_t sphereUid = sphere->uid(), sinkUid = sink->uid();
+        dense.addNode(std::move(sphere));
+        dense.addNode(std::move(sink));
+        dense.createConnection(sphereUid, 0, sinkUid, 0);
+        CookDiagnostic denseDiag;
+        auto denseOut = dense.cook(&denseDiag);
+        check(denseDiag.ok && denseOut.size() == 1 && denseOut[0].geometry, "dense: cooked");
+        if (!denseOut.empty() && denseOut[0].geometry)
+        {
+            const Geometry &geo = *denseOut[0].geometry;
+            const size_t corners = geo.primitiveCount() * 3;
+            const size_t channelBytes = corners * (2 * sizeof(Vec3) + sizeof(Vec2)); // P, N, uv
+
+            AllocDelta convert;
+            SceneObject so = GeometryConverter::toSceneObject(geo, "dense");
+            const size_t convertCount = convert.count(), convertBytes = convert.bytes();
+            std::printf("  toSceneObject: %zu corners, %zu allocations, %.1f MB (channels %.1f MB)\n",
+                        corners, convertCount, convertBytes / 1048576.0, channelBytes / 1048576.0);
+            check_eq<size_t>(so.vertexCount(), corners, "dense: per-corner positions");
+            check(so.hasNormals() && so.hasUvs() && !so.hasColors(), "dense: N and uv carried, no Cd");
+            check(convertCount <= 16, "dense: conversion allocation count independent of size");
+            check(convertBytes < channelBytes + channelBytes / 8, "dense: conversion allocates ~its outputs only");
+
+            // Reference gather, serial, straight off the attribute tables.
+            const auto *P = geo.points().get<Vec3>("P");
+            const auto *uv = geo.vertices().get<Vec2>("uv");
+            const auto *N = geo.points().get<Vec3>("N");
+            bool same = P && uv && N;
+            for (size_t t = 0; same && t < geo.primitiveCount(); ++t)
+                for (uint32_t k = 0; k < 3 && same; ++k)
+                {
+                    const uint32_t vid = geo.primitivesList()[t].firstVertex + k;
+                    const uint32_t pid = geo.vertexToPoint()[vid];
+                    const size_t c = t * 3 + k;
+                    same = so.positions()[c] == P->data()[pid] && so.normals()[c] == N->data()[pid] &&
+                           so.uvs()[c] == uv->data()[vid];
+                }
+            check(same, "dense: parallel gather matches the attribute tables");
+
+            AllocDelta handOff;
+            SceneObject copy = so;
+            BlasCache::Entry entry;
+            entry.uvs = copy.sharedUvs();
+            entry.normals = copy.sharedNormals();
+            std::printf("  SceneObject copy + BlasCache hand-off: %zu allocations, %zu bytes\n",
+                        handOff.count(), handOff.bytes());
+            check_eq<size_t>(handOff.bytes(), 0, "dense: copy + cache hand-off allocate nothing");
+            check(entry.uvs.sharesWith(so.sharedUvs()) && entry.normals.sharesWith(so.sharedNormals()),
+                  "dense: cache entry shares the SceneObject's storage");
+
+            // Copy-on-write: editing the copy must not touch the original.
+            SceneObject edited = so;
+            edited.setNormals(std::vector<Vec3>(corners, Vec3(0.0f, 0.0f, 1.0f)));
+            check(so.normals()[0] == N->data()[geo.vertexToPoint()[0]], "dense: original survives an edited copy");
+        }
+    }
+
+    // ── Attribute recycling across cooks ─────────────────────────────────
+    // Scrubbing a slider on a dense chain: each re-cook replaces the
+    // transform's cached output, and the CookCache's AttributePool should
+    // serve the next cook from those buffers. Output must not change.
+    std::printf("[sop_eval_test] attribute pool reuse\n");
+    {
+        SopGraph chain(0);
+        auto &reg = SopRegistry::instance();
+        auto sphere = reg.create("primitive_sphere", chain.nextUid());
+        sphere->setParamInt("segments", 256);
+        sphere->setParamInt("rings", 128);
+        auto move = reg.create("transform", chain.nextUid());
+        auto sink = reg.create("object_output", chain.nextUid());
+        const size_t sphereUid = sphere->uid(), moveUid = move->uid(), sinkUid = sink->uid();
+        chain.addNode(std::move(sphere));
+        chain.addNode(std::move(move));
+        chain.addNode(std::move(sink));
+        chain.createConnection(sphereUid, 0, moveUid, 0);
+        chain.createConnection(moveUid, 0, sinkUid, 0);
+
+        CookCache cache;
+        size_t reused = 0, allocated = 0;
+        bool same = true;
+        for (int i = 0; i < 4; ++i)
+        {
+            chain.findNode(moveUid)->setParamVec3("translate", {float(i), 0.0f, 0.0f});
+            std::vector<NodeCookTiming> timings;
+            CookDiagnostic cd, rd;
+            const auto cached = chain.cook(&cd, 0.0, &cache, &timings);
+            const auto reference = chain.cook(&rd);
+            same = same && cd.ok && rd.ok && !cached.empty() &&
+                   cookSignature(cached) == cookSignature(reference);
+            if (i == 0) continue;
+            for (const auto &t : timings)
+            {
+                reused += t.reused;
+                allocated += t.allocations;
+            }
+        }
+        std::printf("  re-cooks: %zu attribute buffers reused, %zu allocated, %zu bytes retained\n",
+                    reused, allocated, cache.pool().retainedBytes());
+        check(reused > 0, "pool: re-cooks reuse the replaced outputs' storage");
+        check(reused >= allocated, "pool: re-cooks allocate less than they reuse");
+        check(same, "pool: cached cooks equal uncached cooks");
+    }
+
     if (failures > 0)
     {
         std::printf("\n[sop_eval_test] %d failure(s)\n", failures);
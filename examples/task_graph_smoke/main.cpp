@@ -0,0 +1,246 @@
+// Smoke test + scaling benchmark for the work-stealing scheduler
+// (core/parallel, core/task_graph).
+//
+// Checks that parallel_for_chunks covers its range exactly once, that nested
+// and concurrent parallelFor calls compose (each inner loop still visits every
+// index), that a recursive TaskGroup computes the right result, and that a
+// TaskGraph honours its edges, rejects cycles and can be re-run.
+//
+// Then times four workloads on private pools of 1, 8, 32 and 64 lanes (plus the
+// machine's own width when it differs) and prints the speedup over one lane:
+//   flat   — one large parallelFor of uneven per-item cost
+//   nested — 64 outer items each running an inner parallelFor (used to be
+//            serialised by the old pool)
+//   fib    — recursive TaskGroup spawn/wait, fine-grained
+//   graph  — a layered DAG, each node depending on three in the layer above
+// Lane counts above the core count oversubscribe and will not scale; the
+// table is meant for wide machines.
+//
+// Exit 0 on success. Depends only on `tracey`.
+
+#include "core/parallel.hpp"
+#include "core/task_graph.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace tracey;
+
+namespace {
+int failures = 0;
+void check(bool ok, const char *what)
+{
+    if (ok) std::printf("  ok   %s\n", what);
+    else { ++failures; std::printf("  FAIL %s\n", what); }
+}
+
+// Deterministic busy work whose cost varies with i, so the loops need
+// balancing. Returned so the optimiser cannot drop it.
+double work(size_t i, int iters)
+{
+    double x = double(i % 97) * 0.001 + 1.0;
+    const int n = iters + int(i % 7) * iters / 4;
+    for (int k = 0; k < n; ++k) x = std::sqrt(x * 1.0001 + 0.5);
+    return x;
+}
+
+uint64_t fibSerial(int n) { return n < 2 ? uint64_t(n) : fibSerial(n - 1) + fibSerial(n - 2); }
+
+uint64_t fibTasks(ThreadPool &pool, int n)
+{
+    if (n < 16) return fibSerial(n);
+    uint64_t a = 0, b = 0;
+    TaskGroup g(pool);
+    g.run([&] { a = fibTasks(pool, n - 1); });
+    b = fibTasks(pool, n - 2);
+    g.wait();
+    return a + b;
+}
+
+template <typename F>
+double timeMs(F &&f)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+struct BenchResult
+{
+    double flat = 0, nested = 0, fib = 0, graph = 0;
+};
+
+BenchResult bench(size_t lanes)
+{
+    ThreadPool pool(lanes - 1);
+    BenchResult r;
+    std::vector<double> out(1 << 16);
+    volatile double sink = 0;
+
+    r.flat = timeMs([&] {
+        pool.parallelFor(out.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) out[i] = work(i, 64);
+        });
+    });
+
+    r.nested = timeMs([&] {
+        pool.parallelFor(
+            64,
+            [&](size_t ob, size_t oe) {
+                for (size_t o = ob; o < oe; ++o)
+                    pool.parallelFor(1024, [&](size_t b, size_t e) {
+                        for (size_t i = b; i < e; ++i) out[o * 1024 + i] = work(i, 64);
+                    });
+            },
+            1);
+    });
+
+    r.fib = timeMs([&] { sink = double(fibTasks(pool, 30)); });
+
+    r.graph = timeMs([&] {
+        constexpr int kLayers = 16, kWidth = 64;
+        TaskGraph g;
+        for (int l = 0; l < kLayers; ++l)
+            for (int w = 0; w < kWidth; ++w)
+                g.add([&out, l, w] { out[size_t(l * kWidth + w)] = work(size_t(w), 4096); });
+        for (int l = 1; l < kLayers; ++l)
+            for (int w = 0; w < kWidth; ++w)
+                for (int d = -1; d <= 1; ++d)
+                    g.precede(TaskGraph::Node((l - 1) * kWidth + (w + d + kWidth) % kWidth),
+                              TaskGraph::Node(l * kWidth + w));
+        g.run(pool);
+    });
+    (void)sink;
+    return r;
+}
+}
+
+int main()
+{
+    std::printf("[task_graph_smoke]\n");
+    ThreadPool &pool = ThreadPool::global();
+    std::printf("  global pool: %zu workers + caller\n", pool.workerCount());
+
+    // --- parallel_for_chunks covers [0,n) exactly once -----------------------
+    {
+        std::vector<std::atomic<int>> hits(100000);
+        parallel_for_chunks(hits.size(), [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i) hits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+        bool once = true;
+        for (auto &h : hits) once = once && h.load() == 1;
+        check(once, "parallel_for_chunks visits every index once");
+    }
+
+    // --- nested loops compose -------------------------------------------------
+    {
+        std::vector<std::atomic<int>> hits(32 * 4096);
+        parallel_for_each_index(32, [&](size_t o) {
+            parallel_for_chunks(4096, [&](size_t b, size_t e) {
+                for (size_t i = b; i < e; ++i) hits[o * 4096 + i].fetch_add(1, std::memory_order_relaxed);
+            });
+        });
+        bool once = true;
+        for (auto &h : hits) once = once && h.load() == 1;
+        check(once, "nested parallelFor visits every inner index once");
+    }
+
+    // --- concurrent dispatches from several outside threads --------------------
+    {
+        std::atomic<uint64_t> total{0};
+        std::vector<std::thread> callers;
+        for (int t = 0; t < 4; ++t)
+            callers.emplace_back([&] {
+                for (int rep = 0; rep < 8; ++rep)
+                    parallel_for_chunks(20000, [&](size_t b, size_t e) {
+                        total.fetch_add(e - b, std::memory_order_relaxed);
+                    });
+            });
+        for (auto &c : callers) c.join();
+        check(total.load() == uint64_t(4) * 8 * 20000, "concurrent parallelFor from 4 threads");
+    }
+
+    // --- TaskGroup ----------------------------------------------------------------
+    check(fibTasks(pool, 24) == fibSerial(24), "recursive TaskGroup fib(24)");
+    {
+        std::atomic<int> ran{0};
+        {
+            TaskGroup g;
+            for (int i = 0; i < 1000; ++i)
+                g.run([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+        } // destructor waits
+        check(ran.load() == 1000, "TaskGroup destructor waits for its tasks");
+    }
+
+    // --- TaskGraph ----------------------------------------------------------------
+    {
+        // Diamond a -> (b, c) -> d, plus a chain d -> e; every node records
+        // the order it finished in.
+        std::atomic<int> clock{0};
+        int stamp[5] = {};
+        TaskGraph g;
+        TaskGraph::Node n[5];
+        for (int i = 0; i < 5; ++i)
+            n[i] = g.add([&stamp, &clock, i] { stamp[i] = clock.fetch_add(1) + 1; });
+        g.precede(n[0], n[1]);
+        g.precede(n[0], n[2]);
+        g.precede(n[1], n[3]);
+        g.precede(n[2], n[3]);
+        g.precede(n[3], n[4]);
+        bool ordered = true;
+        for (int rep = 0; rep < 50 && ordered; ++rep)
+        {
+            clock = 0;
+            ordered = g.run() && stamp[0] == 1 && stamp[1] > stamp[0] && stamp[2] > stamp[0] &&
+                      stamp[3] > stamp[1] && stamp[3] > stamp[2] && stamp[4] == 5;
+        }
+        check(ordered, "TaskGraph honours edges across 50 re-runs");
+
+        TaskGraph cyclic;
+        int ran = 0;
+        const auto a = cyclic.add([&] { ++ran; });
+        const auto b = cyclic.add([&] { ++ran; });
+        cyclic.precede(a, b);
+        cyclic.precede(b, a);
+        check(!cyclic.run() && ran == 0, "TaskGraph rejects a cycle without running it");
+    }
+    {
+        // Wide fan-out: one root releasing 2000 leaves, all feeding one sink.
+        std::atomic<int> leaves{0};
+        int sinkSaw = -1;
+        TaskGraph g;
+        const auto root = g.add([] {});
+        const auto sink = g.add([&] { sinkSaw = leaves.load(); });
+        for (int i = 0; i < 2000; ++i)
+        {
+            const auto leaf = g.add([&] { leaves.fetch_add(1, std::memory_order_relaxed); });
+            g.precede(root, leaf);
+            g.precede(leaf, sink);
+        }
+        check(g.run() && sinkSaw == 2000, "TaskGraph fan-out/fan-in");
+    }
+
+    // --- scaling ------------------------------------------------------------------
+    std::vector<size_t> laneCounts = {1, 8, 32, 64};
+    const size_t hw = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    if (std::find(laneCounts.begin(), laneCounts.end(), hw) == laneCounts.end())
+        laneCounts.push_back(hw);
+    std::printf("  scaling (%zu hardware threads; ms, speedup vs 1 lane):\n", hw);
+    std::printf("  %6s %16s %16s %16s %16s\n", "lanes", "flat", "nested", "fib", "graph");
+    BenchResult base;
+    for (size_t lanes : laneCounts)
+    {
+        const BenchResult r = bench(lanes);
+        if (lanes == 1) base = r;
+        std::printf("  %6zu %9.1f (%4.1fx) %9.1f (%4.1fx) %9.1f (%4.1fx) %9.1f (%4.1fx)\n", lanes,
+                    r.flat, base.flat / r.flat, r.nested, base.nested / r.nested,
+                    r.fib, base.fib / r.fib, r.graph, base.graph / r.graph);
+    }
+
+    std::printf(failures ? "[task_graph_smoke] %d FAILED\n" : "[task_graph_smoke] all passed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -9,9 +9,15 @@
 // apply_emitted's pullUsdMaterial does (walk actors → SceneInstance whose
 // objectRef == the prim path → its MaterialInstance).
 //
+// And that loadFromFileStreaming builds the same scene: every streamed object
+// is in it under the same name with the same geometry (contentHash — what the
+// BlasCache keys a prebuilt BLAS on), and every mesh prim counts toward the
+// "meshes" progress.
+//
 //   usd_import_smoke <scene.usd[a|c|z]>
 
 #include "scene/usd_loader.hpp"
+#include "scene/import_stream.hpp"
 #include "scene/scene.hpp"
 #include "scene/scene_object.hpp"
 #include "scene/actor.hpp"
@@ -21,7 +27,9 @@
 #include "scene/camera.hpp"
 
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include <unordered_map>
 
 int main(int argc, char **argv)
 {
@@ -132,6 +140,52 @@ int main(int argc, char **argv)
 
     std::printf("materials recovered: %d\n", materialsFound);
 
+    // ── Streaming load: same objects, same geometry ──
+    {
+        std::unordered_map<std::string, uint64_t> streamed;
+        tracey::ImportProgress lastMeshes;
+        tracey::ImportStream stream;
+        stream.onObject = [&](const std::string &name, const tracey::SceneObject &obj) {
+            streamed[name] = obj.contentHash();
+        };
+        stream.onProgress = [&](const tracey::ImportProgress &p) {
+            if (std::strcmp(p.stage, "meshes") == 0) lastMeshes = p;
+        };
+        auto streamedScene = tracey::UsdLoader::loadFromFileStreaming(path, stream);
+        if (!streamedScene)
+        {
+            std::fprintf(stderr, "FAIL: loadFromFileStreaming returned null\n");
+            ok = 0;
+        }
+        else
+        {
+            if (streamedScene->objects().size() != scene->objects().size() ||
+                streamedScene->actors().size() != scene->actors().size())
+            {
+                std::fprintf(stderr, "FAIL: streaming load built a different scene (%zu/%zu objects)\n",
+                             streamedScene->objects().size(), scene->objects().size());
+                ok = 0;
+            }
+            for (const auto &[name, hash] : streamed)
+            {
+                const auto *obj = scene->getObject(name);
+                if (!obj || obj->contentHash() != hash)
+                {
+                    std::fprintf(stderr, "FAIL: streamed object '%s' does not match the loaded scene\n",
+                                 name.c_str());
+                    ok = 0;
+                }
+            }
+            if (lastMeshes.done != lastMeshes.total)
+            {
+                std::fprintf(stderr, "FAIL: mesh progress ended at %zu/%zu\n", lastMeshes.done, lastMeshes.total);
+                ok = 0;
+            }
+        }
+        std::printf("streamed: %zu object(s), mesh progress %zu/%zu\n",
+                    streamed.size(), lastMeshes.done, lastMeshes.total);
+    }
+
     // ── Lights + camera (what import_usd_stage replicates into the editor) ──
     int lightCount = 0;
     const char *kTypeName[] = {"point", "distant", "dome", "area"};
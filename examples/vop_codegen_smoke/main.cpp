@@ -22,6 +22,7 @@
 #include "vops/vop_node.hpp"
 #include "vops/vop_registry.hpp"
 
+#include "gpu/shader_cache.hpp"
 #include "gpu/shader_compiler.hpp"
 #include "device/device.hpp"
 #include "geometry/geometry.hpp"
@@ -32,6 +33,8 @@
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <functional>
 #include <memory>
 #include <stdexcept>
@@ -334,8 +337,85 @@ namespace
                         gpuP[0].x, gpuP[0].y, gpuP[0].z);
         }
     }
+
+    // 7) On-disk SPIR-V cache. A private cache in a scratch directory
+    //    checks the store / load / validation / eviction rules without
+    //    shaderc; then the global instance is pointed at the same kind
+    //    of directory to confirm a repeated compile is a cache hit.
+    void test_shader_cache()
+    {
+        namespace fs = std::filesystem;
+        using tracey::ShaderCache;
+        std::error_code ec;
+        const fs::path dir = fs::temp_directory_path(ec) / "tracey_vop_codegen_smoke_spv";
+        fs::remove_all(dir, ec);
+
+        ShaderCache cache(tracey::ShaderCacheConfig{dir, 4096});
+        const auto keyA = ShaderCache::makeKey("comp", "void main(){}", "a", "v1");
+        const auto keyB = ShaderCache::makeKey("comp", "void main(){}", "a", "v2");
+        check(!(keyA == keyB), "spv cache: compiler version changes the key");
+
+        std::vector<uint32_t> module(64, 0u), got;
+        module[0] = 0x07230203u;
+        for (size_t i = 1; i < module.size(); ++i) module[i] = static_cast<uint32_t>(i * 2654435761u);
+        check(!cache.load(keyA, got), "spv cache: cold lookup misses");
+        cache.store(keyA, module);
+        check(cache.load(keyA, got) && got == module, "spv cache: stored module loads back");
+        check(!cache.load(keyB, got), "spv cache: other key still misses");
+
+        // Flip one payload byte: the load must reject (and delete) it.
+        fs::path file;
+        for (const auto &e : fs::directory_iterator(dir, ec)) file = e.path();
+        {
+            std::fstream f(file, std::ios::in | std::ios::out | std::ios::binary);
+            f.seekp(60);
+            f.put('\x5a');
+        }
+        check(!cache.load(keyA, got), "spv cache: corrupt module rejected");
+        check(!fs::exists(file), "spv cache: corrupt module deleted");
+
+        // 4 KiB cap, ~300 B per module: storing 32 must evict.
+        for (int i = 0; i < 32; ++i)
+            cache.store(ShaderCache::makeKey("comp", std::to_string(i), "n", "v1"), module);
+        uint64_t onDisk = 0;
+        for (const auto &e : fs::directory_iterator(dir, ec)) onDisk += e.file_size();
+        const auto st = cache.stats();
+        check(onDisk <= 4096 && st.evictions > 0, "spv cache: size cap enforced by eviction");
+        check(st.hits == 1 && st.rejected == 1, "spv cache: hit / reject counters");
+        std::printf("       stats: hits %llu, misses %llu, stores %llu, evictions %llu, %llu B on disk\n",
+                    (unsigned long long)st.hits, (unsigned long long)st.misses,
+                    (unsigned long long)st.stores, (unsigned long long)st.evictions,
+                    (unsigned long long)onDisk);
+
+        // Through ShaderCompiler: the second compile of the same source
+        // must come from disk, byte-identical.
+        auto &global = ShaderCache::instance();
+        const auto saved = global.config();
+        global.setConfig(tracey::ShaderCacheConfig{dir / "global", saved.maxBytes});
+        global.resetStats();
+        const char *src = "#version 450\nlayout(local_size_x = 64) in;\n"
+                          "layout(std430, binding = 0) buffer B { float v[]; };\n"
+                          "void main() { v[gl_GlobalInvocationID.x] *= 2.0; }\n";
+        try
+        {
+            tracey::ShaderCompiler compiler;
+            const auto cold = compiler.compileComputeShader(src, "cache_probe");
+            const auto warm = compiler.compileComputeShader(src, "cache_probe");
+            const auto gst = global.stats();
+            check(gst.misses == 1 && gst.hits == 1, "spv cache: recompile is a cache hit");
+            check(cold == warm, "spv cache: cached SPIR-V identical to compiled");
+        }
+        catch (const std::exception &e)
+        {
+            std::fprintf(stderr, "  ── shaderc error for 'cache_probe':\n%s\n", e.what());
+            check(false, "spv cache: probe shader compiles");
+        }
+        global.setConfig(saved);
+        fs::remove_all(dir, ec);
+    }
 }
 
+
 int main()
 {
     tracey::vops::registerBuiltinVops();
@@ -347,6 +427,7 @@ int main()
     test_geo_io_passthrough();
     test_geo_io_default_stamp();
     test_kitchen_sink();
+    test_shader_cache();
 
     // ── Phase 2 verification: CPU evaluator vs GPU dispatcher ────────
     // Skip silently when no Vulkan device is available (e.g. CI without
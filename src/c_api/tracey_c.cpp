@@ -5,6 +5,15 @@
 // translation unit; the public header (tracey_c.h) is pure C. This is the
 // embedding boundary — heavy optional modules (USD/MaterialX/OIDN) are NOT
 // referenced here, keeping the ABI small and dependency-free.
+//
+// Incremental updates: every scene edit is stamped from a per-scene counter,
+// and each renderer remembers the stamp its CompiledScene was synced to. On
+// the next render only the delta is applied — moved instances are rewritten
+// and the TLAS rebuilt, edited materials are patched in the material buffer
+// — while structural edits (new meshes/instances/lights/instance groups,
+// moved group placements, replaced geometry, anything emissive) fall back to
+// SceneCompiler::compile, whose BlasCache still skips every BLAS whose
+// geometry is unchanged.
 
 #include "tracey_c.h"
 
@@ -30,9 +39,18 @@
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <new>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace
 {
@@ -80,6 +98,48 @@ namespace
         return mat;
     }
 
+    bool isEmissive(const tracey_material *m)
+    {
+        return m && m->emission_strength > 0.0f &&
+               (m->emission[0] > 0.0f || m->emission[1] > 0.0f || m->emission[2] > 0.0f);
+    }
+
+    // Shared by add_mesh and replace_mesh.
+    bool fillMesh(tracey::SceneObject &obj,
+                  const float *positions, uint32_t vertex_count,
+                  const float *normals, const float *uvs,
+                  const uint32_t *indices, uint32_t index_count)
+    {
+        if (!positions || !indices || vertex_count == 0 || index_count == 0) return false;
+
+        std::vector<tracey::Vec3> pos(vertex_count);
+        for (uint32_t i = 0; i < vertex_count; ++i)
+            pos[i] = tracey::Vec3(positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]);
+        obj.setPositions(std::move(pos));
+
+        std::vector<uint32_t> idx(indices, indices + index_count);
+        obj.setIndices(std::move(idx));
+
+        std::vector<tracey::Vec3> n;
+        if (normals)
+        {
+            n.resize(vertex_count);
+            for (uint32_t i = 0; i < vertex_count; ++i)
+                n[i] = tracey::Vec3(normals[i * 3 + 0], normals[i * 3 + 1], normals[i * 3 + 2]);
+        }
+        obj.setNormals(std::move(n));
+
+        std::vector<tracey::Vec2> u;
+        if (uvs)
+        {
+            u.resize(vertex_count);
+            for (uint32_t i = 0; i < vertex_count; ++i)
+                u[i] = tracey::Vec2(uvs[i * 2 + 0], uvs[i * 2 + 1]);
+        }
+        obj.setUvs(std::move(u));
+        return true;
+    }
+
     tracey::PathTracerBackendKind toBackendKind(tracey_backend b)
     {
         switch (b)
@@ -102,7 +162,36 @@ struct tracey_device_t
 
 struct tracey_scene_t
 {
+    // Guards everything below: an async render syncs from its worker thread
+    // between passes while the caller may still be editing.
+    std::mutex mutex;
     tracey::Scene scene;
+
+    // One record per tracey_scene_add_instance, indexed by instance id. The
+    // C API gives every instance its own root actor, so the actor's
+    // transform is the instance's world transform.
+    struct InstanceRecord
+    {
+        tracey::Actor *actor = nullptr;
+        uint64_t transformEdit = 0; // edit stamp of the last move
+        uint64_t materialEdit = 0;  // edit stamp of the last material change
+        bool emissive = false;
+        // Places an instance group: it compiles to one entry (nested) or one
+        // per leaf (flat), so edits to it take the full compile.
+        bool placesGroup = false;
+    };
+    std::vector<InstanceRecord> instances;
+
+    // Process-unique id, so a renderer never mistakes a new scene that
+    // happens to reuse a freed handle's address for the one it compiled.
+    uint64_t serial = 0;
+    // Bumped by every edit; `structureEdit` is the stamp of the last edit
+    // that needs a full compile.
+    uint64_t edit = 1;
+    uint64_t structureEdit = 1;
+
+    uint64_t bump() { return ++edit; }
+    void bumpStructure() { structureEdit = bump(); }
 };
 
 struct tracey_renderer_t
@@ -116,8 +205,176 @@ struct tracey_renderer_t
     // a process-lifetime static that is finalized after the device is gone,
     // crashing in ~VulkanBuffer. This is the same pattern render_engine uses.)
     tracey::BlasCache blasCache;
+
+    // The persistent compiled scene and the scene state it reflects.
+    std::unique_ptr<tracey::SceneCompiler::CompiledScene> compiled;
+    uint64_t compiledSerial = 0;
+    uint64_t syncedEdit = 0;
+    std::vector<size_t> instanceSlot; // instance id → compiled->instances index
+    tracey::Camera camera;
+
+    // Async render state. `status` holds a tracey_render_status.
+    std::thread worker;
+    std::atomic<bool> cancel{false};
+    std::atomic<int> status{TRACEY_RENDER_IDLE};
+    std::string workerError;
+    std::vector<uint8_t> frame; // progressive image handed to the callback
+
+    ~tracey_renderer_t()
+    {
+        cancel.store(true);
+        if (worker.joinable()) worker.join();
+    }
 };
 
+namespace
+{
+    constexpr size_t kNoSlot = std::numeric_limits<size_t>::max();
+
+    std::atomic<uint64_t> g_nextSceneSerial{1};
+
+    // Bring `r`'s compiled scene up to date with `s`. Caller holds s.mutex.
+    void syncCompiled(tracey_renderer_t &r, tracey_scene_t &s)
+    {
+        using tracey::SceneCompiler;
+        r.camera = s.scene.camera();
+
+        if (!r.compiled || r.compiledSerial != s.serial || s.structureEdit > r.syncedEdit)
+        {
+            // Backends that walk instance groups get them nested.
+            r.compiled = std::make_unique<SceneCompiler::CompiledScene>(
+                SceneCompiler::compile(r.device, s.scene, tracey::BVHConfig{}, &r.blasCache,
+                                       /*buildAccelerationStructures=*/true,
+                                       /*nestInstanceGroups=*/r.tracer->supportsInstanceGroups()));
+            r.compiledSerial = s.serial;
+
+            // Resolve instance ids to TLAS slots through the actor each slot
+            // was emitted for (invisible / empty instances get no slot).
+            std::unordered_map<uint64_t, size_t> slotOfActor;
+            const auto &actorUids = r.compiled->instanceToActorUid;
+            for (size_t i = 0; i < actorUids.size(); ++i) slotOfActor.emplace(actorUids[i], i);
+            r.instanceSlot.assign(s.instances.size(), kNoSlot);
+            for (size_t k = 0; k < s.instances.size(); ++k)
+            {
+                auto it = slotOfActor.find(static_cast<uint64_t>(s.instances[k].actor->getUid()));
+                if (it != slotOfActor.end()) r.instanceSlot[k] = it->second;
+            }
+            r.syncedEdit = s.edit;
+            return;
+        }
+        if (s.edit == r.syncedEdit) return;
+
+        SceneCompiler::CompiledScene &c = *r.compiled;
+        bool moved = false;
+        bool restyled = false;
+        const size_t count = std::min(s.instances.size(), r.instanceSlot.size());
+        for (size_t k = 0; k < count; ++k)
+        {
+            const auto &rec = s.instances[k];
+            const size_t slot = r.instanceSlot[k];
+            if (slot == kNoSlot) continue;
+            if (rec.transformEdit > r.syncedEdit)
+            {
+                c.instances[slot].setTransform(rec.actor->transform().toMatrix());
+                if (slot < c.instancesEnd.size()) c.instancesEnd[slot] = c.instances[slot];
+                moved = true;
+            }
+            if (rec.materialEdit > r.syncedEdit)
+            {
+                c.materials[c.instanceToMaterialIndex[slot]] =
+                    SceneCompiler::materialFactors(rec.actor->instances().front().material());
+                restyled = true;
+            }
+        }
+
+        if (moved && c.tlas)
+        {
+            c.tlas = std::unique_ptr<tracey::TopLevelAccelerationStructure>(
+                r.device->createTopLevelAccelerationStructure(
+                    std::span<const tracey::BottomLevelAccelerationStructure *>(
+                        c.blases.data(), c.blases.size()),
+                    std::span<const tracey::Tlas::Instance>(c.instances.data(), c.instances.size())));
+        }
+        if (restyled && c.materialBuffer)
+        {
+            auto *mapped = static_cast<tracey::GPUMaterial *>(c.materialBuffer->mapForWriting());
+            std::copy(c.materials.begin(), c.materials.end(), mapped);
+            c.materialBuffer->flush();
+        }
+        // In-place mutation: stamp a fresh revision so backends that cache
+        // per-scene resources pick the change up.
+        if (moved || restyled)
+            c.markChanged((moved ? SceneCompiler::CompiledScene::ChangeInstances : 0u) |
+                          (restyled ? SceneCompiler::CompiledScene::ChangeMaterials : 0u));
+        r.syncedEdit = s.edit;
+    }
+
+    // Trace `passes` render() calls of `s` into `r`, syncing at every pass
+    // boundary. An edit that lands mid-render restarts accumulation. Runs on
+    // the caller's thread for tracey_render and on the worker for
+    // tracey_render_async. Throws on engine failure.
+    tracey_render_status renderPasses(tracey_renderer_t &r, tracey_scene_t &s, uint32_t passes,
+                                      tracey_progress_callback callback, void *user_data)
+    {
+        using Clock = std::chrono::steady_clock;
+        const size_t frameBytes = static_cast<size_t>(r.config.width) * r.config.height *
+                                  (r.config.hdrOutput ? 16u : 4u);
+        const uint32_t samplesTotal = passes * r.config.samplesPerFrame;
+
+        uint32_t pass = 0;
+        double traceSeconds = 0.0;
+        Clock::time_point started = Clock::now();
+        while (pass < passes)
+        {
+            if (r.cancel.load(std::memory_order_relaxed)) return TRACEY_RENDER_CANCELLED;
+
+            bool restart = (pass == 0);
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (!s.scene.hasCamera())
+                    throw std::runtime_error("scene has no camera (call tracey_scene_set_camera)");
+                if (restart || r.compiledSerial != s.serial || s.edit != r.syncedEdit)
+                {
+                    syncCompiled(r, s);
+                    restart = true;
+                }
+            }
+            if (restart && pass != 0)
+            {
+                pass = 0;
+                traceSeconds = 0.0;
+                started = Clock::now();
+            }
+
+            const bool want = callback != nullptr || pass + 1 == passes;
+            const Clock::time_point t0 = Clock::now();
+            r.tracer->render(*r.compiled, r.camera, restart, want);
+            traceSeconds += std::chrono::duration<double>(Clock::now() - t0).count();
+            // Cancelled during the pass: the image may be partly traced, so
+            // stop here rather than report it as progress.
+            if (r.cancel.load(std::memory_order_relaxed)) return TRACEY_RENDER_CANCELLED;
+            ++pass;
+
+            if (callback)
+            {
+                r.frame.resize(frameBytes);
+                const size_t bytes = r.tracer->readback(r.frame.data());
+                tracey_progress p;
+                p.samples_done = r.tracer->sampleCount();
+                p.samples_total = samplesTotal;
+                p.samples_per_second = traceSeconds > 0.0 ? p.samples_done / traceSeconds : 0.0;
+                p.elapsed_seconds = std::chrono::duration<double>(Clock::now() - started).count();
+                p.pixels = r.frame.data();
+                p.pixel_bytes = bytes;
+                p.width = r.config.width;
+                p.height = r.config.height;
+                if (callback(&p, user_data) != 0) r.cancel.store(true, std::memory_order_relaxed);
+            }
+        }
+        return TRACEY_RENDER_COMPLETED;
+    }
+}
+
 // ── Defaults ────────────────────────────────────────────────────────────────
 
 extern "C" tracey_material tracey_material_default(void)
@@ -207,7 +464,12 @@ extern "C" tracey_scene tracey_scene_create(void)
 {
     clearError();
     auto *wrap = new (std::nothrow) tracey_scene_t;
-    if (!wrap) setError("out of memory");
+    if (!wrap)
+    {
+        setError("out of memory");
+        return nullptr;
+    }
+    wrap->serial = g_nextSceneSerial.fetch_add(1, std::memory_order_relaxed);
     return wrap;
 }
 
@@ -224,6 +486,7 @@ extern "C" int tracey_scene_add_mesh(tracey_scene scene, const char *name,
         setError("add_mesh: null/empty argument");
         return -1;
     }
+    std::lock_guard<std::mutex> lock(scene->mutex);
     if (scene->scene.hasObject(name))
     {
         setError(std::string("add_mesh: duplicate mesh name '") + name + "'");
@@ -232,31 +495,35 @@ extern "C" int tracey_scene_add_mesh(tracey_scene scene, const char *name,
 
     auto obj = std::make_unique<tracey::SceneObject>();
     obj->setName(name);
+    fillMesh(*obj, positions, vertex_count, normals, uvs, indices, index_count);
 
-    std::vector<tracey::Vec3> pos(vertex_count);
-    for (uint32_t i = 0; i < vertex_count; ++i)
-        pos[i] = tracey::Vec3(positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]);
-    obj->setPositions(std::move(pos));
-
-    std::vector<uint32_t> idx(indices, indices + index_count);
-    obj->setIndices(std::move(idx));
+    scene->scene.addObject(name, std::move(obj));
+    scene->bumpStructure();
+    return 0;
+}
 
-    if (normals)
+extern "C" int tracey_scene_replace_mesh(tracey_scene scene, const char *name,
+                                         const float *positions, uint32_t vertex_count,
+                                         const float *normals, const float *uvs,
+                                         const uint32_t *indices, uint32_t index_count)
+{
+    clearError();
+    if (!scene || !name || !positions || !indices || vertex_count == 0 || index_count == 0)
     {
-        std::vector<tracey::Vec3> n(vertex_count);
-        for (uint32_t i = 0; i < vertex_count; ++i)
-            n[i] = tracey::Vec3(normals[i * 3 + 0], normals[i * 3 + 1], normals[i * 3 + 2]);
-        obj->setNormals(std::move(n));
+        setError("replace_mesh: null/empty argument");
+        return -1;
     }
-    if (uvs)
+    std::lock_guard<std::mutex> lock(scene->mutex);
+    tracey::SceneObject *obj = scene->scene.getObject(name);
+    if (!obj)
     {
-        std::vector<tracey::Vec2> u(vertex_count);
-        for (uint32_t i = 0; i < vertex_count; ++i)
-            u[i] = tracey::Vec2(uvs[i * 2 + 0], uvs[i * 2 + 1]);
-        obj->setUvs(std::move(u));
+        setError(std::string("replace_mesh: unknown mesh '") + name + "'");
+        return -1;
     }
-
-    scene->scene.addObject(name, std::move(obj));
+    // The BlasCache keys on the object's content hash, so the next compile
+    // rebuilds this mesh's BLAS and reuses every other one.
+    fillMesh(*obj, positions, vertex_count, normals, uvs, indices, index_count);
+    scene->bumpStructure();
     return 0;
 }
 
@@ -270,7 +537,10 @@ extern "C" int tracey_scene_add_instance(tracey_scene scene, const char *mesh_na
         setError("add_instance: null argument");
         return -1;
     }
-    if (!scene->scene.hasObject(mesh_name))
+    std::lock_guard<std::mutex> lock(scene->mutex);
+    const bool placesGroup = !scene->scene.hasObject(mesh_name) &&
+                             scene->scene.hasInstanceGroup(mesh_name);
+    if (!scene->scene.hasObject(mesh_name) && !placesGroup)
     {
         setError(std::string("add_instance: unknown mesh '") + mesh_name + "'");
         return -1;
@@ -281,8 +551,113 @@ extern "C" int tracey_scene_add_instance(tracey_scene scene, const char *mesh_na
     actor->setTransform(transformFromColumnMajor(transform4x4));
 
     tracey::SceneInstance inst(mesh_name);
-    if (material) inst.setMaterial(toMaterialInstance(*material));
+    if (material && !placesGroup) inst.setMaterial(toMaterialInstance(*material));
     actor->addInstance(std::move(inst));
+
+    scene->bumpStructure();
+    tracey_scene_t::InstanceRecord rec;
+    rec.actor = actor;
+    rec.emissive = !placesGroup && isEmissive(material);
+    rec.placesGroup = placesGroup;
+    scene->instances.push_back(rec);
+    return static_cast<int>(scene->instances.size() - 1);
+}
+
+extern "C" int tracey_scene_set_instance_transform(tracey_scene scene, int instance,
+                                                   const float *transform4x4)
+{
+    clearError();
+    if (!scene || !transform4x4)
+    {
+        setError("set_instance_transform: null argument");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(scene->mutex);
+    if (instance < 0 || static_cast<size_t>(instance) >= scene->instances.size())
+    {
+        setError("set_instance_transform: unknown instance " + std::to_string(instance));
+        return -1;
+    }
+    auto &rec = scene->instances[static_cast<size_t>(instance)];
+    rec.actor->setTransform(transformFromColumnMajor(transform4x4));
+    // Emissive geometry is baked into world-space emitter triangles at
+    // compile time; moving it needs the full path.
+    if (rec.emissive || rec.placesGroup) scene->bumpStructure();
+    else rec.transformEdit = scene->bump();
+    return 0;
+}
+
+extern "C" int tracey_scene_set_instance_material(tracey_scene scene, int instance,
+                                                  const tracey_material *material)
+{
+    clearError();
+    if (!scene || !material)
+    {
+        setError("set_instance_material: null argument");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(scene->mutex);
+    if (instance < 0 || static_cast<size_t>(instance) >= scene->instances.size())
+    {
+        setError("set_instance_material: unknown instance " + std::to_string(instance));
+        return -1;
+    }
+    auto &rec = scene->instances[static_cast<size_t>(instance)];
+    if (rec.placesGroup)
+    {
+        setError("set_instance_material: instance " + std::to_string(instance) +
+                 " places a group; its members carry the materials");
+        return -1;
+    }
+    rec.actor->instances().front().setMaterial(toMaterialInstance(*material));
+    const bool emissive = isEmissive(material);
+    if (rec.emissive || emissive) scene->bumpStructure();
+    else rec.materialEdit = scene->bump();
+    rec.emissive = emissive;
+    return 0;
+}
+
+extern "C" int tracey_scene_add_instance_group(tracey_scene scene, const char *group_name,
+                                               const char *const *member_names,
+                                               const tracey_material *materials,
+                                               const float *transforms4x4, uint32_t count)
+{
+    clearError();
+    if (!scene || !group_name || !member_names || !transforms4x4)
+    {
+        setError("add_instance_group: null argument");
+        return -1;
+    }
+    if (count == 0)
+    {
+        setError(std::string("add_instance_group: group '") + group_name + "' is empty");
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(scene->mutex);
+    if (scene->scene.hasObject(group_name))
+    {
+        setError(std::string("add_instance_group: '") + group_name + "' is already a mesh");
+        return -1;
+    }
+
+    std::vector<tracey::SceneInstance> members;
+    members.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const char *ref = member_names[i];
+        if (!ref || (!scene->scene.hasObject(ref) && !scene->scene.hasInstanceGroup(ref)))
+        {
+            setError(std::string("add_instance_group: unknown member '") + (ref ? ref : "(null)") +
+                     "' in group '" + group_name + "'");
+            return -1;
+        }
+        tracey::SceneInstance member(ref);
+        if (materials) member.setMaterial(toMaterialInstance(materials[i]));
+        member.setLocalTransform(transformFromColumnMajor(transforms4x4 + size_t(i) * 16));
+        members.push_back(std::move(member));
+    }
+    scene->scene.addInstanceGroup(group_name, std::move(members));
+    scene->bumpStructure();
     return 0;
 }
 
@@ -304,10 +679,12 @@ extern "C" int tracey_scene_add_light(tracey_scene scene, const tracey_light *li
     l.size = tracey::Vec2(light->size[0], light->size[1]);
     if (light->hdri_path) l.hdriPath = light->hdri_path;
 
+    std::lock_guard<std::mutex> lock(scene->mutex);
     tracey::Actor *actor = scene->scene.createActor();
     actor->setName("light");
     actor->setTransform(transformFromColumnMajor(transform4x4));
     actor->setLight(l);
+    scene->bumpStructure();
     return 0;
 }
 
@@ -335,7 +712,9 @@ extern "C" void tracey_scene_set_camera(tracey_scene scene, const tracey_camera
         cam.setFocalDistance(camera->focal_distance > 0.0f ? camera->focal_distance
                                                            : (dist > 1e-6f ? dist : 1.0f));
     }
+    std::lock_guard<std::mutex> lock(scene->mutex);
     scene->scene.setCamera(cam);
+    scene->bump(); // no recompile, but a running render restarts
 }
 
 // ── Renderer ────────────────────────────────────────────────────────────────
@@ -368,6 +747,9 @@ extern "C" tracey_renderer tracey_renderer_create(tracey_device device,
     try
     {
         wrap->tracer = std::make_unique<tracey::PathTracer>(wrap->device, cfg);
+        // Lets tracey_render_cancel cut the pass in flight short, not just
+        // stop before the next one (CPU backend: checked per pixel row).
+        wrap->tracer->setCancelFlag(&wrap->cancel);
         // Passthrough program: copies the compiled GPUMaterial slots verbatim.
         // One program covers every instance (instanceProgramIndex defaults 0).
         tracey::MaterialProgramBuffer programs;
@@ -394,34 +776,106 @@ extern "C" int tracey_render(tracey_renderer renderer, tracey_scene scene,
         setError("render: null argument");
         return -1;
     }
-    if (!scene->scene.hasCamera())
+    if (renderer->status.load() == TRACEY_RENDER_RUNNING)
     {
-        setError("render: scene has no camera (call tracey_scene_set_camera)");
+        setError("render: an async render is in progress on this renderer");
         return -1;
     }
     if (sample_count == 0) sample_count = 1;
 
+    tracey_render_status result;
     try
     {
-        tracey::SceneCompiler::CompiledScene compiled =
-            tracey::SceneCompiler::compile(renderer->device, scene->scene, &renderer->blasCache);
-        const tracey::Camera camera = scene->scene.camera();
+        renderer->cancel.store(false);
+        result = renderPasses(*renderer, *scene, sample_count, nullptr, nullptr);
+    }
+    catch (const std::exception &e)
+    {
+        setError(std::string("render: ") + e.what());
+        return -1;
+    }
+    return result == TRACEY_RENDER_CANCELLED ? TRACEY_RENDER_CANCELLED : 0;
+}
 
-        for (uint32_t s = 0; s < sample_count; ++s)
+extern "C" int tracey_render_async(tracey_renderer renderer, tracey_scene scene,
+                                   uint32_t sample_count,
+                                   tracey_progress_callback callback, void *user_data)
+{
+    clearError();
+    if (!renderer || !scene || !renderer->tracer)
+    {
+        setError("render_async: null argument");
+        return -1;
+    }
+    if (renderer->status.load() == TRACEY_RENDER_RUNNING)
+    {
+        setError("render_async: an async render is already in progress");
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(scene->mutex);
+        if (!scene->scene.hasCamera())
         {
-            const bool clear = (s == 0);
-            const bool want = (s == sample_count - 1);
-            renderer->tracer->render(compiled, camera, clear, want);
+            setError("render_async: scene has no camera (call tracey_scene_set_camera)");
+            return -1;
         }
     }
+    if (sample_count == 0) sample_count = 1;
+
+    // Reap the previous (finished) worker before starting the next.
+    if (renderer->worker.joinable()) renderer->worker.join();
+    renderer->cancel.store(false);
+    renderer->workerError.clear();
+    renderer->status.store(TRACEY_RENDER_RUNNING);
+    try
+    {
+        renderer->worker = std::thread([renderer, scene, sample_count, callback, user_data] {
+            tracey_render_status result = TRACEY_RENDER_FAILED;
+            try
+            {
+                result = renderPasses(*renderer, *scene, sample_count, callback, user_data);
+            }
+            catch (const std::exception &e)
+            {
+                renderer->workerError = std::string("render_async: ") + e.what();
+            }
+            renderer->status.store(result);
+        });
+    }
     catch (const std::exception &e)
     {
-        setError(std::string("render: ") + e.what());
+        renderer->status.store(TRACEY_RENDER_FAILED);
+        setError(std::string("render_async: ") + e.what());
         return -1;
     }
     return 0;
 }
 
+extern "C" void tracey_render_cancel(tracey_renderer renderer)
+{
+    if (renderer) renderer->cancel.store(true);
+}
+
+extern "C" tracey_render_status tracey_render_wait(tracey_renderer renderer)
+{
+    clearError();
+    if (!renderer)
+    {
+        setError("render_wait: null argument");
+        return TRACEY_RENDER_FAILED;
+    }
+    if (renderer->worker.joinable()) renderer->worker.join();
+    const auto status = static_cast<tracey_render_status>(renderer->status.load());
+    if (status == TRACEY_RENDER_FAILED) setError(renderer->workerError);
+    return status;
+}
+
+extern "C" tracey_render_status tracey_render_poll(tracey_renderer renderer)
+{
+    if (!renderer) return TRACEY_RENDER_FAILED;
+    return static_cast<tracey_render_status>(renderer->status.load());
+}
+
 extern "C" size_t tracey_readback_beauty(tracey_renderer renderer, void *out)
 {
     clearError();
@@ -30,6 +30,13 @@
  *     float *px = malloc(512 * 512 * 4 * sizeof(float));
  *     tracey_readback_beauty(r, px);              // RGBA32F (HDR)
  *
+ *     // Later frames: edit the scene in place; the renderer keeps its
+ *     // compiled scene and only patches what changed.
+ *     tracey_scene_set_instance_transform(scn, inst, moved4x4);
+ *     tracey_render_async(r, scn, 256, on_progress, user); // returns at once
+ *     ...
+ *     tracey_render_wait(r);                      // or tracey_render_cancel(r)
+ *
  *     tracey_renderer_destroy(r);
  *     tracey_scene_destroy(scn);
  *     tracey_device_destroy(dev);                 // device last
@@ -40,6 +47,17 @@
  *     renderer BEFORE the device.
  *   - Mesh/instance/light/camera data passed to add_* functions is copied;
  *     the caller's buffers need not outlive the call.
+ *   - A renderer keeps the last scene it rendered compiled. Edits made
+ *     through the tracey_scene_set_* / replace functions are applied to that
+ *     compiled scene incrementally on the next render; a scene must outlive
+ *     any render (sync or async) that uses it.
+ *
+ * Threading:
+ *   - Scene functions may be called from any thread, including while an
+ *     async render of that scene is running: the render picks the edit up
+ *     at its next pass and restarts accumulation.
+ *   - A renderer runs at most one render at a time. Readbacks are safe from
+ *     the progress callback or once tracey_render_wait() has returned.
  *
  * Errors:
  *   - Handle-returning functions return NULL on failure.
@@ -98,6 +116,16 @@ typedef enum tracey_aov
     TRACEY_AOV_COUNT       = 6
 } tracey_aov;
 
+/* State of a renderer's most recent render (see tracey_render_async). */
+typedef enum tracey_render_status
+{
+    TRACEY_RENDER_IDLE      = 0, /* nothing started yet                  */
+    TRACEY_RENDER_RUNNING   = 1,
+    TRACEY_RENDER_COMPLETED = 2, /* all requested samples accumulated    */
+    TRACEY_RENDER_CANCELLED = 3, /* stopped early; partial image is kept */
+    TRACEY_RENDER_FAILED    = 4  /* see tracey_last_error after wait     */
+} tracey_render_status;
+
 /* ── POD parameter structs ───────────────────────────────────────────────── */
 
 /* PBR material. All colors are linear RGB. Use tracey_material_default() to
@@ -157,6 +185,26 @@ typedef struct tracey_render_config
     tracey_backend backend;     /* (default TRACEY_BACKEND_AUTO) */
 } tracey_render_config;
 
+/* Progress report handed to the async render callback after every pass
+ * (one pass = samples_per_frame samples). `pixels` is the current beauty
+ * image in the same format tracey_readback_beauty writes; it is only valid
+ * for the duration of the callback. */
+typedef struct tracey_progress
+{
+    uint32_t samples_done;      /* accumulated so far (restarts on scene edit) */
+    uint32_t samples_total;     /* as requested                                */
+    double   samples_per_second;/* per pixel, over the time spent tracing      */
+    double   elapsed_seconds;   /* since the accumulation (re)started          */
+    const void *pixels;
+    size_t   pixel_bytes;
+    uint32_t width;
+    uint32_t height;
+} tracey_progress;
+
+/* Async render callback, invoked on the render thread. Return 0 to keep
+ * going, non-zero to cancel (same as tracey_render_cancel). */
+typedef int (*tracey_progress_callback)(const tracey_progress *progress, void *user_data);
+
 /* ── Defaults ────────────────────────────────────────────────────────────── */
 
 tracey_material      tracey_material_default(void);
@@ -194,13 +242,53 @@ int tracey_scene_add_mesh(tracey_scene scene, const char *name,
                           const float *normals, const float *uvs,
                           const uint32_t *indices, uint32_t index_count);
 
+/* Replace the geometry of a previously-added mesh (same arguments as
+ * tracey_scene_add_mesh). Every instance of it picks up the new geometry;
+ * only this mesh's BLAS is rebuilt on the next render. Returns 0 on success,
+ * < 0 on failure (unknown name, empty geometry). */
+int tracey_scene_replace_mesh(tracey_scene scene, const char *name,
+                              const float *positions, uint32_t vertex_count,
+                              const float *normals, const float *uvs,
+                              const uint32_t *indices, uint32_t index_count);
+
 /* Instantiate a previously-added mesh with a material and a column-major 4x4
  * world transform (16 floats). If material is NULL, the mesh's default
- * material is used. Returns 0 on success, < 0 on failure. */
+ * material is used. `mesh_name` may also name an instance group (see
+ * tracey_scene_add_instance_group), which places every member of it; the
+ * members carry their own materials, so `material` is ignored then.
+ * Returns the instance id (>= 0, assigned in order from 0) on success, < 0 on
+ * failure. */
 int tracey_scene_add_instance(tracey_scene scene, const char *mesh_name,
                               const tracey_material *material,
                               const float *transform4x4);
 
+/* Declare (or replace) a named instance group: `count` members, member i
+ * instantiating member_names[i] (a mesh, or another group to nest it) with
+ * materials[i] (materials may be NULL for every member's default) at
+ * transforms4x4[i * 16] (column-major, in the group's local space). Place
+ * the group with tracey_scene_add_instance. On the CPU backend every
+ * placement shares the members, so N placements of an M-member group cost
+ * N + M instances rather than N * M; other backends expand it. Returns 0 on
+ * success, < 0 on failure (empty group, unknown member, a name already used
+ * by a mesh). */
+int tracey_scene_add_instance_group(tracey_scene scene, const char *group_name,
+                                    const char *const *member_names,
+                                    const tracey_material *materials,
+                                    const float *transforms4x4, uint32_t count);
+
+/* Move an instance (column-major 4x4 world transform). On the next render
+ * the renderer rewrites the instance and rebuilds only the TLAS. Returns 0
+ * on success, < 0 on failure (unknown instance id). */
+int tracey_scene_set_instance_transform(tracey_scene scene, int instance,
+                                        const float *transform4x4);
+
+/* Replace an instance's material. On the next render the renderer patches
+ * the instance's material slot in place. (Instances whose old or new
+ * material is emissive force a full recompile instead, since emissive
+ * geometry feeds light sampling.) Returns 0 on success, < 0 on failure. */
+int tracey_scene_set_instance_material(tracey_scene scene, int instance,
+                                       const tracey_material *material);
+
 /* Add a light with a column-major 4x4 world transform (16 floats).
  * Returns 0 on success, < 0 on failure. */
 int tracey_scene_add_light(tracey_scene scene, const tracey_light *light,
@@ -217,13 +305,41 @@ tracey_renderer tracey_renderer_create(tracey_device device,
                                        const tracey_render_config *config);
 void            tracey_renderer_destroy(tracey_renderer renderer);
 
-/* Compile `scene` and render `sample_count` samples, accumulating into the
- * renderer's framebuffer (the accumulator is cleared at the start of the
- * call). The scene must have a camera set. Returns 0 on success, < 0 on
- * failure. After this returns, the readback functions observe the result. */
+/* Bring the renderer's compiled copy of `scene` up to date and render
+ * `sample_count` samples, accumulating into the renderer's framebuffer (the
+ * accumulator is cleared at the start of the call). The first render of a
+ * scene compiles it; later renders apply only the edits made since. The
+ * scene must have a camera set. Returns 0 on success, < 0 on failure
+ * (including while an async render is running), or TRACEY_RENDER_CANCELLED
+ * when tracey_render_cancel from another thread stopped it early (the
+ * partial image is kept). After this returns, the readback functions
+ * observe the result. */
 int tracey_render(tracey_renderer renderer, tracey_scene scene,
                   uint32_t sample_count);
 
+/* Start rendering `sample_count` samples of `scene` on a background thread
+ * and return immediately. After every pass `callback` (may be NULL) gets
+ * the progressive image and the sample rate. Scene edits made meanwhile are
+ * applied between passes and restart accumulation. Returns 0 if the render
+ * started, < 0 on failure (bad arguments, no camera, already running). */
+int tracey_render_async(tracey_renderer renderer, tracey_scene scene,
+                        uint32_t sample_count,
+                        tracey_progress_callback callback, void *user_data);
+
+/* Ask a running render (async, or tracey_render on another thread) to stop.
+ * The pass in flight is cut short where the backend supports it (the CPU
+ * backend checks between pixel rows; GPU backends finish the pass); pixels
+ * it didn't reach keep their previous samples. The renderer stays usable.
+ * Safe to call from any thread, including the callback. No-op when idle. */
+void tracey_render_cancel(tracey_renderer renderer);
+
+/* Block until the current async render (if any) has finished. Returns its
+ * final status; on TRACEY_RENDER_FAILED, tracey_last_error() describes why. */
+tracey_render_status tracey_render_wait(tracey_renderer renderer);
+
+/* Status of the renderer's most recent render, without blocking. */
+tracey_render_status tracey_render_poll(tracey_renderer renderer);
+
 /* Copy the beauty image into `out`. The caller must allocate
  * width*height*4*sizeof(float) bytes when hdr_output is set, else
  * width*height*4 bytes (RGBA8). Returns the number of bytes written, 0 on
@@ -1,6 +1,9 @@
 #include "blas.hpp"
 #include "intersect.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <unordered_map>
 namespace tracey
 {
     // Traversal uses a fixed per-ray stack (kTraversalStackSize). The stack can
@@ -25,6 +28,49 @@ namespace tracey
     {
         const auto primCount = (indices.has_value() ? indices->size() / 3 : (data.size() / stride) / 3);
         std::vector<PrimitiveRef> primRefs(primCount);
+
+        // Compact storage: every distinct vertex goes into the pool once.
+        // Indexed input already names its shared vertices; a triangle soup
+        // is welded on exact position.
+        struct VertexKey
+        {
+            uint32_t x, y, z;
+            bool operator==(const VertexKey &) const = default;
+        };
+        struct VertexKeyHash
+        {
+            size_t operator()(const VertexKey &k) const
+            {
+                return (size_t(k.x) * 73856093u) ^ (size_t(k.y) * 19349663u) ^ (size_t(k.z) * 83492791u);
+            }
+        };
+        std::vector<uint32_t> poolOfSource;
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> poolOfPosition;
+        const auto poolIndex = [&](size_t primitiveId, uint32_t element, const Vec3 &p) -> uint32_t {
+            if (indices)
+            {
+                const uint32_t source = m_vertexIndices[primitiveId * 3 + element];
+                if (source >= poolOfSource.size()) poolOfSource.resize(size_t(source) + 1, ~0u);
+                if (poolOfSource[source] == ~0u)
+                {
+                    poolOfSource[source] = static_cast<uint32_t>(m_compactVertices.size());
+                    m_compactVertices.push_back(p);
+                }
+                return poolOfSource[source];
+            }
+            VertexKey key;
+            std::memcpy(&key.x, &p.x, sizeof(float));
+            std::memcpy(&key.y, &p.y, sizeof(float));
+            std::memcpy(&key.z, &p.z, sizeof(float));
+            const auto [it, inserted] = poolOfPosition.try_emplace(key, static_cast<uint32_t>(m_compactVertices.size()));
+            if (inserted) m_compactVertices.push_back(p);
+            return it->second;
+        };
+        if (config.compactTriangles)
+            m_compactIndices.reserve(primCount * 3);
+        else
+            m_triangleData.reserve(primCount);
+
         for (size_t i = 0; i < primCount; ++i)
         {
             primRefs[i].index = static_cast<uint32_t>(i);
@@ -34,6 +80,13 @@ namespace tracey
             primRefs[i]
                 .bMin = glm::min(glm::min(v0, v1), v2);
             primRefs[i].bMax = glm::max(glm::max(v0, v1), v2);
+            if (config.compactTriangles)
+            {
+                m_compactIndices.push_back(poolIndex(i, 0, v0));
+                m_compactIndices.push_back(poolIndex(i, 1, v1));
+                m_compactIndices.push_back(poolIndex(i, 2, v2));
+                continue;
+            }
             // Store triangle data for intersection
             TriangleData triData;
             triData.v0 = v0;
@@ -42,7 +95,86 @@ namespace tracey
             triData.normal = glm::normalize(glm::cross(triData.edge1, triData.edge2));
             m_triangleData.emplace_back(triData);
         }
+        m_compactVertices.shrink_to_fit();
+
+        buildTree(primRefs);
+        if (config.triangleBlocks && !config.compactTriangles && kTriangleBlockKernel)
+            buildTriangleBlocks();
+    }
+
+    Blas::Blas(std::span<const Vec3> positions, std::span<const uint32_t> indices, const BVHConfig &config) : Blas(std::span<const float>(reinterpret_cast<const float *>(positions.data()), positions.size() * 3), 3, indices, config)
+    {
+    }
+
+    Blas::Blas(std::span<const std::span<const Vec3>> positionKeys, const BVHConfig &config)
+        : m_vertexBuffer(positionKeys.empty()
+                             ? std::span<const float>{}
+                             : std::span<const float>(reinterpret_cast<const float *>(positionKeys[0].data()),
+                                                      positionKeys[0].size() * 3)),
+          m_vertexStride(3),
+          fetchVertexFunc(&Blas::fetchVertex),
+          m_config(config)
+    {
+        // No keys, no triangles: an empty Blas, as the single-key
+        // constructor builds from an empty vertex buffer.
+        if (positionKeys.empty())
+            return;
+        const size_t primCount = m_vertexBuffer.size() / 9;
+        m_motionKeys = static_cast<uint32_t>(std::max<size_t>(positionKeys.size(), 1));
+        for (const auto &key : positionKeys)
+            if (key.size() != positionKeys[0].size())
+                m_motionKeys = 1;
+
+        auto makeTriangle = [](const Vec3 &v0, const Vec3 &v1, const Vec3 &v2) {
+            TriangleData tri;
+            tri.v0 = v0;
+            tri.edge1 = v1 - v0;
+            tri.edge2 = v2 - v0;
+            tri.normal = glm::normalize(glm::cross(tri.edge1, tri.edge2));
+            return tri;
+        };
+
+        // Reference bounds enclose the triangle at every key, so the tree's
+        // topology (and BVHNode bounds) is valid across the whole shutter.
+        std::vector<PrimitiveRef> primRefs(primCount);
+        m_triangleData.reserve(primCount);
+        m_motionTriangles.reserve(primCount * (m_motionKeys - 1));
+        for (uint32_t k = 0; k < m_motionKeys; ++k)
+        {
+            const Vec3 *p = positionKeys[k].data();
+            for (size_t i = 0; i < primCount; ++i)
+            {
+                const Vec3 &v0 = p[i * 3 + 0];
+                const Vec3 &v1 = p[i * 3 + 1];
+                const Vec3 &v2 = p[i * 3 + 2];
+                const Vec3 bMin = glm::min(glm::min(v0, v1), v2);
+                const Vec3 bMax = glm::max(glm::max(v0, v1), v2);
+                if (k == 0)
+                {
+                    primRefs[i] = {static_cast<uint32_t>(i), bMin, bMax};
+                    m_triangleData.push_back(makeTriangle(v0, v1, v2));
+                }
+                else
+                {
+                    primRefs[i].bMin = glm::min(primRefs[i].bMin, bMin);
+                    primRefs[i].bMax = glm::max(primRefs[i].bMax, bMax);
+                    m_motionTriangles.push_back(makeTriangle(v0, v1, v2));
+                }
+            }
+        }
 
+        buildTree(primRefs);
+        if (m_motionKeys > 1)
+            buildSegmentBounds();
+    }
+
+    void Blas::buildTree(std::vector<PrimitiveRef> &primRefs)
+    {
+        const size_t primCount = primRefs.size();
+        // No root at all for an empty Blas: a zero-prim root would read as an
+        // interior node. intersect() already treats no nodes as a miss.
+        if (primCount == 0)
+            return;
         m_nodes.reserve(primCount * 2); // Rough estimate
         m_nodes.emplace_back();         // root
         if (primCount == 1)
@@ -59,8 +191,78 @@ namespace tracey
         buildRecursive(primRefs, 0, 0, static_cast<uint32_t>(primCount), 0);
     }
 
-    Blas::Blas(std::span<const Vec3> positions, std::span<const uint32_t> indices, const BVHConfig &config) : Blas(std::span<const float>(reinterpret_cast<const float *>(positions.data()), positions.size() * 3), 3, indices, config)
+    void Blas::buildSegmentBounds()
+    {
+        // Children are always allocated after their parent, so one reverse
+        // pass sees every child before the node that contains it.
+        const uint32_t segments = m_motionKeys - 1;
+        m_segmentBounds.assign(m_nodes.size() * segments,
+                               {Vec3(std::numeric_limits<float>::max()), 0.0f,
+                                Vec3(std::numeric_limits<float>::lowest()), 0.0f});
+        for (size_t n = m_nodes.size(); n-- > 0;)
+        {
+            const BVHNode &node = m_nodes[n];
+            const uint32_t primCount = node.primCountAndType & 0xFFFFFF;
+            for (uint32_t s = 0; s < segments; ++s)
+            {
+                SegmentBounds &b = m_segmentBounds[n * segments + s];
+                if (primCount > 0)
+                {
+                    for (uint32_t i = node.firstChildOrPrim; i < node.firstChildOrPrim + primCount; ++i)
+                    {
+                        for (uint32_t k = s; k <= s + 1; ++k)
+                        {
+                            const TriangleData &tri = keyTriangle(k, m_primIndices[i]);
+                            const Vec3 v1 = tri.v0 + tri.edge1;
+                            const Vec3 v2 = tri.v0 + tri.edge2;
+                            b.boundsMin = glm::min(b.boundsMin, glm::min(glm::min(tri.v0, v1), v2));
+                            b.boundsMax = glm::max(b.boundsMax, glm::max(glm::max(tri.v0, v1), v2));
+                        }
+                    }
+                }
+                else if (node.firstChildOrPrim > n) // interior (an empty root has no children)
+                {
+                    for (uint32_t c = node.firstChildOrPrim; c <= node.firstChildOrPrim + 1; ++c)
+                    {
+                        const SegmentBounds &cb = m_segmentBounds[c * segments + s];
+                        b.boundsMin = glm::min(b.boundsMin, cb.boundsMin);
+                        b.boundsMax = glm::max(b.boundsMax, cb.boundsMax);
+                    }
+                }
+            }
+        }
+    }
+
+    void Blas::buildTriangleBlocks()
     {
+        m_leafBlocks.assign(m_nodes.size(), 0);
+        for (size_t n = 0; n < m_nodes.size(); ++n)
+        {
+            const BVHNode &node = m_nodes[n];
+            const uint32_t primCount = node.primCountAndType & 0xFFFFFF;
+            if (primCount == 0)
+                continue;
+            m_leafBlocks[n] = static_cast<uint32_t>(m_triangleBlocks.size());
+            for (uint32_t first = 0; first < primCount; first += kTriangleBlockWidth)
+            {
+                TriangleBlock &block = m_triangleBlocks.emplace_back();
+                for (uint32_t lane = 0; lane < kTriangleBlockWidth; ++lane)
+                {
+                    // Pad a short block with its last triangle.
+                    const uint32_t slot = std::min(first + lane, primCount - 1);
+                    const uint32_t primId = m_primIndices[node.firstChildOrPrim + slot];
+                    const TriangleData &tri = m_triangleData[primId];
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        block.v0[axis][lane] = tri.v0[axis];
+                        block.edge1[axis][lane] = tri.edge1[axis];
+                        block.edge2[axis][lane] = tri.edge2[axis];
+                    }
+                    block.primId[lane] = primId;
+                }
+            }
+        }
+        m_triangleBlocks.shrink_to_fit();
     }
 
     // Blas::Blas(std::span<const Vec3> positions, std::span<const uint32_t> indices) : m_vertexBuffer(std::span<const float>(reinterpret_cast<const float *>(positions.data()), positions.size() * 3)), m_vertexIndices(indices)
@@ -93,11 +295,74 @@ namespace tracey
     //     buildRecursive(primRefs, 0, 0, static_cast<uint32_t>(primCount), 0);
     // }
 
+    size_t Blas::memoryBytes() const
+    {
+        return m_nodes.capacity() * sizeof(BVHNode) + m_primIndices.capacity() * sizeof(uint32_t) +
+               (m_triangleData.capacity() + m_motionTriangles.capacity()) * sizeof(TriangleData) +
+               m_segmentBounds.capacity() * sizeof(SegmentBounds) +
+               m_compactVertices.capacity() * sizeof(Vec3) + m_compactIndices.capacity() * sizeof(uint32_t) +
+               m_triangleBlocks.capacity() * sizeof(TriangleBlock) + m_leafBlocks.capacity() * sizeof(uint32_t);
+    }
+
+    Blas::TriangleData Blas::triangle(uint32_t primId) const
+    {
+        if (!compact())
+            return m_triangleData[primId];
+        const uint32_t *tri = &m_compactIndices[size_t(primId) * 3];
+        TriangleData data;
+        data.v0 = m_compactVertices[tri[0]];
+        data.edge1 = m_compactVertices[tri[1]] - data.v0;
+        data.edge2 = m_compactVertices[tri[2]] - data.v0;
+        data.normal = glm::normalize(glm::cross(data.edge1, data.edge2));
+        return data;
+    }
+
     std::optional<Hit> Blas::intersect(const Ray &ray, float tMin, float tMax, RayFlags flags) const
+    {
+        if (m_motionKeys > 1)
+            return intersectImpl<true, false, false>(ray, tMin, tMax, flags);
+        if (!m_triangleBlocks.empty())
+            return intersectImpl<false, false, true>(ray, tMin, tMax, flags);
+        return compact() ? intersectImpl<false, true, false>(ray, tMin, tMax, flags)
+                         : intersectImpl<false, false, false>(ray, tMin, tMax, flags);
+    }
+
+    template <bool Motion, bool Compact, bool Blocks>
+    std::optional<Hit> Blas::intersectImpl(const Ray &ray, float tMin, float tMax, RayFlags flags) const
     {
         if (m_nodes.empty())
             return std::nullopt;
 
+        // The per-ray half of the triangle test, hoisted out of the leaves.
+        const RayShear shear = rayShear(ray.direction);
+        if (!shear.valid)
+            return std::nullopt;
+
+        // Motion: the segment bracketing the ray's time and the position
+        // within it. Boxes come from that segment's bounds, triangles are
+        // interpolated between its two keys.
+        uint32_t segment = 0;
+        float segmentT = 0.0f;
+        if constexpr (Motion)
+        {
+            const uint32_t segments = m_motionKeys - 1;
+            const float x = glm::clamp(ray.time, 0.0f, 1.0f) * static_cast<float>(segments);
+            segment = std::min(static_cast<uint32_t>(x), segments - 1);
+            segmentT = x - static_cast<float>(segment);
+        }
+        const auto testBox = [&](int nodeIndex, float maxT, float &tEnter, float &tExit) {
+            if constexpr (Motion)
+            {
+                const SegmentBounds &b = m_segmentBounds[nodeIndex * (m_motionKeys - 1) + segment];
+                return intersectAABB(ray, b.boundsMin, b.boundsMax, tMin, maxT, tEnter, tExit);
+            }
+            else
+            {
+                return intersectAABB(ray, m_nodes[nodeIndex].boundsMin, m_nodes[nodeIndex].boundsMax,
+                                     tMin, maxT, tEnter, tExit);
+            }
+        };
+
         float closestT = tMax;
         std::optional<Hit> hit = std::nullopt;
 
@@ -115,8 +380,7 @@ namespace tracey
         // intersectAABB is the hottest function in the CPU tracer.
         {
             float rEnter, rExit;
-            if (!intersectAABB(ray, m_nodes[0].boundsMin, m_nodes[0].boundsMax,
-                               tMin, closestT, rEnter, rExit))
+            if (!testBox(0, closestT, rEnter, rExit))
                 return std::nullopt;
             stack[stackTop++] = {0, rEnter};
         }
@@ -131,7 +395,35 @@ namespace tracey
             const BVHNode &node = m_nodes[entry.nodeIndex];
 
             const auto primCount = node.primCountAndType & 0xFFFFFF;
-            if (primCount > 0)
+            if (Blocks && primCount > 0)
+            {
+                // Same per-triangle order and strict t < closestT update as
+                // the loop below, a block of four tests at a time.
+                const TriangleBlock *block = &m_triangleBlocks[m_leafBlocks[entry.nodeIndex]];
+                for (uint32_t first = 0; first < primCount; first += kTriangleBlockWidth, ++block)
+                {
+                    float t[kTriangleBlockWidth], u[kTriangleBlockWidth], v[kTriangleBlockWidth];
+                    const uint32_t mask = intersectTriangleBlock(ray, shear, *block, t, u, v);
+                    if (mask == 0)
+                        continue;
+                    const uint32_t lanes = std::min<uint32_t>(primCount - first, kTriangleBlockWidth);
+                    for (uint32_t lane = 0; lane < lanes; ++lane)
+                    {
+                        if (!(mask & (1u << lane)) || !(t[lane] < closestT))
+                            continue;
+                        closestT = t[lane];
+                        hit = Hit{};
+                        hit->t = t[lane];
+                        hit->u = u[lane];
+                        hit->v = v[lane];
+                        hit->primitiveId = block->primId[lane];
+                        hit->normal = m_triangleData[block->primId[lane]].normal;
+                        if (flags & RAY_FLAG_TERMINATE_ON_FIRST_HIT)
+                            return hit;
+                    }
+                }
+            }
+            else if (primCount > 0)
             {
                 const auto primType = (node.primCountAndType >> 24) & 0xFF;
                 switch (primType)
@@ -140,9 +432,28 @@ namespace tracey
                     for (size_t i = node.firstChildOrPrim; i < node.firstChildOrPrim + primCount; ++i)
                     {
                         const uint32_t primId = m_primIndices[i];
-                        const auto &triData = m_triangleData[primId];
+                        TriangleData localTri;
+                        if constexpr (Motion)
+                        {
+                            const TriangleData &a = keyTriangle(segment, primId);
+                            const TriangleData &b = keyTriangle(segment + 1, primId);
+                            localTri.v0 = glm::mix(a.v0, b.v0, segmentT);
+                            localTri.edge1 = glm::mix(a.edge1, b.edge1, segmentT);
+                            localTri.edge2 = glm::mix(a.edge2, b.edge2, segmentT);
+                        }
+                        else if constexpr (Compact)
+                        {
+                            // Same arithmetic as the TriangleData build, so the
+                            // hit matches the non-compact Blas.
+                            const uint32_t *tri = &m_compactIndices[size_t(primId) * 3];
+                            localTri.v0 = m_compactVertices[tri[0]];
+                            localTri.edge1 = m_compactVertices[tri[1]] - localTri.v0;
+                            localTri.edge2 = m_compactVertices[tri[2]] - localTri.v0;
+                        }
+                        const auto &triData = (Motion || Compact) ? localTri : m_triangleData[primId];
                         Hit localHit;
                         if (intersectTriangle(ray,
+                                              shear,
                                               triData.v0,
                                               triData.edge1,
                                               triData.edge2,
@@ -155,7 +466,10 @@ namespace tracey
                             {
                                 closestT = localHit.t;
                                 hit = localHit;
-                                hit->normal = triData.normal;
+                                if constexpr (Motion || Compact)
+                                    hit->normal = glm::normalize(glm::cross(triData.edge1, triData.edge2));
+                                else
+                                    hit->normal = triData.normal;
                                 if (flags & RAY_FLAG_TERMINATE_ON_FIRST_HIT)
                                     return hit;
                             }
@@ -175,10 +489,8 @@ namespace tracey
                 int right = left + 1;
 
                 float tEnterL, tExitL, tEnterR, tExitR;
-                bool hitL = intersectAABB(ray, m_nodes[left].boundsMin, m_nodes[left].boundsMax,
-                                          tMin, closestT, tEnterL, tExitL);
-                bool hitR = intersectAABB(ray, m_nodes[right].boundsMin, m_nodes[right].boundsMax,
-                                          tMin, closestT, tEnterR, tExitR);
+                bool hitL = testBox(left, closestT, tEnterL, tExitL);
+                bool hitR = testBox(right, closestT, tEnterR, tExitR);
 
                 if (hitL && hitR)
                 {
@@ -215,6 +527,8 @@ namespace tracey
 
     std::tuple<Vec3, Vec3> Blas::getBounds() const
     {
+        if (m_nodes.empty())
+            return {Vec3(0.0f), Vec3(0.0f)};
         return {m_nodes[0].boundsMin, m_nodes[0].boundsMax};
     }
 
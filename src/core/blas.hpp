@@ -25,6 +25,26 @@ namespace tracey
 
         /// Number of bins for SAH evaluation (more bins = better splits, slower build)
         int binCount = 16;
+
+        /// Store each triangle as three indices into a shared, deduplicated
+        /// vertex pool instead of a precomputed 48-byte TriangleData; the
+        /// edges and face normal are rebuilt at the hit. Roughly 18 bytes per
+        /// triangle on a closed mesh instead of 48. Host-side only: GPU
+        /// uploads expand the triangles again. Motion Blases ignore it.
+        bool compactTriangles = false;
+
+        /// Also pack every leaf's triangles into SoA blocks of four
+        /// (TriangleBlock) and test a block at a time with the 4-wide
+        /// watertight kernel (NEON / FMA3). Hits are bit-identical to the
+        /// per-triangle test. Adds 40 bytes per triangle on top of
+        /// TriangleData; host-side only. Ignored with compactTriangles, by
+        /// motion Blases, and in builds without NEON or FMA3
+        /// (kTriangleBlockKernel), where the block test would only be the
+        /// scalar loop. A leaf of at most two full blocks is the sweet spot,
+        /// so pair it with leafThreshold = kTriangleBlockLeafThreshold; that
+        /// value was measured with the FMA3 kernel only.
+        bool triangleBlocks = false;
+        static constexpr int kTriangleBlockLeafThreshold = 8;
     };
 
     class Blas
@@ -33,6 +53,16 @@ namespace tracey
         Blas(std::span<const Vec3> positions, const BVHConfig &config = {});
         Blas(std::span<const float> data, std::uint32_t stride, std::optional<std::span<const uint32_t>> indices = std::nullopt, const BVHConfig &config = {});
         Blas(std::span<const Vec3> positions, std::span<const uint32_t> indices, const BVHConfig &config = {});
+        // Deformation motion blur. `positionKeys` holds K samples of the same
+        // triangle soup (3 vertices per triangle), evenly spaced over the
+        // shutter: key 0 at Ray::time 0, key K-1 at Ray::time 1. intersect()
+        // interpolates each triangle between the two keys bracketing the
+        // ray's time. The tree is built once over the bounds swept by all
+        // keys; every node also keeps its bounds per segment (key k to k+1),
+        // which is what traversal tests, so a ray only pays for the motion
+        // within its own segment. One key, or keys whose sizes differ from
+        // key 0, build a static Blas over key 0; no keys build an empty one.
+        explicit Blas(std::span<const std::span<const Vec3>> positionKeys, const BVHConfig &config = {});
 
         std::optional<Hit> intersect(const Ray &ray, float tMin, float tMax, RayFlags flags) const;
         std::tuple<Vec3, Vec3> getBounds() const;
@@ -55,17 +85,50 @@ namespace tracey
             Vec3 normal;
         };
 
+        // Empty for a compactTriangles Blas; triangle() works for both.
         const auto &triangleData() const
         {
             return m_triangleData;
         }
 
+        bool compact() const { return !m_compactIndices.empty(); }
+        size_t triangleCount() const { return compact() ? m_compactIndices.size() / 3 : m_triangleData.size(); }
+        TriangleData triangle(uint32_t primId) const;
+        // Bytes held by the tree and the triangle storage.
+        size_t memoryBytes() const;
+
         const auto &primIndices() const
         {
             return m_primIndices;
         }
 
+        // Position keys over the shutter; 1 for a static Blas. nodes() and
+        // triangleData() describe key 0 (with swept node bounds), so
+        // consumers that know nothing about motion see a valid, sharp Blas.
+        uint32_t motionKeyCount() const { return m_motionKeys; }
+
     private:
+        // Node bounds for one motion segment. Padded like BVHNode so the
+        // 4-wide loads in intersectAABB stay inside the struct.
+        struct alignas(16) SegmentBounds
+        {
+            Vec3 boundsMin;
+            float pad0;
+            Vec3 boundsMax;
+            float pad1;
+        };
+
+        template <bool Motion, bool Compact, bool Blocks>
+        std::optional<Hit> intersectImpl(const Ray &ray, float tMin, float tMax, RayFlags flags) const;
+        void buildTree(std::vector<PrimitiveRef> &primRefs);
+        void buildTriangleBlocks();
+        void buildSegmentBounds();
+        const TriangleData &keyTriangle(uint32_t key, uint32_t primId) const
+        {
+            return key == 0 ? m_triangleData[primId]
+                            : m_motionTriangles[(key - 1) * m_triangleData.size() + primId];
+        }
+
         uint32_t buildRecursive(std::span<PrimitiveRef> primRefs, uint32_t nodeIndex, uint32_t start, uint32_t end, int depth);
         Vec3 fetchVertex(uint32_t primitiveId, uint32_t element) const
         {
@@ -98,5 +161,23 @@ namespace tracey
         const uint32_t m_vertexStride; // x, y, z
         const FetchFunction fetchVertexFunc;
         BVHConfig m_config;
+
+        // Deformation motion (m_motionKeys > 1): triangles for keys 1..K-1,
+        // key-major, and per-node bounds for each of the K-1 segments,
+        // node-major.
+        uint32_t m_motionKeys = 1;
+        std::vector<TriangleData> m_motionTriangles;
+        std::vector<SegmentBounds> m_segmentBounds;
+
+        // compactTriangles: the deduplicated vertex pool and three pool
+        // indices per triangle, in place of m_triangleData.
+        std::vector<Vec3> m_compactVertices;
+        std::vector<uint32_t> m_compactIndices;
+
+        // triangleBlocks: each leaf's triangles in m_primIndices order,
+        // ceil(count / 4) blocks per leaf, and the first block of every
+        // node (unused for interior nodes).
+        std::vector<TriangleBlock> m_triangleBlocks;
+        std::vector<uint32_t> m_leafBlocks;
     };
 }
\ No newline at end of file
@@ -24,4 +24,20 @@ namespace tracey
     };
 
     static_assert(sizeof(BVHNode) == 32);
+
+    // Leaf storage for BVHConfig::triangleBlocks: up to kTriangleBlockWidth
+    // triangles in SoA layout — [axis][lane] — for the 4-wide leaf test
+    // (intersectTriangleBlock). Same v0 / edge representation as
+    // Blas::TriangleData, so a block hit is the per-triangle hit bit for bit.
+    // Unused lanes repeat the last triangle (same primId): a duplicate hit can
+    // never beat the original under the strict t < closestT update.
+    static constexpr uint32_t kTriangleBlockWidth = 4;
+    struct alignas(16) TriangleBlock
+    {
+        float v0[3][kTriangleBlockWidth];
+        float edge1[3][kTriangleBlockWidth];
+        float edge2[3][kTriangleBlockWidth];
+        uint32_t primId[kTriangleBlockWidth];
+    };
+    static_assert(sizeof(TriangleBlock) == 160, "TriangleBlock must be 160 bytes (4 triangles)");
 }
\ No newline at end of file
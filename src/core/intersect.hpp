@@ -1,9 +1,14 @@
 #pragma once
 #include <tuple>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include "ray.hpp"
+#include "bvh_node.hpp"
 #if defined(__ARM_NEON)
 #include <arm_neon.h>
+#elif defined(__FMA__)
+#include <immintrin.h>
 #endif
 namespace tracey
 {
@@ -46,6 +51,84 @@ namespace tracey
         return tExit >= tEnter;
 #endif
     }
+    // a * b + c. With hardware FMA (every AArch64 target; x86 built with FMA3)
+    // this is one fused, singly-rounded op — spelled out here rather than left
+    // to -ffp-contract, which fuses whichever a*b±c patterns the optimiser
+    // happens to see and so rounds the scalar and SIMD triangle tests
+    // differently (the reason the first SIMD leaf test was reverted). Without
+    // FMA nothing can be contracted and it is a plain multiply-add.
+    inline float fmadd(float a, float b, float c)
+    {
+#if defined(__ARM_FEATURE_FMA) || defined(__FMA__)
+        return std::fma(a, b, c);
+#else
+        return a * b + c;
+#endif
+    }
+
+    // Per-ray half of the watertight test below: kz is the axis of greatest
+    // |direction|, kx,ky cycle after it (swapped when dir[kz] < 0 to preserve
+    // winding so the edge-sign test is consistent across the shared edge), and
+    // S shears the direction onto +z. `valid` is false for a zero-length or
+    // NaN direction, which hits nothing.
+    struct RayShear
+    {
+        int kx = 0, ky = 1, kz = 2;
+        float Sx = 0.0f, Sy = 0.0f, Sz = 0.0f;
+        bool valid = false;
+    };
+
+    inline RayShear rayShear(const Vec3 &dir)
+    {
+        RayShear s;
+        const Vec3 ad(std::abs(dir.x), std::abs(dir.y), std::abs(dir.z));
+        int kz = 0;
+        float amax = ad.x;
+        if (ad.y > amax) { kz = 1; amax = ad.y; }
+        if (ad.z > amax) { kz = 2; amax = ad.z; }
+        if (!(amax > 0.0f))
+            return s;
+        int kx = kz + 1; if (kx == 3) kx = 0;
+        int ky = kx + 1; if (ky == 3) ky = 0;
+        if (dir[kz] < 0.0f) { const int tmp = kx; kx = ky; ky = tmp; }
+        s.kx = kx;
+        s.ky = ky;
+        s.kz = kz;
+        s.Sx = dir[kx] / dir[kz];
+        s.Sy = dir[ky] / dir[kz];
+        s.Sz = 1.0f / dir[kz];
+        s.valid = true;
+        return s;
+    }
+
+    // Exactly-on-an-edge fallback: the edge functions in double precision.
+    // The products of two floats are exact in double, so this rounds the
+    // same however it is compiled.
+    inline void edgeFunctionsDouble(float Ax, float Ay, float Bx, float By, float Cx, float Cy,
+                                    float &U, float &V, float &W)
+    {
+        U = static_cast<float>(static_cast<double>(Cx) * static_cast<double>(By) - static_cast<double>(Cy) * static_cast<double>(Bx));
+        V = static_cast<float>(static_cast<double>(Ax) * static_cast<double>(Cy) - static_cast<double>(Ay) * static_cast<double>(Cx));
+        W = static_cast<float>(static_cast<double>(Bx) * static_cast<double>(Ay) - static_cast<double>(By) * static_cast<double>(Ax));
+    }
+
+    // Final gate shared by the scalar and block tests: signs, det, and t.
+    // Written as !(t > EPSILON) (not t <= EPSILON) so a NaN t is rejected —
+    // matches Möller-Trumbore's old final gate. A NaN/Inf hit must never be
+    // reported: it would slip past the caller's closestT cull and leave the
+    // BVH traversal unable to tighten, deepening the stack.
+    inline bool acceptTriangleHit(float U, float V, float W, float t)
+    {
+        const float EPSILON = 1e-8f;
+        // Two-sided edge test: a hit requires U,V,W to all share a sign (zeros,
+        // i.e. edges/vertices, are allowed). Reject only when the signs disagree.
+        if ((U < 0.0f || V < 0.0f || W < 0.0f) && (U > 0.0f || V > 0.0f || W > 0.0f))
+            return false;
+        if (U + V + W == 0.0f)
+            return false; // ray coplanar with the triangle
+        return t > EPSILON;
+    }
+
     // Watertight ray/triangle intersection — Woop, Benthin & Wald, "Watertight
     // Ray/Triangle Intersection" (JCGT 2013). Replaces Möller-Trumbore's strict
     // u,v ∈ [0,1] test, which leaks: at a shared edge between two triangles,
@@ -61,82 +144,51 @@ namespace tracey
     // faces. Same signature as before — v1/v2 are reconstructed from the edges,
     // and (uOut,vOut) keep Möller-Trumbore's convention (barycentric weights of
     // v1 and v2), so callers and attribute interpolation are unchanged.
-    inline bool intersectTriangle(const Ray &ray, const Vec3 &v0, const Vec3 &edge1, const Vec3 &edge2, float &tOut, float &uOut, float &vOut)
+    //
+    // Every a*b±c goes through fmadd(), in the same order as the 4-wide block
+    // test (intersectTriangleBlock), so the two report bit-identical hits.
+    inline bool intersectTriangle(const Ray &ray, const RayShear &shear, const Vec3 &v0, const Vec3 &edge1,
+                                  const Vec3 &edge2, float &tOut, float &uOut, float &vOut)
     {
-        const float EPSILON = 1e-8f;
+        if (!shear.valid)
+            return false;
+        const int kx = shear.kx, ky = shear.ky, kz = shear.kz;
         const Vec3 v1 = v0 + edge1;
         const Vec3 v2 = v0 + edge2;
-        const Vec3 &dir = ray.direction;
-
-        // Per-ray shear/permutation. kz is the axis of greatest |direction|;
-        // kx,ky cycle after it (swapped when dir[kz] < 0 to preserve winding so
-        // the edge-sign test is consistent across the shared edge). Cheap enough
-        // to recompute per triangle. dir[kz] is the largest-magnitude component,
-        // so it is non-zero for any real (non-degenerate) ray.
-        const Vec3 ad(std::abs(dir.x), std::abs(dir.y), std::abs(dir.z));
-        int kz = 0;
-        float amax = ad.x;
-        if (ad.y > amax) { kz = 1; amax = ad.y; }
-        if (ad.z > amax) { kz = 2; amax = ad.z; }
-        if (!(amax > 0.0f))
-            return false; // degenerate ray: zero-length or NaN direction
-        int kx = kz + 1; if (kx == 3) kx = 0;
-        int ky = kx + 1; if (ky == 3) ky = 0;
-        if (dir[kz] < 0.0f) { const int tmp = kx; kx = ky; ky = tmp; }
-
-        const float Sx = dir[kx] / dir[kz];
-        const float Sy = dir[ky] / dir[kz];
-        const float Sz = 1.0f / dir[kz];
 
         // Vertices translated to ray origin, then sheared into the (kx,ky) plane.
         const Vec3 A = v0 - ray.origin;
         const Vec3 B = v1 - ray.origin;
         const Vec3 C = v2 - ray.origin;
-        const float Ax = A[kx] - Sx * A[kz];
-        const float Ay = A[ky] - Sy * A[kz];
-        const float Bx = B[kx] - Sx * B[kz];
-        const float By = B[ky] - Sy * B[kz];
-        const float Cx = C[kx] - Sx * C[kz];
-        const float Cy = C[ky] - Sy * C[kz];
+        const float Ax = fmadd(-shear.Sx, A[kz], A[kx]);
+        const float Ay = fmadd(-shear.Sy, A[kz], A[ky]);
+        const float Bx = fmadd(-shear.Sx, B[kz], B[kx]);
+        const float By = fmadd(-shear.Sy, B[kz], B[ky]);
+        const float Cx = fmadd(-shear.Sx, C[kz], C[kx]);
+        const float Cy = fmadd(-shear.Sy, C[kz], C[ky]);
 
         // Scaled barycentrics (edge functions). U,V,W are the weights of v0,v1,v2.
-        float U = Cx * By - Cy * Bx;
-        float V = Ax * Cy - Ay * Cx;
-        float W = Bx * Ay - By * Ax;
+        float U = fmadd(Cx, By, -(Cy * Bx));
+        float V = fmadd(Ax, Cy, -(Ay * Cx));
+        float W = fmadd(Bx, Ay, -(By * Ax));
 
         // Fall back to double precision exactly on an edge (any function == 0).
         // This is what makes the test watertight: the shared edge resolves to the
         // same sign for both adjacent triangles instead of a fp coin-flip.
         if (U == 0.0f || V == 0.0f || W == 0.0f)
-        {
-            U = static_cast<float>(static_cast<double>(Cx) * static_cast<double>(By) - static_cast<double>(Cy) * static_cast<double>(Bx));
-            V = static_cast<float>(static_cast<double>(Ax) * static_cast<double>(Cy) - static_cast<double>(Ay) * static_cast<double>(Cx));
-            W = static_cast<float>(static_cast<double>(Bx) * static_cast<double>(Ay) - static_cast<double>(By) * static_cast<double>(Ax));
-        }
-
-        // Two-sided edge test: a hit requires U,V,W to all share a sign (zeros,
-        // i.e. edges/vertices, are allowed). Reject only when the signs disagree.
-        if ((U < 0.0f || V < 0.0f || W < 0.0f) && (U > 0.0f || V > 0.0f || W > 0.0f))
-            return false;
-
-        const float det = U + V + W;
-        if (det == 0.0f)
-            return false; // ray coplanar with the triangle
+            edgeFunctionsDouble(Ax, Ay, Bx, By, Cx, Cy, U, V, W);
 
         // Interpolate the sheared z of each vertex → hit distance. The shear maps
         // the ray direction to +z, so the interpolated z divided by det is t.
-        const float Az = Sz * A[kz];
-        const float Bz = Sz * B[kz];
-        const float Cz = Sz * C[kz];
-        const float T = U * Az + V * Bz + W * Cz;
+        const float det = U + V + W;
+        const float Az = shear.Sz * A[kz];
+        const float Bz = shear.Sz * B[kz];
+        const float Cz = shear.Sz * C[kz];
+        const float T = fmadd(W, Cz, fmadd(V, Bz, U * Az));
 
         const float rcpDet = 1.0f / det;
         const float t = T * rcpDet; // det's sign cancels: t > 0 for forward hits
-        // Written as !(t > EPSILON) (not t <= EPSILON) so a NaN t is rejected —
-        // matches Möller-Trumbore's old final gate. A NaN/Inf hit must never be
-        // reported: it would slip past the caller's closestT cull and leave the
-        // BVH traversal unable to tighten, deepening the stack.
-        if (!(t > EPSILON))
+        if (!acceptTriangleHit(U, V, W, t))
             return false;
 
         tOut = t;
@@ -145,6 +197,145 @@ namespace tracey
         return true;
     }
 
+    inline bool intersectTriangle(const Ray &ray, const Vec3 &v0, const Vec3 &edge1, const Vec3 &edge2, float &tOut, float &uOut, float &vOut)
+    {
+        return intersectTriangle(ray, rayShear(ray.direction), v0, edge1, edge2, tOut, uOut, vOut);
+    }
+
+    // Lane-by-lane reference for intersectTriangleBlock: bit i of the result
+    // is set when lane i hits, with its t/u/v written.
+    inline uint32_t intersectTriangleBlockScalar(const Ray &ray, const RayShear &shear, const TriangleBlock &block,
+                                                 float tOut[kTriangleBlockWidth], float uOut[kTriangleBlockWidth],
+                                                 float vOut[kTriangleBlockWidth])
+    {
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < kTriangleBlockWidth; ++i)
+        {
+            const Vec3 v0(block.v0[0][i], block.v0[1][i], block.v0[2][i]);
+            const Vec3 e1(block.edge1[0][i], block.edge1[1][i], block.edge1[2][i]);
+            const Vec3 e2(block.edge2[0][i], block.edge2[1][i], block.edge2[2][i]);
+            if (intersectTriangle(ray, shear, v0, e1, e2, tOut[i], uOut[i], vOut[i]))
+                mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    // Whether intersectTriangleBlock below has a SIMD kernel in this build.
+    // Without one it is the scalar loop above, which is no faster than the
+    // per-triangle test, so Blas skips building blocks (BVHConfig::triangleBlocks).
+#if defined(__ARM_NEON) || defined(__FMA__)
+    inline constexpr bool kTriangleBlockKernel = true;
+#else
+    inline constexpr bool kTriangleBlockKernel = false;
+#endif
+
+    // The 4-wide watertight test: intersectTriangle's arithmetic, op for op,
+    // on all lanes at once (NEON, or SSE with FMA3), with the double-precision
+    // edge fallback and the accept gate done per lane. Falls back to the
+    // scalar loop where neither is available.
+    inline uint32_t intersectTriangleBlock(const Ray &ray, const RayShear &shear, const TriangleBlock &block,
+                                           float tOut[kTriangleBlockWidth], float uOut[kTriangleBlockWidth],
+                                           float vOut[kTriangleBlockWidth])
+    {
+#if defined(__ARM_NEON) || defined(__FMA__)
+        if (!shear.valid)
+            return 0;
+        const int kx = shear.kx, ky = shear.ky, kz = shear.kz;
+        alignas(16) float Ax[4], Ay[4], Bx[4], By[4], Cx[4], Cy[4];
+        alignas(16) float U[4], V[4], W[4], t[4], u[4], v[4];
+#if defined(__ARM_NEON)
+        const auto sub = [&](const float (&p)[3][4], const float (*e)[4], int k) {
+            const float32x4_t p0 = vld1q_f32(p[k]);
+            return vsubq_f32(e ? vaddq_f32(p0, vld1q_f32(e[k])) : p0, vdupq_n_f32(ray.origin[k]));
+        };
+        // A/B/C per axis: v0, v0 + edge1, v0 + edge2, minus the origin.
+        const float32x4_t AX = sub(block.v0, nullptr, kx), AY = sub(block.v0, nullptr, ky), AZ = sub(block.v0, nullptr, kz);
+        const float32x4_t BX = sub(block.v0, block.edge1, kx), BY = sub(block.v0, block.edge1, ky), BZ = sub(block.v0, block.edge1, kz);
+        const float32x4_t CX = sub(block.v0, block.edge2, kx), CY = sub(block.v0, block.edge2, ky), CZ = sub(block.v0, block.edge2, kz);
+        const float32x4_t sx = vdupq_n_f32(shear.Sx), sy = vdupq_n_f32(shear.Sy), sz = vdupq_n_f32(shear.Sz);
+        // fmadd(-S, P[kz], P[kx]) == P[kx] - S * P[kz], fused.
+        const float32x4_t ax = vfmsq_f32(AX, sx, AZ), ay = vfmsq_f32(AY, sy, AZ);
+        const float32x4_t bx = vfmsq_f32(BX, sx, BZ), by = vfmsq_f32(BY, sy, BZ);
+        const float32x4_t cx = vfmsq_f32(CX, sx, CZ), cy = vfmsq_f32(CY, sy, CZ);
+        // fmadd(a, b, -(c * d)).
+        float32x4_t uu = vfmaq_f32(vnegq_f32(vmulq_f32(cy, bx)), cx, by);
+        float32x4_t vv = vfmaq_f32(vnegq_f32(vmulq_f32(ay, cx)), ax, cy);
+        float32x4_t ww = vfmaq_f32(vnegq_f32(vmulq_f32(by, ax)), bx, ay);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const uint32x4_t onEdge = vorrq_u32(vorrq_u32(vceqq_f32(uu, zero), vceqq_f32(vv, zero)), vceqq_f32(ww, zero));
+        if (vmaxvq_u32(onEdge) != 0)
+        {
+            vst1q_f32(Ax, ax); vst1q_f32(Ay, ay); vst1q_f32(Bx, bx);
+            vst1q_f32(By, by); vst1q_f32(Cx, cx); vst1q_f32(Cy, cy);
+            vst1q_f32(U, uu); vst1q_f32(V, vv); vst1q_f32(W, ww);
+            for (int i = 0; i < 4; ++i)
+                if (U[i] == 0.0f || V[i] == 0.0f || W[i] == 0.0f)
+                    edgeFunctionsDouble(Ax[i], Ay[i], Bx[i], By[i], Cx[i], Cy[i], U[i], V[i], W[i]);
+            uu = vld1q_f32(U); vv = vld1q_f32(V); ww = vld1q_f32(W);
+        }
+        const float32x4_t det = vaddq_f32(vaddq_f32(uu, vv), ww);
+        const float32x4_t T = vfmaq_f32(vfmaq_f32(vmulq_f32(uu, vmulq_f32(sz, AZ)), vv, vmulq_f32(sz, BZ)),
+                                        ww, vmulq_f32(sz, CZ));
+        const float32x4_t rcp = vdivq_f32(vdupq_n_f32(1.0f), det);
+        vst1q_f32(U, uu); vst1q_f32(V, vv); vst1q_f32(W, ww);
+        vst1q_f32(t, vmulq_f32(T, rcp));
+        vst1q_f32(u, vmulq_f32(vv, rcp));
+        vst1q_f32(v, vmulq_f32(ww, rcp));
+#else
+        const auto sub = [&](const float (&p)[3][4], const float (*e)[4], int k) {
+            const __m128 p0 = _mm_load_ps(p[k]);
+            return _mm_sub_ps(e ? _mm_add_ps(p0, _mm_load_ps(e[k])) : p0, _mm_set1_ps(ray.origin[k]));
+        };
+        const __m128 AX = sub(block.v0, nullptr, kx), AY = sub(block.v0, nullptr, ky), AZ = sub(block.v0, nullptr, kz);
+        const __m128 BX = sub(block.v0, block.edge1, kx), BY = sub(block.v0, block.edge1, ky), BZ = sub(block.v0, block.edge1, kz);
+        const __m128 CX = sub(block.v0, block.edge2, kx), CY = sub(block.v0, block.edge2, ky), CZ = sub(block.v0, block.edge2, kz);
+        const __m128 sx = _mm_set1_ps(shear.Sx), sy = _mm_set1_ps(shear.Sy), sz = _mm_set1_ps(shear.Sz);
+        // fmadd(-S, P[kz], P[kx]) == -(S * P[kz]) + P[kx], fused.
+        const __m128 ax = _mm_fnmadd_ps(sx, AZ, AX), ay = _mm_fnmadd_ps(sy, AZ, AY);
+        const __m128 bx = _mm_fnmadd_ps(sx, BZ, BX), by = _mm_fnmadd_ps(sy, BZ, BY);
+        const __m128 cx = _mm_fnmadd_ps(sx, CZ, CX), cy = _mm_fnmadd_ps(sy, CZ, CY);
+        // fmadd(a, b, -(c * d)).
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        __m128 uu = _mm_fmadd_ps(cx, by, _mm_xor_ps(_mm_mul_ps(cy, bx), signBit));
+        __m128 vv = _mm_fmadd_ps(ax, cy, _mm_xor_ps(_mm_mul_ps(ay, cx), signBit));
+        __m128 ww = _mm_fmadd_ps(bx, ay, _mm_xor_ps(_mm_mul_ps(by, ax), signBit));
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 onEdge = _mm_or_ps(_mm_or_ps(_mm_cmpeq_ps(uu, zero), _mm_cmpeq_ps(vv, zero)), _mm_cmpeq_ps(ww, zero));
+        if (_mm_movemask_ps(onEdge) != 0)
+        {
+            _mm_store_ps(Ax, ax); _mm_store_ps(Ay, ay); _mm_store_ps(Bx, bx);
+            _mm_store_ps(By, by); _mm_store_ps(Cx, cx); _mm_store_ps(Cy, cy);
+            _mm_store_ps(U, uu); _mm_store_ps(V, vv); _mm_store_ps(W, ww);
+            for (int i = 0; i < 4; ++i)
+                if (U[i] == 0.0f || V[i] == 0.0f || W[i] == 0.0f)
+                    edgeFunctionsDouble(Ax[i], Ay[i], Bx[i], By[i], Cx[i], Cy[i], U[i], V[i], W[i]);
+            uu = _mm_load_ps(U); vv = _mm_load_ps(V); ww = _mm_load_ps(W);
+        }
+        const __m128 det = _mm_add_ps(_mm_add_ps(uu, vv), ww);
+        const __m128 T = _mm_fmadd_ps(ww, _mm_mul_ps(sz, CZ),
+                                      _mm_fmadd_ps(vv, _mm_mul_ps(sz, BZ), _mm_mul_ps(uu, _mm_mul_ps(sz, AZ))));
+        const __m128 rcp = _mm_div_ps(_mm_set1_ps(1.0f), det);
+        _mm_store_ps(U, uu); _mm_store_ps(V, vv); _mm_store_ps(W, ww);
+        _mm_store_ps(t, _mm_mul_ps(T, rcp));
+        _mm_store_ps(u, _mm_mul_ps(vv, rcp));
+        _mm_store_ps(v, _mm_mul_ps(ww, rcp));
+#endif
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < kTriangleBlockWidth; ++i)
+        {
+            if (!acceptTriangleHit(U[i], V[i], W[i], t[i]))
+                continue;
+            tOut[i] = t[i];
+            uOut[i] = u[i];
+            vOut[i] = v[i];
+            mask |= 1u << i;
+        }
+        return mask;
+#else
+        return intersectTriangleBlockScalar(ray, shear, block, tOut, uOut, vOut);
+#endif
+    }
+
     inline std::tuple<tracey::Vec3, tracey::Vec3> transformAABB(const float M[3][4],
                                                                 const tracey::Vec3 &localMin,
                                                                 const tracey::Vec3 &localMax)
@@ -0,0 +1,701 @@
+#include "noise.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#endif
+
+// Cross-width determinism relies on every lane type doing the same IEEE
+// operations; a compiler fusing a*b+c into an FMA in one path but not the
+// other would break that, so contraction is off for this file.
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace tracey
+{
+    namespace noise
+    {
+        namespace
+        {
+            // ── Lane types ──────────────────────────────────────────────────
+            // F1 is one float; F8 is kLanes floats. Both expose the same
+            // free-function vocabulary (arithmetic, floor, abs, min, max,
+            // sqrt, step) plus a matching 32-bit integer type U for the
+            // Worley hash, so every kernel below is written once as a
+            // template over the lane type.
+
+            struct F1
+            {
+                float v;
+                F1() = default;
+                F1(float s) : v(s) {}
+                static F1 load(const float *p) { return F1(*p); }
+                void store(float *p) const { *p = v; }
+
+                struct U
+                {
+                    uint32_t v;
+                    U() = default;
+                    explicit U(uint32_t s) : v(s) {}
+                };
+            };
+            inline F1 operator+(F1 a, F1 b) { return F1(a.v + b.v); }
+            inline F1 operator-(F1 a, F1 b) { return F1(a.v - b.v); }
+            inline F1 operator*(F1 a, F1 b) { return F1(a.v * b.v); }
+            inline F1 operator/(F1 a, F1 b) { return F1(a.v / b.v); }
+            inline F1 floor(F1 a) { return F1(std::floor(a.v)); }
+            inline F1 abs(F1 a) { return F1(std::fabs(a.v)); }
+            inline F1 min(F1 a, F1 b) { return F1(a.v < b.v ? a.v : b.v); }
+            inline F1 max(F1 a, F1 b) { return F1(a.v > b.v ? a.v : b.v); }
+            inline F1 sqrt(F1 a) { return F1(std::sqrt(a.v)); }
+            // GLSL step(edge, x): 0 where x < edge, else 1.
+            inline F1 step(F1 edge, F1 x) { return F1(x.v >= edge.v ? 1.0f : 0.0f); }
+
+            inline F1::U operator+(F1::U a, F1::U b) { return F1::U(a.v + b.v); }
+            inline F1::U operator*(F1::U a, F1::U b) { return F1::U(a.v * b.v); }
+            inline F1::U operator^(F1::U a, F1::U b) { return F1::U(a.v ^ b.v); }
+            inline F1::U operator&(F1::U a, F1::U b) { return F1::U(a.v & b.v); }
+            inline F1::U shr(F1::U a, int n) { return F1::U(a.v >> n); }
+            // `a` already holds an integer value (the result of floor).
+            inline F1::U toInt(F1 a) { return F1::U(static_cast<uint32_t>(static_cast<int32_t>(a.v))); }
+            inline F1 toFloat(F1::U a) { return F1(static_cast<float>(static_cast<int32_t>(a.v))); }
+
+#if defined(__ARM_NEON)
+            struct F8
+            {
+                float32x4_t lo, hi;
+                F8() = default;
+                F8(float32x4_t a, float32x4_t b) : lo(a), hi(b) {}
+                F8(float s) : lo(vdupq_n_f32(s)), hi(vdupq_n_f32(s)) {}
+                static F8 load(const float *p) { return F8(vld1q_f32(p), vld1q_f32(p + 4)); }
+                void store(float *p) const
+                {
+                    vst1q_f32(p, lo);
+                    vst1q_f32(p + 4, hi);
+                }
+
+                struct U
+                {
+                    uint32x4_t lo, hi;
+                    U() = default;
+                    U(uint32x4_t a, uint32x4_t b) : lo(a), hi(b) {}
+                    explicit U(uint32_t s) : lo(vdupq_n_u32(s)), hi(vdupq_n_u32(s)) {}
+                };
+            };
+            inline F8 operator+(F8 a, F8 b) { return F8(vaddq_f32(a.lo, b.lo), vaddq_f32(a.hi, b.hi)); }
+            inline F8 operator-(F8 a, F8 b) { return F8(vsubq_f32(a.lo, b.lo), vsubq_f32(a.hi, b.hi)); }
+            inline F8 operator*(F8 a, F8 b) { return F8(vmulq_f32(a.lo, b.lo), vmulq_f32(a.hi, b.hi)); }
+            inline F8 operator/(F8 a, F8 b) { return F8(vdivq_f32(a.lo, b.lo), vdivq_f32(a.hi, b.hi)); }
+            inline F8 floor(F8 a) { return F8(vrndmq_f32(a.lo), vrndmq_f32(a.hi)); }
+            inline F8 abs(F8 a) { return F8(vabsq_f32(a.lo), vabsq_f32(a.hi)); }
+            inline F8 min(F8 a, F8 b) { return F8(vminq_f32(a.lo, b.lo), vminq_f32(a.hi, b.hi)); }
+            inline F8 max(F8 a, F8 b) { return F8(vmaxq_f32(a.lo, b.lo), vmaxq_f32(a.hi, b.hi)); }
+            inline F8 sqrt(F8 a) { return F8(vsqrtq_f32(a.lo), vsqrtq_f32(a.hi)); }
+            inline F8 step(F8 edge, F8 x)
+            {
+                const uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
+                return F8(vreinterpretq_f32_u32(vandq_u32(vcgeq_f32(x.lo, edge.lo), one)),
+                          vreinterpretq_f32_u32(vandq_u32(vcgeq_f32(x.hi, edge.hi), one)));
+            }
+
+            inline F8::U operator+(F8::U a, F8::U b) { return F8::U(vaddq_u32(a.lo, b.lo), vaddq_u32(a.hi, b.hi)); }
+            inline F8::U operator*(F8::U a, F8::U b) { return F8::U(vmulq_u32(a.lo, b.lo), vmulq_u32(a.hi, b.hi)); }
+            inline F8::U operator^(F8::U a, F8::U b) { return F8::U(veorq_u32(a.lo, b.lo), veorq_u32(a.hi, b.hi)); }
+            inline F8::U operator&(F8::U a, F8::U b) { return F8::U(vandq_u32(a.lo, b.lo), vandq_u32(a.hi, b.hi)); }
+            inline F8::U shr(F8::U a, int n)
+            {
+                const int32x4_t s = vdupq_n_s32(-n);
+                return F8::U(vshlq_u32(a.lo, s), vshlq_u32(a.hi, s));
+            }
+            inline F8::U toInt(F8 a)
+            {
+                return F8::U(vreinterpretq_u32_s32(vcvtq_s32_f32(a.lo)),
+                             vreinterpretq_u32_s32(vcvtq_s32_f32(a.hi)));
+            }
+            inline F8 toFloat(F8::U a)
+            {
+                return F8(vcvtq_f32_s32(vreinterpretq_s32_u32(a.lo)),
+                          vcvtq_f32_s32(vreinterpretq_s32_u32(a.hi)));
+            }
+#elif defined(__AVX2__)
+            struct F8
+            {
+                __m256 v;
+                F8() = default;
+                explicit F8(__m256 x) : v(x) {}
+                F8(float s) : v(_mm256_set1_ps(s)) {}
+                static F8 load(const float *p) { return F8(_mm256_loadu_ps(p)); }
+                void store(float *p) const { _mm256_storeu_ps(p, v); }
+
+                struct U
+                {
+                    __m256i v;
+                    U() = default;
+                    explicit U(__m256i x) : v(x) {}
+                    explicit U(uint32_t s) : v(_mm256_set1_epi32(static_cast<int>(s))) {}
+                };
+            };
+            inline F8 operator+(F8 a, F8 b) { return F8(_mm256_add_ps(a.v, b.v)); }
+            inline F8 operator-(F8 a, F8 b) { return F8(_mm256_sub_ps(a.v, b.v)); }
+            inline F8 operator*(F8 a, F8 b) { return F8(_mm256_mul_ps(a.v, b.v)); }
+            inline F8 operator/(F8 a, F8 b) { return F8(_mm256_div_ps(a.v, b.v)); }
+            inline F8 floor(F8 a) { return F8(_mm256_floor_ps(a.v)); }
+            inline F8 abs(F8 a) { return F8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)); }
+            inline F8 min(F8 a, F8 b) { return F8(_mm256_min_ps(a.v, b.v)); }
+            inline F8 max(F8 a, F8 b) { return F8(_mm256_max_ps(a.v, b.v)); }
+            inline F8 sqrt(F8 a) { return F8(_mm256_sqrt_ps(a.v)); }
+            inline F8 step(F8 edge, F8 x)
+            {
+                return F8(_mm256_and_ps(_mm256_cmp_ps(x.v, edge.v, _CMP_GE_OQ), _mm256_set1_ps(1.0f)));
+            }
+
+            inline F8::U operator+(F8::U a, F8::U b) { return F8::U(_mm256_add_epi32(a.v, b.v)); }
+            inline F8::U operator*(F8::U a, F8::U b) { return F8::U(_mm256_mullo_epi32(a.v, b.v)); }
+            inline F8::U operator^(F8::U a, F8::U b) { return F8::U(_mm256_xor_si256(a.v, b.v)); }
+            inline F8::U operator&(F8::U a, F8::U b) { return F8::U(_mm256_and_si256(a.v, b.v)); }
+            inline F8::U shr(F8::U a, int n) { return F8::U(_mm256_srl_epi32(a.v, _mm_cvtsi32_si128(n))); }
+            inline F8::U toInt(F8 a) { return F8::U(_mm256_cvttps_epi32(a.v)); }
+            inline F8 toFloat(F8::U a) { return F8(_mm256_cvtepi32_ps(a.v)); }
+#elif defined(__SSE2__)
+            // Baseline x86-64: two __m128 per block. floor and the 32-bit
+            // multiply are SSE4.1; without it they are emulated exactly.
+            inline __m128 floor4(__m128 x)
+            {
+#if defined(__SSE4_1__)
+                return _mm_floor_ps(x);
+#else
+                const __m128 sign = _mm_set1_ps(-0.0f);
+                const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+                __m128 f = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+                f = _mm_or_ps(f, _mm_and_ps(x, sign)); // floor(-0) = -0
+                // |x| >= 2^23 is already integral (and may not fit an int).
+                const __m128 big = _mm_cmpge_ps(_mm_andnot_ps(sign, x), _mm_set1_ps(8388608.0f));
+                return _mm_or_ps(_mm_and_ps(big, x), _mm_andnot_ps(big, f));
+#endif
+            }
+            inline __m128i mullo4(__m128i a, __m128i b)
+            {
+#if defined(__SSE4_1__)
+                return _mm_mullo_epi32(a, b);
+#else
+                const __m128i even = _mm_mul_epu32(a, b);
+                const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+                return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                          _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+            }
+
+            struct F8
+            {
+                __m128 lo, hi;
+                F8() = default;
+                F8(__m128 a, __m128 b) : lo(a), hi(b) {}
+                F8(float s) : lo(_mm_set1_ps(s)), hi(_mm_set1_ps(s)) {}
+                static F8 load(const float *p) { return F8(_mm_loadu_ps(p), _mm_loadu_ps(p + 4)); }
+                void store(float *p) const
+                {
+                    _mm_storeu_ps(p, lo);
+                    _mm_storeu_ps(p + 4, hi);
+                }
+
+                struct U
+                {
+                    __m128i lo, hi;
+                    U() = default;
+                    U(__m128i a, __m128i b) : lo(a), hi(b) {}
+                    explicit U(uint32_t s)
+                        : lo(_mm_set1_epi32(static_cast<int>(s))), hi(_mm_set1_epi32(static_cast<int>(s))) {}
+                };
+            };
+            inline F8 operator+(F8 a, F8 b) { return F8(_mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi)); }
+            inline F8 operator-(F8 a, F8 b) { return F8(_mm_sub_ps(a.lo, b.lo), _mm_sub_ps(a.hi, b.hi)); }
+            inline F8 operator*(F8 a, F8 b) { return F8(_mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi)); }
+            inline F8 operator/(F8 a, F8 b) { return F8(_mm_div_ps(a.lo, b.lo), _mm_div_ps(a.hi, b.hi)); }
+            inline F8 floor(F8 a) { return F8(floor4(a.lo), floor4(a.hi)); }
+            inline F8 abs(F8 a)
+            {
+                const __m128 sign = _mm_set1_ps(-0.0f);
+                return F8(_mm_andnot_ps(sign, a.lo), _mm_andnot_ps(sign, a.hi));
+            }
+            inline F8 min(F8 a, F8 b) { return F8(_mm_min_ps(a.lo, b.lo), _mm_min_ps(a.hi, b.hi)); }
+            inline F8 max(F8 a, F8 b) { return F8(_mm_max_ps(a.lo, b.lo), _mm_max_ps(a.hi, b.hi)); }
+            inline F8 sqrt(F8 a) { return F8(_mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi)); }
+            inline F8 step(F8 edge, F8 x)
+            {
+                const __m128 one = _mm_set1_ps(1.0f);
+                return F8(_mm_and_ps(_mm_cmpge_ps(x.lo, edge.lo), one),
+                          _mm_and_ps(_mm_cmpge_ps(x.hi, edge.hi), one));
+            }
+
+            inline F8::U operator+(F8::U a, F8::U b) { return F8::U(_mm_add_epi32(a.lo, b.lo), _mm_add_epi32(a.hi, b.hi)); }
+            inline F8::U operator*(F8::U a, F8::U b) { return F8::U(mullo4(a.lo, b.lo), mullo4(a.hi, b.hi)); }
+            inline F8::U operator^(F8::U a, F8::U b) { return F8::U(_mm_xor_si128(a.lo, b.lo), _mm_xor_si128(a.hi, b.hi)); }
+            inline F8::U operator&(F8::U a, F8::U b) { return F8::U(_mm_and_si128(a.lo, b.lo), _mm_and_si128(a.hi, b.hi)); }
+            inline F8::U shr(F8::U a, int n)
+            {
+                const __m128i c = _mm_cvtsi32_si128(n);
+                return F8::U(_mm_srl_epi32(a.lo, c), _mm_srl_epi32(a.hi, c));
+            }
+            inline F8::U toInt(F8 a) { return F8::U(_mm_cvttps_epi32(a.lo), _mm_cvttps_epi32(a.hi)); }
+            inline F8 toFloat(F8::U a) { return F8(_mm_cvtepi32_ps(a.lo), _mm_cvtepi32_ps(a.hi)); }
+#else
+            // Portable fallback: kLanes independent floats. The fixed-trip
+            // loops are what the auto-vectoriser wants to see.
+            struct F8
+            {
+                float v[kLanes];
+                F8() = default;
+                F8(float s)
+                {
+                    for (size_t i = 0; i < kLanes; ++i) v[i] = s;
+                }
+                static F8 load(const float *p)
+                {
+                    F8 r;
+                    for (size_t i = 0; i < kLanes; ++i) r.v[i] = p[i];
+                    return r;
+                }
+                void store(float *p) const
+                {
+                    for (size_t i = 0; i < kLanes; ++i) p[i] = v[i];
+                }
+
+                struct U
+                {
+                    uint32_t v[kLanes];
+                    U() = default;
+                    explicit U(uint32_t s)
+                    {
+                        for (size_t i = 0; i < kLanes; ++i) v[i] = s;
+                    }
+                };
+            };
+            template <typename R, typename A, typename Fn>
+            inline R lanewise(const A &a, Fn &&fn)
+            {
+                R r;
+                for (size_t i = 0; i < kLanes; ++i) r.v[i] = fn(a.v[i]);
+                return r;
+            }
+            template <typename R, typename A, typename Fn>
+            inline R lanewise(const A &a, const A &b, Fn &&fn)
+            {
+                R r;
+                for (size_t i = 0; i < kLanes; ++i) r.v[i] = fn(a.v[i], b.v[i]);
+                return r;
+            }
+            inline F8 operator+(F8 a, F8 b) { return lanewise<F8>(a, b, [](float x, float y) { return x + y; }); }
+            inline F8 operator-(F8 a, F8 b) { return lanewise<F8>(a, b, [](float x, float y) { return x - y; }); }
+            inline F8 operator*(F8 a, F8 b) { return lanewise<F8>(a, b, [](float x, float y) { return x * y; }); }
+            inline F8 operator/(F8 a, F8 b) { return lanewise<F8>(a, b, [](float x, float y) { return x / y; }); }
+            inline F8 floor(F8 a) { return lanewise<F8>(a, [](float x) { return std::floor(x); }); }
+            inline F8 abs(F8 a) { return lanewise<F8>(a, [](float x) { return std::fabs(x); }); }
+            inline F8 min(F8 a, F8 b) { return lanewise<F8>(a, b, [](float x, float y) { return x < y ? x : y; }); }
+            inline F8 max(F8 a, F8 b) { return lanewise<F8>(a, b, [](float x, float y) { return x > y ? x : y; }); }
+            inline F8 sqrt(F8 a) { return lanewise<F8>(a, [](float x) { return std::sqrt(x); }); }
+            inline F8 step(F8 edge, F8 x)
+            {
+                return lanewise<F8>(edge, x, [](float e, float v) { return v >= e ? 1.0f : 0.0f; });
+            }
+
+            inline F8::U operator+(F8::U a, F8::U b) { return lanewise<F8::U>(a, b, [](uint32_t x, uint32_t y) { return x + y; }); }
+            inline F8::U operator*(F8::U a, F8::U b) { return lanewise<F8::U>(a, b, [](uint32_t x, uint32_t y) { return x * y; }); }
+            inline F8::U operator^(F8::U a, F8::U b) { return lanewise<F8::U>(a, b, [](uint32_t x, uint32_t y) { return x ^ y; }); }
+            inline F8::U operator&(F8::U a, F8::U b) { return lanewise<F8::U>(a, b, [](uint32_t x, uint32_t y) { return x & y; }); }
+            inline F8::U shr(F8::U a, int n) { return lanewise<F8::U>(a, [n](uint32_t x) { return x >> n; }); }
+            inline F8::U toInt(F8 a)
+            {
+                return lanewise<F8::U>(a, [](float x) { return static_cast<uint32_t>(static_cast<int32_t>(x)); });
+            }
+            inline F8 toFloat(F8::U a)
+            {
+                return lanewise<F8>(a, [](uint32_t x) { return static_cast<float>(static_cast<int32_t>(x)); });
+            }
+#endif
+
+            // ── Shared helpers (glm/GLSL naming) ────────────────────────────
+            template <typename F>
+            inline F fract(F x) { return x - floor(x); }
+            template <typename F>
+            inline F mod289(F x) { return x - floor(x * F(1.0f / 289.0f)) * F(289.0f); }
+            template <typename F>
+            inline F permute(F x) { return mod289((x * F(34.0f) + F(1.0f)) * x); }
+            template <typename F>
+            inline F taylorInvSqrt(F r) { return F(1.79284291400159f) - F(0.85373472095314f) * r; }
+            template <typename F>
+            inline F fade(F t) { return t * t * t * (t * (t * F(6.0f) - F(15.0f)) + F(10.0f)); }
+            // glm::mix for scalars: x + a * (y - x).
+            template <typename F>
+            inline F mix(F x, F y, F a) { return x + a * (y - x); }
+
+            // ── Classic Perlin (Gustavson) ──────────────────────────────────
+            // The GLSL original packs the four (x, y) lattice corners into
+            // vec4s; here each vec4 component is its own lane register.
+            template <typename F>
+            F perlinT(F px, F py, F pz)
+            {
+                const F one(1.0f);
+                F pi0x = floor(px), pi0y = floor(py), pi0z = floor(pz);
+                F pi1x = pi0x + one, pi1y = pi0y + one, pi1z = pi0z + one;
+                pi0x = mod289(pi0x); pi0y = mod289(pi0y); pi0z = mod289(pi0z);
+                pi1x = mod289(pi1x); pi1y = mod289(pi1y); pi1z = mod289(pi1z);
+                const F pf0x = fract(px), pf0y = fract(py), pf0z = fract(pz);
+                const F pf1x = pf0x - one, pf1y = pf0y - one, pf1z = pf0z - one;
+
+                // Corners in GLSL order: (x0,y0) (x1,y0) (x0,y1) (x1,y1).
+                const F hx0 = permute(pi0x);
+                const F hx1 = permute(pi1x);
+                const F ixy[4] = {permute(hx0 + pi0y), permute(hx1 + pi0y),
+                                  permute(hx0 + pi1y), permute(hx1 + pi1y)};
+
+                const F inv7(1.0f / 7.0f);
+                const F half(0.5f);
+                const F zero(0.0f);
+                F n[2][4];
+                for (int zc = 0; zc < 2; ++zc)
+                {
+                    const F iz = zc ? pi1z : pi0z;
+                    const F fz = zc ? pf1z : pf0z;
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        const F h = permute(ixy[k] + iz);
+                        F gx = h * inv7;
+                        F gy = fract(floor(gx) * inv7) - half;
+                        gx = fract(gx);
+                        const F gz0 = half - abs(gx) - abs(gy);
+                        const F sz = step(gz0, zero);
+                        gx = gx - sz * (step(zero, gx) - half);
+                        gy = gy - sz * (step(zero, gy) - half);
+                        const F norm = taylorInvSqrt(gx * gx + gy * gy + gz0 * gz0);
+                        const F fx = (k & 1) ? pf1x : pf0x;
+                        const F fy = (k & 2) ? pf1y : pf0y;
+                        n[zc][k] = (gx * norm) * fx + (gy * norm) * fy + (gz0 * norm) * fz;
+                    }
+                }
+
+                const F ux = fade(pf0x), uy = fade(pf0y), uz = fade(pf0z);
+                F nz[4];
+                for (int k = 0; k < 4; ++k) nz[k] = mix(n[0][k], n[1][k], uz);
+                const F nyz0 = mix(nz[0], nz[2], uy);
+                const F nyz1 = mix(nz[1], nz[3], uy);
+                return F(2.2f) * mix(nyz0, nyz1, ux);
+            }
+
+            // ── Simplex (Ashima / McEwan) ───────────────────────────────────
+            template <typename F>
+            F simplexT(F vx, F vy, F vz)
+            {
+                const F cx(1.0f / 6.0f), cy(1.0f / 3.0f);
+                const F one(1.0f), zero(0.0f), half(0.5f);
+
+                // First corner.
+                const F s = vx * cy + vy * cy + vz * cy;
+                F ix = floor(vx + s), iy = floor(vy + s), iz = floor(vz + s);
+                const F t = ix * cx + iy * cx + iz * cx;
+                const F x0x = vx - ix + t, x0y = vy - iy + t, x0z = vz - iz + t;
+
+                // Other corners: g = step(x0.yzx, x0.xyz), l = 1 - g.
+                const F gx = step(x0y, x0x), gy = step(x0z, x0y), gz = step(x0x, x0z);
+                const F lx = one - gx, ly = one - gy, lz = one - gz;
+                const F i1x = min(gx, lz), i1y = min(gy, lx), i1z = min(gz, ly);
+                const F i2x = max(gx, lz), i2y = max(gy, lx), i2z = max(gz, ly);
+
+                F xs[4][3] = {
+                    {x0x, x0y, x0z},
+                    {x0x - i1x + cx, x0y - i1y + cx, x0z - i1z + cx},
+                    {x0x - i2x + cy, x0y - i2y + cy, x0z - i2z + cy},
+                    {x0x - half, x0y - half, x0z - half},
+                };
+                const F ox[4] = {zero, i1x, i2x, one};
+                const F oy[4] = {zero, i1y, i2y, one};
+                const F oz[4] = {zero, i1z, i2z, one};
+
+                // Permutations.
+                ix = mod289(ix); iy = mod289(iy); iz = mod289(iz);
+
+                // Gradients: 7x7 points over a square, mapped onto an
+                // octahedron (ns = n_ * D.wyz - D.xzx with n_ = 1/7).
+                const F n_(0.142857142857f);
+                const F nsx = n_ * F(2.0f) - zero;
+                const F nsy = n_ * half - one;
+                const F nsz = n_ * one - zero;
+
+                F sum(0.0f);
+                for (int k = 0; k < 4; ++k)
+                {
+                    const F p = permute(permute(permute(iz + oz[k]) + iy + oy[k]) + ix + ox[k]);
+                    const F j = p - F(49.0f) * floor(p * nsz * nsz);
+                    const F x_ = floor(j * nsz);
+                    const F y_ = floor(j - F(7.0f) * x_);
+                    const F x = x_ * nsx + nsy;
+                    const F y = y_ * nsx + nsy;
+                    const F h = one - abs(x) - abs(y);
+                    const F sh = zero - step(h, zero);
+                    F g0 = x + (floor(x) * F(2.0f) + one) * sh;
+                    F g1 = y + (floor(y) * F(2.0f) + one) * sh;
+                    F g2 = h;
+                    const F norm = taylorInvSqrt(g0 * g0 + g1 * g1 + g2 * g2);
+                    g0 = g0 * norm; g1 = g1 * norm; g2 = g2 * norm;
+
+                    const F *xk = xs[k];
+                    F m = max(F(0.6f) - (xk[0] * xk[0] + xk[1] * xk[1] + xk[2] * xk[2]), zero);
+                    m = m * m;
+                    sum = sum + m * m * (g0 * xk[0] + g1 * xk[1] + g2 * xk[2]);
+                }
+                return F(42.0f) * sum;
+            }
+
+            // ── Worley F1 ───────────────────────────────────────────────────
+            // Feature point of cell c: c + three 24-bit fractions of a
+            // murmur-finalised hash of (c, seed), (c, seed+1013),
+            // (c, seed+1031). 27-cell search around the sample's cell.
+            template <typename U>
+            U hash3i(U x, U y, U z, U seedTerm)
+            {
+                U h = (x * U(2654435761u)) ^ (y * U(2246822519u)) ^ (z * U(374761393u)) ^ seedTerm;
+                h = h ^ shr(h, 13); h = h * U(0x85ebca6bu);
+                h = h ^ shr(h, 16); h = h * U(0xc2b2ae35u);
+                h = h ^ shr(h, 13);
+                return h;
+            }
+
+            template <typename F>
+            F worleyT(F px, F py, F pz, int seed)
+            {
+                using U = typename F::U;
+                const U mask(0x00ffffffu);
+                const F toUnit(1.0f / 16777216.0f);
+                const U sx(static_cast<uint32_t>(seed) * 3266489917u);
+                const U sy(static_cast<uint32_t>(seed + 1013) * 3266489917u);
+                const U sz(static_cast<uint32_t>(seed + 1031) * 3266489917u);
+
+                const U ix = toInt(floor(px)), iy = toInt(floor(py)), iz = toInt(floor(pz));
+                F best(1e30f);
+                for (int dz = -1; dz <= 1; ++dz)
+                    for (int dy = -1; dy <= 1; ++dy)
+                        for (int dx = -1; dx <= 1; ++dx)
+                        {
+                            const U cx = ix + U(static_cast<uint32_t>(dx));
+                            const U cy = iy + U(static_cast<uint32_t>(dy));
+                            const U cz = iz + U(static_cast<uint32_t>(dz));
+                            const F jx = toFloat(hash3i(cx, cy, cz, sx) & mask) * toUnit;
+                            const F jy = toFloat(hash3i(cx, cy, cz, sy) & mask) * toUnit;
+                            const F jz = toFloat(hash3i(cx, cy, cz, sz) & mask) * toUnit;
+                            const F ex = toFloat(cx) + jx - px;
+                            const F ey = toFloat(cy) + jy - py;
+                            const F ez = toFloat(cz) + jz - pz;
+                            best = min(best, ex * ex + ey * ey + ez * ez);
+                        }
+                return sqrt(best);
+            }
+
+            // ── Fractal sums ────────────────────────────────────────────────
+            enum class FractalKind { Fbm, Turbulence, Ridged };
+
+            int clampOctaves(const Fractal &f) { return std::clamp(f.octaves, 1, Fractal::kMaxOctaves); }
+
+            template <FractalKind K, typename F>
+            F fractalT(F x, F y, F z, const Fractal &f)
+            {
+                const int octaves = clampOctaves(f);
+                const F lac(f.lacunarity);
+                float amp = 1.0f;
+                F sum(0.0f);
+                for (int o = 0; o < octaves; ++o)
+                {
+                    F n = perlinT(x, y, z);
+                    if constexpr (K == FractalKind::Turbulence) n = abs(n);
+                    if constexpr (K == FractalKind::Ridged)
+                    {
+                        n = F(1.0f) - abs(n);
+                        n = n * n; // sharpen — classic Musgrave variant
+                    }
+                    sum = sum + n * F(amp);
+                    x = x * lac; y = y * lac; z = z * lac;
+                    amp *= f.gain;
+                }
+                return sum;
+            }
+
+            // ── Vector noise ────────────────────────────────────────────────
+            template <typename F>
+            F shiftedPerlin(F x, F y, F z, int seed)
+            {
+                const float so = static_cast<float>(seed);
+                return perlinT(x + F(so * 17.13f), y + F(so * 31.71f), z + F(so * 53.91f));
+            }
+
+            template <typename F>
+            void perlin3T(F x, F y, F z, int seed, F &ox, F &oy, F &oz)
+            {
+                ox = shiftedPerlin(x, y, z, seed);
+                oy = shiftedPerlin(x, y, z, seed + kChannelSeedY);
+                oz = shiftedPerlin(x, y, z, seed + kChannelSeedZ);
+            }
+
+            // curl = (∂Pz/∂y − ∂Py/∂z, ∂Px/∂z − ∂Pz/∂x, ∂Py/∂x − ∂Px/∂y)
+            // over the three perlin3 potentials.
+            template <typename F>
+            void curlT(F x, F y, F z, int seed, float eps, F &ox, F &oy, F &oz)
+            {
+                const int sX = seed, sY = seed + kChannelSeedY, sZ = seed + kChannelSeedZ;
+                const F e(eps);
+                const F inv2e(2.0f * eps);
+                auto ddx = [&](int s) { return (shiftedPerlin(x + e, y, z, s) - shiftedPerlin(x - e, y, z, s)) / inv2e; };
+                auto ddy = [&](int s) { return (shiftedPerlin(x, y + e, z, s) - shiftedPerlin(x, y - e, z, s)) / inv2e; };
+                auto ddz = [&](int s) { return (shiftedPerlin(x, y, z + e, s) - shiftedPerlin(x, y, z - e, s)) / inv2e; };
+                ox = ddy(sZ) - ddz(sY);
+                oy = ddz(sX) - ddx(sZ);
+                oz = ddx(sY) - ddy(sX);
+            }
+
+            // ── Batch driver ────────────────────────────────────────────────
+            // Calls eval(F8{}, i) for every full block — two per iteration —
+            // then eval(F1{}, i) for each leftover point. `eval` is a generic
+            // lambda; the tag argument selects the lane type.
+            template <typename Eval>
+            void forEachBlock(size_t count, Eval &&eval)
+            {
+                size_t i = 0;
+                for (; i + 2 * kLanes <= count; i += 2 * kLanes)
+                {
+                    eval(F8{}, i);
+                    eval(F8{}, i + kLanes);
+                }
+                for (; i + kLanes <= count; i += kLanes) eval(F8{}, i);
+                for (; i < count; ++i) eval(F1{}, i);
+            }
+
+            template <typename Kernel>
+            void runScalar(const float *x, const float *y, const float *z, float *out, size_t count, Kernel &&kernel)
+            {
+                forEachBlock(count, [&](auto tag, size_t i) {
+                    using F = decltype(tag);
+                    kernel(F::load(x + i), F::load(y + i), F::load(z + i)).store(out + i);
+                });
+            }
+        }
+
+        void perlin(const float *x, const float *y, const float *z, float *out, size_t count)
+        {
+            runScalar(x, y, z, out, count, [](auto a, auto b, auto c) { return perlinT(a, b, c); });
+        }
+
+        void simplex(const float *x, const float *y, const float *z, float *out, size_t count)
+        {
+            runScalar(x, y, z, out, count, [](auto a, auto b, auto c) { return simplexT(a, b, c); });
+        }
+
+        void worley(const float *x, const float *y, const float *z, int seed, float *out, size_t count)
+        {
+            runScalar(x, y, z, out, count, [seed](auto a, auto b, auto c) { return worleyT(a, b, c, seed); });
+        }
+
+        void fbm(const float *x, const float *y, const float *z, const Fractal &f, float *out, size_t count)
+        {
+            runScalar(x, y, z, out, count,
+                      [&f](auto a, auto b, auto c) { return fractalT<FractalKind::Fbm>(a, b, c, f); });
+        }
+
+        void turbulence(const float *x, const float *y, const float *z, const Fractal &f, float *out, size_t count)
+        {
+            runScalar(x, y, z, out, count,
+                      [&f](auto a, auto b, auto c) { return fractalT<FractalKind::Turbulence>(a, b, c, f); });
+        }
+
+        void ridged(const float *x, const float *y, const float *z, const Fractal &f, float *out, size_t count)
+        {
+            runScalar(x, y, z, out, count,
+                      [&f](auto a, auto b, auto c) { return fractalT<FractalKind::Ridged>(a, b, c, f); });
+        }
+
+        void perlin3(const float *x, const float *y, const float *z, int seed,
+                     float *outX, float *outY, float *outZ, size_t count)
+        {
+            forEachBlock(count, [&](auto tag, size_t i) {
+                using F = decltype(tag);
+                F ox, oy, oz;
+                perlin3T(F::load(x + i), F::load(y + i), F::load(z + i), seed, ox, oy, oz);
+                ox.store(outX + i);
+                oy.store(outY + i);
+                oz.store(outZ + i);
+            });
+        }
+
+        void curl(const float *x, const float *y, const float *z, int seed, float eps,
+                  float *outX, float *outY, float *outZ, size_t count)
+        {
+            forEachBlock(count, [&](auto tag, size_t i) {
+                using F = decltype(tag);
+                F ox, oy, oz;
+                curlT(F::load(x + i), F::load(y + i), F::load(z + i), seed, eps, ox, oy, oz);
+                ox.store(outX + i);
+                oy.store(outY + i);
+                oz.store(outZ + i);
+            });
+        }
+
+        void perlin3Field(const Vec3 *points, size_t count, float frequency, const Vec3 &offset,
+                          int seed, Vec3 *out)
+        {
+            constexpr size_t kBlock = 32 * kLanes;
+            float x[kBlock], y[kBlock], z[kBlock];
+            float nx[kBlock], ny[kBlock], nz[kBlock];
+            for (size_t b = 0; b < count; b += kBlock)
+            {
+                const size_t m = std::min(kBlock, count - b);
+                for (size_t k = 0; k < m; ++k)
+                {
+                    x[k] = points[b + k].x * frequency + offset.x;
+                    y[k] = points[b + k].y * frequency + offset.y;
+                    z[k] = points[b + k].z * frequency + offset.z;
+                }
+                perlin3(x, y, z, seed, nx, ny, nz, m);
+                for (size_t k = 0; k < m; ++k) out[b + k] = Vec3(nx[k], ny[k], nz[k]);
+            }
+        }
+
+        float perlin(const Vec3 &p) { return perlinT(F1(p.x), F1(p.y), F1(p.z)).v; }
+        float simplex(const Vec3 &p) { return simplexT(F1(p.x), F1(p.y), F1(p.z)).v; }
+        float worley(const Vec3 &p, int seed) { return worleyT(F1(p.x), F1(p.y), F1(p.z), seed).v; }
+        float fbm(const Vec3 &p, const Fractal &f)
+        {
+            return fractalT<FractalKind::Fbm>(F1(p.x), F1(p.y), F1(p.z), f).v;
+        }
+        float turbulence(const Vec3 &p, const Fractal &f)
+        {
+            return fractalT<FractalKind::Turbulence>(F1(p.x), F1(p.y), F1(p.z), f).v;
+        }
+        float ridged(const Vec3 &p, const Fractal &f)
+        {
+            return fractalT<FractalKind::Ridged>(F1(p.x), F1(p.y), F1(p.z), f).v;
+        }
+
+        Vec3 perlin3(const Vec3 &p, int seed)
+        {
+            F1 ox, oy, oz;
+            perlin3T(F1(p.x), F1(p.y), F1(p.z), seed, ox, oy, oz);
+            return Vec3(ox.v, oy.v, oz.v);
+        }
+
+        Vec3 curl(const Vec3 &p, int seed, float eps)
+        {
+            F1 ox, oy, oz;
+            curlT(F1(p.x), F1(p.y), F1(p.z), seed, eps, ox, oy, oz);
+            return Vec3(ox.v, oy.v, oz.v);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <cstddef>
+
+namespace tracey
+{
+    // Batched 3D noise shared by the CPU consumers of procedural noise: the
+    // noise VOPs, the MoGraph noise effector and pop_wind turbulence.
+    //
+    // Every batch entry point takes structure-of-arrays input (x[], y[], z[])
+    // and writes structure-of-arrays output, for any `count`. Points are
+    // evaluated in blocks of kLanes (8) — two blocks per loop iteration, so 16
+    // points are in flight — on AVX2 (one __m256 per block), NEON or SSE2
+    // (two 4-wide registers), with a plain-float fallback elsewhere. A tail
+    // shorter than a block runs through the same kernel one lane at a time.
+    //
+    // Deterministic across widths: the single-lane path and every block path
+    // perform the same IEEE operations in the same order (mul and add only —
+    // no FMA contraction, which noise.cpp switches off), so a point returns
+    // bit-identical values whether it is evaluated alone, in a tail or inside
+    // a full block.
+    //
+    // The formulas are the ones glm and the GLSL preamble in
+    // vops/codegen/glsl_emit.cpp use (Gustavson's classic Perlin, Ashima's
+    // simplex, hash-jittered Worley F1), so CPU and GPU cooks of the same
+    // graph read the same field.
+    namespace noise
+    {
+        constexpr size_t kLanes = 8;
+
+        // Octave controls for the fractal sums. Octaves are clamped to
+        // [1, kMaxOctaves] so a stray large value cannot stall a cook.
+        struct Fractal
+        {
+            static constexpr int kMaxOctaves = 10;
+            int octaves = 5;
+            float lacunarity = 2.0f;
+            float gain = 0.5f;
+        };
+
+        // Shift a sample point into a per-seed slice of the noise domain.
+        // Adjacent integer seeds give unrelated fields; the strides match
+        // the GLSL emitter's seed offset.
+        inline Vec3 seedShift(const Vec3 &p, int seed)
+        {
+            const float so = static_cast<float>(seed);
+            return Vec3(p.x + so * 17.13f, p.y + so * 31.71f, p.z + so * 53.91f);
+        }
+
+        // Seed offsets of the three channels of vector noise (perlin3, curl).
+        constexpr int kChannelSeedY = 41;
+        constexpr int kChannelSeedZ = 83;
+
+        // ── Batch (SoA) entry points ────────────────────────────────────────
+        // Classic Perlin, roughly [-1, 1].
+        void perlin(const float *x, const float *y, const float *z, float *out, size_t count);
+        // Simplex, roughly [-1, 1].
+        void simplex(const float *x, const float *y, const float *z, float *out, size_t count);
+        // Worley F1: distance to the nearest jittered feature point, [0, ~1].
+        void worley(const float *x, const float *y, const float *z, int seed, float *out, size_t count);
+
+        // Fractal sums of Perlin octaves. The input is the first octave's
+        // sample position (already scaled and seed-shifted).
+        //   fbm        — Σ perlin(p) · gainⁱ
+        //   turbulence — Σ |perlin(p)| · gainⁱ
+        //   ridged     — Σ (1 − |perlin(p)|)² · gainⁱ
+        void fbm(const float *x, const float *y, const float *z, const Fractal &f, float *out, size_t count);
+        void turbulence(const float *x, const float *y, const float *z, const Fractal &f, float *out, size_t count);
+        void ridged(const float *x, const float *y, const float *z, const Fractal &f, float *out, size_t count);
+
+        // Three decorrelated Perlin channels: perlin(seedShift(p, seed)),
+        // seed + kChannelSeedY and seed + kChannelSeedZ.
+        void perlin3(const float *x, const float *y, const float *z, int seed,
+                     float *outX, float *outY, float *outZ, size_t count);
+        // Divergence-free curl of the perlin3 potential, by central
+        // differences with step `eps`.
+        void curl(const float *x, const float *y, const float *z, int seed, float eps,
+                  float *outX, float *outY, float *outZ, size_t count);
+
+        // perlin3 over an array of points sampled at p * frequency + offset,
+        // for callers holding AoS positions (effectors, POPs). Transposes
+        // through a small stack buffer; run it per chunk to parallelise.
+        void perlin3Field(const Vec3 *points, size_t count, float frequency, const Vec3 &offset,
+                          int seed, Vec3 *out);
+
+        // ── Single point ────────────────────────────────────────────────────
+        // Same kernels at one lane; bit-identical to the batch results.
+        float perlin(const Vec3 &p);
+        float simplex(const Vec3 &p);
+        float worley(const Vec3 &p, int seed);
+        float fbm(const Vec3 &p, const Fractal &f);
+        float turbulence(const Vec3 &p, const Fractal &f);
+        float ridged(const Vec3 &p, const Fractal &f);
+        Vec3 perlin3(const Vec3 &p, int seed);
+        Vec3 curl(const Vec3 &p, int seed, float eps);
+    }
+}
@@ -0,0 +1,350 @@
+#include "parallel.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+
+namespace tracey
+{
+    namespace
+    {
+        // Which pool (and which of its workers) the calling thread is, so
+        // submit() can push to the worker's own deque and waits know where
+        // their subtree lives. Null for threads outside every pool.
+        struct WorkerIdentity
+        {
+            ThreadPool *pool = nullptr;
+            size_t index = 0;
+        };
+        thread_local WorkerIdentity t_worker;
+
+        // Per-thread xorshift for picking a steal victim, so thieves spread
+        // over the pool instead of all hammering worker 0.
+        size_t nextVictim(size_t n)
+        {
+            thread_local uint32_t state =
+                static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1u;
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state % n;
+        }
+
+        size_t defaultWorkerCount()
+        {
+            // Reserve a core for the calling thread; the pool + caller then span
+            // ~hardware_concurrency() lanes without oversubscribing.
+            size_t lanes = std::max<size_t>(1, std::thread::hardware_concurrency());
+            if (const char *env = std::getenv("TRACEY_THREADS"))
+            {
+                const long v = std::strtol(env, nullptr, 10);
+                if (v > 0) lanes = static_cast<size_t>(v);
+            }
+            return lanes - 1; // caller is one lane
+        }
+    }
+
+    // --- WorkStealingDeque ---------------------------------------------------
+
+    WorkStealingDeque::WorkStealingDeque(size_t capacityLog2)
+        : m_slots(std::make_unique<Slot[]>(size_t(1) << capacityLog2)),
+          m_mask(static_cast<int64_t>((size_t(1) << capacityLog2) - 1))
+    {
+    }
+
+    bool WorkStealingDeque::push(const Task &task)
+    {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const int64_t t = m_top.load(std::memory_order_acquire);
+        if (b - t > m_mask) return false; // full
+        Slot &slot = m_slots[b & m_mask];
+        slot.fn.store(task.fn, std::memory_order_relaxed);
+        slot.ctx.store(task.ctx, std::memory_order_relaxed);
+        // Release publishes the slot (and whatever the task's context points
+        // at) to a thief's acquire-load of m_bottom.
+        m_bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool WorkStealingDeque::pop(Task &task)
+    {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            // Empty.
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        const Slot &slot = m_slots[b & m_mask];
+        task.fn = slot.fn.load(std::memory_order_relaxed);
+        task.ctx = slot.ctx.load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // Last element: race the thieves for it.
+            const bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                           std::memory_order_relaxed);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    bool WorkStealingDeque::popAbove(int64_t mark, Task &task)
+    {
+        if (m_bottom.load(std::memory_order_relaxed) <= mark) return false;
+        return pop(task);
+    }
+
+    bool WorkStealingDeque::steal(Task &task)
+    {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b) return false;
+        const Slot &slot = m_slots[t & m_mask];
+        Task read;
+        read.fn = slot.fn.load(std::memory_order_relaxed);
+        read.ctx = slot.ctx.load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false; // lost to the owner or another thief
+        task = read;
+        return true;
+    }
+
+    // --- ThreadPool ------------------------------------------------------------
+
+    ThreadPool &ThreadPool::global()
+    {
+        static ThreadPool instance(defaultWorkerCount());
+        return instance;
+    }
+
+    ThreadPool *ThreadPool::current()
+    {
+        return t_worker.pool;
+    }
+
+    ThreadPool::ThreadPool(size_t workers)
+    {
+        m_workers.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+            m_workers.push_back(std::make_unique<Worker>());
+        // Deques exist before any thread starts, so a thief never sees a
+        // half-built m_workers.
+        m_threads.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+            m_threads.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stop.store(true, std::memory_order_release);
+        }
+        m_workerCv.notify_all();
+        m_waiterCv.notify_all();
+        for (auto &t : m_threads) t.join();
+    }
+
+    void ThreadPool::submit(const Task &task, size_t copies)
+    {
+        if (copies == 0) return;
+        if (t_worker.pool == this)
+        {
+            WorkStealingDeque &own = m_workers[t_worker.index]->deque;
+            for (size_t i = 0; i < copies; ++i)
+                if (!own.push(task)) task.fn(task.ctx);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_injectMutex);
+            for (size_t i = 0; i < copies; ++i) m_injection.push_back(task);
+            m_injected.fetch_add(copies, std::memory_order_relaxed);
+        }
+        wakeWorkers(copies);
+        // A waiter that is not isolated can run the new tasks too.
+        if (m_sleepingWaiters.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_waiterCv.notify_all();
+        }
+    }
+
+    size_t ThreadPool::retract(const void *ctx)
+    {
+        if (m_injected.load(std::memory_order_relaxed) == 0) return 0;
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        const size_t before = m_injection.size();
+        m_injection.erase(std::remove_if(m_injection.begin(), m_injection.end(),
+                                         [ctx](const Task &t) { return t.ctx == ctx; }),
+                          m_injection.end());
+        const size_t removed = before - m_injection.size();
+        m_injected.fetch_sub(removed, std::memory_order_relaxed);
+        return removed;
+    }
+
+    void ThreadPool::wakeWorkers(size_t count)
+    {
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (m_sleepingWorkers.load(std::memory_order_seq_cst) == 0) return;
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        if (count == 1)
+            m_workerCv.notify_one();
+        else
+            m_workerCv.notify_all();
+    }
+
+    void ThreadPool::notifyDone()
+    {
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (m_sleepingWaiters.load(std::memory_order_seq_cst) == 0) return;
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_waiterCv.notify_all();
+    }
+
+    bool ThreadPool::popInjected(Task &task)
+    {
+        if (m_injected.load(std::memory_order_relaxed) == 0) return false;
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        if (m_injection.empty()) return false;
+        task = m_injection.front();
+        m_injection.pop_front();
+        m_injected.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool ThreadPool::steal(size_t self, Task &task)
+    {
+        const size_t n = m_workers.size();
+        if (n == 0) return false;
+        const size_t start = nextVictim(n);
+        for (size_t k = 0; k < n; ++k)
+        {
+            const size_t v = (start + k) % n;
+            if (v == self) continue;
+            WorkStealingDeque &victim = m_workers[v]->deque;
+            // A failed steal only means someone else got that task; keep
+            // trying while the victim still has any.
+            while (!victim.empty())
+                if (victim.steal(task)) return true;
+        }
+        return false;
+    }
+
+    bool ThreadPool::findWork(size_t self, Task &task)
+    {
+        if (self < m_workers.size() && m_workers[self]->deque.pop(task)) return true;
+        if (popInjected(task)) return true;
+        return steal(self, task);
+    }
+
+    bool ThreadPool::runOne()
+    {
+        const size_t self = t_worker.pool == this ? t_worker.index : SIZE_MAX;
+        Task task;
+        if (!findWork(self, task)) return false;
+        task.fn(task.ctx);
+        return true;
+    }
+
+    ThreadPool::WaitScope ThreadPool::beginWait() const
+    {
+        WaitScope scope;
+        if (t_worker.pool == this)
+        {
+            scope.worker = true;
+            scope.mark = m_workers[t_worker.index]->deque.mark();
+        }
+        return scope;
+    }
+
+    void ThreadPool::wait(const std::atomic<int> &pending, const WaitScope &scope, bool isolated)
+    {
+        const size_t self = scope.worker ? t_worker.index : SIZE_MAX;
+        int idle = 0;
+        while (pending.load(std::memory_order_acquire) > 0)
+        {
+            Task task;
+            const bool found = isolated
+                                   ? scope.worker && m_workers[self]->deque.popAbove(scope.mark, task)
+                                   : findWork(self, task);
+            if (found)
+            {
+                task.fn(task.ctx);
+                idle = 0;
+                continue;
+            }
+            // Nothing we may run: the remaining tasks are executing on other
+            // lanes. Spin briefly (they usually finish within a chunk-time),
+            // then sleep until a task completes or new work appears.
+            if (++idle < kPoolSpinIters)
+            {
+                cpuRelax();
+                continue;
+            }
+            m_sleepingWaiters.fetch_add(1, std::memory_order_seq_cst);
+            const uint64_t seen = m_epoch.load(std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(m_sleepMutex);
+                m_waiterCv.wait(lock, [&] {
+                    return pending.load(std::memory_order_acquire) <= 0 ||
+                           m_epoch.load(std::memory_order_relaxed) != seen ||
+                           m_stop.load(std::memory_order_relaxed);
+                });
+            }
+            m_sleepingWaiters.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    void ThreadPool::workerLoop(size_t index)
+    {
+        t_worker = {this, index};
+        Task task;
+        for (;;)
+        {
+            // Spin briefly for new work before sleeping: catches a back-to-back
+            // dispatch without a futex wake. Bounded, so an idle pool spins once
+            // then sleeps on the condvar.
+            bool found = false;
+            for (int i = 0; i < kPoolSpinIters && !found; ++i)
+            {
+                if (m_stop.load(std::memory_order_acquire)) return;
+                found = findWork(index, task);
+                if (!found) cpuRelax();
+            }
+            if (!found)
+            {
+                // Announce the sleep, then look once more: a submit either
+                // sees us counted (and notifies) or happened before the
+                // epoch read below (and its task is visible to findWork).
+                m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+                const uint64_t seen = m_epoch.load(std::memory_order_seq_cst);
+                found = findWork(index, task);
+                if (!found)
+                {
+                    std::unique_lock<std::mutex> lock(m_sleepMutex);
+                    m_workerCv.wait(lock, [&] {
+                        return m_stop.load(std::memory_order_relaxed) ||
+                               m_epoch.load(std::memory_order_relaxed) != seen;
+                    });
+                }
+                m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+                if (m_stop.load(std::memory_order_acquire)) return;
+                if (!found) continue;
+            }
+
+            // More queued than this worker will get to soon: pass the wake on
+            // so a burst of submits fans out over the sleeping workers.
+            if (m_sleepingWorkers.load(std::memory_order_relaxed) > 0 &&
+                (!m_workers[index]->deque.empty() || m_injected.load(std::memory_order_relaxed) > 0))
+                wakeWorkers(1);
+
+            task.fn(task.ctx);
+        }
+    }
+}
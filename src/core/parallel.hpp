@@ -23,12 +23,25 @@
 // pixels): the heavy lane straggled while the rest idled (~7.5× on 32 cores).
 // Pulling small chunks from the cursor self-balances (~14× on 32 cores) and lets
 // slower cores (e.g. Apple E-cores) simply claim fewer chunks.
+//
+// Under the parallel-for sits a work-stealing task scheduler: every worker owns
+// a lock-free deque (Chase–Lev), pushes and pops its own end LIFO, and steals
+// FIFO from the other end of its peers' when it runs dry; threads outside the
+// pool submit through a small locked injection queue. A parallelFor pushes one
+// "helper" task per idle lane and claims chunks itself, so any number of
+// dispatches — concurrent from different threads, or nested inside another
+// loop's body — share the workers instead of queueing behind a dispatch mutex
+// (the old pool ran one job at a time and collapsed nested loops to serial).
+// TaskGroup / TaskGraph in task_graph.hpp expose the same scheduler for
+// irregular work: spawn, dependencies, and a wait() that runs tasks instead of
+// blocking.
 
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -57,122 +70,218 @@ namespace tracey
     // back-to-back dispatch without paying a futex wake.
     static constexpr int kPoolSpinIters = 8192;
 
-    // Process-wide fork-join worker pool. Header-only Meyers singleton so there
-    // is exactly one instance across all translation units.
-    class ThreadPool
+    // One schedulable unit: a plain function pointer + context, so pushing a
+    // task never allocates. Whoever submits it keeps `ctx` alive until it has
+    // run (parallelFor and TaskGroup both wait for their tasks).
+    struct Task
+    {
+        void (*fn)(void *) = nullptr;
+        void *ctx = nullptr;
+    };
+
+    // Fixed-capacity Chase–Lev work-stealing deque (Lê, Pop, Cohen & Zappa
+    // Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models",
+    // PPoPP 2013). The owning worker push()es and pop()s at the bottom; any
+    // thread may steal() from the top. push() fails when full — the caller
+    // then runs the task inline, which is always a valid schedule — so the
+    // buffer never has to grow under concurrent thieves.
+    class WorkStealingDeque
     {
     public:
-        static ThreadPool &global()
+        explicit WorkStealingDeque(size_t capacityLog2 = 12);
+
+        bool push(const Task &task);  // owner only
+        bool pop(Task &task);         // owner only, newest first
+        bool steal(Task &task);       // any thread, oldest first
+
+        // Owner only: position of the bottom. Tasks pushed after a mark()
+        // sit at or above it; popAbove() takes only those, which is how a
+        // waiting thread confines itself to work it spawned (see
+        // ThreadPool::wait).
+        int64_t mark() const { return m_bottom.load(std::memory_order_relaxed); }
+        bool popAbove(int64_t mark, Task &task);
+
+        bool empty() const
         {
-            static ThreadPool instance;
-            return instance;
+            return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
         }
 
+    private:
+        // Task split over two atomics: a thief reads the slot before its CAS
+        // on m_top and discards what it read if the CAS fails, so a torn
+        // pair is never *used*, but the reads must still not be data races.
+        struct Slot
+        {
+            std::atomic<void (*)(void *)> fn{nullptr};
+            std::atomic<void *> ctx{nullptr};
+        };
+
+        alignas(64) std::atomic<int64_t> m_top{0};
+        alignas(64) std::atomic<int64_t> m_bottom{0};
+        std::unique_ptr<Slot[]> m_slots;
+        int64_t m_mask = 0;
+    };
+
+    // Process-wide worker pool. global() is a Meyers singleton so there is
+    // exactly one instance across all translation units; separate pools can
+    // be constructed with an explicit size (the scaling benchmarks do).
+    class ThreadPool
+    {
+    public:
+        static ThreadPool &global();
+
+        // `workers` threads besides the caller. The global pool uses
+        // hardware_concurrency()-1, or $TRACEY_THREADS-1 when that is set.
+        explicit ThreadPool(size_t workers);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
         // Number of worker threads (the calling thread participates too, so the
         // effective width is workerCount()+1 ≈ hardware_concurrency()).
-        size_t workerCount() const { return m_workers.size(); }
+        size_t workerCount() const { return m_threads.size(); }
 
         // Run body(begin,end) over small dynamic chunks of [0,n), blocking until
         // all are done. Every lane (workers + the calling thread) pulls chunks
         // from a shared atomic cursor, so work self-balances and a 0-worker
-        // machine still makes progress on the caller.
+        // machine still makes progress on the caller. `grainOverride` replaces the
+        // automatic chunk size (0 = chunkGrain()); pass 1 when each index is
+        // already a coarse unit of work.
+        //
+        // Safe to call from inside another parallelFor body or a task: the inner
+        // loop's helpers go onto this thread's deque where idle workers steal
+        // them, and the wait only runs this loop's own leftovers, so an outer
+        // body is never re-entered on the same stack.
         template <typename Body>
-        void parallelFor(size_t n, Body &&body)
+        void parallelFor(size_t n, Body &&body, size_t grainOverride = 0)
         {
             if (n == 0) return;
 
-            const size_t lanes = m_workers.size() + 1; // workers + caller
-            const size_t grain = chunkGrain(n, lanes);
+            const size_t lanes = m_threads.size() + 1; // workers + caller
+            const size_t grain = grainOverride ? grainOverride : chunkGrain(n, lanes);
+            const size_t chunks = (n + grain - 1) / grain;
 
-            // Nested dispatch (a body that itself calls parallelFor) or a
-            // 0-worker pool: run the chunks inline on this thread. Nesting must
-            // NOT re-enter the pool — a lane re-locking m_dispatchMutex would
-            // deadlock — so inner parallel-fors collapse to serial, exactly as
-            // the old queue-based pool effectively behaved.
-            if (m_workers.empty() || t_inJob)
+            // 0-worker pool or a single chunk: no one to share it with.
+            if (m_threads.empty() || chunks == 1)
             {
                 for (size_t i = 0; i < n; i += grain)
                     body(i, std::min(n, i + grain));
                 return;
             }
 
-            // Trampoline so workers can invoke `body` through a void* without a
+            // Trampoline so helpers can invoke `body` through a void* without a
             // per-dispatch heap allocation (vs storing a std::function). `body`
-            // lives on the caller's stack and outlives the dispatch (we block
-            // until every lane finishes below).
+            // and `job` live on the caller's stack and outlive the dispatch (we
+            // wait for every helper below).
             using BodyT = std::remove_reference_t<Body>;
-            JobFn fn = [](void *ctx, size_t b, size_t e) {
+            LoopJob job;
+            job.pool = this;
+            job.fn = [](void *ctx, size_t b, size_t e) {
                 (*static_cast<BodyT *>(ctx))(b, e);
             };
+            job.ctx = static_cast<void *>(std::addressof(body));
+            job.n = n;
+            job.grain = grain;
 
-            // One job at a time on the shared pool (fork-join).
-            std::lock_guard<std::mutex> dispatch(m_dispatchMutex);
+            // One helper per lane that could usefully join, minus the caller.
+            // A helper that arrives after the cursor is exhausted returns at
+            // once, so over-supplying costs a pop, not a chunk.
+            const size_t helpers = std::min(m_threads.size(), chunks - 1);
+            job.pending.store(static_cast<int>(helpers), std::memory_order_relaxed);
 
-            // Publish the job, then bump the generation to release the workers.
-            {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_jobFn = fn;
-                m_jobCtx = static_cast<void *>(std::addressof(body));
-                m_jobN = n;
-                m_jobGrain = grain;
-                m_cursor.store(0, std::memory_order_relaxed);
-                m_lanesRemaining.store(static_cast<int>(m_workers.size()),
-                                       std::memory_order_relaxed);
-                // Release: a worker that observes this generation via a lock-free
-                // acquire-load (spin path) is guaranteed to see the job fields +
-                // reset cursor/lanes written above.
-                m_generation.fetch_add(1, std::memory_order_release);
-            }
-            m_workCv.notify_all();
+            const WaitScope scope = beginWait();
+            submit(Task{&LoopJob::helper, &job}, helpers);
 
             // The calling thread is a lane too.
-            runJob();
-
-            // Wait for the worker lanes to drain the cursor for this generation.
-            // Spin first (they're finishing their last chunks — usually within a
-            // chunk-time), then fall back to the condvar so we don't burn a core
-            // if a straggler runs long.
-            bool drained = false;
-            for (int i = 0; i < kPoolSpinIters; ++i)
-            {
-                if (m_lanesRemaining.load(std::memory_order_acquire) == 0) { drained = true; break; }
-                cpuRelax();
-            }
-            if (!drained)
+            job.run();
+
+            // The cursor is exhausted, so helpers still queued would only
+            // find nothing to do. A worker pops its own back in wait(); an
+            // outside thread takes its out of the injection queue here rather
+            // than waiting for a busy pool to get round to them.
+            if (!scope.worker)
             {
-                std::unique_lock<std::mutex> done(m_doneMutex);
-                m_doneCv.wait(done, [this] {
-                    return m_lanesRemaining.load(std::memory_order_acquire) == 0;
-                });
+                if (const size_t retracted = retract(&job))
+                    job.pending.fetch_sub(static_cast<int>(retracted), std::memory_order_acq_rel);
             }
+            wait(job.pending, scope, /*isolated=*/true);
         }
 
-    private:
-        using JobFn = void (*)(void *, size_t, size_t);
+        // --- Low-level task interface (TaskGroup / TaskGraph build on it) ---
 
-        ThreadPool()
+        // Queue `copies` instances of `task`. From a worker of this pool they go
+        // onto its own deque (running inline if that is full); from any other
+        // thread, onto the shared injection queue. Wakes sleeping workers.
+        void submit(const Task &task, size_t copies = 1);
+
+        // Where a waiting thread stands when it starts waiting; taken *before*
+        // submitting the tasks it will wait for.
+        struct WaitScope
         {
-            // Reserve a core for the calling thread; the pool + caller then span
-            // ~hardware_concurrency() lanes without oversubscribing.
-            const size_t hw = std::max<size_t>(1, std::thread::hardware_concurrency());
-            const size_t workers = hw > 1 ? hw - 1 : 0; // caller is one lane
-            m_workers.reserve(workers);
-            for (size_t i = 0; i < workers; ++i)
-                m_workers.emplace_back([this] { workerLoop(); });
-        }
+            int64_t mark = 0;
+            bool worker = false;
+        };
+        WaitScope beginWait() const;
+
+        // Block until `pending` reaches zero, running tasks meanwhile instead of
+        // sleeping. `isolated` restricts that to tasks this thread pushed since
+        // `scope` was taken (its own subtree); otherwise it also steals from
+        // other workers and the injection queue. Whoever drops `pending` to
+        // zero must call notifyDone().
+        void wait(const std::atomic<int> &pending, const WaitScope &scope, bool isolated);
+        void notifyDone();
+
+        // Remove not-yet-started tasks with this context from the injection
+        // queue; returns how many were removed.
+        size_t retract(const void *ctx);
 
-        ~ThreadPool()
+        // Run one task from anywhere in the pool; false when none was found.
+        bool runOne();
+
+        // The pool the calling thread works for, or null for outside threads.
+        static ThreadPool *current();
+
+    private:
+        // Shared state of one parallelFor dispatch.
+        struct LoopJob
         {
+            using Fn = void (*)(void *, size_t, size_t);
+
+            ThreadPool *pool = nullptr;
+            Fn fn = nullptr;
+            void *ctx = nullptr;
+            size_t n = 0;
+            size_t grain = 1;
+            alignas(64) std::atomic<size_t> cursor{0};
+            std::atomic<int> pending{0};
+
+            // Claim and run chunks from the shared cursor until [0,n) is
+            // exhausted.
+            void run()
             {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_stop.store(true, std::memory_order_release);
+                for (;;)
+                {
+                    const size_t i = cursor.fetch_add(grain, std::memory_order_relaxed);
+                    if (i >= n) break;
+                    fn(ctx, i, std::min(n, i + grain));
+                }
             }
-            m_workCv.notify_all();
-            for (auto &w : m_workers) w.join();
-        }
 
-        ThreadPool(const ThreadPool &) = delete;
-        ThreadPool &operator=(const ThreadPool &) = delete;
+            static void helper(void *p)
+            {
+                auto &job = *static_cast<LoopJob *>(p);
+                ThreadPool *pool = job.pool; // `job` may be gone once pending hits 0
+                job.run();
+                if (job.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    pool->notifyDone();
+            }
+        };
+
+        struct Worker
+        {
+            WorkStealingDeque deque;
+        };
 
         // Chunk size: aim for ~kChunksPerLane chunks per lane so a slow lane only
         // delays the others by at most one chunk, but keep chunks coarse enough
@@ -186,87 +295,35 @@ namespace tracey
             return std::max<size_t>(kMinGrain, (n + target - 1) / target);
         }
 
-        // Claim and run chunks from the shared cursor until [0,n) is exhausted.
-        // While a body runs, this lane is "in a job", so a nested parallelFor it
-        // triggers collapses to serial instead of re-entering (and deadlocking on)
-        // the pool.
-        void runJob()
-        {
-            const size_t n = m_jobN, grain = m_jobGrain;
-            const JobFn fn = m_jobFn;
-            void *const ctx = m_jobCtx;
-            const bool prevInJob = t_inJob;
-            t_inJob = true;
-            for (;;)
-            {
-                const size_t i = m_cursor.fetch_add(grain, std::memory_order_relaxed);
-                if (i >= n) break;
-                fn(ctx, i, std::min(n, i + grain));
-            }
-            t_inJob = prevInJob;
-        }
+        void workerLoop(size_t index);
+        bool findWork(size_t self, Task &task);
+        bool steal(size_t self, Task &task);
+        bool popInjected(Task &task);
+        void wakeWorkers(size_t count);
 
-        void workerLoop()
-        {
-            uint64_t lastGen = 0;
-            for (;;)
-            {
-                // Spin briefly for the next generation before sleeping: catches a
-                // back-to-back dispatch without a futex wake. Bounded, so an idle
-                // pool spins once then sleeps on the condvar (which still wakes it
-                // on the next dispatch — the predicate covers a gen bump that
-                // lands between the spin ending and the wait starting).
-                bool gotWork = false;
-                for (int i = 0; i < kPoolSpinIters; ++i)
-                {
-                    if (m_stop.load(std::memory_order_acquire)) return;
-                    if (m_generation.load(std::memory_order_acquire) != lastGen) { gotWork = true; break; }
-                    cpuRelax();
-                }
-                if (!gotWork)
-                {
-                    std::unique_lock<std::mutex> lock(m_mutex);
-                    m_workCv.wait(lock, [this, lastGen] {
-                        return m_stop.load(std::memory_order_relaxed) ||
-                               m_generation.load(std::memory_order_relaxed) != lastGen;
-                    });
-                    if (m_stop.load(std::memory_order_relaxed)) return;
-                }
-                lastGen = m_generation.load(std::memory_order_acquire);
-                runJob();
-                if (m_lanesRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
-                {
-                    std::lock_guard<std::mutex> g(m_doneMutex);
-                    m_doneCv.notify_all();
-                }
-            }
-        }
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
 
-        std::vector<std::thread> m_workers;
-        std::mutex m_mutex;               // guards job publication + m_generation
-        std::condition_variable m_workCv; // wakes workers on a new generation
-        std::mutex m_doneMutex;
-        std::condition_variable m_doneCv; // signals the caller when lanes drain
-        std::mutex m_dispatchMutex;       // serializes dispatches (one job at a time)
-
-        // Current job (published under m_mutex, read lock-free after a lane has
-        // observed the matching generation; stable until the next dispatch, which
-        // m_dispatchMutex + the done-wait prevent from overlapping).
-        JobFn m_jobFn = nullptr;
-        void *m_jobCtx = nullptr;
-        size_t m_jobN = 0;
-        size_t m_jobGrain = 1;
-        std::atomic<size_t> m_cursor{0};
-        std::atomic<int> m_lanesRemaining{0};
-        // Atomic so worker lanes can poll them lock-free during the spin phase
-        // (the condvar paths still hold m_mutex). m_generation is bumped with
-        // release on dispatch; m_stop with release on teardown.
-        std::atomic<uint64_t> m_generation{0};
-        std::atomic<bool> m_stop{false};
+        // Tasks submitted from outside the pool. m_injected mirrors its size
+        // so the spin loops can poll it without taking the lock.
+        std::mutex m_injectMutex;
+        std::deque<Task> m_injection;
+        std::atomic<size_t> m_injected{0};
 
-        // True while this thread is executing a chunk body, so a nested
-        // parallelFor on the same thread runs serially instead of re-entering.
-        static inline thread_local bool t_inJob = false;
+        // Sleep/wake. m_epoch is bumped after every submit and every
+        // notifyDone(); a thread about to sleep reads it, looks for work one
+        // last time, and sleeps only while it is unchanged, so a wake that
+        // races with falling asleep is never lost. Idle workers and blocked
+        // waiters sleep on separate condvars so a single submit wakes one
+        // worker rather than every waiter; the counters let the hot path skip
+        // the mutex when nobody is asleep.
+        std::mutex m_sleepMutex;
+        std::condition_variable m_workerCv;
+        std::condition_variable m_waiterCv;
+        std::atomic<uint64_t> m_epoch{0};
+        std::atomic<int> m_sleepingWorkers{0};
+        std::atomic<int> m_sleepingWaiters{0};
+        std::atomic<bool> m_stop{false};
     };
 
     // Body signature: void(size_t begin, size_t end) — half-open range.
@@ -281,4 +338,26 @@ namespace tracey
         }
         ThreadPool::global().parallelFor(n, body);
     }
+
+    // Per-item variant for a handful of EXPENSIVE independent items (decoding a
+    // texture file, building one BLAS). parallel_for_chunks' minimum grain of
+    // 256 would put a 30-texture scene into a single chunk on one lane; here
+    // every index is its own claimable chunk, so idle lanes pick up whole items.
+    // Body signature: void(size_t index).
+    template <typename Body>
+    inline void parallel_for_each_index(size_t n, Body body)
+    {
+        if (n == 0) return;
+        if (n == 1)
+        {
+            body(size_t{0});
+            return;
+        }
+        ThreadPool::global().parallelFor(
+            n,
+            [&body](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) body(i);
+            },
+            /*grainOverride=*/1);
+    }
 }
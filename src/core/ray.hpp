@@ -9,8 +9,9 @@ namespace tracey
         Vec3 direction;
         Vec3 invDirection;
         // Shutter time in [0,1) for motion blur. The TLAS interpolates each
-        // instance's transform between its shutter-open and shutter-close pose
-        // at this time. Defaults to 0 so static rays are unaffected.
+        // instance's transform between its pose keys at this time, and a
+        // motion Blas its triangles between their position keys. Defaults to
+        // 0 so static rays are unaffected.
         float time = 0.0f;
     };
 
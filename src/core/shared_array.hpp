@@ -0,0 +1,71 @@
+#pragma once
+
+// Reference-counted, copy-on-write array used for the per-vertex channels that
+// travel SOP cook → SceneObject → SceneCompiler → BlasCache. Copying a
+// SharedArray shares the storage (one atomic increment); the first mutation
+// through a shared handle detaches it with a private copy. That lets a
+// SceneObject be copied into a Scene, and its UVs / normals be kept by a
+// BlasCache entry, without duplicating megabytes of per-corner data at every
+// hop.
+//
+// Read access mirrors const std::vector (and vec() hands out the vector
+// itself, so existing `const std::vector<T> &` consumers keep working).
+// Mutation goes through edit() or the push_back / reserve / resize helpers.
+// Not synchronised: a handle must not be mutated while another thread reads
+// through the same handle; distinct handles sharing storage are safe.
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace tracey
+{
+    template <typename T>
+    class SharedArray
+    {
+    public:
+        SharedArray() = default;
+        SharedArray(std::vector<T> values)
+        {
+            if (!values.empty()) m_data = std::make_shared<std::vector<T>>(std::move(values));
+        }
+        SharedArray(std::initializer_list<T> values) : SharedArray(std::vector<T>(values)) {}
+
+        const std::vector<T> &vec() const { return m_data ? *m_data : emptyVector(); }
+
+        size_t size() const { return m_data ? m_data->size() : 0; }
+        bool empty() const { return size() == 0; }
+        const T *data() const { return vec().data(); }
+        const T &operator[](size_t i) const { return (*m_data)[i]; }
+        typename std::vector<T>::const_iterator begin() const { return vec().begin(); }
+        typename std::vector<T>::const_iterator end() const { return vec().end(); }
+
+        // True when both handles point at the same storage.
+        bool sharesWith(const SharedArray &other) const { return m_data && m_data == other.m_data; }
+
+        // Mutable access, detaching from any other holder first.
+        std::vector<T> &edit()
+        {
+            if (!m_data)
+                m_data = std::make_shared<std::vector<T>>();
+            else if (m_data.use_count() > 1)
+                m_data = std::make_shared<std::vector<T>>(*m_data);
+            return *m_data;
+        }
+        void push_back(const T &value) { edit().push_back(value); }
+        void reserve(size_t n) { edit().reserve(n); }
+        void resize(size_t n, const T &value = T()) { edit().resize(n, value); }
+        void clear() { m_data.reset(); }
+
+    private:
+        static const std::vector<T> &emptyVector()
+        {
+            static const std::vector<T> empty;
+            return empty;
+        }
+
+        std::shared_ptr<std::vector<T>> m_data;
+    };
+}
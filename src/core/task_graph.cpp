@@ -0,0 +1,77 @@
+#include "task_graph.hpp"
+
+namespace tracey
+{
+    void TaskGraph::precede(Node before, Node after)
+    {
+        m_nodes[before].successors.push_back(after);
+        m_nodes[after].predecessors++;
+    }
+
+    bool TaskGraph::run(ThreadPool &pool)
+    {
+        if (m_nodes.empty()) return true;
+
+        // Kahn's walk, only to reject cycles up front: a cyclic graph would
+        // otherwise leave its nodes waiting on each other forever.
+        {
+            std::vector<uint32_t> indegree(m_nodes.size());
+            std::vector<Node> ready;
+            for (size_t i = 0; i < m_nodes.size(); ++i)
+            {
+                indegree[i] = m_nodes[i].predecessors;
+                if (indegree[i] == 0) ready.push_back(static_cast<Node>(i));
+            }
+            size_t visited = 0;
+            while (!ready.empty())
+            {
+                const Node n = ready.back();
+                ready.pop_back();
+                visited++;
+                for (Node s : m_nodes[n].successors)
+                    if (--indegree[s] == 0) ready.push_back(s);
+            }
+            if (visited != m_nodes.size()) return false;
+        }
+
+        m_pool = &pool;
+        for (NodeData &n : m_nodes)
+            n.remaining.store(n.predecessors, std::memory_order_relaxed);
+        m_pending.store(static_cast<int>(m_nodes.size()), std::memory_order_relaxed);
+
+        const ThreadPool::WaitScope scope = pool.beginWait();
+        for (NodeData &n : m_nodes)
+            if (n.predecessors == 0) pool.submit(Task{&TaskGraph::execute, &n});
+        pool.wait(m_pending, scope, /*isolated=*/false);
+        return true;
+    }
+
+    void TaskGraph::execute(void *p)
+    {
+        auto *node = static_cast<NodeData *>(p);
+        TaskGraph &graph = *node->graph;
+        ThreadPool &pool = *graph.m_pool;
+        while (node)
+        {
+            if (node->fn) node->fn();
+
+            // Release the successors. The first that becomes ready is the
+            // continuation; the rest go to the pool.
+            NodeData *next = nullptr;
+            for (Node s : node->successors)
+            {
+                NodeData &succ = graph.m_nodes[s];
+                if (succ.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+                if (!next)
+                    next = &succ;
+                else
+                    pool.submit(Task{&TaskGraph::execute, &succ});
+            }
+            // Only after the successors are accounted for, so the count cannot
+            // reach zero while work is still to be released.
+            if (graph.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                pool.notifyDone();
+            node = next;
+        }
+    }
+}
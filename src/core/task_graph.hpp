@@ -0,0 +1,126 @@
+#pragma once
+
+// Task-parallel front ends for the work-stealing ThreadPool (parallel.hpp),
+// for work that is not a flat loop:
+//
+//   TaskGroup — fork-join over arbitrary callables: run() spawns, wait()
+//               returns once every spawned task (and anything they spawned
+//               into the same group) has finished.
+//   TaskGraph — a DAG of callables with precede() edges, run as a whole;
+//               a node starts as soon as its last predecessor finishes.
+//
+// Neither wait blocks a lane: the waiting thread runs queued tasks — its own
+// and, when it has none, ones stolen from other workers — until its own
+// work completes, so a TaskGroup waited on inside a parallelFor body (or vice
+// versa) composes instead of deadlocking or serialising. The flip side is
+// that a wait may run unrelated tasks on the waiting thread's stack; keep
+// thread_local scratch out of anything held across a wait().
+//
+// Tasks must not throw.
+
+#include "parallel.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tracey
+{
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(ThreadPool &pool = ThreadPool::global()) : m_pool(pool) {}
+        ~TaskGroup() { wait(); }
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        // Queue fn() on the pool. Callable from inside the group's own tasks.
+        template <typename F>
+        void run(F &&fn)
+        {
+            using Fn = std::decay_t<F>;
+            struct Closure
+            {
+                TaskGroup *group;
+                Fn fn;
+
+                static void invoke(void *p)
+                {
+                    auto *c = static_cast<Closure *>(p);
+                    TaskGroup *group = c->group;
+                    c->fn();
+                    delete c;
+                    group->finishOne();
+                }
+            };
+            m_pending.fetch_add(1, std::memory_order_relaxed);
+            m_pool.submit(Task{&Closure::invoke, new Closure{this, std::forward<F>(fn)}});
+        }
+
+        // Run tasks until every one run() on this group has finished.
+        void wait() { m_pool.wait(m_pending, m_pool.beginWait(), /*isolated=*/false); }
+
+    private:
+        void finishOne()
+        {
+            ThreadPool &pool = m_pool; // the group may be gone once pending hits 0
+            if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                pool.notifyDone();
+        }
+
+        ThreadPool &m_pool;
+        std::atomic<int> m_pending{0};
+    };
+
+    class TaskGraph
+    {
+    public:
+        using Node = uint32_t;
+
+        // Add a node; it runs fn() once per run().
+        template <typename F>
+        Node add(F &&fn)
+        {
+            NodeData &n = m_nodes.emplace_back();
+            n.graph = this;
+            n.fn = std::forward<F>(fn);
+            return static_cast<Node>(m_nodes.size() - 1);
+        }
+
+        // `after` starts only once `before` has finished.
+        void precede(Node before, Node after);
+
+        size_t size() const { return m_nodes.size(); }
+
+        // Run every node once, honouring the precede() edges, and return when
+        // all have finished; the calling thread helps. A node whose last
+        // predecessor finishes is continued on the same thread (no queue
+        // round-trip); further ready successors are pushed for other lanes to
+        // steal. Returns false without running anything when the edges form a
+        // cycle. May be called again once it returns.
+        bool run(ThreadPool &pool = ThreadPool::global());
+
+    private:
+        struct NodeData
+        {
+            TaskGraph *graph = nullptr;
+            std::function<void()> fn;
+            std::vector<Node> successors;
+            uint32_t predecessors = 0;
+            std::atomic<uint32_t> remaining{0};
+        };
+
+        static void execute(void *node);
+
+        // deque: stable addresses (tasks point at nodes) and no moves of the
+        // atomics as nodes are added.
+        std::deque<NodeData> m_nodes;
+        ThreadPool *m_pool = nullptr;
+        std::atomic<int> m_pending{0};
+    };
+}
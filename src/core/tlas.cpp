@@ -2,6 +2,8 @@
 #include "blas.hpp"
 #include "intersect.hpp"
 #include <algorithm>
+#include <stdexcept>
+#include <string>
 namespace tracey
 {
     // See blas.cpp: cap tree depth so the fixed traversal stack can't overflow.
@@ -18,69 +20,109 @@ namespace tracey
     {
     }
 
-    namespace
+    Tlas::Tlas(std::span<const Blas *> blases, std::span<const Instance> instances,
+               std::span<const Instance> instancesEnd, bool hasMotion, const Config &config)
+        : Tlas(blases, {}, instances, instancesEnd, hasMotion, config)
     {
-        // Row-major 3×4 Instance transform → column-major 4×4 object→world.
-        Mat4 instanceToWorld(const Tlas::Instance &instance)
-        {
-            return Mat4(
-                instance.transform[0][0], instance.transform[1][0], instance.transform[2][0], 0.0f,
-                instance.transform[0][1], instance.transform[1][1], instance.transform[2][1], 0.0f,
-                instance.transform[0][2], instance.transform[1][2], instance.transform[2][2], 0.0f,
-                instance.transform[0][3], instance.transform[1][3], instance.transform[2][3], 1.0f);
-        }
     }
 
-    Tlas::Tlas(std::span<const Blas *> blases, std::span<const Instance> instances,
-               std::span<const Instance> instancesEnd, bool hasMotion, const Config &config)
-        : blases(blases), instances(instances), m_hasMotion(hasMotion), m_config(config)
+    Tlas::Tlas(std::span<const Blas *> blases, std::span<const Tlas *const> groups,
+               std::span<const Instance> instances, std::span<const Instance> instancesEnd,
+               bool hasMotion, const Config &config, uint32_t recordBase)
+        : blases(blases), groups(groups), instances(instances),
+          m_recordBase(recordBase), m_config(config)
     {
-        // hasMotion requires a parallel end-pose array; fall back to static if
-        // the caller didn't supply matching counts.
-        if (m_hasMotion && instancesEnd.size() != instances.size())
-            m_hasMotion = false;
+        const std::span<const Instance> keys[2] = {instances, instancesEnd};
+        build(std::span<const std::span<const Instance>>(keys, hasMotion ? 2 : 1));
+    }
+
+    Tlas::Tlas(std::span<const Blas *> blases, std::span<const Tlas *const> groups,
+               std::span<const std::span<const Instance>> instanceKeys,
+               const Config &config, uint32_t recordBase)
+        : blases(blases), groups(groups),
+          instances(instanceKeys.empty() ? std::span<const Instance>{} : instanceKeys[0]),
+          m_recordBase(recordBase), m_config(config)
+    {
+        build(instanceKeys);
+    }
+
+    void Tlas::build(std::span<const std::span<const Instance>> instanceKeys)
+    {
+        // Motion requires every key to parallel key 0; fall back to static
+        // if the caller didn't supply matching counts.
+        m_motionKeys = static_cast<uint32_t>(std::max<size_t>(instanceKeys.size(), 1));
+        for (const auto &key : instanceKeys)
+            if (key.size() != instances.size())
+                m_motionKeys = 1;
 
         // Prepare instance references with world-space AABBs
         std::vector<InstanceRef> instanceRefs(instances.size());
+        instanceTransforms.reserve(instances.size());
+        m_keyTransforms.reserve(instances.size() * (m_motionKeys - 1));
 
         for (size_t i = 0; i < instances.size(); ++i)
         {
             const auto &instance = instances[i];
             // Precompute inverse transforms for each instance (shutter-open).
-            const Mat4 toWorldMat = instanceToWorld(instance);
+            const Mat4 toWorldMat = instance.getTransform();
             Transforms transforms;
             transforms.toWorld = toWorldMat;
             transforms.toObject = glm::inverse(toWorldMat);
             instanceTransforms.push_back(transforms);
 
-            // Compute world-space AABB for this instance
-            const uint32_t blasIndex = static_cast<uint32_t>(instance.blasAddress);
-            const Blas &blas = *blases[blasIndex];
-            const auto [localMin, localMax] = blas.getBounds();
-
-            // Transform BLAS bounds to world space (shutter-open pose).
-            auto [worldMin, worldMax] = transformAABB(toWorldMat, localMin, localMax);
-
-            // Motion: cache the shutter-close transform and grow the instance
-            // AABB to the swept union so traversal never misses it mid-shutter.
-            if (m_hasMotion)
+            // Compute world-space AABB for this instance. A group reference
+            // contributes its whole child Tlas's bounds, like a BLAS would.
+            Vec3 localMin, localMax;
+            if (instance.referencesGroup())
+            {
+                const Tlas &group = *groups[instance.groupIndex()];
+                std::tie(localMin, localMax) = group.getBounds();
+                m_levels = std::max(m_levels, group.levels() + 1);
+            }
+            else
             {
-                const Mat4 endToWorld = instanceToWorld(instancesEnd[i]);
-                Transforms endXf;
-                endXf.toWorld = endToWorld;
-                endXf.toObject = glm::inverse(endToWorld);
-                instanceTransformsEnd.push_back(endXf);
-
-                const auto [endMin, endMax] = transformAABB(endToWorld, localMin, localMax);
-                worldMin = glm::min(worldMin, endMin);
-                worldMax = glm::max(worldMax, endMax);
+                const uint32_t blasIndex = static_cast<uint32_t>(instance.blasAddress);
+                std::tie(localMin, localMax) = blases[blasIndex]->getBounds();
             }
 
+            // Transform BLAS bounds to world space (shutter-open pose).
+            auto [worldMin, worldMax] = transformAABB(toWorldMat, localMin, localMax);
             instanceRefs[i].index = static_cast<uint32_t>(i);
             instanceRefs[i].bMin = worldMin;
             instanceRefs[i].bMax = worldMax;
         }
 
+        // Motion: cache the later keys' transforms and grow each instance
+        // AABB to the union of its poses. Linear interpolation between two
+        // keys stays inside the union of the two keys' boxes for translation
+        // and scale; rotation can bulge slightly past it, which more keys
+        // shrink.
+        for (uint32_t k = 1; k < m_motionKeys; ++k)
+        {
+            for (size_t i = 0; i < instances.size(); ++i)
+            {
+                const Mat4 keyToWorld = instanceKeys[k][i].getTransform();
+                Transforms keyXf;
+                keyXf.toWorld = keyToWorld;
+                keyXf.toObject = glm::inverse(keyToWorld);
+                m_keyTransforms.push_back(keyXf);
+
+                const auto [localMin, localMax] = instances[i].referencesGroup()
+                    ? groups[instances[i].groupIndex()]->getBounds()
+                    : blases[static_cast<uint32_t>(instances[i].blasAddress)]->getBounds();
+                const auto [keyMin, keyMax] = transformAABB(keyToWorld, localMin, localMax);
+                instanceRefs[i].bMin = glm::min(instanceRefs[i].bMin, keyMin);
+                instanceRefs[i].bMax = glm::max(instanceRefs[i].bMax, keyMax);
+            }
+        }
+
+        // intersect() recurses once per level; refuse a deeper hierarchy
+        // rather than traverse it.
+        if (m_levels > kMaxInstanceLevels)
+            throw std::invalid_argument("Tlas: instance groups nest " + std::to_string(m_levels) +
+                                        " levels deep, the limit is " +
+                                        std::to_string(kMaxInstanceLevels));
+
         // Build BVH over instances
         if (instances.empty())
             return;
@@ -311,6 +353,13 @@ namespace tracey
 
         return nodeIndex;
     }
+    std::tuple<Vec3, Vec3> Tlas::getBounds() const
+    {
+        if (m_nodes.empty())
+            return {Vec3(0.0f), Vec3(0.0f)};
+        return {m_nodes[0].boundsMin, m_nodes[0].boundsMax};
+    }
+
     std::optional<Hit> Tlas::intersect(const Ray &ray, float tMin, float tMax, RayFlags flags) const
     {
         std::optional<Hit> closestHit = std::nullopt;
@@ -319,46 +368,73 @@ namespace tracey
         if (m_nodes.empty())
             return closestHit;
 
-        // Per-instance Blas test, factored out of the BVH walk. Transforms the
-        // ray into the instance's local space (precomputed inverse), intersects
-        // the Blas, and folds a closer world-space hit into closestHit.
+        // Per-instance test, factored out of the BVH walk. Transforms the ray
+        // into the instance's local space (precomputed inverse), intersects the
+        // Blas — or recurses into the referenced group Tlas — and folds a closer
+        // world-space hit into closestHit.
         const auto testInstance = [&](uint32_t instanceIndex) {
-            const Blas &blas = *blases[static_cast<uint32_t>(instances[instanceIndex].blasAddress)];
+            const Instance &instance = instances[instanceIndex];
             const auto &xf = instanceTransforms[instanceIndex];
 
             // Motion blur: linearly interpolate the object→world matrix between
-            // the shutter-open and -close poses at the ray's shutter time, then
-            // invert per-ray. Element-wise matrix lerp matches Metal's matrix
+            // the two pose keys bracketing the ray's shutter time, then invert
+            // per-ray. Element-wise matrix lerp matches Metal's matrix
             // motion-keyframe interpolation so the two backends stay in lockstep.
             Mat4 toObjectM = xf.toObject;
             Mat4 toWorldM = xf.toWorld;
-            if (m_hasMotion)
+            if (m_motionKeys > 1)
             {
-                const float t = ray.time;
-                toWorldM = xf.toWorld * (1.0f - t) + instanceTransformsEnd[instanceIndex].toWorld * t;
+                const uint32_t segments = m_motionKeys - 1;
+                const float x = glm::clamp(ray.time, 0.0f, 1.0f) * static_cast<float>(segments);
+                const uint32_t segment = std::min(static_cast<uint32_t>(x), segments - 1);
+                const float t = x - static_cast<float>(segment);
+                toWorldM = keyTransforms(segment, instanceIndex).toWorld * (1.0f - t) +
+                           keyTransforms(segment + 1, instanceIndex).toWorld * t;
                 toObjectM = glm::inverse(toWorldM);
             }
 
             const Vec3 localRayDirection = transformVector(toObjectM, ray.direction);
             const Vec3 localRayInvDirection = 1.0f / localRayDirection;
             const Vec3 localRayOrigin = transformPoint(toObjectM, ray.origin);
-            const Ray localRay{localRayOrigin, localRayDirection, localRayInvDirection};
+            const Ray localRay{localRayOrigin, localRayDirection, localRayInvDirection, ray.time};
+            // The local direction is deliberately not renormalised: an affine
+            // map preserves the ray parameter, so a local t is the world t and
+            // the current [tMin, closestT) window culls nested traversal too.
+
+            // A group hit already carries its position in this instance's local
+            // space (the group's "world") and the leaf's record id; a Blas hit
+            // only has the local t, and its record is this Tlas's own slot.
+            std::optional<Hit> hitOpt;
+            Vec3 localHitPos;
+            uint32_t recordId;
+            if (instance.referencesGroup())
+            {
+                hitOpt = groups[instance.groupIndex()]->intersect(localRay, tMin, closestT, flags);
+                if (!hitOpt)
+                    return false;
+                localHitPos = hitOpt->position;
+                recordId = hitOpt->instanceId;
+            }
+            else
+            {
+                const Blas &blas = *blases[static_cast<uint32_t>(instance.blasAddress)];
+                hitOpt = blas.intersect(localRay, tMin, closestT, flags);
+                if (!hitOpt)
+                    return false;
+                localHitPos = localRay.origin + localRay.direction * hitOpt->t;
+                recordId = m_recordBase + instanceIndex;
+            }
 
-            if (const auto hitOpt = blas.intersect(localRay, 0.0f, 1e30f, flags); hitOpt)
+            const Vec3 worldHitPos = transformPoint(toWorldM, localHitPos);
+            const float tWorld = hitOpt->t;
+            if (tWorld >= tMin && tWorld < closestT)
             {
-                const Vec3 localHitPos = localRay.origin + localRay.direction * hitOpt->t;
-                const Vec3 worldHitPos = transformPoint(toWorldM, localHitPos);
-                // World-space t (ray.direction is normalized in the renderer).
-                const float tWorld = glm::dot(worldHitPos - ray.origin, ray.direction);
-                if (tWorld >= tMin && tWorld < closestT)
-                {
-                    closestHit = hitOpt;
-                    closestT = tWorld;
-                    closestHit->instanceId = instanceIndex;
-                    closestHit->position = worldHitPos;
-                    closestHit->t = tWorld;
-                    return true;
-                }
+                closestHit = hitOpt;
+                closestT = tWorld;
+                closestHit->instanceId = recordId;
+                closestHit->position = worldHitPos;
+                closestHit->t = tWorld;
+                return true;
             }
             return false;
         };
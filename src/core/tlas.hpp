@@ -2,7 +2,7 @@
 #include <cstdint>
 #include <optional>
 #include <span>
-#include <optional>
+#include <tuple>
 #include <vector>
 #include "hit.hpp"
 #include "bvh_node.hpp"
@@ -30,6 +30,12 @@ namespace tracey
             uint32_t instanceShaderBindingTableRecordOffsetAndFlags = 0u;
             uint64_t blasAddress = 0; // Address of the BLAS this instance refers to
 
+            // Nested instancing: with the top bit set, blasAddress names an
+            // instance group — another Tlas, indexed into the `groups` span the
+            // Tlas was built with — instead of a BLAS. Only the CPU Tlas walks
+            // group references; device TLASes take flat instance lists.
+            static constexpr uint64_t kGroupReferenceBit = 1ull << 63;
+
             Instance()
             {
                 // Initialize to identity matrix
@@ -56,6 +62,31 @@ namespace tracey
                         transform[r][c] = mat[c][r];
             }
 
+            bool referencesGroup() const
+            {
+                return (blasAddress & kGroupReferenceBit) != 0;
+            }
+
+            uint32_t groupIndex() const
+            {
+                return static_cast<uint32_t>(blasAddress & ~kGroupReferenceBit);
+            }
+
+            void setGroupReference(uint32_t groupIndex)
+            {
+                blasAddress = kGroupReferenceBit | groupIndex;
+            }
+
+            // Inverse of setTransform: the row-major 3x4 as a column-major Mat4.
+            Mat4 getTransform() const
+            {
+                return Mat4(
+                    transform[0][0], transform[1][0], transform[2][0], 0.0f,
+                    transform[0][1], transform[1][1], transform[2][1], 0.0f,
+                    transform[0][2], transform[1][2], transform[2][2], 0.0f,
+                    transform[0][3], transform[1][3], transform[2][3], 1.0f);
+            }
+
             uint32_t instanceCustomIndex() const
             {
                 return instanceCustomIndexAndMask & 0xFFFFFF;
@@ -129,8 +160,47 @@ namespace tracey
         // false this behaves exactly like the static constructor.
         Tlas(std::span<const Blas *> blases, std::span<const Instance> instances,
              std::span<const Instance> instancesEnd, bool hasMotion, const Config &config);
+        // Multi-level constructor: instances may reference `groups` (see
+        // Instance::setGroupReference). A group is itself a Tlas over the same
+        // blases, built in the group's local space; a placement transforms the
+        // ray into that space and recurses. Hits report a *record* id in
+        // Hit::instanceId: recordBase + the leaf's index in the Tlas that holds
+        // it, so a group's leaves share one record range across every
+        // placement. Nesting depth is capped at kMaxInstanceLevels (this Tlas
+        // included); deeper groups throw std::invalid_argument. Groups must
+        // outlive this Tlas.
+        Tlas(std::span<const Blas *> blases, std::span<const Tlas *const> groups,
+             std::span<const Instance> instances, std::span<const Instance> instancesEnd,
+             bool hasMotion, const Config &config, uint32_t recordBase = 0);
+        // Multi-segment motion: `instanceKeys` holds K poses of every
+        // instance (each key parallel to key 0), evenly spaced over the
+        // shutter — key 0 at Ray::time 0, key K-1 at Ray::time 1.
+        // intersect() interpolates within the segment bracketing the ray's
+        // time, so K > 2 follows curved paths (rotation, arcs) that a single
+        // open/close pair cuts straight across. The two-pose constructor is
+        // the K = 2 case; K = 1 is static. Keys whose size differs from key
+        // 0 disable motion. The instance BVH bounds each instance by the
+        // union of all its keys.
+        Tlas(std::span<const Blas *> blases, std::span<const Tlas *const> groups,
+             std::span<const std::span<const Instance>> instanceKeys,
+             const Config &config, uint32_t recordBase = 0);
+
+        static constexpr int kMaxInstanceLevels = 4;
 
         std::optional<Hit> intersect(const Ray &ray, float tMin, float tMax, RayFlags flags) const;
+
+        // Bounds of every instance in this Tlas's space (the root node). An
+        // empty Tlas reports a zero-size box at the origin.
+        std::tuple<Vec3, Vec3> getBounds() const;
+
+        // Instance pose keys over the shutter; 1 without motion.
+        uint32_t motionKeyCount() const { return m_motionKeys; }
+
+        // Instance levels below and including this one: 1 for a Tlas whose
+        // instances all reference BLASes.
+        int levels() const { return m_levels; }
+        uint32_t recordBase() const { return m_recordBase; }
+        size_t instanceCount() const { return instances.size(); }
         const Instance &getInstance(uint32_t index) const
         {
             return instances[index];
@@ -168,15 +238,25 @@ namespace tracey
             Vec3 bMax;
         };
 
+        void build(std::span<const std::span<const Instance>> instanceKeys);
         uint32_t buildRecursive(std::span<InstanceRef> refs, uint32_t nodeIndex, uint32_t start, uint32_t end, int depth);
+        const Transforms &keyTransforms(uint32_t key, uint32_t index) const
+        {
+            return key == 0 ? instanceTransforms[index]
+                            : m_keyTransforms[(key - 1) * instances.size() + index];
+        }
 
         std::span<const Blas *> blases;
+        std::span<const Tlas *const> groups;
         std::span<const Instance> instances;
         std::vector<Transforms> instanceTransforms;
-        // R4 motion blur: shutter-close transforms (parallel to
-        // instanceTransforms). Only consulted when m_hasMotion is true.
-        std::vector<Transforms> instanceTransformsEnd;
-        bool m_hasMotion = false;
+        // Motion blur: transforms for pose keys 1..K-1, key-major, each key
+        // parallel to instanceTransforms (key 0). Empty when m_motionKeys
+        // is 1.
+        std::vector<Transforms> m_keyTransforms;
+        uint32_t m_motionKeys = 1;
+        uint32_t m_recordBase = 0;
+        int m_levels = 1;
         std::vector<BVHNode> m_nodes;
         std::vector<uint32_t> m_instanceIndices;
         Config m_config;
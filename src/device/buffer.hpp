@@ -12,5 +12,12 @@ namespace tracey
         virtual void mapRange(uint32_t offset, uint32_t size) = 0;
         virtual void flush() = 0;
         virtual void flushRange(uint32_t offset, uint32_t size) = 0;
+
+        // Contents in ordinary cached host memory, stable for the buffer's
+        // lifetime, when the buffer lives there (CpuBuffer); null otherwise.
+        // Persistently mapped device memory is deliberately not offered: it
+        // is often write-combined, and reading it in a hot loop is far
+        // slower than copying it out once.
+        virtual const void *hostData() const { return nullptr; }
     };
 }
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace tracey
         void mapRange(uint32_t offset, uint32_t size) override;
         void flush() override;
         void flushRange(uint32_t offset, uint32_t size) override;
+        const void *hostData() const override { return m_data; }
 
     private:
         void *m_data = nullptr;
@@ -24,6 +24,7 @@ namespace tracey
         }
 
         const Tlas &tlas() const { return m_tlas.value(); }
+        const Tlas *cpuTlas() const override { return m_tlas ? &*m_tlas : nullptr; }
 
     private:
         std::vector<const Blas *> blasPtrs;
@@ -28,6 +28,6 @@ namespace tracey
     }
     size_t VulkanComputeBottomLevelAccelerationStructure::triangleCount() const
     {
-        return m_blas ? m_blas->triangleData().size() : 0;
+        return m_blas ? m_blas->triangleCount() : 0;
     }
 }
\ No newline at end of file
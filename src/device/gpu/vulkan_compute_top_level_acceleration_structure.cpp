@@ -23,14 +23,14 @@ namespace tracey
     VulkanComputeTopLevelAccelerationStructure::VulkanComputeTopLevelAccelerationStructure(VulkanComputeDevice &device, std::span<const BottomLevelAccelerationStructure *> blases, std::span<const Tlas::Instance> instances) : m_device(device)
     {
         // Build the CPU-side TLAS with BVH
-        std::vector<const Blas *> blasPtrs;
-        blasPtrs.reserve(blases.size());
+        m_blasPtrs.reserve(blases.size());
         for (const auto &blas : blases)
         {
             const auto vulkanBlas = static_cast<const VulkanComputeBottomLevelAccelerationStructure *>(blas);
-            blasPtrs.push_back(&vulkanBlas->blas());
+            m_blasPtrs.push_back(&vulkanBlas->blas());
         }
-        Tlas tlas(blasPtrs, instances);
+        m_tlas.emplace(std::span<const Blas *>(m_blasPtrs.data(), m_blasPtrs.size()), instances);
+        const Tlas &tlas = *m_tlas;
 
         std::cout << "TLAS BVH: " << tlas.nodeCount() << " nodes, " << instances.size() << " instances" << std::endl;
         size_t nodeCount = 0;
@@ -88,7 +88,16 @@ namespace tracey
             const auto vulkanBlas = static_cast<const VulkanComputeBottomLevelAccelerationStructure *>(blas);
             const auto blasNodeCount = vulkanBlas->nodeCount();
             const auto blasTriangleCount = vulkanBlas->triangleCount();
-            std::memcpy(&triangleData[triangleOffset], vulkanBlas->triangleData().data(), sizeof(Blas::TriangleData) * blasTriangleCount);
+            if (vulkanBlas->blas().compact())
+            {
+                // BVHConfig::compactTriangles: the shader reads full TriangleData.
+                for (size_t t = 0; t < blasTriangleCount; ++t)
+                    triangleData[triangleOffset + t] = vulkanBlas->blas().triangle(static_cast<uint32_t>(t));
+            }
+            else
+            {
+                std::memcpy(&triangleData[triangleOffset], vulkanBlas->triangleData().data(), sizeof(Blas::TriangleData) * blasTriangleCount);
+            }
             std::memcpy(&primitiveIndexData[triangleOffset], vulkanBlas->primIndices().data(), sizeof(uint32_t) * blasTriangleCount);
             blasInfoData[blasIndex].rootNodeIndex = static_cast<uint32_t>(nodeOffset);
             blasInfoData[blasIndex].triangleOffset = static_cast<uint32_t>(triangleOffset);
@@ -1,5 +1,7 @@
 #pragma once
 #include <memory>
+#include <optional>
+#include <vector>
 #include "../top_level_acceleration_structure.hpp"
 #include "../../core/tlas.hpp"
 
@@ -24,8 +26,15 @@ namespace tracey
         VulkanBuffer *tlasNodesBuffer() const { return m_tlasNodesBuffer.get(); }
         VulkanBuffer *tlasInstanceIndicesBuffer() const { return m_tlasInstanceIndicesBuffer.get(); }
 
+        const Tlas *cpuTlas() const override { return m_tlas ? &*m_tlas : nullptr; }
+
     private:
         VulkanComputeDevice &m_device;
+        // The CPU TLAS the GPU buffers were uploaded from. Kept (it is small:
+        // instance-level nodes over spans) so the CPU path tracer backend can
+        // reuse it rather than rebuild it.
+        std::vector<const Blas *> m_blasPtrs;
+        std::optional<Tlas> m_tlas;
         std::unique_ptr<VulkanBuffer> m_instancesBuffer;
         std::unique_ptr<VulkanBuffer> m_blasBuffer;
         std::unique_ptr<VulkanBuffer> m_blasInfoBuffer;
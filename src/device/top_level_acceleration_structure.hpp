@@ -2,9 +2,17 @@
 
 namespace tracey
 {
+    class Tlas;
+
     class TopLevelAccelerationStructure
     {
     public:
         virtual ~TopLevelAccelerationStructure() = default;
+
+        /// CPU-side instance BVH this acceleration structure was built from,
+        /// over the BLASes' cpuBlas() data and the instance span passed at
+        /// creation. The CPU path tracer backend traverses it directly
+        /// instead of building a second one.
+        virtual const Tlas *cpuTlas() const = 0;
     };
 } // namespace tracey
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "../graph/connection.hpp"
 
 #include <algorithm>
+#include <optional>
 #include <unordered_map>
 
 namespace tracey
@@ -12,11 +13,9 @@ namespace tracey
         DopGraph::DopGraph(size_t uid) : Graph(uid)
         {
             // Frame 0 is the implicit pre-sim baseline: empty geometry, no
-            // header advance. Seeding the cache with it means cookOneFrame
-            // can always assume a valid `prev` and the editor's
+            // header advance. FrameCache seeds itself with it so
+            // cookOneFrame can always assume a valid `prev` and the editor's
             // "cached_to_frame" status starts at 0 rather than -1.
-            m_frameCache.emplace_back();
-            m_frameCache.back().header.frame = 0;
         }
 
         DopNode *DopGraph::findNode(size_t uid)
@@ -52,29 +51,91 @@ namespace tracey
 
         void DopGraph::clearCache()
         {
-            // Keep frame-0 (the empty baseline). Without it, the next
+            // Keeps frame-0 (the empty baseline). Without it, the next
             // cookToFrame call would have nothing to read as `prev`.
-            m_frameCache.resize(1);
+            m_frameCache.clear();
+            m_frameSopInputs.clear();
+            m_sopFirstRead.clear();
+        }
+
+        void DopGraph::setFrameCacheConfig(FrameCacheConfig config)
+        {
+            m_frameCache.setConfig(std::move(config));
+            m_frameSopInputs.clear();
+            m_sopFirstRead.clear();
+        }
+
+        int DopGraph::invalidateChangedSopInputs()
+        {
+            if (!m_sopProvider) return 0;
+            for (size_t i = 0; i < m_frameSopInputs.size(); ++i)
+            {
+                bool changed = false;
+                for (const SopInputStamp &s : m_frameSopInputs[i])
+                {
+                    const bool present = m_sopProvider->lookupCookedGeometry(s.sopUid) != nullptr;
+                    if (present != s.present || m_sopProvider->version(s.sopUid) != s.version)
+                    {
+                        changed = true;
+                        break;
+                    }
+                }
+                if (!changed) continue;
+
+                // The cache may cut earlier than asked (see
+                // FrameCache::truncate); keep the stamps in step with it.
+                const int kept = m_frameCache.truncate(static_cast<int>(i));
+                m_frameSopInputs.resize(static_cast<size_t>(kept));
+                std::erase_if(m_sopFirstRead, [kept](const auto &entry) { return entry.second > kept; });
+                return kept + 1;
+            }
+            return 0;
+        }
+
+        const std::vector<DopGraph::SopInputStamp> *DopGraph::sopInputs(int frameIdx) const
+        {
+            if (frameIdx < 1 || frameIdx > static_cast<int>(m_frameSopInputs.size())) return nullptr;
+            return &m_frameSopInputs[frameIdx - 1];
         }
 
         int DopGraph::cachedToFrame() const
         {
-            // m_frameCache[0] is the baseline (frame 0). The "newest cooked
-            // frame" is the index of the last element when size > 1.
-            return m_frameCache.empty() ? 0
-                                        : static_cast<int>(m_frameCache.size() - 1);
+            return m_frameCache.lastFrame();
         }
 
         const SimState *DopGraph::frame(int frameIdx) const
         {
-            if (frameIdx < 0) return nullptr;
-            if (static_cast<size_t>(frameIdx) >= m_frameCache.size()) return nullptr;
-            return &m_frameCache[frameIdx];
+            return m_frameCache.get(frameIdx);
         }
 
         // ── Topo sort (Kahn's; identical to VopGraph's) ────────────────────
         namespace
         {
+            // Forwards to the graph's provider and stamps each uid the
+            // first time a frame's cook looks it up. Lookups come from the
+            // serial part of a node's cookFrame, so no locking.
+            class RecordingSopProvider : public SopGeometryProvider
+            {
+            public:
+                RecordingSopProvider(const SopGeometryProvider &inner,
+                                     std::vector<DopGraph::SopInputStamp> &out)
+                    : m_inner(inner), m_out(out) {}
+
+                const Geometry *lookupCookedGeometry(uint64_t sopUid) const override
+                {
+                    const Geometry *g = m_inner.lookupCookedGeometry(sopUid);
+                    const bool seen = std::any_of(m_out.begin(), m_out.end(),
+                                                  [&](const auto &s) { return s.sopUid == sopUid; });
+                    if (!seen) m_out.push_back({sopUid, m_inner.version(sopUid), g != nullptr});
+                    return g;
+                }
+                uint64_t version(uint64_t sopUid) const override { return m_inner.version(sopUid); }
+
+            private:
+                const SopGeometryProvider &m_inner;
+                std::vector<DopGraph::SopInputStamp> &m_out;
+            };
+
             std::vector<size_t> topoSort(const DopGraph &g, bool *cycleOut)
             {
                 std::unordered_map<size_t, int> inDeg;
@@ -135,7 +196,8 @@ namespace tracey
         SimState DopGraph::cookOneFrame(const SimState &prev,
                                         int frameIdx,
                                         double fps,
-                                        int substepsPerFrame) const
+                                        int substepsPerFrame,
+                                        std::vector<SopInputStamp> *inputsOut) const
         {
             SimState next = prev;  // carry geometry forward as the starting point
             const int nsub = std::max(1, substepsPerFrame);
@@ -150,6 +212,9 @@ namespace tracey
                 node->prepare(next);
             }
 
+            std::optional<RecordingSopProvider> recorder;
+            if (m_sopProvider && inputsOut) recorder.emplace(*m_sopProvider, *inputsOut);
+
             for (int sub = 0; sub < nsub; ++sub)
             {
                 next.header.frame = frameIdx;
@@ -164,7 +229,7 @@ namespace tracey
                 DopEvalContext ctx;
                 ctx.state = &next;
                 ctx.graph = this;
-                ctx.sopProvider = m_sopProvider;
+                ctx.sopProvider = recorder ? &*recorder : m_sopProvider;
                 for (size_t uid : m_topoOrder)
                 {
                     const auto *node = findNode(uid);
@@ -187,10 +252,20 @@ namespace tracey
                 // get the empty baseline.
                 return;
             }
-            for (int f = static_cast<int>(m_frameCache.size()); f <= target; ++f)
+            for (int f = m_frameCache.lastFrame() + 1; f <= target; ++f)
             {
                 const SimState &prev = m_frameCache.back();
-                m_frameCache.push_back(cookOneFrame(prev, f, fps, substepsPerFrame));
+                std::vector<SopInputStamp> inputs;
+                SimState next = cookOneFrame(prev, f, fps, substepsPerFrame, &inputs);
+                // A SOP edit invalidates from the first cached frame that
+                // read the SOP, so the frame before a first read is where
+                // invalidateChangedSopInputs() will cut. Keep it exact.
+                bool firstRead = false;
+                for (const SopInputStamp &s : inputs)
+                    firstRead |= m_sopFirstRead.try_emplace(s.sopUid, f).second;
+                if (firstRead) m_frameCache.checkpoint();
+                m_frameCache.push(std::move(next));
+                m_frameSopInputs.push_back(std::move(inputs));
             }
         }
     }
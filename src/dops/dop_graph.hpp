@@ -3,6 +3,7 @@
 #include "../graph/graph.hpp"
 #include "dop_node.hpp"
 #include "eval_context.hpp"
+#include "frame_cache.hpp"
 #include "sim_state.hpp"
 
 #include <cstddef>
@@ -28,10 +29,19 @@ namespace tracey
         //
         // State cache: keyed by integer frame number. Frame 0 is the implicit
         // empty "before sim starts" state. Frame 1 is the first cooked frame.
+        // Frames are held compressed (see FrameCache) and spill to disk past
+        // the configured memory budget; frame() decodes on demand.
         // Edits anywhere in the graph (params, nodes, connections) MUST call
         // markDirty() — which also clears the cache, since prior frames were
         // derived from the old graph and are now invalid.
         //
+        // SOP inputs are dependency-tracked instead: each cooked frame
+        // records the (uid, version) of every SOP output its nodes read
+        // through the provider. After a SOP edit, invalidateChangedSopInputs()
+        // drops only the frames from the first one whose inputs changed —
+        // a sim that starts reading its emitter at frame 40 keeps frames
+        // 1..39, and an edit to a SOP the sim never reads keeps everything.
+        //
         // Phase 0: no inter-node data ports. cookFrame walks nodes linearly
         // in topo order; each node mutates the shared SimState. Adding data
         // slots later is purely additive — mirror VopGraph's slot table and
@@ -66,9 +76,14 @@ namespace tracey
             int cachedToFrame() const;
 
             // Return the cached SimState for a frame, or nullptr if not
-            // cached. Reads are cheap (hashmap lookup); the caller should
-            // NOT mutate the returned state — it's the canonical cache
-            // entry that downstream consumers (`dop_import` SOP) will read.
+            // cached. The newest frame is returned as cooked; older frames
+            // are decoded from the compressed cache on first access (one
+            // frame's worth of work during sequential playback) and come
+            // back quantised per FrameCacheConfig::quantumFor() (P and v
+            // by default; other attributes exact). The caller should
+            // NOT mutate the returned state, and should copy it if it needs
+            // it past the next cook or a few more frame() calls — see
+            // FrameCache::get().
             const SimState *frame(int frameIdx) const;
 
             // Cook frame-by-frame from the last-cached frame forward to
@@ -81,6 +96,25 @@ namespace tracey
             // button and by markDirty().
             void clearCache();
 
+            // Frame-cache tuning (quantisation step, memory budget, spill
+            // directory). Changing the config drops every cached frame.
+            void setFrameCacheConfig(FrameCacheConfig config);
+
+            // Compare every cached frame's recorded SOP inputs against the
+            // provider's current versions (and presence) and truncate the
+            // cache just before the first frame that differs. Returns the
+            // first dropped frame, or 0 when every cached frame is still
+            // valid. The next cookToFrame() resumes from the kept tail,
+            // exactly as it was first cooked: cookToFrame() checkpoints the
+            // frame before each SOP's first read, which is where this cuts
+            // (see FrameCache::truncate()).
+            int invalidateChangedSopInputs();
+            const FrameCacheConfig &frameCacheConfig() const { return m_frameCache.config(); }
+
+            // Compression ratio / encode + decode timings since the last
+            // clear — surfaced by dop_smoke and the editor's sim status.
+            const FrameCacheStats &frameCacheStats() const { return m_frameCache.stats(); }
+
             // Optional SOP-graph back-reference for DOPs that source data
             // from a cooked SOP node (pop_source's emit_mode="geometry").
             // The editor sets this once at engine bootstrap; smoke tests
@@ -90,23 +124,47 @@ namespace tracey
             void setSopProvider(const SopGeometryProvider *provider) { m_sopProvider = provider; }
             const SopGeometryProvider *sopProvider() const { return m_sopProvider; }
 
+            // One SOP output a cooked frame read: which uid, the
+            // provider's version() at the time, and whether it was there at
+            // all (a missing source makes pop_source fall back, so its
+            // appearance is a change too).
+            struct SopInputStamp
+            {
+                uint64_t sopUid = 0;
+                uint64_t version = 0;
+                bool present = false;
+            };
+
+            // SOP inputs recorded for cached frame `frameIdx` (>= 1), or
+            // nullptr when it isn't cached.
+            const std::vector<SopInputStamp> *sopInputs(int frameIdx) const;
+
         private:
             // One frame's cook, given the prior frame's state. Returns the
             // new SimState. Walks node topo order over `substeps` substeps.
+            // SOP lookups made along the way are appended to `inputsOut`
+            // (one stamp per uid).
             SimState cookOneFrame(const SimState &prev,
                                   int frameIdx,
                                   double fps,
-                                  int substepsPerFrame) const;
+                                  int substepsPerFrame,
+                                  std::vector<SopInputStamp> *inputsOut) const;
 
             size_t m_nextUid = 1;
 
             mutable bool m_dirty = true;
             mutable std::vector<size_t> m_topoOrder;
 
-            // Per-frame cache. Dense vector indexed by frame number; index 0
-            // is the implicit empty initial state. Resized on the fly as we
-            // cook forward.
-            std::vector<SimState> m_frameCache;
+            // Per-frame cache; frame 0 is the implicit empty initial state.
+            // Mutable because frame() decodes lazily.
+            mutable FrameCache m_frameCache;
+            // m_frameSopInputs[f - 1] is frame f's; kept in step with
+            // m_frameCache.
+            std::vector<std::vector<SopInputStamp>> m_frameSopInputs;
+            // SOP uid → first cached frame that read it, so cookToFrame can
+            // spot a first read without rescanning every frame. Entries past
+            // a truncation are dropped with the frames.
+            std::unordered_map<uint64_t, int> m_sopFirstRead;
 
             // Optional. Used by pop_source (and any future geometry-source
             // DOP) to read the cooked output of a referenced SOP node at
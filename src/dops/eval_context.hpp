@@ -21,11 +21,22 @@ namespace tracey
         // Returns nullptr when the uid isn't in the cache (the source SOP
         // hasn't been cooked yet, or was deleted). Consumers must handle
         // null — e.g. pop_source falls back to its origin/initial_v defaults.
+        //
+        // version() identifies the geometry lookupCookedGeometry() would
+        // return: it must change whenever that geometry is edited (the
+        // editor forwards CookCache::versionOf — the cookId, or for
+        // time-dependent sources a key that ignores the playhead, since a
+        // sim legitimately reads a different frame of those every step).
+        // DopGraph records it per frame for every uid a frame read, and
+        // invalidateChangedSopInputs() compares against it. The default 0
+        // means "untracked": only a source appearing or disappearing then
+        // counts as a change.
         class SopGeometryProvider
         {
         public:
             virtual ~SopGeometryProvider() = default;
             virtual const Geometry *lookupCookedGeometry(uint64_t sopUid) const = 0;
+            virtual uint64_t version(uint64_t sopUid) const { (void)sopUid; return 0; }
         };
 
         // Carried through every DOP node's cookFrame() call.
@@ -0,0 +1,997 @@
+#include "frame_cache.hpp"
+
+#include "../geometry/attribute.hpp"
+#include "../geometry/attribute_table.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <system_error>
+#include <typeindex>
+#include <unordered_map>
+
+namespace tracey
+{
+    namespace dops
+    {
+        namespace
+        {
+            // Spill files are private to the process that wrote them, but a
+            // stale file from a crashed session must not decode as garbage.
+            constexpr uint32_t kSpillMagic = 0x43464454u; // "TDFC"
+            constexpr uint32_t kSpillVersion = 2;
+
+            // Quantised values are clamped well inside int64 so the linear
+            // predictor (2*q1 - q2) and its residual can't overflow.
+            constexpr double kMaxQuantised = 1152921504606846976.0; // 2^60
+
+            enum class ElemType : uint8_t
+            {
+                Float,
+                Vec2,
+                Vec3,
+                Vec4,
+                Mat3,
+                Mat4,
+                Int,
+                String,
+                Unknown,
+            };
+
+            enum class Encoding : uint8_t
+            {
+                Raw,       // element bytes verbatim
+                Quantised, // zig-zag varint residuals of quantised floats
+                IntDelta,  // zig-zag varint deltas against the previous element
+            };
+
+            ElemType elemTypeOf(const AttributeBase &attr)
+            {
+                const std::type_index t = attr.typeIndex();
+                if (t == std::type_index(typeid(float))) return ElemType::Float;
+                if (t == std::type_index(typeid(Vec2))) return ElemType::Vec2;
+                if (t == std::type_index(typeid(Vec3))) return ElemType::Vec3;
+                if (t == std::type_index(typeid(Vec4))) return ElemType::Vec4;
+                if (t == std::type_index(typeid(Mat3))) return ElemType::Mat3;
+                if (t == std::type_index(typeid(Mat4))) return ElemType::Mat4;
+                if (t == std::type_index(typeid(int))) return ElemType::Int;
+                if (t == std::type_index(typeid(std::string))) return ElemType::String;
+                return ElemType::Unknown;
+            }
+
+            // Floats per element for the float-backed types (glm types are
+            // tightly packed float arrays), 0 otherwise.
+            uint32_t floatComponents(ElemType type)
+            {
+                switch (type)
+                {
+                case ElemType::Float: return 1;
+                case ElemType::Vec2:  return 2;
+                case ElemType::Vec3:  return 3;
+                case ElemType::Vec4:  return 4;
+                case ElemType::Mat3:  return 9;
+                case ElemType::Mat4:  return 16;
+                default:              return 0;
+                }
+            }
+
+            static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 must be tightly packed");
+            static_assert(sizeof(Mat4) == 16 * sizeof(float), "Mat4 must be tightly packed");
+
+            // Calls fn(T{}) with T the C++ element type of a float-backed
+            // ElemType.
+            template <typename Fn>
+            void withFloatType(ElemType type, Fn &&fn)
+            {
+                switch (type)
+                {
+                case ElemType::Float: fn(float{}); break;
+                case ElemType::Vec2:  fn(Vec2{}); break;
+                case ElemType::Vec3:  fn(Vec3{}); break;
+                case ElemType::Vec4:  fn(Vec4{}); break;
+                case ElemType::Mat3:  fn(Mat3{}); break;
+                case ElemType::Mat4:  fn(Mat4{}); break;
+                default: break;
+                }
+            }
+
+            uint64_t zigzag(int64_t v)
+            {
+                return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+            }
+            int64_t unzigzag(uint64_t v)
+            {
+                return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+            }
+
+            struct ByteWriter
+            {
+                std::vector<uint8_t> &out;
+
+                void u8(uint8_t v) { out.push_back(v); }
+                void varint(uint64_t v)
+                {
+                    while (v >= 0x80)
+                    {
+                        out.push_back(static_cast<uint8_t>(v | 0x80));
+                        v >>= 7;
+                    }
+                    out.push_back(static_cast<uint8_t>(v));
+                }
+                void svarint(int64_t v) { varint(zigzag(v)); }
+                void bytes(const void *data, size_t n)
+                {
+                    const auto *p = static_cast<const uint8_t *>(data);
+                    out.insert(out.end(), p, p + n);
+                }
+                template <typename T>
+                void pod(const T &v) { bytes(&v, sizeof(T)); }
+                void str(const std::string &s)
+                {
+                    varint(s.size());
+                    bytes(s.data(), s.size());
+                }
+            };
+
+            // Bounds-checked reader. Any overrun latches `ok = false` and
+            // returns zeros; callers check `ok` once at the end.
+            struct ByteReader
+            {
+                const uint8_t *p = nullptr;
+                const uint8_t *end = nullptr;
+                bool ok = true;
+
+                uint8_t u8()
+                {
+                    if (p >= end) { ok = false; return 0; }
+                    return *p++;
+                }
+                uint64_t varint()
+                {
+                    uint64_t v = 0;
+                    for (int shift = 0; shift < 64; shift += 7)
+                    {
+                        if (p >= end) { ok = false; return 0; }
+                        const uint8_t b = *p++;
+                        v |= static_cast<uint64_t>(b & 0x7f) << shift;
+                        if (!(b & 0x80)) return v;
+                    }
+                    ok = false;
+                    return 0;
+                }
+                int64_t svarint() { return unzigzag(varint()); }
+                void bytes(void *dst, size_t n)
+                {
+                    if (static_cast<size_t>(end - p) < n) { ok = false; std::memset(dst, 0, n); return; }
+                    std::memcpy(dst, p, n);
+                    p += n;
+                }
+                template <typename T>
+                T pod()
+                {
+                    T v{};
+                    bytes(&v, sizeof(T));
+                    return v;
+                }
+                std::string str()
+                {
+                    const uint64_t n = varint();
+                    if (!ok || static_cast<uint64_t>(end - p) < n) { ok = false; return {}; }
+                    std::string s(reinterpret_cast<const char *>(p), static_cast<size_t>(n));
+                    p += n;
+                    return s;
+                }
+            };
+
+            AttributeTable &tableOf(Geometry &g, size_t cls)
+            {
+                switch (cls)
+                {
+                case 0: return g.points();
+                case 1: return g.vertices();
+                case 2: return g.primitives();
+                default: return g.detail();
+                }
+            }
+            const AttributeTable &tableOf(const Geometry &g, size_t cls)
+            {
+                switch (cls)
+                {
+                case 0: return g.points();
+                case 1: return g.vertices();
+                case 2: return g.primitives();
+                default: return g.detail();
+                }
+            }
+
+            // What the frame would cost held as a plain SimState. Used only
+            // for the compression-ratio report.
+            size_t rawByteSize(const SimState &s)
+            {
+                size_t bytes = sizeof(SimState);
+                for (size_t cls = 0; cls < 4; ++cls)
+                {
+                    const AttributeTable &t = tableOf(s.geometry, cls);
+                    for (const auto &name : t.names())
+                    {
+                        const AttributeBase *attr = t.find(name);
+                        const ElemType type = elemTypeOf(*attr);
+                        if (type == ElemType::Int) bytes += attr->size() * sizeof(int);
+                        else if (type == ElemType::String)
+                        {
+                            for (const auto &str : static_cast<const Attribute<std::string> *>(attr)->data())
+                                bytes += sizeof(std::string) + str.size();
+                        }
+                        else bytes += attr->size() * floatComponents(type) * sizeof(float);
+                    }
+                }
+                bytes += s.geometry.vertexToPoint().size() * sizeof(uint32_t);
+                bytes += s.geometry.primitivesList().size() * sizeof(GeoPrimitive);
+                return bytes;
+            }
+
+            // Match each element of the current table to an element one frame
+            // back: by `id` when both frames carry ids, by index when neither
+            // does, not at all otherwise. -1 means "no history".
+            std::vector<int32_t> matchElements(size_t n,
+                                               bool hasIds,
+                                               const std::vector<int32_t> &ids,
+                                               bool prevHasIds,
+                                               const std::vector<int32_t> &prevIds,
+                                               size_t prevSize)
+            {
+                std::vector<int32_t> ref(n, -1);
+                if (prevSize == 0) return ref;
+                if (!hasIds && !prevHasIds)
+                {
+                    const size_t m = std::min(n, prevSize);
+                    for (size_t i = 0; i < m; ++i) ref[i] = static_cast<int32_t>(i);
+                    return ref;
+                }
+                if (!hasIds || !prevHasIds) return ref;
+
+                // pop_source hands out ids in increasing order and kills
+                // compact in place, so the previous frame's ids are nearly
+                // always sorted — binary search then, hash map otherwise.
+                if (std::is_sorted(prevIds.begin(), prevIds.end()))
+                {
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        auto it = std::lower_bound(prevIds.begin(), prevIds.end(), ids[i]);
+                        if (it != prevIds.end() && *it == ids[i])
+                            ref[i] = static_cast<int32_t>(it - prevIds.begin());
+                    }
+                }
+                else
+                {
+                    std::unordered_map<int32_t, int32_t> byId;
+                    byId.reserve(prevIds.size());
+                    for (size_t j = 0; j < prevIds.size(); ++j)
+                        byId.emplace(prevIds[j], static_cast<int32_t>(j));
+                    for (size_t i = 0; i < n; ++i)
+                    {
+                        auto it = byId.find(ids[i]);
+                        if (it != byId.end()) ref[i] = it->second;
+                    }
+                }
+                return ref;
+            }
+
+            // Shared predictor for the quantised coder: linear extrapolation
+            // through the last two frames, else the last frame, else the
+            // previous element of this frame.
+            struct Predictor
+            {
+                const std::vector<int32_t> &ref;
+                const std::vector<int32_t> &prevRef;
+                const std::vector<int64_t> *q1;
+                const std::vector<int64_t> *q2;
+                uint32_t components;
+
+                int64_t operator()(const std::vector<int64_t> &q, size_t i, uint32_t c) const
+                {
+                    const int32_t r1 = ref[i];
+                    if (q1 && r1 >= 0)
+                    {
+                        const int64_t a = (*q1)[static_cast<size_t>(r1) * components + c];
+                        const int32_t r2 = static_cast<size_t>(r1) < prevRef.size() ? prevRef[r1] : -1;
+                        if (q2 && r2 >= 0)
+                            return 2 * a - (*q2)[static_cast<size_t>(r2) * components + c];
+                        return a;
+                    }
+                    return i > 0 ? q[(i - 1) * components + c] : 0;
+                }
+            };
+
+            void writeIntDelta(ByteWriter &w, const int32_t *v, size_t n)
+            {
+                int64_t prev = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    w.svarint(static_cast<int64_t>(v[i]) - prev);
+                    prev = v[i];
+                }
+            }
+            void readIntDelta(ByteReader &r, int32_t *v, size_t n)
+            {
+                int64_t prev = 0;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    prev += r.svarint();
+                    v[i] = static_cast<int32_t>(prev);
+                }
+            }
+        }
+
+        std::filesystem::path FrameCacheConfig::defaultSpillDirectory()
+        {
+            std::error_code ec;
+            const auto tmp = std::filesystem::temp_directory_path(ec);
+            if (ec) return {};
+            return tmp / "tracey_dop_cache";
+        }
+
+        float FrameCacheConfig::quantumFor(const std::string &name) const
+        {
+            const auto it = attributeQuanta.find(name);
+            if (it != attributeQuanta.end()) return std::max(it->second, 0.0f);
+            return name == "P" || name == "v" ? std::max(quantum, 0.0f) : 0.0f;
+        }
+
+        bool FrameCacheConfig::lossy() const
+        {
+            return quantum > 0.0f ||
+                   std::any_of(attributeQuanta.begin(), attributeQuanta.end(),
+                               [](const auto &q) { return q.second > 0.0f; });
+        }
+
+        // Predictor state. Tables are indexed by AttributeClass; attribute
+        // histories are keyed by name within a table.
+        struct FrameCodecState
+        {
+            struct AttributeHistory
+            {
+                uint8_t type = 0;
+                std::vector<int64_t> q1; // quantised values, one frame back
+                std::vector<int64_t> q2; // two frames back
+            };
+            struct TableHistory
+            {
+                size_t size = 0;
+                bool hasIds = false;
+                std::vector<int32_t> ids;     // one frame back
+                std::vector<int32_t> prevRef; // one-back element -> two-back element
+                std::unordered_map<std::string, AttributeHistory> attributes;
+            };
+
+            TableHistory tables[4];
+
+            void reset()
+            {
+                for (auto &t : tables) t = TableHistory{};
+            }
+        };
+
+        FrameCache::FrameCache(FrameCacheConfig config)
+            : m_config(std::move(config)),
+              m_encodeChain(std::make_unique<FrameCodecState>()),
+              m_decodeChain(std::make_unique<FrameCodecState>())
+        {
+            m_baseline.header.frame = 0;
+            static std::atomic<uint64_t> s_instance{0};
+            const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+            m_spillTag = std::to_string(static_cast<uint64_t>(now)) + "_" + std::to_string(s_instance++);
+        }
+
+        FrameCache::~FrameCache()
+        {
+            removeSpillFiles();
+        }
+
+        void FrameCache::setConfig(FrameCacheConfig config)
+        {
+            clear();
+            m_config = std::move(config);
+        }
+
+        void FrameCache::clear()
+        {
+            removeSpillFiles();
+            m_entries.clear();
+            m_tail.reset();
+            m_checkpoints.clear();
+            m_hot.clear();
+            m_encodeChain->reset();
+            m_decodeChain->reset();
+            m_decodeChainFrame = -1;
+            m_stats = FrameCacheStats{};
+        }
+
+        void FrameCache::checkpoint()
+        {
+            const int frameIdx = lastFrame();
+            if (frameIdx == 0 || !m_config.lossy() || m_checkpoints.contains(frameIdx)) return;
+            m_stats.checkpointBytes += rawByteSize(*m_tail);
+            m_checkpoints.emplace(frameIdx, *m_tail);
+        }
+
+        int FrameCache::truncate(int lastKept)
+        {
+            if (lastKept >= lastFrame()) return lastFrame();
+            if (m_config.lossy())
+            {
+                auto it = m_checkpoints.upper_bound(lastKept);
+                lastKept = it == m_checkpoints.begin() ? 0 : std::prev(it)->first;
+            }
+            if (lastKept <= 0)
+            {
+                clear();
+                return 0;
+            }
+
+            // Decode the new tail from scratch so m_decodeChain ends up
+            // holding exactly the predictor state of frame `lastKept`.
+            m_hot.clear();
+            m_decodeChainFrame = -1;
+            const SimState *kept = get(lastKept);
+            if (!kept)
+            {
+                clear();
+                return 0;
+            }
+            auto checkpointIt = m_checkpoints.find(lastKept);
+            auto tail = std::make_unique<SimState>(checkpointIt != m_checkpoints.end() ? checkpointIt->second
+                                                                                       : *kept);
+            *m_encodeChain = *m_decodeChain;
+            m_hot.clear();
+
+            for (auto it = m_checkpoints.upper_bound(lastKept); it != m_checkpoints.end();)
+            {
+                m_stats.checkpointBytes -= rawByteSize(it->second);
+                it = m_checkpoints.erase(it);
+            }
+            for (int f = lastFrame(); f > lastKept; --f)
+            {
+                const Entry &e = m_entries[f - 1];
+                if (e.spilled)
+                {
+                    std::error_code ec;
+                    std::filesystem::remove(spillPath(f), ec);
+                    m_stats.spilledFrames -= 1;
+                }
+                else
+                {
+                    m_stats.residentBytes -= e.encodedBytes;
+                }
+                m_stats.frames -= 1;
+                m_stats.rawBytes -= e.rawBytes;
+                m_stats.encodedBytes -= e.encodedBytes;
+                m_entries.pop_back();
+            }
+            m_tail = std::move(tail);
+            return lastKept;
+        }
+
+        const SimState &FrameCache::back() const
+        {
+            return m_tail ? *m_tail : m_baseline;
+        }
+
+        bool FrameCache::isKeyframe(int frameIdx) const
+        {
+            const int interval = std::max(1, m_config.keyframeInterval);
+            return (frameIdx - 1) % interval == 0;
+        }
+
+        std::filesystem::path FrameCache::spillPath(int frameIdx) const
+        {
+            return m_config.spillDirectory /
+                   ("dop_" + m_spillTag + "_" + std::to_string(frameIdx) + ".tdfc");
+        }
+
+        // ── Table codec ────────────────────────────────────────────────────
+        //
+        // Per table:
+        //   varint size, u8 hasIds, varint attributeCount, then per attribute
+        //   str name, u8 ElemType, varint generation, default value,
+        //   u8 Encoding, payload (a Quantised payload leads with its float
+        //   step). When hasIds is set the first attribute is
+        //   the int `id`, so the decoder can match elements before it reaches
+        //   any quantised attribute.
+
+        namespace
+        {
+            using TableHistory = FrameCodecState::TableHistory;
+            using AttributeHistory = FrameCodecState::AttributeHistory;
+
+            void encodeTable(const AttributeTable &t,
+                             TableHistory &h,
+                             const FrameCacheConfig &config,
+                             ByteWriter &w)
+            {
+                const size_t n = t.size();
+                const auto *idAttr = t.get(kAttrId);
+                const bool hasIds = idAttr != nullptr;
+                std::vector<int32_t> ids;
+                if (hasIds) ids.assign(idAttr->data().begin(), idAttr->data().end());
+
+                const std::vector<int32_t> ref =
+                    matchElements(n, hasIds, ids, h.hasIds, h.ids, h.size);
+
+                std::vector<std::string> names = t.names();
+                std::sort(names.begin(), names.end());
+                if (hasIds)
+                {
+                    names.erase(std::find(names.begin(), names.end(), "id"));
+                    names.insert(names.begin(), "id");
+                }
+
+                w.varint(n);
+                w.u8(hasIds ? 1 : 0);
+                w.varint(names.size());
+
+                std::unordered_map<std::string, AttributeHistory> nextAttrs;
+                for (const auto &name : names)
+                {
+                    const AttributeBase *attr = t.find(name);
+                    const ElemType type = elemTypeOf(*attr);
+                    w.str(name);
+                    w.u8(static_cast<uint8_t>(type));
+                    w.varint(attr->generation());
+
+                    if (type == ElemType::Int)
+                    {
+                        const auto *a = static_cast<const Attribute<int> *>(attr);
+                        w.pod(a->defaultValue());
+                        w.u8(static_cast<uint8_t>(Encoding::IntDelta));
+                        writeIntDelta(w, a->data().data(), n);
+                        continue;
+                    }
+                    if (type == ElemType::String)
+                    {
+                        const auto *a = static_cast<const Attribute<std::string> *>(attr);
+                        w.str(a->defaultValue());
+                        w.u8(static_cast<uint8_t>(Encoding::Raw));
+                        for (const auto &s : a->data()) w.str(s);
+                        continue;
+                    }
+                    if (type == ElemType::Unknown)
+                    {
+                        // Not one of the serialisable element types — the
+                        // decoder skips it, same as save_scene would.
+                        w.u8(static_cast<uint8_t>(Encoding::Raw));
+                        continue;
+                    }
+
+                    const uint32_t C = floatComponents(type);
+                    const float *f = nullptr;
+                    withFloatType(type, [&](auto tag) {
+                        using T = decltype(tag);
+                        const auto *a = static_cast<const Attribute<T> *>(attr);
+                        w.pod(a->defaultValue());
+                        f = reinterpret_cast<const float *>(a->data().data());
+                    });
+
+                    const size_t count = n * C;
+                    std::vector<int64_t> q;
+                    const float quantum = config.quantumFor(name);
+                    bool quantised = quantum > 0.0f;
+                    if (quantised)
+                    {
+                        q.resize(count);
+                        const double inv = 1.0 / static_cast<double>(quantum);
+                        for (size_t k = 0; k < count; ++k)
+                        {
+                            const double v = static_cast<double>(f[k]) * inv;
+                            if (!std::isfinite(v) || std::abs(v) > kMaxQuantised)
+                            {
+                                quantised = false;
+                                break;
+                            }
+                            q[k] = std::llround(v);
+                        }
+                    }
+                    if (!quantised)
+                    {
+                        // Lossless attributes, or non-finite / out-of-range
+                        // values: store verbatim and drop this attribute's
+                        // history so the next quantised frame predicts
+                        // spatially.
+                        w.u8(static_cast<uint8_t>(Encoding::Raw));
+                        w.bytes(f, count * sizeof(float));
+                        continue;
+                    }
+
+                    const auto hit = h.attributes.find(name);
+                    const AttributeHistory *hist =
+                        (hit != h.attributes.end() && hit->second.type == static_cast<uint8_t>(type) &&
+                         !hit->second.q1.empty())
+                            ? &hit->second
+                            : nullptr;
+                    const Predictor predict{ref, h.prevRef,
+                                            hist ? &hist->q1 : nullptr,
+                                            hist && !hist->q2.empty() ? &hist->q2 : nullptr,
+                                            C};
+
+                    w.u8(static_cast<uint8_t>(Encoding::Quantised));
+                    w.pod(quantum);
+                    for (size_t i = 0; i < n; ++i)
+                        for (uint32_t c = 0; c < C; ++c)
+                            w.svarint(q[i * C + c] - predict(q, i, c));
+
+                    AttributeHistory next;
+                    next.type = static_cast<uint8_t>(type);
+                    if (hist) next.q2 = std::move(hit->second.q1);
+                    next.q1 = std::move(q);
+                    nextAttrs.emplace(name, std::move(next));
+                }
+
+                h.size = n;
+                h.hasIds = hasIds;
+                h.ids = std::move(ids);
+                h.prevRef = ref;
+                h.attributes = std::move(nextAttrs);
+            }
+
+            // Mirror of encodeTable. `out` may be null when the frame is only
+            // being walked to advance predictor state towards a later frame.
+            bool decodeTable(ByteReader &r,
+                             TableHistory &h,
+                             AttributeTable *out)
+            {
+                const size_t n = static_cast<size_t>(r.varint());
+                const bool hasIds = r.u8() != 0;
+                const size_t attrCount = static_cast<size_t>(r.varint());
+                if (!r.ok) return false;
+                if (out) out->resize(n);
+
+                std::vector<int32_t> ids;
+                std::vector<int32_t> ref;
+                bool matched = false;
+                auto ensureMatched = [&] {
+                    if (matched) return;
+                    ref = matchElements(n, hasIds, ids, h.hasIds, h.ids, h.size);
+                    matched = true;
+                };
+
+                std::unordered_map<std::string, AttributeHistory> nextAttrs;
+                for (size_t ai = 0; ai < attrCount && r.ok; ++ai)
+                {
+                    const std::string name = r.str();
+                    const ElemType type = static_cast<ElemType>(r.u8());
+                    const uint64_t generation = r.varint();
+
+                    if (type == ElemType::Int)
+                    {
+                        const int def = r.pod<int>();
+                        const auto enc = static_cast<Encoding>(r.u8());
+                        if (enc != Encoding::IntDelta) return false;
+                        std::vector<int32_t> values(n);
+                        readIntDelta(r, values.data(), n);
+                        if (out)
+                        {
+                            auto *a = out->add<int>(name, def);
+                            std::copy(values.begin(), values.end(), a->data().begin());
+                            a->restoreGeneration(generation);
+                        }
+                        if (ai == 0 && hasIds) ids = std::move(values);
+                        continue;
+                    }
+
+                    ensureMatched();
+
+                    if (type == ElemType::String)
+                    {
+                        std::string def = r.str();
+                        r.u8();
+                        std::vector<std::string> values(n);
+                        for (auto &s : values) s = r.str();
+                        if (out)
+                        {
+                            auto *a = out->add<std::string>(name, std::move(def));
+                            a->data() = std::move(values);
+                            a->restoreGeneration(generation);
+                        }
+                        continue;
+                    }
+                    if (type == ElemType::Unknown)
+                    {
+                        r.u8();
+                        continue;
+                    }
+                    const uint32_t C = floatComponents(type);
+                    if (C == 0) return false;
+
+                    float *f = nullptr;
+                    std::vector<float> scratch;
+                    AttributeBase *made = nullptr;
+                    withFloatType(type, [&](auto tag) {
+                        using T = decltype(tag);
+                        const T def = r.pod<T>();
+                        if (out)
+                        {
+                            auto *a = out->add<T>(name, def);
+                            f = reinterpret_cast<float *>(a->data().data());
+                            made = a;
+                        }
+                    });
+                    const size_t count = n * C;
+                    if (!f)
+                    {
+                        scratch.resize(count);
+                        f = scratch.data();
+                    }
+
+                    const auto enc = static_cast<Encoding>(r.u8());
+                    if (enc == Encoding::Raw)
+                    {
+                        r.bytes(f, count * sizeof(float));
+                    }
+                    else if (enc == Encoding::Quantised)
+                    {
+                        const float quantum = r.pod<float>();
+                        const auto hit = h.attributes.find(name);
+                        const AttributeHistory *hist =
+                            (hit != h.attributes.end() && hit->second.type == static_cast<uint8_t>(type) &&
+                             !hit->second.q1.empty())
+                                ? &hit->second
+                                : nullptr;
+                        const Predictor predict{ref, h.prevRef,
+                                                hist ? &hist->q1 : nullptr,
+                                                hist && !hist->q2.empty() ? &hist->q2 : nullptr,
+                                                C};
+                        std::vector<int64_t> q(count);
+                        for (size_t i = 0; i < n; ++i)
+                            for (uint32_t c = 0; c < C; ++c)
+                                q[i * C + c] = predict(q, i, c) + r.svarint();
+                        const double step = static_cast<double>(quantum);
+                        for (size_t k = 0; k < count; ++k)
+                            f[k] = static_cast<float>(static_cast<double>(q[k]) * step);
+
+                        AttributeHistory next;
+                        next.type = static_cast<uint8_t>(type);
+                        if (hist) next.q2 = std::move(hit->second.q1);
+                        next.q1 = std::move(q);
+                        nextAttrs.emplace(name, std::move(next));
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                    if (made) made->restoreGeneration(generation);
+                }
+                if (!r.ok) return false;
+                ensureMatched();
+
+                h.size = n;
+                h.hasIds = hasIds;
+                h.ids = std::move(ids);
+                h.prevRef = std::move(ref);
+                h.attributes = std::move(nextAttrs);
+                return true;
+            }
+        }
+
+        void FrameCache::push(SimState state)
+        {
+            const int frameIdx = lastFrame() + 1;
+            const auto t0 = std::chrono::steady_clock::now();
+
+            Entry entry;
+            entry.keyframe = isKeyframe(frameIdx);
+            entry.rawBytes = rawByteSize(state);
+            if (entry.keyframe) m_encodeChain->reset();
+
+            ByteWriter w{entry.blob};
+            w.pod(kSpillMagic);
+            w.pod(kSpillVersion);
+            w.u8(entry.keyframe ? 1 : 0);
+            w.pod(state.header);
+            for (size_t cls = 0; cls < 4; ++cls)
+            {
+                encodeTable(
+                    tableOf(state.geometry, cls), m_encodeChain->tables[cls], m_config, w);
+            }
+            const auto &v2p = state.geometry.vertexToPoint();
+            w.varint(v2p.size());
+            writeIntDelta(w, reinterpret_cast<const int32_t *>(v2p.data()), v2p.size());
+            const auto &prims = state.geometry.primitivesList();
+            w.varint(prims.size());
+            uint32_t expectedFirst = 0;
+            for (const auto &p : prims)
+            {
+                w.svarint(static_cast<int64_t>(p.firstVertex) - expectedFirst);
+                w.varint(p.vertexCount);
+                expectedFirst = p.firstVertex + p.vertexCount;
+            }
+            entry.blob.shrink_to_fit();
+            entry.encodedBytes = entry.blob.size();
+            entry.lastUse = ++m_useClock;
+
+            m_stats.frames += 1;
+            m_stats.rawBytes += entry.rawBytes;
+            m_stats.encodedBytes += entry.encodedBytes;
+            m_stats.residentBytes += entry.encodedBytes;
+            m_stats.encodeSeconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+            m_entries.push_back(std::move(entry));
+            m_tail = std::make_unique<SimState>(std::move(state));
+            enforceBudget();
+        }
+
+        // ── Spill / reload ─────────────────────────────────────────────────
+
+        void FrameCache::enforceBudget()
+        {
+            if (m_config.spillDirectory.empty()) return;
+            while (m_stats.residentBytes > m_config.memoryBudgetBytes)
+            {
+                // Least recently used resident frame; the newest frame is
+                // never a candidate (it was just touched by push()).
+                int victim = -1;
+                uint64_t oldest = UINT64_MAX;
+                for (size_t i = 0; i + 1 < m_entries.size(); ++i)
+                {
+                    const Entry &e = m_entries[i];
+                    if (e.spilled || e.lastUse >= oldest) continue;
+                    oldest = e.lastUse;
+                    victim = static_cast<int>(i) + 1;
+                }
+                if (victim < 0 || !spill(victim)) return;
+            }
+        }
+
+        bool FrameCache::spill(int frameIdx)
+        {
+            Entry &e = m_entries[frameIdx - 1];
+            std::error_code ec;
+            std::filesystem::create_directories(m_config.spillDirectory, ec);
+            const auto path = spillPath(frameIdx);
+            std::ofstream f(path, std::ios::binary | std::ios::trunc);
+            if (f) f.write(reinterpret_cast<const char *>(e.blob.data()),
+                           static_cast<std::streamsize>(e.blob.size()));
+            if (!f)
+            {
+                // Keep the frame in memory and stop spilling; the budget is
+                // exceeded but nothing is lost.
+                std::cerr << "DopGraph: frame cache could not spill to "
+                          << path.string() << "; keeping frames in memory\n";
+                m_config.spillDirectory.clear();
+                return false;
+            }
+            e.blob.clear();
+            e.blob.shrink_to_fit();
+            e.spilled = true;
+            m_stats.residentBytes -= e.encodedBytes;
+            m_stats.spilledFrames += 1;
+            return true;
+        }
+
+        bool FrameCache::reload(int frameIdx)
+        {
+            Entry &e = m_entries[frameIdx - 1];
+            if (!e.spilled) return true;
+            const auto path = spillPath(frameIdx);
+            std::ifstream f(path, std::ios::binary);
+            std::vector<uint8_t> blob(e.encodedBytes);
+            if (f) f.read(reinterpret_cast<char *>(blob.data()), static_cast<std::streamsize>(blob.size()));
+            if (!f)
+            {
+                std::cerr << "DopGraph: frame cache could not reload " << path.string() << "\n";
+                return false;
+            }
+            e.blob = std::move(blob);
+            e.spilled = false;
+            m_stats.residentBytes += e.encodedBytes;
+            m_stats.spilledFrames -= 1;
+            m_stats.diskLoads += 1;
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            return true;
+        }
+
+        void FrameCache::removeSpillFiles()
+        {
+            for (size_t i = 0; i < m_entries.size(); ++i)
+            {
+                if (!m_entries[i].spilled) continue;
+                std::error_code ec;
+                std::filesystem::remove(spillPath(static_cast<int>(i) + 1), ec);
+            }
+        }
+
+        // ── Decode ─────────────────────────────────────────────────────────
+
+        const SimState *FrameCache::get(int frameIdx)
+        {
+            if (frameIdx < 0 || frameIdx > lastFrame()) return nullptr;
+            if (frameIdx == 0) return &m_baseline;
+            if (frameIdx == lastFrame()) return m_tail.get();
+
+            for (auto &h : m_hot)
+            {
+                if (h.frame != frameIdx) continue;
+                h.lastUse = ++m_useClock;
+                return h.state.get();
+            }
+
+            const auto t0 = std::chrono::steady_clock::now();
+
+            // Resume from the last decode when it sits between the nearest
+            // keyframe and the target; otherwise restart at the keyframe.
+            const int interval = std::max(1, m_config.keyframeInterval);
+            const int keyframe = frameIdx - ((frameIdx - 1) % interval);
+            int from = keyframe;
+            if (m_decodeChainFrame >= keyframe && m_decodeChainFrame < frameIdx)
+                from = m_decodeChainFrame + 1;
+
+            auto decoded = std::make_unique<SimState>();
+            for (int f = from; f <= frameIdx; ++f)
+            {
+                if (!reload(f)) { m_decodeChainFrame = -1; return nullptr; }
+                Entry &e = m_entries[f - 1];
+                e.lastUse = ++m_useClock;
+                if (e.keyframe) m_decodeChain->reset();
+
+                SimState *out = (f == frameIdx) ? decoded.get() : nullptr;
+                ByteReader r{e.blob.data(), e.blob.data() + e.blob.size()};
+                const bool headerOk = r.pod<uint32_t>() == kSpillMagic &&
+                                      r.pod<uint32_t>() == kSpillVersion;
+                r.u8();
+                const SimHeader header = r.pod<SimHeader>();
+                bool ok = headerOk && r.ok;
+                for (size_t cls = 0; cls < 4 && ok; ++cls)
+                {
+                    ok = decodeTable(
+                        r, m_decodeChain->tables[cls],
+                        out ? &tableOf(out->geometry, cls) : nullptr);
+                }
+                std::vector<uint32_t> v2p(static_cast<size_t>(r.varint()));
+                readIntDelta(r, reinterpret_cast<int32_t *>(v2p.data()), v2p.size());
+                std::vector<GeoPrimitive> prims(static_cast<size_t>(r.varint()));
+                uint32_t expectedFirst = 0;
+                for (auto &p : prims)
+                {
+                    p.firstVertex = static_cast<uint32_t>(expectedFirst + r.svarint());
+                    p.vertexCount = static_cast<uint32_t>(r.varint());
+                    expectedFirst = p.firstVertex + p.vertexCount;
+                }
+                if (!ok || !r.ok)
+                {
+                    std::cerr << "DopGraph: frame cache entry " << f << " is corrupt\n";
+                    m_decodeChainFrame = -1;
+                    return nullptr;
+                }
+                m_decodeChainFrame = f;
+                if (out)
+                {
+                    out->header = header;
+                    out->geometry.vertexToPoint() = std::move(v2p);
+                    out->geometry.primitivesList() = std::move(prims);
+                }
+            }
+            // Reloads may have pushed resident bytes back over budget.
+            enforceBudget();
+
+            m_stats.decodedFrames += 1;
+            m_stats.decodeSeconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+            const size_t capacity = std::max<size_t>(1, m_config.hotFrames);
+            if (m_hot.size() >= capacity)
+            {
+                auto lru = std::min_element(m_hot.begin(), m_hot.end(),
+                                            [](const HotFrame &a, const HotFrame &b) { return a.lastUse < b.lastUse; });
+                m_hot.erase(lru);
+            }
+            m_hot.push_back({frameIdx, ++m_useClock, std::move(decoded)});
+            return m_hot.back().state.get();
+        }
+    }
+}
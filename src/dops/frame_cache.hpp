@@ -0,0 +1,223 @@
+#pragma once
+
+#include "sim_state.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tracey
+{
+    namespace dops
+    {
+        // Predictor state threaded through an encode or decode walk;
+        // defined in frame_cache.cpp.
+        struct FrameCodecState;
+
+        // Tuning knobs for DopGraph's frame cache.
+        //
+        //   quantum           — world-space step the positional attributes
+        //                       (P, and v in units per second) are
+        //                       quantised to before delta coding. 1e-4 is
+        //                       0.1 mm at metre scale: well under anything
+        //                       the viewport or a render can resolve. 0
+        //                       stores them losslessly.
+        //   attributeQuanta   — per-attribute-name steps, overriding
+        //                       `quantum` for P / v and opting any other
+        //                       float-backed attribute into quantisation.
+        //                       The step is absolute, in the attribute's
+        //                       own units; 0 means lossless. Float
+        //                       attributes not named here (pscale, mass,
+        //                       density, age, Cd, ...) are stored verbatim,
+        //                       since no one step suits all their scales.
+        //   keyframeInterval  — every Nth frame is coded without reference
+        //                       to earlier frames, bounding how far back a
+        //                       random scrub has to decode.
+        //   memoryBudgetBytes — encoded bytes kept resident before cold
+        //                       frames spill to `spillDirectory`.
+        //   spillDirectory    — where spilled frames go. Empty disables
+        //                       spilling (the budget is then advisory).
+        //   hotFrames         — decoded frames kept around so repeated
+        //                       frame() calls on the same few frames (the
+        //                       playhead plus a dop_import or two) don't
+        //                       re-decode.
+        struct FrameCacheConfig
+        {
+            float quantum = 1e-4f;
+            std::map<std::string, float> attributeQuanta;
+            int keyframeInterval = 16;
+            size_t memoryBudgetBytes = size_t(512) << 20;
+            std::filesystem::path spillDirectory = defaultSpillDirectory();
+            size_t hotFrames = 4;
+
+            // <system temp>/tracey_dop_cache, or empty when the platform
+            // has no temp directory. Created lazily on the first spill.
+            static std::filesystem::path defaultSpillDirectory();
+
+            // Quantisation step for the named attribute; 0 when it is
+            // stored losslessly.
+            float quantumFor(const std::string &name) const;
+            // True when any attribute may be quantised, i.e. decoded
+            // frames can differ from the cooked ones.
+            bool lossy() const;
+        };
+
+        // Running totals since the last clear(). `rawBytes` is what the
+        // cached frames would cost as plain SimStates; the ratio against
+        // `encodedBytes` is what the editor / dop_smoke report.
+        struct FrameCacheStats
+        {
+            size_t frames = 0;
+            size_t rawBytes = 0;
+            size_t encodedBytes = 0;
+            size_t residentBytes = 0;
+            size_t spilledFrames = 0;
+            // Exact frames held by checkpoint(), in raw SimState bytes.
+            size_t checkpointBytes = 0;
+            size_t decodedFrames = 0;
+            size_t diskLoads = 0;
+            double encodeSeconds = 0.0;
+            double decodeSeconds = 0.0;
+
+            double ratio() const
+            {
+                return encodedBytes ? static_cast<double>(rawBytes) / static_cast<double>(encodedBytes)
+                                    : 1.0;
+            }
+        };
+
+        // Compressed per-frame SimState store backing DopGraph.
+        //
+        // Every pushed frame is encoded immediately, attribute by attribute:
+        //   • float / vector / matrix attributes with a step (quantumFor())
+        //     are quantised to it and coded as
+        //     zig-zag varint residuals against a prediction. Between
+        //     keyframes the prediction is temporal — the same element one
+        //     frame back, or the linear extrapolation through the last two
+        //     frames when both exist (ballistic particles then cost a byte
+        //     or two per component). Elements are matched across frames by
+        //     their int `id` attribute when the table carries one, so
+        //     births and deaths don't shift every residual; by index
+        //     otherwise. Elements with no history predict from their
+        //     neighbour in the same frame.
+        //   • the other float-backed attributes are stored verbatim.
+        //   • int attributes (ids, flags) are delta-coded against the
+        //     previous element — sequential ids collapse to one byte each.
+        //   • vertexToPoint / primitivesList go through the same int delta
+        //     coder; strings are stored raw.
+        // Attribute generations are recorded and restored on decode so
+        // generation-keyed consumers see the same values as the cook.
+        //
+        // Only the newest frame is kept as a plain SimState (it's the
+        // `prev` the next cook reads, and must be bit-exact). Every other
+        // frame lives as an encoded blob, decoded on demand into a small
+        // LRU of hot frames. When resident blobs exceed the memory budget
+        // the least recently used ones are written to the spill directory
+        // and read back lazily by get().
+        //
+        // Decoding walks forward from the nearest keyframe, reusing the
+        // last decode's predictor state when the request is the next frame
+        // along — sequential playback decodes exactly one frame per step.
+        class FrameCache
+        {
+        public:
+            explicit FrameCache(FrameCacheConfig config = {});
+            ~FrameCache();
+
+            FrameCache(const FrameCache &) = delete;
+            FrameCache &operator=(const FrameCache &) = delete;
+
+            // Replaces the config and clears the cache — frames encoded
+            // under different steps can't share predictor state.
+            void setConfig(FrameCacheConfig config);
+            const FrameCacheConfig &config() const { return m_config; }
+
+            // Drop every frame but the frame-0 baseline and delete any
+            // spill files this cache wrote.
+            void clear();
+
+            // Keep an exact copy of the newest frame so truncate() can resume
+            // from it as originally cooked. A no-op for the frame-0 baseline
+            // and when the config isn't lossy(), where decoding is exact.
+            void checkpoint();
+
+            // Drop every frame after `lastKept` and make the last remaining
+            // frame the new tail, so the next push() continues from it. A
+            // cook resumed from the tail must see the state originally
+            // cooked, not a quantised decode, or the resumed sim would
+            // depend on where it was last cut. So in a lossy() cache the cut
+            // moves back to the newest checkpoint() at or below `lastKept`
+            // (frame 0 when there is none). Encoding carries on from the
+            // decoder's predictor state, which matches the encoder's at that
+            // frame. Returns the frame actually kept: 0 means cleared, and so
+            // does a kept frame that fails to decode. A `lastKept` at or past
+            // lastFrame() changes nothing.
+            int truncate(int lastKept);
+
+            // Highest cached frame index (0 when only the baseline exists).
+            int lastFrame() const { return static_cast<int>(m_entries.size()); }
+
+            // The newest frame, exact. Valid until the next push/clear.
+            const SimState &back() const;
+
+            // Append frame lastFrame() + 1.
+            void push(SimState state);
+
+            // Cached state for `frameIdx`, or nullptr if out of range (or
+            // a spilled frame failed to reload). The pointer stays valid
+            // until the next push/clear or until `hotFrames` other frames
+            // have been decoded — callers that need it longer copy.
+            const SimState *get(int frameIdx);
+
+            const FrameCacheStats &stats() const { return m_stats; }
+
+        private:
+            struct Entry
+            {
+                std::vector<uint8_t> blob; // empty while spilled
+                size_t encodedBytes = 0;
+                size_t rawBytes = 0;
+                bool keyframe = false;
+                bool spilled = false;
+                uint64_t lastUse = 0;
+            };
+
+            struct HotFrame
+            {
+                int frame = 0;
+                uint64_t lastUse = 0;
+                std::unique_ptr<SimState> state;
+            };
+
+            bool isKeyframe(int frameIdx) const;
+            std::filesystem::path spillPath(int frameIdx) const;
+            void enforceBudget();
+            bool spill(int frameIdx);
+            bool reload(int frameIdx);
+            void removeSpillFiles();
+
+            FrameCacheConfig m_config;
+            FrameCacheStats m_stats;
+
+            SimState m_baseline;
+            std::unique_ptr<SimState> m_tail;
+            // checkpoint()ed frames, exact, by frame index.
+            std::map<int, SimState> m_checkpoints;
+            std::vector<Entry> m_entries; // m_entries[f - 1] is frame f
+
+            std::vector<HotFrame> m_hot;
+            uint64_t m_useClock = 0;
+
+            std::unique_ptr<FrameCodecState> m_encodeChain;
+            std::unique_ptr<FrameCodecState> m_decodeChain;
+            int m_decodeChainFrame = -1; // frame m_decodeChain last advanced past
+
+            // Distinguishes this cache's spill files from other graphs'.
+            std::string m_spillTag;
+        };
+    }
+}
@@ -0,0 +1,105 @@
+#include "neighbor_grid.hpp"
+
+#include "sim_state.hpp"
+
+#include "../core/parallel.hpp"
+#include "../geometry/attribute.hpp"
+#include "../geometry/attribute_table.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace tracey
+{
+    namespace dops
+    {
+        void NeighborGrid::build(const std::vector<Vec3> &positions, float cellSize)
+        {
+            const size_t n = positions.size();
+            m_cellSize = std::max(cellSize, 1e-6f);
+            m_invCellSize = 1.0f / m_cellSize;
+
+            // ~2 slots per point keeps chains short; the floor keeps tiny
+            // sets from degenerating into a single slot.
+            uint32_t slots = 64;
+            while (slots < 2 * n && slots < (1u << 30)) slots <<= 1;
+            m_slotMask = slots - 1;
+
+            m_pointSlot.resize(n);
+            m_sortedIndex.resize(n);
+            m_sortedPos.resize(n);
+            m_slotStart.assign(static_cast<size_t>(slots) + 1, 0);
+
+            // 1 + 2: slot per point and an atomic histogram. The counter
+            // array is reused as the scatter cursor in step 4.
+            std::unique_ptr<std::atomic<uint32_t>[]> counter(new std::atomic<uint32_t>[slots]);
+            for (uint32_t s = 0; s < slots; ++s) counter[s].store(0, std::memory_order_relaxed);
+            tracey::parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const Vec3 &p = positions[i];
+                    const uint32_t slot = slotOf(cellCoord(p.x), cellCoord(p.y), cellCoord(p.z));
+                    m_pointSlot[i] = slot;
+                    counter[slot].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+
+            // 3: exclusive prefix sum. Serial — one add per slot is cheap
+            // next to the per-point passes.
+            for (uint32_t s = 0; s < slots; ++s)
+            {
+                m_slotStart[s + 1] = m_slotStart[s] + counter[s].load(std::memory_order_relaxed);
+                counter[s].store(m_slotStart[s], std::memory_order_relaxed);
+            }
+
+            // 4: scatter. Each point claims the next free entry in its slot.
+            tracey::parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const uint32_t at = counter[m_pointSlot[i]].fetch_add(1, std::memory_order_relaxed);
+                    m_sortedIndex[at] = static_cast<uint32_t>(i);
+                }
+            });
+
+            // 5: restore index order inside each slot, then gather positions.
+            tracey::parallel_for_chunks(slots, [&](size_t begin, size_t end) {
+                for (size_t s = begin; s < end; ++s)
+                {
+                    const uint32_t b = m_slotStart[s];
+                    const uint32_t e = m_slotStart[s + 1];
+                    if (e - b > 1) std::sort(m_sortedIndex.begin() + b, m_sortedIndex.begin() + e);
+                    for (uint32_t k = b; k < e; ++k) m_sortedPos[k] = positions[m_sortedIndex[k]];
+                }
+            });
+        }
+
+        const NeighborGrid &acquireNeighborGrid(SimState &state, float radius)
+        {
+            const float cell = std::max(radius, 1e-6f);
+            const auto *P = std::as_const(state.geometry).points().get<Vec3>("P");
+            const uint64_t generation = P ? P->generation() : 0;
+            const size_t n = P ? P->size() : 0;
+
+            NeighborGrid *grid = state.neighbors.get();
+            if (grid && grid->sourceGeneration() == generation && grid->pointCount() == n &&
+                grid->cellSize() >= cell && grid->cellSize() <= 2.0f * cell)
+            {
+                return *grid;
+            }
+
+            // Copy-on-write: the previous frame (or the frame cache's tail)
+            // may still hold this grid.
+            if (!grid || state.neighbors.use_count() > 1)
+            {
+                state.neighbors = std::make_shared<NeighborGrid>();
+                grid = state.neighbors.get();
+            }
+            static const std::vector<Vec3> kEmpty;
+            grid->build(P ? P->data() : kEmpty, cell);
+            grid->setSourceGeneration(generation);
+            return *grid;
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tracey
+{
+    namespace dops
+    {
+        struct SimState;
+
+        // Uniform-grid / spatial-hash neighbour structure over a particle set.
+        // Point-point POPs (pop_interact, pop_collide) query it instead of the
+        // O(n²) all-pairs loop.
+        //
+        // Build (all passes on the thread pool except the prefix sum):
+        //   1. hash every point's integer cell coordinate into a power-of-two
+        //      slot table sized ~2× the point count,
+        //   2. count points per slot (atomic histogram),
+        //   3. exclusive prefix sum → slot start offsets,
+        //   4. scatter point indices into their slot range (counting sort),
+        //   5. sort each slot's range by index so traversal order — and so
+        //      every force sum over neighbours — is deterministic no matter
+        //      how the scatter raced.
+        // Positions are copied into slot order alongside the indices so a
+        // query walks contiguous memory.
+        //
+        // Queries visit the 3×3×3 block of cells around the query point, so
+        // the search radius must not exceed cellSize(). Two cells of the
+        // block can hash to the same slot; those are visited once. Slots
+        // shared with far-away cells only add candidates the distance test
+        // rejects.
+        class NeighborGrid
+        {
+        public:
+            // Rebuild over `positions` with the given cell edge length.
+            void build(const std::vector<Vec3> &positions, float cellSize);
+
+            float cellSize() const { return m_cellSize; }
+            size_t pointCount() const { return m_sortedIndex.size(); }
+
+            // Calls fn(j, pj, dist2) for every point j with
+            // |pj - p|² <= radius². Includes the query point itself when it
+            // is part of the set — callers skip j == i.
+            template <typename Fn>
+            void forEachNeighbor(const Vec3 &p, float radius, Fn &&fn) const
+            {
+                if (m_sortedIndex.empty()) return;
+                assert(radius <= m_cellSize * 1.0001f);
+                const float r2 = radius * radius;
+                const int cx = cellCoord(p.x);
+                const int cy = cellCoord(p.y);
+                const int cz = cellCoord(p.z);
+
+                uint32_t visited[27];
+                int visitedCount = 0;
+                for (int dz = -1; dz <= 1; ++dz)
+                    for (int dy = -1; dy <= 1; ++dy)
+                        for (int dx = -1; dx <= 1; ++dx)
+                        {
+                            const uint32_t slot = slotOf(cx + dx, cy + dy, cz + dz);
+                            bool seen = false;
+                            for (int k = 0; k < visitedCount; ++k)
+                                if (visited[k] == slot) { seen = true; break; }
+                            if (seen) continue;
+                            visited[visitedCount++] = slot;
+
+                            for (uint32_t s = m_slotStart[slot]; s < m_slotStart[slot + 1]; ++s)
+                            {
+                                const Vec3 &q = m_sortedPos[s];
+                                const float ex = q.x - p.x;
+                                const float ey = q.y - p.y;
+                                const float ez = q.z - p.z;
+                                const float d2 = ex * ex + ey * ey + ez * ez;
+                                if (d2 <= r2) fn(m_sortedIndex[s], q, d2);
+                            }
+                        }
+            }
+
+            // Cache key bookkeeping for acquireNeighborGrid().
+            uint64_t sourceGeneration() const { return m_sourceGeneration; }
+            void setSourceGeneration(uint64_t generation) { m_sourceGeneration = generation; }
+
+        private:
+            int cellCoord(float v) const
+            {
+                // Clamp so far-flung (or NaN) points land in an edge cell
+                // instead of overflowing the int conversion.
+                float c = std::floor(v * m_invCellSize);
+                if (!(c > -1e9f)) c = -1e9f;
+                if (c > 1e9f) c = 1e9f;
+                return static_cast<int>(c);
+            }
+            uint32_t slotOf(int x, int y, int z) const
+            {
+                // Teschner et al. spatial hash primes.
+                const uint32_t h = (static_cast<uint32_t>(x) * 73856093u) ^
+                                   (static_cast<uint32_t>(y) * 19349663u) ^
+                                   (static_cast<uint32_t>(z) * 83492791u);
+                return h & m_slotMask;
+            }
+
+            float m_cellSize = 1.0f;
+            float m_invCellSize = 1.0f;
+            uint32_t m_slotMask = 0;
+            uint64_t m_sourceGeneration = 0;
+
+            std::vector<uint32_t> m_slotStart;   // slotCount + 1 offsets
+            std::vector<uint32_t> m_sortedIndex; // point indices in slot order
+            std::vector<Vec3> m_sortedPos;       // positions in slot order
+            std::vector<uint32_t> m_pointSlot;   // scratch: slot per point
+        };
+
+        // Neighbour grid over `state`'s point P for a search radius of
+        // `radius`, built on first use and shared by every node that asks
+        // within the same substep. A cached grid is reused while P is
+        // unchanged (same attribute generation and point count) and its
+        // cell size covers `radius` without being more than twice as
+        // coarse; otherwise it is rebuilt. The grid rides along when the
+        // SimState is copied, so it is copy-on-write: a grid still shared
+        // with another state is replaced rather than rebuilt in place.
+        //
+        // Nodes reading P alongside a query should do so through a const
+        // reference — a mutable data() access bumps the generation and
+        // forces the next node to rebuild.
+        const NeighborGrid &acquireNeighborGrid(SimState &state, float radius);
+    }
+}
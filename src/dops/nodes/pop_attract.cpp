@@ -43,15 +43,15 @@ namespace tracey
             void prepare(SimState &state) const override
             {
                 Geometry &g = state.geometry;
-                if (!g.points().get<Vec3>("force")) g.points().add<Vec3>("force", Vec3(0.0f));
+                if (!g.points().get(kAttrForce)) g.points().add(kAttrForce, Vec3(0.0f));
             }
 
             void cookFrame(DopEvalContext &ctx) const override
             {
                 if (!ctx.state) return;
                 Geometry &g = ctx.state->geometry;
-                auto *P = g.points().get<Vec3>("P");
-                auto *F = g.points().get<Vec3>("force");
+                auto *P = g.points().get(kAttrP);
+                auto *F = g.points().get(kAttrForce);
                 if (!P || !F) return;
                 const Vec3  tgt  = paramVec3 ("target",   Vec3(0.0f));
                 const float k    = paramFloat("strength", 1.0f);
@@ -0,0 +1,155 @@
+// pop_collide — particle-particle collisions. Particles are spheres of
+// radius `radius` (or their own `pscale`, when the attribute exists); every
+// overlapping pair is pushed apart along the line between centres and, if
+// approaching, has its relative normal velocity reflected with
+// `restitution` (0 = perfectly inelastic, 1 = elastic). Place AFTER
+// pop_solver, like pop_speed_limit: it corrects the integrated P and v.
+//
+// Resolution is Jacobi-style: each particle sums the corrections from all
+// of its contacts against the start-of-iteration positions, then every
+// particle applies its sum at once. Both halves of a pair see the same
+// contact, so the scheme is symmetric, parallel over particles without
+// atomics, and deterministic. `iterations` > 1 re-runs it (rebuilding the
+// neighbour grid, since P moved) to settle dense piles.
+
+#include "../dop_node.hpp"
+#include "../dop_graph.hpp"
+#include "../dop_registry.hpp"
+#include "../neighbor_grid.hpp"
+#include "../sim_state.hpp"
+
+#include "../../core/parallel.hpp"
+#include "../../geometry/geometry.hpp"
+#include "../../geometry/attribute.hpp"
+#include "../../geometry/attribute_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace tracey
+{
+    namespace dops
+    {
+        class PopCollideDop : public DopNode
+        {
+        public:
+            explicit PopCollideDop(size_t uid) : DopNode(uid)
+            {
+                declareParam(Parameter::makeFloat("radius",      0.05f));
+                declareParam(Parameter::makeFloat("restitution", 0.5f));
+                declareParam(Parameter::makeInt  ("iterations",  1));
+            }
+            std::string kind() const override { return "pop_collide"; }
+            InputsAndOutputs ports() const override
+            {
+                InputsAndOutputs io;
+                io.addInput(PortInfo::createInput("in", DataType::Scene3D));
+                io.addOutput(PortInfo::createOutput("out", DataType::Scene3D));
+                return io;
+            }
+
+            void prepare(SimState &state) const override
+            {
+                Geometry &g = state.geometry;
+                if (!g.points().get(kAttrV)) g.points().add(kAttrV, Vec3(0.0f));
+            }
+
+            void cookFrame(DopEvalContext &ctx) const override
+            {
+                if (!ctx.state) return;
+                Geometry &g = ctx.state->geometry;
+                if (!g.points().get(kAttrP) || !g.points().get(kAttrV)) return;
+                const size_t n = g.pointCount();
+                if (n < 2) return;
+
+                const float radius = std::max(1e-5f, paramFloat("radius", 0.05f));
+                const float e      = std::clamp(paramFloat("restitution", 0.5f), 0.0f, 1.0f);
+                const int   iters  = std::clamp(paramInt("iterations", 1), 1, 16);
+
+                // Per-particle radii. The grid radius has to cover the
+                // largest possible contact distance.
+                const auto *PS = std::as_const(g).points().get(kAttrPscale);
+                const std::vector<float> *rd = PS ? &PS->data() : nullptr;
+                float maxRadius = radius;
+                if (rd)
+                {
+                    maxRadius = 0.0f;
+                    for (float r : *rd) maxRadius = std::max(maxRadius, r);
+                    if (maxRadius <= 0.0f) return;
+                }
+
+                std::vector<Vec3> dP(n);
+                std::vector<Vec3> dV(n);
+                for (int it = 0; it < iters; ++it)
+                {
+                    const NeighborGrid &grid = acquireNeighborGrid(*ctx.state, 2.0f * maxRadius);
+                    const auto &pd = std::as_const(g).points().get(kAttrP)->data();
+                    const auto &vd = std::as_const(g).points().get(kAttrV)->data();
+
+                    std::vector<uint8_t> touched(n, 0);
+                    tracey::parallel_for_chunks(n,
+                        [&, radius, e, maxRadius](size_t begin, size_t end) {
+                            for (size_t i = begin; i < end; ++i)
+                            {
+                                const Vec3 pi = pd[i];
+                                const Vec3 vi = vd[i];
+                                const float ri = rd ? (*rd)[i] : radius;
+                                Vec3 corr(0.0f);
+                                Vec3 dv(0.0f);
+                                grid.forEachNeighbor(pi, 2.0f * maxRadius,
+                                    [&](uint32_t j, const Vec3 &pj, float d2) {
+                                        if (j == i) return;
+                                        const float contact = ri + (rd ? (*rd)[j] : radius);
+                                        if (d2 >= contact * contact) return;
+                                        const float d = std::sqrt(d2);
+                                        // Coincident centres: split along
+                                        // ±X by index so the pair still
+                                        // separates symmetrically.
+                                        const Vec3 nrm = d > 1e-7f
+                                            ? (pi - pj) / d
+                                            : Vec3(i < j ? -1.0f : 1.0f, 0.0f, 0.0f);
+                                        corr += nrm * (0.5f * (contact - d));
+                                        const float vn = glm::dot(vi - vd[j], nrm);
+                                        if (vn < 0.0f) dv -= nrm * (0.5f * (1.0f + e) * vn);
+                                    });
+                                dP[i] = corr;
+                                dV[i] = dv;
+                                touched[i] = (corr != Vec3(0.0f) || dv != Vec3(0.0f)) ? 1 : 0;
+                            }
+                        }, /*serialThreshold=*/256);
+
+                    if (std::find(touched.begin(), touched.end(), 1) == touched.end()) break;
+
+                    // Mutable access bumps P's generation, so the next
+                    // iteration (and any later node) rebuilds the grid.
+                    auto &pw = g.points().get(kAttrP)->data();
+                    auto &vw = g.points().get(kAttrV)->data();
+                    tracey::parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            pw[i] += dP[i];
+                            vw[i] += dV[i];
+                        }
+                    });
+                }
+            }
+        };
+
+        void registerPopCollideDop()
+        {
+            DopRegistry::instance().registerType(
+                {"pop_collide", "Collide", "Modifier",
+                 /*inputs*/  {{"in"}},
+                 /*outputs*/ {{"out"}},
+                 /*params*/ {
+                     {"radius",      ParamType::Float, "0.05"},
+                     {"restitution", ParamType::Float, "0.5"},
+                     {"iterations",  ParamType::Int,   "1"},
+                 }},
+                [](size_t uid) { return std::make_unique<PopCollideDop>(uid); });
+        }
+    }
+}
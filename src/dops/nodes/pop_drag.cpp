@@ -40,16 +40,16 @@ namespace tracey
             void prepare(SimState &state) const override
             {
                 Geometry &g = state.geometry;
-                if (!g.points().get<Vec3>("force")) g.points().add<Vec3>("force", Vec3(0.0f));
-                if (!g.points().get<Vec3>("v"))     g.points().add<Vec3>("v",     Vec3(0.0f));
+                if (!g.points().get(kAttrForce)) g.points().add(kAttrForce, Vec3(0.0f));
+                if (!g.points().get(kAttrV))     g.points().add(kAttrV,     Vec3(0.0f));
             }
 
             void cookFrame(DopEvalContext &ctx) const override
             {
                 if (!ctx.state) return;
                 Geometry &g = ctx.state->geometry;
-                auto *F = g.points().get<Vec3>("force");
-                auto *V = g.points().get<Vec3>("v");
+                auto *F = g.points().get(kAttrForce);
+                auto *V = g.points().get(kAttrV);
                 if (!F || !V) return;
                 const float k = paramFloat("drag", 1.0f);
                 auto &fd = F->data();
@@ -72,8 +72,8 @@ namespace tracey
                     // Make sure `force` exists before the VOP subnet's
                     // geo_input.force / geo_output.force ports read or
                     // write it.
-                    if (!g.points().get<Vec3>("force"))
-                        g.points().add<Vec3>("force", Vec3(0.0f));
+                    if (!g.points().get(kAttrForce))
+                        g.points().add(kAttrForce, Vec3(0.0f));
 
                     if (!m_vopGraph) m_vopGraph = makeSeededVopGraph();
 
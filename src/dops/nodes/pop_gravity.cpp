@@ -36,15 +36,15 @@ namespace tracey
                 // adds it on emit, but a graph with pop_gravity but no
                 // pop_source (or pop_gravity ordered before pop_source) would
                 // crash without this.
-                if (!state.geometry.points().get<Vec3>("force"))
-                    state.geometry.points().add<Vec3>("force", Vec3(0.0f));
+                if (!state.geometry.points().get(kAttrForce))
+                    state.geometry.points().add(kAttrForce, Vec3(0.0f));
             }
 
             void cookFrame(DopEvalContext &ctx) const override
             {
                 if (!ctx.state) return;
                 Geometry &g = ctx.state->geometry;
-                auto *F = g.points().get<Vec3>("force");
+                auto *F = g.points().get(kAttrForce);
                 if (!F) return;
                 const Vec3 gv = paramVec3("gravity", Vec3(0.0f, -9.81f, 0.0f));
                 auto &fd = F->data();
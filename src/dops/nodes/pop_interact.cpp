@@ -0,0 +1,129 @@
+// pop_interact — particle-particle steering forces (separation, cohesion,
+// alignment) over every neighbour within `radius`. The flocking trio:
+//
+//   separation — push away from each neighbour, weighted by
+//                (1 - d / radius) so the push fades to zero at the edge of
+//                the neighbourhood. Negative values attract.
+//   cohesion   — pull toward the neighbourhood's centroid, normalised by
+//                `radius` so the strength reads the same at any scale.
+//   alignment  — steer toward the neighbourhood's mean velocity (needs `v`;
+//                skipped when the attribute is missing).
+//
+// Neighbours come from the SimState's shared NeighborGrid, so several
+// interaction nodes in one substep pay for one grid build. Each particle
+// only writes its own `force` slot — the loop is parallel over particles
+// with no synchronisation, and the grid's index-ordered traversal keeps the
+// per-particle sums deterministic.
+
+#include "../dop_node.hpp"
+#include "../dop_graph.hpp"
+#include "../dop_registry.hpp"
+#include "../neighbor_grid.hpp"
+#include "../sim_state.hpp"
+
+#include "../../core/parallel.hpp"
+#include "../../geometry/geometry.hpp"
+#include "../../geometry/attribute.hpp"
+#include "../../geometry/attribute_table.hpp"
+
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace tracey
+{
+    namespace dops
+    {
+        class PopInteractDop : public DopNode
+        {
+        public:
+            explicit PopInteractDop(size_t uid) : DopNode(uid)
+            {
+                declareParam(Parameter::makeFloat("radius",     0.5f));
+                declareParam(Parameter::makeFloat("separation", 1.0f));
+                declareParam(Parameter::makeFloat("cohesion",   0.0f));
+                declareParam(Parameter::makeFloat("alignment",  0.0f));
+            }
+            std::string kind() const override { return "pop_interact"; }
+            InputsAndOutputs ports() const override
+            {
+                InputsAndOutputs io;
+                io.addInput(PortInfo::createInput("in", DataType::Scene3D));
+                io.addOutput(PortInfo::createOutput("out", DataType::Scene3D));
+                return io;
+            }
+
+            void prepare(SimState &state) const override
+            {
+                Geometry &g = state.geometry;
+                if (!g.points().get(kAttrForce)) g.points().add(kAttrForce, Vec3(0.0f));
+            }
+
+            void cookFrame(DopEvalContext &ctx) const override
+            {
+                if (!ctx.state) return;
+                Geometry &g = ctx.state->geometry;
+                const auto *P = std::as_const(g).points().get(kAttrP);
+                const auto *V = std::as_const(g).points().get(kAttrV);
+                auto *F = g.points().get(kAttrForce);
+                if (!P || !F) return;
+
+                const float radius = std::max(1e-4f, paramFloat("radius", 0.5f));
+                const float kSep   = paramFloat("separation", 1.0f);
+                const float kCoh   = paramFloat("cohesion",   0.0f);
+                const float kAli   = V ? paramFloat("alignment", 0.0f) : 0.0f;
+                if (kSep == 0.0f && kCoh == 0.0f && kAli == 0.0f) return;
+
+                const NeighborGrid &grid = acquireNeighborGrid(*ctx.state, radius);
+                const auto &pd = P->data();
+                const std::vector<Vec3> *vd = V ? &V->data() : nullptr;
+                auto &fd = F->data();
+                const float invRadius = 1.0f / radius;
+
+                tracey::parallel_for_chunks(fd.size(),
+                    [&, kSep, kCoh, kAli, radius, invRadius](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            const Vec3 pi = pd[i];
+                            Vec3 sep(0.0f);
+                            Vec3 sumP(0.0f);
+                            Vec3 sumV(0.0f);
+                            int count = 0;
+                            grid.forEachNeighbor(pi, radius,
+                                [&](uint32_t j, const Vec3 &pj, float d2) {
+                                    if (j == i) return;
+                                    const float d = std::sqrt(d2);
+                                    if (d > 1e-6f)
+                                        sep += (pi - pj) * ((1.0f - d * invRadius) / d);
+                                    sumP += pj;
+                                    if (vd) sumV += (*vd)[j];
+                                    ++count;
+                                });
+                            if (count == 0) continue;
+
+                            const float invCount = 1.0f / static_cast<float>(count);
+                            Vec3 f = sep * kSep;
+                            f += (sumP * invCount - pi) * (kCoh * invRadius);
+                            if (vd) f += (sumV * invCount - (*vd)[i]) * kAli;
+                            fd[i] += f;
+                        }
+                    }, /*serialThreshold=*/256);
+            }
+        };
+
+        void registerPopInteractDop()
+        {
+            DopRegistry::instance().registerType(
+                {"pop_interact", "Interact", "Force",
+                 /*inputs*/  {{"in"}},
+                 /*outputs*/ {{"out"}},
+                 /*params*/ {
+                     {"radius",     ParamType::Float, "0.5"},
+                     {"separation", ParamType::Float, "1.0"},
+                     {"cohesion",   ParamType::Float, "0.0"},
+                     {"alignment",  ParamType::Float, "0.0"},
+                 }},
+                [](size_t uid) { return std::make_unique<PopInteractDop>(uid); });
+        }
+    }
+}
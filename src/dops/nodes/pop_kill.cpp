@@ -132,7 +132,7 @@ namespace tracey
                 else if (mode == "age")
                 {
                     const float maxAge = paramFloat("max_age", 10.0f);
-                    if (const auto *A = g.points().get<float>("age"))
+                    if (const auto *A = g.points().get(kAttrAge))
                     {
                         const auto &d = A->data();
                         for (size_t i = 0; i < n; ++i)
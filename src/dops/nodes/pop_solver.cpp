@@ -70,10 +70,10 @@ namespace tracey
                 // pop_source isn't present (e.g. a manually-seeded state
                 // from an input SOP in some future setup).
                 Geometry &g = state.geometry;
-                if (!g.points().get<Vec3> ("v"))     g.points().add<Vec3> ("v",     Vec3(0.0f));
-                if (!g.points().get<float>("age"))   g.points().add<float>("age",   0.0f);
-                if (!g.points().get<float>("life"))  g.points().add<float>("life",  1.0f);
-                if (!g.points().get<Vec3> ("force")) g.points().add<Vec3> ("force", Vec3(0.0f));
+                if (!g.points().get(kAttrV))     g.points().add(kAttrV,     Vec3(0.0f));
+                if (!g.points().get(kAttrAge))   g.points().add(kAttrAge,   0.0f);
+                if (!g.points().get(kAttrLife))  g.points().add(kAttrLife,  1.0f);
+                if (!g.points().get(kAttrForce)) g.points().add(kAttrForce, Vec3(0.0f));
             }
 
             void cookFrame(DopEvalContext &ctx) const override
@@ -83,11 +83,11 @@ namespace tracey
                 const float dt = static_cast<float>(ctx.state->header.dt);
                 if (dt <= 0.0f) return;
 
-                auto *P     = g.points().get<Vec3> ("P");
-                auto *V     = g.points().get<Vec3> ("v");
-                auto *AGE   = g.points().get<float>("age");
-                auto *LIFE  = g.points().get<float>("life");
-                auto *FORCE = g.points().get<Vec3> ("force");
+                auto *P     = g.points().get(kAttrP);
+                auto *V     = g.points().get(kAttrV);
+                auto *AGE   = g.points().get(kAttrAge);
+                auto *LIFE  = g.points().get(kAttrLife);
+                auto *FORCE = g.points().get(kAttrForce);
                 if (!P || !V || !AGE || !LIFE || !FORCE) return;
 
                 auto &pd = P->data();
@@ -182,9 +182,9 @@ namespace tracey
                         src = ctx.sopProvider->lookupCookedGeometry(srcUid);
                     if (src)
                     {
-                        srcP  = src->points().get<Vec3>("P");
-                        srcN  = src->points().get<Vec3>("N");
-                        srcCd = src->points().get<Vec3>("Cd");
+                        srcP  = src->points().get(kAttrP);
+                        srcN  = src->points().get(kAttrN);
+                        srcCd = src->points().get(kAttrCd);
                         if (srcP) srcCount = srcP->data().size();
                     }
                 }
@@ -209,17 +209,17 @@ namespace tracey
                 // bulk-emit cost goes from O(n²) to O(n).
                 const size_t base = g.pointCount();
                 g.points().resize(base + static_cast<size_t>(emit));
-                auto *P     = g.points().get<Vec3>("P");
-                auto *V     = g.points().get<Vec3>("v");
-                auto *AGE   = g.points().get<float>("age");
-                auto *LIFE  = g.points().get<float>("life");
-                auto *ID    = g.points().get<int>("id");
-                auto *FORCE = g.points().get<Vec3>("force");
+                auto *P     = g.points().get(kAttrP);
+                auto *V     = g.points().get(kAttrV);
+                auto *AGE   = g.points().get(kAttrAge);
+                auto *LIFE  = g.points().get(kAttrLife);
+                auto *ID    = g.points().get(kAttrId);
+                auto *FORCE = g.points().get(kAttrForce);
                 if (!P || !V || !AGE || !LIFE || !ID || !FORCE) return;
 
                 // Cd materialised by prepare() when emit_mode=geometry +
                 // inherit_cd=true. Stays absent for the legacy point path.
-                auto *CD = g.points().get<Vec3>("Cd");
+                auto *CD = g.points().get(kAttrCd);
 
                 for (int i = 0; i < emit; ++i)
                 {
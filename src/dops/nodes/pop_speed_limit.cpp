@@ -53,7 +53,7 @@ namespace tracey
             {
                 if (!ctx.state) return;
                 Geometry &g = ctx.state->geometry;
-                auto *V = g.points().get<Vec3>("v");
+                auto *V = g.points().get(kAttrV);
                 if (!V) return;
                 const std::string mode = paramString("mode", "hard");
                 const float       cap  = std::max(0.0f, paramFloat("max_speed", 10.0f));
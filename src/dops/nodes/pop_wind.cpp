@@ -10,37 +10,19 @@
 #include "../dop_registry.hpp"
 #include "../sim_state.hpp"
 
+#include "../../core/noise.hpp"
 #include "../../core/parallel.hpp"
 #include "../../geometry/geometry.hpp"
 #include "../../geometry/attribute.hpp"
 #include "../../geometry/attribute_table.hpp"
 
-#include <glm/glm.hpp>
-#include <glm/gtc/noise.hpp>
-
+#include <algorithm>
 #include <memory>
 
 namespace tracey
 {
     namespace dops
     {
-        namespace
-        {
-            // Decorrelated 3D perlin: shift the lookup coord per axis so
-            // the three components don't all spike together. Matches the
-            // shift constants noise_vec3 uses in glsl_emit so a graph that
-            // mixes CPU pop_wind with GPU noise_vec3 reads consistently.
-            inline glm::vec3 perlin3(const glm::vec3 &p, int seed)
-            {
-                const float s = static_cast<float>(seed);
-                return glm::vec3(
-                    glm::perlin(glm::vec3(p.x + s * 17.13f, p.y + s * 31.71f, p.z + s * 53.91f)),
-                    glm::perlin(glm::vec3(p.x + (s + 41.f) * 17.13f, p.y + (s + 41.f) * 31.71f, p.z + (s + 41.f) * 53.91f)),
-                    glm::perlin(glm::vec3(p.x + (s + 83.f) * 17.13f, p.y + (s + 83.f) * 31.71f, p.z + (s + 83.f) * 53.91f))
-                );
-            }
-        }
-
         class PopWindDop : public DopNode
         {
         public:
@@ -64,15 +46,15 @@ namespace tracey
             void prepare(SimState &state) const override
             {
                 Geometry &g = state.geometry;
-                if (!g.points().get<Vec3>("force")) g.points().add<Vec3>("force", Vec3(0.0f));
+                if (!g.points().get(kAttrForce)) g.points().add(kAttrForce, Vec3(0.0f));
             }
 
             void cookFrame(DopEvalContext &ctx) const override
             {
                 if (!ctx.state) return;
                 Geometry &g = ctx.state->geometry;
-                auto *P = g.points().get<Vec3>("P");
-                auto *F = g.points().get<Vec3>("force");
+                auto *P = g.points().get(kAttrP);
+                auto *F = g.points().get(kAttrForce);
                 if (!P || !F) return;
 
                 const Vec3 dir = paramVec3("direction", Vec3(1.0f, 0.0f, 0.0f));
@@ -89,18 +71,20 @@ namespace tracey
                 const size_t n = fd.size();
                 tracey::parallel_for_chunks(n,
                     [&pd, &fd, uniform, turb, freq, seed, wantTurb](size_t begin, size_t end) {
-                        for (size_t i = begin; i < end; ++i)
+                        // Turbulence in SoA blocks through the shared noise
+                        // kernels, then one pass to fold it into force.
+                        constexpr size_t kBlock = 256;
+                        Vec3 t[kBlock];
+                        for (size_t b = begin; b < end; b += kBlock)
                         {
-                            fd[i].x += uniform.x;
-                            fd[i].y += uniform.y;
-                            fd[i].z += uniform.z;
+                            const size_t m = std::min(kBlock, end - b);
                             if (wantTurb)
+                                noise::perlin3Field(pd.data() + b, m, freq, Vec3(0.0f), seed, t);
+                            for (size_t k = 0; k < m; ++k)
                             {
-                                const glm::vec3 sp(pd[i].x * freq, pd[i].y * freq, pd[i].z * freq);
-                                const glm::vec3 t = perlin3(sp, seed) * turb;
-                                fd[i].x += t.x;
-                                fd[i].y += t.y;
-                                fd[i].z += t.z;
+                                Vec3 &f = fd[b + k];
+                                f += uniform;
+                                if (wantTurb) f += t[k] * turb;
                             }
                         }
                     });
@@ -14,6 +14,8 @@ namespace tracey
         void registerPopDragDop();
         void registerPopWindDop();
         void registerPopAttractDop();
+        void registerPopInteractDop();
+        void registerPopCollideDop();
         void registerPopSpeedLimitDop();
         void registerPopKillDop();
 
@@ -27,8 +29,10 @@ namespace tracey
             registerPopDragDop();
             registerPopWindDop();
             registerPopAttractDop();
+            registerPopInteractDop();
             registerSolverDops();     // pop_solver (integrator)
             registerPopSpeedLimitDop();
+            registerPopCollideDop();
             registerPopKillDop();
         }
     }
@@ -3,11 +3,14 @@
 #include "../geometry/geometry.hpp"
 
 #include <cstdint>
+#include <memory>
 
 namespace tracey
 {
     namespace dops
     {
+        class NeighborGrid;
+
         // Per-frame simulation header. The DopGraph fills this in before each
         // cookFrame() and passes it to every node via DopEvalContext, so
         // sources / solvers / forces don't each need to look up the timeline
@@ -36,10 +39,16 @@ namespace tracey
         // particles this is just a Geometry whose points carry P / v / age /
         // life / id / force attributes. The header is rebuilt each frame from
         // the timeline; only the geometry persists across the frame boundary.
+        //
+        // `neighbors` is a derived cache, not state: the spatial hash over P
+        // that point-point nodes share within a substep. Only touch it
+        // through acquireNeighborGrid() (neighbor_grid.hpp), which rebuilds
+        // it whenever P has moved. The frame cache doesn't store it.
         struct SimState
         {
             Geometry geometry;
             SimHeader header;
+            std::shared_ptr<NeighborGrid> neighbors;
         };
     }
 }
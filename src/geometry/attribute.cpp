@@ -15,6 +15,19 @@ namespace tracey
     // here where buffer.hpp is in scope.
     AttributeBase::~AttributeBase() = default;
 
+    void *AttributeBase::operator new(std::size_t bytes)
+    {
+        if (auto *pool = AttributePool::current()) return pool->acquireBlock(bytes);
+        return ::operator new(bytes);
+    }
+
+    void AttributeBase::operator delete(void *p, std::size_t bytes)
+    {
+        if (auto *pool = AttributePool::current())
+            if (pool->releaseBlock(p, bytes)) return;
+        ::operator delete(p, bytes);
+    }
+
     // ── typeTag (verbatim from before) ──
     template <> const char *Attribute<float>::typeTag() const { return "float"; }
     template <> const char *Attribute<int>::typeTag() const { return "int"; }
@@ -3,7 +3,10 @@
 #include "../core/types.hpp"
 #include "../device/buffer.hpp"
 #include "attribute_class.hpp"
+#include "attribute_name.hpp"
+#include "attribute_pool.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -44,13 +47,20 @@ namespace tracey
     {
     public:
         AttributeBase(std::string name, AttributeClass cls)
-            : m_name(std::move(name)), m_class(cls) {}
+            : m_name(std::move(name)), m_id(internAttributeName(m_name)), m_class(cls) {}
         // Out-of-line so the `std::unique_ptr<Buffer>` member can hold
         // a forward-declared Buffer in this header; the destructor is
         // emitted in attribute.cpp where buffer.hpp is included.
         virtual ~AttributeBase();
 
+        // Attribute objects come from the thread's AttributePool when one
+        // is installed (during a SOP cook), from the heap otherwise.
+        static void *operator new(std::size_t bytes);
+        static void operator delete(void *p, std::size_t bytes);
+
         const std::string &name() const { return m_name; }
+        // Interned id of name(); what AttributeTable matches handles on.
+        AttributeId id() const { return m_id; }
         AttributeClass attributeClass() const { return m_class; }
 
         // Element count this attribute carries. The vector and the GPU
@@ -82,6 +92,14 @@ namespace tracey
         // detection use this instead of hashing content bytes.
         uint64_t generation() const { return m_generation; }
 
+        // Overwrite the counter with a value captured from another
+        // instance. Only for caches that rebuild an attribute from a
+        // serialised snapshot (the DOP frame cache): the rebuilt copy
+        // must report the generation of the attribute it was encoded
+        // from, or generation-keyed consumers (dop_import) would see two
+        // different frames decode to the same generation.
+        void restoreGeneration(uint64_t generation) { m_generation = generation; }
+
         // Bytes per element in the GPU buffer. Differs from sizeof(T)
         // for std430-padded types: Vec3 → 16 bytes (vec3 array stride
         // in std430), Vec2 → 8 bytes, float/int/Vec4 → sizeof(T).
@@ -104,6 +122,10 @@ namespace tracey
         const Buffer *bufferConst() const;
 
     protected:
+        // For clone(): the name is already interned.
+        AttributeBase(std::string name, AttributeId id, AttributeClass cls)
+            : m_name(std::move(name)), m_id(id), m_class(cls) {}
+
         enum class Side : uint8_t { Cpu, Gpu, Both };
 
         // Sync the CPU vector to match the GPU buffer if the latter
@@ -134,6 +156,7 @@ namespace tracey
 
     private:
         std::string m_name;
+        AttributeId m_id;
         AttributeClass m_class;
     };
 
@@ -146,7 +169,16 @@ namespace tracey
     {
     public:
         Attribute(std::string name, AttributeClass cls, size_t size, T def = T{})
-            : AttributeBase(std::move(name), cls), m_data(size, def), m_default(std::move(def)) {}
+            : AttributeBase(std::move(name), cls), m_data(makeStorage(size, def)), m_default(std::move(def))
+        {
+            // AttributeBase::operator new has no aligned overload.
+            static_assert(alignof(Attribute) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        }
+        // Hands the element buffer back to the installed pool, if any.
+        ~Attribute() override
+        {
+            if (auto *pool = AttributePool::current()) pool->release(std::move(m_data));
+        }
 
         size_t size() const override { return m_data.size(); }
 
@@ -171,9 +203,9 @@ namespace tracey
             // Force the CPU vector to current state before duplicating
             // so the clone observes any pending GPU-side writes.
             syncToCpu();
-            auto out = std::make_unique<Attribute<T>>(
-                name(), attributeClass(), m_data.size(), m_default);
-            out->m_data = m_data;
+            std::unique_ptr<Attribute<T>> out(
+                new Attribute<T>(name(), id(), attributeClass(), m_data.size(), m_default));
+            std::copy(m_data.begin(), m_data.end(), out->m_data.begin());
             // Preserve the source generation. Phase C uses generation
             // as an O(1) change-detection signal across the cook-
             // request side channel (dop_import stamps positions into a
@@ -244,6 +276,15 @@ namespace tracey
         }
 
     private:
+        Attribute(std::string name, AttributeId id, AttributeClass cls, size_t size, T def)
+            : AttributeBase(std::move(name), id, cls), m_data(makeStorage(size, def)), m_default(std::move(def)) {}
+
+        static std::vector<T> makeStorage(size_t n, const T &def)
+        {
+            if (auto *pool = AttributePool::current()) return pool->acquire<T>(n, def);
+            return std::vector<T>(n, def);
+        }
+
         // mutable: const-data() needs to download into m_data when the
         // GPU side is the current authority. The attribute's identity
         // doesn't change — only the representation catches up.
@@ -0,0 +1,63 @@
+#include "attribute_name.hpp"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace tracey
+{
+    namespace
+    {
+        struct NameRegistry
+        {
+            // deque: push_back never moves existing strings, so the
+            // string_view keys and the references attributeNameOf hands
+            // out stay valid.
+            std::deque<std::string> names;
+            std::unordered_map<std::string_view, AttributeId> ids;
+            std::shared_mutex mutex;
+
+            NameRegistry()
+            {
+                // Order must match the AttributeIds enum.
+                for (const char *name : {"P", "N", "Cd", "uv", "Alpha", "pscale", "orient",
+                                         "v", "force", "age", "life", "id"})
+                    add(name);
+            }
+
+            AttributeId add(std::string_view name)
+            {
+                const auto id = static_cast<AttributeId>(names.size());
+                ids.emplace(names.emplace_back(name), id);
+                return id;
+            }
+        };
+
+        NameRegistry &registry()
+        {
+            static NameRegistry instance;
+            return instance;
+        }
+    }
+
+    AttributeId internAttributeName(std::string_view name)
+    {
+        NameRegistry &r = registry();
+        {
+            std::shared_lock lock(r.mutex);
+            if (auto it = r.ids.find(name); it != r.ids.end()) return it->second;
+        }
+        std::unique_lock lock(r.mutex);
+        if (auto it = r.ids.find(name); it != r.ids.end()) return it->second;
+        return r.add(name);
+    }
+
+    const std::string &attributeNameOf(AttributeId id)
+    {
+        static const std::string empty;
+        NameRegistry &r = registry();
+        std::shared_lock lock(r.mutex);
+        return id < r.names.size() ? r.names[id] : empty;
+    }
+}
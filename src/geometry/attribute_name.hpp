@@ -0,0 +1,89 @@
+#pragma once
+
+// Interned attribute names.
+//
+// Every attribute name is registered once in a process-wide table and
+// referred to by a small integer id from then on: AttributeBase keeps the
+// id of its name, AttributeTable matches on it, and nodes hold typed
+// AttributeHandle<T>s (id + element type) across cooks instead of
+// re-spelling "P" into a std::string on every lookup.
+//
+// The standard attribute names are pre-registered at fixed ids (the
+// AttributeIds enum below) so their handles are compile-time constants.
+// Ids are never reused or freed; the table only grows with the set of
+// distinct names the process has seen.
+
+#include "../core/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace tracey
+{
+    using AttributeId = uint32_t;
+
+    inline constexpr AttributeId kInvalidAttributeId = UINT32_MAX;
+
+    // Fixed ids of the pre-registered names, in registration order.
+    enum AttributeIds : AttributeId
+    {
+        kAttrIdP = 0,
+        kAttrIdN,
+        kAttrIdCd,
+        kAttrIdUv,
+        kAttrIdAlpha,
+        kAttrIdPscale,
+        kAttrIdOrient,
+        kAttrIdV,
+        kAttrIdForce,
+        kAttrIdAge,
+        kAttrIdLife,
+        kAttrIdId,
+        kAttrIdCount,
+    };
+
+    // Id for `name`, registering it on first sight. Thread-safe; lookups
+    // of known names take a shared lock only.
+    AttributeId internAttributeName(std::string_view name);
+
+    // Name registered under `id`. The reference stays valid for the life
+    // of the process.
+    const std::string &attributeNameOf(AttributeId id);
+
+    // Typed reference to an attribute by interned name. Resolving it in
+    // an AttributeTable is a scan over a handful of integer ids plus a
+    // typeIndex() compare; constructing one from a string interns it, so
+    // do that once (a static, or a member built at node construction),
+    // not per lookup.
+    template <typename T>
+    class AttributeHandle
+    {
+    public:
+        constexpr AttributeHandle() = default;
+        constexpr explicit AttributeHandle(AttributeId id) : m_id(id) {}
+        explicit AttributeHandle(std::string_view name) : m_id(internAttributeName(name)) {}
+
+        constexpr AttributeId id() const { return m_id; }
+        constexpr bool valid() const { return m_id != kInvalidAttributeId; }
+        const std::string &name() const { return attributeNameOf(m_id); }
+
+    private:
+        AttributeId m_id = kInvalidAttributeId;
+    };
+
+    // Handles for the standard point attributes, with the element types
+    // the SOP / POP nodes store them as. (uv is left out: it is Vec2 or
+    // Vec3 depending on the producer.)
+    inline constexpr AttributeHandle<Vec3>  kAttrP{kAttrIdP};
+    inline constexpr AttributeHandle<Vec3>  kAttrN{kAttrIdN};
+    inline constexpr AttributeHandle<Vec3>  kAttrCd{kAttrIdCd};
+    inline constexpr AttributeHandle<float> kAttrAlpha{kAttrIdAlpha};
+    inline constexpr AttributeHandle<float> kAttrPscale{kAttrIdPscale};
+    inline constexpr AttributeHandle<Vec4>  kAttrOrient{kAttrIdOrient};
+    inline constexpr AttributeHandle<Vec3>  kAttrV{kAttrIdV};
+    inline constexpr AttributeHandle<Vec3>  kAttrForce{kAttrIdForce};
+    inline constexpr AttributeHandle<float> kAttrAge{kAttrIdAge};
+    inline constexpr AttributeHandle<float> kAttrLife{kAttrIdLife};
+    inline constexpr AttributeHandle<int>   kAttrId{kAttrIdId};
+}
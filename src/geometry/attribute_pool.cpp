@@ -0,0 +1,73 @@
+#include "attribute_pool.hpp"
+
+#include <new>
+
+namespace tracey
+{
+    namespace
+    {
+        thread_local AttributePool *t_current = nullptr;
+    }
+
+    AttributePool::AttributePool(size_t retainLimitBytes) : m_retainLimit(retainLimitBytes)
+    {
+    }
+
+    AttributePool::~AttributePool()
+    {
+        trim();
+    }
+
+    AttributePool *AttributePool::current()
+    {
+        return t_current;
+    }
+
+    AttributePool::Scope::Scope(AttributePool *pool) : m_previous(t_current)
+    {
+        t_current = pool;
+    }
+
+    AttributePool::Scope::~Scope()
+    {
+        t_current = m_previous;
+    }
+
+    void *AttributePool::acquireBlock(size_t bytes)
+    {
+        for (auto &list : m_blocks)
+        {
+            if (list.bytes != bytes || list.free.empty()) continue;
+            void *p = list.free.back();
+            list.free.pop_back();
+            m_retainedBytes -= bytes;
+            m_stats.reused += 1;
+            m_stats.bytesReused += bytes;
+            return p;
+        }
+        m_stats.allocations += 1;
+        m_stats.bytesAllocated += bytes;
+        return ::operator new(bytes);
+    }
+
+    bool AttributePool::releaseBlock(void *p, size_t bytes)
+    {
+        if (m_retainedBytes + bytes > m_retainLimit) return false;
+        BlockList *target = nullptr;
+        for (auto &list : m_blocks)
+            if (list.bytes == bytes) target = &list;
+        if (!target) target = &m_blocks.emplace_back(BlockList{bytes, {}});
+        target->free.push_back(p);
+        m_retainedBytes += bytes;
+        return true;
+    }
+
+    void AttributePool::trim()
+    {
+        m_bins.clear();
+        for (auto &list : m_blocks)
+            for (void *p : list.free) ::operator delete(p);
+        m_blocks.clear();
+        m_retainedBytes = 0;
+    }
+}
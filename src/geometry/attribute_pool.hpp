@@ -0,0 +1,162 @@
+#pragma once
+
+// Recycling pool for attribute storage during a SOP cook.
+//
+// A cook builds and drops a Geometry per node: every Attribute<T> is a heap
+// object holding a heap vector, and a playback re-cook of a deep graph frees
+// the previous frame's outputs just as it allocates the new ones. While a
+// pool is installed on the calling thread (AttributePool::Scope — SopGraph::
+// cook installs its CookCache's pool), Attribute<T> takes its element vector
+// from the pool and returns it on destruction, and the Attribute objects
+// themselves come from per-size free lists. Buffers freed by frame N's cook
+// (the replaced cache outputs, each node's scratch copies) back frame N+1's.
+//
+// Everything the pool hands out is an ordinary heap block, so nothing has to
+// be promoted when an output outlives the cook (stored in CookCache, handed
+// to the editor as an EmittedActor): it is simply never returned, and
+// whoever frees it later — on any thread, pool or no pool — frees it to the
+// heap. The pool only ever holds blocks nobody references.
+//
+// Single-threaded by construction: only the thread that installed the pool
+// sees it, so worker lanes inside a node's parallel loops allocate from the
+// heap as before. Retained storage is capped at `retainLimitBytes`; past
+// that, released blocks go straight back to the heap.
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace tracey
+{
+    class AttributePool
+    {
+    public:
+        // Requests served, split by where the memory came from. Only
+        // requests made while the pool was installed are counted.
+        struct Stats
+        {
+            size_t allocations = 0;    // fresh heap blocks
+            size_t reused = 0;         // served from the pool
+            size_t bytesAllocated = 0;
+            size_t bytesReused = 0;
+        };
+
+        explicit AttributePool(size_t retainLimitBytes = size_t(256) << 20);
+        ~AttributePool();
+
+        AttributePool(const AttributePool &) = delete;
+        AttributePool &operator=(const AttributePool &) = delete;
+
+        // The pool installed on this thread, or nullptr.
+        static AttributePool *current();
+
+        // Installs `pool` on this thread for the scope's lifetime, restoring
+        // whatever was installed before (nested subnet cooks re-install the
+        // same pool). A null pool uninstalls for the scope.
+        class Scope
+        {
+        public:
+            explicit Scope(AttributePool *pool);
+            ~Scope();
+            Scope(const Scope &) = delete;
+            Scope &operator=(const Scope &) = delete;
+
+        private:
+            AttributePool *m_previous;
+        };
+
+        // A vector of `n` copies of `def`, reusing a released buffer of
+        // capacity n..4n when there is one.
+        template <typename T>
+        std::vector<T> acquire(size_t n, const T &def)
+        {
+            if (n == 0) return {};
+            auto &b = bins<T>();
+            // Bin c holds capacities in [2^c, 2^(c+1)): n's own bin (where a
+            // same-size re-cook's buffer lands) may hold ones that are too
+            // small, the next one up never does.
+            const unsigned cls = static_cast<unsigned>(std::bit_width(n) - 1);
+            for (unsigned c = cls; c <= cls + 1 && c < kSizeClasses; ++c)
+            {
+                auto &bin = b.bySize[c];
+                auto it = std::find_if(bin.begin(), bin.end(),
+                                       [n](const std::vector<T> &v) { return v.capacity() >= n; });
+                if (it == bin.end()) continue;
+                std::swap(*it, bin.back());
+                std::vector<T> v = std::move(bin.back());
+                bin.pop_back();
+                m_retainedBytes -= v.capacity() * sizeof(T);
+                v.assign(n, def);
+                m_stats.reused += 1;
+                m_stats.bytesReused += n * sizeof(T);
+                return v;
+            }
+            m_stats.allocations += 1;
+            m_stats.bytesAllocated += n * sizeof(T);
+            return std::vector<T>(n, def);
+        }
+
+        // Take back a vector's buffer (its elements are destroyed now).
+        template <typename T>
+        void release(std::vector<T> &&v)
+        {
+            const size_t bytes = v.capacity() * sizeof(T);
+            if (bytes == 0 || m_retainedBytes + bytes > m_retainLimit) return;
+            v.clear();
+            const unsigned cls = static_cast<unsigned>(std::bit_width(v.capacity()) - 1);
+            if (cls >= kSizeClasses) return;
+            bins<T>().bySize[cls].push_back(std::move(v));
+            m_retainedBytes += bytes;
+        }
+
+        // Fixed-size blocks for the Attribute objects themselves.
+        void *acquireBlock(size_t bytes);
+        // False when the pool is full; the caller frees the block itself.
+        bool releaseBlock(void *p, size_t bytes);
+
+        const Stats &stats() const { return m_stats; }
+        size_t retainedBytes() const { return m_retainedBytes; }
+
+        // Free everything retained.
+        void trim();
+
+    private:
+        static constexpr unsigned kSizeClasses = 48;
+
+        struct BinsBase
+        {
+            virtual ~BinsBase() = default;
+        };
+        template <typename T>
+        struct Bins : BinsBase
+        {
+            std::vector<std::vector<T>> bySize[kSizeClasses];
+        };
+
+        template <typename T>
+        Bins<T> &bins()
+        {
+            const std::type_index key(typeid(T));
+            for (auto &[type, b] : m_bins)
+                if (type == key) return static_cast<Bins<T> &>(*b);
+            m_bins.emplace_back(key, std::make_unique<Bins<T>>());
+            return static_cast<Bins<T> &>(*m_bins.back().second);
+        }
+
+        struct BlockList
+        {
+            size_t bytes = 0;
+            std::vector<void *> free;
+        };
+
+        size_t m_retainLimit;
+        size_t m_retainedBytes = 0;
+        Stats m_stats;
+        std::vector<std::pair<std::type_index, std::unique_ptr<BinsBase>>> m_bins;
+        std::vector<BlockList> m_blocks;
+    };
+}
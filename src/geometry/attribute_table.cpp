@@ -1,5 +1,7 @@
 #include "attribute_table.hpp"
 
+#include <algorithm>
+
 namespace tracey
 {
     AttributeTable &AttributeTable::operator=(const AttributeTable &other)
@@ -7,45 +9,50 @@ namespace tracey
         if (this == &other) return *this;
         m_class = other.m_class;
         m_size = other.m_size;
-        m_byName.clear();
-        for (const auto &[name, attr] : other.m_byName)
+        m_attrs.clear();
+        m_attrs.reserve(other.m_attrs.size());
+        for (const auto &slot : other.m_attrs)
         {
-            m_byName.emplace(name, attr->clone());
+            m_attrs.push_back({slot.id, slot.attr->clone()});
         }
+        m_spatialIndex = other.m_spatialIndex;
         return *this;
     }
 
     void AttributeTable::resize(size_t n)
     {
         m_size = n;
-        for (auto &[_, attr] : m_byName)
+        for (auto &slot : m_attrs)
         {
-            attr->resize(n);
+            slot.attr->resize(n);
         }
     }
 
     AttributeBase *AttributeTable::find(std::string_view name)
     {
-        auto it = m_byName.find(std::string(name));
-        return it == m_byName.end() ? nullptr : it->second.get();
+        for (auto &slot : m_attrs)
+            if (slot.attr->name() == name) return slot.attr.get();
+        return nullptr;
     }
 
     const AttributeBase *AttributeTable::find(std::string_view name) const
     {
-        auto it = m_byName.find(std::string(name));
-        return it == m_byName.end() ? nullptr : it->second.get();
+        return const_cast<AttributeTable *>(this)->find(name);
     }
 
     void AttributeTable::remove(std::string_view name)
     {
-        m_byName.erase(std::string(name));
+        if (name == "P") m_spatialIndex.reset();
+        m_attrs.erase(std::remove_if(m_attrs.begin(), m_attrs.end(),
+                                     [name](const Slot &slot) { return slot.attr->name() == name; }),
+                      m_attrs.end());
     }
 
     std::vector<std::string> AttributeTable::names() const
     {
         std::vector<std::string> out;
-        out.reserve(m_byName.size());
-        for (const auto &[name, _] : m_byName) out.push_back(name);
+        out.reserve(m_attrs.size());
+        for (const auto &slot : m_attrs) out.push_back(slot.attr->name());
         return out;
     }
 }
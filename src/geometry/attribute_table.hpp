@@ -5,15 +5,23 @@
 #include <memory>
 #include <string>
 #include <string_view>
-#include <unordered_map>
+#include <type_traits>
+#include <typeindex>
 #include <vector>
 
 namespace tracey
 {
+    class PointKdTree;
+
     // A bag of attributes, all addressing the same number of elements (the
     // class size). One AttributeTable per AttributeClass per Geometry.
     //
     // resize(n) propagates to every contained attribute so they stay in lockstep.
+    //
+    // Storage is a flat vector in insertion order: tables hold a handful of
+    // attributes, so a scan over interned ids (AttributeHandle lookups) or
+    // names (string lookups — no allocation) beats hashing. Typed lookups
+    // check AttributeBase::typeIndex() and static_cast, no dynamic_cast.
     class AttributeTable
     {
     public:
@@ -35,7 +43,9 @@ namespace tracey
         // attribute's defaultValue().
         void resize(size_t n);
 
-        bool has(std::string_view name) const { return m_byName.contains(std::string(name)); }
+        bool has(std::string_view name) const { return find(name) != nullptr; }
+        template <typename T>
+        bool has(const AttributeHandle<T> &handle) const { return get(handle) != nullptr; }
 
         // Add (or replace) an attribute of element type T. Returns a pointer
         // to the typed attribute (not owned by caller). Pre-fills with the
@@ -43,43 +53,91 @@ namespace tracey
         template <typename T>
         Attribute<T> *add(std::string name, T def = T{})
         {
-            auto attr = std::make_unique<Attribute<T>>(name, m_class, m_size, def);
+            auto attr = std::make_unique<Attribute<T>>(std::move(name), m_class, m_size, def);
             auto *raw = attr.get();
-            m_byName[std::move(name)] = std::move(attr);
+            // A fresh P restarts its generation count, which could alias
+            // the generation a cached spatial index was keyed on.
+            if (raw->id() == kAttrIdP) m_spatialIndex.reset();
+            if (Slot *slot = slotOf(raw->id()))
+                slot->attr = std::move(attr);
+            else
+                m_attrs.push_back({raw->id(), std::move(attr)});
             return raw;
         }
 
-        // Look up a typed attribute. Returns nullptr if missing or if the
-        // stored type doesn't match T.
         template <typename T>
-        Attribute<T> *get(std::string_view name)
+        Attribute<T> *add(const AttributeHandle<T> &handle, T def = T{})
         {
-            auto it = m_byName.find(std::string(name));
-            if (it == m_byName.end()) return nullptr;
-            return dynamic_cast<Attribute<T> *>(it->second.get());
+            return add<T>(handle.name(), std::move(def));
         }
 
+        // Look up a typed attribute. Returns nullptr if missing or if the
+        // stored type doesn't match T.
+        template <typename T>
+        Attribute<T> *get(std::string_view name) { return typed<T>(find(name)); }
+
         template <typename T>
-        const Attribute<T> *get(std::string_view name) const
-        {
-            auto it = m_byName.find(std::string(name));
-            if (it == m_byName.end()) return nullptr;
-            return dynamic_cast<const Attribute<T> *>(it->second.get());
-        }
+        const Attribute<T> *get(std::string_view name) const { return typed<T>(find(name)); }
+
+        // Same, by interned handle — the form for per-cook / per-point
+        // call sites.
+        template <typename T>
+        Attribute<T> *get(const AttributeHandle<T> &handle) { return typed<T>(find(handle.id())); }
+
+        template <typename T>
+        const Attribute<T> *get(const AttributeHandle<T> &handle) const { return typed<T>(find(handle.id())); }
 
         // Untyped lookup — needed by the Geometry → SceneObject converter
         // when it just needs to enumerate attributes for serialization.
         AttributeBase *find(std::string_view name);
         const AttributeBase *find(std::string_view name) const;
+        AttributeBase *find(AttributeId id)
+        {
+            Slot *slot = slotOf(id);
+            return slot ? slot->attr.get() : nullptr;
+        }
+        const AttributeBase *find(AttributeId id) const
+        {
+            return const_cast<AttributeTable *>(this)->find(id);
+        }
 
         void remove(std::string_view name);
 
         // Names of all attributes in insertion-stable order.
         std::vector<std::string> names() const;
 
+        // Slot for the lazily built point KD-tree (see
+        // geometry/point_kdtree.hpp, acquirePointKdTree). Derived data, so
+        // it lives in a mutable cache and is shared — not deep-copied — when
+        // the table is copied.
+        std::shared_ptr<const PointKdTree> &spatialIndexCache() const { return m_spatialIndex; }
+
     private:
+        template <typename T, typename Base>
+        static auto typed(Base *attr)
+        {
+            using Out = std::conditional_t<std::is_const_v<Base>, const Attribute<T>, Attribute<T>>;
+            if (!attr || attr->typeIndex() != std::type_index(typeid(T))) return static_cast<Out *>(nullptr);
+            return static_cast<Out *>(attr);
+        }
+
+        // The id sits next to the pointer so a handle lookup scans one
+        // contiguous array without touching the attributes.
+        struct Slot
+        {
+            AttributeId id;
+            std::unique_ptr<AttributeBase> attr;
+        };
+        Slot *slotOf(AttributeId id)
+        {
+            for (auto &slot : m_attrs)
+                if (slot.id == id) return &slot;
+            return nullptr;
+        }
+
         AttributeClass m_class = AttributeClass::Point;
         size_t m_size = 0;
-        std::unordered_map<std::string, std::unique_ptr<AttributeBase>> m_byName;
+        std::vector<Slot> m_attrs;
+        mutable std::shared_ptr<const PointKdTree> m_spatialIndex;
     };
 }
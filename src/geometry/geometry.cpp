@@ -22,7 +22,7 @@ namespace tracey
         const size_t id = m_pointAttrs.size();
         m_pointAttrs.resize(id + 1);
         // Write P after resize so it isn't clobbered by the default fill.
-        auto *P = m_pointAttrs.get<Vec3>("P");
+        auto *P = m_pointAttrs.get(kAttrP);
         if (P) P->at(id) = p;
         return id;
     }
@@ -59,15 +59,16 @@ namespace tracey
             }
         }
 
-        // Try every supported element type until one matches.
+        // Dispatch on the (shared) element type.
         void copy_attribute(const AttributeBase *src, AttributeBase *dst, size_t dstStart)
         {
-            if (src->typeIndex() != dst->typeIndex()) return;
+            const std::type_index type = src->typeIndex();
+            if (type != dst->typeIndex()) return;
 #define TRY_TYPE(T)                                                                  \
-    if (auto *s = dynamic_cast<const Attribute<T> *>(src);                           \
-        s && dynamic_cast<Attribute<T> *>(dst))                                      \
+    if (type == std::type_index(typeid(T)))                                          \
     {                                                                                \
-        copy_attribute_typed<T>(s, dynamic_cast<Attribute<T> *>(dst), dstStart);     \
+        copy_attribute_typed<T>(static_cast<const Attribute<T> *>(src),              \
+                                static_cast<Attribute<T> *>(dst), dstStart);         \
         return;                                                                      \
     }
             TRY_TYPE(float)
@@ -134,14 +135,14 @@ namespace tracey
 
     std::vector<Vec3> &Geometry::positions()
     {
-        auto *P = m_pointAttrs.get<Vec3>("P");
+        auto *P = m_pointAttrs.get(kAttrP);
         if (!P) throw std::runtime_error("Geometry: P attribute missing");
         return P->data();
     }
 
     const std::vector<Vec3> &Geometry::positions() const
     {
-        const auto *P = m_pointAttrs.get<Vec3>("P");
+        const auto *P = m_pointAttrs.get(kAttrP);
         if (!P) throw std::runtime_error("Geometry: P attribute missing");
         return P->data();
     }
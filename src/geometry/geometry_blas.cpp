@@ -0,0 +1,150 @@
+#include "geometry_blas.hpp"
+
+#include "geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <span>
+#include <utility>
+
+namespace tracey
+{
+    GeometryBlas::GeometryBlas(const Geometry &geo, uint64_t contentHash)
+        : m_contentHash(contentHash)
+    {
+        const auto &P = geo.positions();
+        const auto &v2p = geo.vertexToPoint();
+        const auto &prims = geo.primitivesList();
+        m_positions = P;
+        m_vertexToPoint = v2p;
+        m_primitives = prims;
+        m_indices.reserve(prims.size() * 3);
+        m_triToPrim.reserve(prims.size());
+        for (size_t pi = 0; pi < prims.size(); ++pi)
+        {
+            const GeoPrimitive &prim = prims[pi];
+            if (prim.vertexCount < 3 || prim.firstVertex + prim.vertexCount > v2p.size()) continue;
+            const uint32_t base = prim.firstVertex;
+            for (uint32_t k = 1; k + 1 < prim.vertexCount; ++k)
+            {
+                const uint32_t a = v2p[base], b = v2p[base + k], c = v2p[base + k + 1];
+                if (a >= P.size() || b >= P.size() || c >= P.size()) continue;
+                m_indices.insert(m_indices.end(), {a, b, c});
+                m_triToPrim.push_back(static_cast<uint32_t>(pi));
+            }
+        }
+        if (m_triToPrim.empty()) return;
+        m_blas = std::make_unique<Blas>(std::span<const Vec3>(m_positions),
+                                        std::span<const uint32_t>(m_indices));
+    }
+
+    std::optional<Hit> GeometryBlas::intersect(const Vec3 &origin, const Vec3 &direction,
+                                               float maxDistance, float bias) const
+    {
+        if (!m_blas) return std::nullopt;
+        Ray ray;
+        ray.origin = origin + direction * bias;
+        ray.direction = direction;
+        // Axis-aligned rays are the common case here (project along -Y).
+        // 1/0 = inf makes the slab test compute 0·inf = NaN for a ray lying
+        // exactly in a box face — e.g. a point directly above a grid line —
+        // and the box is wrongly rejected. A huge finite reciprocal keeps
+        // that product 0 and behaves like inf everywhere else.
+        for (int a = 0; a < 3; ++a)
+            ray.invDirection[a] = direction[a] != 0.0f
+                ? 1.0f / direction[a]
+                : std::copysign(std::numeric_limits<float>::max(), direction[a]);
+        auto hit = m_blas->intersect(ray, 0.0f, maxDistance - bias, RAY_FLAG_NONE);
+        if (!hit) return std::nullopt;
+        hit->position = ray.origin + direction * hit->t;
+        hit->t += bias;
+        hit->primitiveId = m_triToPrim[hit->primitiveId];
+        hit->instanceId = 0;
+        return hit;
+    }
+
+    bool GeometryBlas::matches(const Geometry &geo) const
+    {
+        const auto same = [](const auto &a, const auto &b) {
+            return a.size() == b.size() &&
+                   (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0);
+        };
+        return same(m_positions, geo.positions()) && same(m_vertexToPoint, geo.vertexToPoint()) &&
+               same(m_primitives, geo.primitivesList());
+    }
+
+    namespace
+    {
+        // splitmix64 finaliser: every input bit reaches every output bit.
+        uint64_t mixWord(uint64_t x)
+        {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+    }
+
+    uint64_t geometryContentHash(const Geometry &geo)
+    {
+        // 64-bit words, each folded in through a full avalanche mix. (Plain
+        // FNV-1a steps on whole words let a flip of bit 63 in one word
+        // cancel one in another; FNV is only sound byte by byte.) Only ever
+        // compared within one process, and acquireGeometryBlas still checks
+        // the content on a hit.
+        uint64_t h = 0xcbf29ce484222325ULL;
+        auto mix = [&](const void *p, size_t bytes) {
+            const auto *b = static_cast<const unsigned char *>(p);
+            size_t i = 0;
+            for (; i + 8 <= bytes; i += 8)
+            {
+                uint64_t w;
+                std::memcpy(&w, b + i, 8);
+                h = mixWord(h ^ w);
+            }
+            uint64_t tail = 0;
+            if (bytes > i) std::memcpy(&tail, b + i, bytes - i);
+            // Length folded in with the tail, so [a][b] and [ab] differ.
+            h = mixWord(h ^ tail);
+            h = mixWord(h ^ static_cast<uint64_t>(bytes));
+        };
+        const auto &P = geo.positions();
+        const auto &v2p = geo.vertexToPoint();
+        const auto &prims = geo.primitivesList();
+        mix(P.data(), P.size() * sizeof(Vec3));
+        mix(v2p.data(), v2p.size() * sizeof(uint32_t));
+        mix(prims.data(), prims.size() * sizeof(GeoPrimitive));
+        return h;
+    }
+
+    std::shared_ptr<const GeometryBlas> acquireGeometryBlas(const Geometry &geo)
+    {
+        // Most-recently-used first. A handful of entries covers the usual
+        // graph (one or two collision surfaces) without pinning the BVHs
+        // of geometry that has since changed.
+        constexpr size_t kCapacity = 8;
+        static std::mutex mutex;
+        static std::list<std::shared_ptr<const GeometryBlas>> entries;
+
+        const uint64_t hash = geometryContentHash(geo);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto it = entries.begin(); it != entries.end(); ++it)
+            {
+                if ((*it)->contentHash() != hash || !(*it)->matches(geo)) continue;
+                entries.splice(entries.begin(), entries, it);
+                return entries.front();
+            }
+        }
+
+        auto blas = std::make_shared<const GeometryBlas>(geo, hash);
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.push_front(blas);
+        if (entries.size() > kCapacity) entries.pop_back();
+        return blas;
+    }
+}
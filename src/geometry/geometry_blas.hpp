@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../core/blas.hpp"
+#include "../core/hit.hpp"
+#include "../core/types.hpp"
+#include "geometry.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace tracey
+{
+    // The engine's CPU Blas built over a Geometry's primitives, for ray casts
+    // inside cooks (the ray SOP, the intersect VOP). Primitives are
+    // fan-triangulated; hits report the source primitive id, not the
+    // triangle's.
+    //
+    // Owns the flattened vertex / index arrays the Blas was built from (a
+    // Blas only keeps spans into its input) and is immutable after
+    // construction, so one instance can be traced from any number of threads.
+    class GeometryBlas
+    {
+    public:
+        explicit GeometryBlas(const Geometry &geo, uint64_t contentHash = 0);
+
+        // Closest hit along origin + t·direction for t in (bias, maxDistance].
+        // `direction` must be normalised (t is then a distance); hits closer
+        // than `bias` are skipped by starting the ray there, so a point lying
+        // on the surface does not hit itself. Both faces count.
+        std::optional<Hit> intersect(const Vec3 &origin, const Vec3 &direction,
+                                     float maxDistance, float bias = 0.0f) const;
+
+        size_t triangleCount() const { return m_triToPrim.size(); }
+        uint64_t contentHash() const { return m_contentHash; }
+        // True when `geo` has exactly the P, vertex → point and primitive
+        // list this BVH was built from.
+        bool matches(const Geometry &geo) const;
+
+    private:
+        std::vector<Vec3> m_positions;
+        // The rest of the source, kept for matches().
+        std::vector<uint32_t> m_vertexToPoint;
+        std::vector<GeoPrimitive> m_primitives;
+        std::vector<uint32_t> m_indices;
+        std::vector<uint32_t> m_triToPrim;
+        std::unique_ptr<Blas> m_blas;
+        uint64_t m_contentHash = 0;
+    };
+
+    // Fingerprint of what a GeometryBlas is built from: P, vertex → point
+    // and the primitive list. Attribute-only edits (Cd, N, uv) keep it.
+    uint64_t geometryContentHash(const Geometry &geo);
+
+    // GeometryBlas for `geo`, shared through a small process-wide cache
+    // keyed by geometryContentHash() and confirmed against the stored
+    // source, so a hash collision costs a build, never a wrong BVH.
+    // Re-cooking a node whose collision input did not change — or a second
+    // node casting against the same surface — costs a hash and a compare
+    // instead of a BVH build. Thread-safe; the build itself runs outside the
+    // cache lock.
+    std::shared_ptr<const GeometryBlas> acquireGeometryBlas(const Geometry &geo);
+}
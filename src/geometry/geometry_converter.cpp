@@ -1,5 +1,6 @@
 #include "geometry_converter.hpp"
 
+#include "../core/parallel.hpp"
 #include "../scene/scene_object.hpp"
 
 namespace tracey
@@ -9,7 +10,7 @@ namespace tracey
         SceneObject out(name);
 
         const auto &v2p = geo.vertexToPoint();
-        const auto *P = geo.points().get<Vec3>("P");
+        const auto *P = geo.points().get(kAttrP);
         if (!P) return out; // empty
 
         // Walk primitives, expanding to triangles (only triangle prims for v1).
@@ -20,57 +21,66 @@ namespace tracey
         std::vector<Vec2> uvs;
         std::vector<Vec3> colors;
 
-        const auto *vertexN = geo.vertices().get<Vec3>("N");
-        const auto *pointN = geo.points().get<Vec3>("N");
+        const auto *vertexN = geo.vertices().get(kAttrN);
+        const auto *pointN = geo.points().get(kAttrN);
         const auto *vertexUV = geo.vertices().get<Vec2>("uv");
         const auto *pointUV = geo.points().get<Vec2>("uv");
         // Vertex color "Cd" — the VOP geo_output.Cd port emits it as a
         // Point attribute; we also honour a Vertex-class Cd for per-corner
         // shading when present.
-        const auto *vertexCd = geo.vertices().get<Vec3>("Cd");
-        const auto *pointCd = geo.points().get<Vec3>("Cd");
+        const auto *vertexCd = geo.vertices().get(kAttrCd);
+        const auto *pointCd = geo.points().get(kAttrCd);
 
         const bool wantNormals = vertexN || pointN;
         const bool wantUVs = vertexUV || pointUV;
         const bool wantColors = vertexCd || pointCd;
 
+        // Triangle t's primitive. Identity (and not materialised) when every
+        // primitive is a triangle — the common case.
         size_t triCount = 0;
         for (const GeoPrimitive &p : prims) if (p.vertexCount == 3) ++triCount;
-
-        positions.reserve(triCount * 3);
-        if (wantNormals) normals.reserve(triCount * 3);
-        if (wantUVs) uvs.reserve(triCount * 3);
-        if (wantColors) colors.reserve(triCount * 3);
-
-        for (const GeoPrimitive &p : prims)
+        std::vector<uint32_t> triPrims;
+        if (triCount != prims.size())
         {
-            if (p.vertexCount != 3) continue; // skip non-triangles for v1
-            for (uint32_t k = 0; k < 3; ++k)
-            {
-                const uint32_t vid = p.firstVertex + k;
-                const uint32_t pid = v2p[vid];
-
-                positions.push_back(P->at(pid));
-
-                if (wantNormals)
-                {
-                    if (vertexN) normals.push_back(vertexN->at(vid));
-                    else         normals.push_back(pointN->at(pid));
-                }
-
-                if (wantUVs)
-                {
-                    if (vertexUV) uvs.push_back(vertexUV->at(vid));
-                    else          uvs.push_back(pointUV->at(pid));
-                }
+            triPrims.reserve(triCount);
+            for (size_t i = 0; i < prims.size(); ++i)
+                if (prims[i].vertexCount == 3) triPrims.push_back(static_cast<uint32_t>(i));
+        }
 
-                if (wantColors)
+        // Class resolution happens once, here: each channel reads either the
+        // vertex attribute (indexed by corner) or the point attribute
+        // (indexed through vertexToPoint). The outputs are sized up front and
+        // every triangle writes its own three slots, so the gather is a
+        // single parallel pass with no push_back growth.
+        positions.resize(triCount * 3);
+        if (wantNormals) normals.resize(triCount * 3);
+        if (wantUVs) uvs.resize(triCount * 3);
+        if (wantColors) colors.resize(triCount * 3);
+
+        const Vec3 *srcP = P->data().data();
+        const Vec3 *srcN = vertexN ? vertexN->data().data() : pointN ? pointN->data().data() : nullptr;
+        const Vec2 *srcUV = vertexUV ? vertexUV->data().data() : pointUV ? pointUV->data().data() : nullptr;
+        const Vec3 *srcCd = vertexCd ? vertexCd->data().data() : pointCd ? pointCd->data().data() : nullptr;
+        const bool nPerVertex = vertexN != nullptr;
+        const bool uvPerVertex = vertexUV != nullptr;
+        const bool cdPerVertex = vertexCd != nullptr;
+
+        parallel_for_chunks(triCount, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t)
+            {
+                const GeoPrimitive &p = prims[triPrims.empty() ? t : triPrims[t]];
+                for (uint32_t k = 0; k < 3; ++k)
                 {
-                    if (vertexCd) colors.push_back(vertexCd->at(vid));
-                    else          colors.push_back(pointCd->at(pid));
+                    const size_t dst = t * 3 + k;
+                    const uint32_t vid = p.firstVertex + k;
+                    const uint32_t pid = v2p[vid];
+                    positions[dst] = srcP[pid];
+                    if (srcN) normals[dst] = srcN[nPerVertex ? vid : pid];
+                    if (srcUV) uvs[dst] = srcUV[uvPerVertex ? vid : pid];
+                    if (srcCd) colors[dst] = srcCd[cdPerVertex ? vid : pid];
                 }
             }
-        }
+        });
 
         // Point-cloud fallback: when the geometry has points but no triangle
         // primitives (e.g. scatter, points_grid emitting a bare point cloud),
@@ -160,7 +170,7 @@ namespace tracey
         geo.vertices().resize(cornerCount);
         geo.vertexToPoint().resize(cornerCount);
 
-        auto *P = geo.points().get<Vec3>("P");
+        auto *P = geo.points().get(kAttrP);
 
         for (size_t c = 0; c < cornerCount; ++c)
         {
@@ -27,7 +27,10 @@ namespace tracey
         //
         // Output is non-indexed (matches existing primitive generators):
         // positions/normals/uvs are flat per-corner arrays; indices stay
-        // empty.
+        // empty. Each channel's class is resolved once and the gather is a
+        // single parallel pass into presized arrays, which the SceneObject
+        // then owns as SharedArrays — later copies of it (Scene, BlasCache)
+        // share them rather than copying.
         static SceneObject toSceneObject(const Geometry &geo, const std::string &name);
 
         // SceneObject → Geometry.
@@ -0,0 +1,168 @@
+#include "point_kdtree.hpp"
+
+#include "attribute.hpp"
+#include "attribute_table.hpp"
+
+#include "../core/parallel.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace tracey
+{
+    void PointKdTree::build(const std::vector<Vec3> &positions)
+    {
+        const size_t n = positions.size();
+        m_index.resize(n);
+        std::iota(m_index.begin(), m_index.end(), 0u);
+        m_axis.assign(n, 0);
+
+        struct Range { uint32_t b, e; };
+        std::vector<Range> level;
+        if (n > kLeafSize) level.push_back({0, static_cast<uint32_t>(n)});
+        std::vector<Range> next;
+        while (!level.empty())
+        {
+            next.assign(level.size() * 2, Range{0, 0});
+            auto split = [&](size_t li) {
+                const Range r = level[li];
+                Vec3 lo(positions[m_index[r.b]]);
+                Vec3 hi(lo);
+                for (uint32_t s = r.b + 1; s < r.e; ++s)
+                {
+                    lo = glm::min(lo, positions[m_index[s]]);
+                    hi = glm::max(hi, positions[m_index[s]]);
+                }
+                const Vec3 ext = hi - lo;
+                const int axis = (ext.x >= ext.y && ext.x >= ext.z) ? 0 : (ext.y >= ext.z ? 1 : 2);
+
+                const uint32_t mid = r.b + (r.e - r.b) / 2;
+                std::nth_element(m_index.begin() + r.b, m_index.begin() + mid, m_index.begin() + r.e,
+                                 [&](uint32_t a, uint32_t b) {
+                                     const float ka = positions[a][axis];
+                                     const float kb = positions[b][axis];
+                                     return ka < kb || (ka == kb && a < b);
+                                 });
+                m_axis[mid] = static_cast<uint8_t>(axis);
+                next[2 * li]     = {r.b, mid};
+                next[2 * li + 1] = {mid + 1, r.e};
+            };
+            // Few big ranges near the root: one claimable item each. Many
+            // small ones further down: chunk them so a claim covers more
+            // than a handful of points.
+            if (level.size() < 4096)
+                tracey::parallel_for_each_index(level.size(), split);
+            else
+                tracey::parallel_for_chunks(level.size(), [&](size_t begin, size_t end) {
+                    for (size_t li = begin; li < end; ++li) split(li);
+                });
+
+            level.clear();
+            for (const Range &r : next)
+                if (r.e - r.b > kLeafSize) level.push_back(r);
+        }
+
+        m_pos.resize(n);
+        tracey::parallel_for_chunks(n, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) m_pos[s] = positions[m_index[s]];
+        });
+    }
+
+    int PointKdTree::findNearest(const Vec3 &p, int k, float maxRadius, uint32_t exclude,
+                                 uint32_t *outIndex, float *outDist2) const
+    {
+        k = std::min(k, kMaxK);
+        if (k <= 0 || m_index.empty()) return 0;
+
+        // Max-heap of the best k so far on (dist2, index): the worst
+        // candidate sits on top and bounds the search.
+        using Candidate = std::pair<float, uint32_t>;
+        Candidate heap[kMaxK];
+        int count = 0;
+        const float r2 = maxRadius * maxRadius;
+        auto bound = [&] { return count < k ? r2 : heap[0].first; };
+        auto offer = [&](uint32_t slot) {
+            const uint32_t idx = m_index[slot];
+            if (idx == exclude) return;
+            const Vec3 &q = m_pos[slot];
+            const float ex = q.x - p.x;
+            const float ey = q.y - p.y;
+            const float ez = q.z - p.z;
+            const Candidate c{ex * ex + ey * ey + ez * ez, idx};
+            if (c.first > r2) return;
+            if (count < k)
+            {
+                heap[count++] = c;
+                std::push_heap(heap, heap + count);
+            }
+            else if (c < heap[0])
+            {
+                std::pop_heap(heap, heap + count);
+                heap[count - 1] = c;
+                std::push_heap(heap, heap + count);
+            }
+        };
+
+        struct Entry { uint32_t b, e; float d2; };
+        Entry stack[kStackDepth];
+        int sp = 0;
+        stack[sp++] = {0, static_cast<uint32_t>(m_index.size()), 0.0f};
+        while (sp > 0)
+        {
+            const Entry top = stack[--sp];
+            // The split-plane distance is a lower bound for everything in
+            // the range; skip it if the heap has tightened since the push.
+            if (top.d2 > bound()) continue;
+            uint32_t b = top.b, e = top.e;
+            while (e > b)
+            {
+                if (e - b <= kLeafSize)
+                {
+                    for (uint32_t s = b; s < e; ++s) offer(s);
+                    break;
+                }
+                const uint32_t mid = b + (e - b) / 2;
+                offer(mid);
+                const int axis = m_axis[mid];
+                const float diff = p[axis] - m_pos[mid][axis];
+                const float d2 = diff * diff;
+                if (diff < 0.0f)
+                {
+                    if (d2 <= bound()) stack[sp++] = {mid + 1, e, d2};
+                    e = mid;
+                }
+                else
+                {
+                    if (d2 <= bound()) stack[sp++] = {b, mid, d2};
+                    b = mid + 1;
+                }
+            }
+        }
+
+        std::sort_heap(heap, heap + count);
+        for (int i = 0; i < count; ++i)
+        {
+            outIndex[i] = heap[i].second;
+            if (outDist2) outDist2[i] = heap[i].first;
+        }
+        return count;
+    }
+
+    std::shared_ptr<const PointKdTree> acquirePointKdTree(const AttributeTable &points)
+    {
+        const auto *P = points.get<Vec3>("P");
+        const uint64_t generation = P ? P->generation() : 0;
+        const size_t n = P ? P->size() : 0;
+
+        auto &cache = points.spatialIndexCache();
+        if (cache && cache->sourceGeneration() == generation && cache->size() == n) return cache;
+
+        auto tree = std::make_shared<PointKdTree>();
+        static const std::vector<Vec3> kEmpty;
+        tree->build(P ? P->data() : kEmpty);
+        tree->setSourceGeneration(generation);
+        cache = tree;
+        return cache;
+    }
+}
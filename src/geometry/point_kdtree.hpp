@@ -0,0 +1,121 @@
+#pragma once
+
+#include "../core/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tracey
+{
+    class AttributeTable;
+
+    // Static 3D KD-tree over a point set — the spatial index behind the
+    // point-cloud VOPs (pc_nearest, pc_radius) and the point_relax SOP.
+    //
+    // Layout is implicit: the node for index range [b, e) is the median slot
+    // b + (e - b) / 2, its children are [b, mid) and [mid + 1, e), and ranges
+    // of kLeafSize points or fewer are leaves scanned linearly. No child
+    // pointers, no per-node bounds — only the permuted positions (copied, so
+    // a query walks contiguous memory), their original indices and one split
+    // axis byte per slot.
+    //
+    // Build splits each range at the median of its widest axis. Ranges of
+    // one tree level are independent, so every level is one parallel pass
+    // (the top levels have few ranges and run mostly serially; by the time
+    // the ranges get small there are enough of them to fill the pool).
+    // Ties are broken by point index, so the tree — and every query result
+    // — is deterministic.
+    //
+    // Queries never allocate: traversal uses a fixed stack and k-nearest
+    // results go to caller buffers of at most kMaxK entries, so they can run
+    // inside a parallel_for_chunks body as-is.
+    class PointKdTree
+    {
+    public:
+        static constexpr int kMaxK = 64;
+        static constexpr uint32_t kNoExclude = 0xffffffffu;
+
+        void build(const std::vector<Vec3> &positions);
+
+        size_t size() const { return m_index.size(); }
+
+        // Up to k (clamped to kMaxK) nearest points to `p` with
+        // |q - p| <= maxRadius, closest first (ties by lower index). Point
+        // `exclude` is skipped (kNoExclude for none). Returns the count
+        // written to outIndex / outDist2.
+        int findNearest(const Vec3 &p, int k, float maxRadius, uint32_t exclude,
+                        uint32_t *outIndex, float *outDist2) const;
+
+        // Calls fn(index, q, dist2) for every point within `radius` of `p`,
+        // in tree order (fixed for a given tree, so sums over the visited
+        // points are deterministic).
+        template <typename Fn>
+        void forEachInRadius(const Vec3 &p, float radius, Fn &&fn) const
+        {
+            if (m_index.empty()) return;
+            const float r2 = radius * radius;
+            struct Range { uint32_t b, e; };
+            Range stack[kStackDepth];
+            int sp = 0;
+            stack[sp++] = {0, static_cast<uint32_t>(m_index.size())};
+            while (sp > 0)
+            {
+                Range r = stack[--sp];
+                while (r.e > r.b)
+                {
+                    if (r.e - r.b <= kLeafSize)
+                    {
+                        for (uint32_t s = r.b; s < r.e; ++s) visit(p, r2, s, fn);
+                        break;
+                    }
+                    const uint32_t mid = r.b + (r.e - r.b) / 2;
+                    visit(p, r2, mid, fn);
+                    const int axis = m_axis[mid];
+                    const float diff = p[axis] - m_pos[mid][axis];
+                    const Range lo{r.b, mid};
+                    const Range hi{mid + 1, r.e};
+                    if (diff * diff <= r2) stack[sp++] = diff < 0.0f ? hi : lo;
+                    r = diff < 0.0f ? lo : hi;
+                }
+            }
+        }
+
+        // Cache key bookkeeping for acquirePointKdTree().
+        uint64_t sourceGeneration() const { return m_sourceGeneration; }
+        void setSourceGeneration(uint64_t generation) { m_sourceGeneration = generation; }
+
+    private:
+        static constexpr uint32_t kLeafSize = 8;
+        // One pending far child per level; 64 levels covers any index range.
+        static constexpr int kStackDepth = 64;
+
+        template <typename Fn>
+        void visit(const Vec3 &p, float r2, uint32_t slot, Fn &fn) const
+        {
+            const Vec3 &q = m_pos[slot];
+            const float ex = q.x - p.x;
+            const float ey = q.y - p.y;
+            const float ez = q.z - p.z;
+            const float d2 = ex * ex + ey * ey + ez * ez;
+            if (d2 <= r2) fn(m_index[slot], q, d2);
+        }
+
+        std::vector<Vec3> m_pos;      // positions in tree order
+        std::vector<uint32_t> m_index; // original point index per slot
+        std::vector<uint8_t> m_axis;   // split axis of internal-node slots
+        uint64_t m_sourceGeneration = 0;
+    };
+
+    // KD-tree over `points`' P, built on first use and cached on the table.
+    // Every caller shares it until P changes (attribute generation or point
+    // count), so several point-cloud nodes in one cook — and later cooks of
+    // an unchanged upstream — pay for one build. The cache rides along when
+    // the table is copied; the tree is immutable, so copies just share it.
+    //
+    // Not thread-safe: call from serial setup (VopNode::prepare, the top of
+    // a SOP cook), hold on to the returned pointer, then query it from as
+    // many threads as you like. Returns an empty tree when P is missing.
+    std::shared_ptr<const PointKdTree> acquirePointKdTree(const AttributeTable &points);
+}
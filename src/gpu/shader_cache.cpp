@@ -0,0 +1,355 @@
+#include "shader_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace tracey
+{
+    namespace
+    {
+        constexpr char kMagic[4] = {'T', 'S', 'P', 'V'};
+        constexpr uint32_t kFormatVersion = 1;
+        constexpr uint32_t kSpirvMagic = 0x07230203u;
+        constexpr const char *kExtension = ".spv";
+
+        // Fixed-size little header in front of the SPIR-V words. Written
+        // and read as raw bytes: the cache is per-machine, never shipped.
+        struct FileHeader
+        {
+            char magic[4];
+            uint32_t version;
+            uint64_t keyLo;
+            uint64_t keyHi;
+            uint64_t payloadHash;
+            uint32_t wordCount;
+            uint32_t reserved;
+        };
+        static_assert(sizeof(FileHeader) == 40);
+
+        // Two unrelated 64-bit hashes fed the same bytes, for a 128-bit
+        // key: FNV-1a and a word-at-a-time multiply / xor-shift mix.
+        struct KeyHasher
+        {
+            uint64_t fnv = 0xcbf29ce484222325ULL;
+            uint64_t mix = 0x9e3779b97f4a7c15ULL;
+
+            void bytes(const void *p, size_t n)
+            {
+                const auto *b = static_cast<const unsigned char *>(p);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    fnv ^= b[i];
+                    fnv *= 0x00000100000001b3ULL;
+                }
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8)
+                {
+                    uint64_t w;
+                    std::memcpy(&w, b + i, 8);
+                    word(w);
+                }
+                uint64_t tail = 0;
+                std::memcpy(&tail, b + i, n - i);
+                word(tail ^ (static_cast<uint64_t>(n - i) << 56));
+            }
+            void word(uint64_t w)
+            {
+                mix = (mix ^ w) * 0xff51afd7ed558ccdULL;
+                mix ^= mix >> 32;
+            }
+            // Length-prefixed, so ("ab", "c") and ("a", "bc") differ.
+            void field(std::string_view s)
+            {
+                const uint64_t len = s.size();
+                bytes(&len, sizeof(len));
+                bytes(s.data(), s.size());
+            }
+        };
+
+        uint64_t payloadHash(std::span<const uint32_t> words)
+        {
+            KeyHasher h;
+            h.bytes(words.data(), words.size_bytes());
+            return h.fnv ^ h.mix;
+        }
+
+        std::string uniqueSuffix()
+        {
+            static std::atomic<uint64_t> s_counter{0};
+            const auto now = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            const auto tid = static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            return ".tmp" + std::to_string(now ^ (tid << 1)) + "_" + std::to_string(s_counter++);
+        }
+
+        std::filesystem::path envPath(const char *name)
+        {
+            const char *v = std::getenv(name);
+            return (v && *v) ? std::filesystem::path(v) : std::filesystem::path();
+        }
+    }
+
+    std::filesystem::path ShaderCacheConfig::defaultDirectory()
+    {
+        if (const char *env = std::getenv("TRACEY_SHADER_CACHE_DIR"))
+            return std::filesystem::path(env);
+
+        std::filesystem::path base;
+#if defined(_WIN32)
+        base = envPath("LOCALAPPDATA");
+        if (!base.empty()) return base / "tracey" / "shaders";
+#elif defined(__APPLE__)
+        base = envPath("HOME");
+        if (!base.empty()) return base / "Library" / "Caches" / "tracey" / "shaders";
+#else
+        base = envPath("XDG_CACHE_HOME");
+        if (!base.empty()) return base / "tracey" / "shaders";
+        base = envPath("HOME");
+        if (!base.empty()) return base / ".cache" / "tracey" / "shaders";
+#endif
+        std::error_code ec;
+        const auto tmp = std::filesystem::temp_directory_path(ec);
+        if (ec) return {};
+        return tmp / "tracey_shader_cache";
+    }
+
+    ShaderCache &ShaderCache::instance()
+    {
+        static ShaderCache cache;
+        return cache;
+    }
+
+    ShaderCache::ShaderCache(ShaderCacheConfig config)
+        : m_config(std::move(config))
+    {
+    }
+
+    void ShaderCache::setConfig(ShaderCacheConfig config)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config = std::move(config);
+        m_diskBytes = 0;
+        m_scanned = false;
+        m_warned = false;
+    }
+
+    ShaderCacheConfig ShaderCache::config() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_config;
+    }
+
+    bool ShaderCache::enabled() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return !m_config.directory.empty();
+    }
+
+    ShaderCache::Key ShaderCache::makeKey(std::string_view stage, std::string_view source,
+                                          std::string_view name, std::string_view compilerVersion)
+    {
+        KeyHasher h;
+        h.field("tracey-spirv-cache");
+        h.field(stage);
+        h.field(compilerVersion);
+        h.field(name);
+        h.field(source);
+        return {h.fnv, h.mix};
+    }
+
+    std::filesystem::path ShaderCache::pathFor(const Key &key, const std::filesystem::path &dir) const
+    {
+        char name[40];
+        std::snprintf(name, sizeof(name), "%016llx%016llx",
+                      static_cast<unsigned long long>(key.hi),
+                      static_cast<unsigned long long>(key.lo));
+        return dir / (std::string(name) + kExtension);
+    }
+
+    bool ShaderCache::load(const Key &key, std::vector<uint32_t> &spirv)
+    {
+        const std::filesystem::path dir = config().directory;
+        if (dir.empty())
+        {
+            m_misses++;
+            return false;
+        }
+        const auto path = pathFor(key, dir);
+        std::ifstream f(path, std::ios::binary);
+        if (!f)
+        {
+            m_misses++;
+            return false;
+        }
+
+        FileHeader h{};
+        bool ok = static_cast<bool>(f.read(reinterpret_cast<char *>(&h), sizeof(h))) &&
+                  std::memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 &&
+                  h.version == kFormatVersion &&
+                  h.keyLo == key.lo && h.keyHi == key.hi &&
+                  h.wordCount > 0 && h.wordCount <= (uint32_t(1) << 28);
+        std::vector<uint32_t> words;
+        if (ok)
+        {
+            words.resize(h.wordCount);
+            ok = static_cast<bool>(f.read(reinterpret_cast<char *>(words.data()),
+                                          static_cast<std::streamsize>(words.size() * sizeof(uint32_t))));
+            // Trailing bytes mean the file is not what the header says.
+            ok = ok && f.peek() == std::ifstream::traits_type::eof();
+            ok = ok && words[0] == kSpirvMagic && payloadHash(words) == h.payloadHash;
+        }
+        f.close();
+        if (!ok)
+        {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            m_rejected++;
+            m_misses++;
+            return false;
+        }
+
+        // Refresh the mtime so eviction sees this module as recently used.
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        spirv = std::move(words);
+        m_hits++;
+        return true;
+    }
+
+    void ShaderCache::store(const Key &key, std::span<const uint32_t> spirv)
+    {
+        if (spirv.empty()) return;
+        const ShaderCacheConfig cfg = config();
+        if (cfg.directory.empty()) return;
+
+        std::error_code ec;
+        std::filesystem::create_directories(cfg.directory, ec);
+        const auto path = pathFor(key, cfg.directory);
+        auto tmp = path;
+        tmp += uniqueSuffix();
+
+        FileHeader h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kFormatVersion;
+        h.keyLo = key.lo;
+        h.keyHi = key.hi;
+        h.payloadHash = payloadHash(spirv);
+        h.wordCount = static_cast<uint32_t>(spirv.size());
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            if (f)
+            {
+                f.write(reinterpret_cast<const char *>(&h), sizeof(h));
+                f.write(reinterpret_cast<const char *>(spirv.data()),
+                        static_cast<std::streamsize>(spirv.size_bytes()));
+            }
+            if (f) f.close();
+            if (!f)
+            {
+                std::filesystem::remove(tmp, ec);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_warned)
+                    std::cerr << "ShaderCache: could not write to " << cfg.directory.string()
+                              << "; shaders will be recompiled\n";
+                m_warned = true;
+                return;
+            }
+        }
+
+        const uint64_t replaced = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+        std::filesystem::rename(tmp, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+        m_stores++;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_config.directory != cfg.directory) return;
+        if (!m_scanned)
+        {
+            trimLocked(cfg.directory, cfg.maxBytes);
+            return;
+        }
+        m_diskBytes += sizeof(FileHeader) + spirv.size_bytes();
+        m_diskBytes -= std::min(m_diskBytes, replaced);
+        if (m_diskBytes > cfg.maxBytes) trimLocked(cfg.directory, cfg.maxBytes);
+    }
+
+    void ShaderCache::trimLocked(const std::filesystem::path &dir, uint64_t maxBytes)
+    {
+        struct Entry
+        {
+            std::filesystem::path path;
+            std::filesystem::file_time_type time;
+            uint64_t bytes;
+        };
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+        std::error_code ec;
+        for (auto it = std::filesystem::directory_iterator(dir, ec);
+             !ec && it != std::filesystem::directory_iterator(); it.increment(ec))
+        {
+            if (it->path().extension() != kExtension) continue;
+            std::error_code fec;
+            const uint64_t bytes = it->file_size(fec);
+            if (fec) continue;
+            entries.push_back({it->path(), it->last_write_time(fec), bytes});
+            total += bytes;
+        }
+        m_scanned = true;
+
+        // Trim to 90% of the cap so a cache sitting at its limit does not
+        // rescan the directory on every store.
+        const uint64_t target = maxBytes - maxBytes / 10;
+        if (total > maxBytes)
+        {
+            std::sort(entries.begin(), entries.end(),
+                      [](const Entry &a, const Entry &b) { return a.time < b.time; });
+            for (const Entry &e : entries)
+            {
+                if (total <= target) break;
+                if (!std::filesystem::remove(e.path, ec)) continue;
+                total -= e.bytes;
+                m_evictions++;
+            }
+        }
+        m_diskBytes = total;
+    }
+
+    void ShaderCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_config.directory.empty()) return;
+        trimLocked(m_config.directory, 0);
+        m_diskBytes = 0;
+    }
+
+    ShaderCacheStats ShaderCache::stats() const
+    {
+        ShaderCacheStats s;
+        s.hits = m_hits.load();
+        s.misses = m_misses.load();
+        s.stores = m_stores.load();
+        s.evictions = m_evictions.load();
+        s.rejected = m_rejected.load();
+        return s;
+    }
+
+    void ShaderCache::resetStats()
+    {
+        m_hits = 0;
+        m_misses = 0;
+        m_stores = 0;
+        m_evictions = 0;
+        m_rejected = 0;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace tracey
+{
+    // Tuning knobs for the on-disk SPIR-V cache.
+    //
+    //   directory — where compiled modules live. Empty disables the cache
+    //               (every compile goes to shaderc).
+    //   maxBytes  — cap on the directory's total size. When a store pushes
+    //               it over, the least recently used modules are deleted.
+    struct ShaderCacheConfig
+    {
+        std::filesystem::path directory = defaultDirectory();
+        uint64_t maxBytes = uint64_t(256) << 20;
+
+        // $TRACEY_SHADER_CACHE_DIR when set (an empty value disables the
+        // cache), otherwise the per-user cache directory
+        // (~/.cache/tracey/shaders, ~/Library/Caches/tracey/shaders,
+        // %LOCALAPPDATA%\tracey\shaders), falling back to
+        // <system temp>/tracey_shader_cache.
+        static std::filesystem::path defaultDirectory();
+    };
+
+    // Running totals since the last resetStats().
+    struct ShaderCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        uint64_t evictions = 0;
+        uint64_t rejected = 0; // unreadable / corrupt files treated as misses
+    };
+
+    // Content-addressed cache of compiled SPIR-V, shared by every process
+    // that points at the same directory. ShaderCompiler consults it before
+    // invoking shaderc, so warm launches and re-opened VOP graphs skip
+    // GLSL compilation entirely.
+    //
+    // A module is stored as <key>.spv, where the 128-bit key covers the
+    // shader stage, source text, source name and compiler version. Writes
+    // go to a uniquely named temporary and are renamed into place, so a
+    // concurrent reader (another thread or another editor instance) sees
+    // either the whole module or nothing. Files are validated on load
+    // (header, key, length, payload hash, SPIR-V magic); anything that
+    // fails is deleted and reported as a miss.
+    class ShaderCache
+    {
+    public:
+        struct Key
+        {
+            uint64_t lo = 0;
+            uint64_t hi = 0;
+            bool operator==(const Key &) const = default;
+        };
+
+        static ShaderCache &instance();
+
+        explicit ShaderCache(ShaderCacheConfig config = {});
+
+        void setConfig(ShaderCacheConfig config);
+        ShaderCacheConfig config() const;
+        bool enabled() const;
+
+        // `stage` and `compilerVersion` are opaque strings; anything that
+        // changes the generated code (stage, target env, optimisation
+        // level, glslang revision) belongs in one of them. Sources are
+        // compiled without an include resolver, so the source text is the
+        // complete input; a resolver would have to add the resolved files
+        // to the key.
+        static Key makeKey(std::string_view stage, std::string_view source,
+                           std::string_view name, std::string_view compilerVersion);
+
+        // Fills `spirv` and returns true on a hit. Thread-safe.
+        bool load(const Key &key, std::vector<uint32_t> &spirv);
+        // Best effort: a failed write is reported once on stderr and
+        // otherwise ignored. Thread-safe.
+        void store(const Key &key, std::span<const uint32_t> spirv);
+
+        // Deletes every cached module in the directory.
+        void clear();
+
+        ShaderCacheStats stats() const;
+        void resetStats();
+
+    private:
+        std::filesystem::path pathFor(const Key &key, const std::filesystem::path &dir) const;
+        void trimLocked(const std::filesystem::path &dir, uint64_t maxBytes);
+
+        mutable std::mutex m_mutex;
+        ShaderCacheConfig m_config;
+        // Bytes of *.spv in the directory, counted on first use and kept
+        // up to date by store / eviction. Other processes writing to the
+        // same directory make it an underestimate until the next trim
+        // rescans.
+        uint64_t m_diskBytes = 0;
+        bool m_scanned = false;
+        bool m_warned = false;
+
+        std::atomic<uint64_t> m_hits{0};
+        std::atomic<uint64_t> m_misses{0};
+        std::atomic<uint64_t> m_stores{0};
+        std::atomic<uint64_t> m_evictions{0};
+        std::atomic<uint64_t> m_rejected{0};
+    };
+}
@@ -1,23 +1,68 @@
 #include "shader_compiler.hpp"
+#include "shader_cache.hpp"
 #include <shaderc/shaderc.hpp>
+#if __has_include(<glslang/build_info.h>)
+#include <glslang/build_info.h>
+#endif
 #include <fstream>
+#include <string>
+
+#ifndef TRACEY_SHADERC_VERSION
+#define TRACEY_SHADERC_VERSION ""
+#endif
 
 namespace tracey
 {
+    namespace
+    {
+        // Identity of the compiler that produced a module, folded into every
+        // cache key so a toolchain upgrade invalidates old modules: the
+        // glslang release (build_info.h, shipped with the shaderc/SDK
+        // headers) plus the shaderc / Vulkan SDK version CMake detected.
+        // shaderc_get_spv_version only names the SPIR-V spec version it
+        // targets, which stays put across compiler releases; it is kept
+        // because it changes the emitted modules too.
+        const std::string &compilerVersion()
+        {
+            static const std::string version = [] {
+                std::string id = "shaderc build=" TRACEY_SHADERC_VERSION;
+#if defined(GLSLANG_VERSION_MAJOR)
+                id += " glslang=" + std::to_string(GLSLANG_VERSION_MAJOR) + "." +
+                      std::to_string(GLSLANG_VERSION_MINOR) + "." + std::to_string(GLSLANG_VERSION_PATCH) +
+                      GLSLANG_VERSION_FLAVOR;
+#endif
+                unsigned int spv = 0, revision = 0;
+                shaderc_get_spv_version(&spv, &revision);
+                return id + " spv=" + std::to_string(spv) + " rev=" + std::to_string(revision) +
+                       " env=vulkan opt=none";
+            }();
+            return version;
+        }
+    }
+
     std::vector<uint32_t> ShaderCompiler::compileComputeShader(const std::string_view source, const std::string_view sourceName)
     {
+        auto &cache = ShaderCache::instance();
+        const auto key = ShaderCache::makeKey("comp", source, sourceName, compilerVersion());
+        std::vector<uint32_t> spirv;
+        if (cache.load(key, spirv)) return spirv;
+
         shaderc::Compiler compiler;
         shaderc::CompileOptions options;
 
+        // shaderc wants a NUL-terminated name; a string_view need not be.
+        const std::string name(sourceName);
         shaderc::SpvCompilationResult module =
-            compiler.CompileGlslToSpv(source.data(), source.size(), shaderc_compute_shader, sourceName.data(), options);
+            compiler.CompileGlslToSpv(source.data(), source.size(), shaderc_compute_shader, name.c_str(), options);
 
         if (module.GetCompilationStatus() != shaderc_compilation_status_success)
         {
             throw std::runtime_error("Shader compilation failed: " + module.GetErrorMessage());
         }
 
-        return {module.cbegin(), module.cend()};
+        spirv.assign(module.cbegin(), module.cend());
+        cache.store(key, spirv);
+        return spirv;
     }
     std::vector<uint32_t> ShaderCompiler::compileComputeShader(const std::filesystem::path &filePath)
     {
@@ -31,4 +76,4 @@ namespace tracey
                            std::istreambuf_iterator<char>());
         return compileComputeShader(source, filePath.filename().string());
     }
-}
\ No newline at end of file
+}
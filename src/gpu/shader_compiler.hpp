@@ -4,6 +4,9 @@
 #include <filesystem>
 namespace tracey
 {
+    // GLSL → SPIR-V through shaderc. Results go through the on-disk
+    // ShaderCache (shader_cache.hpp): a source compiled once by any run is
+    // loaded instead of recompiled.
     class ShaderCompiler
     {
     public:
@@ -1,5 +1,8 @@
 #include "graph.hpp"
 #include "node.hpp"
+
+#include <algorithm>
+
 namespace tracey
 {
     Graph::~Graph()
@@ -18,6 +21,40 @@ namespace tracey
     {
         m_nodes.emplace_back(std::move(node));
     }
+    std::unique_ptr<Node> Graph::removeNode(size_t uid)
+    {
+        auto it = std::find_if(m_nodes.begin(), m_nodes.end(),
+                               [uid](const std::unique_ptr<Node> &n) { return n->uid() == uid; });
+        if (it == m_nodes.end()) return nullptr;
+        std::unique_ptr<Node> node = std::move(*it);
+        m_nodes.erase(it);
+        std::erase_if(m_connections, [uid](const Connection &c) {
+            return c.fromNode == uid || c.toNode == uid;
+        });
+        return node;
+    }
+    std::unique_ptr<Node> Graph::replaceNode(std::unique_ptr<Node> node)
+    {
+        for (auto &n : m_nodes)
+        {
+            if (n->uid() == node->uid())
+            {
+                std::swap(n, node);
+                return node;
+            }
+        }
+        return nullptr;
+    }
+    bool Graph::removeConnection(const Connection &connection)
+    {
+        auto it = std::find_if(m_connections.begin(), m_connections.end(), [&](const Connection &c) {
+            return c.fromNode == connection.fromNode && c.fromPort == connection.fromPort &&
+                   c.toNode == connection.toNode && c.toPort == connection.toPort;
+        });
+        if (it == m_connections.end()) return false;
+        m_connections.erase(it);
+        return true;
+    }
     size_t Graph::uid() const
     {
         return m_uid;
@@ -19,6 +19,16 @@ namespace tracey
 
         void addNode(std::unique_ptr<Node> node);
 
+        // In-place edits used by incremental graph patches. removeNode also
+        // drops every connection touching the node; replaceNode keeps the
+        // old node's slot (and so serialization order) and its connections.
+        // Both return the detached node, or nullptr if no node had that uid
+        // (replaceNode then leaves the graph untouched).
+        std::unique_ptr<Node> removeNode(size_t uid);
+        std::unique_ptr<Node> replaceNode(std::unique_ptr<Node> node);
+        // Removes the first identical connection. False if none matched.
+        bool removeConnection(const Connection &connection);
+
         size_t uid() const;
 
         const std::vector<std::unique_ptr<Node>> &nodes() const { return m_nodes; }
@@ -1,12 +1,329 @@
 #include "denoiser.hpp"
 
+#include "../core/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
 #ifdef TRACEY_HAS_OIDN
 #include <OpenImageDenoise/oidn.h>
 #endif
 
 namespace tracey
 {
+    // Scratch planes for one à-trous run, reused across PreviewDenoiser
+    // frames so the viewport does not reallocate them every sample.
+    struct ATrousScratch
+    {
+        // Guides, structure-of-arrays so the inner loops read contiguous
+        // floats. Normals are unit length (zero = background).
+        std::vector<float> nx, ny, nz, z, dz, ar, ag, ab;
+        // Ping-pong demodulated signal + its variance and luminance.
+        std::vector<float> r[2], g[2], b[2], var[2], lum[2];
+        std::vector<float> varBlur, tmp;
+
+        void resize(size_t n, bool normals, bool depth, bool albedo)
+        {
+            auto fit = [n](std::vector<float> &v, bool on) { v.resize(on ? n : 0); };
+            fit(nx, normals); fit(ny, normals); fit(nz, normals);
+            fit(z, depth); fit(dz, depth);
+            fit(ar, albedo); fit(ag, albedo); fit(ab, albedo);
+            for (int i = 0; i < 2; ++i)
+            {
+                fit(r[i], true); fit(g[i], true); fit(b[i], true);
+                fit(var[i], true); fit(lum[i], true);
+            }
+            fit(varBlur, true);
+            fit(tmp, true);
+        }
+    };
+
+    namespace
+    {
+        // B3-spline taps of the à-trous wavelet.
+        constexpr float kKernel[5] = {1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+
+        // Albedo below this is not divided out: near-black surfaces would
+        // amplify their noise instead of flattening their texture.
+        constexpr float kMinDemodAlbedo = 0.01f;
+
+        inline float luminance(float r, float g, float b)
+        {
+            return 0.2126f * r + 0.7152f * g + 0.0722f * b;
+        }
+        inline float demodFactor(float a) { return a > kMinDemodAlbedo ? a : 1.0f; }
+
+        // 3×3 binomial blur of `src` into `dst`, clamped at the borders.
+        void blur3x3(int w, int h, const std::vector<float> &src, std::vector<float> &tmp,
+                     std::vector<float> &dst)
+        {
+            parallel_for_each_index(static_cast<size_t>(h), [&](size_t y) {
+                const float *row = src.data() + y * w;
+                float *t = tmp.data() + y * w;
+                for (int x = 0; x < w; ++x)
+                    t[x] = 0.25f * row[std::max(x - 1, 0)] + 0.5f * row[x] + 0.25f * row[std::min(x + 1, w - 1)];
+            });
+            parallel_for_each_index(static_cast<size_t>(h), [&](size_t y) {
+                const int yi = static_cast<int>(y);
+                const float *up = tmp.data() + static_cast<size_t>(std::max(yi - 1, 0)) * w;
+                const float *mid = tmp.data() + y * w;
+                const float *dn = tmp.data() + static_cast<size_t>(std::min(yi + 1, h - 1)) * w;
+                float *d = dst.data() + y * w;
+                for (int x = 0; x < w; ++x) d[x] = 0.25f * up[x] + 0.5f * mid[x] + 0.25f * dn[x];
+            });
+        }
+
+        // Edge-avoiding à-trous filter. Colour is demodulated by albedo so
+        // texture detail survives, filtered for `iterations` levels with
+        // a 5×5 kernel whose taps spread 2^level pixels apart, and
+        // re-modulated into `out` (RGB at `outStride` floats per pixel).
+        // `out` may alias `color`: the input is fully consumed first.
+        void atrous(int w, int h, const float *color, const float *albedo, const float *normal,
+                    float *out, size_t outStride, const DenoiseOptions &opt, ATrousScratch &s)
+        {
+            const size_t n = static_cast<size_t>(w) * h;
+            const float *depth = opt.depthRGBA;
+            s.resize(n, normal != nullptr, depth != nullptr, albedo != nullptr);
+
+            // ── Guides + demodulated input ────────────────────────────────
+            parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    float fr = 1.0f, fg = 1.0f, fb = 1.0f;
+                    if (albedo)
+                    {
+                        s.ar[i] = albedo[i * 4 + 0];
+                        s.ag[i] = albedo[i * 4 + 1];
+                        s.ab[i] = albedo[i * 4 + 2];
+                        fr = demodFactor(s.ar[i]);
+                        fg = demodFactor(s.ag[i]);
+                        fb = demodFactor(s.ab[i]);
+                    }
+                    if (normal)
+                    {
+                        const float x = normal[i * 4 + 0], y = normal[i * 4 + 1], z = normal[i * 4 + 2];
+                        const float len2 = x * x + y * y + z * z;
+                        const float inv = len2 > 1e-12f ? 1.0f / std::sqrt(len2) : 0.0f;
+                        s.nx[i] = x * inv;
+                        s.ny[i] = y * inv;
+                        s.nz[i] = z * inv;
+                    }
+                    if (depth) s.z[i] = depth[i * 4];
+                    const float r = color[i * 4 + 0] / fr;
+                    const float g = color[i * 4 + 1] / fg;
+                    const float b = color[i * 4 + 2] / fb;
+                    s.r[0][i] = r;
+                    s.g[0][i] = g;
+                    s.b[0][i] = b;
+                    s.lum[0][i] = luminance(r, g, b);
+                    if (opt.variance)
+                    {
+                        const float fl = std::max(luminance(fr, fg, fb), 1e-4f);
+                        s.var[0][i] = std::max(opt.variance[i], 0.0f) / (fl * fl);
+                    }
+                }
+            });
+
+            if (depth)
+            {
+                // Screen-space depth gradient, so the depth stop scales with
+                // how steeply the surface recedes rather than with scene units.
+                parallel_for_each_index(static_cast<size_t>(h), [&](size_t y) {
+                    const int yi = static_cast<int>(y);
+                    for (int x = 0; x < w; ++x)
+                    {
+                        const size_t i = y * w + x;
+                        const float zc = s.z[i];
+                        auto at = [&](int xx, int yy) {
+                            xx = std::clamp(xx, 0, w - 1);
+                            yy = std::clamp(yy, 0, h - 1);
+                            const float v = s.z[static_cast<size_t>(yy) * w + xx];
+                            return v > 0.0f ? v : zc;
+                        };
+                        s.dz[i] = 0.5f * std::max(std::fabs(at(x + 1, yi) - at(x - 1, yi)),
+                                                  std::fabs(at(x, yi + 1) - at(x, yi - 1)));
+                    }
+                });
+            }
+
+            if (!opt.variance)
+            {
+                // No per-pixel statistics: take the luminance variance over
+                // each 3×3 neighbourhood.
+                std::vector<float> &mean = s.varBlur;
+                std::vector<float> &sq = s.var[1];
+                parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) sq[i] = s.lum[0][i] * s.lum[0][i];
+                });
+                blur3x3(w, h, s.lum[0], s.tmp, mean);
+                blur3x3(w, h, sq, s.tmp, s.var[0]);
+                parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                        s.var[0][i] = std::max(0.0f, s.var[0][i] - mean[i] * mean[i]);
+                });
+            }
+
+            // ── Wavelet levels ────────────────────────────────────────────
+            const int iterations = std::clamp(opt.iterations, 0, 10);
+            const float colorSigma = std::max(opt.colorSigma, 1e-3f);
+            const float depthSigma = std::max(opt.depthSigma, 1e-3f);
+            const float invAlbedoSigma = 1.0f / std::max(opt.albedoSigma, 1e-4f);
+            const float normalPower = std::max(opt.normalPower, 0.0f);
+            int src = 0;
+            for (int it = 0; it < iterations; ++it)
+            {
+                const int dst = src ^ 1;
+                const int step = 1 << it;
+                blur3x3(w, h, s.var[src], s.tmp, s.varBlur);
+
+                parallel_for_each_index(static_cast<size_t>(h), [&](size_t y) {
+                    const int yi = static_cast<int>(y);
+                    const float *R = s.r[src].data(), *G = s.g[src].data(), *B = s.b[src].data();
+                    const float *L = s.lum[src].data(), *V = s.var[src].data();
+                    for (int x = 0; x < w; ++x)
+                    {
+                        const size_t p = y * w + x;
+                        const float lp = L[p];
+                        const float invL = 1.0f / (colorSigma * std::sqrt(s.varBlur[p]) + 1e-4f);
+                        const bool pHit = normal ? (s.nx[p] != 0.0f || s.ny[p] != 0.0f || s.nz[p] != 0.0f) : true;
+
+                        float sr = 0.0f, sg = 0.0f, sb = 0.0f, sv = 0.0f, sw = 0.0f;
+                        for (int ky = -2; ky <= 2; ++ky)
+                        {
+                            const int qy = yi + ky * step;
+                            if (qy < 0 || qy >= h) continue;
+                            for (int kx = -2; kx <= 2; ++kx)
+                            {
+                                const int qx = x + kx * step;
+                                if (qx < 0 || qx >= w) continue;
+                                const size_t q = static_cast<size_t>(qy) * w + qx;
+
+                                float e = -std::fabs(lp - L[q]) * invL;
+                                float wn = 1.0f;
+                                if (normal)
+                                {
+                                    const float d = s.nx[p] * s.nx[q] + s.ny[p] * s.ny[q] + s.nz[p] * s.nz[q];
+                                    const bool qHit = s.nx[q] != 0.0f || s.ny[q] != 0.0f || s.nz[q] != 0.0f;
+                                    wn = pHit != qHit ? 0.0f : pHit ? std::pow(std::max(d, 0.0f), normalPower) : 1.0f;
+                                }
+                                if (depth)
+                                {
+                                    const float dist = static_cast<float>(step * (std::abs(kx) + std::abs(ky)));
+                                    e -= std::fabs(s.z[p] - s.z[q]) /
+                                         (depthSigma * s.dz[p] * dist + 1e-3f * s.z[p] + 1e-6f);
+                                }
+                                if (albedo)
+                                {
+                                    e -= (std::fabs(s.ar[p] - s.ar[q]) + std::fabs(s.ag[p] - s.ag[q]) +
+                                          std::fabs(s.ab[p] - s.ab[q])) * invAlbedoSigma;
+                                }
+                                const float wgt = kKernel[kx + 2] * kKernel[ky + 2] * wn * std::exp(e);
+                                sr += wgt * R[q];
+                                sg += wgt * G[q];
+                                sb += wgt * B[q];
+                                sv += wgt * wgt * V[q];
+                                sw += wgt;
+                            }
+                        }
+                        // The centre tap always contributes, so sw > 0.
+                        const float inv = 1.0f / sw;
+                        s.r[dst][p] = sr * inv;
+                        s.g[dst][p] = sg * inv;
+                        s.b[dst][p] = sb * inv;
+                        s.var[dst][p] = sv * inv * inv;
+                        s.lum[dst][p] = luminance(s.r[dst][p], s.g[dst][p], s.b[dst][p]);
+                    }
+                });
+                src = dst;
+            }
+
+            // ── Re-modulate ───────────────────────────────────────────────
+            parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const float fr = albedo ? demodFactor(s.ar[i]) : 1.0f;
+                    const float fg = albedo ? demodFactor(s.ag[i]) : 1.0f;
+                    const float fb = albedo ? demodFactor(s.ab[i]) : 1.0f;
+                    float *o = out + i * outStride;
+                    o[0] = s.r[src][i] * fr;
+                    o[1] = s.g[src][i] * fg;
+                    o[2] = s.b[src][i] * fb;
+                }
+            });
+        }
+
+#ifdef TRACEY_HAS_OIDN
+        bool oidnDenoise(int width, int height, const float *colorRGBA, const float *albedoRGBA,
+                         const float *normalRGBA, float *outRGBA, std::string *error)
+        {
+            // Our readback buffers are RGBA32F — feed OIDN FLOAT3 with a 16-byte
+            // pixel stride so it reads/writes RGB and skips the alpha lane.
+            const size_t kPixelStride = 4 * sizeof(float);
+
+            // CPU device: it can denoise directly from shared host pointers
+            // (oidnSetSharedFilterImage). The GPU/Metal device would require
+            // device-allocated OIDNBuffers + copies — a future optimisation for an
+            // interactive preview, not needed for offline export.
+            OIDNDevice device = oidnNewDevice(OIDN_DEVICE_TYPE_CPU);
+            if (!device)
+            {
+                if (error) *error = "OIDN: failed to create CPU device";
+                return false;
+            }
+            oidnCommitDevice(device);
+            {
+                const char *msg = nullptr;
+                if (oidnGetDeviceError(device, &msg) != OIDN_ERROR_NONE)
+                {
+                    if (error) *error = msg ? msg : "OIDN: device commit failed";
+                    oidnReleaseDevice(device);
+                    return false;
+                }
+            }
+
+            OIDNFilter filter = oidnNewFilter(device, "RT");  // ray-traced beauty
+            if (!filter)
+            {
+                if (error) *error = "OIDN: failed to create RT filter";
+                oidnReleaseDevice(device);
+                return false;
+            }
+            oidnSetSharedFilterImage(filter, "color", const_cast<float *>(colorRGBA),
+                                     OIDN_FORMAT_FLOAT3, static_cast<size_t>(width),
+                                     static_cast<size_t>(height), 0, kPixelStride, 0);
+            if (albedoRGBA)
+                oidnSetSharedFilterImage(filter, "albedo", const_cast<float *>(albedoRGBA),
+                                         OIDN_FORMAT_FLOAT3, static_cast<size_t>(width),
+                                         static_cast<size_t>(height), 0, kPixelStride, 0);
+            if (normalRGBA)
+                oidnSetSharedFilterImage(filter, "normal", const_cast<float *>(normalRGBA),
+                                         OIDN_FORMAT_FLOAT3, static_cast<size_t>(width),
+                                         static_cast<size_t>(height), 0, kPixelStride, 0);
+            oidnSetSharedFilterImage(filter, "output", outRGBA, OIDN_FORMAT_FLOAT3,
+                                     static_cast<size_t>(width), static_cast<size_t>(height),
+                                     0, kPixelStride, 0);
+            oidnSetFilterBool(filter, "hdr", true);  // beauty is linear HDR
+            oidnCommitFilter(filter);
+            oidnExecuteFilter(filter);
+
+            const char *msg = nullptr;
+            const bool ok = (oidnGetDeviceError(device, &msg) == OIDN_ERROR_NONE);
+            if (!ok && error) *error = msg ? msg : "OIDN denoise failed";
+
+            oidnReleaseFilter(filter);
+            oidnReleaseDevice(device);
+            return ok;
+        }
+#endif
+    }
+
     bool denoiserAvailable()
+    {
+        return true;
+    }
+
+    bool oidnAvailable()
     {
 #ifdef TRACEY_HAS_OIDN
         return true;
@@ -22,75 +339,104 @@ namespace tracey
                       float *outRGBA,
                       std::string *error)
     {
-#ifndef TRACEY_HAS_OIDN
-        (void)width; (void)height; (void)colorRGBA;
-        (void)albedoRGBA; (void)normalRGBA; (void)outRGBA;
-        if (error) *error = "denoiser not built (configure with -DTRACEY_WITH_OIDN=ON)";
-        return false;
-#else
+        return denoiseImage(width, height, colorRGBA, albedoRGBA, normalRGBA, outRGBA,
+                            DenoiseOptions{}, error);
+    }
+
+    bool denoiseImage(int width, int height,
+                      const float *colorRGBA,
+                      const float *albedoRGBA,
+                      const float *normalRGBA,
+                      float *outRGBA,
+                      const DenoiseOptions &options,
+                      std::string *error)
+    {
         if (width <= 0 || height <= 0 || !colorRGBA || !outRGBA)
         {
             if (error) *error = "denoiseImage: invalid arguments";
             return false;
         }
-
-        // Our readback buffers are RGBA32F — feed OIDN FLOAT3 with a 16-byte
-        // pixel stride so it reads/writes RGB and skips the alpha lane.
-        const size_t kPixelStride = 4 * sizeof(float);
-
-        // CPU device: it can denoise directly from shared host pointers
-        // (oidnSetSharedFilterImage). The GPU/Metal device would require
-        // device-allocated OIDNBuffers + copies — a future optimisation for an
-        // interactive preview, not needed for offline export.
-        OIDNDevice device = oidnNewDevice(OIDN_DEVICE_TYPE_CPU);
-        if (!device)
+#ifdef TRACEY_HAS_OIDN
+        if (options.backend != DenoiserBackend::ATrous)
+            return oidnDenoise(width, height, colorRGBA, albedoRGBA, normalRGBA, outRGBA, error);
+#else
+        if (options.backend == DenoiserBackend::Oidn)
         {
-            if (error) *error = "OIDN: failed to create CPU device";
+            if (error) *error = "OIDN not built (configure with -DTRACEY_WITH_OIDN=ON)";
             return false;
         }
-        oidnCommitDevice(device);
-        {
-            const char *msg = nullptr;
-            if (oidnGetDeviceError(device, &msg) != OIDN_ERROR_NONE)
+#endif
+        ATrousScratch scratch;
+        atrous(width, height, colorRGBA, albedoRGBA, normalRGBA, outRGBA, 4, options, scratch);
+        return true;
+    }
+
+    // ── PreviewDenoiser ──────────────────────────────────────────────────
+
+    bool PreviewDenoiser::denoise(int width, int height,
+                                  const float *colorRGBA,
+                                  const float *albedoRGBA,
+                                  const float *normalRGBA,
+                                  float *outRGBA,
+                                  uint32_t sampleCount,
+                                  const DenoiseOptions &options)
+    {
+        if (width <= 0 || height <= 0 || !colorRGBA || !outRGBA) return false;
+        const size_t n = static_cast<size_t>(width) * height;
+        if (width != m_width || height != m_height || sampleCount <= m_lastSampleCount)
+            reset();
+        m_width = width;
+        m_height = height;
+
+        if (!m_scratch) m_scratch = std::make_shared<ATrousScratch>();
+        m_current.resize(n * 3);
+        atrous(width, height, colorRGBA, albedoRGBA, normalRGBA, m_current.data(), 3, options, *m_scratch);
+
+        // History weight per frame. Low enough to average out shimmer over
+        // a handful of frames, high enough that the clamp rarely engages
+        // on a converging image.
+        constexpr float kAlpha = 0.2f;
+        const bool blend = !m_history.empty();
+        if (!blend) m_history = m_current;
+
+        const int w = width;
+        parallel_for_each_index(static_cast<size_t>(height), [&](size_t y) {
+            const int yi = static_cast<int>(y);
+            for (int x = 0; x < w; ++x)
             {
-                if (error) *error = msg ? msg : "OIDN: device commit failed";
-                oidnReleaseDevice(device);
-                return false;
+                const size_t i = y * w + x;
+                for (int c = 0; c < 3; ++c)
+                {
+                    float v = m_current[i * 3 + c];
+                    if (blend)
+                    {
+                        float lo = v, hi = v;
+                        for (int dy = -1; dy <= 1; ++dy)
+                        {
+                            const int yy = std::clamp(yi + dy, 0, height - 1);
+                            for (int dx = -1; dx <= 1; ++dx)
+                            {
+                                const int xx = std::clamp(x + dx, 0, w - 1);
+                                const float nv = m_current[(static_cast<size_t>(yy) * w + xx) * 3 + c];
+                                lo = std::min(lo, nv);
+                                hi = std::max(hi, nv);
+                            }
+                        }
+                        const float hist = std::clamp(m_history[i * 3 + c], lo, hi);
+                        v = hist + (v - hist) * kAlpha;
+                        m_history[i * 3 + c] = v;
+                    }
+                    outRGBA[i * 4 + c] = v;
+                }
             }
-        }
+        });
+        m_lastSampleCount = sampleCount;
+        return true;
+    }
 
-        OIDNFilter filter = oidnNewFilter(device, "RT");  // ray-traced beauty
-        if (!filter)
-        {
-            if (error) *error = "OIDN: failed to create RT filter";
-            oidnReleaseDevice(device);
-            return false;
-        }
-        oidnSetSharedFilterImage(filter, "color", const_cast<float *>(colorRGBA),
-                                 OIDN_FORMAT_FLOAT3, static_cast<size_t>(width),
-                                 static_cast<size_t>(height), 0, kPixelStride, 0);
-        if (albedoRGBA)
-            oidnSetSharedFilterImage(filter, "albedo", const_cast<float *>(albedoRGBA),
-                                     OIDN_FORMAT_FLOAT3, static_cast<size_t>(width),
-                                     static_cast<size_t>(height), 0, kPixelStride, 0);
-        if (normalRGBA)
-            oidnSetSharedFilterImage(filter, "normal", const_cast<float *>(normalRGBA),
-                                     OIDN_FORMAT_FLOAT3, static_cast<size_t>(width),
-                                     static_cast<size_t>(height), 0, kPixelStride, 0);
-        oidnSetSharedFilterImage(filter, "output", outRGBA, OIDN_FORMAT_FLOAT3,
-                                 static_cast<size_t>(width), static_cast<size_t>(height),
-                                 0, kPixelStride, 0);
-        oidnSetFilterBool(filter, "hdr", true);  // beauty is linear HDR
-        oidnCommitFilter(filter);
-        oidnExecuteFilter(filter);
-
-        const char *msg = nullptr;
-        const bool ok = (oidnGetDeviceError(device, &msg) == OIDN_ERROR_NONE);
-        if (!ok && error) *error = msg ? msg : "OIDN denoise failed";
-
-        oidnReleaseFilter(filter);
-        oidnReleaseDevice(device);
-        return ok;
-#endif
+    void PreviewDenoiser::reset()
+    {
+        m_history.clear();
+        m_lastSampleCount = 0;
     }
 } // namespace tracey
@@ -1,23 +1,115 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace tracey
 {
-    // True when the build links a working denoiser (Intel OIDN, gated by the
-    // TRACEY_WITH_OIDN CMake option). When false, denoiseImage() is a no-op
-    // that reports failure — callers fall back to the raw image.
+    struct ATrousScratch;
+
+    // Which implementation denoiseImage() runs.
+    //   Auto   — Intel OIDN when the build links it (TRACEY_WITH_OIDN),
+    //            otherwise the built-in à-trous filter.
+    //   Oidn   — OIDN only; fails when it is not built in.
+    //   ATrous — the built-in edge-avoiding à-trous wavelet filter
+    //            (Dammertz et al. 2010, with SVGF-style variance-guided
+    //            luminance stopping). Native, parallel, no dependencies;
+    //            fast enough to run on every viewport frame.
+    enum class DenoiserBackend
+    {
+        Auto,
+        Oidn,
+        ATrous,
+    };
+
+    // Tuning for denoiseImage(). Only `backend` applies to OIDN; the rest
+    // steer the à-trous filter.
+    //
+    //   depthRGBA   — optional camera-distance AOV (R channel, 0 = no hit),
+    //                 same layout as the other buffers. Stops the filter at
+    //                 silhouettes where normals alone agree.
+    //   variance    — optional width*height floats: the variance of each
+    //                 pixel's luminance *estimate* (sample variance / spp).
+    //                 Progressive renderers that track it get a filter that
+    //                 backs off as the image converges; without it the
+    //                 variance is estimated from each pixel's 3×3
+    //                 neighbourhood.
+    //   iterations  — à-trous levels; the footprint doubles per level
+    //                 (5 levels reach 62 pixels out).
+    //   colorSigma  — luminance edge stop, in standard deviations.
+    //   normalPower — exponent on dot(n_p, n_q).
+    //   depthSigma  — depth edge stop, in multiples of the local depth
+    //                 gradient.
+    //   albedoSigma — albedo edge stop (L1 RGB distance).
+    struct DenoiseOptions
+    {
+        DenoiserBackend backend = DenoiserBackend::Auto;
+        const float *depthRGBA = nullptr;
+        const float *variance = nullptr;
+        int iterations = 5;
+        float colorSigma = 4.0f;
+        float normalPower = 64.0f;
+        float depthSigma = 1.0f;
+        float albedoSigma = 0.1f;
+    };
+
+    // Always true: the à-trous filter is built in. Kept so call sites that
+    // gate denoising on it keep working unchanged.
     bool denoiserAvailable();
 
+    // True when the build links Intel OIDN (the TRACEY_WITH_OIDN CMake
+    // option), which DenoiserBackend::Auto then prefers.
+    bool oidnAvailable();
+
     // Denoise an HDR *linear* beauty image, optionally guided by albedo +
     // normal AOVs (the R1 layers). All buffers are width*height RGBA32F,
     // interleaved (stride 4 floats); only RGB is read/written — alpha is left
     // untouched. `albedoRGBA` / `normalRGBA` may be null (no guide). `outRGBA`
     // may alias `colorRGBA` for in-place denoising. Returns false + fills
-    // `error` on failure (including when no denoiser is built in).
+    // `error` on failure.
+    bool denoiseImage(int width, int height,
+                      const float *colorRGBA,
+                      const float *albedoRGBA,
+                      const float *normalRGBA,
+                      float *outRGBA,
+                      std::string *error = nullptr);
     bool denoiseImage(int width, int height,
                       const float *colorRGBA,
                       const float *albedoRGBA,
                       const float *normalRGBA,
                       float *outRGBA,
+                      const DenoiseOptions &options,
                       std::string *error = nullptr);
+
+    // Per-frame denoise of a progressively refined image (the interactive
+    // viewport). Runs the à-trous filter — `options.backend` is ignored —
+    // then blends the result into a history buffer, with the history
+    // clamped to each pixel's 3×3 neighbourhood of the new frame so it can
+    // lag but never ghost. That steadies the frame-to-frame shimmer a
+    // spatial filter alone shows at low sample counts.
+    //
+    // `sampleCount` is the number of samples in `colorRGBA`. When it does
+    // not grow past the previous call's (accumulation restarted: camera or
+    // scene edit) or the size changes, the history is discarded.
+    class PreviewDenoiser
+    {
+    public:
+        bool denoise(int width, int height,
+                     const float *colorRGBA,
+                     const float *albedoRGBA,
+                     const float *normalRGBA,
+                     float *outRGBA,
+                     uint32_t sampleCount,
+                     const DenoiseOptions &options = {});
+        void reset();
+
+    private:
+        std::vector<float> m_current; // this frame's filtered RGB
+        std::vector<float> m_history; // blended RGB
+        std::shared_ptr<ATrousScratch> m_scratch;
+        int m_width = 0;
+        int m_height = 0;
+        uint32_t m_lastSampleCount = 0;
+    };
 } // namespace tracey
@@ -1,47 +1,281 @@
 // The single translation unit that compiles tinyexr. miniz (the deflate impl
 // tinyexr links for ZIP compression) is built separately from deps/tinyexr/miniz.c;
 // tinyexr only #include <miniz.h> here for declarations.
+//
+// tinyexr is only used for reading. Writing goes through the chunk writer
+// below: tinyexr's saver compresses the whole image serially into memory
+// before touching the file, which stalled sequence export for a good part
+// of every frame at 4K with six AOVs.
 #define TINYEXR_IMPLEMENTATION
 #include <tinyexr.h>
 
 #include "exr_writer.hpp"
 
+#include "../core/parallel.hpp"
+
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstring>
+#include <fstream>
 #include <utility>
 
 namespace tracey
 {
-    bool writeMultiLayerExr(const std::string &path, int width, int height,
-                            const std::vector<ExrLayer> &layers, std::string *error)
+    namespace
     {
-        if (width <= 0 || height <= 0 || layers.empty())
+        // ── Half conversion ────────────────────────────────────────────────
+        // Round-to-nearest-even; overflow goes to inf, NaN stays NaN.
+        uint16_t floatToHalf(float value)
         {
-            if (error) *error = "writeMultiLayerExr: invalid dimensions or no layers";
-            return false;
+            uint32_t x;
+            std::memcpy(&x, &value, sizeof(x));
+            const uint32_t sign = x & 0x80000000u;
+            x ^= sign;
+
+            uint32_t h;
+            if (x >= (127u + 16u) << 23) // ≥ 65536 (or inf / NaN)
+            {
+                h = x > (255u << 23) ? 0x7e00u : 0x7c00u;
+            }
+            else if (x < (113u << 23)) // below the smallest normal half
+            {
+                // Adding 0.5 lets the FPU do the denormal rounding.
+                constexpr uint32_t kMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+                float f, magic;
+                std::memcpy(&f, &x, sizeof(f));
+                std::memcpy(&magic, &kMagic, sizeof(magic));
+                f += magic;
+                std::memcpy(&h, &f, sizeof(h));
+                h -= kMagic;
+            }
+            else
+            {
+                const uint32_t mantOdd = (x >> 13) & 1u;
+                x += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu;
+                x += mantOdd;
+                h = x >> 13;
+            }
+            return static_cast<uint16_t>(h | (sign >> 16));
         }
-        const size_t pix = static_cast<size_t>(width) * static_cast<size_t>(height);
 
-        // Flatten every layer into individual single-channel float planes
-        // (EXR stores planar, not interleaved).
-        struct Chan
+        // ── Header encoding ────────────────────────────────────────────────
+        struct ByteWriter
+        {
+            std::vector<unsigned char> bytes;
+
+            void raw(const void *p, size_t n)
+            {
+                const auto *b = static_cast<const unsigned char *>(p);
+                bytes.insert(bytes.end(), b, b + n);
+            }
+            void u8(uint8_t v) { bytes.push_back(v); }
+            void i32(int32_t v) { raw(&v, sizeof(v)); }
+            void u32(uint32_t v) { raw(&v, sizeof(v)); }
+            void f32(float v) { raw(&v, sizeof(v)); }
+            void str(const std::string &s) { raw(s.c_str(), s.size() + 1); }
+
+            // name, type, size, then whatever `value` writes.
+            template <typename Fn>
+            void attribute(const char *name, const char *type, Fn value)
+            {
+                str(name);
+                str(type);
+                const size_t sizePos = bytes.size();
+                i32(0);
+                const size_t begin = bytes.size();
+                value();
+                const int32_t size = static_cast<int32_t>(bytes.size() - begin);
+                std::memcpy(bytes.data() + sizePos, &size, sizeof(size));
+            }
+        };
+
+        // OpenEXR compression / level-mode codes.
+        constexpr uint8_t kCompressionNone = 0;
+        constexpr uint8_t kCompressionZips = 2;
+        constexpr uint8_t kCompressionZip  = 3;
+        constexpr uint8_t kLevelModeOne    = 0;
+        constexpr uint8_t kLevelModeMipmap = 1;
+
+        struct OutChannel
         {
             std::string name;
-            std::vector<float> data;
+            size_t layer = 0;
+            int component = 0;
+            ExrPixelType type = ExrPixelType::Float;
         };
-        std::vector<Chan> chans;
-        chans.reserve(layers.size() * 4);
 
-        for (const auto &L : layers)
+        // One resolution level: where each channel's pixels come from. Level
+        // 0 reads the caller's interleaved layers in place (stride =
+        // channels); smaller levels own box-filtered planes (stride 1).
+        struct Level
         {
-            if (!L.data || L.channels < 1 || L.channels > 4)
+            int width = 0;
+            int height = 0;
+            std::vector<const float *> src;
+            std::vector<size_t> stride;
+            std::vector<std::vector<float>> planes;
+        };
+
+        struct Chunk
+        {
+            int level = 0;
+            int x0 = 0, y0 = 0, w = 0, h = 0; // pixel rect within the level
+            int tileX = 0, tileY = 0;
+        };
+
+        int levelCount(int width, int height)
+        {
+            int n = 1;
+            for (int m = std::max(width, height); m > 1; m >>= 1) ++n;
+            return n;
+        }
+
+        // 2×2 box filter, ROUND_DOWN sizes: an odd trailing row / column
+        // of the finer level has no coarse pixel and is dropped. The clamp
+        // in at() only matters for a fine level 1 pixel wide (or high),
+        // whose single column (row) is read twice.
+        void downsample(const Level &fine, size_t c, Level &coarse)
+        {
+            std::vector<float> &dst = coarse.planes[c];
+            dst.resize(static_cast<size_t>(coarse.width) * coarse.height);
+            const float *s = fine.src[c];
+            const size_t st = fine.stride[c];
+            auto at = [&](int x, int y) {
+                x = std::min(x, fine.width - 1);
+                y = std::min(y, fine.height - 1);
+                return s[(static_cast<size_t>(y) * fine.width + x) * st];
+            };
+            for (int y = 0; y < coarse.height; ++y)
+                for (int x = 0; x < coarse.width; ++x)
+                    dst[static_cast<size_t>(y) * coarse.width + x] =
+                        0.25f * (at(2 * x, 2 * y) + at(2 * x + 1, 2 * y) +
+                                 at(2 * x, 2 * y + 1) + at(2 * x + 1, 2 * y + 1));
+        }
+
+        // Pixel data of one chunk in file order (line by line, each line
+        // channel by channel) followed by ZIP's byte split + delta predictor
+        // and deflate. Falls back to the raw bytes when deflate does not
+        // shrink them, which readers recognise by dataSize == raw size.
+        void encodeChunk(const Chunk &ck, const Level &lv,
+                         const std::vector<OutChannel> &chans, bool tiled,
+                         ExrCompression compression, int zipLevel,
+                         std::vector<unsigned char> &out, uint64_t &rawBytes)
+        {
+            thread_local std::vector<unsigned char> raw, tmp;
+            size_t pixelBytes = 0;
+            for (const auto &ch : chans) pixelBytes += ch.type == ExrPixelType::Half ? 2 : 4;
+            raw.resize(pixelBytes * static_cast<size_t>(ck.w) * ck.h);
+
+            unsigned char *dst = raw.data();
+            for (int y = ck.y0; y < ck.y0 + ck.h; ++y)
+            {
+                for (size_t c = 0; c < chans.size(); ++c)
+                {
+                    const size_t st = lv.stride[c];
+                    const float *row = lv.src[c] + (static_cast<size_t>(y) * lv.width + ck.x0) * st;
+                    if (chans[c].type == ExrPixelType::Half)
+                    {
+                        for (int x = 0; x < ck.w; ++x, dst += 2)
+                        {
+                            const uint16_t hv = floatToHalf(row[x * st]);
+                            std::memcpy(dst, &hv, 2);
+                        }
+                    }
+                    else if (st == 1)
+                    {
+                        std::memcpy(dst, row, static_cast<size_t>(ck.w) * 4);
+                        dst += static_cast<size_t>(ck.w) * 4;
+                    }
+                    else
+                    {
+                        for (int x = 0; x < ck.w; ++x, dst += 4)
+                            std::memcpy(dst, row + x * st, 4);
+                    }
+                }
+            }
+            rawBytes = raw.size();
+
+            const unsigned char *payload = raw.data();
+            size_t payloadSize = raw.size();
+            if (compression != ExrCompression::None && !raw.empty())
+            {
+                tmp.resize(raw.size());
+                unsigned char *t1 = tmp.data();
+                unsigned char *t2 = tmp.data() + (raw.size() + 1) / 2;
+                for (size_t i = 0; i < raw.size(); ++i) *((i & 1) ? t2++ : t1++) = raw[i];
+                int p = tmp[0];
+                for (size_t i = 1; i < tmp.size(); ++i)
+                {
+                    const int d = int(tmp[i]) - p + (128 + 256);
+                    p = tmp[i];
+                    tmp[i] = static_cast<unsigned char>(d);
+                }
+                // Compress straight into `out` behind the chunk header.
+                const size_t headerBytes = tiled ? 20 : 8;
+                mz_ulong zipped = mz_compressBound(static_cast<mz_ulong>(tmp.size()));
+                out.resize(headerBytes + zipped);
+                if (mz_compress2(out.data() + headerBytes, &zipped, tmp.data(),
+                                 static_cast<mz_ulong>(tmp.size()), zipLevel) == MZ_OK &&
+                    zipped < raw.size())
+                {
+                    payload = nullptr;
+                    payloadSize = zipped;
+                }
+            }
+
+            ByteWriter hdr;
+            if (tiled)
+            {
+                hdr.i32(ck.tileX);
+                hdr.i32(ck.tileY);
+                hdr.i32(ck.level);
+                hdr.i32(ck.level);
+            }
+            else
             {
-                if (error) *error = "writeMultiLayerExr: layer '" + L.name + "' invalid";
-                return false;
+                hdr.i32(ck.y0);
             }
+            hdr.i32(static_cast<int32_t>(payloadSize));
+            out.resize(hdr.bytes.size() + payloadSize);
+            std::memcpy(out.data(), hdr.bytes.data(), hdr.bytes.size());
+            if (payload) std::memcpy(out.data() + hdr.bytes.size(), payload, payloadSize);
+        }
+    }
+
+    bool writeMultiLayerExr(const std::string &path, int width, int height,
+                            const std::vector<ExrLayer> &layers, std::string *error)
+    {
+        return writeMultiLayerExr(path, width, height, layers, ExrWriteOptions{}, error);
+    }
+
+    bool writeMultiLayerExr(const std::string &path, int width, int height,
+                            const std::vector<ExrLayer> &layers,
+                            const ExrWriteOptions &options,
+                            std::string *error, ExrWriteStats *stats)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        auto fail = [&](const std::string &msg) {
+            if (error) *error = "writeMultiLayerExr: " + msg;
+            return false;
+        };
+        if (width <= 0 || height <= 0 || layers.empty())
+            return fail("invalid dimensions or no layers");
+        if (options.tiled && (options.tileSize < 1 || options.tileSize > 65536))
+            return fail("invalid tile size");
+
+        // Flatten every layer into individual channels (EXR stores planar,
+        // not interleaved).
+        std::vector<OutChannel> chans;
+        chans.reserve(layers.size() * 4);
+        for (size_t li = 0; li < layers.size(); ++li)
+        {
+            const auto &L = layers[li];
+            if (!L.data || L.channels < 1 || L.channels > 4)
+                return fail("layer '" + L.name + "' invalid");
             for (int c = 0; c < L.channels; ++c)
             {
-                Chan ch;
+                OutChannel ch;
                 if (L.channels == 1)
                 {
                     ch.name = L.name.empty() ? "Y" : L.name;
@@ -51,57 +285,159 @@ namespace tracey
                     const char *sfx = (c == 0) ? "R" : (c == 1) ? "G" : (c == 2) ? "B" : "A";
                     ch.name = L.name.empty() ? std::string(sfx) : (L.name + "." + sfx);
                 }
-                ch.data.resize(pix);
-                for (size_t p = 0; p < pix; ++p)
-                    ch.data[p] = L.data[p * static_cast<size_t>(L.channels) + c];
+                ch.layer = li;
+                ch.component = c;
+                ch.type = L.pixelType;
                 chans.push_back(std::move(ch));
             }
         }
 
         // OpenEXR canonically stores channels in alphabetical order.
         std::sort(chans.begin(), chans.end(),
-                  [](const Chan &a, const Chan &b) { return a.name < b.name; });
+                  [](const OutChannel &a, const OutChannel &b) { return a.name < b.name; });
+        bool longNames = false;
+        for (const auto &ch : chans)
+        {
+            if (ch.name.size() > 255) return fail("channel name too long: " + ch.name);
+            longNames = longNames || ch.name.size() > 31;
+        }
 
-        const int n = static_cast<int>(chans.size());
+        // ── Levels ─────────────────────────────────────────────────────────
+        const bool tiled = options.tiled;
+        const bool mipmaps = tiled && options.mipmaps;
+        const int numLevels = mipmaps ? levelCount(width, height) : 1;
+        std::vector<Level> levels(numLevels);
+        levels[0].width = width;
+        levels[0].height = height;
+        for (const auto &ch : chans)
+        {
+            const ExrLayer &L = layers[ch.layer];
+            levels[0].src.push_back(L.data + ch.component);
+            levels[0].stride.push_back(static_cast<size_t>(L.channels));
+        }
+        for (int l = 1; l < numLevels; ++l)
+        {
+            Level &lv = levels[l];
+            lv.width = std::max(1, width >> l);
+            lv.height = std::max(1, height >> l);
+            lv.planes.resize(chans.size());
+            parallel_for_each_index(chans.size(), [&](size_t c) { downsample(levels[l - 1], c, lv); });
+            for (const auto &plane : lv.planes)
+            {
+                lv.src.push_back(plane.data());
+                lv.stride.push_back(1);
+            }
+        }
 
-        EXRHeader header;
-        InitEXRHeader(&header);
-        EXRImage image;
-        InitEXRImage(&image);
+        // ── Chunks, in file order ──────────────────────────────────────────
+        std::vector<Chunk> chunks;
+        if (tiled)
+        {
+            const int ts = options.tileSize;
+            for (int l = 0; l < numLevels; ++l)
+            {
+                const Level &lv = levels[l];
+                const int tilesX = (lv.width + ts - 1) / ts;
+                const int tilesY = (lv.height + ts - 1) / ts;
+                for (int ty = 0; ty < tilesY; ++ty)
+                    for (int tx = 0; tx < tilesX; ++tx)
+                        chunks.push_back({l, tx * ts, ty * ts,
+                                          std::min(ts, lv.width - tx * ts),
+                                          std::min(ts, lv.height - ty * ts), tx, ty});
+            }
+        }
+        else
+        {
+            const int lines = options.compression == ExrCompression::Zip ? 16 : 1;
+            for (int y = 0; y < height; y += lines)
+                chunks.push_back({0, 0, y, width, std::min(lines, height - y), 0, 0});
+        }
 
-        image.num_channels = n;
-        image.width = width;
-        image.height = height;
-        std::vector<unsigned char *> imgPtrs(n);
-        for (int c = 0; c < n; ++c)
-            imgPtrs[c] = reinterpret_cast<unsigned char *>(chans[c].data.data());
-        image.images = imgPtrs.data();
-
-        std::vector<EXRChannelInfo> chInfos(n);
-        std::vector<int> pixTypes(n), reqTypes(n);
-        for (int c = 0; c < n; ++c)
-        {
-            std::memset(&chInfos[c], 0, sizeof(EXRChannelInfo));
-            std::strncpy(chInfos[c].name, chans[c].name.c_str(), 255);
-            chInfos[c].name[255] = '\0';
-            pixTypes[c] = TINYEXR_PIXELTYPE_FLOAT;  // input data is float
-            reqTypes[c] = TINYEXR_PIXELTYPE_FLOAT;  // store as 32-bit float
-        }
-        header.num_channels = n;
-        header.channels = chInfos.data();
-        header.pixel_types = pixTypes.data();
-        header.requested_pixel_types = reqTypes.data();
-        header.compression_type = TINYEXR_COMPRESSIONTYPE_ZIP;
-
-        // All arrays are caller-owned (stack/vector) — do NOT Free* the header/
-        // image; tinyexr only reads them.
-        const char *err = nullptr;
-        const int ret = SaveEXRImageToFile(&image, &header, path.c_str(), &err);
-        if (ret != TINYEXR_SUCCESS)
+        // ── Header ─────────────────────────────────────────────────────────
+        ByteWriter hdr;
+        hdr.u32(20000630u); // magic
+        hdr.u32(2u | (tiled ? 0x200u : 0u) | (longNames ? 0x400u : 0u));
+        hdr.attribute("channels", "chlist", [&] {
+            for (const auto &ch : chans)
+            {
+                hdr.str(ch.name);
+                hdr.i32(ch.type == ExrPixelType::Half ? 1 : 2);
+                hdr.u8(0);                  // pLinear
+                hdr.u8(0); hdr.u8(0); hdr.u8(0);
+                hdr.i32(1);                 // xSampling
+                hdr.i32(1);                 // ySampling
+            }
+            hdr.u8(0);
+        });
+        hdr.attribute("compression", "compression", [&] {
+            hdr.u8(options.compression == ExrCompression::Zip  ? kCompressionZip
+                 : options.compression == ExrCompression::Zips ? kCompressionZips
+                                                               : kCompressionNone);
+        });
+        auto box = [&] { hdr.i32(0); hdr.i32(0); hdr.i32(width - 1); hdr.i32(height - 1); };
+        hdr.attribute("dataWindow", "box2i", box);
+        hdr.attribute("displayWindow", "box2i", box);
+        hdr.attribute("lineOrder", "lineOrder", [&] { hdr.u8(0); }); // INCREASING_Y
+        hdr.attribute("pixelAspectRatio", "float", [&] { hdr.f32(1.0f); });
+        hdr.attribute("screenWindowCenter", "v2f", [&] { hdr.f32(0.0f); hdr.f32(0.0f); });
+        hdr.attribute("screenWindowWidth", "float", [&] { hdr.f32(1.0f); });
+        if (tiled)
         {
-            if (error) *error = err ? err : "SaveEXRImageToFile failed";
-            if (err) FreeEXRErrorMessage(err);
-            return false;
+            hdr.attribute("tiles", "tiledesc", [&] {
+                hdr.u32(static_cast<uint32_t>(options.tileSize));
+                hdr.u32(static_cast<uint32_t>(options.tileSize));
+                hdr.u8(mipmaps ? kLevelModeMipmap : kLevelModeOne); // ROUND_DOWN
+            });
+        }
+        hdr.u8(0);
+
+        // ── Stream ─────────────────────────────────────────────────────────
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (!f) return fail("cannot open " + path);
+        const uint64_t tablePos = hdr.bytes.size();
+        std::vector<uint64_t> offsets(chunks.size(), 0);
+        f.write(reinterpret_cast<const char *>(hdr.bytes.data()),
+                static_cast<std::streamsize>(hdr.bytes.size()));
+        f.write(reinterpret_cast<const char *>(offsets.data()),
+                static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+        uint64_t pos = tablePos + offsets.size() * sizeof(uint64_t);
+
+        // A few chunks per lane per window: enough to keep every lane busy
+        // while bounding how much compressed data waits for the file.
+        const int zipLevel = std::clamp(options.zipLevel, 1, 9);
+        const size_t window = std::max<size_t>(16, (ThreadPool::global().workerCount() + 1) * 4);
+        std::vector<std::vector<unsigned char>> encoded(std::min(window, chunks.size()));
+        std::vector<uint64_t> rawBytes(encoded.size());
+        uint64_t totalRaw = 0;
+        for (size_t first = 0; first < chunks.size() && f; first += window)
+        {
+            const size_t count = std::min(window, chunks.size() - first);
+            parallel_for_each_index(count, [&](size_t i) {
+                const Chunk &ck = chunks[first + i];
+                encodeChunk(ck, levels[ck.level], chans, tiled, options.compression,
+                            zipLevel, encoded[i], rawBytes[i]);
+            });
+            for (size_t i = 0; i < count; ++i)
+            {
+                offsets[first + i] = pos;
+                f.write(reinterpret_cast<const char *>(encoded[i].data()),
+                        static_cast<std::streamsize>(encoded[i].size()));
+                pos += encoded[i].size();
+                totalRaw += rawBytes[i];
+            }
+        }
+        f.seekp(static_cast<std::streamoff>(tablePos));
+        f.write(reinterpret_cast<const char *>(offsets.data()),
+                static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+        f.close();
+        if (!f) return fail("write failed for " + path);
+
+        if (stats)
+        {
+            stats->chunks = chunks.size();
+            stats->pixelBytes = totalRaw;
+            stats->fileBytes = pos;
+            stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
         }
         return true;
     }
@@ -149,7 +485,26 @@ namespace tracey
         for (int c = 0; c < image.num_channels; ++c)
         {
             std::vector<float> plane(pix);
-            std::memcpy(plane.data(), image.images[c], pix * sizeof(float));
+            if (image.images)
+            {
+                std::memcpy(plane.data(), image.images[c], pix * sizeof(float));
+            }
+            else
+            {
+                // Tiled: reassemble the full-resolution level. Tile planes
+                // are tile_size_x wide regardless of the tile's clipped width.
+                for (int t = 0; t < image.num_tiles; ++t)
+                {
+                    const EXRTile &tile = image.tiles[t];
+                    const auto *src = reinterpret_cast<const float *>(tile.images[c]);
+                    const int x0 = tile.offset_x * header.tile_size_x;
+                    const int y0 = tile.offset_y * header.tile_size_y;
+                    for (int y = 0; y < tile.height; ++y)
+                        std::memcpy(plane.data() + static_cast<size_t>(y0 + y) * image.width + x0,
+                                    src + static_cast<size_t>(y) * header.tile_size_x,
+                                    static_cast<size_t>(tile.width) * sizeof(float));
+                }
+            }
             channels.emplace_back(header.channels[c].name, std::move(plane));
         }
 
@@ -157,4 +512,48 @@ namespace tracey
         FreeEXRHeader(&header);
         return true;
     }
+
+    bool readExrInfo(const std::string &path, ExrFileInfo &info, std::string *error)
+    {
+        const char *err = nullptr;
+        EXRVersion ver;
+        if (ParseEXRVersionFromFile(&ver, path.c_str()) != TINYEXR_SUCCESS)
+        {
+            if (error) *error = "ParseEXRVersionFromFile failed for " + path;
+            return false;
+        }
+        EXRHeader header;
+        InitEXRHeader(&header);
+        if (ParseEXRHeaderFromFile(&header, &ver, path.c_str(), &err) != TINYEXR_SUCCESS)
+        {
+            if (error) *error = err ? err : "ParseEXRHeaderFromFile failed";
+            if (err) FreeEXRErrorMessage(err);
+            return false;
+        }
+
+        info = ExrFileInfo{};
+        info.tiled = header.tiled != 0;
+        if (info.tiled)
+        {
+            info.tileWidth = header.tile_size_x;
+            info.tileHeight = header.tile_size_y;
+            if (header.tile_level_mode == TINYEXR_TILE_MIPMAP_LEVELS)
+            {
+                const int w = header.data_window.max_x - header.data_window.min_x + 1;
+                const int h = header.data_window.max_y - header.data_window.min_y + 1;
+                int m = std::max(w, h);
+                info.levels = 1;
+                if (header.tile_rounding_mode == TINYEXR_TILE_ROUND_UP)
+                    for (int s = 1; s < m; s <<= 1) ++info.levels;
+                else
+                    for (; m > 1; m >>= 1) ++info.levels;
+            }
+        }
+        for (int c = 0; c < header.num_channels; ++c)
+            info.channels.emplace_back(header.channels[c].name,
+                                       header.pixel_types[c] == TINYEXR_PIXELTYPE_HALF
+                                           ? ExrPixelType::Half : ExrPixelType::Float);
+        FreeEXRHeader(&header);
+        return true;
+    }
 } // namespace tracey
@@ -1,14 +1,26 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace tracey
 {
+    // Storage type of a layer's channels in the file. Input is always float;
+    // Half halves the file and is plenty for colour-like AOVs (beauty,
+    // albedo, normals). Keep depth, position and ids Float.
+    enum class ExrPixelType
+    {
+        Float,
+        Half,
+    };
+
     // One named image layer fed to writeMultiLayerExr. `data` is tightly packed,
     // interleaved, width*height*channels floats (linear). Channel naming in the
     // file follows the comp convention:
-    //   - name == ""  → the default beauty layer: "R","G","B" (+"A" if 4 ch)
+    //   - name == ""  → the default beauty layer: "R","G","B" (+"A" if 4 ch),
+    //                    or "Y" (luminance) for a 1-channel layer
     //   - 1 channel    → the bare `name` (e.g. "Z" for depth, "id")
     //   - 3/4 channels → "name.R","name.G","name.B"(,"name.A")
     struct ExrLayer
@@ -16,21 +28,81 @@ namespace tracey
         std::string name;
         int channels = 3;        // 1, 3, or 4
         const float *data = nullptr;
+        ExrPixelType pixelType = ExrPixelType::Float;
+    };
+
+    // Chunk compression. Zip (16 scanlines per chunk) is what Nuke and
+    // OpenEXR default to; Zips (one scanline per chunk) trades some ratio for
+    // finer-grained random access. Both use the standard byte-split +
+    // delta predictor ahead of deflate.
+    enum class ExrCompression
+    {
+        None,
+        Zips,
+        Zip,
+    };
+
+    // File layout knobs. The defaults write a scanline, ZIP-compressed file.
+    //
+    //   tiled         — tileSize×tileSize tiles instead of scanline chunks.
+    //   mipmaps       — tiled only: also store box-filtered levels down to
+    //                   1×1 (OpenEXR MIPMAP_LEVELS, ROUND_DOWN), so texture
+    //                   readers can sample the file directly.
+    //   zipLevel      — deflate effort, 1 (fastest) … 9. 4 matches OpenEXR's
+    //                   own default and is most of level 9's ratio.
+    struct ExrWriteOptions
+    {
+        ExrCompression compression = ExrCompression::Zip;
+        bool tiled = false;
+        int tileSize = 64;
+        bool mipmaps = false;
+        int zipLevel = 4;
     };
 
-    // Write a single-part, multi-channel OpenEXR (32-bit float, uncompressed-
-    // or zip-compressed) gathering every layer into one file — the form Nuke /
-    // usdview read AOVs from. Returns true on success; on failure returns false
-    // and fills `error` when non-null. Backed by vendored tinyexr.
+    // What one write did; fed to the smoke test's throughput report.
+    struct ExrWriteStats
+    {
+        size_t chunks = 0;
+        uint64_t pixelBytes = 0; // uncompressed pixel data over all levels
+        uint64_t fileBytes = 0;
+        double seconds = 0.0;
+    };
+
+    // Write a single-part, multi-channel OpenEXR gathering every layer into one
+    // file — the form Nuke / usdview read AOVs from. Returns true on success; on
+    // failure returns false and fills `error` when non-null.
+    //
+    // Chunks (scanline blocks or tiles) are compressed in parallel on the
+    // global thread pool and streamed to disk a window at a time, so peak
+    // memory is a few chunks per thread rather than the whole compressed
+    // image; the offset table is patched in at the end.
     bool writeMultiLayerExr(const std::string &path, int width, int height,
                             const std::vector<ExrLayer> &layers,
                             std::string *error = nullptr);
+    bool writeMultiLayerExr(const std::string &path, int width, int height,
+                            const std::vector<ExrLayer> &layers,
+                            const ExrWriteOptions &options,
+                            std::string *error = nullptr,
+                            ExrWriteStats *stats = nullptr);
 
     // Read every channel of a single-part EXR into (channel-name → plane) pairs,
     // each `width*height` floats (row-major). Channel names are the full EXR
-    // names ("R", "albedo.R", "Z", …). Returns false + fills `error` on failure.
-    // Keeps tinyexr private to this TU; used by tests and downstream readers.
+    // names ("R", "albedo.R", "Z", …). Tiled files return their full-resolution
+    // level. Returns false + fills `error` on failure. Keeps tinyexr private to
+    // this TU; used by tests and downstream readers.
     bool readMultiLayerExr(const std::string &path, int *width, int *height,
                            std::vector<std::pair<std::string, std::vector<float>>> &channels,
                            std::string *error = nullptr);
+
+    // Layout of an EXR on disk, read from its header.
+    struct ExrFileInfo
+    {
+        bool tiled = false;
+        int tileWidth = 0;
+        int tileHeight = 0;
+        int levels = 1;                  // 1 unless mipmapped
+        std::vector<std::pair<std::string, ExrPixelType>> channels;
+    };
+    bool readExrInfo(const std::string &path, ExrFileInfo &info,
+                     std::string *error = nullptr);
 } // namespace tracey
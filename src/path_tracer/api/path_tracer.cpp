@@ -180,6 +180,16 @@ namespace tracey
         return m_backend->readbackAOV(aov, outData);
     }
 
+    SceneMemoryStats PathTracer::sceneMemory() const
+    {
+        return m_backend->sceneMemory();
+    }
+
+    bool PathTracer::supportsInstanceGroups() const
+    {
+        return m_backend->supportsInstanceGroups();
+    }
+
     void PathTracer::setMaterialPrograms(const MaterialProgramBuffer &programs)
     {
         if (!m_config.useMaterialPrograms)
@@ -10,6 +10,7 @@
 #include "shading/material_program/material_program.hpp"
 #include "path_tracer_backend.hpp"
 
+#include <atomic>
 #include <memory>
 
 namespace tracey
@@ -40,14 +41,44 @@ namespace tracey
         bool linearOutput = false;
 
         // Interactive denoise: when true (and NOT linearOutput), a backend that
-        // supports it runs OIDN on the accumulated LINEAR beauty each frame and
-        // writes the tonemapped denoised result to the display image — a clean
-        // live preview at low sample counts. Currently honoured by the CPU
-        // backend (its pixels are already host-side); the GPU backend ignores
-        // it (would need readback+denoise+upload). Skipped under linearOutput so
-        // it never interferes with the EXR / host-side export-denoise path.
+        // supports it filters the accumulated LINEAR beauty each frame with the
+        // built-in à-trous denoiser (PreviewDenoiser: albedo/normal/depth
+        // guided, variance-driven, temporally stabilised) and writes the
+        // tonemapped result to the display image — a clean live preview at low
+        // sample counts. Turns on the albedo/normal/depth AOVs it needs.
+        // Currently honoured by the CPU backend (its pixels are already
+        // host-side); the GPU backend ignores it (would need
+        // readback+denoise+upload). Skipped under linearOutput so it never
+        // interferes with the EXR / host-side export-denoise path.
         bool denoisePreview = false;
 
+        // CPU backend: keep the per-vertex shading data compact — octahedral
+        // 32-bit normals, half-float UVs, and one octahedral UV tangent per
+        // triangle in place of the object-space positions (40 bytes per
+        // vertex down to 8, plus 4 per triangle). Decoded at the hit, so the
+        // image differs from the full-precision path only by quantisation.
+        // Pair with BVHConfig::compactTriangles at compile time to shrink the
+        // triangle storage too. Other backends ignore it.
+        bool compactShadingData = false;
+
+        // CPU backend: world-space radiance cache for diffuse
+        // interreflection. Completed paths record the radiance leaving each
+        // diffuse surface they hit into a hashed grid (quantised position +
+        // normal). Once a path has taken a diffuse bounce, it ends at the
+        // next diffuse hit whose cell holds a trusted estimate and adds that
+        // estimate instead of tracing on. Interiors reach a stable GI look in
+        // a fraction of the rays, at the cost of bias: light is blurred over a
+        // cell and lags behind the cell's history. The cache outlives camera
+        // moves and is dropped when the scene or its materials change. Off is
+        // the unbiased reference. Other backends ignore it.
+        bool radianceCache = false;
+        // Cell edge in world units. Larger cells fill faster and blur more.
+        float radianceCacheCellSize = 0.1f;
+        // Samples a cell must hold before paths may end in it: the bias /
+        // variance control. Higher trusts only well-converged cells (less
+        // bias, more of each path traced out); lower ends paths sooner.
+        uint32_t radianceCacheMinSamples = 16;
+
         // If true, the pipeline binds the four MaterialProgram SSBOs and the
         // hit shader is expected to be the uber-VM hit. Defaults to false so
         // legacy hit shaders keep working unchanged.
@@ -120,6 +151,14 @@ namespace tracey
         /// bytes written, or 0 if AOVs are unavailable.
         size_t readbackAOV(AovKind aov, void *outData);
 
+        /// Host memory the backend holds for the last rendered scene (zero
+        /// for backends that don't track it).
+        SceneMemoryStats sceneMemory() const;
+
+        /// True when the backend renders nested instance groups, i.e. scenes
+        /// for it may be compiled with nestInstanceGroups.
+        bool supportsInstanceGroups() const;
+
         /// Get shader inputs buffer for advanced use cases
         /// Allows direct manipulation of shader uniforms beyond camera parameters
         ShaderInputsBuffer *shaderInputs() { return m_shaderInputs.get(); }
@@ -150,6 +189,18 @@ namespace tracey
         bool denoisePreview() const { return m_config.denoisePreview; }
         void setDenoisePreview(bool v) { m_config.denoisePreview = v; }
 
+        // Read live the same way; the two modes converge to different images,
+        // so render the next frame with clearAccumulation after toggling. See
+        // PathTracerConfig::radianceCache.
+        bool radianceCache() const { return m_config.radianceCache; }
+        void setRadianceCache(bool v) { m_config.radianceCache = v; }
+
+        /// Let a frame in flight stop early: render() returns once `cancel`
+        /// reads true, with the pixels the backend didn't reach left at their
+        /// previous value. Checked per pixel row by the CPU backend; GPU
+        /// backends finish the frame. Pass null to detach. Not owned.
+        void setCancelFlag(const std::atomic<bool> *cancel) { m_backend->setCancelFlag(cancel); }
+
         /// Replace the material program buffers with the given packed programs.
         /// Only valid when config.useMaterialPrograms is true. Clears
         /// accumulation on next render.
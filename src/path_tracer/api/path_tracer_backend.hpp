@@ -8,6 +8,7 @@
 #include "rendering/data_structure.hpp"
 #include "shader_inputs_buffer.hpp"
 
+#include <atomic>
 #include <memory>
 
 namespace tracey
@@ -41,6 +42,13 @@ namespace tracey
         Count,
     };
 
+    // Per-scene memory a backend reports through sceneMemory(), in bytes.
+    struct SceneMemoryStats
+    {
+        size_t acceleration = 0; // BVH nodes + triangle storage
+        size_t shading = 0;      // per-vertex / per-triangle shading attributes
+    };
+
     // Who owns the presentable output image, and in what form the backend
     // delivers pixels. Decides which InitParams resources the façade creates.
     enum class PathTracerOutputKind
@@ -110,6 +118,15 @@ namespace tracey
         // the AOV is unavailable. Default: no AOVs.
         virtual size_t readbackAOV(AovKind /*aov*/, void * /*dst*/) { return 0; }
 
+        // Host memory the backend holds for the bound scene. Default: not
+        // tracked (all zero).
+        virtual SceneMemoryStats sceneMemory() const { return {}; }
+
+        // True when dispatch() traverses nested instance groups (see
+        // SceneCompiler::CompiledScene::instanceGroups), so callers may
+        // compile with nestInstanceGroups. Default: flat instance lists only.
+        virtual bool supportsInstanceGroups() const { return false; }
+
         // Build pipeline, descriptors, command buffer. Called once at PathTracer
         // construction time.
         virtual void initialize(const InitParams &params) = 0;
@@ -146,6 +163,12 @@ namespace tracey
         // buffer; BackendImage: the output texture). Returns true if it ran.
         // Default: unsupported (no-op) — the GPU backend overrides it.
         virtual bool denoise() { return false; }
+
+        // Flag polled during dispatch(); once it reads true the backend may
+        // stop tracing the frame early, leaving the pixels it didn't reach at
+        // their previous value. Null (the default) never stops. Default: the
+        // GPU backends submit a frame as one dispatch and ignore it.
+        virtual void setCancelFlag(const std::atomic<bool> * /*cancel*/) {}
     };
 
 } // namespace tracey
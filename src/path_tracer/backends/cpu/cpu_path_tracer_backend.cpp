@@ -1,18 +1,21 @@
 // See header. The per-pixel body below mirrors the Metal megakernel in
 // ../metal/pathtrace_msl.hpp statement-for-statement (which itself ports
 // the canonical GLSL set). When editing rendering semantics, change all
-// three together — pt_backend_compare is the referee.
+// three together — pt_backend_compare is the referee. The one exception is
+// the radiance cache (PathTracerConfig::radianceCache), which is CPU-only and
+// leaves the loop, RNG draws included, unchanged while it is off.
 
 #include "cpu_path_tracer_backend.hpp"
 
 #include "path_tracer/api/path_tracer.hpp"
 #include "path_tracer/api/shader_inputs_view.hpp"
 #include "core/parallel.hpp"
-#include "io/denoiser.hpp"   // interactive denoise post-pass (OIDN, guarded)
+#include "io/denoiser.hpp"   // denoise passes (OIDN when built in, else à-trous)
 #include "shading/material_program/opcodes.hpp"
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstdio>
@@ -25,6 +28,12 @@ namespace tracey
     {
         constexpr float kPi = 3.14159265359f;
 
+        // Radiance cache (PathTracerConfig::radianceCache): the most diffuse
+        // vertices one path records for the update, and the metallic weight
+        // above which a surface's reflection is too view-dependent to cache.
+        constexpr uint32_t kMaxCacheVertices = 16;
+        constexpr float kCacheMaxMetallic = 0.05f;
+
         // ── RNG (bit-exact: ray_gen.glsl hash / pbr_lib.glsl nextRandom) ──
         float hashSeed(uint32_t seed)
         {
@@ -89,22 +98,62 @@ namespace tracey
             B = glm::cross(N, T);
         }
 
-        // UV-aligned tangent (Lengyel), Gram-Schmidt against N; falls back to
-        // `fallbackT` for degenerate UVs. Mirrors the MSL backend.
-        glm::vec3 computeUVTangent(const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2,
-                                   const glm::vec2 &uv0, const glm::vec2 &uv1, const glm::vec2 &uv2,
-                                   const glm::vec3 &N, const glm::vec3 &fallbackT)
+        // A triangle's unnormalised UV tangent dP/du (Lengyel); zero for
+        // degenerate UVs.
+        glm::vec3 uvTangentDirection(const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2,
+                                     const glm::vec2 &uv0, const glm::vec2 &uv1, const glm::vec2 &uv2)
         {
             const glm::vec3 e1 = p1 - p0, e2 = p2 - p0;
             const glm::vec2 d1 = uv1 - uv0, d2 = uv2 - uv0;
             const float det = d1.x * d2.y - d2.x * d1.y;
-            if (std::abs(det) < 1e-12f) return fallbackT;
-            glm::vec3 Traw = e1 * d2.y - e2 * d1.y;
-            Traw = Traw - N * glm::dot(N, Traw);
+            if (std::abs(det) < 1e-12f) return glm::vec3(0.0f);
+            return e1 * d2.y - e2 * d1.y;
+        }
+
+        // `dir` Gram-Schmidt'ed against N and normalised; `fallbackT` when
+        // nothing is left of it. Mirrors the MSL backend.
+        glm::vec3 tangentAlong(const glm::vec3 &dir, const glm::vec3 &N, const glm::vec3 &fallbackT)
+        {
+            const glm::vec3 Traw = dir - N * glm::dot(N, dir);
             const float l = glm::length(Traw);
             return l > 1e-8f ? Traw / l : fallbackT;
         }
 
+        // ── Compact shading data (PathTracerConfig::compactShadingData) ──
+        // Unit vectors as octahedral snorm16x2 (Cigolle et al. 2014).
+        // kNoDirection, a code the encoder never emits, stands for a zero
+        // vector: the "no normal" the full-precision path detects by length.
+        constexpr uint32_t kNoDirection = 0x80008000u;
+
+        uint32_t encodeOctahedral(const glm::vec3 &n)
+        {
+            const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+            if (!(l1 > 1e-20f)) return kNoDirection; // also catches NaN
+            glm::vec2 p = glm::vec2(n.x, n.y) / l1;
+            if (n.z < 0.0f)
+            {
+                p = glm::vec2((1.0f - std::abs(p.y)) * (p.x >= 0.0f ? 1.0f : -1.0f),
+                              (1.0f - std::abs(p.x)) * (p.y >= 0.0f ? 1.0f : -1.0f));
+            }
+            const auto snorm = [](float v) {
+                const auto q = static_cast<int16_t>(std::lround(glm::clamp(v, -1.0f, 1.0f) * 32767.0f));
+                return static_cast<uint32_t>(static_cast<uint16_t>(q));
+            };
+            return snorm(p.x) | (snorm(p.y) << 16);
+        }
+
+        glm::vec3 decodeOctahedral(uint32_t code)
+        {
+            if (code == kNoDirection) return glm::vec3(0.0f);
+            const float x = static_cast<float>(static_cast<int16_t>(code & 0xffffu)) / 32767.0f;
+            const float y = static_cast<float>(static_cast<int16_t>(code >> 16)) / 32767.0f;
+            glm::vec3 n(x, y, 1.0f - std::abs(x) - std::abs(y));
+            const float fold = std::max(-n.z, 0.0f);
+            n.x += n.x >= 0.0f ? -fold : fold;
+            n.y += n.y >= 0.0f ? -fold : fold;
+            return glm::normalize(n);
+        }
+
         glm::vec3 tangentToWorld(const glm::vec3 &v, const glm::vec3 &N,
                                  const glm::vec3 &T, const glm::vec3 &B)
         {
@@ -139,21 +188,44 @@ namespace tracey
             return geometrySchlickGGX(NdotL, roughness) * geometrySchlickGGX(NdotV, roughness);
         }
 
+        // View `count` elements of a global vertex-attribute buffer: in place
+        // when it lives in host memory, else through a copy into `copy`. A
+        // missing buffer reads as zeros. Never empty, so the view can always
+        // be indexed.
+        template <typename T>
+        std::span<const T> bindVertexAttribute(const Buffer *buffer, size_t count, std::vector<T> &copy)
+        {
+            if (buffer && count > 0)
+            {
+                if (const void *host = buffer->hostData())
+                {
+                    copy = {};
+                    return {static_cast<const T *>(host), count};
+                }
+                copy.resize(count);
+                std::memcpy(copy.data(), buffer->mapForReading(), count * sizeof(T));
+                buffer->unmap();
+                return copy;
+            }
+            copy.assign(std::max<size_t>(count, 1), T(0.0f));
+            return copy;
+        }
+
         // ── Material fetch (pbr_lib.glsl over GPUMaterial) ──
         uint32_t samplerKindForSlot(const GPUMaterial &m, uint32_t slot)
         {
             return (m.samplerBits >> (slot * 2u)) & 0x3u;
         }
 
-        glm::vec4 sampleTex(const std::vector<CpuTexture> &textures, int idx,
+        glm::vec4 sampleTex(const std::vector<const CpuTexture *> &textures, int idx,
                             uint32_t kind, glm::vec2 uv)
         {
             if (idx < 0 || static_cast<size_t>(idx) >= textures.size()) return glm::vec4(1.0f);
-            return textures[static_cast<size_t>(idx)].sample(uv, kind);
+            return textures[static_cast<size_t>(idx)]->sample(uv, kind);
         }
 
         // ── Sky (sky_miss.glsl) ──
-        glm::vec3 sampleDomeGradient(const std::vector<GPULight> &lights, uint32_t domeIdx,
+        glm::vec3 sampleDomeGradient(std::span<const GPULight> lights, uint32_t domeIdx,
                                      const glm::vec3 &dir)
         {
             const auto *slots = reinterpret_cast<const glm::vec4 *>(lights.data());
@@ -166,7 +238,7 @@ namespace tracey
             return glm::mix(lower, upper, glm::smoothstep(0.45f, 0.55f, y));
         }
 
-        glm::vec3 skyRadiance(const std::vector<GPULight> &lights, uint32_t lightCount,
+        glm::vec3 skyRadiance(std::span<const GPULight> lights, uint32_t lightCount,
                               const glm::vec3 &dir)
         {
             const auto *slots = reinterpret_cast<const glm::vec4 *>(lights.data());
@@ -323,105 +395,257 @@ namespace tracey
     void CpuPathTracerBackend::uploadMaterialPrograms(const MaterialProgramBuffer &programs)
     {
         m_programs = programs;
+        m_radianceCacheStale = true;
     }
 
     void CpuPathTracerBackend::uploadMaterialParameters(const MaterialProgramBuffer &programs)
     {
         m_programs.parameters() = programs.parameters();
+        m_radianceCacheStale = true;
     }
 
     void CpuPathTracerBackend::bindScene(const SceneCompiler::CompiledScene &scene)
     {
-        // Already bound to this scene AND the TLAS actually got built. The m_tlas
-        // check is essential: a prior bind that bailed before building the TLAS
+        // Already bound to this scene AND the TLAS actually got bound. The m_tlas
+        // check is essential: a prior bind that bailed before binding the TLAS
         // (scene not yet built for CPU tracing) must NOT count as "bound", or the
         // trace loop would dereference a null m_tlas. m_sceneRevision is committed
         // only on full success (end of this function), so this stays honest.
-        if (scene.revision == m_sceneRevision && m_tlas) return;
-
-        // BVH: the engine's own CPU acceleration structures. A scene compiled in
-        // raster-only mode (buildAccelerationStructures == false) leaves the BLAS
-        // pointers null — it isn't renderable on the CPU backend. Bail WITHOUT
-        // committing m_sceneRevision (so a later, complete compile rebinds) and
-        // WITHOUT touching m_tlas; dispatch() skips tracing when m_tlas is null,
-        // so this can never crash. Build into a local first so a mid-loop bail
-        // doesn't leave m_blasPtrs half-populated.
-        std::vector<const Blas *> blasPtrs;
-        blasPtrs.reserve(scene.blases.size());
-        for (const auto *blas : scene.blases)
+        if (scene.revision == m_sceneRevision && m_tlas &&
+            m_compactShading == m_config->compactShadingData)
+            return;
+
+        // Which parts moved since the last successful bind. With nothing bound
+        // (first bind, or the last one bailed) everything is redone. The TLAS
+        // depends on the BLASes as well as the instances.
+        const bool rebindAll = !m_tlas;
+        const bool geometry = rebindAll || scene.changes.geometry != m_bound.geometry ||
+                              m_compactShading != m_config->compactShadingData;
+        const bool instances = geometry || scene.changes.instances != m_bound.instances;
+        const bool textures = rebindAll || scene.changes.textures != m_bound.textures;
+
+        if (geometry)
         {
-            const Blas *cpu = blas ? blas->cpuBlas() : nullptr;
-            if (!cpu)
+            // BVH: the engine's own CPU acceleration structures. A scene compiled
+            // in raster-only mode (buildAccelerationStructures == false) leaves the
+            // BLAS pointers null — it isn't renderable on the CPU backend. Bail
+            // WITHOUT committing m_sceneRevision (so a later, complete compile
+            // rebinds) and with m_tlas null, since the one bound may belong to a
+            // scene that is gone; dispatch() skips tracing when m_tlas is null, so
+            // this can never crash. Build into a local first so a mid-loop bail
+            // doesn't leave m_blasPtrs half-populated.
+            std::vector<const Blas *> blasPtrs;
+            blasPtrs.reserve(scene.blases.size());
+            for (const auto *blas : scene.blases)
             {
-                std::fprintf(stderr, "[cpu-pt] bindScene: a BLAS has no CPU data — "
-                                     "scene not built for CPU tracing; skipping bind\n");
-                return;
+                const Blas *cpu = blas ? blas->cpuBlas() : nullptr;
+                if (!cpu)
+                {
+                    std::fprintf(stderr, "[cpu-pt] bindScene: a BLAS has no CPU data — "
+                                         "scene not built for CPU tracing; skipping bind\n");
+                    m_tlas = nullptr;
+                    return;
+                }
+                blasPtrs.push_back(cpu);
             }
-            blasPtrs.push_back(cpu);
-        }
-        m_blasPtrs = std::move(blasPtrs);
-        m_instances = scene.instances;
-        m_instancesEnd = scene.instancesEnd;
-        m_hasMotion = scene.hasMotion && m_instancesEnd.size() == m_instances.size();
-        m_tlas = std::make_unique<Tlas>(
-            std::span<const Blas *>(m_blasPtrs.data(), m_blasPtrs.size()),
-            std::span<const Tlas::Instance>(m_instances.data(), m_instances.size()),
-            std::span<const Tlas::Instance>(m_instancesEnd.data(), m_instancesEnd.size()),
-            m_hasMotion, Tlas::Config{});
+            m_blasPtrs = std::move(blasPtrs);
 
-        m_lights = scene.lights;
-        m_emitters = scene.emitters;
-        m_materials = scene.materials;
+            // Deformation motion. A deforming mesh gets a motion Blas of its own,
+            // built here from the scene's position keys; it stands in for the
+            // engine's static BLAS at the same index.
+            m_motionBlases.clear();
+            if (scene.hasMotion)
+            {
+                for (size_t i = 0; i < scene.blasMotion.size() && i < m_blasPtrs.size(); ++i)
+                {
+                    const auto &keys = scene.blasMotion[i].keys;
+                    if (keys.size() < 2)
+                        continue;
+                    std::vector<std::span<const Vec3>> keySpans(keys.begin(), keys.end());
+                    m_motionBlases.push_back(std::make_unique<Blas>(
+                        std::span<const std::span<const Vec3>>(keySpans.data(), keySpans.size())));
+                    m_blasPtrs[i] = m_motionBlases.back().get();
+                }
+            }
 
-        const size_t instanceCount = scene.instances.size();
-        m_instanceData.assign(std::max<size_t>(instanceCount, 1), glm::uvec2(0));
-        for (size_t i = 0; i < instanceCount; ++i)
-        {
-            m_instanceData[i] = glm::uvec2(
-                i < scene.instanceProgramIndex.size() ? scene.instanceProgramIndex[i] : 0u,
-                i < scene.instanceUvOffset.size() ? scene.instanceUvOffset[i] : 0u);
+            // Global per-vertex attributes, parallel to each other and indexed by
+            // the per-instance uv offset. Positions are object space — used to
+            // derive UV-aligned tangents at the hit for the anisotropic GGX lobe.
+            size_t totalVertices = 0;
+            for (uint32_t c : scene.vertexCounts) totalVertices += c;
+            m_uvs = bindVertexAttribute(scene.uvBuffer.get(), totalVertices, m_uvCopy);
+            m_normals = bindVertexAttribute(scene.normalBuffer.get(), totalVertices, m_normalCopy);
+            m_positions = bindVertexAttribute(scene.positionBuffer.get(), totalVertices, m_positionCopy);
+
+            m_compactShading = m_config->compactShadingData;
+            m_packedNormals = {};
+            m_packedUvs = {};
+            m_packedTangents = {};
+            if (m_compactShading)
+            {
+                const size_t vertexSlots = m_uvs.size();
+                const size_t triangleSlots = std::max<size_t>(vertexSlots / 3, 1);
+                m_packedNormals.resize(vertexSlots);
+                m_packedUvs.resize(vertexSlots);
+                m_packedTangents.resize(triangleSlots, kNoDirection);
+                parallel_for_chunks(vertexSlots, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        m_packedNormals[i] = encodeOctahedral(glm::vec3(m_normals[i]));
+                        m_packedUvs[i] = glm::packHalf2x16(m_uvs[i]);
+                    }
+                });
+                parallel_for_chunks(vertexSlots / 3, [&](size_t begin, size_t end) {
+                    for (size_t t = begin; t < end; ++t)
+                    {
+                        const size_t v = t * 3;
+                        m_packedTangents[t] = encodeOctahedral(uvTangentDirection(
+                            glm::vec3(m_positions[v]), glm::vec3(m_positions[v + 1]), glm::vec3(m_positions[v + 2]),
+                            m_uvs[v], m_uvs[v + 1], m_uvs[v + 2]));
+                    }
+                });
+                // The encoded arrays replace the full-precision ones.
+                m_uvs = {};
+                m_normals = {};
+                m_positions = {};
+                m_uvCopy = {};
+                m_normalCopy = {};
+                m_positionCopy = {};
+                m_shadingBytes = (m_packedNormals.size() + m_packedUvs.size() + m_packedTangents.size()) *
+                                 sizeof(uint32_t);
+            }
+            else
+            {
+                m_shadingBytes = m_uvs.size_bytes() + m_normals.size_bytes() + m_positions.size_bytes();
+            }
         }
 
-        uint32_t totalVertices = 0;
-        for (uint32_t c : scene.vertexCounts) totalVertices += c;
-
-        m_uvs.assign(std::max<uint32_t>(totalVertices, 1), glm::vec2(0.0f));
-        if (scene.uvBuffer && totalVertices > 0)
+        if (instances)
         {
-            std::memcpy(m_uvs.data(), scene.uvBuffer->mapForReading(),
-                        static_cast<size_t>(totalVertices) * sizeof(glm::vec2));
-            scene.uvBuffer->unmap();
+            // Multi-segment poses when the scene carries more than two keys;
+            // otherwise the open/close pair.
+            const bool poseKeys = scene.hasMotion && scene.instanceKeys.size() >= 2;
+            m_hasMotion = scene.hasMotion &&
+                          (scene.instancesEnd.size() == scene.instances.size() || poseKeys ||
+                           !m_motionBlases.empty());
+            const std::span<const Blas *> blasSpan(m_blasPtrs.data(), m_blasPtrs.size());
+
+            // Instance groups (nested instancing) become their own Tlas, built in
+            // order so every group's children already exist. Reserve up front: each
+            // group keeps a span over the prefix of m_groupPtrs built before it.
+            m_tlas = nullptr;
+            m_ownTlas.reset();
+            m_groupTlases.clear();
+            m_groupPtrs.clear();
+            m_groupPtrs.reserve(scene.instanceGroups.size());
+            for (const auto &group : scene.instanceGroups)
+            {
+                const std::span<const Tlas::Instance> members(group.instances.data(), group.instances.size());
+                m_groupTlases.push_back(std::make_unique<Tlas>(
+                    blasSpan, std::span<const Tlas *const>(m_groupPtrs.data(), m_groupPtrs.size()),
+                    members, members, false, Tlas::Config{}, group.recordBase));
+                m_groupPtrs.push_back(m_groupTlases.back().get());
+            }
+            const std::span<const Tlas *const> groupSpan(m_groupPtrs.data(), m_groupPtrs.size());
+
+            // A static, flat scene traces the TLAS the compiler already built
+            // over the same BLASes and instances; building a second one per
+            // transform edit was half the cost of the re-bind.
+            const Tlas *compiled = scene.tlas ? scene.tlas->cpuTlas() : nullptr;
+            if (!m_hasMotion && scene.instanceGroups.empty() && compiled &&
+                compiled->instanceCount() == scene.instances.size())
+            {
+                m_tlas = compiled;
+            }
+            else if (poseKeys)
+            {
+                std::vector<std::span<const Tlas::Instance>> keys(scene.instanceKeys.begin(), scene.instanceKeys.end());
+                m_ownTlas = std::make_unique<Tlas>(
+                    blasSpan, groupSpan,
+                    std::span<const std::span<const Tlas::Instance>>(keys.data(), keys.size()),
+                    Tlas::Config{});
+            }
+            else
+            {
+                m_ownTlas = std::make_unique<Tlas>(
+                    blasSpan, groupSpan,
+                    std::span<const Tlas::Instance>(scene.instances.data(), scene.instances.size()),
+                    std::span<const Tlas::Instance>(scene.instancesEnd.data(), scene.instancesEnd.size()),
+                    m_hasMotion && scene.instancesEnd.size() == scene.instances.size(), Tlas::Config{});
+            }
+            if (m_ownTlas) m_tlas = m_ownTlas.get();
+
+            // Per-record lookups: Hit::instanceId is a record id, which equals the
+            // top-level instance index unless the scene carries nested groups
+            // (their members' records follow the top-level ones).
+            const size_t instanceCount = std::max(scene.instances.size(), scene.instanceProgramIndex.size());
+            m_instanceData.assign(std::max<size_t>(instanceCount, 1), glm::uvec2(0));
+            for (size_t i = 0; i < instanceCount; ++i)
+            {
+                m_instanceData[i] = glm::uvec2(
+                    i < scene.instanceProgramIndex.size() ? scene.instanceProgramIndex[i] : 0u,
+                    i < scene.instanceUvOffset.size() ? scene.instanceUvOffset[i] : 0u);
+            }
         }
 
-        m_normals.assign(std::max<uint32_t>(totalVertices, 1), glm::vec4(0.0f));
-        if (scene.normalBuffer && totalVertices > 0)
-        {
-            std::memcpy(m_normals.data(), scene.normalBuffer->mapForReading(),
-                        static_cast<size_t>(totalVertices) * sizeof(glm::vec4));
-            scene.normalBuffer->unmap();
-        }
+        // Host-side arrays are read in place. Re-seated on every revision: an
+        // in-place edit may have reallocated any of them.
+        m_lights = scene.lights;
+        m_emitters = scene.emitters;
+        m_materials = scene.materials;
 
-        // Object-space positions, parallel to m_uvs/m_normals — used to derive
-        // UV-aligned tangents at the hit for the anisotropic GGX lobe.
-        m_positions.assign(std::max<uint32_t>(totalVertices, 1), glm::vec4(0.0f));
-        if (scene.positionBuffer && totalVertices > 0)
+        if (textures)
         {
-            std::memcpy(m_positions.data(), scene.positionBuffer->mapForReading(),
-                        static_cast<size_t>(totalVertices) * sizeof(glm::vec4));
-            scene.positionBuffer->unmap();
+            // Reuse the float conversion of every image the previous bind already
+            // had; convert the rest in parallel.
+            std::vector<TextureEntry> cache;
+            cache.reserve(scene.textureSources.size());
+            std::vector<size_t> missing;
+            for (const auto &src : scene.textureSources)
+            {
+                TextureEntry entry{src.pixels, src.srgb, nullptr};
+                for (const TextureEntry &old : m_textureCache)
+                {
+                    if (old.pixels == src.pixels && old.srgb == src.srgb)
+                    {
+                        entry.texture = old.texture;
+                        break;
+                    }
+                }
+                if (!entry.texture) missing.push_back(cache.size());
+                cache.push_back(std::move(entry));
+            }
+            parallel_for_each_index(missing.size(), [&](size_t k) {
+                const size_t i = missing[k];
+                cache[i].texture = std::make_shared<const CpuTexture>(scene.textureSources[i]);
+            });
+            m_textureCache = std::move(cache);
+            m_textures.clear();
+            m_textures.reserve(m_textureCache.size());
+            for (const TextureEntry &entry : m_textureCache) m_textures.push_back(entry.texture.get());
         }
 
-        m_textures.clear();
-        m_textures.reserve(scene.textureSources.size());
-        for (const auto &src : scene.textureSources) m_textures.emplace_back(src);
-
-        // Commit only now that the bind fully succeeded (TLAS built, buffers
-        // copied). Stamping it up front — as this used to — meant an early bail or
+        // Commit only now that the bind fully succeeded (TLAS bound, buffers
+        // viewed). Stamping it up front — as this used to — meant an early bail or
         // throw left the scene marked "bound" with m_tlas null, and the next
         // dispatch early-returned straight into a null dereference.
+        m_bound = scene.changes;
         m_sceneRevision = scene.revision;
     }
 
+    SceneMemoryStats CpuPathTracerBackend::sceneMemory() const
+    {
+        // Objects with identical content share one BLAS (BlasCache).
+        std::vector<const Blas *> blases = m_blasPtrs;
+        std::sort(blases.begin(), blases.end());
+        blases.erase(std::unique(blases.begin(), blases.end()), blases.end());
+        SceneMemoryStats stats;
+        for (const Blas *blas : blases)
+            stats.acceleration += blas->memoryBytes();
+        stats.shading = m_shadingBytes;
+        return stats;
+    }
+
     double CpuPathTracerBackend::dispatch(const SceneCompiler::CompiledScene &scene,
                                           uint32_t /*accumulatedSampleCount*/,
                                           bool clearAccumulation,
@@ -440,31 +664,88 @@ namespace tracey
         const uint32_t H = m_config->height;
         const size_t pixelCount = static_cast<size_t>(W) * H;
 
+        const ShaderInputsView in = readShaderInputs(*m_shaderInputs);
+        const uint32_t samplesPerFrame = m_config->samplesPerFrame;
+        const uint32_t firstSample = static_cast<uint32_t>(in.currentSample - 1) * samplesPerFrame;
+
         // AOV layers track the beauty accumulator: allocate lazily (config may
-        // have flipped enableAovs after initialize) and clear in lockstep.
-        const bool aovs = m_config->enableAovs;
+        // have flipped enableAovs after initialize) and clear in lockstep. The
+        // denoise preview needs them as guides even without AOV output.
+        const bool preview = m_config->denoisePreview && !m_config->linearOutput;
+        const bool aovs = m_config->enableAovs || preview;
         if (aovs && m_aovs[0].size() != pixelCount)
+        {
             for (auto &a : m_aovs) a.assign(pixelCount, glm::vec4(0.0f));
+            m_aovFirstSample = clearAccumulation ? 0u : firstSample;
+        }
+        if (preview && m_lumMoment.size() != pixelCount)
+        {
+            // Started mid-accumulation: seed with mean² (zero variance) so the
+            // filter treats the pixels as converged rather than as pure noise.
+            m_lumMoment.resize(pixelCount);
+            for (size_t i = 0; i < pixelCount; ++i)
+            {
+                const float l = glm::dot(glm::vec3(m_accumulator[i]), glm::vec3(0.2126f, 0.7152f, 0.0722f));
+                m_lumMoment[i] = l * l;
+            }
+        }
+        if (!preview && !m_lumMoment.empty())
+        {
+            m_lumMoment = {};
+            m_previewDenoiser.reset();
+        }
+        // Layers nothing accumulates into any more would go stale; drop them
+        // so they can't be mistaken for guides. Re-enabling reallocates them.
+        if (!aovs && !m_aovs[0].empty())
+            for (auto &a : m_aovs) a = {};
 
         if (clearAccumulation)
         {
             std::fill(m_accumulator.begin(), m_accumulator.end(), glm::vec4(0.0f));
             if (aovs)
                 for (auto &a : m_aovs) std::fill(a.begin(), a.end(), glm::vec4(0.0f));
+            std::fill(m_lumMoment.begin(), m_lumMoment.end(), 0.0f);
+            m_aovFirstSample = 0;
         }
+        const uint32_t aovFirstSample = m_aovFirstSample;
 
-        const ShaderInputsView in = readShaderInputs(*m_shaderInputs);
-        const uint32_t samplesPerFrame = m_config->samplesPerFrame;
+        // Radiance cache: (re)start it for this scene and material set. The
+        // cell contents stay valid across camera moves, so an accumulation
+        // clear alone keeps them.
+        const bool radianceCache = m_config->radianceCache;
+        if (radianceCache)
+        {
+            if (m_radianceCache.empty() || m_radianceCacheStale || m_radianceCacheRevision != scene.revision ||
+                m_radianceCache.cellSize() != std::max(m_config->radianceCacheCellSize, 1e-6f))
+            {
+                m_radianceCache.reset(m_config->radianceCacheCellSize);
+                m_radianceCacheRevision = scene.revision;
+                m_radianceCacheStale = false;
+            }
+        }
+        else if (!m_radianceCache.empty())
+        {
+            m_radianceCache.release();
+        }
+        const uint32_t cacheMinSamples = std::max(m_config->radianceCacheMinSamples, 1u);
         const float aspectRatio = static_cast<float>(W) / static_cast<float>(H);
         const float tanHalfFov = std::tan((in.fov * kPi / 180.0f) / 2.0f);
+        const bool compact = m_compactShading;
+        const std::atomic<bool> *cancel = m_cancel;
 
         parallel_for_chunks(static_cast<size_t>(W) * H, [&](size_t begin, size_t end) {
+            // Once cancelled, the rest of the chunk traces no samples: its
+            // pixels keep their accumulated mean and are only re-resolved.
+            uint32_t pixelSamples = samplesPerFrame;
             for (size_t pixelIdx = begin; pixelIdx < end; ++pixelIdx)
             {
                 const uint32_t px = static_cast<uint32_t>(pixelIdx % W);
                 const uint32_t py = static_cast<uint32_t>(pixelIdx / W);
+                if (cancel && (px == 0 || pixelIdx == begin) && cancel->load(std::memory_order_relaxed))
+                    pixelSamples = 0;
 
                 glm::vec3 mean = glm::vec3(m_accumulator[pixelIdx]);
+                float lumMoment = preview ? m_lumMoment[pixelIdx] : 0.0f;
 
                 // Running AOV means (parallel to `mean`), seeded from prior frames.
                 constexpr size_t kAovN = static_cast<size_t>(AovKind::Count);
@@ -472,7 +753,7 @@ namespace tracey
                 if (aovs)
                     for (size_t k = 0; k < kAovN; ++k) aovMean[k] = m_aovs[k][pixelIdx];
 
-                for (uint32_t s = 0; s < samplesPerFrame; ++s)
+                for (uint32_t s = 0; s < pixelSamples; ++s)
                 {
                     // Per-sample AOV values, captured at the first shaded hit
                     // (or the primary miss). Default = background (zero).
@@ -524,6 +805,18 @@ namespace tracey
                     // counting.
                     bool countEmissionOnHit = true;
                     bool alive = true;
+                    // Radiance cache: the diffuse vertices of this path, with
+                    // the throughput reaching each and `accum` just after its
+                    // emission. Whatever `accum` gains past that point is the
+                    // vertex's reflected radiance scaled by its throughput.
+                    struct CacheVertex
+                    {
+                        uint64_t key;
+                        glm::vec3 throughput;
+                        glm::vec3 accum;
+                    };
+                    CacheVertex cacheVertices[kMaxCacheVertices];
+                    uint32_t cacheVertexCount = 0;
 
                     for (uint32_t depth = 0; depth <= in.maxDepth && alive; ++depth)
                     {
@@ -561,10 +854,28 @@ namespace tracey
 
                         const uint32_t base = m_instanceData[instanceIdx].y + triIdx * 3u;
 
+                        glm::vec3 n0, n1, n2;
+                        glm::vec2 uv0, uv1, uv2;
+                        if (compact)
+                        {
+                            n0 = decodeOctahedral(m_packedNormals[base + 0u]);
+                            n1 = decodeOctahedral(m_packedNormals[base + 1u]);
+                            n2 = decodeOctahedral(m_packedNormals[base + 2u]);
+                            uv0 = glm::unpackHalf2x16(m_packedUvs[base + 0u]);
+                            uv1 = glm::unpackHalf2x16(m_packedUvs[base + 1u]);
+                            uv2 = glm::unpackHalf2x16(m_packedUvs[base + 2u]);
+                        }
+                        else
+                        {
+                            n0 = glm::vec3(m_normals[base + 0u]);
+                            n1 = glm::vec3(m_normals[base + 1u]);
+                            n2 = glm::vec3(m_normals[base + 2u]);
+                            uv0 = m_uvs[base + 0u];
+                            uv1 = m_uvs[base + 1u];
+                            uv2 = m_uvs[base + 2u];
+                        }
+
                         glm::vec3 N_raw;
-                        const glm::vec3 n0 = glm::vec3(m_normals[base + 0u]);
-                        const glm::vec3 n1 = glm::vec3(m_normals[base + 1u]);
-                        const glm::vec3 n2 = glm::vec3(m_normals[base + 2u]);
                         const float magSum = glm::dot(n0, n0) + glm::dot(n1, n1) + glm::dot(n2, n2);
                         if (magSum < 1e-6f)
                         {
@@ -592,8 +903,7 @@ namespace tracey
                                                 ? glm::normalize(N_raw - 2.0f * NdotV_raw * V)
                                                 : N_raw;
 
-                        const glm::vec2 uv =
-                            w * m_uvs[base + 0u] + u * m_uvs[base + 1u] + v * m_uvs[base + 2u];
+                        const glm::vec2 uv = w * uv0 + u * uv1 + v * uv2;
 
                         const GPUMaterial &gm = m_materials[instanceIdx];
                         glm::vec3 hostAlbedo(gm.baseColorR, gm.baseColorG, gm.baseColorB);
@@ -669,11 +979,13 @@ namespace tracey
                         glm::vec3 Taniso = T, Baniso = B;
                         if (anisotropy != 0.0f)
                         {
-                            Taniso = computeUVTangent(
-                                glm::vec3(m_positions[base + 0u]),
-                                glm::vec3(m_positions[base + 1u]),
-                                glm::vec3(m_positions[base + 2u]),
-                                m_uvs[base + 0u], m_uvs[base + 1u], m_uvs[base + 2u], N, T);
+                            const glm::vec3 dPdu =
+                                compact ? decodeOctahedral(m_packedTangents[base / 3u])
+                                        : uvTangentDirection(glm::vec3(m_positions[base + 0u]),
+                                                             glm::vec3(m_positions[base + 1u]),
+                                                             glm::vec3(m_positions[base + 2u]),
+                                                             uv0, uv1, uv2);
+                            Taniso = tangentAlong(dPdu, N, T);
                             Baniso = glm::cross(N, Taniso);
                         }
 
@@ -710,6 +1022,27 @@ namespace tracey
                             accum += color * emission;
                         }
 
+                        // Radiance cache: a diffuse vertex reached through a
+                        // diffuse bounce (the NEE gate above is off exactly then)
+                        // ends the path in a converged cell; otherwise the vertex
+                        // is recorded so the completed path can update its cell.
+                        // The geometric normal, turned toward the viewer, keys
+                        // the cell so the two faces of a thin wall stay apart.
+                        if (radianceCache && !isGlass && clearcoat <= 0.0f && metallic < kCacheMaxMetallic)
+                        {
+                            const uint64_t cell = m_radianceCache.key(
+                                hitPos, glm::dot(faceN, V) < 0.0f ? -faceN : faceN);
+                            glm::vec3 cached;
+                            if (!countEmissionOnHit && m_radianceCache.lookup(cell, cacheMinSamples, cached))
+                            {
+                                accum += color * cached;
+                                alive = false;
+                                break;
+                            }
+                            if (cacheVertexCount < kMaxCacheVertices)
+                                cacheVertices[cacheVertexCount++] = {cell, color, accum};
+                        }
+
                         if (in.lightCount > 0 && !isGlass)
                         {
                             const auto *slots = reinterpret_cast<const glm::vec4 *>(m_lights.data());
@@ -1004,6 +1337,19 @@ namespace tracey
                         }
                     }
 
+                    // Radiance cache update: each recorded vertex's outgoing
+                    // radiance as this path measured it.
+                    for (uint32_t c = 0; c < cacheVertexCount; ++c)
+                    {
+                        const CacheVertex &cv = cacheVertices[c];
+                        const glm::vec3 gained = accum - cv.accum;
+                        glm::vec3 radiance(0.0f);
+                        for (int k = 0; k < 3; ++k)
+                            if (cv.throughput[k] > 1e-6f) radiance[k] = gained[k] / cv.throughput[k];
+                        if (std::isfinite(radiance.x) && std::isfinite(radiance.y) && std::isfinite(radiance.z))
+                            m_radianceCache.add(cv.key, glm::max(radiance, glm::vec3(0.0f)));
+                    }
+
                     // ── resolve ──
                     // All radiance (emission, sky, NEE) lives in `accum`;
                     // `color` is pure throughput, consumed during the walk.
@@ -1011,13 +1357,22 @@ namespace tracey
                     const int n = (in.currentSample - 1) * static_cast<int>(samplesPerFrame) +
                                   static_cast<int>(s) + 1;
                     mean = mean + (sampleColor - mean) / static_cast<float>(n);
+                    if (preview)
+                    {
+                        const float l = glm::dot(sampleColor, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+                        lumMoment += (l * l - lumMoment) / static_cast<float>(n);
+                    }
 
                     if (aovs)
+                    {
+                        const float aovN = static_cast<float>(n - static_cast<int>(aovFirstSample));
                         for (size_t k = 0; k < kAovN; ++k)
-                            aovMean[k] += (aovSample[k] - aovMean[k]) / static_cast<float>(n);
+                            aovMean[k] += (aovSample[k] - aovMean[k]) / aovN;
+                    }
                 }
 
                 m_accumulator[pixelIdx] = glm::vec4(mean, 1.0f);
+                if (preview) m_lumMoment[pixelIdx] = lumMoment;
                 if (aovs)
                     for (size_t k = 0; k < kAovN; ++k) m_aovs[k][pixelIdx] = aovMean[k];
 
@@ -1049,17 +1404,20 @@ namespace tracey
             }
         });
 
+        if (preview) denoisePreviewFrame(firstSample + samplesPerFrame);
+
         const auto end = std::chrono::high_resolution_clock::now();
         return std::chrono::duration<double, std::milli>(end - start).count();
     }
 
     // One-shot denoise of the converged accumulation (see PathTracerBackend::
     // denoise — invoked once max samples is reached, not per frame). m_accumulator
-    // IS the linear beauty (one RGBA32F per pixel), so OIDN reads it with no
-    // readback; guided by albedo + normal when AOVs are on. The denoised linear
-    // is tonemapped over the display buffer (m_pixels) with the same Reinhard +
-    // gamma 2.2 as the per-sample resolve. Skipped under linearOutput so it never
-    // touches the EXR / host-side export-denoise path.
+    // IS the linear beauty (one RGBA32F per pixel), so the denoiser reads it with
+    // no readback: OIDN when built in, the à-trous filter otherwise, guided by
+    // albedo + normal (+ depth) whenever the AOV layers are live. The denoised
+    // linear is tonemapped over the display buffer (m_pixels) with the same
+    // Reinhard + gamma 2.2 as the per-sample resolve. Skipped under linearOutput
+    // so it never touches the EXR / host-side export-denoise path.
     bool CpuPathTracerBackend::denoise()
     {
         if (!m_config || m_config->linearOutput || !tracey::denoiserAvailable())
@@ -1069,29 +1427,71 @@ namespace tracey
         if (pixelCount == 0 || m_accumulator.size() != pixelCount) return false;
 
         m_denoiseScratch.resize(pixelCount);
-        const float *albedo = nullptr;
-        const float *normal = nullptr;
-        if (m_config->enableAovs)
-        {
-            const auto &aAov = m_aovs[static_cast<size_t>(AovKind::Albedo)];
-            const auto &nAov = m_aovs[static_cast<size_t>(AovKind::Normal)];
-            if (aAov.size() == pixelCount)
-                albedo = reinterpret_cast<const float *>(aAov.data());
-            if (nAov.size() == pixelCount)
-                normal = reinterpret_cast<const float *>(nAov.data());
-        }
+        // The layers are only current while dispatch() still accumulates
+        // them: AOV output on, or the denoise preview needing its guides.
+        const bool guidesLive =
+            m_config->enableAovs || (m_config->denoisePreview && !m_config->linearOutput);
+        auto guide = [&](AovKind k) -> const float * {
+            const auto &aov = m_aovs[static_cast<size_t>(k)];
+            return guidesLive && aov.size() == pixelCount ? reinterpret_cast<const float *>(aov.data())
+                                                          : nullptr;
+        };
+        DenoiseOptions options;
+        options.depthRGBA = guide(AovKind::Depth);
         if (!tracey::denoiseImage(static_cast<int>(m_config->width),
                                   static_cast<int>(m_config->height),
                                   reinterpret_cast<const float *>(m_accumulator.data()),
-                                  albedo, normal,
-                                  reinterpret_cast<float *>(m_denoiseScratch.data())))
+                                  guide(AovKind::Albedo), guide(AovKind::Normal),
+                                  reinterpret_cast<float *>(m_denoiseScratch.data()),
+                                  options))
             return false;
 
+        writeDisplay(m_denoiseScratch.data());
+        return true;
+    }
+
+    void CpuPathTracerBackend::denoisePreviewFrame(uint32_t sampleCount)
+    {
+        const size_t pixelCount =
+            static_cast<size_t>(m_config->width) * m_config->height;
+        if (pixelCount == 0 || m_lumMoment.size() != pixelCount) return;
+
+        // Variance of each pixel's mean: (E[l²] - E[l]²) / n.
+        m_previewVariance.resize(pixelCount);
+        const float invN = 1.0f / static_cast<float>(std::max(sampleCount, 1u));
+        parallel_for_chunks(pixelCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const float l = glm::dot(glm::vec3(m_accumulator[i]), glm::vec3(0.2126f, 0.7152f, 0.0722f));
+                m_previewVariance[i] = std::max(0.0f, m_lumMoment[i] - l * l) * invN;
+            }
+        });
+
+        m_denoiseScratch.resize(pixelCount);
+        auto guide = [&](AovKind k) {
+            return reinterpret_cast<const float *>(m_aovs[static_cast<size_t>(k)].data());
+        };
+        DenoiseOptions options;
+        options.depthRGBA = guide(AovKind::Depth);
+        options.variance = m_previewVariance.data();
+        m_previewDenoiser.denoise(static_cast<int>(m_config->width),
+                                  static_cast<int>(m_config->height),
+                                  reinterpret_cast<const float *>(m_accumulator.data()),
+                                  guide(AovKind::Albedo), guide(AovKind::Normal),
+                                  reinterpret_cast<float *>(m_denoiseScratch.data()),
+                                  sampleCount, options);
+        writeDisplay(m_denoiseScratch.data());
+    }
+
+    void CpuPathTracerBackend::writeDisplay(const glm::vec4 *linear)
+    {
+        const size_t pixelCount =
+            static_cast<size_t>(m_config->width) * m_config->height;
         const bool hdr = m_config->hdrOutput;
         parallel_for_chunks(pixelCount, [&](size_t begin, size_t end) {
             for (size_t i = begin; i < end; ++i)
             {
-                const glm::vec3 c(m_denoiseScratch[i]);
+                const glm::vec3 c = glm::max(glm::vec3(linear[i]), glm::vec3(0.0f));
                 const glm::vec3 t = c / (c + glm::vec3(1.0f));
                 const glm::vec3 g =
                     glm::pow(glm::max(t, glm::vec3(0.0f)), glm::vec3(1.0f / 2.2f));
@@ -1110,7 +1510,6 @@ namespace tracey
                 }
             }
         });
-        return true;
     }
 
     size_t CpuPathTracerBackend::readback(void *dst)
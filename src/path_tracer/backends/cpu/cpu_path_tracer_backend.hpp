@@ -12,15 +12,20 @@
 #pragma once
 
 #include "path_tracer/api/path_tracer_backend.hpp"
+#include "cpu_radiance_cache.hpp"
 #include "cpu_texture.hpp"
 
+#include "io/denoiser.hpp"
+
 #include "core/tlas.hpp"
 
 #include <glm/glm.hpp>
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <vector>
 
 namespace tracey
@@ -43,43 +48,118 @@ namespace tracey
         size_t readback(void *dst) override;
         bool aovsAvailable() const override;
         size_t readbackAOV(AovKind aov, void *dst) override;
+        SceneMemoryStats sceneMemory() const override;
+        bool supportsInstanceGroups() const override { return true; }
         bool denoise() override;
+        void setCancelFlag(const std::atomic<bool> *cancel) override { m_cancel = cancel; }
 
     private:
         void bindScene(const SceneCompiler::CompiledScene &scene);
+        // Tonemap (Reinhard + gamma 2.2, as the per-sample resolve) a linear
+        // RGBA image into the display buffer.
+        void writeDisplay(const glm::vec4 *linear);
+        // m_config->denoisePreview: à-trous + temporal blend of the current
+        // accumulation into the display buffer.
+        void denoisePreviewFrame(uint32_t sampleCount);
 
         const PathTracerConfig *m_config = nullptr;
         ShaderInputsBuffer *m_shaderInputs = nullptr;
+        const std::atomic<bool> *m_cancel = nullptr; // polled per pixel row
 
         // Frame state.
         std::vector<glm::vec4> m_accumulator;  // running mean per pixel
         std::vector<uint8_t> m_pixels;         // packed RGBA8 or RGBA32F
 
         // AOV layers (one RGBA32F running-mean per pixel), parallel to
-        // m_accumulator, indexed by AovKind. Allocated/written only when
-        // m_config->enableAovs; empty otherwise. See readbackAOV().
+        // m_accumulator, indexed by AovKind. Allocated/written when
+        // m_config->enableAovs, or when the denoise preview needs its
+        // albedo / normal / depth guides; empty otherwise. See readbackAOV().
         std::array<std::vector<glm::vec4>, static_cast<size_t>(AovKind::Count)> m_aovs;
+        // Sample index the AOV means started at. Non-zero when the layers
+        // were switched on mid-accumulation (toggling the denoise preview),
+        // so their running means divide by their own sample count.
+        uint32_t m_aovFirstSample = 0;
 
-        // Scratch for the interactive denoise post-pass (m_config->denoisePreview):
-        // OIDN writes the denoised linear beauty here, then we tonemap it into
-        // m_pixels. Reused across frames to avoid per-frame allocation.
+        // Scratch for the denoise passes (denoise() and the per-frame
+        // m_config->denoisePreview): the denoised linear beauty lands here,
+        // then we tonemap it into m_pixels. Reused across frames to avoid
+        // per-frame allocation.
         std::vector<glm::vec4> m_denoiseScratch;
+        // Denoise preview: running mean of luminance² per pixel (with the
+        // accumulator's mean, the per-pixel variance that steers the
+        // filter), that variance for the current frame, and the filter's
+        // temporal history.
+        std::vector<float> m_lumMoment;
+        std::vector<float> m_previewVariance;
+        PreviewDenoiser m_previewDenoiser;
+
+        // m_config->radianceCache: the shared cell grid, and what it was
+        // filled for. Rebuilt when the scene revision, the material programs
+        // or the cell size change; kept across camera moves and accumulation
+        // clears, which leave the radiance it holds valid.
+        CpuRadianceCache m_radianceCache;
+        uint64_t m_radianceCacheRevision = ~0ull;
+        bool m_radianceCacheStale = true;
 
-        // Per-scene state, rebuilt when revision changes.
+        // Per-scene state. bindScene() compares the scene's change stamps
+        // (CompiledScene::changes) with m_bound and redoes only the
+        // categories that moved, so a transform drag rebuilds the TLAS and
+        // nothing else. Scene-owned arrays are viewed in place rather than
+        // copied; the spans are re-seated on every revision change, which is
+        // the only time the CompiledScene may have moved them.
         uint64_t m_sceneRevision = ~0ull;
+        SceneCompiler::CompiledScene::ChangeStamps m_bound;
         std::vector<const Blas *> m_blasPtrs;
-        std::vector<Tlas::Instance> m_instances;
-        std::vector<Tlas::Instance> m_instancesEnd;  // R4 motion: shutter-close poses
+        // Deformation motion: Blases built from CompiledScene::blasMotion,
+        // referenced from m_blasPtrs in place of the engine's static ones.
+        std::vector<std::unique_ptr<Blas>> m_motionBlases;
         bool m_hasMotion = false;
-        std::unique_ptr<Tlas> m_tlas;
-        std::vector<GPULight> m_lights;
-        std::vector<SceneCompiler::CompiledScene::EmissiveTri> m_emitters; // world-space emissive tris (NEE)
-        std::vector<GPUMaterial> m_materials;       // per-instance
-        std::vector<glm::uvec2> m_instanceData;     // programId, uvOffset
-        std::vector<glm::vec2> m_uvs;               // global per-vertex
-        std::vector<glm::vec4> m_normals;           // global per-vertex
-        std::vector<glm::vec4> m_positions;         // global per-vertex (object space)
-        std::vector<CpuTexture> m_textures;
+        // Nested instancing: one Tlas per CompiledScene::instanceGroups entry,
+        // built children-first; m_groupPtrs is the span every group and the
+        // top-level Tlas resolve group references through.
+        std::vector<std::unique_ptr<Tlas>> m_groupTlases;
+        std::vector<const Tlas *> m_groupPtrs;
+        // The Tlas traced against: the compiler's own CPU TLAS
+        // (TopLevelAccelerationStructure::cpuTlas) when the scene has no
+        // motion or nested groups, else m_ownTlas built here.
+        const Tlas *m_tlas = nullptr;
+        std::unique_ptr<Tlas> m_ownTlas;
+        std::span<const GPULight> m_lights;
+        std::span<const SceneCompiler::CompiledScene::EmissiveTri> m_emitters; // world-space emissive tris (NEE)
+        std::span<const GPUMaterial> m_materials;   // per-record (Hit::instanceId)
+        std::vector<glm::uvec2> m_instanceData;     // programId, uvOffset per record
+        // Global per-vertex attributes: views of the scene's buffers when they
+        // live in host memory (Buffer::hostData), else of the copies below.
+        std::span<const glm::vec2> m_uvs;
+        std::span<const glm::vec4> m_normals;
+        std::span<const glm::vec4> m_positions;     // object space
+        std::vector<glm::vec2> m_uvCopy;
+        std::vector<glm::vec4> m_normalCopy;
+        std::vector<glm::vec4> m_positionCopy;
+        // m_config->compactShadingData: the same attributes encoded, and the
+        // full-precision views above left empty. Normals are octahedral
+        // snorm16x2 and UVs half2, per vertex; positions are only ever used
+        // for the anisotropic lobe's UV tangent, so that is stored instead,
+        // octahedral, one per triangle (the global buffers are triangle
+        // soups: triangle t of a mesh is vertices 3t..3t+2).
+        bool m_compactShading = false;
+        std::vector<uint32_t> m_packedNormals;
+        std::vector<uint32_t> m_packedUvs;
+        std::vector<uint32_t> m_packedTangents;
+        size_t m_shadingBytes = 0;
+        // Float textures, index-parallel to CompiledScene::textureSources.
+        // Converted copies are cached by decoded image (the shared pixels
+        // pointer, which DecodedTextureCache keeps stable across compiles)
+        // and colour space, so a recompile only converts images it has not
+        // seen; the cache holds exactly the current scene's textures.
+        struct TextureEntry
+        {
+            std::shared_ptr<const DecodedTexture> pixels;
+            bool srgb = false;
+            std::shared_ptr<const CpuTexture> texture;
+        };
+        std::vector<TextureEntry> m_textureCache;
+        std::vector<const CpuTexture *> m_textures;
 
         // Packed material programs (interpreted directly).
         MaterialProgramBuffer m_programs;
@@ -0,0 +1,125 @@
+#include "cpu_radiance_cache.hpp"
+
+#include "core/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tracey
+{
+    namespace
+    {
+        // splitmix64 finaliser: spreads the packed cell coordinates, whose
+        // low bits are just x, over the table.
+        uint64_t mixKey(uint64_t k)
+        {
+            k ^= k >> 30;
+            k *= 0xbf58476d1ce4e5b9ull;
+            k ^= k >> 27;
+            k *= 0x94d049bb133111ebull;
+            k ^= k >> 31;
+            return k;
+        }
+
+        // std::atomic<float>::fetch_add is C++20 but not in every standard
+        // library we build against yet.
+        void atomicAdd(std::atomic<float> &target, float value)
+        {
+            float current = target.load(std::memory_order_relaxed);
+            while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+            {
+            }
+        }
+    }
+
+    void CpuRadianceCache::reset(float cellSize)
+    {
+        m_cellSize = std::max(cellSize, 1e-6f);
+        m_invCellSize = 1.0f / m_cellSize;
+        if (!m_cells)
+        {
+            m_cells = std::make_unique<Cell[]>(kCellCount);
+            return;
+        }
+        parallel_for_chunks(kCellCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                Cell &cell = m_cells[i];
+                cell.key.store(0, std::memory_order_relaxed);
+                for (auto &s : cell.sum) s.store(0.0f, std::memory_order_relaxed);
+                cell.count.store(0, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    void CpuRadianceCache::release()
+    {
+        m_cells.reset();
+        m_cellSize = 0.0f;
+        m_invCellSize = 0.0f;
+    }
+
+    uint64_t CpuRadianceCache::key(const glm::vec3 &position, const glm::vec3 &normal) const
+    {
+        // 19 bits per axis (the grid wraps every 2^19 cells, far beyond any
+        // scene at a useful cell size), 3 bits of normal, and a marker bit so
+        // no key is ever 0.
+        const glm::vec3 q = glm::clamp(position * m_invCellSize, glm::vec3(-1.0e9f), glm::vec3(1.0e9f));
+        const auto axis = [](float v) {
+            return static_cast<uint64_t>(static_cast<int64_t>(std::floor(v))) & 0x7ffffull;
+        };
+        const glm::vec3 a = glm::abs(normal);
+        const uint64_t major = a.x >= a.y && a.x >= a.z ? 0u : (a.y >= a.z ? 1u : 2u);
+        const uint64_t side = normal[static_cast<int>(major)] < 0.0f ? 1u : 0u;
+        return axis(q.x) | (axis(q.y) << 19) | (axis(q.z) << 38) | ((major * 2u + side) << 57) |
+               (1ull << 60);
+    }
+
+    bool CpuRadianceCache::lookup(uint64_t key, uint32_t minSamples, glm::vec3 &radiance) const
+    {
+        if (!m_cells) return false;
+        const size_t mask = kCellCount - 1;
+        size_t slot = mixKey(key) & mask;
+        for (uint32_t probe = 0; probe < kMaxProbes; ++probe, slot = (slot + 1) & mask)
+        {
+            const Cell &cell = m_cells[slot];
+            const uint64_t k = cell.key.load(std::memory_order_relaxed);
+            if (k == 0) return false;
+            if (k != key) continue;
+            const uint32_t n = cell.count.load(std::memory_order_acquire);
+            if (n == 0 || n < minSamples) return false;
+            radiance = glm::vec3(cell.sum[0].load(std::memory_order_relaxed),
+                                 cell.sum[1].load(std::memory_order_relaxed),
+                                 cell.sum[2].load(std::memory_order_relaxed)) /
+                       static_cast<float>(n);
+            return true;
+        }
+        return false;
+    }
+
+    void CpuRadianceCache::add(uint64_t key, const glm::vec3 &radiance)
+    {
+        if (!m_cells) return;
+        const size_t mask = kCellCount - 1;
+        size_t slot = mixKey(key) & mask;
+        for (uint32_t probe = 0; probe < kMaxProbes; ++probe, slot = (slot + 1) & mask)
+        {
+            Cell &cell = m_cells[slot];
+            uint64_t k = cell.key.load(std::memory_order_relaxed);
+            // Claim a free slot; on a lost race `k` becomes the winner's key,
+            // which may well be ours.
+            if (k == 0 && cell.key.compare_exchange_strong(k, key, std::memory_order_relaxed))
+                k = key;
+            if (k != key) continue;
+            if (cell.count.load(std::memory_order_relaxed) >= kMaxCellSamples) return;
+            for (int c = 0; c < 3; ++c) atomicAdd(cell.sum[c], radiance[c]);
+            cell.count.fetch_add(1, std::memory_order_release);
+            return;
+        }
+    }
+
+    size_t CpuRadianceCache::memoryBytes() const
+    {
+        return m_cells ? kCellCount * sizeof(Cell) : 0;
+    }
+} // namespace tracey
@@ -0,0 +1,71 @@
+// World-space radiance cache for the CPU path tracer backend
+// (PathTracerConfig::radianceCache).
+//
+// A fixed-size, open-addressed hash grid. A cell is keyed by the hit
+// position quantised to `cellSize` plus the dominant axis of the surface
+// normal, which keeps the two sides of a thin wall and the faces that meet
+// at a corner in separate cells. A cell holds the running sum of the
+// outgoing radiance that completed paths measured leaving diffuse surfaces
+// inside it, along with the number of samples.
+//
+// Every path-tracing lane reads and writes the cells concurrently without
+// locks. Keys are claimed with a CAS, sums grow through atomic adds, and
+// the count is published last. A reader may therefore see a sum that is one
+// sample ahead of its count. That is noise, not tearing, and is harmless
+// for an estimate the cache averages over thousands of samples.
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tracey
+{
+    class CpuRadianceCache
+    {
+    public:
+        // Cells in the table, and the linear-probe distance before an insert
+        // gives up. A full neighbourhood just means that point is not cached.
+        static constexpr size_t kCellCount = size_t(1) << 20;
+        static constexpr uint32_t kMaxProbes = 8;
+        // A cell stops taking samples here. Its mean has converged long
+        // before, and this bounds the float error in the running sums.
+        static constexpr uint32_t kMaxCellSamples = 1u << 14;
+
+        // Empty every cell and start over with `cellSize` (world units). The
+        // table is allocated on first use.
+        void reset(float cellSize);
+        // Free the table (cache switched off).
+        void release();
+        bool empty() const { return !m_cells; }
+        float cellSize() const { return m_cellSize; }
+
+        // Cell key for a surface point and its (geometric) normal. Never 0.
+        uint64_t key(const glm::vec3 &position, const glm::vec3 &normal) const;
+
+        // Mean radiance of the cell, if it exists and holds at least
+        // `minSamples` samples.
+        bool lookup(uint64_t key, uint32_t minSamples, glm::vec3 &radiance) const;
+
+        // Add one radiance sample to the cell, claiming a slot for it if needed.
+        void add(uint64_t key, const glm::vec3 &radiance);
+
+        size_t memoryBytes() const;
+
+    private:
+        struct Cell
+        {
+            std::atomic<uint64_t> key{0};  // 0 = free
+            std::atomic<float> sum[3] = {0.0f, 0.0f, 0.0f};
+            std::atomic<uint32_t> count{0};
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        float m_cellSize = 0.0f;
+        float m_invCellSize = 0.0f;
+    };
+} // namespace tracey
@@ -1,5 +1,7 @@
 #include "cpu_texture.hpp"
 
+#include "scene/texture_cache.hpp"
+
 #include <algorithm>
 #include <cmath>
 
@@ -20,13 +22,14 @@ namespace tracey
         : m_width(src.width), m_height(src.height)
     {
         const size_t count = static_cast<size_t>(src.width) * src.height;
+        const uint8_t *rgba8 = src.pixels->rgba8.data();
         m_texels.resize(count);
         for (size_t i = 0; i < count; ++i)
         {
-            glm::vec4 t(src.rgba8[i * 4 + 0] / 255.0f,
-                        src.rgba8[i * 4 + 1] / 255.0f,
-                        src.rgba8[i * 4 + 2] / 255.0f,
-                        src.rgba8[i * 4 + 3] / 255.0f);
+            glm::vec4 t(rgba8[i * 4 + 0] / 255.0f,
+                        rgba8[i * 4 + 1] / 255.0f,
+                        rgba8[i * 4 + 2] / 255.0f,
+                        rgba8[i * 4 + 3] / 255.0f);
             if (src.srgb)
             {
                 t.r = srgbToLinear(t.r);
@@ -29,6 +29,7 @@
 #endif
 
 #include "path_tracer/api/path_tracer.hpp"
+#include "scene/texture_cache.hpp"
 #include "device/gpu/vulkan_compute_device.hpp"
 #include "device/gpu/vulkan_image_2d.hpp"
 #include "gpu/vulkan_context.hpp"
@@ -380,12 +381,15 @@ namespace tracey
                 idesc.instanceDescriptorBufferOffset = 0;
                 idesc.instanceDescriptorStride = sizeof(MTLAccelerationStructureInstanceDescriptor);
 
-                // R4 motion blur: rebuild as a hardware motion AS — two matrix
-                // keyframes per instance (shutter-open/-close), interpolated by
-                // the per-ray time the pathtrace_motion kernel passes to
-                // intersect(). Matrix keyframes interpolate linearly, matching
-                // the CPU TLAS. The motion AS is consumed by the instance_motion
-                // intersector in pathtrace_motion.
+                // R4 motion blur: rebuild as a hardware motion AS — K matrix
+                // keyframes per instance (shutter-open/-close, plus any interior
+                // keys in scene.instanceKeys), evenly spaced over [0,1] and
+                // interpolated by the per-ray time the pathtrace_motion kernel
+                // passes to intersect(). Matrix keyframes interpolate linearly
+                // per segment, matching the CPU TLAS. The motion AS is consumed
+                // by the instance_motion intersector in pathtrace_motion.
+                // Deformation keys (scene.blasMotion) are CPU-only for now;
+                // deforming meshes render at their shutter-open shape here.
                 const bool motion = scene.hasMotion &&
                                     scene.instancesEnd.size() == instanceCount &&
                                     instanceCount > 0;
@@ -399,12 +403,24 @@ namespace tracey
                             m.columns[c] = MTLPackedFloat3Make(
                                 inst.transform[0][c], inst.transform[1][c], inst.transform[2][c]);
                     };
-                    std::vector<MTLPackedFloat4x3> motionXf(instanceCount * 2);
+                    bool multiKey = scene.instanceKeys.size() > 2;
+                    for (const auto &key : scene.instanceKeys)
+                        multiKey = multiKey && key.size() == instanceCount;
+                    const size_t keyCount = multiKey ? scene.instanceKeys.size() : 2;
+                    std::vector<MTLPackedFloat4x3> motionXf(instanceCount * keyCount);
                     std::vector<MTLAccelerationStructureMotionInstanceDescriptor> mdescs(instanceCount);
                     for (size_t i = 0; i < instanceCount; ++i)
                     {
-                        fill(motionXf[i * 2 + 0], scene.instances[i]);
-                        fill(motionXf[i * 2 + 1], scene.instancesEnd[i]);
+                        if (multiKey)
+                        {
+                            for (size_t k = 0; k < keyCount; ++k)
+                                fill(motionXf[i * keyCount + k], scene.instanceKeys[k][i]);
+                        }
+                        else
+                        {
+                            fill(motionXf[i * 2 + 0], scene.instances[i]);
+                            fill(motionXf[i * 2 + 1], scene.instancesEnd[i]);
+                        }
                         MTLAccelerationStructureMotionInstanceDescriptor &d = mdescs[i];
                         d.options = MTLAccelerationStructureInstanceOptionDisableTriangleCulling |
                                     MTLAccelerationStructureInstanceOptionOpaque;
@@ -412,8 +428,8 @@ namespace tracey
                         d.intersectionFunctionTableOffset = 0;
                         d.accelerationStructureIndex =
                             static_cast<uint32_t>(scene.instances[i].blasAddress);
-                        d.motionTransformsStartIndex = static_cast<uint32_t>(i * 2);
-                        d.motionTransformsCount = 2;
+                        d.motionTransformsStartIndex = static_cast<uint32_t>(i * keyCount);
+                        d.motionTransformsCount = static_cast<uint32_t>(keyCount);
                         d.motionStartBorderMode = MTLMotionBorderModeClamp;
                         d.motionEndBorderMode = MTLMotionBorderModeClamp;
                         d.motionStartTime = 0.0f;
@@ -427,7 +443,7 @@ namespace tracey
                     idesc.instanceDescriptorType = MTLAccelerationStructureInstanceDescriptorTypeMotion;
                     idesc.motionTransformBuffer = motionXfBuf;
                     idesc.motionTransformBufferOffset = 0;
-                    idesc.motionTransformCount = static_cast<NSUInteger>(instanceCount * 2);
+                    idesc.motionTransformCount = static_cast<NSUInteger>(instanceCount * keyCount);
                     idesc.instanceDescriptorBuffer = motionDescBuf;
                     idesc.instanceDescriptorStride =
                         sizeof(MTLAccelerationStructureMotionInstanceDescriptor);
@@ -532,7 +548,7 @@ namespace tracey
                 id<MTLTexture> tex = [device newTextureWithDescriptor:td];
                 [tex replaceRegion:MTLRegionMake2D(0, 0, src.width, src.height)
                        mipmapLevel:0
-                         withBytes:src.rgba8.data()
+                         withBytes:src.pixels->rgba8.data()
                        bytesPerRow:static_cast<NSUInteger>(src.width) * 4];
                 [sceneTextures addObject:tex];
             }
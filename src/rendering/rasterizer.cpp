@@ -323,6 +323,18 @@ namespace tracey
         pc.misc     = glm::uvec4(m_currentLightCount, 0u, 0u, 0u);
         m_commandBuffer->pushConstants(&pc, sizeof(pc), 0);
 
+        // A scene compiled for the CPU path tracer may place nested instance
+        // groups. Draw their leaves; each reads the material of its record.
+        std::vector<Tlas::Instance> expandedInstances;
+        std::vector<uint32_t> expandedRecords;
+        if (!scene.instanceGroups.empty())
+            SceneCompiler::expandInstanceGroups(scene, expandedInstances, expandedRecords);
+        const std::vector<Tlas::Instance> &instances =
+            scene.instanceGroups.empty() ? scene.instances : expandedInstances;
+        const auto recordOf = [&expandedRecords](size_t i) -> size_t {
+            return expandedRecords.empty() ? i : expandedRecords[i];
+        };
+
         // Per-instance layout (must match the vertex input description
         // in vulkan_graphics_pipeline.cpp + the input declarations in
         // position_only.vert): mat4 model + albedo + (metallic,
@@ -351,10 +363,10 @@ namespace tracey
             // body of the original serial loop, unchanged.
             std::vector<InstanceData> insts(count);
             tracey::parallel_for_chunks(count,
-                [&insts, &scene, startInst](size_t kBegin, size_t kEnd) {
+                [&insts, &scene, &instances, &recordOf, startInst](size_t kBegin, size_t kEnd) {
                     for (size_t k = kBegin; k < kEnd; ++k)
                     {
-                        const auto &inst = scene.instances[startInst + k];
+                        const auto &inst = instances[startInst + k];
                         glm::mat4 model(1.0f);
                         for (int r = 0; r < 3; ++r)
                             for (int c = 0; c < 4; ++c)
@@ -362,7 +374,7 @@ namespace tracey
                         glm::vec4 albedo(0.8f, 0.8f, 0.8f, 1.0f);
                         glm::vec4 mrx(0.0f, 0.5f, 0.0f, 0.0f);  // metallic, roughness, emissive strength
                         glm::vec4 emissive(0.0f, 0.0f, 0.0f, 0.0f);
-                        const size_t mi = startInst + k;
+                        const size_t mi = recordOf(startInst + k);
                         if (mi < scene.instanceToMaterialIndex.size())
                         {
                             const uint32_t matIdx = scene.instanceToMaterialIndex[mi];
@@ -418,12 +430,12 @@ namespace tracey
         // batchable chunks. Non-contiguous repeats are rare in practice
         // and just produce more, smaller batches.
         size_t i = 0;
-        while (i < scene.instances.size())
+        while (i < instances.size())
         {
-            const size_t blasIndex = static_cast<size_t>(scene.instances[i].blasAddress);
+            const size_t blasIndex = static_cast<size_t>(instances[i].blasAddress);
             size_t j = i + 1;
-            while (j < scene.instances.size() &&
-                   static_cast<size_t>(scene.instances[j].blasAddress) == blasIndex)
+            while (j < instances.size() &&
+                   static_cast<size_t>(instances[j].blasAddress) == blasIndex)
                 ++j;
             drawBatch(blasIndex, i, j - i);
             i = j;
@@ -436,9 +448,9 @@ namespace tracey
         if (m_showEdges)
         {
             m_commandBuffer->bindLinesPipeline(m_pipeline.get());
-            for (size_t i = 0; i < scene.instances.size(); ++i)
+            for (size_t i = 0; i < instances.size(); ++i)
             {
-                const auto& instance = scene.instances[i];
+                const auto& instance = instances[i];
                 size_t blasIndex = static_cast<size_t>(instance.blasAddress);
                 if (blasIndex >= scene.vertexBuffers.size()) continue;
                 const Buffer* vb = scene.vertexBuffers[blasIndex];
@@ -455,9 +467,9 @@ namespace tracey
                         model[c][r] = instance.transform[r][c];
 
                 glm::vec4 baseColor(0.8f, 0.8f, 0.8f, 1.0f);
-                if (i < scene.instanceToMaterialIndex.size())
+                if (const size_t record = recordOf(i); record < scene.instanceToMaterialIndex.size())
                 {
-                    uint32_t matIdx = scene.instanceToMaterialIndex[i];
+                    uint32_t matIdx = scene.instanceToMaterialIndex[record];
                     if (matIdx < scene.materials.size())
                     {
                         const auto& m = scene.materials[matIdx];
@@ -485,9 +497,9 @@ namespace tracey
         if (m_showPoints)
         {
             m_commandBuffer->bindPointsPipeline(m_pipeline.get());
-            for (size_t i = 0; i < scene.instances.size(); ++i)
+            for (size_t i = 0; i < instances.size(); ++i)
             {
-                const auto& instance = scene.instances[i];
+                const auto& instance = instances[i];
                 size_t blasIndex = static_cast<size_t>(instance.blasAddress);
                 if (blasIndex >= scene.vertexBuffers.size()) continue;
                 const Buffer* vb = scene.vertexBuffers[blasIndex];
@@ -504,9 +516,9 @@ namespace tracey
                         model[c][r] = instance.transform[r][c];
 
                 glm::vec4 baseColor(0.8f, 0.8f, 0.8f, 1.0f);
-                if (i < scene.instanceToMaterialIndex.size())
+                if (const size_t record = recordOf(i); record < scene.instanceToMaterialIndex.size())
                 {
-                    uint32_t matIdx = scene.instanceToMaterialIndex[i];
+                    uint32_t matIdx = scene.instanceToMaterialIndex[record];
                     if (matIdx < scene.materials.size())
                     {
                         const auto& m = scene.materials[matIdx];
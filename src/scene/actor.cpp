@@ -1,10 +1,14 @@
 #include "actor.hpp"
 #include "scene.hpp"
+
+#include <algorithm>
+
 namespace tracey
 {
     void Actor::setTransform(const Transform &transform)
     {
         m_transform = transform;
+        markWorldDirty();
     }
 
     void Actor::applyTransform(const Transform &deltaTransform)
@@ -12,12 +16,86 @@ namespace tracey
         m_transform.applyRotation(deltaTransform.rotation());
         m_transform.applyScale(deltaTransform.scale());
         m_transform.setPosition(m_transform.position() + deltaTransform.position());
+        markWorldDirty();
     }
 
     const Transform &Actor::transform() const
     {
         return m_transform;
     }
+
+    const Mat4 &Actor::worldTransform() const
+    {
+        if (!m_worldDirty)
+            return m_worldTransform;
+
+        // Collect the dirty chain up to the nearest clean ancestor (or the
+        // root), then compose top-down. Iterative, so a deep hierarchy can't
+        // overflow the stack.
+        std::vector<const Actor *> chain;
+        const Mat4 *parentWorld = nullptr;
+        for (const Actor *actor = this; actor;)
+        {
+            if (!actor->m_worldDirty)
+            {
+                parentWorld = &actor->m_worldTransform;
+                break;
+            }
+            chain.push_back(actor);
+            actor = (actor->hasParent() && actor->m_scene) ? actor->m_scene->getActor(actor->m_parent) : nullptr;
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            const Actor &actor = **it;
+            actor.m_worldTransform = parentWorld ? *parentWorld * actor.m_transform.toMatrix()
+                                                 : actor.m_transform.toMatrix();
+            actor.m_worldDirty = false;
+            parentWorld = &actor.m_worldTransform;
+        }
+        return m_worldTransform;
+    }
+
+    void Actor::markWorldDirty()
+    {
+        if (m_worldDirty)
+            return;
+        // Explicit stack for the same reason as worldTransform().
+        std::vector<Actor *> pending{this};
+        while (!pending.empty())
+        {
+            Actor *actor = pending.back();
+            pending.pop_back();
+            if (actor->m_worldDirty)
+                continue;
+            actor->m_worldDirty = true;
+            if (!actor->m_scene)
+                continue;
+            for (auto childUid : actor->m_children)
+            {
+                if (Actor *child = actor->m_scene->getActor(childUid))
+                    pending.push_back(child);
+            }
+        }
+    }
+
+    void Actor::setParent(size_t parentUid)
+    {
+        if (parentUid == m_parent)
+            return;
+        if (m_scene)
+        {
+            if (Actor *oldParent = hasParent() ? m_scene->getActor(m_parent) : nullptr)
+            {
+                auto &siblings = oldParent->m_children;
+                siblings.erase(std::remove(siblings.begin(), siblings.end(), uid), siblings.end());
+            }
+            if (Actor *newParent = parentUid != kNoParent ? m_scene->getActor(parentUid) : nullptr)
+                newParent->m_children.push_back(uid);
+        }
+        m_parent = parentUid;
+        markWorldDirty();
+    }
+
     const std::span<const size_t> Actor::children() const
     {
         return m_children;
@@ -25,5 +103,13 @@ namespace tracey
     void Actor::removeChild(size_t childUid)
     {
         m_children.erase(std::remove(m_children.begin(), m_children.end(), childUid), m_children.end());
+        if (Actor *child = m_scene ? m_scene->getActor(childUid) : nullptr)
+        {
+            if (child->m_parent == uid)
+            {
+                child->m_parent = kNoParent;
+                child->markWorldDirty();
+            }
+        }
     }
 }
\ No newline at end of file
@@ -25,28 +25,36 @@ namespace tracey
 
         size_t getUid() const { return uid; }
 
-        // The transform stored here is a *local* transform; Scene::flatten
-        // composes world = parent.world × actor.local while walking the
-        // parent → children tree. SceneCompiler consumes the resulting world
-        // transforms when building TLAS instances.
+        // The transform stored here is a *local* transform; worldTransform()
+        // composes parent.world × actor.local up the parent chain.
+        // SceneCompiler consumes the world transforms (via Scene::flatten)
+        // when building TLAS instances.
         void setTransform(const Transform &transform);
         void applyTransform(const Transform &deltaTransform);
         const Transform &transform() const;
 
+        // Cached world transform. Recomputed lazily, and only when this
+        // actor or one of its ancestors changed transform or parent since
+        // the last call — editing one actor re-dirties just its subtree.
+        // Not safe to call concurrently with itself on a dirty chain; the
+        // parallel Scene::flatten cleans shared ancestors before fanning out.
+        const Mat4 &worldTransform() const;
+
         // Parent–child topology. Parent uid is SIZE_MAX when this actor sits
-        // at the root of the scene tree. addChild() appends the child's uid
-        // to m_children but does NOT set the child's parent — call setParent
-        // on the child too. (Both edges are stored so Scene::flatten can run
-        // top-down without a per-actor reverse scan.)
+        // at the root of the scene tree. Both edges are kept in sync:
+        // setParent() moves this actor into the new parent's child list (and
+        // out of the old one's), addChild(c) is c->setParent(uid()), and
+        // removeChild() detaches the child back to the root. Re-parenting to
+        // the current parent is a no-op, so wiring an edge twice is harmless.
         static constexpr size_t kNoParent = SIZE_MAX;
         size_t parent() const { return m_parent; }
-        void setParent(size_t parentUid) { m_parent = parentUid; }
+        void setParent(size_t parentUid);
         bool hasParent() const { return m_parent != kNoParent; }
 
         const std::span<const size_t> children() const;
         void addChild(Actor *child)
         {
-            m_children.push_back(child->uid);
+            if (child) child->setParent(uid);
         }
         void removeChild(size_t childUid);
 
@@ -94,10 +102,18 @@ namespace tracey
         Actor(Scene *scene, size_t uid) : m_scene(scene), uid(uid) {}
 
     private:
-        [[maybe_unused]] Scene *m_scene = nullptr;
+        friend class Scene;
+        // Flag this actor's and every descendant's cached world transform
+        // stale. Stops at an already-dirty actor: dirty implies its whole
+        // subtree is dirty too.
+        void markWorldDirty();
+
+        Scene *m_scene = nullptr;
         size_t uid = 0;
         std::string m_name;
         Transform m_transform;
+        mutable Mat4 m_worldTransform{1.0f};
+        mutable bool m_worldDirty = true;
         size_t m_parent = kNoParent;
         std::vector<size_t> m_children;
         std::vector<SceneInstance> m_instances;
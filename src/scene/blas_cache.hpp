@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../core/shared_array.hpp"
 #include "../core/types.hpp"
 #include "../device/bottom_level_acceleration_structure.hpp"
 #include "../device/buffer.hpp"
@@ -43,14 +44,15 @@ namespace tracey
             // UVs travel with the cache entry rather than the GPU because the
             // compiler concatenates them into a global uvBuffer per compile —
             // we keep them around so a cache hit doesn't have to re-extract
-            // from the SceneObject.
-            std::vector<Vec2> uvs;
+            // from the SceneObject. Shared with the SceneObject's own channel
+            // (no copy) unless it had to be padded to vertexCount.
+            SharedArray<Vec2> uvs;
             bool hasUvs = false;
             // Per-vertex normals — same per-cook-concat treatment as UVs so
             // the hit shader can interpolate them at intersection. Empty +
             // hasNormals=false when the source SceneObject had no N (the
             // shader then falls back to the face normal stored in the BLAS).
-            std::vector<Vec3> normals;
+            SharedArray<Vec3> normals;
             bool hasNormals = false;
             uint64_t contentHash = 0;
             // Set true when lookup() / insert() returns this entry during a
@@ -0,0 +1,62 @@
+#include "blas_prebuilder.hpp"
+
+namespace tracey
+{
+    BlasPrebuilder::BlasPrebuilder(Device *device, BlasCache &cache, const BVHConfig &bvhConfig,
+                                   std::shared_mutex *exclusive)
+        : m_device(device), m_cache(cache), m_bvhConfig(bvhConfig), m_exclusive(exclusive)
+    {
+        m_thread = std::thread([this] { run(); });
+    }
+
+    BlasPrebuilder::~BlasPrebuilder()
+    {
+        finish();
+    }
+
+    void BlasPrebuilder::push(const std::string &name, const SceneObject &obj)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.emplace_back(name, obj);
+        }
+        m_cv.notify_one();
+    }
+
+    void BlasPrebuilder::finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done = true;
+        }
+        m_cv.notify_one();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    size_t BlasPrebuilder::built() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_built;
+    }
+
+    void BlasPrebuilder::run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;)
+        {
+            m_cv.wait(lock, [this] { return m_done || !m_queue.empty(); });
+            if (m_queue.empty()) return; // done and drained
+            auto [name, obj] = std::move(m_queue.front());
+            m_queue.pop_front();
+            lock.unlock();
+            bool ok = false;
+            {
+                std::unique_lock<std::shared_mutex> exclusive;
+                if (m_exclusive) exclusive = std::unique_lock<std::shared_mutex>(*m_exclusive);
+                ok = SceneCompiler::prepareObject(m_device, name, obj, m_bvhConfig, m_cache);
+            }
+            lock.lock();
+            if (ok) ++m_built;
+        }
+    }
+}
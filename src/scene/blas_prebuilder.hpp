@@ -0,0 +1,67 @@
+#pragma once
+
+// Builds BLASes for objects as an import streams them in.
+//
+// Owns one thread that drains a queue of (name, SceneObject) and runs
+// SceneCompiler::prepareObject for each into the given BlasCache, so the BVH
+// builds for the first meshes of a file overlap the parsing of the rest.
+// Wire push() into ImportStream::onObject, then call finish() once the load
+// returns and compile the final Scene with the same cache and BVH config —
+// every object the prebuilder saw comes back as a cache hit.
+//
+// The device and the cache belong to the builder thread between construction
+// and finish(): the caller must not compile with either in the meantime —
+// unless it passes `exclusive`, a lock the builder takes uniquely around each
+// build and the caller's compiles take too (the editor's GPU lock, shared
+// with its live renderer).
+
+#include "scene_compiler.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace tracey
+{
+    class BlasPrebuilder
+    {
+    public:
+        BlasPrebuilder(Device *device, BlasCache &cache, const BVHConfig &bvhConfig = BVHConfig{},
+                       std::shared_mutex *exclusive = nullptr);
+        ~BlasPrebuilder();
+
+        BlasPrebuilder(const BlasPrebuilder &) = delete;
+        BlasPrebuilder &operator=(const BlasPrebuilder &) = delete;
+
+        // Queue `obj` for a build under `name`. Cheap (the SceneObject copy
+        // shares its channels); safe from any thread.
+        void push(const std::string &name, const SceneObject &obj);
+
+        // Wait for the queue to drain and stop the thread. Idempotent.
+        void finish();
+
+        // Objects built so far (cache hits on a name+hash already present
+        // count too).
+        size_t built() const;
+
+    private:
+        void run();
+
+        Device *m_device;
+        BlasCache &m_cache;
+        BVHConfig m_bvhConfig;
+        std::shared_mutex *m_exclusive;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::deque<std::pair<std::string, SceneObject>> m_queue;
+        size_t m_built = 0;
+        bool m_done = false;
+        std::thread m_thread;
+    };
+}
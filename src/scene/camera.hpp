@@ -1,6 +1,7 @@
 #pragma once
 #include "../core/types.hpp"
 #include "transform.hpp"
+#include <algorithm>
 
 namespace tracey
 {
@@ -46,6 +47,13 @@ namespace tracey
         void setShutter(float shutter) { m_shutter = shutter; }
         float shutter() const { return m_shutter; }
 
+        // Scene evaluations across the open shutter (>= 2, evenly spaced;
+        // 2 = open + close only). More samples give curved paths for
+        // rotating instances and follow non-linear deformation, at one
+        // scene evaluation each.
+        void setMotionSamples(int samples) { m_motionSamples = std::max(samples, 2); }
+        int motionSamples() const { return m_motionSamples; }
+
         // Computed directions
         Vec3 forward() const
         {
@@ -87,5 +95,6 @@ namespace tracey
         float m_aperture = 0.0f;        // lens radius (0 = pinhole)
         float m_focalDistance = 5.0f;   // in-focus distance along the view dir
         float m_shutter = 0.0f;         // shutter-open fraction (0 = no motion blur)
+        int m_motionSamples = 2;        // scene evaluations over the shutter
     };
 }
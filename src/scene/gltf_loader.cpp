@@ -5,6 +5,8 @@
 #include "camera.hpp"
 #include "skeleton.hpp"
 #include "scene_object.hpp"
+#include "import_stream.hpp"
+#include "../core/parallel.hpp"
 // tinygltf pulls in stb_image_write here; its aggregate initialisers trip
 // -Wmissing-field-initializers. Silence that vendored-header noise locally.
 #pragma clang diagnostic push
@@ -923,7 +925,10 @@ namespace tracey
         gltfCache().erase(path);
     }
 
-    std::unique_ptr<Scene> GltfLoader::loadFromFile(const std::string &path, const LoadOptions &options)
+    // Shared body of loadFromFile / loadFromFileStreaming (`stream` null for
+    // the former).
+    static std::unique_ptr<Scene> loadGltf(const std::string &path, const GltfLoader::LoadOptions &options,
+                                           const ImportStream *stream)
     {
         tinygltf::Model model;
         tinygltf::TinyGLTF loader;
@@ -972,9 +977,18 @@ namespace tracey
         // Extract embedded textures from GLTF model before processing
         extractEmbeddedTextures(model, *scene);
 
-        // First pass: Create SceneObjects for all mesh primitives
-        std::unordered_map<int, std::string> meshToObjectName;
-
+        // First pass: Create SceneObjects for all mesh primitives. The
+        // primitives are independent, so they're converted on the pool into
+        // slots (each streamed out as it completes) and then added to the
+        // scene serially in file order.
+        struct PrimitiveSlot
+        {
+            size_t meshIdx;
+            size_t primIdx;
+            std::string objectName;
+            SceneObject obj;
+        };
+        std::vector<PrimitiveSlot> slots;
         for (size_t meshIdx = 0; meshIdx < model.meshes.size(); ++meshIdx)
         {
             const auto &mesh = model.meshes[meshIdx];
@@ -989,22 +1003,34 @@ namespace tracey
                     continue;
                 }
 
-                SceneObject obj = processPrimitive(model, primitive, options);
-                if (obj.vertexCount() == 0)
-                {
-                    continue;
-                }
-
                 std::string objectName = mesh.name.empty()
                                              ? ("mesh_" + std::to_string(meshIdx) + "_prim_" + std::to_string(primIdx))
                                              : (mesh.name + "_prim_" + std::to_string(primIdx));
+                slots.push_back(PrimitiveSlot{meshIdx, primIdx, std::move(objectName), SceneObject()});
+            }
+        }
 
-                int primKey = static_cast<int>(meshIdx) * 1000 + static_cast<int>(primIdx);
-                meshToObjectName[primKey] = objectName;
+        ImportStreamEmitter emitter(stream, "meshes", slots.size());
+        parallel_for_each_index(slots.size(), [&](size_t i) {
+            PrimitiveSlot &slot = slots[i];
+            slot.obj = processPrimitive(model, model.meshes[slot.meshIdx].primitives[slot.primIdx], options);
+            emitter.object(slot.objectName, slot.obj);
+        });
 
-                scene->addObject(objectName, std::move(obj));
+        std::unordered_map<int, std::string> meshToObjectName;
+        for (PrimitiveSlot &slot : slots)
+        {
+            if (slot.obj.vertexCount() == 0)
+            {
+                continue;
             }
+
+            int primKey = static_cast<int>(slot.meshIdx) * 1000 + static_cast<int>(slot.primIdx);
+            meshToObjectName[primKey] = slot.objectName;
+
+            scene->addObject(slot.objectName, std::move(slot.obj));
         }
+        emitter.progress("assemble", 0, 0);
 
         std::cout << "Loaded " << scene->objects().size() << " mesh primitives from GLTF" << std::endl;
 
@@ -1222,6 +1248,22 @@ namespace tracey
         return scene;
     }
 
+    std::unique_ptr<Scene> GltfLoader::loadFromFile(const std::string &path, const LoadOptions &options)
+    {
+        return loadGltf(path, options, nullptr);
+    }
+
+    std::unique_ptr<Scene> GltfLoader::loadFromFileStreaming(const std::string &path, const ImportStream &stream)
+    {
+        return loadGltf(path, LoadOptions{}, &stream);
+    }
+
+    std::unique_ptr<Scene> GltfLoader::loadFromFileStreaming(const std::string &path, const ImportStream &stream,
+                                                             const LoadOptions &options)
+    {
+        return loadGltf(path, options, &stream);
+    }
+
     // ── Hierarchy peek ─────────────────────────────────────────────────────
     namespace
     {
@@ -7,6 +7,8 @@
 
 namespace tracey
 {
+    struct ImportStream;
+
     class GltfLoader
     {
     public:
@@ -24,6 +26,15 @@ namespace tracey
 
         static std::unique_ptr<Scene> loadFromFile(const std::string &path, const LoadOptions &options);
 
+        // Streaming load: primitives are converted on the ThreadPool and each
+        // one is handed to `stream.onObject` (with a "meshes" progress step)
+        // as soon as it's converted, while the rest are still in flight. The
+        // returned Scene is the same one loadFromFile builds. See
+        // import_stream.hpp.
+        static std::unique_ptr<Scene> loadFromFileStreaming(const std::string &path, const ImportStream &stream);
+        static std::unique_ptr<Scene> loadFromFileStreaming(const std::string &path, const ImportStream &stream,
+                                                            const LoadOptions &options);
+
         // Process-wide memo of parsed scenes, keyed by path. Repeated callers
         // for the same path (the SOP graph spawns one gltf_import per primitive,
         // and the editor's apply_emitted re-resolves materials per actor) share
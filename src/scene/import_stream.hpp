@@ -0,0 +1,80 @@
+#pragma once
+
+// Streaming hooks for the scene importers (GltfLoader / UsdLoader
+// ::loadFromFileStreaming).
+//
+// A streaming load converts meshes on the ThreadPool and hands each finished
+// SceneObject to `onObject` as soon as it exists, before the rest of the file
+// has been read — the caller typically pushes it into a BlasPrebuilder so the
+// BVH builds overlap the parse. The Scene the load returns is still assembled
+// in file order and is identical to the one the plain loadFromFile produces;
+// the streamed objects are early copies (sharing channel storage) of the
+// objects that end up in it, under the same names.
+//
+// The loader serialises its callbacks — they never run concurrently with each
+// other — but they run on pool worker threads, so they must not block on work
+// that needs the pool. Either callback may be left empty.
+
+#include "scene_object.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace tracey
+{
+    struct ImportProgress
+    {
+        const char *stage = "";  // "meshes", "assemble"
+        size_t done = 0;
+        size_t total = 0;        // 0 when unknown
+    };
+
+    struct ImportStream
+    {
+        std::function<void(const std::string &name, const SceneObject &obj)> onObject;
+        std::function<void(const ImportProgress &progress)> onProgress;
+    };
+
+    // Loader-side helper: serialises emits from the conversion workers and
+    // counts them into `stage` progress. Null stream → every call is a no-op.
+    class ImportStreamEmitter
+    {
+    public:
+        ImportStreamEmitter(const ImportStream *stream, const char *stage, size_t total)
+            : m_stream(stream), m_stage(stage), m_total(total)
+        {
+        }
+
+        // Emit `obj` (skipped when empty) and, when `countsTowardTotal`, one
+        // step of progress.
+        void object(const std::string &name, const SceneObject &obj, bool countsTowardTotal = true)
+        {
+            if (!m_stream) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stream->onObject && obj.vertexCount() > 0) m_stream->onObject(name, obj);
+            if (countsTowardTotal) ++m_done;
+            if (countsTowardTotal && m_stream->onProgress)
+                m_stream->onProgress(ImportProgress{m_stage, m_done, m_total});
+        }
+
+        // One step of progress with nothing to emit (a prim that failed to
+        // convert still counts toward the total).
+        void skip() { object(std::string(), SceneObject()); }
+
+        void progress(const char *stage, size_t done, size_t total)
+        {
+            if (!m_stream || !m_stream->onProgress) return;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stream->onProgress(ImportProgress{stage, done, total});
+        }
+
+    private:
+        const ImportStream *m_stream;
+        const char *m_stage;
+        size_t m_total;
+        size_t m_done = 0;
+        std::mutex m_mutex;
+    };
+}
@@ -1,5 +1,9 @@
 #include "scene.hpp"
 
+#include "../core/parallel.hpp"
+
+#include <algorithm>
+
 namespace tracey
 {
     Actor *Scene::createActor()
@@ -12,17 +16,21 @@ namespace tracey
     }
     void Scene::removeActor(size_t uid)
     {
-        if (uid >= m_actors.size())
+        if (uid >= m_actors.size() || !m_actors[uid])
             return;
 
-        // Remove from parent's children list if applicable. Skip slots that
-        // were already reset by a prior removeActor — m_actors is sparse
-        // (we reset rather than erase so existing uids stay stable as
-        // indices), so iterating it always includes null entries.
-        for (auto &actorPtr : m_actors)
+        // Unlink both edges through the parent links rather than scanning
+        // every actor. Children of the removed actor become roots. Slots are
+        // reset rather than erased so existing uids stay stable as indices.
+        Actor *actor = m_actors[uid].get();
+        if (actor->hasParent())
         {
-            if (actorPtr) actorPtr->removeChild(uid);
+            if (Actor *parent = getActor(actor->parent()))
+                parent->removeChild(uid);
         }
+        const std::vector<size_t> children(actor->children().begin(), actor->children().end());
+        for (auto childUid : children)
+            actor->removeChild(childUid);
 
         m_actors[uid].reset();
     }
@@ -32,57 +40,122 @@ namespace tracey
         m_actors.clear();
         m_objects.clear();
         m_embeddedTextures.clear();
+        m_instanceGroups.clear();
         m_camera.reset();
         m_root = -1;
     }
     std::vector<SceneNode> Scene::flatten() const
     {
-        std::vector<SceneNode> out;
-        // Iterate over all actors directly
-        // This handles both hierarchical scenes (via children) and flat lists
+        // Roots in uid order, each followed by its subtree in pre-order
+        // (children in insertion order). An actor whose parent slot is gone
+        // counts as a root, matching Actor::worldTransform().
+        std::vector<const Actor *> roots;
         for (const auto &actorPtr : m_actors)
         {
-            if (actorPtr)
+            if (actorPtr && !(actorPtr->hasParent() && getActor(actorPtr->parent())))
+                roots.push_back(actorPtr.get());
+        }
+
+        std::vector<SceneNode> out;
+        if (m_actors.size() < kParallelFlattenThreshold)
+        {
+            out.reserve(m_actors.size());
+            for (const Actor *root : roots)
+                appendSubtree(out, *root);
+            return out;
+        }
+
+        // Large scenes: cut the forest into independent work items without
+        // changing the output order. An item is either a whole subtree or a
+        // single actor; splitting subtree(a) into [a, subtree(c0),
+        // subtree(c1), ...] keeps the concatenation identical to the serial
+        // pre-order. Split level by level until there are enough items for
+        // the pool (a USD stage usually hangs everything off one /World
+        // prim, so splitting only roots would leave one lane busy).
+        struct WorkItem
+        {
+            const Actor *actor;
+            bool wholeSubtree;
+        };
+        std::vector<WorkItem> items;
+        items.reserve(roots.size());
+        for (const Actor *root : roots)
+            items.push_back({root, true});
+
+        const size_t targetItems = 8 * std::max<size_t>(1, ThreadPool::global().workerCount());
+        for (int level = 0; level < 8 && items.size() < targetItems; ++level)
+        {
+            std::vector<WorkItem> next;
+            next.reserve(items.size() * 2);
+            bool split = false;
+            for (const WorkItem &item : items)
             {
-                // Check if this actor has a parent - skip if it does (it will be visited via parent)
-                bool hasParent = false;
-                for (const auto &otherPtr : m_actors)
+                if (!item.wholeSubtree || item.actor->children().empty())
                 {
-                    if (otherPtr && otherPtr.get() != actorPtr.get())
-                    {
-                        for (auto childUid : otherPtr->children())
-                        {
-                            if (childUid == actorPtr->getUid())
-                            {
-                                hasParent = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (hasParent)
-                        break;
+                    next.push_back(item);
+                    continue;
                 }
-
-                // Only add top-level actors (those without parents)
-                if (!hasParent)
+                // Resolve the split actor's world transform here, serially,
+                // so workers only ever read it.
+                item.actor->worldTransform();
+                next.push_back({item.actor, false});
+                for (auto childUid : item.actor->children())
                 {
-                    addChildren(out, Mat4(1.0), actorPtr->getUid());
+                    if (const Actor *child = getActor(childUid))
+                        next.push_back({child, true});
                 }
+                split = true;
             }
+            items = std::move(next);
+            if (!split)
+                break;
         }
+
+        // Contiguous runs of items per task, so a flat scene of many small
+        // roots doesn't pay one output vector per actor.
+        const size_t batchCount = std::min(items.size(), targetItems);
+        const size_t perBatch = (items.size() + batchCount - 1) / batchCount;
+        std::vector<std::vector<SceneNode>> parts(batchCount);
+        parallel_for_each_index(batchCount, [&](size_t b) {
+            const size_t end = std::min(items.size(), (b + 1) * perBatch);
+            for (size_t i = b * perBatch; i < end; ++i)
+            {
+                const WorkItem &item = items[i];
+                if (item.wholeSubtree)
+                    appendSubtree(parts[b], *item.actor);
+                else
+                    parts[b].push_back({item.actor->worldTransform(), item.actor});
+            }
+        });
+
+        size_t total = 0;
+        for (const auto &part : parts)
+            total += part.size();
+        out.reserve(total);
+        // SceneNode's const actor pointer rules out range insert (it needs
+        // assignment); copy-construct node by node.
+        for (const auto &part : parts)
+            for (const auto &node : part)
+                out.push_back(node);
         return out;
     }
-    void Scene::addChildren(std::vector<SceneNode> &out, const Mat4 &parentTransform, size_t uid) const
-    {
-        const Actor *actor = getActor(uid);
-        if (!actor)
-            return;
 
-        Mat4 worldTransform = parentTransform * actor->transform().toMatrix();
-        out.push_back({worldTransform, const_cast<Actor *>(actor)});
-        for (auto childUid : actor->children())
+    void Scene::appendSubtree(std::vector<SceneNode> &out, const Actor &root) const
+    {
+        // Explicit stack: deep hierarchies must not blow the call stack.
+        // Children are pushed in reverse so they pop in insertion order.
+        std::vector<const Actor *> stack{&root};
+        while (!stack.empty())
         {
-            addChildren(out, worldTransform, childUid);
+            const Actor *actor = stack.back();
+            stack.pop_back();
+            out.push_back({actor->worldTransform(), actor});
+            const auto children = actor->children();
+            for (auto it = children.rbegin(); it != children.rend(); ++it)
+            {
+                if (const Actor *child = getActor(*it))
+                    stack.push_back(child);
+            }
         }
     }
 
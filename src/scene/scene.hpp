@@ -51,7 +51,15 @@ namespace tracey
 
         void removeActor(size_t uid);
         void clear();
+
+        // Every live actor with its world transform: roots in uid order, each
+        // followed by its subtree in pre-order. O(actors) — roots come from
+        // the parent links and world transforms from each actor's cache, so
+        // only subtrees edited since the last call recompute their matrices.
+        // Scenes past kParallelFlattenThreshold actors walk independent
+        // subtrees on the thread pool; the output order is unchanged.
         std::vector<SceneNode> flatten() const;
+        static constexpr size_t kParallelFlattenThreshold = 4096;
 
         // Live actors only. The underlying m_actors is sparse — removeActor
         // resets a slot to null rather than erasing so existing uids stay
@@ -119,13 +127,39 @@ namespace tracey
             return m_embeddedTextures;
         }
 
+        // Instance groups (prototype sets for nested instancing). A group is a
+        // named list of SceneInstances — each placing a SceneObject or another
+        // group — and a SceneInstance whose objectRef names a group places the
+        // whole set. Object names win when a name is registered as both.
+        // SceneCompiler compiles each referenced group once, so a forest of N
+        // placed copies of an M-tree group costs N + M instances, not N × M.
+        void addInstanceGroup(const std::string &name, std::vector<SceneInstance> instances)
+        {
+            m_instanceGroups[name] = std::move(instances);
+        }
+        const std::vector<SceneInstance> *getInstanceGroup(const std::string &name) const
+        {
+            auto it = m_instanceGroups.find(name);
+            return it != m_instanceGroups.end() ? &it->second : nullptr;
+        }
+        bool hasInstanceGroup(const std::string &name) const
+        {
+            return m_instanceGroups.find(name) != m_instanceGroups.end();
+        }
+        void removeInstanceGroup(const std::string &name) { m_instanceGroups.erase(name); }
+        const std::unordered_map<std::string, std::vector<SceneInstance>> &instanceGroups() const
+        {
+            return m_instanceGroups;
+        }
+
     private:
-        void addChildren(std::vector<SceneNode> &out, const Mat4 &parentTransform, size_t uid) const;
+        void appendSubtree(std::vector<SceneNode> &out, const Actor &root) const;
 
     private:
         std::vector<std::unique_ptr<Actor>> m_actors;
         std::unordered_map<std::string, std::unique_ptr<SceneObject>> m_objects;
         std::unordered_map<std::string, EmbeddedTexture> m_embeddedTextures;
+        std::unordered_map<std::string, std::vector<SceneInstance>> m_instanceGroups;
         std::optional<Camera> m_camera;
         int64_t m_root = -1;
     };
@@ -5,17 +5,18 @@
 #include "../graph/graphs/shader_graph/nodes.hpp"
 #include "../graph/graphs/shader_graph/serialization.hpp"
 #include "../graph/graphs/shader_graph/shader_graph.hpp"
+#include "texture_cache.hpp"
+#include "../core/parallel.hpp"
 #include "../shading/material_program/opcodes.hpp"
 #include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <optional>
 #include <stdexcept>
 #include <unordered_map>
-
-// stb_image header (implementation is in gltf_loader.cpp)
-#include <stb_image.h>
+#include <unordered_set>
 
 namespace tracey
 {
@@ -80,7 +81,52 @@ namespace tracey
         }
     }  // anon
 
-    int32_t SceneCompiler::loadTexture(Device *device, CompiledScene &result, const Scene &scene, const std::string &texturePath, bool isColorData)
+    SceneCompiler::DecodedTextures SceneCompiler::decodeTextures(const Scene &scene,
+                                                                 const std::vector<std::string> &paths)
+    {
+        // One slot per unique path so lanes never share a map node. File paths
+        // go through the process-wide DecodedTextureCache (a hit is a mutex +
+        // stat); embedded images were already decoded by the glTF loader and
+        // only need their channels expanded to RGBA.
+        std::vector<std::shared_ptr<const DecodedTexture>> slots(paths.size());
+        parallel_for_each_index(paths.size(), [&](size_t i) {
+            const std::string &path = paths[i];
+            if (path.rfind("embedded:", 0) != 0)
+            {
+                slots[i] = DecodedTextureCache::global().load(path);
+                return;
+            }
+
+            const EmbeddedTexture *embedded = scene.getEmbeddedTexture(path);
+            if (!embedded || embedded->width <= 0 || embedded->height <= 0 ||
+                embedded->channels < 1 || embedded->channels > 4)
+                return;
+            const size_t pixelCount =
+                static_cast<size_t>(embedded->width) * static_cast<size_t>(embedded->height);
+            if (embedded->data.size() < pixelCount * static_cast<size_t>(embedded->channels))
+                return;
+
+            auto tex = std::make_shared<DecodedTexture>();
+            tex->width = static_cast<uint32_t>(embedded->width);
+            tex->height = static_cast<uint32_t>(embedded->height);
+            tex->rgba8.resize(pixelCount * 4);
+            expandToRgba8(embedded->data.data(), embedded->channels, pixelCount, tex->rgba8.data());
+            slots[i] = std::move(tex);
+        });
+
+        DecodedTextures out;
+        out.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            if (!slots[i])
+                std::cerr << "Warning: Failed to load texture: " << paths[i] << std::endl;
+            out.emplace(paths[i], std::move(slots[i]));
+        }
+        return out;
+    }
+
+    int32_t SceneCompiler::loadTexture(Device *device, CompiledScene &result, const DecodedTextures &decoded,
+                                       const std::string &texturePath, bool isColorData)
     {
         // Cache key folds in the format hint so the same source file can
         // produce both a sRGB albedo upload and a Unorm normal/MR upload
@@ -94,93 +140,14 @@ namespace tracey
             return static_cast<int32_t>(it->second);
         }
 
-        int width, height;
-        const unsigned char *data = nullptr;
-        size_t dataSize = 0;
-        bool needsStbiFree = false;
-        bool needsPlainFree = false;
-
-        // Handle embedded textures
-        if (texturePath.find("embedded:") == 0)
+        // Pixels were decoded up front by decodeTextures(); a missing or null
+        // entry is a texture that failed to load (already reported there).
+        auto found = decoded.find(texturePath);
+        if (found == decoded.end() || !found->second)
         {
-            const EmbeddedTexture *embedded = scene.getEmbeddedTexture(texturePath);
-            if (!embedded)
-            {
-                std::cerr << "Warning: Embedded texture not found: " << texturePath << std::endl;
-                return -1;
-            }
-
-            width = embedded->width;
-            height = embedded->height;
-
-            // If the embedded texture has 4 channels, use it directly
-            // Otherwise, convert to RGBA
-            if (embedded->channels == 4)
-            {
-                data = embedded->data.data();
-                dataSize = embedded->data.size();
-                // No free needed - data points to EmbeddedTexture's vector
-            }
-            else
-            {
-                // The data is already decoded by tinygltf, not compressed
-                // We need to expand it to RGBA manually
-                size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
-                unsigned char *rgba = static_cast<unsigned char *>(malloc(pixelCount * 4));
-
-                for (size_t i = 0; i < pixelCount; ++i)
-                {
-                    if (embedded->channels == 1)
-                    {
-                        // Grayscale
-                        rgba[i * 4 + 0] = embedded->data[i];
-                        rgba[i * 4 + 1] = embedded->data[i];
-                        rgba[i * 4 + 2] = embedded->data[i];
-                        rgba[i * 4 + 3] = 255;
-                    }
-                    else if (embedded->channels == 2)
-                    {
-                        // Grayscale + Alpha
-                        rgba[i * 4 + 0] = embedded->data[i * 2 + 0];
-                        rgba[i * 4 + 1] = embedded->data[i * 2 + 0];
-                        rgba[i * 4 + 2] = embedded->data[i * 2 + 0];
-                        rgba[i * 4 + 3] = embedded->data[i * 2 + 1];
-                    }
-                    else if (embedded->channels == 3)
-                    {
-                        // RGB
-                        rgba[i * 4 + 0] = embedded->data[i * 3 + 0];
-                        rgba[i * 4 + 1] = embedded->data[i * 3 + 1];
-                        rgba[i * 4 + 2] = embedded->data[i * 3 + 2];
-                        rgba[i * 4 + 3] = 255;
-                    }
-                }
-
-                data = rgba;
-                dataSize = pixelCount * 4;
-                needsPlainFree = true;
-            }
-
-            std::cout << "Loaded embedded texture: " << texturePath << " (" << width << "x" << height << ")" << std::endl;
-        }
-        else
-        {
-            // Load image from file
-            int channels;
-            unsigned char *fileData = stbi_load(texturePath.c_str(), &width, &height, &channels, 4); // Force RGBA
-
-            if (!fileData)
-            {
-                std::cerr << "Warning: Failed to load texture: " << texturePath << std::endl;
-                return -1;
-            }
-
-            data = fileData;
-            dataSize = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
-            needsStbiFree = true;
-
-            std::cout << "Loaded texture: " << texturePath << " (" << width << "x" << height << ")" << std::endl;
+            return -1;
         }
+        const DecodedTexture &pixels = *found->second;
 
         // Create GPU texture. Color-data textures (albedo, emissive) use
         // sRGB so the hardware decodes gamma on sample; data textures
@@ -189,38 +156,29 @@ namespace tracey
         const ImageFormat texFormat = isColorData ? ImageFormat::R8G8B8A8Srgb
                                                   : ImageFormat::R8G8B8A8Unorm;
         Image2D *texture = device->createImage2DWithData(
-            static_cast<uint32_t>(width),
-            static_cast<uint32_t>(height),
+            pixels.width,
+            pixels.height,
             texFormat,
-            data,
-            dataSize,
+            pixels.rgba8.data(),
+            pixels.rgba8.size(),
             SamplerFilter::Linear,
             SamplerAddressMode::Repeat);
 
-        // Retain the decoded pixels for path tracer backends that own their
-        // textures (Metal / CPU) — see CompiledScene::textureSources. Copied
-        // before the frees below; index-parallel with result.textures.
-        CompiledScene::TextureSource source;
-        source.width = static_cast<uint32_t>(width);
-        source.height = static_cast<uint32_t>(height);
-        source.srgb = isColorData;
-        source.rgba8.assign(data, data + dataSize);
-
-        if (needsStbiFree)
-        {
-            stbi_image_free(const_cast<unsigned char *>(data));
-        }
-        else if (needsPlainFree)
-        {
-            free(const_cast<unsigned char *>(data));
-        }
-
         if (!texture)
         {
             std::cerr << "Warning: Failed to create GPU texture for: " << texturePath << std::endl;
             return -1;
         }
 
+        // Retain the decoded pixels for path tracer backends that own their
+        // textures (Metal / CPU) — see CompiledScene::textureSources.
+        // Index-parallel with result.textures.
+        CompiledScene::TextureSource source;
+        source.width = pixels.width;
+        source.height = pixels.height;
+        source.srgb = isColorData;
+        source.pixels = found->second;
+
         // Store texture and return index
         int32_t index = static_cast<int32_t>(result.textures.size());
         result.textures.push_back(std::unique_ptr<Image2D>(texture));
@@ -230,55 +188,10 @@ namespace tracey
         return index;
     }
 
-    GPUMaterial SceneCompiler::convertMaterial(Device *device, CompiledScene &result, const Scene &scene, const MaterialInstance &material)
+    GPUMaterial SceneCompiler::materialFactors(const MaterialInstance &material)
     {
         GPUMaterial gpuMat;
 
-        // Pack per-texture sampler choices into samplerBits (2 bits per slot).
-        // The hit shader reads back via samplerBits >> (slot * 2) & 3.
-        auto packSampler = [&](SamplerKind k, uint32_t slot) {
-            gpuMat.samplerBits |= (static_cast<uint32_t>(k) & 0x3u) << (slot * 2u);
-        };
-
-        // Load textures. Albedo/emissive carry color data and must be loaded
-        // as sRGB; normal/MR/occlusion are raw data and need Unorm. Loading
-        // a normal map as sRGB silently gamma-decodes the byte triplets and
-        // produces wrong shading.
-        auto albedoPath = material.getTexture(TEXTURE_ALBEDO);
-        if (albedoPath)
-        {
-            gpuMat.albedoTexIndex = loadTexture(device, result, scene, *albedoPath, /*isColorData=*/true);
-            packSampler(material.getTextureSampler(TEXTURE_ALBEDO), 0u);
-        }
-
-        auto normalPath = material.getTexture(TEXTURE_NORMAL);
-        if (normalPath)
-        {
-            gpuMat.normalTexIndex = loadTexture(device, result, scene, *normalPath, /*isColorData=*/false);
-            packSampler(material.getTextureSampler(TEXTURE_NORMAL), 1u);
-        }
-
-        auto mrPath = material.getTexture(TEXTURE_METALLIC_ROUGHNESS);
-        if (mrPath)
-        {
-            gpuMat.metallicRoughnessTexIndex = loadTexture(device, result, scene, *mrPath, /*isColorData=*/false);
-            packSampler(material.getTextureSampler(TEXTURE_METALLIC_ROUGHNESS), 2u);
-        }
-
-        auto emissivePath = material.getTexture(TEXTURE_EMISSIVE);
-        if (emissivePath)
-        {
-            gpuMat.emissiveTexIndex = loadTexture(device, result, scene, *emissivePath, /*isColorData=*/true);
-            packSampler(material.getTextureSampler(TEXTURE_EMISSIVE), 3u);
-        }
-
-        auto occlusionPath = material.getTexture(TEXTURE_OCCLUSION);
-        if (occlusionPath)
-        {
-            gpuMat.occlusionTexIndex = loadTexture(device, result, scene, *occlusionPath, /*isColorData=*/false);
-            packSampler(material.getTextureSampler(TEXTURE_OCCLUSION), 4u);
-        }
-
         // Set base color factor
         auto albedo = material.albedo();
         if (albedo)
@@ -333,6 +246,59 @@ namespace tracey
 
         return gpuMat;
     }
+
+    GPUMaterial SceneCompiler::convertMaterial(Device *device, CompiledScene &result, const DecodedTextures &decoded,
+                                               const MaterialInstance &material)
+    {
+        GPUMaterial gpuMat = materialFactors(material);
+
+        // Pack per-texture sampler choices into samplerBits (2 bits per slot).
+        // The hit shader reads back via samplerBits >> (slot * 2) & 3.
+        auto packSampler = [&](SamplerKind k, uint32_t slot) {
+            gpuMat.samplerBits |= (static_cast<uint32_t>(k) & 0x3u) << (slot * 2u);
+        };
+
+        // Load textures. Albedo/emissive carry color data and must be loaded
+        // as sRGB; normal/MR/occlusion are raw data and need Unorm. Loading
+        // a normal map as sRGB silently gamma-decodes the byte triplets and
+        // produces wrong shading.
+        auto albedoPath = material.getTexture(TEXTURE_ALBEDO);
+        if (albedoPath)
+        {
+            gpuMat.albedoTexIndex = loadTexture(device, result, decoded, *albedoPath, /*isColorData=*/true);
+            packSampler(material.getTextureSampler(TEXTURE_ALBEDO), 0u);
+        }
+
+        auto normalPath = material.getTexture(TEXTURE_NORMAL);
+        if (normalPath)
+        {
+            gpuMat.normalTexIndex = loadTexture(device, result, decoded, *normalPath, /*isColorData=*/false);
+            packSampler(material.getTextureSampler(TEXTURE_NORMAL), 1u);
+        }
+
+        auto mrPath = material.getTexture(TEXTURE_METALLIC_ROUGHNESS);
+        if (mrPath)
+        {
+            gpuMat.metallicRoughnessTexIndex = loadTexture(device, result, decoded, *mrPath, /*isColorData=*/false);
+            packSampler(material.getTextureSampler(TEXTURE_METALLIC_ROUGHNESS), 2u);
+        }
+
+        auto emissivePath = material.getTexture(TEXTURE_EMISSIVE);
+        if (emissivePath)
+        {
+            gpuMat.emissiveTexIndex = loadTexture(device, result, decoded, *emissivePath, /*isColorData=*/true);
+            packSampler(material.getTextureSampler(TEXTURE_EMISSIVE), 3u);
+        }
+
+        auto occlusionPath = material.getTexture(TEXTURE_OCCLUSION);
+        if (occlusionPath)
+        {
+            gpuMat.occlusionTexIndex = loadTexture(device, result, decoded, *occlusionPath, /*isColorData=*/false);
+            packSampler(material.getTextureSampler(TEXTURE_OCCLUSION), 4u);
+        }
+
+        return gpuMat;
+    }
     SceneCompiler::ObjectData SceneCompiler::compileObject(Device *device, const SceneObject &obj,
                                                             const BVHConfig &bvhConfig,
                                                             bool buildAccelerationStructures)
@@ -381,10 +347,10 @@ namespace tracey
         }
         data.colorBuffer->flush();
 
-        // Store UVs if available
+        // Store UVs if available — shared with the SceneObject, not copied.
         if (obj.hasUvs())
         {
-            data.uvs = obj.uvs();
+            data.uvs = obj.sharedUvs();
         }
         else
         {
@@ -399,7 +365,7 @@ namespace tracey
         data.hasNormals = obj.hasNormals();
         if (data.hasNormals)
         {
-            data.normals = obj.normals();
+            data.normals = obj.sharedNormals();
             // Pad in case the source vector is shorter than the vertex count
             // (defensive — shouldn't happen with the existing converters).
             if (data.normals.size() < data.vertexCount)
@@ -432,11 +398,35 @@ namespace tracey
         return data;
     }
 
+    BlasCache::Entry SceneCompiler::makeCacheEntry(ObjectData &&data, const SceneObject &obj, uint64_t hash)
+    {
+        BlasCache::Entry entry;
+        entry.blas = std::move(data.blas);
+        entry.vertexBuffer = std::move(data.vertexBuffer);
+        entry.colorBuffer = std::move(data.colorBuffer);
+        entry.vertexCount = data.vertexCount;
+        entry.uvs = std::move(data.uvs);
+        entry.hasUvs = obj.hasUvs();
+        entry.normals = std::move(data.normals);
+        entry.hasNormals = data.hasNormals;
+        entry.contentHash = hash;
+        return entry;
+    }
+
+    bool SceneCompiler::prepareObject(Device *device, const std::string &name, const SceneObject &obj,
+                                      const BVHConfig &bvhConfig, BlasCache &cache)
+    {
+        const uint64_t hash = obj.contentHash();
+        if (cache.lookup(name, hash)) return true;
+        ObjectData data = compileObject(device, obj, bvhConfig);
+        if (data.vertexCount == 0) return false;
+        cache.insert(name, makeCacheEntry(std::move(data), obj, hash));
+        return true;
+    }
+
     Mat4 SceneCompiler::computeWorldTransform(const Scene & /*scene*/, const Actor &actor)
     {
-        // For now, just return the actor's local transform
-        // TODO: Implement full hierarchy traversal if needed
-        return actor.transform().toMatrix();
+        return actor.worldTransform();
     }
 
     SceneCompiler::CompiledScene SceneCompiler::compile(Device *device, const Scene &scene)
@@ -466,6 +456,16 @@ namespace tracey
         return ++counter;
     }
 
+    void SceneCompiler::CompiledScene::markChanged(uint32_t what)
+    {
+        revision = nextSceneRevision();
+        if (what & ChangeInstances) changes.instances = revision;
+        if (what & ChangeGeometry) changes.geometry = revision;
+        if (what & ChangeMaterials) changes.materials = revision;
+        if (what & ChangeLights) changes.lights = revision;
+        if (what & ChangeTextures) changes.textures = revision;
+    }
+
     // Build the analytic-light list + its GPU buffer from the scene. Identical to
     // the gather that used to be inline in compile() — kept in one place so a full
     // compile and an in-place light refresh produce byte-identical light data.
@@ -598,10 +598,11 @@ namespace tracey
 
     SceneCompiler::CompiledScene SceneCompiler::compile(Device *device, const Scene &scene,
                                                         const BVHConfig &bvhConfig, BlasCache *cache,
-                                                        bool buildAccelerationStructures)
+                                                        bool buildAccelerationStructures,
+                                                        bool nestInstanceGroups)
     {
         CompiledScene result;
-        result.revision = nextSceneRevision();
+        result.markChanged(CompiledScene::ChangeAll);
 
         // Per-compile config + stats logs fired once per compile_scene()
         // call; with particle sims cooking 60×/sec the stderr flood
@@ -614,7 +615,8 @@ namespace tracey
         {
             std::cout << "BVH Configuration: leafThreshold=" << bvhConfig.leafThreshold
                       << ", traversalCost=" << bvhConfig.traversalCost
-                      << ", intersectionCost=" << bvhConfig.intersectionCost << std::endl;
+                      << ", intersectionCost=" << bvhConfig.intersectionCost
+                      << ", compactTriangles=" << bvhConfig.compactTriangles << std::endl;
         }
 
         // Step 1: Compile all unique objects to BLAS — or pull them from the
@@ -696,21 +698,20 @@ namespace tracey
                         }
                         entry->colorBuffer->flush();
                     }
-                    // uvs / normals live as CPU vectors on the entry
+                    // uvs / normals live as CPU arrays on the entry
                     // and get concatenated into the global uv /
-                    // normal buffers below — replace them with fresh
-                    // copies from the SceneObject so VOP-written
-                    // values flow through.
+                    // normal buffers below — re-share them from the
+                    // SceneObject so VOP-written values flow through.
                     if (objPtr->hasUvs())
                     {
-                        entry->uvs = objPtr->uvs();
+                        entry->uvs = objPtr->sharedUvs();
                         if (entry->uvs.size() < vCount)
                             entry->uvs.resize(vCount, Vec2(0.0f));
                     }
                     entry->hasUvs = objPtr->hasUvs();
                     if (objPtr->hasNormals())
                     {
-                        entry->normals = objPtr->normals();
+                        entry->normals = objPtr->sharedNormals();
                         if (entry->normals.size() < vCount)
                             entry->normals.resize(vCount, Vec3(0.0f));
                     }
@@ -719,7 +720,7 @@ namespace tracey
                         // Object lost its normals between cooks; zero
                         // out so the hit shader's "all-zero ⇒ face
                         // normal" fallback still kicks in cleanly.
-                        std::fill(entry->normals.begin(), entry->normals.end(), Vec3(0.0f));
+                        entry->normals = std::vector<Vec3>(entry->normals.size(), Vec3(0.0f));
                     }
                     entry->hasNormals = objPtr->hasNormals();
                 }
@@ -735,16 +736,7 @@ namespace tracey
                 // are valid. Use vertexCount as the validity check.
                 if (objData.vertexCount == 0) continue;
 
-                BlasCache::Entry fresh;
-                fresh.blas = std::move(objData.blas);
-                fresh.vertexBuffer = std::move(objData.vertexBuffer);
-                fresh.colorBuffer = std::move(objData.colorBuffer);
-                fresh.vertexCount = objData.vertexCount;
-                fresh.uvs = std::move(objData.uvs);
-                fresh.hasUvs = objPtr->hasUvs();
-                fresh.normals = std::move(objData.normals);
-                fresh.hasNormals = objData.hasNormals;
-                fresh.contentHash = hash;
+                BlasCache::Entry fresh = makeCacheEntry(std::move(objData), *objPtr, hash);
                 if (cache && buildAccelerationStructures)
                 {
                     entry = cache->insert(name, std::move(fresh));
@@ -907,6 +899,182 @@ namespace tracey
             return true;
         };
 
+        // Nested instancing: resolve every instance group a visible actor places
+        // (directly or through other groups) into groupPlans, children first,
+        // so each group is compiled once however many times it's placed. An
+        // objectRef naming a SceneObject always wins over a group of the same
+        // name. References that would close a cycle or name an empty group
+        // are dropped. A reference that would nest deeper than
+        // Tlas::kMaxInstanceLevels is reported and flattened: the child's
+        // members are inlined into the referencing group, which costs one
+        // level.
+        struct GroupMember
+        {
+            const SceneInstance *instance = nullptr;
+            int32_t childGroup = -1; // >= 0: places that group instead of a BLAS
+            size_t blasIndex = 0;
+            Mat4 transform{1.0f}; // in the group's local space
+        };
+        struct GroupPlan
+        {
+            std::vector<GroupMember> members;
+            int levels = 1; // Tlas::levels() of the group once built
+        };
+        std::vector<GroupPlan> groupPlans;
+        std::unordered_map<std::string, int32_t> groupIndexByName; // -1: in progress / dropped
+        std::function<int32_t(const std::string &)> resolveGroup =
+            [&](const std::string &name) -> int32_t {
+            if (auto it = groupIndexByName.find(name); it != groupIndexByName.end())
+                return it->second;
+            const std::vector<SceneInstance> *members = scene.getInstanceGroup(name);
+            if (!members)
+                return -1;
+            groupIndexByName[name] = -1; // a reference back to `name` now reads as a cycle
+
+            GroupPlan plan;
+            for (const auto &member : *members)
+            {
+                const std::string &ref = member.objectRef();
+                const Mat4 local = member.hasLocalTransform() ? member.localTransform()->toMatrix() : Mat4(1.0f);
+                if (auto blas = result.objectToBlasIndex.find(ref); blas != result.objectToBlasIndex.end())
+                {
+                    plan.members.push_back({&member, -1, blas->second, local});
+                    continue;
+                }
+                const int32_t child = resolveGroup(ref);
+                if (child < 0)
+                    continue;
+                // The top-level Tlas adds one more level above this group.
+                if (groupPlans[child].levels + 1 <= Tlas::kMaxInstanceLevels - 1)
+                {
+                    plan.levels = std::max(plan.levels, groupPlans[child].levels + 1);
+                    plan.members.push_back({&member, child, 0, local});
+                    continue;
+                }
+                // Too deep: inline the child's members. Each of them already
+                // fits below the child, so one step always fits here.
+                std::cerr << "SceneCompiler: instance group '" << name << "' nests '" << ref
+                          << "' deeper than " << Tlas::kMaxInstanceLevels
+                          << " instance levels -- flattening that member" << std::endl;
+                for (const GroupMember &inner : groupPlans[child].members)
+                {
+                    GroupMember inlined = inner;
+                    inlined.transform = local * inner.transform;
+                    if (inlined.childGroup >= 0)
+                        plan.levels = std::max(plan.levels, groupPlans[inlined.childGroup].levels + 1);
+                    plan.members.push_back(inlined);
+                }
+            }
+            if (plan.members.empty())
+                return -1;
+            const int32_t index = static_cast<int32_t>(groupPlans.size());
+            groupPlans.push_back(std::move(plan));
+            groupIndexByName[name] = index;
+            return index;
+        };
+        for (const auto &node : sceneNodes)
+        {
+            if (!effectivelyVisible(node.actor)) continue;
+            for (const auto &sceneInstance : node.actor->instances())
+            {
+                const std::string &ref = sceneInstance.objectRef();
+                if (!result.objectToBlasIndex.count(ref) && scene.hasInstanceGroup(ref))
+                    resolveGroup(ref);
+            }
+        }
+
+        // Decode every texture the instance loop below will reference in one
+        // parallel pass (deduplicated by path — the sRGB and Unorm uploads of
+        // the same file share one decode), instead of stbi_load-ing them one
+        // at a time from inside the loop. Same visibility/BLAS filters as the
+        // loop, so nothing is decoded that wouldn't be uploaded.
+        DecodedTextures decodedTextures;
+        {
+            std::vector<std::string> texturePaths;
+            std::unordered_set<std::string> seenPaths;
+            const char *const slots[] = {TEXTURE_ALBEDO, TEXTURE_NORMAL, TEXTURE_METALLIC_ROUGHNESS,
+                                         TEXTURE_EMISSIVE, TEXTURE_OCCLUSION};
+            for (const auto &node : sceneNodes)
+            {
+                if (!effectivelyVisible(node.actor)) continue;
+                for (const auto &sceneInstance : node.actor->instances())
+                {
+                    if (!result.objectToBlasIndex.count(sceneInstance.objectRef())) continue;
+                    for (const char *slot : slots)
+                    {
+                        auto path = sceneInstance.material().getTexture(slot);
+                        if (path && seenPaths.insert(*path).second)
+                            texturePaths.push_back(std::move(*path));
+                    }
+                }
+            }
+            for (const auto &plan : groupPlans)
+            {
+                for (const auto &member : plan.members)
+                {
+                    if (member.childGroup >= 0) continue;
+                    for (const char *slot : slots)
+                    {
+                        auto path = member.instance->material().getTexture(slot);
+                        if (path && seenPaths.insert(*path).second)
+                            texturePaths.push_back(std::move(*path));
+                    }
+                }
+            }
+            decodedTextures = decodeTextures(scene, texturePaths);
+            if (verboseCompile && !texturePaths.empty())
+            {
+                const auto stats = DecodedTextureCache::global().stats();
+                std::cout << "Decoded " << texturePaths.size() << " texture(s); decode cache "
+                          << stats.hits << " hit(s) / " << stats.misses << " miss(es) total" << std::endl;
+            }
+        }
+
+        // Collect emissive triangles (world-space) for path-tracer NEE. Only
+        // called when an instance's material actually emits; capped so a
+        // high-poly emissive mesh can't explode the list.
+        constexpr size_t kMaxEmitterTris = 4096;
+        const auto appendEmitters = [&](const std::string &objectRef, const GPUMaterial &gpuMat,
+                                        const Mat4 &finalTransform) {
+            const Vec3 emission(gpuMat.emissiveR, gpuMat.emissiveG, gpuMat.emissiveB);
+            const float emiss = (emission.x + emission.y + emission.z) * gpuMat.emissiveStrength;
+            if (!(emiss > 1e-4f) || result.emitters.size() >= kMaxEmitterTris)
+                return;
+            const SceneObject *obj = scene.getObject(objectRef);
+            if (!obj)
+                return;
+            const auto &P = obj->positions();
+            const auto &idx = obj->indices();
+            const Vec3 emRGB = emission * gpuMat.emissiveStrength;
+            const size_t triCount = idx.empty() ? P.size() / 3 : idx.size() / 3;
+            for (size_t t = 0; t < triCount &&
+                                result.emitters.size() < kMaxEmitterTris; ++t)
+            {
+                const uint32_t i0 = idx.empty() ? uint32_t(t * 3 + 0) : idx[t * 3 + 0];
+                const uint32_t i1 = idx.empty() ? uint32_t(t * 3 + 1) : idx[t * 3 + 1];
+                const uint32_t i2 = idx.empty() ? uint32_t(t * 3 + 2) : idx[t * 3 + 2];
+                if (i0 >= P.size() || i1 >= P.size() || i2 >= P.size()) continue;
+                CompiledScene::EmissiveTri e;
+                e.p0 = transformPoint(finalTransform, P[i0]);
+                e.p1 = transformPoint(finalTransform, P[i1]);
+                e.p2 = transformPoint(finalTransform, P[i2]);
+                e.area = 0.5f * glm::length(glm::cross(e.p1 - e.p0, e.p2 - e.p0));
+                if (e.area <= 1e-9f) continue; // skip degenerate
+                e.emission = emRGB;
+                result.emitters.push_back(e);
+            }
+        };
+
+        // Top-level placements of instance groups: (group, world transform,
+        // placing actor). Group records and emitters are emitted after the loop.
+        struct GroupPlacement
+        {
+            int32_t group;
+            Mat4 transform;
+            uint64_t actorUid;
+        };
+        std::vector<GroupPlacement> groupPlacements;
+
         for (const auto &node : sceneNodes)
         {
             const Actor *actor = node.actor;
@@ -937,16 +1105,20 @@ namespace tracey
             {
                 const std::string &objectRef = sceneInstance.objectRef();
 
-                // Find the BLAS for this object
+                // Find the BLAS for this object, or the instance group it names
                 auto it = result.objectToBlasIndex.find(objectRef);
+                int32_t groupIndex = -1;
                 if (it == result.objectToBlasIndex.end())
                 {
-                    // Object not found, skip
-                    continue;
+                    if (auto g = groupIndexByName.find(objectRef); g != groupIndexByName.end())
+                        groupIndex = g->second;
+                    if (groupIndex < 0)
+                    {
+                        // Object not found, skip
+                        continue;
+                    }
                 }
 
-                size_t blasIndex = it->second;
-
                 // Compute final transform (world * local instance transform)
                 Mat4 finalTransform = worldTransform;
                 if (sceneInstance.hasLocalTransform())
@@ -954,6 +1126,31 @@ namespace tracey
                     finalTransform = worldTransform * sceneInstance.localTransform()->toMatrix();
                 }
 
+                if (groupIndex >= 0)
+                {
+                    // Group placement: one TLAS entry referencing the group,
+                    // with a placeholder record (the group's members carry
+                    // their own materials).
+                    Tlas::Instance instance;
+                    instance.setTransform(finalTransform);
+                    instance.setGroupReference(static_cast<uint32_t>(groupIndex));
+                    instance.setCustomIndex(materialIndex);
+                    instance.setMask(0xFF);
+
+                    result.instances.push_back(instance);
+                    result.instanceToMaterialIndex.push_back(materialIndex);
+                    result.instanceProgramIndex.push_back(0);
+                    result.instanceUvOffset.push_back(0);
+                    result.instanceToActorUid.push_back(static_cast<uint64_t>(actor->getUid()));
+                    result.materials.push_back(GPUMaterial{});
+                    groupPlacements.push_back({groupIndex, finalTransform,
+                                               static_cast<uint64_t>(actor->getUid())});
+                    materialIndex++;
+                    continue;
+                }
+
+                size_t blasIndex = it->second;
+
                 // Create TLAS instance
                 Tlas::Instance instance;
                 instance.setTransform(finalTransform);
@@ -968,7 +1165,7 @@ namespace tracey
                 result.instanceToActorUid.push_back(static_cast<uint64_t>(actor->getUid()));
 
                 // Convert material and load textures
-                GPUMaterial gpuMat = convertMaterial(device, result, scene, sceneInstance.material());
+                GPUMaterial gpuMat = convertMaterial(device, result, decodedTextures, sceneInstance.material());
                 // Viewport preview color: when an actor's material graph
                 // statically resolves to a constant baseColor, that
                 // wins over whatever the SceneObject material carried.
@@ -988,42 +1185,107 @@ namespace tracey
                     gpuMat.baseColorB = actorPreviewAlbedo->z;
                 }
                 result.materials.push_back(gpuMat);
+                appendEmitters(objectRef, gpuMat, finalTransform);
+
+                materialIndex++;
+            }
+        }
+
+        // Instance-group records, after every top-level record. Groups are
+        // placed in the group's local space; members use their own
+        // SceneInstance material and the passthrough program (a group is
+        // shared across actors, so no single actor's graph applies), and
+        // resolve picks to the first actor that placed the group.
+        if (!groupPlans.empty())
+        {
+            std::vector<uint64_t> groupActorUid(groupPlans.size(), 0);
+            std::vector<bool> groupPlaced(groupPlans.size(), false);
+            for (const auto &placement : groupPlacements)
+            {
+                if (groupPlaced[placement.group]) continue;
+                groupPlaced[placement.group] = true;
+                groupActorUid[placement.group] = placement.actorUid;
+            }
+            // Parents come after their children, so a reverse walk hands each
+            // parent's actor down before the child is visited.
+            for (size_t g = groupPlans.size(); g-- > 0;)
+            {
+                if (!groupPlaced[g]) continue;
+                for (const auto &member : groupPlans[g].members)
+                {
+                    if (member.childGroup < 0 || groupPlaced[member.childGroup]) continue;
+                    groupPlaced[member.childGroup] = true;
+                    groupActorUid[member.childGroup] = groupActorUid[g];
+                }
+            }
 
-                // Collect emissive triangles (world-space) for path-tracer NEE.
-                // Only when this instance's material actually emits; the common
-                // non-emissive case costs one cheap add + compare here.
-                const Vec3 emission(gpuMat.emissiveR, gpuMat.emissiveG, gpuMat.emissiveB);
-                const float emiss = (emission.x + emission.y + emission.z) * gpuMat.emissiveStrength;
-                constexpr size_t kMaxEmitterTris = 4096;
-                if (emiss > 1e-4f && result.emitters.size() < kMaxEmitterTris)
+            result.instanceGroups.resize(groupPlans.size());
+            for (size_t g = 0; g < groupPlans.size(); ++g)
+            {
+                auto &group = result.instanceGroups[g];
+                group.recordBase = materialIndex;
+                group.instances.reserve(groupPlans[g].members.size());
+                for (const auto &member : groupPlans[g].members)
                 {
-                    if (const SceneObject *obj = scene.getObject(objectRef))
+                    Tlas::Instance instance;
+                    instance.setTransform(member.transform);
+                    instance.setCustomIndex(materialIndex);
+                    instance.setMask(0xFF);
+
+                    GPUMaterial gpuMat{};
+                    uint32_t uvOffset = 0;
+                    if (member.childGroup >= 0)
                     {
-                        const auto &P = obj->positions();
-                        const auto &idx = obj->indices();
-                        const Vec3 emRGB = emission * gpuMat.emissiveStrength;
-                        const size_t triCount = idx.empty() ? P.size() / 3 : idx.size() / 3;
-                        for (size_t t = 0; t < triCount &&
-                                            result.emitters.size() < kMaxEmitterTris; ++t)
-                        {
-                            const uint32_t i0 = idx.empty() ? uint32_t(t * 3 + 0) : idx[t * 3 + 0];
-                            const uint32_t i1 = idx.empty() ? uint32_t(t * 3 + 1) : idx[t * 3 + 1];
-                            const uint32_t i2 = idx.empty() ? uint32_t(t * 3 + 2) : idx[t * 3 + 2];
-                            if (i0 >= P.size() || i1 >= P.size() || i2 >= P.size()) continue;
-                            CompiledScene::EmissiveTri e;
-                            e.p0 = transformPoint(finalTransform, P[i0]);
-                            e.p1 = transformPoint(finalTransform, P[i1]);
-                            e.p2 = transformPoint(finalTransform, P[i2]);
-                            e.area = 0.5f * glm::length(glm::cross(e.p1 - e.p0, e.p2 - e.p0));
-                            if (e.area <= 1e-9f) continue; // skip degenerate
-                            e.emission = emRGB;
-                            result.emitters.push_back(e);
-                        }
+                        instance.setGroupReference(static_cast<uint32_t>(member.childGroup));
+                    }
+                    else
+                    {
+                        instance.blasAddress = member.blasIndex;
+                        gpuMat = convertMaterial(device, result, decodedTextures, member.instance->material());
+                        uvOffset = blasUvStart[member.blasIndex];
                     }
+
+                    group.instances.push_back(instance);
+                    result.instanceToMaterialIndex.push_back(materialIndex);
+                    result.instanceProgramIndex.push_back(0);
+                    result.instanceUvOffset.push_back(uvOffset);
+                    result.instanceToActorUid.push_back(groupActorUid[g]);
+                    result.materials.push_back(gpuMat);
+                    materialIndex++;
                 }
+            }
 
-                materialIndex++;
+            // Emitters are world-space, so they are the one thing that is
+            // still expanded per placement (bounded by kMaxEmitterTris).
+            std::function<void(int32_t, const Mat4 &)> appendGroupEmitters =
+                [&](int32_t g, const Mat4 &groupToWorld) {
+                const auto &group = result.instanceGroups[g];
+                const auto &members = groupPlans[g].members;
+                for (size_t m = 0; m < members.size() && result.emitters.size() < kMaxEmitterTris; ++m)
+                {
+                    const Mat4 memberToWorld = groupToWorld * group.instances[m].getTransform();
+                    if (members[m].childGroup >= 0)
+                        appendGroupEmitters(members[m].childGroup, memberToWorld);
+                    else
+                        appendEmitters(members[m].instance->objectRef(),
+                                       result.materials[group.recordBase + m], memberToWorld);
+                }
+            };
+            for (const auto &placement : groupPlacements)
+                appendGroupEmitters(placement.group, placement.transform);
+
+            if (verboseCompile)
+            {
+                size_t members = 0;
+                for (const auto &group : result.instanceGroups) members += group.instances.size();
+                std::cout << "Instance groups: " << result.instanceGroups.size() << " group(s), "
+                          << members << " member(s), " << groupPlacements.size()
+                          << " top-level placement(s)" << (nestInstanceGroups ? "" : " -- flattening")
+                          << std::endl;
             }
+
+            if (!nestInstanceGroups)
+                flattenInstanceGroups(result);
         }
 
         // Analytic lights + the always-present light buffer. Factored into
@@ -1052,7 +1314,11 @@ namespace tracey
         // over invalid handles otherwise. The path tracer is the only
         // consumer of result.tlas; the rasterizer drives instancing from
         // result.instances directly.
-        if (buildAccelerationStructures)
+        //
+        // Nested groups only exist for the CPU path tracer backend, which
+        // builds its own multi-level Tlas from instances + instanceGroups;
+        // device TLASes take flat instance lists, so none is built then.
+        if (buildAccelerationStructures && result.instanceGroups.empty())
         {
             result.tlas = std::unique_ptr<TopLevelAccelerationStructure>(
                 device->createTopLevelAccelerationStructure(
@@ -1130,4 +1396,180 @@ namespace tracey
 
         return result;
     }
+
+    void SceneCompiler::expandInstanceGroups(const CompiledScene &scene, std::vector<Tlas::Instance> &leaves,
+                                             std::vector<uint32_t> &records)
+    {
+        leaves.clear();
+        records.clear();
+        leaves.reserve(scene.instances.size());
+        records.reserve(scene.instances.size());
+
+        std::function<void(uint32_t, const Mat4 &)> expand = [&](uint32_t g, const Mat4 &xf) {
+            const auto &group = scene.instanceGroups[g];
+            for (size_t m = 0; m < group.instances.size(); ++m)
+            {
+                Tlas::Instance leaf = group.instances[m];
+                const Mat4 toWorld = xf * leaf.getTransform();
+                if (leaf.referencesGroup())
+                {
+                    expand(leaf.groupIndex(), toWorld);
+                    continue;
+                }
+                leaf.setTransform(toWorld);
+                leaves.push_back(leaf);
+                records.push_back(group.recordBase + static_cast<uint32_t>(m));
+            }
+        };
+
+        for (size_t i = 0; i < scene.instances.size(); ++i)
+        {
+            const Tlas::Instance &instance = scene.instances[i];
+            if (instance.referencesGroup())
+            {
+                expand(instance.groupIndex(), instance.getTransform());
+                continue;
+            }
+            leaves.push_back(instance);
+            records.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    void SceneCompiler::flattenInstanceGroups(CompiledScene &scene)
+    {
+        if (scene.instanceGroups.empty())
+            return;
+
+        const bool withEnd = scene.instancesEnd.size() == scene.instances.size();
+        std::vector<Tlas::Instance> instances;
+        std::vector<Tlas::Instance> instancesEnd;
+        std::vector<uint32_t> toMaterialIndex;
+        std::vector<uint32_t> programIndex;
+        std::vector<uint32_t> uvOffset;
+        std::vector<uint64_t> toActorUid;
+        std::vector<GPUMaterial> materials;
+
+        // Copy record `src` out for a new top-level leaf placed at `xf`
+        // (shutter-open) / `xfEnd` (shutter-close).
+        const auto emit = [&](const Tlas::Instance &leaf, uint32_t src, const Mat4 &xf, const Mat4 &xfEnd) {
+            const uint32_t record = static_cast<uint32_t>(instances.size());
+            Tlas::Instance instance = leaf;
+            instance.setTransform(xf);
+            instance.setCustomIndex(record);
+            instances.push_back(instance);
+            if (withEnd)
+            {
+                instance.setTransform(xfEnd);
+                instancesEnd.push_back(instance);
+            }
+            toMaterialIndex.push_back(record);
+            programIndex.push_back(src < scene.instanceProgramIndex.size() ? scene.instanceProgramIndex[src] : 0u);
+            uvOffset.push_back(src < scene.instanceUvOffset.size() ? scene.instanceUvOffset[src] : 0u);
+            toActorUid.push_back(src < scene.instanceToActorUid.size() ? scene.instanceToActorUid[src] : 0u);
+            materials.push_back(src < scene.materials.size() ? scene.materials[src] : GPUMaterial{});
+        };
+
+        std::function<void(uint32_t, const Mat4 &, const Mat4 &)> expand =
+            [&](uint32_t g, const Mat4 &xf, const Mat4 &xfEnd) {
+            const auto &group = scene.instanceGroups[g];
+            for (size_t m = 0; m < group.instances.size(); ++m)
+            {
+                const Tlas::Instance &member = group.instances[m];
+                const Mat4 local = member.getTransform();
+                if (member.referencesGroup())
+                    expand(member.groupIndex(), xf * local, xfEnd * local);
+                else
+                    emit(member, group.recordBase + static_cast<uint32_t>(m), xf * local, xfEnd * local);
+            }
+        };
+
+        for (size_t i = 0; i < scene.instances.size(); ++i)
+        {
+            const Tlas::Instance &instance = scene.instances[i];
+            const Mat4 xf = instance.getTransform();
+            const Mat4 xfEnd = withEnd ? scene.instancesEnd[i].getTransform() : xf;
+            if (instance.referencesGroup())
+                expand(instance.groupIndex(), xf, xfEnd);
+            else
+                emit(instance, static_cast<uint32_t>(i), xf, xfEnd);
+        }
+
+        scene.instances = std::move(instances);
+        if (withEnd)
+            scene.instancesEnd = std::move(instancesEnd);
+        scene.instanceToMaterialIndex = std::move(toMaterialIndex);
+        scene.instanceProgramIndex = std::move(programIndex);
+        scene.instanceUvOffset = std::move(uvOffset);
+        scene.instanceToActorUid = std::move(toActorUid);
+        scene.materials = std::move(materials);
+        scene.instanceGroups.clear();
+        scene.markChanged(CompiledScene::ChangeInstances | CompiledScene::ChangeMaterials);
+    }
+
+    SceneCompiler::MotionSample SceneCompiler::captureMotionSample(const CompiledScene &scene)
+    {
+        MotionSample sample;
+        sample.instances = scene.instances;
+        for (const auto &[name, blasIndex] : scene.objectToBlasIndex)
+        {
+            if (blasIndex >= scene.vertexBuffers.size() || !scene.vertexBuffers[blasIndex])
+                continue;
+            const Buffer *buffer = scene.vertexBuffers[blasIndex];
+            const size_t count = blasIndex < scene.vertexCounts.size() ? scene.vertexCounts[blasIndex] : 0;
+            const auto *src = static_cast<const Vec3 *>(buffer->mapForReading());
+            sample.positions.emplace(name, std::vector<Vec3>(src, src + count));
+            buffer->unmap();
+        }
+        return sample;
+    }
+
+    bool SceneCompiler::applyMotionSamples(CompiledScene &scene, std::span<const MotionSample> samples)
+    {
+        if (samples.size() < 2)
+            return false;
+        for (const auto &sample : samples)
+            if (sample.instances.size() != scene.instances.size())
+                return false;
+
+        scene.instanceKeys.clear();
+        scene.instanceKeys.reserve(samples.size());
+        for (const auto &sample : samples)
+            scene.instanceKeys.push_back(sample.instances);
+        scene.instancesEnd = samples.back().instances;
+
+        // Deformation keys for every object whose positions move with a
+        // fixed vertex count. Rigid objects (unchanged positions) keep an
+        // empty entry so they stay on the cheaper static BLAS.
+        scene.blasMotion.assign(scene.blases.size(), {});
+        for (const auto &[name, blasIndex] : scene.objectToBlasIndex)
+        {
+            if (blasIndex >= scene.blasMotion.size())
+                continue;
+            const auto first = samples.front().positions.find(name);
+            if (first == samples.front().positions.end())
+                continue;
+            bool usable = true;
+            bool moves = false;
+            for (const auto &sample : samples)
+            {
+                const auto it = sample.positions.find(name);
+                if (it == sample.positions.end() || it->second.size() != first->second.size())
+                {
+                    usable = false;
+                    break;
+                }
+                moves = moves || it->second != first->second;
+            }
+            if (!usable || !moves)
+                continue;
+            auto &keys = scene.blasMotion[blasIndex].keys;
+            keys.reserve(samples.size());
+            for (const auto &sample : samples)
+                keys.push_back(sample.positions.at(name));
+        }
+
+        scene.hasMotion = true;
+        scene.markChanged(CompiledScene::ChangeInstances | CompiledScene::ChangeGeometry);
+        return true;
+    }
 }
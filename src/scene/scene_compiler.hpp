@@ -1,5 +1,6 @@
 #pragma once
 #include "scene.hpp"
+#include "blas_cache.hpp"
 #include "../device/device.hpp"
 #include "../device/buffer.hpp"
 #include "../device/image_2d.hpp"
@@ -9,6 +10,7 @@
 #include "../core/blas.hpp"
 #include "../shading/material_program/material_program.hpp"
 #include <memory>
+#include <span>
 #include <vector>
 #include <unordered_map>
 
@@ -108,7 +110,7 @@ namespace tracey
     };
     static_assert(sizeof(GPULight) == 96, "GPULight must be 96 bytes (6 * vec4)");
 
-    class BlasCache;
+    struct DecodedTexture;
 
     class SceneCompiler
     {
@@ -169,13 +171,16 @@ namespace tracey
             // The decoded pixels would otherwise be freed right after the
             // Vulkan upload; path tracer backends that own their textures
             // (Metal builds MTLTextures, the CPU backend samples directly)
-            // read from here instead of the device images.
+            // read from here instead of the device images. `pixels` is shared
+            // with the DecodedTextureCache rather than copied, so an unchanged
+            // image keeps the same pointer across recompiles and backends can
+            // key their converted copies on it.
             struct TextureSource
             {
                 uint32_t width = 0;
                 uint32_t height = 0;
                 bool srgb = false;            // colour data (albedo/emissive)
-                std::vector<uint8_t> rgba8;   // tightly packed RGBA8
+                std::shared_ptr<const DecodedTexture> pixels; // tightly packed RGBA8
             };
             std::vector<TextureSource> textureSources;
 
@@ -210,6 +215,46 @@ namespace tracey
             std::vector<Tlas::Instance> instancesEnd;
             bool hasMotion = false;
 
+            // Multi-segment and deformation motion blur, filled by
+            // applyMotionSamples(). `instanceKeys` holds K >= 2 instance poses
+            // evenly spaced over the shutter (front = `instances`, back =
+            // `instancesEnd`); backends that take only two poses keep using
+            // instancesEnd. `blasMotion` is parallel to `blases`: for a mesh
+            // whose vertices move over the shutter (skinning, VOP deformers)
+            // it holds the BLAS's triangle-soup positions at each of the K
+            // times; empty for rigid meshes. Only the CPU backend builds
+            // motion BLASes from it.
+            struct BlasMotion
+            {
+                std::vector<std::vector<Vec3>> keys;
+            };
+            std::vector<std::vector<Tlas::Instance>> instanceKeys;
+            std::vector<BlasMotion> blasMotion;
+
+            // Nested instancing. Populated only by compile(...,
+            // nestInstanceGroups = true) for scenes that place instance groups
+            // (Scene::addInstanceGroup). Each group holds its members in the
+            // group's local space; an entry of `instances` — or of another
+            // group — places it via Tlas::Instance::setGroupReference. Groups
+            // are stored children-first, so a group only references
+            // lower-indexed groups.
+            //
+            // The per-record arrays (materials, instanceToMaterialIndex,
+            // instanceProgramIndex, instanceUvOffset, instanceToActorUid) hold
+            // the top-level entries first, still index-parallel to `instances`,
+            // followed by each group's [recordBase, recordBase +
+            // instances.size()) range. Group references keep a placeholder
+            // record so addressing stays "record = base + index"; a CPU Tlas
+            // built over this reports the leaf's record in Hit::instanceId.
+            // Every placement of a group shares its records, so memory is
+            // O(unique group members + placements).
+            struct InstanceGroup
+            {
+                std::vector<Tlas::Instance> instances;
+                uint32_t recordBase = 0;
+            };
+            std::vector<InstanceGroup> instanceGroups;
+
             // Per-instance material program lookup and UV base offset.
             // instanceProgramIndex[i] is the GPU programId (= index into
             // materialPrograms.headers()); instanceUvOffset[i] is the
@@ -263,6 +308,45 @@ namespace tracey
             // that cache per-scene resources (acceleration structures, scene
             // buffer copies) compare this instead of re-uploading per frame.
             uint64_t revision = 0;
+
+            // What a revision bump touched. Each stamp is the revision at
+            // which that part of the scene last changed: compile() sets them
+            // all, in-place edits go through markChanged() with only the
+            // categories they wrote, so a backend can re-bind in proportion
+            // to the edit instead of treating every bump as a new scene.
+            //
+            //   Instances — instances, instancesEnd, instanceKeys,
+            //               instanceGroups, the per-record arrays
+            //               (instanceToMaterialIndex, instanceProgramIndex,
+            //               instanceUvOffset, instanceToActorUid), tlas and
+            //               emitters.
+            //   Geometry  — blases, blasMotion, vertexCounts and the global
+            //               uv / normal / position buffers.
+            //   Materials — materials and materialBuffer.
+            //   Lights    — lights, lightBuffer, lightCount.
+            //   Textures  — textures, textureSources.
+            enum Change : uint32_t
+            {
+                ChangeInstances = 1u << 0,
+                ChangeGeometry = 1u << 1,
+                ChangeMaterials = 1u << 2,
+                ChangeLights = 1u << 3,
+                ChangeTextures = 1u << 4,
+                ChangeAll = (1u << 5) - 1,
+            };
+            struct ChangeStamps
+            {
+                uint64_t instances = 0;
+                uint64_t geometry = 0;
+                uint64_t materials = 0;
+                uint64_t lights = 0;
+                uint64_t textures = 0;
+            };
+            ChangeStamps changes;
+
+            // Stamp a fresh revision and mark `what` (Change bits) as changed
+            // at it.
+            void markChanged(uint32_t what);
         };
 
         // Allocate the next scene revision stamp. Used by compile() and by
@@ -287,9 +371,68 @@ namespace tracey
         /// off, since the rasterizer doesn't traverse a BVH. The `cache`
         /// parameter is also ignored in that mode — there's nothing to cache
         /// because cached entries are inseparable from their BLAS.
+        ///
+        /// `nestInstanceGroups` keeps instance-group placements nested (see
+        /// CompiledScene::instanceGroups) instead of expanding every group
+        /// member into its own top-level instance. Only the CPU path tracer
+        /// backend traverses nested groups, so `tlas` is not built in that
+        /// mode when the scene places any group — device TLASes, the
+        /// rasterizer and the Metal backend all take flat instance lists.
         static CompiledScene compile(Device *device, const Scene &scene,
                                      const BVHConfig &bvhConfig, BlasCache *cache,
-                                     bool buildAccelerationStructures);
+                                     bool buildAccelerationStructures,
+                                     bool nestInstanceGroups = false);
+
+        /// Build `obj`'s BLAS and vertex / color buffers into `cache` under
+        /// `name`, ahead of compile(). A later compile() with the same cache
+        /// and BVH config takes the entry as a cache hit as long as the
+        /// scene's object of that name still has the same contentHash(), so
+        /// a streaming import can build BLASes while the rest of the file is
+        /// still being parsed (see BlasPrebuilder). Returns false for an
+        /// empty object. Not thread-safe with respect to `cache`.
+        static bool prepareObject(Device *device, const std::string &name, const SceneObject &obj,
+                                  const BVHConfig &bvhConfig, BlasCache &cache);
+
+        // One shutter sample for motion blur: the instance poses and each
+        // object's triangle-soup positions (by object name) of a scene
+        // compiled at a sub-frame time.
+        struct MotionSample
+        {
+            std::vector<Tlas::Instance> instances;
+            std::unordered_map<std::string, std::vector<Vec3>> positions;
+        };
+        static MotionSample captureMotionSample(const CompiledScene &scene);
+
+        // Attach `samples` — K >= 2 captures evenly spaced over the shutter,
+        // the first at shutter open — to `scene` as motion keys: instance
+        // poses (instanceKeys / instancesEnd) and, for each object whose
+        // positions change while its vertex count stays fixed, deformation
+        // keys (blasMotion). Objects whose topology changes across the
+        // shutter stay sharp. Sets hasMotion and a fresh revision. Returns
+        // false, leaving `scene` untouched, when a sample's instance count
+        // differs from the scene's.
+        static bool applyMotionSamples(CompiledScene &scene, std::span<const MotionSample> samples);
+
+        // Expand every instance-group reference in place into one top-level
+        // instance per leaf, with its records copied out of the group's range.
+        // The result has the flat layout compile() produces by default; a no-op
+        // when the scene has no groups.
+        static void flattenInstanceGroups(CompiledScene &scene);
+
+        // Read-only counterpart for consumers that take flat instance lists
+        // (the rasterizer, viewport picking) but are handed a nested scene:
+        // every leaf as a world-space instance (shutter-open pose), plus the
+        // record it reads its material / actor from. For a scene without
+        // groups this is a copy of `instances` with records 0..n-1.
+        static void expandInstanceGroups(const CompiledScene &scene, std::vector<Tlas::Instance> &leaves,
+                                         std::vector<uint32_t> &records);
+
+        // The scalar factors of a material (base color, metallic/roughness,
+        // emission, transmission, lobe weights) with every texture slot left
+        // unbound. compile() starts from this and then binds textures; a
+        // caller patching an untextured material in a live CompiledScene
+        // (the C API's material edit) writes it straight into `materials`.
+        static GPUMaterial materialFactors(const MaterialInstance &material);
 
         // Analytic-light data: the GPULight list + its uploaded buffer. Factored
         // out of compile() so an editor light edit (add / delete / tweak) can
@@ -333,8 +476,8 @@ namespace tracey
             std::unique_ptr<BottomLevelAccelerationStructure> blas;
             size_t vertexCount;
             size_t nodeCount;
-            std::vector<Vec2> uvs;       // Per-vertex UVs for this object
-            std::vector<Vec3> normals;   // Per-vertex normals for this object
+            SharedArray<Vec2> uvs;       // Per-vertex UVs (shared with the SceneObject)
+            SharedArray<Vec3> normals;   // Per-vertex normals (shared with the SceneObject)
             bool hasNormals = false;
         };
 
@@ -344,17 +487,29 @@ namespace tracey
         static ObjectData compileObject(Device *device, const SceneObject &obj,
                                         const BVHConfig &bvhConfig,
                                         bool buildAccelerationStructures = true);
+        static BlasCache::Entry makeCacheEntry(ObjectData &&data, const SceneObject &obj, uint64_t hash);
         static Mat4 computeWorldTransform(const Scene &scene, const Actor &actor);
 
-        // Load a texture and return its index, or -1 if failed. `isColorData`
-        // selects the GPU format: true → R8G8B8A8Srgb (gamma-decoded on
-        // sample, for albedo/emissive), false → R8G8B8A8Unorm (raw bytes,
-        // for normal/MR/occlusion). Two distinct uploads are kept if the
-        // same texture path is referenced as both color and data — the
-        // cache key includes the format.
-        static int32_t loadTexture(Device *device, CompiledScene &result, const Scene &scene, const std::string &texturePath, bool isColorData);
-
-        // Convert MaterialInstance to GPUMaterial, loading textures as needed
-        static GPUMaterial convertMaterial(Device *device, CompiledScene &result, const Scene &scene, const MaterialInstance &material);
+        // Texture path (file or "embedded:…") → decoded RGBA8 pixels; null for
+        // a texture that failed to load.
+        using DecodedTextures = std::unordered_map<std::string, std::shared_ptr<const DecodedTexture>>;
+
+        // Decode `paths` (unique) in parallel on the ThreadPool. Files come
+        // from DecodedTextureCache::global(), so unchanged files are not
+        // re-decoded across compiles; embedded images are expanded to RGBA.
+        static DecodedTextures decodeTextures(const Scene &scene, const std::vector<std::string> &paths);
+
+        // Upload a decoded texture and return its index, or -1 if failed.
+        // `isColorData` selects the GPU format: true → R8G8B8A8Srgb
+        // (gamma-decoded on sample, for albedo/emissive), false →
+        // R8G8B8A8Unorm (raw bytes, for normal/MR/occlusion). Two distinct
+        // uploads are kept if the same texture path is referenced as both
+        // color and data — the cache key includes the format.
+        static int32_t loadTexture(Device *device, CompiledScene &result, const DecodedTextures &decoded,
+                                   const std::string &texturePath, bool isColorData);
+
+        // Convert MaterialInstance to GPUMaterial, uploading textures as needed
+        static GPUMaterial convertMaterial(Device *device, CompiledScene &result, const DecodedTextures &decoded,
+                                           const MaterialInstance &material);
     };
 }
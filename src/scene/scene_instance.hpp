@@ -13,6 +13,8 @@ namespace tracey
         SceneInstance(const std::string &objectRef);
         SceneInstance(const std::string &objectRef, const MaterialInstance &material);
 
+        // Name of the SceneObject this instance places — or of an instance
+        // group (Scene::addInstanceGroup), which places every member of it.
         const std::string &objectRef() const { return m_objectRef; }
         void setObjectRef(const std::string &objectRef) { m_objectRef = objectRef; }
 
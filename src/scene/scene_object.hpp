@@ -1,4 +1,5 @@
 #pragma once
+#include "../core/shared_array.hpp"
 #include "../core/types.hpp"
 #include <string>
 #include <vector>
@@ -18,21 +19,30 @@ namespace tracey
         const std::string &name() const { return m_name; }
         void setName(const std::string &name) { m_name = name; }
 
-        const std::vector<Vec3> &positions() const { return m_positions; }
-        const std::vector<uint32_t> &indices() const { return m_indices; }
-        const std::vector<Vec3> &normals() const { return m_normals; }
-        const std::vector<Vec2> &uvs() const { return m_uvs; }
+        const std::vector<Vec3> &positions() const { return m_positions.vec(); }
+        const std::vector<uint32_t> &indices() const { return m_indices.vec(); }
+        const std::vector<Vec3> &normals() const { return m_normals.vec(); }
+        const std::vector<Vec2> &uvs() const { return m_uvs.vec(); }
         // Per-vertex color (Cd), one entry per position. Set by the SOP→
         // SceneObject converter when the Geometry carries a "Cd" Point
         // attribute; the rasterizer streams it as a second vertex buffer
         // and multiplies it into the material base color in the shader.
-        const std::vector<Vec3> &colors() const { return m_colors; }
+        const std::vector<Vec3> &colors() const { return m_colors.vec(); }
 
-        void setPositions(std::vector<Vec3> positions) { m_positions = std::move(positions); }
-        void setIndices(std::vector<uint32_t> indices) { m_indices = std::move(indices); }
-        void setNormals(std::vector<Vec3> normals) { m_normals = std::move(normals); }
-        void setUvs(std::vector<Vec2> uvs) { m_uvs = std::move(uvs); }
-        void setColors(std::vector<Vec3> colors) { m_colors = std::move(colors); }
+        // The channels are SharedArrays: copying a SceneObject (or handing a
+        // channel to the compiler's BlasCache) shares the storage instead of
+        // duplicating it. Setters take a vector by value (moved in, no copy)
+        // or another SharedArray (shared).
+        const SharedArray<Vec3> &sharedPositions() const { return m_positions; }
+        const SharedArray<Vec3> &sharedNormals() const { return m_normals; }
+        const SharedArray<Vec2> &sharedUvs() const { return m_uvs; }
+        const SharedArray<Vec3> &sharedColors() const { return m_colors; }
+
+        void setPositions(SharedArray<Vec3> positions) { m_positions = std::move(positions); }
+        void setIndices(SharedArray<uint32_t> indices) { m_indices = std::move(indices); }
+        void setNormals(SharedArray<Vec3> normals) { m_normals = std::move(normals); }
+        void setUvs(SharedArray<Vec2> uvs) { m_uvs = std::move(uvs); }
+        void setColors(SharedArray<Vec3> colors) { m_colors = std::move(colors); }
 
         // Skinning data (one entry per position, kept 1:1 with positions even
         // after the loader expands an indexed primitive to a triangle list).
@@ -89,11 +99,11 @@ namespace tracey
 
     private:
         std::string m_name;
-        std::vector<Vec3> m_positions;
-        std::vector<uint32_t> m_indices;
-        std::vector<Vec3> m_normals;
-        std::vector<Vec2> m_uvs;
-        std::vector<Vec3> m_colors;
+        SharedArray<Vec3> m_positions;
+        SharedArray<uint32_t> m_indices;
+        SharedArray<Vec3> m_normals;
+        SharedArray<Vec2> m_uvs;
+        SharedArray<Vec3> m_colors;
 
         // Skinning (empty for non-skinned meshes).
         std::vector<Vec4> m_jointIndices;
@@ -0,0 +1,233 @@
+#include "texture_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+// stb_image header (implementation is in gltf_loader.cpp)
+#include <stb_image.h>
+
+namespace tracey
+{
+    void expandToRgba8(const uint8_t *src, int channels, size_t pixelCount, uint8_t *dst)
+    {
+        if (channels == 4)
+        {
+            std::memcpy(dst, src, pixelCount * 4);
+            return;
+        }
+
+        size_t i = 0;
+#if defined(__ARM_NEON)
+        // 16 pixels per step: de-interleaving loads + one interleaving store.
+        const uint8x16_t opaque = vdupq_n_u8(255);
+        if (channels == 3)
+        {
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                const uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+                uint8x16x4_t rgba;
+                rgba.val[0] = rgb.val[0];
+                rgba.val[1] = rgb.val[1];
+                rgba.val[2] = rgb.val[2];
+                rgba.val[3] = opaque;
+                vst4q_u8(dst + i * 4, rgba);
+            }
+        }
+        else if (channels == 2)
+        {
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                const uint8x16x2_t ga = vld2q_u8(src + i * 2);
+                uint8x16x4_t rgba;
+                rgba.val[0] = ga.val[0];
+                rgba.val[1] = ga.val[0];
+                rgba.val[2] = ga.val[0];
+                rgba.val[3] = ga.val[1];
+                vst4q_u8(dst + i * 4, rgba);
+            }
+        }
+        else if (channels == 1)
+        {
+            for (; i + 16 <= pixelCount; i += 16)
+            {
+                const uint8x16_t g = vld1q_u8(src + i);
+                uint8x16x4_t rgba;
+                rgba.val[0] = g;
+                rgba.val[1] = g;
+                rgba.val[2] = g;
+                rgba.val[3] = opaque;
+                vst4q_u8(dst + i * 4, rgba);
+            }
+        }
+#elif defined(__SSSE3__)
+        // 4 pixels per shuffle. Lanes with a -1 index come out zero and are
+        // then OR'd with the constant alpha mask.
+        if (channels == 3)
+        {
+            const __m128i shuf = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            // The 16-byte load reads 4 bytes past the 4 pixels it converts;
+            // stop while two more pixels remain so it never leaves `src`.
+            for (; i + 6 <= pixelCount; i += 4)
+            {
+                const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),
+                                 _mm_or_si128(_mm_shuffle_epi8(in, shuf), alpha));
+            }
+        }
+        else if (channels == 2)
+        {
+            const __m128i shuf = _mm_setr_epi8(0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7);
+            for (; i + 4 <= pixelCount; i += 4)
+            {
+                const __m128i in = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i * 2));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_shuffle_epi8(in, shuf));
+            }
+        }
+        else if (channels == 1)
+        {
+            const __m128i shuf = _mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1);
+            const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+            for (; i + 4 <= pixelCount; i += 4)
+            {
+                int32_t four;
+                std::memcpy(&four, src + i, sizeof(four));
+                const __m128i in = _mm_cvtsi32_si128(four);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),
+                                 _mm_or_si128(_mm_shuffle_epi8(in, shuf), alpha));
+            }
+        }
+#endif
+        // Scalar tail (and the whole image on targets without the paths above).
+        // One branch-free body per channel count so -O3 can still vectorise it.
+        if (channels == 3)
+        {
+            for (; i < pixelCount; ++i)
+            {
+                dst[i * 4 + 0] = src[i * 3 + 0];
+                dst[i * 4 + 1] = src[i * 3 + 1];
+                dst[i * 4 + 2] = src[i * 3 + 2];
+                dst[i * 4 + 3] = 255;
+            }
+        }
+        else if (channels == 2)
+        {
+            for (; i < pixelCount; ++i)
+            {
+                dst[i * 4 + 0] = src[i * 2 + 0];
+                dst[i * 4 + 1] = src[i * 2 + 0];
+                dst[i * 4 + 2] = src[i * 2 + 0];
+                dst[i * 4 + 3] = src[i * 2 + 1];
+            }
+        }
+        else if (channels == 1)
+        {
+            for (; i < pixelCount; ++i)
+            {
+                dst[i * 4 + 0] = src[i];
+                dst[i * 4 + 1] = src[i];
+                dst[i * 4 + 2] = src[i];
+                dst[i * 4 + 3] = 255;
+            }
+        }
+    }
+
+    std::shared_ptr<const DecodedTexture> DecodedTextureCache::load(const std::string &path)
+    {
+        // Validation stamp: mtime + size. Either changing means the file was
+        // rewritten; a stat failure means it's gone (don't serve stale pixels).
+        std::error_code ec;
+        const auto mtime = std::filesystem::last_write_time(path, ec);
+        if (ec) return nullptr;
+        const uint64_t fileSize = std::filesystem::file_size(path, ec);
+        if (ec) return nullptr;
+        const int64_t stamp = static_cast<int64_t>(mtime.time_since_epoch().count());
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_entries.find(path);
+            if (it != m_entries.end() && it->second.mtime == stamp &&
+                it->second.fileSize == fileSize)
+            {
+                it->second.lastUse = ++m_useClock;
+                ++m_stats.hits;
+                return it->second.texture;
+            }
+            ++m_stats.misses;
+        }
+
+        // Decode outside the lock so distinct paths decode concurrently.
+        int width = 0, height = 0, channels = 0;
+        unsigned char *pixels = stbi_load(path.c_str(), &width, &height, &channels, 4); // force RGBA
+        if (!pixels) return nullptr;
+
+        auto decoded = std::make_shared<DecodedTexture>();
+        decoded->width = static_cast<uint32_t>(width);
+        decoded->height = static_cast<uint32_t>(height);
+        decoded->rgba8.assign(pixels, pixels + static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+        stbi_image_free(pixels);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Entry &entry = m_entries[path];
+        if (entry.texture) m_bytes -= entry.texture->rgba8.size();
+        entry.mtime = stamp;
+        entry.fileSize = fileSize;
+        entry.lastUse = ++m_useClock;
+        entry.texture = decoded;
+        m_bytes += decoded->rgba8.size();
+        evictOverBudget();
+        return decoded;
+    }
+
+    void DecodedTextureCache::evictOverBudget()
+    {
+        while (m_bytes > m_budgetBytes && m_entries.size() > 1)
+        {
+            auto oldest = m_entries.begin();
+            for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+                if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+            m_bytes -= oldest->second.texture->rgba8.size();
+            m_entries.erase(oldest);
+        }
+    }
+
+    void DecodedTextureCache::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_bytes = 0;
+    }
+
+    size_t DecodedTextureCache::size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    size_t DecodedTextureCache::bytes() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bytes;
+    }
+
+    void DecodedTextureCache::setBudgetBytes(size_t budget)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_budgetBytes = budget;
+        evictOverBudget();
+    }
+
+    DecodedTextureCache::Stats DecodedTextureCache::stats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+}
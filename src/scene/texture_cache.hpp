@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tracey
+{
+    // Tightly packed RGBA8 pixels for one decoded texture. Shared (const) between
+    // the process-wide cache below and every compile that references the image.
+    struct DecodedTexture
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> rgba8;
+    };
+
+    // Expand `pixelCount` interleaved 8-bit pixels with `channels` components
+    // (1 = grey, 2 = grey+alpha, 3 = RGB, 4 = RGBA) into RGBA8 at `dst`. Missing
+    // alpha is 255. NEON / SSSE3 shuffle paths where available; the scalar loops
+    // are one straight-line body per channel count so they auto-vectorise too.
+    void expandToRgba8(const uint8_t *src, int channels, size_t pixelCount, uint8_t *dst);
+
+    // Process-wide cache of decoded texture FILES, keyed by path and validated
+    // against the file's modification time + size on every lookup.
+    //
+    // SceneCompiler::compile used to stbi_load every texture path on every
+    // compile, so a recompile after an unrelated SOP edit re-decoded all of
+    // Sponza's JPEGs. Decoded pixels depend only on the file, so they can
+    // outlive any one CompiledScene: a hit hands back the same shared buffer,
+    // and touching/replacing the file on disk (new mtime or size) re-decodes.
+    //
+    // Thread-safe: lookups take a short mutex, decoding runs outside it, so the
+    // compiler fans distinct paths out across the ThreadPool. Two threads racing
+    // on the same cold path both decode and the second insert wins — harmless,
+    // and the compiler dedupes paths before fanning out anyway.
+    //
+    // Bounded by a byte budget: when exceeded, least-recently-used entries are
+    // dropped (outstanding shared_ptrs keep their pixels alive until released).
+    class DecodedTextureCache
+    {
+    public:
+        static DecodedTextureCache &global()
+        {
+            static DecodedTextureCache instance;
+            return instance;
+        }
+
+        // Decoded RGBA8 pixels for the image file at `path`, or nullptr when
+        // the file is missing or stb_image can't decode it (failures are not
+        // cached, so a file that appears later is picked up).
+        std::shared_ptr<const DecodedTexture> load(const std::string &path);
+
+        void clear();
+        size_t size() const;
+        size_t bytes() const;
+
+        // Resident-pixel budget (default 2 GiB).
+        void setBudgetBytes(size_t budget);
+
+        struct Stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+        };
+        Stats stats() const;
+
+    private:
+        DecodedTextureCache() = default;
+        DecodedTextureCache(const DecodedTextureCache &) = delete;
+        DecodedTextureCache &operator=(const DecodedTextureCache &) = delete;
+
+        struct Entry
+        {
+            int64_t mtime = 0;
+            uint64_t fileSize = 0;
+            uint64_t lastUse = 0;
+            std::shared_ptr<const DecodedTexture> texture;
+        };
+
+        // Caller holds m_mutex.
+        void evictOverBudget();
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<std::string, Entry> m_entries;
+        size_t m_bytes = 0;
+        size_t m_budgetBytes = size_t{2} << 30;
+        uint64_t m_useClock = 0;
+        Stats m_stats;
+    };
+}
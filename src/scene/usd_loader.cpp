@@ -11,6 +11,8 @@
 #include "scene_instance.hpp"
 #include "scene_object.hpp"
 #include "transform.hpp"
+#include "import_stream.hpp"
+#include "../core/parallel.hpp"
 
 #include <pxr/usd/usd/stage.h>
 #include <pxr/usd/usd/primRange.h>
@@ -460,10 +462,12 @@ namespace tracey
         // transform relative to the prototype root (so multi-mesh / offset
         // prototypes instance correctly) + its material. Instance proxies are
         // traversed so a prototype that itself contains nested instances still
-        // yields its geometry.
+        // yields its geometry. Newly added objects are streamed through
+        // `emitter` when one is given.
         std::vector<ProtoMesh> gatherPrototypeMeshes(const UsdPrim &protoRoot,
                                                      Scene &scene,
-                                                     const std::string &keyPrefix)
+                                                     const std::string &keyPrefix,
+                                                     ImportStreamEmitter *emitter = nullptr)
         {
             std::vector<ProtoMesh> out;
             if (!protoRoot) return out;
@@ -479,6 +483,7 @@ namespace tracey
                     auto obj = std::make_unique<SceneObject>();
                     if (!convertMesh(mesh, *obj)) continue;
                     obj->setName(objName);
+                    if (emitter) emitter->object(objName, *obj, /*countsTowardTotal=*/false);
                     scene.addObject(objName, std::move(obj));
                 }
                 ProtoMesh pm;
@@ -499,7 +504,7 @@ namespace tracey
         // the number of placements created. Static (default-time) only;
         // per-instance animation + invisibleIds are follow-ups.
         int convertPointInstancer(const UsdGeomPointInstancer &pi, Scene &scene,
-                                  const glm::mat4 &upM)
+                                  const glm::mat4 &upM, ImportStreamEmitter *emitter = nullptr)
         {
             const UsdPrim prim = pi.GetPrim();
             SdfPathVector protoPaths;
@@ -528,7 +533,7 @@ namespace tracey
             for (size_t k = 0; k < protoPaths.size(); ++k)
                 protoMeshes[k] = gatherPrototypeMeshes(
                     stage->GetPrimAtPath(protoPaths[k]), scene,
-                    prim.GetPath().GetString() + "::proto" + std::to_string(k));
+                    prim.GetPath().GetString() + "::proto" + std::to_string(k), emitter);
 
             Actor *actor = scene.createActor();
             actor->setName("instancer:" + prim.GetPath().GetString());
@@ -554,7 +559,9 @@ namespace tracey
 
     bool UsdLoader::available() { return true; }
 
-    std::unique_ptr<Scene> UsdLoader::loadFromFile(const std::string &path)
+    // Shared body of loadFromFile / loadFromFileStreaming (`stream` null for
+    // the former).
+    static std::unique_ptr<Scene> loadUsd(const std::string &path, const ImportStream *stream)
     {
         UsdStageRefPtr stage = UsdStage::Open(path);
         if (!stage)
@@ -585,6 +592,33 @@ namespace tracey
             return false;
         };
 
+        // Standalone mesh prims (the ones the traversal below turns into one
+        // actor each), in traversal order. Converting them — triangulation,
+        // primvar de-indexing — is the bulk of the load and each is
+        // independent, so it runs on the pool up front, streaming every mesh
+        // out as it finishes; the traversal then only assembles, taking the
+        // converted objects back in the same order.
+        std::vector<UsdPrim> meshPrims;
+        for (const UsdPrim &prim : stage->Traverse())
+            if (!underPrototype(prim.GetPath()) && !prim.IsInstance() && prim.IsA<UsdGeomMesh>())
+                meshPrims.push_back(prim);
+        std::vector<std::unique_ptr<SceneObject>> converted(meshPrims.size());
+        ImportStreamEmitter emitter(stream, "meshes", meshPrims.size());
+        parallel_for_each_index(meshPrims.size(), [&](size_t i) {
+            auto obj = std::make_unique<SceneObject>();
+            if (!convertMesh(UsdGeomMesh(meshPrims[i]), *obj))
+            {
+                emitter.skip();
+                return;
+            }
+            const std::string name = meshPrims[i].GetPath().GetString();
+            obj->setName(name);
+            emitter.object(name, *obj);
+            converted[i] = std::move(obj);
+        });
+        emitter.progress("assemble", 0, 0);
+        size_t nextMesh = 0;
+
         // Shared prototype geometry for native (scenegraph) instancing, keyed by
         // prototype path so all instances of the same master reuse one BLAS set.
         std::unordered_map<std::string, std::vector<ProtoMesh>> protoCache;
@@ -598,7 +632,7 @@ namespace tracey
             // PointInstancer → shared prototypes + per-instance placements.
             if (prim.IsA<UsdGeomPointInstancer>())
             {
-                instances += convertPointInstancer(UsdGeomPointInstancer(prim), *scene, upM);
+                instances += convertPointInstancer(UsdGeomPointInstancer(prim), *scene, upM, &emitter);
                 continue;
             }
 
@@ -616,7 +650,7 @@ namespace tracey
                     const std::string key = proto.GetPath().GetString();
                     auto it = protoCache.find(key);
                     if (it == protoCache.end())
-                        it = protoCache.emplace(key, gatherPrototypeMeshes(proto, *scene, key)).first;
+                        it = protoCache.emplace(key, gatherPrototypeMeshes(proto, *scene, key, &emitter)).first;
                     if (!it->second.empty())
                     {
                         const glm::mat4 instWorld = upM * toGlm(
@@ -671,13 +705,11 @@ namespace tracey
                 continue;
             }
 
-            UsdGeomMesh mesh(prim);
-            if (!mesh) continue;
+            if (!prim.IsA<UsdGeomMesh>()) continue;
 
-            auto obj = std::make_unique<SceneObject>();
-            if (!convertMesh(mesh, *obj)) continue;
+            std::unique_ptr<SceneObject> obj = std::move(converted[nextMesh++]);
+            if (!obj) continue;
             const std::string name = prim.GetPath().GetString();
-            obj->setName(name);
             scene->addObject(name, std::move(obj));
 
             // One actor per mesh prim, world transform baked on (hierarchy
@@ -698,6 +730,16 @@ namespace tracey
         return scene;
     }
 
+    std::unique_ptr<Scene> UsdLoader::loadFromFile(const std::string &path)
+    {
+        return loadUsd(path, nullptr);
+    }
+
+    std::unique_ptr<Scene> UsdLoader::loadFromFileStreaming(const std::string &path, const ImportStream &stream)
+    {
+        return loadUsd(path, &stream);
+    }
+
     namespace
     {
         // Process-wide parsed-stage cache (mirrors GltfLoader's). Stores
@@ -709,6 +751,12 @@ namespace tracey
     }
 
     std::shared_ptr<const Scene> UsdLoader::loadFromFileCached(const std::string &path)
+    {
+        return loadFromFileCached(path, ImportStream{});
+    }
+
+    std::shared_ptr<const Scene> UsdLoader::loadFromFileCached(const std::string &path,
+                                                               const ImportStream &stream)
     {
         {
             std::lock_guard<std::mutex> lock(g_cacheMutex);
@@ -717,7 +765,7 @@ namespace tracey
         }
         // Parse outside the lock (USD open can be slow); first writer wins on
         // the rare race — both produce equivalent scenes.
-        std::shared_ptr<const Scene> parsed = loadFromFile(path);
+        std::shared_ptr<const Scene> parsed = loadFromFileStreaming(path, stream);
         if (!parsed) return nullptr;
         std::lock_guard<std::mutex> lock(g_cacheMutex);
         auto [it, inserted] = g_cache.emplace(path, parsed);
@@ -874,11 +922,21 @@ namespace tracey
         return nullptr;
     }
 
+    std::unique_ptr<Scene> UsdLoader::loadFromFileStreaming(const std::string &path, const ImportStream &)
+    {
+        return loadFromFile(path);
+    }
+
     std::shared_ptr<const Scene> UsdLoader::loadFromFileCached(const std::string &)
     {
         return nullptr;
     }
 
+    std::shared_ptr<const Scene> UsdLoader::loadFromFileCached(const std::string &, const ImportStream &)
+    {
+        return nullptr;
+    }
+
     void UsdLoader::invalidateCache(const std::string &) {}
 
     std::vector<UsdLoader::HierarchyNode> UsdLoader::peekHierarchy(const std::string &,
@@ -9,6 +9,8 @@
 
 namespace tracey
 {
+    struct ImportStream;
+
     // Imports an OpenUSD stage (.usd / .usda / .usdc / .usdz) into our Scene,
     // mirroring GltfLoader. The header is deliberately USD-free (no pxr types in
     // the API) so anything can include it; the implementation lives in the
@@ -30,6 +32,13 @@ namespace tracey
         // when USD support isn't compiled in.
         static std::unique_ptr<Scene> loadFromFile(const std::string &path);
 
+        // Streaming load (mirrors GltfLoader::loadFromFileStreaming): mesh
+        // prims are converted on the ThreadPool and each is handed to
+        // `stream.onObject` as it finishes, with "meshes" progress against
+        // the stage's mesh-prim count. Prototype meshes are streamed as the
+        // assembly pass reaches them. Same Scene as loadFromFile.
+        static std::unique_ptr<Scene> loadFromFileStreaming(const std::string &path, const ImportStream &stream);
+
         // Process-wide memo of parsed stages, keyed by path. Mirrors
         // GltfLoader::loadFromFileCached: the SOP graph spawns one usd_import
         // per mesh prim and the editor's apply_emitted re-resolves materials
@@ -38,6 +47,10 @@ namespace tracey
         // reference until invalidated or process exit. Thread-safe. Returns
         // nullptr on failure / no USD support.
         static std::shared_ptr<const Scene> loadFromFileCached(const std::string &path);
+        // As above, parsing through loadFromFileStreaming on a cache miss.
+        // A hit returns immediately without calling `stream`.
+        static std::shared_ptr<const Scene> loadFromFileCached(const std::string &path,
+                                                               const ImportStream &stream);
 
         // Drop any cached entry for `path` (e.g. the file was re-saved).
         static void invalidateCache(const std::string &path);
@@ -26,6 +26,19 @@ namespace tracey
             return &it->second.output;
         }
 
+        uint64_t CookCache::versionOf(size_t uid) const
+        {
+            auto it = m_entries.find(uid);
+            if (it == m_entries.end() || !it->second.valid) return 0;
+            return it->second.timeDependent ? it->second.editKey : it->second.cookId;
+        }
+
+        void CookCache::markDirty(size_t uid)
+        {
+            auto it = m_entries.find(uid);
+            if (it != m_entries.end()) it->second.valid = false;
+        }
+
         void CookCache::markAllUntouched()
         {
             for (auto &[_, e] : m_entries) e.touched = false;
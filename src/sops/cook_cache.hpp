@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../geometry/attribute_pool.hpp"
 #include "../geometry/geometry.hpp"
 
 #include <cstddef>
@@ -37,14 +38,22 @@ namespace tracey
         public:
             struct Entry
             {
-                // Bumps every time the node was actually re-cooked. Stays
-                // unchanged across cache hits, so downstream nodes mixing
-                // this in see a stable signature for clean upstreams.
+                // Set from nextCookId() every time the node was actually
+                // re-cooked. Stays unchanged across cache hits, so downstream
+                // nodes mixing this in see a stable signature for clean
+                // upstreams. Unique across the cache's lifetime — an entry
+                // evicted and re-created under the same uid never repeats an
+                // id, so external consumers (the DOP graph's per-frame input
+                // stamps) can compare ids without tracking evictions.
                 uint64_t cookId = 0;
                 // Hash of (kind, params, incoming connection topology +
                 // upstream cookIds, time if timeDependent). Compared to a
                 // freshly computed key to decide hit vs miss.
                 uint64_t inputKey = 0;
+                // Like inputKey but blind to time: (kind, params, bypass,
+                // incoming topology + upstream editKeys). Changes only when
+                // the graph is edited, never when just the playhead moves.
+                uint64_t editKey = 0;
                 // Last cooked output. Read by downstream cooks when this
                 // entry is a cache hit; downstream pointers must stay valid
                 // for the duration of the cook (see SopGraph::cook).
@@ -75,18 +84,48 @@ namespace tracey
             // sweep and shouldn't be flipped by side-channel reads.
             const Geometry *findOutput(size_t uid) const;
 
+            // Version of findOutput(uid) for consumers that cache results
+            // derived from it across frames (DopGraph's SOP input stamps):
+            // the cookId for static entries, the editKey for time-dependent
+            // ones — whose cookId moves with every frame while only an
+            // edit should count as a change. 0 if absent / not yet cooked.
+            // Same no-touch contract as findOutput().
+            uint64_t versionOf(size_t uid) const;
+
+            // Fresh cookId for an entry that was just re-cooked.
+            uint64_t nextCookId() { return ++m_lastCookId; }
+
             // Get-or-create. The returned entry is marked touched; if it's
             // freshly constructed, `valid` is still false until the caller
             // fills in inputKey + output + flips valid = true.
             Entry &upsert(size_t uid);
 
+            // Incremental-patch hooks (see applySopGraphPatch). markDirty
+            // forces the next cook to re-run `uid` even when its inputKey
+            // still matches; downstream nodes follow through the bumped
+            // cookId. erase drops the entry outright (node deleted or
+            // rebuilt under the same uid).
+            void markDirty(size_t uid);
+            void erase(size_t uid) { m_entries.erase(uid); }
+
+            // Attribute storage recycled across this cache's cooks:
+            // SopGraph::cook installs it for the duration of the cook, so the
+            // outputs a re-cook replaces (and every node's scratch geometry)
+            // back the next cook's allocations.
+            AttributePool &pool() { return m_pool; }
+
             void markAllUntouched();
             void evictUntouched();
             void clear() { m_entries.clear(); }
             size_t size() const { return m_entries.size(); }
 
         private:
+            // Declared first so it outlives the entries it may be recycling
+            // into while they're destroyed.
+            AttributePool m_pool;
             std::unordered_map<size_t, Entry> m_entries;
+            // Not reset by clear(): ids stay unique for the cache's lifetime.
+            uint64_t m_lastCookId = 0;
         };
     }
 }
@@ -93,28 +93,28 @@ namespace tracey
                     if (inputs.empty() || !inputs[0]) return {};
                     Geometry out = *inputs[0];
 
-                    auto *P = out.points().get<Vec3>("P");
+                    auto *P = out.points().get(kAttrP);
                     if (!P) return out;
                     const size_t n = P->data().size();
                     if (n == 0) return out;
 
                     const FalloffParams falloff = loadFalloffParamsAt(*this, time);
 
-                    auto *Cd = out.points().get<Vec3>("Cd");
+                    auto *Cd = out.points().get(kAttrCd);
                     if ((wantsCd || falloff.weightToCd) && !Cd)
                     {
-                        Cd = out.points().add<Vec3>("Cd", Vec3(1.0f));
+                        Cd = out.points().add(kAttrCd, Vec3(1.0f));
                     }
-                    auto *ps = out.points().get<float>("pscale");
+                    auto *ps = out.points().get(kAttrPscale);
                     if (wantsPscale && !ps)
                     {
-                        ps = out.points().add<float>("pscale", 1.0f);
+                        ps = out.points().add(kAttrPscale, 1.0f);
                     }
 
                     // Rotation: probe whether any point will receive a
                     // non-zero offset before materialising `orient`.
-                    auto *orient = out.points().get<Vec4>("orient");
-                    const auto *N = out.points().get<Vec3>("N");
+                    auto *orient = out.points().get(kAttrOrient);
+                    const auto *N = out.points().get(kAttrN);
                     bool wantsOrient = orient != nullptr;
                     if (!wantsOrient && rotDegFn)
                     {
@@ -127,7 +127,7 @@ namespace tracey
                     }
                     if (wantsOrient && !orient)
                     {
-                        orient = out.points().add<Vec4>("orient", identityWxyz());
+                        orient = out.points().add(kAttrOrient, identityWxyz());
                         // Seed from the N frame so effector rotation composes
                         // on top of orient_to_normal-style behaviour.
                         if (N)
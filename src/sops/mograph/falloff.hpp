@@ -11,9 +11,8 @@
 //              (full weight at/behind center, ramps out along the axis)
 // then  w = 1 - smoothstep(inner, 1, d); optional invert; × strength.
 //
-// Also hosts the per-point deterministic random + noise seed-shift helpers
-// the random/noise effectors share (replicated from the TU-local versions
-// in src/vops/nodes/noise_vops.cpp — those can't be linked against).
+// Also hosts the per-point deterministic random helpers the random
+// effector uses. Noise fields come from core/noise.hpp.
 
 #pragma once
 
@@ -185,14 +184,6 @@ namespace tracey
                             rand01(i, seed + 1013) * 2.0f - 1.0f,
                             rand01(i, seed + 1031) * 2.0f - 1.0f);
             }
-
-            // Decorrelate a noise field per seed by shifting the sample
-            // position — mirrors the seedShift in vops/nodes/noise_vops.cpp.
-            inline glm::vec3 seedShift(const glm::vec3 &p, int seed)
-            {
-                const float s = static_cast<float>(seed);
-                return p + glm::vec3(s * 17.131f, s * 31.711f, s * 53.917f);
-            }
         } // namespace mograph
     } // namespace sops
 } // namespace tracey
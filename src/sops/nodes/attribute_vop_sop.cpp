@@ -12,15 +12,18 @@
 // v1 deferred items:
 //   • Constant-vs-port-input parameter modes (Houdini-style "linked"
 //     params) — VOP node parameters are knobs only.
-//   • Multi-geometry inputs — only one input geometry.
+//   • Multi-geometry inputs — the second input (`collision`) is only
+//     visible to VopNode::prepareWithInputs (the intersect VOP casts
+//     against it); per-point reads still address the first input only.
 //   • The frontend canvas/palette/inspector were copied (third copy) rather
 //     than unified; refactor is the natural follow-up.
 //
 // Cook contract:
-//   • Single Geometry input, single Geometry output.
+//   • Geometry input (+ optional collision input), single Geometry output.
 //   • Cook clones the input, stamps any promoted host params back into the
-//     matching VOP nodes (time-sampled), calls each VopNode::prepare(geo)
-//     once so geo_output materialises target attributes, then iterates
+//     matching VOP nodes (time-sampled), calls each
+//     VopNode::prepareWithInputs(geo, extra) once so geo_output materialises
+//     target attributes, then iterates
 //     points and calls VopGraph::evaluatePoint(idx, geo) per point.
 
 #include "attribute_vop_sop.hpp"
@@ -68,6 +71,7 @@ namespace tracey
                 {
                     InputsAndOutputs io;
                     io.addInput(PortInfo::createInput("in", DataType::Scene3D));
+                    io.addInput(PortInfo::createInput("collision", DataType::Scene3D));
                     io.addOutput(PortInfo::createOutput("out", DataType::Scene3D));
                     return io;
                 }
@@ -104,10 +108,13 @@ namespace tracey
                     // section: prepare() can `add<>` an attribute, which
                     // reallocates the attribute table's storage. Doing
                     // that concurrently with reads in evaluate() would race.
+                    // Inputs past the first (the `collision` surface) are
+                    // handed to prepare so ray-casting nodes can build their
+                    // BVH once here rather than per point.
                     for (const auto &n : m_vopGraph->nodes())
                     {
                         if (auto *vn = dynamic_cast<vops::VopNode *>(n.get()))
-                            vn->prepare(out);
+                            vn->prepareWithInputs(out, inputs.subspan(1));
                     }
                     // Hoist compile() out of the per-point loop. evaluatePoint
                     // does it lazily but calling it once up-front prevents
@@ -514,7 +521,7 @@ namespace tracey
         {
             SopRegistry::instance().registerType(
                 {"attribute_vop", "Attribute VOP", "Modifiers",
-                 /*inputs*/ {{"in"}}, /*outputs*/ {{"out"}},
+                 /*inputs*/ {{"in"}, {"collision"}}, /*outputs*/ {{"out"}},
                  /*params*/ {}},
                 [](size_t uid) -> std::unique_ptr<SopNode> {
                     return std::make_unique<AttributeVopSop>(uid);
@@ -20,11 +20,17 @@
 // written by the MoGraph effectors) takes precedence over the N-derived
 // frame; `orient_to_normal` only governs the N fallback.
 //
+// Packed instancing: with `pack_instances` on, the cook returns an empty
+// Geometry and the clones exist only as an instance stamp. Feed this node
+// into an `instance` SOP's stamp input and SopGraph::cook reads this node's
+// own stamp + template instead, emitting one nested instance-group level per
+// packed copy_to_points in the chain (EmittedActor::groupLevels). A 100-point
+// template of 100-point copies then ships as one stamp BLAS plus two small
+// group levels rather than 10 000 baked stamp copies. Anything else wired to
+// a packed node's output sees nothing.
+//
 // Deferred (matches plan):
 //   • `up` per-point.
-//   • Multi-instancing (1 BLAS + N TLAS instances) — current implementation
-//     bakes one fat output Geometry, which the existing actor pipeline ships
-//     as a single BLAS.
 
 #include "../sop_node.hpp"
 #include "../sop_registry.hpp"
@@ -61,6 +67,9 @@ namespace tracey
                     // blades that should stay axis-aligned regardless of
                     // the underlying terrain's surface normal.
                     declareParam(Parameter::makeBool("orient_to_normal", true));
+                    // Off by default: the clones are baked into the output.
+                    // See "Packed instancing" above.
+                    declareParam(Parameter::makeBool("pack_instances", false));
                 }
 
                 std::string kind() const override { return "copy_to_points"; }
@@ -77,6 +86,9 @@ namespace tracey
                 Geometry cook(std::span<const Geometry *const> inputs) const override
                 {
                     if (inputs.size() < 2 || !inputs[0] || !inputs[1]) return {};
+                    // Clones consumed only as an instance stamp; the
+                    // `instance` SOP downstream reads our inputs directly.
+                    if (paramBool("pack_instances", false)) return {};
                     const Geometry &stamp = *inputs[0];
                     const Geometry &tmpl  = *inputs[1];
 
@@ -84,7 +96,7 @@ namespace tracey
                     if (tplP.empty()) return {};
 
                     const bool useNormal = paramBool("orient_to_normal", true);
-                    const auto *tplOrient = tmpl.points().get<Vec4>("orient");
+                    const auto *tplOrient = tmpl.points().get(kAttrOrient);
 
                     // GPU fast path. Handles the common particle-instance
                     // case (stamp = primitive_cube / glTF mesh, template =
@@ -109,16 +121,16 @@ namespace tracey
                         }
                     }
 
-                    const auto *tplPs = tmpl.points().get<float>("pscale");
-                    const auto *tplN  = tmpl.points().get<Vec3>("N");
-                    const auto *tplCd = tmpl.points().get<Vec3>("Cd");
+                    const auto *tplPs = tmpl.points().get(kAttrPscale);
+                    const auto *tplN  = tmpl.points().get(kAttrN);
+                    const auto *tplCd = tmpl.points().get(kAttrCd);
 
                     // mergeFrom only preserves attributes whose name+type exist
                     // on the destination, so any attribute we want propagated
                     // from the stamp (or stamped from the template) must be
                     // pre-declared on `out` before the first merge.
                     Geometry out;
-                    if (stamp.points().get<Vec3>("N"))
+                    if (stamp.points().get(kAttrN))
                     {
                         // Preserve point-N from the stamp so the resulting
                         // mesh keeps proper shading after the cloning — the
@@ -157,7 +169,7 @@ namespace tracey
                         // Structural deep copy of the stamp — we mutate its
                         // positions/normals in place, then mergeFrom into out.
                         Geometry clone = stamp;
-                        if (auto *cP = clone.points().get<Vec3>("P"))
+                        if (auto *cP = clone.points().get(kAttrP))
                         {
                             for (auto &p : cP->data())
                             {
@@ -166,7 +178,7 @@ namespace tracey
                                 p = Vec3(tp.x + P.x, tp.y + P.y, tp.z + P.z);
                             }
                         }
-                        if (auto *cN = clone.points().get<Vec3>("N"))
+                        if (auto *cN = clone.points().get(kAttrN))
                         {
                             for (auto &n : cN->data())
                             {
@@ -183,7 +195,7 @@ namespace tracey
                         if (tplCd && i < tplCd->data().size())
                         {
                             const Vec3 cd = tplCd->data()[i];
-                            auto *cv = clone.vertices().get<Vec3>("Cd");
+                            auto *cv = clone.vertices().get(kAttrCd);
                             if (!cv) cv = clone.vertices().add<Vec3>("Cd", Vec3(1.0f));
                             for (auto &v : cv->data()) v = cd;
                         }
@@ -202,7 +214,8 @@ namespace tracey
                  /*inputs*/ {{"stamp"}, {"template"}},
                  /*outputs*/ {{"out"}},
                  /*params*/ {
-                     {"orient_to_normal", ParamType::Bool, "true"}}},
+                     {"orient_to_normal", ParamType::Bool, "true"},
+                     {"pack_instances",   ParamType::Bool, "false"}}},
                 [](size_t uid) -> std::unique_ptr<SopNode> {
                     return std::make_unique<CopyToPointsSop>(uid);
                 });
@@ -13,6 +13,13 @@
 // up with N instances pointing at that one BVH. That's true GPU instancing:
 // memory is O(stamp_size + N * sizeof(transform)) instead of O(N * stamp_size).
 //
+// Nested instancing: when the stamp is a copy_to_points with
+// `pack_instances` on (optionally a chain of them), SopGraph::cook reads the
+// packed node's own stamp and template and emits ONE actor whose
+// groupLevels hold one instance-group level per packed copy — the clones of
+// the clones are never baked. The editor maps those levels onto Scene
+// instance groups.
+//
 // The class itself is a stub — emit logic lives in SopGraph::cook so the
 // emission machinery (parent links, cook timing, cache integration) is
 // shared with the other terminals (`object_output`, `light`).
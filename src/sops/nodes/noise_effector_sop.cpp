@@ -7,7 +7,8 @@
 #include "../mograph/effector_base.hpp"
 #include "../sop_registry.hpp"
 
-#include <glm/gtc/noise.hpp>
+#include "../../core/noise.hpp"
+#include "../../core/parallel.hpp"
 
 #include <algorithm>
 #include <vector>
@@ -58,17 +59,11 @@ namespace tracey
                     if (!inputs.empty() && inputs[0])
                     {
                         const auto &P = inputs[0]->positions();
-                        field.reserve(P.size());
-                        for (const auto &p : P)
-                        {
-                            const glm::vec3 base(p.x * freq + offset.x,
-                                                 p.y * freq + offset.y,
-                                                 p.z * freq + offset.z);
-                            field.push_back(Vec3(
-                                glm::perlin(mograph::seedShift(base, seed)),
-                                glm::perlin(mograph::seedShift(base, seed + 41)),
-                                glm::perlin(mograph::seedShift(base, seed + 83))));
-                        }
+                        field.resize(P.size());
+                        tracey::parallel_for_chunks(P.size(), [&](size_t begin, size_t end) {
+                            noise::perlin3Field(P.data() + begin, end - begin, freq, offset, seed,
+                                                field.data() + begin);
+                        }, /*serialThreshold=*/256);
                     }
 
                     return applyEffect(
@@ -110,7 +110,7 @@ namespace tracey
                         // any stale point N so downstream consumers
                         // unambiguously pick up the vertex version.
                         out.points().remove("N");
-                        auto *Nv = out.vertices().get<Vec3>("N");
+                        auto *Nv = out.vertices().get(kAttrN);
                         if (!Nv) Nv = out.vertices().add<Vec3>("N", Vec3(0.0f));
                         auto &N = Nv->data();
                         for (const auto &prim : prims)
@@ -143,7 +143,7 @@ namespace tracey
                     // smooth→flat→smooth doesn't leave both attributes
                     // floating and have the hit shader pick the wrong one.
                     out.vertices().remove("N");
-                    auto *Nattr = out.points().get<Vec3>("N");
+                    auto *Nattr = out.points().get(kAttrN);
                     if (!Nattr) Nattr = out.points().add<Vec3>("N", Vec3(0.0f));
                     auto &N = Nattr->data();
                     std::fill(N.begin(), N.end(), Vec3(0.0f));
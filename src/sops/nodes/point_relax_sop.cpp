@@ -0,0 +1,111 @@
+// PointRelaxSop — push points apart until no two sit closer than `radius`.
+// The usual follow-up to a random scatter: clumps spread out into an even
+// blue-noise-ish distribution while the overall layout stays put.
+//
+// Each iteration is one Jacobi step: every point looks at its neighbours
+// within `radius` (through the point KD-tree, geometry/point_kdtree.hpp)
+// and moves away from each by half the overlap, scaled by `strength`.
+// New positions go to a separate buffer, so the result does not depend on
+// point order or thread count. Coincident points have no direction to
+// separate along and stay where they are.
+//
+// The first iteration reuses a tree cached on the input's point table if
+// an upstream consumer already built one; later iterations rebuild on the
+// moved positions.
+
+#include "../sop_node.hpp"
+#include "../sop_registry.hpp"
+
+#include "../../core/parallel.hpp"
+#include "../../geometry/geometry.hpp"
+#include "../../geometry/attribute.hpp"
+#include "../../geometry/attribute_table.hpp"
+#include "../../geometry/point_kdtree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace tracey
+{
+    namespace sops
+    {
+        namespace
+        {
+            class PointRelaxSop : public SopNode
+            {
+            public:
+                explicit PointRelaxSop(size_t uid) : SopNode(uid)
+                {
+                    declareParam(Parameter::makeFloat("radius",     0.1f));
+                    declareParam(Parameter::makeInt  ("iterations", 10));
+                    declareParam(Parameter::makeFloat("strength",   1.0f));
+                }
+                std::string kind() const override { return "point_relax"; }
+
+                InputsAndOutputs ports() const override
+                {
+                    InputsAndOutputs io;
+                    io.addInput (PortInfo::createInput ("in",  DataType::Scene3D));
+                    io.addOutput(PortInfo::createOutput("out", DataType::Scene3D));
+                    return io;
+                }
+
+                Geometry cook(std::span<const Geometry *const> inputs) const override
+                {
+                    if (inputs.empty() || !inputs[0]) return Geometry{};
+                    Geometry out = *inputs[0];
+                    const size_t n = out.pointCount();
+                    const float radius = paramFloat("radius", 0.1f);
+                    const int iterations = std::clamp(paramInt("iterations", 10), 0, 1000);
+                    const float strength = std::clamp(paramFloat("strength", 1.0f), 0.0f, 1.0f);
+                    if (n <= 1 || radius <= 0.0f || iterations == 0 || strength == 0.0f) return out;
+                    if (!std::as_const(out).points().get<Vec3>("P")) return out;
+
+                    std::vector<Vec3> next(n);
+                    for (int it = 0; it < iterations; ++it)
+                    {
+                        const auto tree = acquirePointKdTree(std::as_const(out).points());
+                        const std::vector<Vec3> &P = std::as_const(out).positions();
+                        bool moved = false;
+                        tracey::parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                            for (size_t i = begin; i < end; ++i)
+                            {
+                                const Vec3 p = P[i];
+                                Vec3 push(0.0f);
+                                tree->forEachInRadius(p, radius, [&](uint32_t j, const Vec3 &q, float d2) {
+                                    if (j == i || d2 <= 0.0f) return;
+                                    const float d = std::sqrt(d2);
+                                    push += (p - q) * ((radius - d) * 0.5f / d);
+                                });
+                                next[i] = p + push * strength;
+                            }
+                        });
+                        for (size_t i = 0; i < n && !moved; ++i) moved = next[i] != P[i];
+                        if (!moved) break;
+                        // Writing through the mutable accessor bumps P's
+                        // generation, so the next acquire rebuilds.
+                        std::copy(next.begin(), next.end(), out.positions().begin());
+                    }
+                    return out;
+                }
+            };
+        }  // anon
+
+        void registerPointRelaxSop()
+        {
+            SopRegistry::instance().registerType(
+                {"point_relax", "Point Relax", "Modifiers",
+                 /*inputs*/  {{"in"}}, /*outputs*/ {{"out"}},
+                 /*params*/ {
+                     {"radius",     ParamType::Float, "0.1", 0.0, 2.0,   0.001},
+                     {"iterations", ParamType::Int,   "10",  0.0, 100.0, 1.0},
+                     {"strength",   ParamType::Float, "1.0", 0.0, 1.0,   0.01},
+                 }},
+                [](size_t uid) -> std::unique_ptr<SopNode> {
+                    return std::make_unique<PointRelaxSop>(uid);
+                });
+        }
+    }
+}
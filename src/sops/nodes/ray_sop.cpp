@@ -0,0 +1,164 @@
+// RaySop — project the points of the first input onto the surface of the
+// second ("collision") input, Houdini's Ray SOP. Snaps scattered points to
+// terrain, drops clones onto whatever is below them, and measures distances
+// to a surface.
+//
+// Each point casts one ray from P:
+//   direction_mode = "vector" — along the `direction` parameter;
+//                    "normal" — along the point's N (falls back to
+//                               `direction` when the input has no N).
+// `reverse` flips the ray; `bidirectional` casts both ways and keeps the
+// nearer hit. Hits further than `max_distance` (0 = unlimited) or closer
+// than `bias` are ignored.
+//
+// On a hit, `transform` moves P to the hit position. Every point gets
+// hitdist (float, -1 on a miss), hitprim (int, collision primitive id or
+// -1) and hitN (Vec3, the hit face's geometric normal, or the ray
+// direction on a miss); misses keep their P.
+//
+// The collision BVH is the engine's CPU Blas, shared through
+// acquireGeometryBlas (geometry/geometry_blas.hpp), so a re-cook against
+// an unchanged collision input skips the build. Rays are traced in
+// parallel over the points.
+
+#include "../sop_node.hpp"
+#include "../sop_registry.hpp"
+
+#include "../../core/parallel.hpp"
+#include "../../geometry/attribute.hpp"
+#include "../../geometry/attribute_table.hpp"
+#include "../../geometry/geometry.hpp"
+#include "../../geometry/geometry_blas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tracey
+{
+    namespace sops
+    {
+        namespace
+        {
+            Vec3 normalizedOr(const Vec3 &v, const Vec3 &fallback)
+            {
+                const float len2 = v.x * v.x + v.y * v.y + v.z * v.z;
+                if (!(len2 > 0.0f)) return fallback;
+                const float inv = 1.0f / std::sqrt(len2);
+                return Vec3(v.x * inv, v.y * inv, v.z * inv);
+            }
+
+            class RaySop : public SopNode
+            {
+            public:
+                explicit RaySop(size_t uid) : SopNode(uid)
+                {
+                    declareParam(Parameter::makeString("direction_mode", "vector"));
+                    declareParam(Parameter::makeVec3  ("direction",      Vec3(0.0f, -1.0f, 0.0f)));
+                    declareParam(Parameter::makeBool  ("reverse",        false));
+                    declareParam(Parameter::makeBool  ("bidirectional",  false));
+                    declareParam(Parameter::makeFloat ("max_distance",   0.0f));
+                    declareParam(Parameter::makeFloat ("bias",           1e-4f));
+                    declareParam(Parameter::makeBool  ("transform",      true));
+                }
+                std::string kind() const override { return "ray"; }
+
+                InputsAndOutputs ports() const override
+                {
+                    InputsAndOutputs io;
+                    io.addInput (PortInfo::createInput ("in",        DataType::Scene3D));
+                    io.addInput (PortInfo::createInput ("collision", DataType::Scene3D));
+                    io.addOutput(PortInfo::createOutput("out",       DataType::Scene3D));
+                    return io;
+                }
+
+                Geometry cook(std::span<const Geometry *const> inputs) const override
+                {
+                    if (inputs.empty() || !inputs[0]) return Geometry{};
+                    Geometry out = *inputs[0];
+                    const size_t n = out.pointCount();
+                    if (inputs.size() < 2 || !inputs[1] || n == 0) return out;
+
+                    const auto blas = acquireGeometryBlas(*inputs[1]);
+
+                    const bool useNormal = paramString("direction_mode", "vector") == "normal";
+                    const float sign = paramBool("reverse", false) ? -1.0f : 1.0f;
+                    const bool bidirectional = paramBool("bidirectional", false);
+                    const bool transform = paramBool("transform", true);
+                    const float maxParam = paramFloat("max_distance", 0.0f);
+                    const float maxDistance = maxParam > 0.0f ? maxParam : std::numeric_limits<float>::infinity();
+                    const float bias = std::max(0.0f, paramFloat("bias", 1e-4f));
+                    const Vec3 fixedDir = normalizedOr(paramVec3("direction", Vec3(0.0f, -1.0f, 0.0f)),
+                                                       Vec3(0.0f, -1.0f, 0.0f));
+
+                    auto &pts = out.points();
+                    const auto *N = useNormal ? std::as_const(pts).get<Vec3>("N") : nullptr;
+                    auto *dist = pts.get<float>("hitdist") ? pts.get<float>("hitdist") : pts.add<float>("hitdist", -1.0f);
+                    auto *prim = pts.get<int>("hitprim") ? pts.get<int>("hitprim") : pts.add<int>("hitprim", -1);
+                    auto *hitN = pts.get<Vec3>("hitN") ? pts.get<Vec3>("hitN") : pts.add<Vec3>("hitN", Vec3(0.0f));
+                    // Fetch every mutable array once, up front: data() bumps
+                    // the attribute generation and must not run per point.
+                    auto &Pd = out.positions();
+                    auto &distd = dist->data();
+                    auto &primd = prim->data();
+                    auto &hitNd = hitN->data();
+                    const std::vector<Vec3> *Nd = N ? &N->data() : nullptr;
+
+                    tracey::parallel_for_chunks(n, [&](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; ++i)
+                        {
+                            const Vec3 p = Pd[i];
+                            Vec3 dir = Nd ? normalizedOr((*Nd)[i], fixedDir) : fixedDir;
+                            dir = dir * sign;
+
+                            auto hit = blas->intersect(p, dir, maxDistance, bias);
+                            if (bidirectional)
+                            {
+                                const float backMax = hit ? hit->t : maxDistance;
+                                if (auto back = blas->intersect(p, -dir, backMax, bias))
+                                {
+                                    if (!hit || back->t < hit->t) hit = back;
+                                }
+                            }
+
+                            if (!hit)
+                            {
+                                distd[i] = -1.0f;
+                                primd[i] = -1;
+                                hitNd[i] = dir;
+                                continue;
+                            }
+                            distd[i] = hit->t;
+                            primd[i] = static_cast<int>(hit->primitiveId);
+                            hitNd[i] = hit->normal;
+                            if (transform) Pd[i] = hit->position;
+                        }
+                    });
+                    return out;
+                }
+            };
+        }  // anon
+
+        void registerRaySop()
+        {
+            SopRegistry::instance().registerType(
+                {"ray", "Ray", "Modifiers",
+                 /*inputs*/  {{"in"}, {"collision"}}, /*outputs*/ {{"out"}},
+                 /*params*/ {
+                     {"direction_mode", ParamType::String, "\"vector\""},
+                     {"direction",      ParamType::Vec3,   "[0, -1, 0]"},
+                     {"reverse",        ParamType::Bool,   "false"},
+                     {"bidirectional",  ParamType::Bool,   "false"},
+                     {"max_distance",   ParamType::Float,  "0.0",    0.0, 100.0, 0.01},
+                     {"bias",           ParamType::Float,  "0.0001", 0.0, 0.1,   0.0001},
+                     {"transform",      ParamType::Bool,   "true"},
+                 }},
+                [](size_t uid) -> std::unique_ptr<SopNode> {
+                    return std::make_unique<RaySop>(uid);
+                });
+        }
+    }
+}
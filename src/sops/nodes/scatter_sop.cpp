@@ -13,10 +13,28 @@
 // uniform-sample [0, total_area) for each point, binary-search the CDF for
 // the chosen triangle, then sample a barycentric coordinate via the
 // classic √u trick (Osada et al. 2002 / Shirley 1992).
+//
+// `mode` = "poisson" replaces the independent samples with a Poisson-disk
+// set: no two points closer than `min_distance`, so coverage is even and
+// far fewer points hide the surface. `count` is ignored; the point count
+// follows from the area and the distance. Parallel dart throwing:
+//
+//   1. Throw ~kPoissonCandidatesPerR2 · area / r² candidates, area-weighted
+//      as above but each drawn from a counter-based hash of (seed, index)
+//      so they can be generated in parallel.
+//   2. Bin them into a 3D grid of cell size r/√3 — one cell can hold at
+//      most one accepted sample — ordered within a cell by a hashed
+//      priority.
+//   3. In pass t, every still-empty cell tries its t-th candidate against
+//      the accepted samples in the surrounding 5³ cells. Cells are split
+//      into 27 phases by (x, y, z) mod 3; two cells of one phase are at
+//      least 2 cells (> r) apart, so a phase runs in parallel without
+//      conflicts, and the result does not depend on thread count.
 
 #include "../sop_node.hpp"
 #include "../sop_registry.hpp"
 
+#include "../../core/parallel.hpp"
 #include "../../geometry/geometry.hpp"
 #include "../../geometry/attribute.hpp"
 #include "../../geometry/attribute_table.hpp"
@@ -24,6 +42,8 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -57,6 +77,192 @@ namespace tracey
                 }
             };
 
+            struct Tri { uint32_t a, b, c; Vec3 n; };
+
+            // Counter-based hash (lowbias32 over a mixed key): the random
+            // stream for candidate i is a pure function of (seed, i, k),
+            // whichever thread draws it.
+            uint32_t hash32(uint32_t x)
+            {
+                x ^= x >> 16;
+                x *= 0x7feb352du;
+                x ^= x >> 15;
+                x *= 0x846ca68bu;
+                x ^= x >> 16;
+                return x;
+            }
+            float hashFloat(uint32_t seed, uint32_t i, uint32_t k)
+            {
+                const uint32_t h = hash32(hash32(seed ^ hash32(i)) + k * 0x9E3779B9u);
+                return (h >> 8) * (1.0f / 16777216.0f);
+            }
+
+            // Candidates thrown per r² of surface area. A cell (side r/√3)
+            // crossed by the surface then sees ~7 candidates — enough
+            // trials that few cells that could hold a point end up empty.
+            constexpr float kPoissonCandidatesPerR2 = 20.0f;
+            constexpr size_t kMaxPoissonCandidates = size_t(1) << 23;
+
+            Geometry scatterPoisson(const std::vector<Tri> &tris, const std::vector<float> &cdf,
+                                    float total, const std::vector<Vec3> &posIn,
+                                    float minDistance, uint32_t seed)
+            {
+                const double wanted = std::ceil(kPoissonCandidatesPerR2 * total /
+                                                (double(minDistance) * minDistance));
+                size_t nc = static_cast<size_t>(std::min<double>(wanted, kMaxPoissonCandidates));
+                if (wanted > kMaxPoissonCandidates)
+                    std::fprintf(stderr,
+                        "[scatter] min_distance %g is too small for this surface; "
+                        "capping at %zu candidates (coverage will be sparse)\n",
+                        minDistance, kMaxPoissonCandidates);
+                nc = std::max<size_t>(nc, 1);
+
+                // ── 1. Candidates ──
+                std::vector<Vec3> cp(nc);
+                std::vector<uint32_t> ctri(nc);
+                tracey::parallel_for_chunks(nc, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const uint32_t ci = static_cast<uint32_t>(i);
+                        const float u = hashFloat(seed, ci, 0) * total;
+                        const auto it = std::upper_bound(cdf.begin(), cdf.end(), u);
+                        size_t idx = static_cast<size_t>(it - cdf.begin());
+                        if (idx >= tris.size()) idx = tris.size() - 1;
+                        const Tri &t = tris[idx];
+                        const float sqrtR1 = std::sqrt(hashFloat(seed, ci, 1));
+                        const float r2 = hashFloat(seed, ci, 2);
+                        const float b0 = 1.0f - sqrtR1;
+                        const float b1 = sqrtR1 * (1.0f - r2);
+                        const float b2 = sqrtR1 * r2;
+                        const Vec3 &pa = posIn[t.a];
+                        const Vec3 &pb = posIn[t.b];
+                        const Vec3 &pc = posIn[t.c];
+                        cp[i] = Vec3(b0 * pa.x + b1 * pb.x + b2 * pc.x,
+                                     b0 * pa.y + b1 * pb.y + b2 * pc.y,
+                                     b0 * pa.z + b1 * pb.z + b2 * pc.z);
+                        ctri[i] = static_cast<uint32_t>(idx);
+                    }
+                });
+
+                // ── 2. Grid ──
+                Vec3 lo(std::numeric_limits<float>::max());
+                for (const Vec3 &p : cp) lo = Vec3(std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z));
+                const float cell = minDistance / std::sqrt(3.0f);
+                const float invCell = 1.0f / cell;
+                // 21 bits per axis in the packed key; a surface more than
+                // ~2M cells across is far past the candidate cap anyway.
+                constexpr uint32_t kAxisMax = (1u << 21) - 1;
+                auto cellOf = [&](const Vec3 &p, int axis) {
+                    const float f = (p[axis] - lo[axis]) * invCell;
+                    return std::min(static_cast<uint32_t>(std::max(f, 0.0f)), kAxisMax);
+                };
+                auto pack = [](uint32_t x, uint32_t y, uint32_t z) {
+                    return (uint64_t(x) << 42) | (uint64_t(y) << 21) | uint64_t(z);
+                };
+
+                struct Cand { uint64_t key; uint32_t priority; uint32_t index; };
+                std::vector<Cand> order(nc);
+                tracey::parallel_for_chunks(nc, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const Vec3 &p = cp[i];
+                        order[i] = {pack(cellOf(p, 0), cellOf(p, 1), cellOf(p, 2)),
+                                    hash32(static_cast<uint32_t>(i) ^ hash32(seed + 0x5bd1e995u)),
+                                    static_cast<uint32_t>(i)};
+                    }
+                });
+                std::sort(order.begin(), order.end(), [](const Cand &a, const Cand &b) {
+                    if (a.key != b.key) return a.key < b.key;
+                    if (a.priority != b.priority) return a.priority < b.priority;
+                    return a.index < b.index;
+                });
+
+                std::vector<uint64_t> cellKey;
+                std::vector<uint32_t> cellStart;
+                for (size_t i = 0; i < nc; ++i)
+                {
+                    if (i == 0 || order[i].key != order[i - 1].key)
+                    {
+                        cellKey.push_back(order[i].key);
+                        cellStart.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+                const size_t cells = cellKey.size();
+                cellStart.push_back(static_cast<uint32_t>(nc));
+
+                std::vector<uint32_t> phaseCells[27];
+                uint32_t maxTrials = 0;
+                for (size_t c = 0; c < cells; ++c)
+                {
+                    const uint64_t k = cellKey[c];
+                    const uint32_t x = uint32_t(k >> 42), y = uint32_t(k >> 21) & kAxisMax, z = uint32_t(k) & kAxisMax;
+                    phaseCells[(x % 3) * 9 + (y % 3) * 3 + (z % 3)].push_back(static_cast<uint32_t>(c));
+                    maxTrials = std::max(maxTrials, cellStart[c + 1] - cellStart[c]);
+                }
+
+                // ── 3. Dart throwing ──
+                constexpr uint32_t kEmpty = 0xffffffffu;
+                std::vector<uint32_t> accepted(cells, kEmpty); // candidate index per cell
+                const float r2 = minDistance * minDistance;
+                auto findCell = [&](uint64_t key) -> int64_t {
+                    const auto it = std::lower_bound(cellKey.begin(), cellKey.end(), key);
+                    return (it != cellKey.end() && *it == key) ? int64_t(it - cellKey.begin()) : -1;
+                };
+                for (uint32_t t = 0; t < maxTrials; ++t)
+                {
+                    for (const auto &list : phaseCells)
+                    {
+                        tracey::parallel_for_chunks(list.size(), [&](size_t begin, size_t end) {
+                            for (size_t li = begin; li < end; ++li)
+                            {
+                                const uint32_t c = list[li];
+                                if (accepted[c] != kEmpty || cellStart[c] + t >= cellStart[c + 1]) continue;
+                                const uint32_t cand = order[cellStart[c] + t].index;
+                                const Vec3 &p = cp[cand];
+                                const uint64_t k = cellKey[c];
+                                const int64_t x = int64_t(k >> 42), y = int64_t((k >> 21) & kAxisMax), z = int64_t(k & kAxisMax);
+                                bool ok = true;
+                                for (int64_t dx = -2; ok && dx <= 2; ++dx)
+                                    for (int64_t dy = -2; ok && dy <= 2; ++dy)
+                                        for (int64_t dz = -2; ok && dz <= 2; ++dz)
+                                        {
+                                            const int64_t nx = x + dx, ny = y + dy, nz = z + dz;
+                                            if (nx < 0 || ny < 0 || nz < 0 ||
+                                                nx > kAxisMax || ny > kAxisMax || nz > kAxisMax) continue;
+                                            const int64_t nc2 = findCell(pack(uint32_t(nx), uint32_t(ny), uint32_t(nz)));
+                                            if (nc2 < 0 || accepted[nc2] == kEmpty) continue;
+                                            const Vec3 &q = cp[accepted[nc2]];
+                                            const float ex = p.x - q.x, ey = p.y - q.y, ez = p.z - q.z;
+                                            ok = ex * ex + ey * ey + ez * ez >= r2;
+                                        }
+                                if (ok) accepted[c] = cand;
+                            }
+                        }, 256);
+                    }
+                }
+
+                // Output in cell order: deterministic and spatially coherent.
+                size_t count = 0;
+                for (uint32_t a : accepted) count += a != kEmpty ? 1 : 0;
+                Geometry out;
+                auto &pts = out.points();
+                auto *P  = pts.add<Vec3>("P",  Vec3(0.0f));
+                auto *N  = pts.add<Vec3>("N",  Vec3(0.0f, 1.0f, 0.0f));
+                pts.add<float>("pscale", 1.0f);
+                out.resizePoints(count);
+                auto &Pd = P->data();
+                auto &Nd = N->data();
+                size_t o = 0;
+                for (uint32_t a : accepted)
+                {
+                    if (a == kEmpty) continue;
+                    Pd[o] = cp[a];
+                    Nd[o] = tris[ctri[a]].n;
+                    ++o;
+                }
+                return out;
+            }
+
             class ScatterSop : public SopNode
             {
             public:
@@ -64,6 +270,8 @@ namespace tracey
                 {
                     declareParam(Parameter::makeInt("count", 100));
                     declareParam(Parameter::makeInt("seed", 0));
+                    declareParam(Parameter::makeString("mode", "random"));
+                    declareParam(Parameter::makeFloat("min_distance", 0.1f));
                 }
 
                 std::string kind() const override { return "scatter"; }
@@ -89,7 +297,6 @@ namespace tracey
                     const auto &v2p   = in.vertexToPoint();
                     const auto &posIn = in.positions();
 
-                    struct Tri { uint32_t a, b, c; Vec3 n; };
                     std::vector<Tri> tris;
                     std::vector<float> cdf;
                     tris.reserve(prims.size());
@@ -139,6 +346,14 @@ namespace tracey
 
                     if (tris.empty() || total <= 0.0f) return {};
 
+                    if (paramString("mode", "random") == "poisson")
+                    {
+                        const float minDistance = paramFloat("min_distance", 0.1f);
+                        if (minDistance > 0.0f)
+                            return scatterPoisson(tris, cdf, total, posIn, minDistance,
+                                                  static_cast<uint32_t>(seedParam));
+                    }
+
                     XorShift32 rng(static_cast<uint32_t>(seedParam) * 0x9E3779B1u +
                                    0xDEADBEEFu);
 
@@ -193,6 +408,8 @@ namespace tracey
                  /*params*/ {
                      {"count", ParamType::Int, "100"},
                      {"seed",  ParamType::Int, "0"},
+                     {"mode",  ParamType::String, "\"random\""},
+                     {"min_distance", ParamType::Float, "0.1", 0.001, 2.0, 0.001},
                  }},
                 [](size_t uid) -> std::unique_ptr<SopNode> {
                     return std::make_unique<ScatterSop>(uid);
@@ -112,11 +112,11 @@ namespace tracey
                         }
                     };
 
-                    runGpuOrCpu(out.points().get<Vec3>("P"), Mpos,
+                    runGpuOrCpu(out.points().get(kAttrP), Mpos,
                                 codegen::TransformCompute::Mode::Position, false);
-                    runGpuOrCpu(out.points().get<Vec3>("N"), Mn,
+                    runGpuOrCpu(out.points().get(kAttrN), Mn,
                                 codegen::TransformCompute::Mode::Normal, true);
-                    runGpuOrCpu(out.vertices().get<Vec3>("N"), Mn,
+                    runGpuOrCpu(out.vertices().get(kAttrN), Mn,
                                 codegen::TransformCompute::Mode::Normal, true);
                     return out;
                 }
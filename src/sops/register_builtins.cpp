@@ -27,6 +27,8 @@ namespace tracey
         void registerSwitchSop();
         void registerBoundSop();
         void registerSortSop();
+        void registerPointRelaxSop();
+        void registerRaySop();
         void registerPlainEffectorSop();
         void registerRandomEffectorSop();
         void registerNoiseEffectorSop();
@@ -60,6 +62,8 @@ namespace tracey
             registerDeleteSop();
             registerSwitchSop();
             registerSortSop();
+            registerPointRelaxSop();
+            registerRaySop();
             registerBoundSop();
             registerPlainEffectorSop();
             registerRandomEffectorSop();
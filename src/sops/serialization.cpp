@@ -1,4 +1,5 @@
 #include "serialization.hpp"
+#include "cook_cache.hpp"
 #include "sop_registry.hpp"
 
 #include "json.hpp"  // nlohmann/json (bundled via deps/tinygltf)
@@ -113,9 +114,11 @@ namespace tracey
                 return out;
             }
 
-            void applyParamFromJson(SopNode &node, const std::string &name, const json &j)
+            // Returns true when the value was written (the parameter exists
+            // and the JSON type matched).
+            bool applyParamFromJson(SopNode &node, const std::string &name, const json &j)
             {
-                if (!j.contains("type") || !j.contains("value")) return;
+                if (!j.contains("type") || !j.contains("value")) return false;
                 const std::string t = j.at("type").get<std::string>();
                 const auto &v = j.at("value");
                 bool ok = false;
@@ -149,15 +152,15 @@ namespace tracey
                 // graph and the current node definition shouldn't crash; the
                 // node's declared default stays in place.
 
-                if (!ok) return;
-                if (!j.contains("channels") || !j["channels"].is_array()) return;
+                if (!ok) return false;
+                if (!j.contains("channels") || !j["channels"].is_array()) return true;
 
                 // Channels are optional. Find the parameter we just wrote to
                 // and drop any restored channels onto it.
                 Parameter *p = nullptr;
                 for (auto &q : node.parameters())
                     if (q.name == name) { p = &q; break; }
-                if (!p) return;
+                if (!p) return true;
 
                 const auto &chArr = j["channels"];
                 p->channels.clear();
@@ -167,6 +170,7 @@ namespace tracey
                     if (cj.is_null()) p->channels.emplace_back();
                     else              p->channels.push_back(channelFromJson(cj));
                 }
+                return true;
             }
 
             json graphToJson(const SopGraph &graph);  // forward decl for recursion
@@ -263,6 +267,56 @@ namespace tracey
 
         namespace
         {
+            std::unique_ptr<SopGraph> buildGraphFromJson(const json &root);  // forward decl for recursion
+
+            // Build one node from its JSON object (see the schema in the
+            // header). Shared by graph loads and the add/replace_node patch
+            // ops so both produce identical nodes.
+            std::unique_ptr<SopNode> buildNodeFromJson(const json &nj)
+            {
+                const std::string kind = nj.at("kind").get<std::string>();
+                const size_t uid = nj.at("uid").get<size_t>();
+                auto node = SopRegistry::instance().create(kind, uid);
+                if (!node)
+                    throw std::runtime_error("deserializeSopGraph: unknown node kind '" + kind + "'");
+
+                if (nj.contains("pos") && nj["pos"].is_array() && nj["pos"].size() == 2)
+                {
+                    node->setPos(nj["pos"][0].get<float>(), nj["pos"][1].get<float>());
+                }
+                node->setBypass(nj.value("bypass", false));
+                // Apply "extra" BEFORE "params": attribute_vop's
+                // extra block carries the promotion list, and each
+                // promotion needs to (re-)declare its host param
+                // slot on a freshly-built node before the params
+                // block can fill values. Without this ordering,
+                // applyParamFromJson's setParamFloat silently no-ops
+                // for promoted params (the slot doesn't exist yet)
+                // and slider edits never round-trip.
+                if (nj.contains("extra"))
+                {
+                    node->deserializeExtraJson(nj["extra"].dump());
+                }
+                if (nj.contains("params") && nj["params"].is_object())
+                {
+                    for (auto it = nj["params"].begin(); it != nj["params"].end(); ++it)
+                    {
+                        applyParamFromJson(*node, it.key(), it.value());
+                    }
+                }
+                // Recurse into nested subgraphs (subnet nodes carry an
+                // inner SopGraph). We attach the inner graph here but
+                // don't wire setRoot until the whole tree is built —
+                // the root pointer is the *outermost* SopGraph, which
+                // doesn't exist yet during this depth-first walk.
+                if (nj.contains("subgraph") && nj["subgraph"].is_object())
+                {
+                    auto inner = buildGraphFromJson(nj["subgraph"]);
+                    node->setInnerGraph(std::move(inner));
+                }
+                return node;
+            }
+
             // Build a SopGraph from an already-parsed JSON object. Used both
             // for the top-level entry point (deserializeSopGraph) and the
             // recursive subgraph case below — the schema is identical at both
@@ -282,47 +336,7 @@ namespace tracey
                 {
                     for (const auto &nj : root["nodes"])
                     {
-                        const std::string kind = nj.at("kind").get<std::string>();
-                        const size_t uid = nj.at("uid").get<size_t>();
-                        auto node = SopRegistry::instance().create(kind, uid);
-                        if (!node)
-                            throw std::runtime_error("deserializeSopGraph: unknown node kind '" + kind + "'");
-
-                        if (nj.contains("pos") && nj["pos"].is_array() && nj["pos"].size() == 2)
-                        {
-                            node->setPos(nj["pos"][0].get<float>(), nj["pos"][1].get<float>());
-                        }
-                        node->setBypass(nj.value("bypass", false));
-                        // Apply "extra" BEFORE "params": attribute_vop's
-                        // extra block carries the promotion list, and each
-                        // promotion needs to (re-)declare its host param
-                        // slot on a freshly-built node before the params
-                        // block can fill values. Without this ordering,
-                        // applyParamFromJson's setParamFloat silently no-ops
-                        // for promoted params (the slot doesn't exist yet)
-                        // and slider edits never round-trip.
-                        if (nj.contains("extra"))
-                        {
-                            node->deserializeExtraJson(nj["extra"].dump());
-                        }
-                        if (nj.contains("params") && nj["params"].is_object())
-                        {
-                            for (auto it = nj["params"].begin(); it != nj["params"].end(); ++it)
-                            {
-                                applyParamFromJson(*node, it.key(), it.value());
-                            }
-                        }
-                        // Recurse into nested subgraphs (subnet nodes carry an
-                        // inner SopGraph). We attach the inner graph here but
-                        // don't wire setRoot until the whole tree is built —
-                        // the root pointer is the *outermost* SopGraph, which
-                        // doesn't exist yet during this depth-first walk.
-                        if (nj.contains("subgraph") && nj["subgraph"].is_object())
-                        {
-                            auto inner = buildGraphFromJson(nj["subgraph"]);
-                            node->setInnerGraph(std::move(inner));
-                        }
-                        graph->addNode(std::move(node));
+                        graph->addNode(buildNodeFromJson(nj));
                     }
                 }
 
@@ -386,5 +400,173 @@ namespace tracey
 
             return graph;
         }
+
+        // ── Incremental patches ────────────────────────────────────────────
+        namespace
+        {
+            // Graph (root or any nested subnet graph) that directly owns
+            // `uid`, or nullptr.
+            SopGraph *findOwner(SopGraph &graph, size_t uid)
+            {
+                if (graph.findNode(uid)) return &graph;
+                for (const auto &n : graph.nodes())
+                {
+                    auto *sn = dynamic_cast<SopNode *>(n.get());
+                    if (!sn || !sn->innerGraph()) continue;
+                    if (SopGraph *owner = findOwner(*sn->innerGraph(), uid)) return owner;
+                }
+                return nullptr;
+            }
+
+            SopNode &requireNode(SopGraph &root, const json &op, const char *key)
+            {
+                const size_t uid = op.at(key).get<size_t>();
+                SopGraph *owner = findOwner(root, uid);
+                if (!owner)
+                    throw std::runtime_error("applySopGraphPatch: no node with uid "
+                        + std::to_string(uid));
+                return *owner->findNode(uid);
+            }
+
+            // Drop the cache entries of `node` and of everything nested in
+            // its subnet graph.
+            void eraseCached(CookCache *cache, const SopNode &node)
+            {
+                if (!cache) return;
+                cache->erase(node.uid());
+                if (const SopGraph *inner = node.innerGraph())
+                {
+                    for (const auto &n : inner->nodes())
+                        if (auto *sn = dynamic_cast<const SopNode *>(n.get())) eraseCached(cache, *sn);
+                }
+            }
+
+            // Hook a freshly built node's subnet tree into the root uid
+            // allocator and keep nextUid past every uid now in the tree —
+            // the same fix-up deserializeSopGraph does after a full load.
+            void adoptSubtree(SopGraph &root, SopNode &node)
+            {
+                size_t maxUid = 0;
+                if (SopGraph *inner = node.innerGraph())
+                    wireRootAndCollectMaxUid(&root, inner, maxUid);
+                wireRootAndCollectMaxUid(&root, &root, maxUid);
+                root.setNextUid(std::max<size_t>(maxUid + 1, root.maxNodeUid() + 1));
+            }
+
+            Connection connectionFromJson(const json &op)
+            {
+                return {op.at("from_node").get<size_t>(), op.at("from_port").get<size_t>(),
+                        op.at("to_node").get<size_t>(), op.at("to_port").get<size_t>()};
+            }
+
+            void applyOp(SopGraph &root, const json &op, CookCache *cache)
+            {
+                const std::string kind = op.at("op").get<std::string>();
+                if (kind == "set_param")
+                {
+                    SopNode &node = requireNode(root, op, "node");
+                    const std::string name = op.at("name").get<std::string>();
+                    const json &pj = op.at("param");
+                    // A full reload starts every parameter without channels,
+                    // so a value-only set has to drop stale keys to match.
+                    if (applyParamFromJson(node, name, pj) && !pj.contains("channels"))
+                    {
+                        for (auto &p : node.parameters())
+                            if (p.name == name) { p.channels.clear(); break; }
+                    }
+                    if (cache) cache->markDirty(node.uid());
+                }
+                else if (kind == "set_bypass")
+                {
+                    SopNode &node = requireNode(root, op, "node");
+                    node.setBypass(op.at("bypass").get<bool>());
+                    if (cache) cache->markDirty(node.uid());
+                }
+                else if (kind == "set_pos")
+                {
+                    SopNode &node = requireNode(root, op, "node");
+                    const json &pos = op.at("pos");
+                    node.setPos(pos.at(0).get<float>(), pos.at(1).get<float>());
+                }
+                else if (kind == "add_node")
+                {
+                    const size_t parentUid = op.value<size_t>("parent", 0);
+                    SopGraph *target = &root;
+                    if (parentUid != 0)
+                    {
+                        target = requireNode(root, op, "parent").innerGraph();
+                        if (!target)
+                            throw std::runtime_error("applySopGraphPatch: node "
+                                + std::to_string(parentUid) + " has no subgraph");
+                    }
+                    auto node = buildNodeFromJson(op.at("node"));
+                    if (findOwner(root, node->uid()))
+                        throw std::runtime_error("applySopGraphPatch: uid "
+                            + std::to_string(node->uid()) + " already in use");
+                    SopNode &added = *node;
+                    target->addNode(std::move(node));
+                    adoptSubtree(root, added);
+                }
+                else if (kind == "replace_node")
+                {
+                    auto node = buildNodeFromJson(op.at("node"));
+                    SopGraph *owner = findOwner(root, node->uid());
+                    if (!owner)
+                        throw std::runtime_error("applySopGraphPatch: no node with uid "
+                            + std::to_string(node->uid()));
+                    eraseCached(cache, *owner->findNode(node->uid()));
+                    SopNode &added = *node;
+                    owner->replaceNode(std::move(node));
+                    adoptSubtree(root, added);
+                }
+                else if (kind == "remove_node")
+                {
+                    SopNode &node = requireNode(root, op, "node");
+                    eraseCached(cache, node);
+                    SopGraph *owner = findOwner(root, node.uid());
+                    // Consumers lose an input; their cached outputs are stale.
+                    for (const auto &c : owner->connections())
+                        if (c.fromNode == node.uid() && cache) cache->markDirty(c.toNode);
+                    owner->removeNode(node.uid());
+                }
+                else if (kind == "connect" || kind == "disconnect")
+                {
+                    const Connection c = connectionFromJson(op);
+                    SopGraph *owner = findOwner(root, c.toNode);
+                    if (!owner || !owner->findNode(c.fromNode))
+                        throw std::runtime_error("applySopGraphPatch: " + kind
+                            + " endpoints must be nodes of the same graph");
+                    if (kind == "connect")
+                    {
+                        // An input port has one source; replace any existing.
+                        if (auto prev = owner->incomingTo(c.toNode, c.toPort))
+                            owner->removeConnection({prev->first, prev->second, c.toNode, c.toPort});
+                        owner->addConnection(c);
+                    }
+                    else if (!owner->removeConnection(c))
+                    {
+                        throw std::runtime_error("applySopGraphPatch: no such connection to node "
+                            + std::to_string(c.toNode));
+                    }
+                    if (cache) cache->markDirty(c.toNode);
+                }
+                else
+                {
+                    throw std::runtime_error("applySopGraphPatch: unknown op '" + kind + "'");
+                }
+            }
+        } // anon
+
+        void applySopGraphPatch(SopGraph &graph, const std::string &patchJson, CookCache *cache)
+        {
+            json root = json::parse(patchJson, /*cb=*/nullptr, /*allow_exceptions=*/true);
+            const int version = root.value("version", 1);
+            if (version != 1)
+                throw std::runtime_error("applySopGraphPatch: unsupported version "
+                    + std::to_string(version));
+            if (!root.contains("ops") || !root["ops"].is_array())
+                throw std::runtime_error("applySopGraphPatch: missing 'ops' array");
+            for (const auto &op : root["ops"]) applyOp(graph, op, cache);
+        }
     }
 }
@@ -9,6 +9,8 @@ namespace tracey
 {
     namespace sops
     {
+        class CookCache;
+
         // JSON serialization for SopGraph. Public API takes/returns std::string
         // so consumers don't pull in nlohmann::json transitively.
         //
@@ -60,5 +62,45 @@ namespace tracey
         // Throws std::runtime_error on bad JSON / unknown node kinds / missing
         // required fields.
         std::unique_ptr<SopGraph> deserializeSopGraph(const std::string &jsonText);
+
+        // Incremental edit of a live graph, so a slider drag doesn't pay for
+        // a whole-graph deserialize per step. Nodes are addressed by uid
+        // alone (uids are unique across subnet nesting); node / param
+        // payloads use the same schema as above.
+        //
+        //   {
+        //     "version": 1,
+        //     "ops": [
+        //       {"op": "set_param",    "node": 2, "name": "translate",
+        //                              "param": {"type": "vec3", "value": [1, 0, 0]}},
+        //       {"op": "set_bypass",   "node": 2, "bypass": true},
+        //       {"op": "set_pos",      "node": 2, "pos": [10.0, 40.0]},
+        //       {"op": "add_node",     "parent": 0, "node": { ...node... }},
+        //       {"op": "replace_node", "node": { ...node... }},
+        //       {"op": "remove_node",  "node": 3},
+        //       {"op": "connect",      "from_node": 1, "from_port": 0, "to_node": 2, "to_port": 0},
+        //       {"op": "disconnect",   "from_node": 1, "from_port": 0, "to_node": 2, "to_port": 0}
+        //     ]
+        //   }
+        //
+        // `parent` is the uid of the subnet whose inner graph receives the
+        // node (0 = this graph). A set_param without `channels` clears any
+        // keyframes, matching what a full reload of the same JSON yields.
+        // `connect` replaces whatever already feeds the target input port;
+        // connect/disconnect act on the graph that owns `to_node`.
+        // `replace_node` rebuilds a node in place (kind, extra state, inner
+        // subgraph) and keeps its connections.
+        //
+        // Applying a patch leaves `graph` identical to deserializing the
+        // JSON of the edited graph. With a non-null `cache`, entries of the
+        // touched nodes are marked dirty (removed / replaced nodes and their
+        // subnet contents are erased); everything else keeps its cached
+        // output. Position-only ops touch nothing.
+        //
+        // Throws std::runtime_error on malformed ops or unknown uids. Ops
+        // before the failing one stay applied — callers should fall back to
+        // a full deserializeSopGraph.
+        void applySopGraphPatch(SopGraph &graph, const std::string &patchJson,
+                                CookCache *cache = nullptr);
     }
 }
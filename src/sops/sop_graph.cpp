@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <iterator>
 #include <unordered_set>
 
 namespace tracey
@@ -153,6 +154,10 @@ namespace tracey
             // directly, so we don't write anything into m_cache.
             if (!cache) invalidate();
 
+            // Cook-scoped attribute recycling (see AttributePool). Subnet
+            // recursion re-installs the same pool.
+            AttributePool::Scope poolScope(cache ? &cache->pool() : nullptr);
+
             bool cycle = false;
             auto order = topoSort(*this, &cycle);
             if (cycle)
@@ -173,8 +178,9 @@ namespace tracey
                 // Per-input src uid + port index + upstream cookId, used to
                 // build this node's cache key. Upstream cookId stays stable
                 // across cache hits, so a clean subtree produces a constant
-                // key and the chain short-circuits all the way down.
-                std::vector<std::tuple<size_t, uint32_t, uint64_t>> inputSrcs;
+                // key and the chain short-circuits all the way down. The
+                // upstream editKey rides along for this node's own editKey.
+                std::vector<std::tuple<size_t, uint32_t, uint64_t, uint64_t>> inputSrcs;
                 inputSrcs.reserve(ports.inputs().size());
                 bool anyUpstreamTimeDep = false;
                 for (size_t i = 0; i < ports.inputs().size(); ++i)
@@ -183,7 +189,7 @@ namespace tracey
                     if (!src.has_value())
                     {
                         inputs.push_back(nullptr);
-                        inputSrcs.emplace_back(0u, 0u, 0u);
+                        inputSrcs.emplace_back(0u, 0u, 0u, 0u);
                         continue;
                     }
                     if (cache)
@@ -192,20 +198,20 @@ namespace tracey
                         if (up && up->valid)
                         {
                             inputs.push_back(&up->output);
-                            inputSrcs.emplace_back(src->first, src->second, up->cookId);
+                            inputSrcs.emplace_back(src->first, src->second, up->cookId, up->editKey);
                             if (up->timeDependent) anyUpstreamTimeDep = true;
                         }
                         else
                         {
                             inputs.push_back(nullptr);
-                            inputSrcs.emplace_back(src->first, src->second, 0u);
+                            inputSrcs.emplace_back(src->first, src->second, 0u, 0u);
                         }
                     }
                     else
                     {
                         auto it = m_cache.find(src->first);
                         inputs.push_back(it == m_cache.end() ? nullptr : &it->second);
-                        inputSrcs.emplace_back(src->first, src->second, 0u);
+                        inputSrcs.emplace_back(src->first, src->second, 0u, 0u);
                     }
                 }
 
@@ -220,18 +226,20 @@ namespace tracey
                 // Compute this node's input key. Mixed with FNV-1a so the
                 // composition stays explicit and predictable.
                 uint64_t inputKey = 0;
+                uint64_t editKey = 0;
                 if (cache)
                 {
                     constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
                     constexpr uint64_t kFnvPrime  = 0x00000100000001b3ULL;
-                    auto mix = [&](const void *p, size_t n) {
+                    auto mixInto = [&](uint64_t &h, const void *p, size_t n) {
                         const auto *b = static_cast<const unsigned char *>(p);
                         for (size_t i = 0; i < n; ++i)
                         {
-                            inputKey ^= b[i];
-                            inputKey *= kFnvPrime;
+                            h ^= b[i];
+                            h *= kFnvPrime;
                         }
                     };
+                    auto mix = [&](const void *p, size_t n) { mixInto(inputKey, p, n); };
                     inputKey = kFnvOffset;
                     const std::string k = node->kind();
                     mix(k.data(), k.size());
@@ -245,13 +253,29 @@ namespace tracey
                     // silently reuse the previous Geometry.
                     const std::string extra = node->serializeExtraJson();
                     if (!extra.empty()) mix(extra.data(), extra.size());
-                    for (const auto &[srcUid, srcPort, srcCookId] : inputSrcs)
+                    for (const auto &[srcUid, srcPort, srcCookId, srcEditKey] : inputSrcs)
                     {
                         mix(&srcUid, sizeof(srcUid));
                         mix(&srcPort, sizeof(srcPort));
                         mix(&srcCookId, sizeof(srcCookId));
                     }
                     if (timeDep) mix(&time, sizeof(time));
+
+                    // editKey: the same recipe without time, chaining
+                    // upstream editKeys instead of cookIds, plus the bypass
+                    // flag. Constant while only the playhead moves.
+                    editKey = kFnvOffset;
+                    mixInto(editKey, k.data(), k.size());
+                    mixInto(editKey, &ph, sizeof(ph));
+                    if (!extra.empty()) mixInto(editKey, extra.data(), extra.size());
+                    const uint8_t bypassed = node->bypass() ? 1 : 0;
+                    mixInto(editKey, &bypassed, sizeof(bypassed));
+                    for (const auto &[srcUid, srcPort, srcCookId, srcEditKey] : inputSrcs)
+                    {
+                        mixInto(editKey, &srcUid, sizeof(srcUid));
+                        mixInto(editKey, &srcPort, sizeof(srcPort));
+                        mixInto(editKey, &srcEditKey, sizeof(srcEditKey));
+                    }
                 }
 
                 // Cache lookup: hit when the key matches what produced the
@@ -261,12 +285,15 @@ namespace tracey
 
                 const Geometry *outputPtr = nullptr;
                 const auto tStart = std::chrono::steady_clock::now();
+                const AttributePool::Stats poolStart =
+                    cache ? cache->pool().stats() : AttributePool::Stats{};
                 if (cacheHit)
                 {
                     // Refresh time-dependence in case the rule changed (e.g.
                     // upstream became time-dep but this node was previously
                     // cached as static). Then reuse the cached output.
                     entry->timeDependent = timeDep;
+                    entry->editKey = editKey;
                     outputPtr = &entry->output;
                 }
                 else
@@ -298,8 +325,9 @@ namespace tracey
                     }
                     if (cache)
                     {
-                        entry->cookId++;
+                        entry->cookId = cache->nextCookId();
                         entry->inputKey = inputKey;
+                        entry->editKey = editKey;
                         entry->timeDependent = timeDep;
                         entry->valid = true;
                         entry->output = std::move(result);
@@ -320,6 +348,14 @@ namespace tracey
                     nct.kind          = node->kind();
                     nct.name          = node->paramString("name", "");
                     nct.ms = std::chrono::duration<double, std::milli>(tEnd - tStart).count();
+                    if (cache)
+                    {
+                        const AttributePool::Stats &poolEnd = cache->pool().stats();
+                        nct.allocations    = poolEnd.allocations - poolStart.allocations;
+                        nct.reused         = poolEnd.reused - poolStart.reused;
+                        nct.bytesAllocated = poolEnd.bytesAllocated - poolStart.bytesAllocated;
+                        nct.bytesReused    = poolEnd.bytesReused - poolStart.bytesReused;
+                    }
                     timings->push_back(std::move(nct));
                 }
                 // Object_output / light terminals consume inputs[0] below;
@@ -398,36 +434,36 @@ namespace tracey
                     // onto ONE SceneObject + BLAS, so the path tracer ends
                     // up with N TLAS instances pointing at one BVH instead
                     // of N flat-baked copies of the vertex data.
+                    //
+                    // Nested instancing: when the stamp comes from a
+                    // copy_to_points with pack_instances on, that node baked
+                    // nothing. Walk back through the chain of packed copies
+                    // instead, taking each one's template as an instance-
+                    // group level (innermost first, see
+                    // EmittedActor::groupLevels) and the first unpacked
+                    // stamp as the geometry.
                     const Geometry *stamp = inputs.size() > 0 ? inputs[0] : nullptr;
                     const Geometry *tmpl  = inputs.size() > 1 ? inputs[1] : nullptr;
-                    if (stamp && tmpl)
-                    {
-                        const auto &tplP  = tmpl->positions();
-                        const auto *tplPs = tmpl->points().get<float>("pscale");
-                        const auto *tplN  = tmpl->points().get<Vec3>("N");
-                        const auto *tplCd = tmpl->points().get<Vec3>("Cd");
-                        const auto *tplOrient = tmpl->points().get<Vec4>("orient");
-                        const bool useN   = node->paramBool("orient_to_normal", true);
-                        const std::string baseName =
-                            node->paramString("name", "instance_" + std::to_string(uid));
-
-                        // Emit ONE EmittedActor with N per-instance entries.
-                        // apply_emitted turns this into a single Scene Actor
-                        // whose `instances()` list grows to N SceneInstances
-                        // — each with its own per-instance TRS and tint. The
-                        // win over the old "N EmittedActors" model is that
-                        // the same Actor stays alive across cooks and
-                        // particle birth/death is just an in-place resize +
-                        // overwrite of the array, not 3000 Actor allocations.
-                        EmittedActor a;
-                        a.sourceNodeUid = uid;
-                        a.instanceIndex = 0;
-                        a.name          = baseName;
-                        a.geometry      = std::make_shared<const Geometry>(*stamp);
-                        a.materialLibraryName =
-                            node->paramString("material_library_name", "");
-                        a.instances.reserve(tplP.size());
 
+                    const auto outputOf = [&](size_t srcUid) -> const Geometry * {
+                        if (cache)
+                        {
+                            auto *up = cache->find(srcUid);
+                            return up && up->valid ? &up->output : nullptr;
+                        }
+                        auto it = m_cache.find(srcUid);
+                        return it == m_cache.end() ? nullptr : &it->second;
+                    };
+                    // One entry per template point: P, pscale, then orient
+                    // (wins) or the N-derived frame, plus Cd as the tint.
+                    const auto entriesFrom = [](const Geometry &t, bool useN) {
+                        const auto &tplP  = t.positions();
+                        const auto *tplPs = t.points().get<float>("pscale");
+                        const auto *tplN  = t.points().get<Vec3>("N");
+                        const auto *tplCd = t.points().get<Vec3>("Cd");
+                        const auto *tplOrient = t.points().get<Vec4>("orient");
+                        std::vector<EmittedActor::InstanceEntry> entries;
+                        entries.reserve(tplP.size());
                         for (size_t i = 0; i < tplP.size(); ++i)
                         {
                             EmittedActor::InstanceEntry e;
@@ -457,8 +493,57 @@ namespace tracey
                                 const glm::quat q = glm::quat_cast(R);
                                 e.rotation = Vec4(q.w, q.x, q.y, q.z);
                             }
-                            a.instances.push_back(e);
+                            entries.push_back(e);
+                        }
+                        return entries;
+                    };
+
+                    // Outermost level first while walking; reversed below.
+                    std::vector<std::vector<EmittedActor::InstanceEntry>> levels;
+                    for (auto src = incomingTo(uid, 0); src.has_value();)
+                    {
+                        const SopNode *packed = findNode(src->first);
+                        if (!packed || packed->kind() != "copy_to_points" || packed->bypass() ||
+                            !packed->paramBool("pack_instances", false))
+                            break;
+                        const auto stampSrc = incomingTo(src->first, 0);
+                        const auto tmplSrc  = incomingTo(src->first, 1);
+                        const Geometry *innerStamp = stampSrc ? outputOf(stampSrc->first) : nullptr;
+                        const Geometry *innerTmpl  = tmplSrc ? outputOf(tmplSrc->first) : nullptr;
+                        if (!innerStamp || !innerTmpl)
+                        {
+                            stamp = nullptr;
+                            break;
                         }
+                        levels.push_back(entriesFrom(
+                            *innerTmpl, packed->paramBool("orient_to_normal", true)));
+                        stamp = innerStamp;
+                        src = stampSrc;
+                    }
+
+                    if (stamp && tmpl)
+                    {
+                        const std::string baseName =
+                            node->paramString("name", "instance_" + std::to_string(uid));
+
+                        // Emit ONE EmittedActor with N per-instance entries.
+                        // apply_emitted turns this into a single Scene Actor
+                        // whose `instances()` list grows to N SceneInstances
+                        // — each with its own per-instance TRS and tint. The
+                        // win over the old "N EmittedActors" model is that
+                        // the same Actor stays alive across cooks and
+                        // particle birth/death is just an in-place resize +
+                        // overwrite of the array, not 3000 Actor allocations.
+                        EmittedActor a;
+                        a.sourceNodeUid = uid;
+                        a.instanceIndex = 0;
+                        a.name          = baseName;
+                        a.geometry      = std::make_shared<const Geometry>(*stamp);
+                        a.materialLibraryName =
+                            node->paramString("material_library_name", "");
+                        a.instances = entriesFrom(*tmpl, node->paramBool("orient_to_normal", true));
+                        a.groupLevels.assign(std::make_move_iterator(levels.rbegin()),
+                                             std::make_move_iterator(levels.rend()));
                         emitted.push_back(std::move(a));
                     }
                 }
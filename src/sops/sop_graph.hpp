@@ -42,6 +42,14 @@ namespace tracey
             std::string kind;
             std::string name;
             double      ms = 0.0;
+            // Attribute storage requests made while the node cooked, split
+            // into fresh heap allocations and those the cook cache's
+            // AttributePool served from recycled buffers. Zero on the
+            // uncached path (no pool installed) and on cache hits.
+            size_t      allocations = 0;
+            size_t      reused = 0;
+            size_t      bytesAllocated = 0;
+            size_t      bytesReused = 0;
         };
 
         class SopGraph : public Graph
@@ -108,6 +108,16 @@ namespace tracey
                 bool hasTint = false;
             };
             std::vector<InstanceEntry> instances;
+            // Nested instancing: set when the `instance` SOP's stamp is a
+            // packed copy_to_points (pack_instances on), possibly chained.
+            // Innermost level first — groupLevels[0] places `geometry` inside
+            // the innermost instance group, groupLevels[k] places group k-1 —
+            // and `instances` above then places the outermost group. The
+            // editor turns each level into a Scene instance group, so the
+            // scene compiles to one BLAS plus a few small TLASes instead of
+            // the product of every level's point count. Empty for a plain
+            // single-level instance.
+            std::vector<std::vector<InstanceEntry>> groupLevels;
             // Per-instance albedo tint pulled from the template's `Cd`
             // attribute (or anywhere upstream that wants to vary shading
             // per instance). White (1,1,1) means "no override" — the slow
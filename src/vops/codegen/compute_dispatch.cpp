@@ -7,7 +7,9 @@
 //   compileOrGet(graph):
 //     - emitGlsl(graph) → GLSL + binding tables
 //     - hashGlsl + cache lookup; hit → return entry
-//     - miss → ShaderCompiler → VkShaderModule → descriptor-set layout
+//     - miss → ShaderCompiler (itself backed by the on-disk SPIR-V
+//       cache, so only the first run ever sees a given graph shape pay
+//       for glslang) → VkShaderModule → descriptor-set layout
 //       (one binding per touched attr + one for params) →
 //       pipeline layout (with `uint pointCount` push constant) →
 //       VkPipeline; stash entry in cache, return.
@@ -49,6 +49,32 @@ namespace tracey
             constexpr const auto &kVecPorts           = kGeoVecPorts;
             constexpr const auto &kFloatPorts         = kGeoFloatPorts;
             constexpr const auto &kInputOnlyFloatPorts = kGeoReadOnlyFloatPorts;
+
+            // Interned attribute handles parallel to the port arrays, so
+            // the per-point evaluate() resolves attributes by id instead
+            // of by string.
+            template <typename T, typename Spec, size_t N>
+            std::array<AttributeHandle<T>, N> handlesFor(const std::array<Spec, N> &ports)
+            {
+                std::array<AttributeHandle<T>, N> out;
+                for (size_t i = 0; i < N; ++i) out[i] = AttributeHandle<T>(ports[i].name);
+                return out;
+            }
+            const auto &vecHandles()
+            {
+                static const auto handles = handlesFor<Vec3>(kVecPorts);
+                return handles;
+            }
+            const auto &floatHandles()
+            {
+                static const auto handles = handlesFor<float>(kFloatPorts);
+                return handles;
+            }
+            const auto &inputOnlyFloatHandles()
+            {
+                static const auto handles = handlesFor<float>(kInputOnlyFloatPorts);
+                return handles;
+            }
         }
 
         // ── geo_input ────────────────────────────────────────────────────────
@@ -79,20 +105,21 @@ namespace tracey
             {
                 if (!ctx.geometry || !ctx.graph) return;
 
+                const auto &points = ctx.geometry->points();
                 size_t portIdx = 0;
-                for (const auto &p : kVecPorts)
+                for (size_t i = 0; i < kVecPorts.size(); ++i)
                 {
-                    Vec3 v = p.defaultValue;
-                    if (const auto *a = ctx.geometry->points().get<Vec3>(p.name))
+                    Vec3 v = kVecPorts[i].defaultValue;
+                    if (const auto *a = points.get(vecHandles()[i]))
                     {
                         if (ctx.pointIndex < a->data().size()) v = a->data()[ctx.pointIndex];
                     }
                     ctx.graph->writeOutput(ctx, uid(), portIdx++, v);
                 }
-                for (const auto &p : kFloatPorts)
+                for (size_t i = 0; i < kFloatPorts.size(); ++i)
                 {
-                    float v = p.defaultValue;
-                    if (const auto *a = ctx.geometry->points().get<float>(p.name))
+                    float v = kFloatPorts[i].defaultValue;
+                    if (const auto *a = points.get(floatHandles()[i]))
                     {
                         if (ctx.pointIndex < a->data().size()) v = a->data()[ctx.pointIndex];
                     }
@@ -101,9 +128,8 @@ namespace tracey
                 // age / life: same shape, but with their own defaults.
                 for (size_t i = 0; i < 2; ++i)
                 {
-                    const auto &p = kInputOnlyFloatPorts[i];
-                    float v = p.defaultValue;
-                    if (const auto *a = ctx.geometry->points().get<float>(p.name))
+                    float v = kInputOnlyFloatPorts[i].defaultValue;
+                    if (const auto *a = points.get(inputOnlyFloatHandles()[i]))
                     {
                         if (ctx.pointIndex < a->data().size()) v = a->data()[ctx.pointIndex];
                     }
@@ -160,21 +186,21 @@ namespace tracey
             void prepare(Geometry &geo) const override
             {
                 size_t inputIdx = 0;
-                for (const auto &p : kVecPorts)
+                for (size_t i = 0; i < kVecPorts.size(); ++i)
                 {
                     const bool willWrite = needsWrite(inputIdx);
                     ++inputIdx;
                     if (!willWrite) continue;
-                    if (!geo.points().get<Vec3>(p.name))
-                        geo.points().add<Vec3>(p.name, p.defaultValue);
+                    if (!geo.points().has(vecHandles()[i]))
+                        geo.points().add(vecHandles()[i], kVecPorts[i].defaultValue);
                 }
-                for (const auto &p : kFloatPorts)
+                for (size_t i = 0; i < kFloatPorts.size(); ++i)
                 {
                     const bool willWrite = needsWrite(inputIdx);
                     ++inputIdx;
                     if (!willWrite) continue;
-                    if (!geo.points().get<float>(p.name))
-                        geo.points().add<float>(p.name, p.defaultValue);
+                    if (!geo.points().has(floatHandles()[i]))
+                        geo.points().add(floatHandles()[i], kFloatPorts[i].defaultValue);
                 }
             }
 
@@ -184,8 +210,9 @@ namespace tracey
 
                 size_t inputIdx = 0;
                 // Vec3 ports
-                for (const auto &p : kVecPorts)
+                for (size_t k = 0; k < kVecPorts.size(); ++k)
                 {
+                    const auto &p = kVecPorts[k];
                     const bool passthrough = paramBool(
                         std::string("passthrough_") + p.name, true);
                     auto in = ctx.graph->readInput(ctx, uid(), inputIdx);
@@ -207,15 +234,16 @@ namespace tracey
                         v = p.defaultValue;
                     }
 
-                    if (auto *a = ctx.geometry->points().get<Vec3>(p.name))
+                    if (auto *a = ctx.geometry->points().get(vecHandles()[k]))
                     {
                         if (ctx.pointIndex < a->data().size())
                             a->data()[ctx.pointIndex] = v;
                     }
                 }
                 // Float ports
-                for (const auto &p : kFloatPorts)
+                for (size_t k = 0; k < kFloatPorts.size(); ++k)
                 {
+                    const auto &p = kFloatPorts[k];
                     const bool passthrough = paramBool(
                         std::string("passthrough_") + p.name, true);
                     auto in = ctx.graph->readInput(ctx, uid(), inputIdx);
@@ -235,7 +263,7 @@ namespace tracey
                         v = p.defaultValue;
                     }
 
-                    if (auto *a = ctx.geometry->points().get<float>(p.name))
+                    if (auto *a = ctx.geometry->points().get(floatHandles()[k]))
                     {
                         if (ctx.pointIndex < a->data().size())
                             a->data()[ctx.pointIndex] = v;
@@ -0,0 +1,137 @@
+// intersect — Houdini's Intersect VOP. Casts a ray per point against a
+// collision surface and reports the closest hit:
+//
+//   inputs   origin    (Vec3, defaults to the point's P)
+//            direction (Vec3, defaults to the `direction` param; normalised)
+//   outputs  hit   (1 / 0)
+//            P     (hit position, or origin on a miss)
+//            dist  (hit distance, -1 on a miss)
+//            prim  (collision primitive id, -1 on a miss)
+//            N     (geometric normal of the hit face, 0 on a miss)
+//
+// The surface is attribute_vop's `collision` input when connected,
+// otherwise the geometry being cooked — which makes self-occlusion tests
+// (AO-style attributes, "is anything above me") a one-node graph. Hosts
+// without a second input (instance geometry, pop_force) always use the
+// cooked geometry.
+//
+// prepare acquires the engine-Blas BVH through acquireGeometryBlas
+// (geometry/geometry_blas.hpp), cached by content hash across cooks, and
+// snapshots P; the per-point casts only read those and never allocate.
+
+#include "../register_builtins.hpp"
+#include "../vop_node.hpp"
+#include "../vop_graph.hpp"
+#include "../vop_registry.hpp"
+
+#include "../../geometry/attribute.hpp"
+#include "../../geometry/attribute_table.hpp"
+#include "../../geometry/geometry.hpp"
+#include "../../geometry/geometry_blas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace tracey
+{
+    namespace vops
+    {
+        namespace
+        {
+            Vec3 asVec3(const Value &v)
+            {
+                if (auto *vv = std::get_if<Vec3>(&v)) return *vv;
+                if (auto *f  = std::get_if<float>(&v)) return Vec3(*f);
+                if (auto *i  = std::get_if<int>(&v))   return Vec3(static_cast<float>(*i));
+                return Vec3(0.0f);
+            }
+        }
+
+        // ── intersect ────────────────────────────────────────────────────────
+        class IntersectVop : public VopNode
+        {
+        public:
+            explicit IntersectVop(size_t uid) : VopNode(uid)
+            {
+                declareParam(Parameter::makeVec3 ("direction",    Vec3(0.0f, -1.0f, 0.0f)));
+                declareParam(Parameter::makeFloat("max_distance", 0.0f));
+                declareParam(Parameter::makeFloat("bias",         1e-4f));
+            }
+            std::string kind() const override { return "intersect"; }
+
+            InputsAndOutputs ports() const override
+            {
+                InputsAndOutputs io;
+                io.addInput(PortInfo::createInput("origin",    DataType::Vec3));
+                io.addInput(PortInfo::createInput("direction", DataType::Vec3));
+                io.addOutput(PortInfo::createOutput("hit",  DataType::Float));
+                io.addOutput(PortInfo::createOutput("P",    DataType::Vec3));
+                io.addOutput(PortInfo::createOutput("dist", DataType::Float));
+                io.addOutput(PortInfo::createOutput("prim", DataType::Float));
+                io.addOutput(PortInfo::createOutput("N",    DataType::Vec3));
+                return io;
+            }
+
+            void prepare(Geometry &geo) const override
+            {
+                prepareWithInputs(geo, {});
+            }
+
+            void prepareWithInputs(Geometry &geo,
+                                   std::span<const Geometry *const> extra) const override
+            {
+                const Geometry &self = geo;
+                const Geometry &collision = (!extra.empty() && extra[0]) ? *extra[0] : self;
+                m_blas = acquireGeometryBlas(collision);
+                m_positions = self.positions();
+            }
+
+            void evaluate(EvalContext &ctx) const override
+            {
+                if (!ctx.graph) return;
+                Vec3 origin = ctx.pointIndex < m_positions.size() ? m_positions[ctx.pointIndex] : Vec3(0.0f);
+                if (auto in = ctx.graph->readInput(ctx, uid(), 0)) origin = asVec3(*in);
+                Vec3 dir = paramVec3("direction", Vec3(0.0f, -1.0f, 0.0f));
+                if (auto in = ctx.graph->readInput(ctx, uid(), 1)) dir = asVec3(*in);
+
+                std::optional<Hit> hit;
+                const float len2 = dir.x * dir.x + dir.y * dir.y + dir.z * dir.z;
+                if (m_blas && len2 > 0.0f)
+                {
+                    const float maxParam = paramFloat("max_distance", 0.0f);
+                    const float maxDistance = maxParam > 0.0f ? maxParam : std::numeric_limits<float>::infinity();
+                    const float bias = std::max(0.0f, paramFloat("bias", 1e-4f));
+                    hit = m_blas->intersect(origin, dir * (1.0f / std::sqrt(len2)), maxDistance, bias);
+                }
+
+                ctx.graph->writeOutput(ctx, uid(), 0, hit ? 1.0f : 0.0f);
+                ctx.graph->writeOutput(ctx, uid(), 1, hit ? hit->position : origin);
+                ctx.graph->writeOutput(ctx, uid(), 2, hit ? hit->t : -1.0f);
+                ctx.graph->writeOutput(ctx, uid(), 3, hit ? static_cast<float>(hit->primitiveId) : -1.0f);
+                ctx.graph->writeOutput(ctx, uid(), 4, hit ? hit->normal : Vec3(0.0f));
+            }
+
+        private:
+            // Per-cook state: written by prepare before the parallel point
+            // loop, only read inside it.
+            mutable std::shared_ptr<const GeometryBlas> m_blas;
+            mutable std::vector<Vec3> m_positions;
+        };
+
+        void registerIntersectVops()
+        {
+            VopRegistry::instance().registerType(
+                {"intersect", "Intersect", "Geometry",
+                 {{"origin"}, {"direction"}},
+                 {{"hit"}, {"P"}, {"dist"}, {"prim"}, {"N"}},
+                 {{"direction",    ParamType::Vec3,  "[0, -1, 0]"},
+                  {"max_distance", ParamType::Float, "0.0",    0.0, 100.0, 0.01},
+                  {"bias",         ParamType::Float, "0.0001", 0.0, 0.1,   0.0001}}},
+                [](size_t uid) { return std::make_unique<IntersectVop>(uid); });
+        }
+    }
+}
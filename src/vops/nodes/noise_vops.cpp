@@ -3,12 +3,10 @@
 #include "../vop_graph.hpp"
 #include "../vop_registry.hpp"
 
-#include <glm/glm.hpp>
-#include <glm/gtc/noise.hpp>
+#include "../../core/noise.hpp"
 
 #include <algorithm>
 #include <cmath>
-#include <cstdint>
 #include <memory>
 
 namespace tracey
@@ -28,76 +26,11 @@ namespace tracey
                 if (auto *i = std::get_if<int>(&in)) return Vec3(static_cast<float>(*i));
                 return Vec3(0.0f);
             }
-
-            // Shift a sample point into a per-seed slice of the noise's
-            // continuous domain. Adjacent integer seeds give meaningfully
-            // different fields without crowding (the offsets are large
-            // irrational-ish strides, not powers of two).
-            glm::vec3 seedShift(const glm::vec3 &p, int seed)
-            {
-                const float so = static_cast<float>(seed);
-                return glm::vec3(p.x + so * 17.13f,
-                                 p.y + so * 31.71f,
-                                 p.z + so * 53.91f);
-            }
-
-            // 32-bit integer hash used by the cellular noise (Worley) below
-            // for feature-point placement. Stable across seeds: the hash
-            // mixes (x, y, z, seed) into a single uint that's then split
-            // into three [0,1) coordinates by dividing successive 10-bit
-            // slices. Cheap; quality is plenty for visible jittered cells.
-            uint32_t hash3i(int x, int y, int z, int seed)
-            {
-                uint32_t h = static_cast<uint32_t>(x) * 2654435761u
-                           ^ static_cast<uint32_t>(y) * 2246822519u
-                           ^ static_cast<uint32_t>(z) *  374761393u
-                           ^ static_cast<uint32_t>(seed) * 3266489917u;
-                h ^= h >> 13; h *= 0x85ebca6bu;
-                h ^= h >> 16; h *= 0xc2b2ae35u;
-                h ^= h >> 13;
-                return h;
-            }
-            // Three independent [0,1) floats packed out of one hash.
-            // Reasonable distribution for jitter; not crypto.
-            glm::vec3 hashedFeaturePoint(int x, int y, int z, int seed)
-            {
-                const uint32_t hx = hash3i(x, y, z, seed);
-                const uint32_t hy = hash3i(x, y, z, seed + 1013);
-                const uint32_t hz = hash3i(x, y, z, seed + 1031);
-                return glm::vec3(
-                    static_cast<float>(hx & 0x00ffffffu) / static_cast<float>(0x01000000u),
-                    static_cast<float>(hy & 0x00ffffffu) / static_cast<float>(0x01000000u),
-                    static_cast<float>(hz & 0x00ffffffu) / static_cast<float>(0x01000000u));
-            }
-
-            // Worley (cellular) F1 noise. Returns the distance to the
-            // nearest jittered feature point, expressed as a [0,1)-ish
-            // value (the cell's edge length is 1.0 in the sampled domain).
-            // Hexagons / rocks / cell patterns are the canonical use.
-            float worleyF1(glm::vec3 p, int seed)
-            {
-                const int ix = static_cast<int>(std::floor(p.x));
-                const int iy = static_cast<int>(std::floor(p.y));
-                const int iz = static_cast<int>(std::floor(p.z));
-                float bestSq = 1e30f;
-                for (int dz = -1; dz <= 1; ++dz)
-                for (int dy = -1; dy <= 1; ++dy)
-                for (int dx = -1; dx <= 1; ++dx)
-                {
-                    const int cx = ix + dx, cy = iy + dy, cz = iz + dz;
-                    glm::vec3 jitter = hashedFeaturePoint(cx, cy, cz, seed);
-                    glm::vec3 fp = glm::vec3(cx, cy, cz) + jitter;
-                    glm::vec3 d = fp - p;
-                    const float sq = glm::dot(d, d);
-                    if (sq < bestSq) bestSq = sq;
-                }
-                return std::sqrt(bestSq);
-            }
         }
 
         // ── noise_perlin ─────────────────────────────────────────────────────
         // 3D Perlin noise at the input position. Output is signed in roughly
-        // [-amplitude, +amplitude] (glm::perlin tops out at about ±0.7).
+        // [-amplitude, +amplitude] (classic Perlin tops out at about ±1).
         class NoisePerlinVop : public VopNode
         {
         public:
@@ -122,8 +55,7 @@ namespace tracey
                 const float freq = paramFloat("frequency", 1.0f);
                 const float amp  = paramFloat("amplitude", 1.0f);
                 const int   seed = paramInt("seed", 0);
-                const glm::vec3 sp = seedShift(glm::vec3(p.x, p.y, p.z) * freq, seed);
-                ctx.graph->writeOutput(ctx, uid(), 0, glm::perlin(sp) * amp);
+                ctx.graph->writeOutput(ctx, uid(), 0, noise::perlin(noise::seedShift(p * freq, seed)) * amp);
             }
         };
 
@@ -155,8 +87,7 @@ namespace tracey
                 const float freq = paramFloat("frequency", 1.0f);
                 const float amp  = paramFloat("amplitude", 1.0f);
                 const int   seed = paramInt("seed", 0);
-                const glm::vec3 sp = seedShift(glm::vec3(p.x, p.y, p.z) * freq, seed);
-                ctx.graph->writeOutput(ctx, uid(), 0, glm::simplex(sp) * amp);
+                ctx.graph->writeOutput(ctx, uid(), 0, noise::simplex(noise::seedShift(p * freq, seed)) * amp);
             }
         };
 
@@ -189,8 +120,7 @@ namespace tracey
                 const float freq = paramFloat("frequency", 1.0f);
                 const float amp  = paramFloat("amplitude", 1.0f);
                 const int   seed = paramInt("seed", 0);
-                const glm::vec3 sp(p.x * freq, p.y * freq, p.z * freq);
-                ctx.graph->writeOutput(ctx, uid(), 0, worleyF1(sp, seed) * amp);
+                ctx.graph->writeOutput(ctx, uid(), 0, noise::worley(p * freq, seed) * amp);
             }
         };
 
@@ -226,23 +156,13 @@ namespace tracey
                 const Vec3 p = readPositionInput(ctx, uid(), 0);
                 const float freq0 = paramFloat("frequency", 1.0f);
                 const float amp0  = paramFloat("amplitude", 1.0f);
-                // Cap octave count generously to keep accidental large
-                // values from grinding the cook to a halt.
-                const int octaves = std::max(1, std::min(paramInt("octaves", 5), 10));
-                const float lac = paramFloat("lacunarity", 2.0f);
-                const float gain = paramFloat("gain", 0.5f);
+                noise::Fractal f;
+                f.octaves = paramInt("octaves", 5);
+                f.lacunarity = paramFloat("lacunarity", 2.0f);
+                f.gain = paramFloat("gain", 0.5f);
                 const int seed = paramInt("seed", 0);
-
-                glm::vec3 sp = seedShift(glm::vec3(p.x, p.y, p.z) * freq0, seed);
-                float amp = 1.0f;
-                float sum = 0.0f;
-                for (int o = 0; o < octaves; ++o)
-                {
-                    sum += glm::perlin(sp) * amp;
-                    sp *= lac;
-                    amp *= gain;
-                }
-                ctx.graph->writeOutput(ctx, uid(), 0, sum * amp0);
+                const Vec3 sp = noise::seedShift(p * freq0, seed);
+                ctx.graph->writeOutput(ctx, uid(), 0, noise::fbm(sp, f) * amp0);
             }
         };
 
@@ -276,21 +196,13 @@ namespace tracey
                 const Vec3 p = readPositionInput(ctx, uid(), 0);
                 const float freq0 = paramFloat("frequency", 1.0f);
                 const float amp0  = paramFloat("amplitude", 1.0f);
-                const int octaves = std::max(1, std::min(paramInt("octaves", 5), 10));
-                const float lac = paramFloat("lacunarity", 2.0f);
-                const float gain = paramFloat("gain", 0.5f);
+                noise::Fractal f;
+                f.octaves = paramInt("octaves", 5);
+                f.lacunarity = paramFloat("lacunarity", 2.0f);
+                f.gain = paramFloat("gain", 0.5f);
                 const int seed = paramInt("seed", 0);
-
-                glm::vec3 sp = seedShift(glm::vec3(p.x, p.y, p.z) * freq0, seed);
-                float amp = 1.0f;
-                float sum = 0.0f;
-                for (int o = 0; o < octaves; ++o)
-                {
-                    sum += std::abs(glm::perlin(sp)) * amp;
-                    sp *= lac;
-                    amp *= gain;
-                }
-                ctx.graph->writeOutput(ctx, uid(), 0, sum * amp0);
+                const Vec3 sp = noise::seedShift(p * freq0, seed);
+                ctx.graph->writeOutput(ctx, uid(), 0, noise::turbulence(sp, f) * amp0);
             }
         };
 
@@ -324,23 +236,13 @@ namespace tracey
                 const Vec3 p = readPositionInput(ctx, uid(), 0);
                 const float freq0 = paramFloat("frequency", 1.0f);
                 const float amp0  = paramFloat("amplitude", 1.0f);
-                const int octaves = std::max(1, std::min(paramInt("octaves", 5), 10));
-                const float lac = paramFloat("lacunarity", 2.0f);
-                const float gain = paramFloat("gain", 0.5f);
+                noise::Fractal f;
+                f.octaves = paramInt("octaves", 5);
+                f.lacunarity = paramFloat("lacunarity", 2.0f);
+                f.gain = paramFloat("gain", 0.5f);
                 const int seed = paramInt("seed", 0);
-
-                glm::vec3 sp = seedShift(glm::vec3(p.x, p.y, p.z) * freq0, seed);
-                float amp = 1.0f;
-                float sum = 0.0f;
-                for (int o = 0; o < octaves; ++o)
-                {
-                    float r = 1.0f - std::abs(glm::perlin(sp));
-                    r = r * r;  // sharpen — classic Musgrave variant
-                    sum += r * amp;
-                    sp *= lac;
-                    amp *= gain;
-                }
-                ctx.graph->writeOutput(ctx, uid(), 0, sum * amp0);
+                const Vec3 sp = noise::seedShift(p * freq0, seed);
+                ctx.graph->writeOutput(ctx, uid(), 0, noise::ridged(sp, f) * amp0);
             }
         };
 
@@ -373,11 +275,7 @@ namespace tracey
                 const float freq = paramFloat("frequency", 1.0f);
                 const float amp  = paramFloat("amplitude", 1.0f);
                 const int   seed = paramInt("seed", 0);
-                const glm::vec3 base(p.x * freq, p.y * freq, p.z * freq);
-                Vec3 r(glm::perlin(seedShift(base, seed)) * amp,
-                       glm::perlin(seedShift(base, seed + 41)) * amp,
-                       glm::perlin(seedShift(base, seed + 83)) * amp);
-                ctx.graph->writeOutput(ctx, uid(), 0, r);
+                ctx.graph->writeOutput(ctx, uid(), 0, noise::perlin3(p * freq, seed) * amp);
             }
         };
 
@@ -416,24 +314,7 @@ namespace tracey
                 const float amp  = paramFloat("amplitude", 1.0f);
                 const float eps  = std::max(1e-5f, paramFloat("eps", 0.001f));
                 const int   seed = paramInt("seed", 0);
-                const glm::vec3 base(p.x * freq, p.y * freq, p.z * freq);
-
-                // Three independent scalar potentials, one per axis pair.
-                // curl = (∂Pz/∂y − ∂Py/∂z, ∂Px/∂z − ∂Pz/∂x, ∂Py/∂x − ∂Px/∂y)
-                auto Px = [&](glm::vec3 q) { return glm::perlin(seedShift(q, seed)); };
-                auto Py = [&](glm::vec3 q) { return glm::perlin(seedShift(q, seed + 41)); };
-                auto Pz = [&](glm::vec3 q) { return glm::perlin(seedShift(q, seed + 83)); };
-
-                const glm::vec3 dx(eps, 0, 0), dy(0, eps, 0), dz(0, 0, eps);
-                const float dPzdy = (Pz(base + dy) - Pz(base - dy)) / (2.0f * eps);
-                const float dPydz = (Py(base + dz) - Py(base - dz)) / (2.0f * eps);
-                const float dPxdz = (Px(base + dz) - Px(base - dz)) / (2.0f * eps);
-                const float dPzdx = (Pz(base + dx) - Pz(base - dx)) / (2.0f * eps);
-                const float dPydx = (Py(base + dx) - Py(base - dx)) / (2.0f * eps);
-                const float dPxdy = (Px(base + dy) - Px(base - dy)) / (2.0f * eps);
-
-                Vec3 curl(dPzdy - dPydz, dPxdz - dPzdx, dPydx - dPxdy);
-                ctx.graph->writeOutput(ctx, uid(), 0, curl * amp);
+                ctx.graph->writeOutput(ctx, uid(), 0, noise::curl(p * freq, seed, eps) * amp);
             }
         };
 
@@ -0,0 +1,271 @@
+// Point-cloud lookup VOPs — Houdini's pcfind / nearpoints family. Each
+// query runs against the geometry the graph is cooking, through the
+// point KD-tree cached on its point table (geometry/point_kdtree.hpp):
+//
+//   pc_nearest — the `count` nearest points (up to 64), optionally only
+//                those within `max_radius` (0 = unlimited).
+//   pc_radius  — every point within `radius`, or only the closest
+//                `max_points` of them when that is > 0.
+//
+// Both report the same outputs: how many points were found, the mean of
+// `attribute` over them (Vec3 attributes as-is, float attributes
+// broadcast, missing → 0), and the closest one's point number, position
+// and distance (-1 / p / 0 when nothing was found). `exclude_self` drops
+// the point being cooked, so smoothing and relaxation graphs see only
+// true neighbours.
+//
+// prepare() acquires the tree and snapshots P and `attribute` once per
+// cook, so the per-point queries neither read the live geometry — which
+// geo_output may be rewriting on other threads — nor allocate: k-nearest
+// results go to a stack buffer and radius sums stream through the
+// traversal. The `p` input defaults to the point's own P when unconnected.
+
+#include "../register_builtins.hpp"
+#include "../vop_node.hpp"
+#include "../vop_graph.hpp"
+#include "../vop_registry.hpp"
+
+#include "../../geometry/attribute.hpp"
+#include "../../geometry/attribute_table.hpp"
+#include "../../geometry/geometry.hpp"
+#include "../../geometry/point_kdtree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tracey
+{
+    namespace vops
+    {
+        namespace
+        {
+            // Accumulated result of one query.
+            struct QueryResult
+            {
+                int count = 0;
+                Vec3 sum = Vec3(0.0f);
+                int closest = -1;
+                float closestDist2 = 0.0f;
+            };
+
+            // Shared parameters, ports and per-cook state of the two
+            // point-cloud nodes. Subclasses only implement query().
+            class PointCloudVopBase : public VopNode
+            {
+            public:
+                explicit PointCloudVopBase(size_t uid) : VopNode(uid)
+                {
+                    declareParam(Parameter::makeString("attribute", "P"));
+                    declareParam(Parameter::makeBool("exclude_self", true));
+                }
+
+                InputsAndOutputs ports() const override
+                {
+                    InputsAndOutputs io;
+                    io.addInput(PortInfo::createInput("p", DataType::Vec3));
+                    io.addOutput(PortInfo::createOutput("count",         DataType::Float));
+                    io.addOutput(PortInfo::createOutput("average",       DataType::Vec3));
+                    io.addOutput(PortInfo::createOutput("closest_ptnum", DataType::Float));
+                    io.addOutput(PortInfo::createOutput("closest_P",     DataType::Vec3));
+                    io.addOutput(PortInfo::createOutput("closest_dist",  DataType::Float));
+                    return io;
+                }
+
+                void prepare(Geometry &geo) const override
+                {
+                    // Read through a const view: the mutable accessors
+                    // bump attribute generations, which would invalidate
+                    // the tree we are about to acquire.
+                    const AttributeTable &points = std::as_const(geo).points();
+                    m_tree = acquirePointKdTree(points);
+
+                    m_positions.clear();
+                    if (const auto *P = points.get<Vec3>("P")) m_positions = P->data();
+
+                    m_values.clear();
+                    const std::string name = paramString("attribute", "P");
+                    if (const auto *a = points.get<Vec3>(name))
+                    {
+                        m_values = a->data();
+                    }
+                    else if (const auto *f = points.get<float>(name))
+                    {
+                        const auto &d = f->data();
+                        m_values.resize(d.size());
+                        for (size_t i = 0; i < d.size(); ++i) m_values[i] = Vec3(d[i]);
+                    }
+                    m_excludeSelf = paramBool("exclude_self", true);
+                }
+
+                void evaluate(EvalContext &ctx) const override
+                {
+                    if (!ctx.graph) return;
+                    Vec3 p = positionOf(ctx.pointIndex);
+                    if (auto in = ctx.graph->readInput(ctx, uid(), 0))
+                    {
+                        if (auto *v = std::get_if<Vec3>(&*in)) p = *v;
+                        else if (auto *f = std::get_if<float>(&*in)) p = Vec3(*f);
+                        else if (auto *i = std::get_if<int>(&*in)) p = Vec3(static_cast<float>(*i));
+                    }
+
+                    QueryResult r;
+                    if (m_tree && m_tree->size() > 0)
+                    {
+                        const uint32_t exclude = m_excludeSelf
+                            ? static_cast<uint32_t>(ctx.pointIndex)
+                            : PointKdTree::kNoExclude;
+                        query(*m_tree, p, exclude, r);
+                    }
+
+                    const float n = static_cast<float>(r.count);
+                    const bool hit = r.closest >= 0;
+                    ctx.graph->writeOutput(ctx, uid(), 0, n);
+                    ctx.graph->writeOutput(ctx, uid(), 1, r.count > 0 ? r.sum / n : Vec3(0.0f));
+                    ctx.graph->writeOutput(ctx, uid(), 2, static_cast<float>(r.closest));
+                    ctx.graph->writeOutput(ctx, uid(), 3, hit ? positionOf(r.closest) : p);
+                    ctx.graph->writeOutput(ctx, uid(), 4, hit ? std::sqrt(r.closestDist2) : 0.0f);
+                }
+
+            protected:
+                virtual void query(const PointKdTree &tree, const Vec3 &p, uint32_t exclude,
+                                   QueryResult &r) const = 0;
+
+                Vec3 valueOf(size_t index) const
+                {
+                    return index < m_values.size() ? m_values[index] : Vec3(0.0f);
+                }
+                Vec3 positionOf(size_t index) const
+                {
+                    return index < m_positions.size() ? m_positions[index] : Vec3(0.0f);
+                }
+
+                // Fold a closest-first findNearest() result into `r`.
+                void gatherNearest(const uint32_t *idx, const float *d2, int count,
+                                   QueryResult &r) const
+                {
+                    r.count = count;
+                    for (int i = 0; i < count; ++i) r.sum += valueOf(idx[i]);
+                    if (count > 0)
+                    {
+                        r.closest = static_cast<int>(idx[0]);
+                        r.closestDist2 = d2[0];
+                    }
+                }
+
+                // Per-cook state: written by prepare() before the parallel
+                // point loop, only read inside it.
+                mutable std::shared_ptr<const PointKdTree> m_tree;
+                mutable std::vector<Vec3> m_positions;
+                mutable std::vector<Vec3> m_values;
+                mutable bool m_excludeSelf = true;
+            };
+        }
+
+        // ── pc_nearest ───────────────────────────────────────────────────────
+        class PcNearestVop : public PointCloudVopBase
+        {
+        public:
+            explicit PcNearestVop(size_t uid) : PointCloudVopBase(uid)
+            {
+                declareParam(Parameter::makeInt("count", 8));
+                declareParam(Parameter::makeFloat("max_radius", 0.0f));
+            }
+            std::string kind() const override { return "pc_nearest"; }
+
+        protected:
+            void query(const PointKdTree &tree, const Vec3 &p, uint32_t exclude,
+                       QueryResult &out) const override
+            {
+                const int k = std::clamp(paramInt("count", 8), 1, PointKdTree::kMaxK);
+                const float r = paramFloat("max_radius", 0.0f);
+                const float maxRadius = r > 0.0f ? r : std::numeric_limits<float>::infinity();
+                uint32_t idx[PointKdTree::kMaxK];
+                float d2[PointKdTree::kMaxK];
+                const int found = tree.findNearest(p, k, maxRadius, exclude, idx, d2);
+                gatherNearest(idx, d2, found, out);
+            }
+        };
+
+        // ── pc_radius ────────────────────────────────────────────────────────
+        // max_points = 0 is unbounded: the sum streams through the
+        // traversal, the closest point is tracked on the way (ties by lower
+        // index, matching findNearest). A positive max_points turns it into
+        // a k-nearest query clamped to `radius`.
+        class PcRadiusVop : public PointCloudVopBase
+        {
+        public:
+            explicit PcRadiusVop(size_t uid) : PointCloudVopBase(uid)
+            {
+                declareParam(Parameter::makeFloat("radius", 0.1f));
+                declareParam(Parameter::makeInt("max_points", 0));
+            }
+            std::string kind() const override { return "pc_radius"; }
+
+        protected:
+            void query(const PointKdTree &tree, const Vec3 &p, uint32_t exclude,
+                       QueryResult &r) const override
+            {
+                const float radius = std::max(0.0f, paramFloat("radius", 0.1f));
+                const int maxPoints = paramInt("max_points", 0);
+                if (maxPoints > 0)
+                {
+                    const int k = std::min(maxPoints, PointKdTree::kMaxK);
+                    uint32_t idx[PointKdTree::kMaxK];
+                    float d2[PointKdTree::kMaxK];
+                    const int found = tree.findNearest(p, k, radius, exclude, idx, d2);
+                    gatherNearest(idx, d2, found, r);
+                    return;
+                }
+                tree.forEachInRadius(p, radius, [&](uint32_t index, const Vec3 &, float d2) {
+                    if (index == exclude) return;
+                    ++r.count;
+                    r.sum += valueOf(index);
+                    const int i = static_cast<int>(index);
+                    if (r.closest < 0 || d2 < r.closestDist2 ||
+                        (d2 == r.closestDist2 && i < r.closest))
+                    {
+                        r.closest = i;
+                        r.closestDist2 = d2;
+                    }
+                });
+            }
+        };
+
+        namespace
+        {
+            template <typename T>
+            VopRegistry::Factory makeFactory()
+            {
+                return [](size_t uid) { return std::make_unique<T>(uid); };
+            }
+        }
+
+        void registerPointCloudVops()
+        {
+            auto &reg = VopRegistry::instance();
+            reg.registerType(
+                {"pc_nearest", "Point Cloud Nearest", "Point Cloud",
+                 {{"p"}},
+                 {{"count"}, {"average"}, {"closest_ptnum"}, {"closest_P"}, {"closest_dist"}},
+                 {{"attribute",    ParamType::String, "\"P\""},
+                  {"exclude_self", ParamType::Bool,   "true"},
+                  {"count",        ParamType::Int,    "8",    1.0, 64.0, 1.0},
+                  {"max_radius",   ParamType::Float,  "0.0",  0.0, 10.0, 0.01}}},
+                makeFactory<PcNearestVop>());
+            reg.registerType(
+                {"pc_radius", "Point Cloud Radius", "Point Cloud",
+                 {{"p"}},
+                 {{"count"}, {"average"}, {"closest_ptnum"}, {"closest_P"}, {"closest_dist"}},
+                 {{"attribute",    ParamType::String, "\"P\""},
+                  {"exclude_self", ParamType::Bool,   "true"},
+                  {"radius",       ParamType::Float,  "0.1",  0.0, 10.0, 0.01},
+                  {"max_points",   ParamType::Int,    "0",    0.0, 64.0, 1.0}}},
+                makeFactory<PcRadiusVop>());
+        }
+    }
+}
@@ -11,6 +11,8 @@ namespace tracey
         void registerMathVops();
         void registerNoiseVops();
         void registerDisplacementVops();
+        void registerPointCloudVops();
+        void registerIntersectVops();
 
         void registerBuiltinVops()
         {
@@ -18,6 +20,8 @@ namespace tracey
             registerMathVops();
             registerNoiseVops();
             registerDisplacementVops();
+            registerPointCloudVops();
+            registerIntersectVops();
         }
     }
 }
@@ -161,6 +161,15 @@ namespace tracey
                     m["noise_vec3"]       = { {V}, {V} };
                     m["noise_curl"]       = { {V}, {V} };
 
+                    // ── Point cloud: query position → count, average,
+                    // closest ptnum / P / distance ────────────────────
+                    m["pc_nearest"] = { {V}, {F, V, F, V, F} };
+                    m["pc_radius"]  = { {V}, {F, V, F, V, F} };
+
+                    // ── Ray cast: origin, direction → hit, P, dist,
+                    // prim, N ─────────────────────────────────────────
+                    m["intersect"] = { {V, V}, {F, V, F, F, V} };
+
                     return m;
                 }();
                 return sigs;
@@ -6,6 +6,7 @@
 #include "parameter.hpp"
 
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -49,6 +50,16 @@ namespace tracey
             // not for per-point work.
             virtual void prepare(Geometry & /*geo*/) const {}
 
+            // prepare() for hosts with extra geometry inputs (attribute_vop's
+            // `collision` input). `extra` holds the host's inputs after the
+            // cooked one, null where unconnected. Hosts with a single input
+            // call prepare() directly; the default ignores `extra`.
+            virtual void prepareWithInputs(Geometry &geo,
+                                           std::span<const Geometry *const> /*extra*/) const
+            {
+                prepare(geo);
+            }
+
             // ── Parameters (mirror SopNode helpers; see src/sops/sop_node.hpp) ──
             const std::vector<Parameter> &parameters() const { return m_params; }
             std::vector<Parameter> &parameters() { return m_params; }